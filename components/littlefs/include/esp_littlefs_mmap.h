@@ -0,0 +1,104 @@
+#ifndef ESP_LITTLEFS_MMAP_H__
+#define ESP_LITTLEFS_MMAP_H__
+
+#include "esp_err.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/types.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Read-only view of a littlefs file that hands out pointers into the
+ * memory-mapped partition (CONFIG_LITTLEFS_MMAP_PARTITION) instead of copying.
+ *
+ * The data of a littlefs file is contiguous in flash within each block: a
+ * file of up to one block (4 KiB) is contiguous as a whole, a larger one in
+ * block-sized pieces. Ranges that cross a block, inline files (the small ones
+ * littlefs keeps in their directory) and partitions that are not mapped are
+ * copied instead.
+ *
+ * The file stays open while the handle exists, so it cannot be removed or
+ * renamed. It must not be written through another FD either: the blocks the
+ * pointers refer to would be freed. A handle is not thread safe; use one per
+ * task.
+ *
+ * Images built with littlefs_mkimage (littlefs_create_asset_image in
+ * project_include.cmake) store their large files on consecutive blocks and
+ * list them in a manifest. Those files are opened by a hash lookup, without
+ * searching the directories and without an FD, and are mapped as a whole
+ * block range. The manifest counts these handles: while one is open, writing,
+ * removing or renaming the file, its directories or the manifest through the
+ * VFS fails with EBUSY, as with an FD. Changing another listed file drops it
+ * from the manifest, which is then removed from the filesystem for good.
+ */
+typedef struct esp_littlefs_mmap * esp_littlefs_mmap_handle_t;
+
+/**
+ * Open a file for mapped reads.
+ *
+ * @param partition_label  Optional, label of the mounted partition.
+ * @param path             Path inside the filesystem, without the mount point (e.g. "/img/logo.bin").
+ * @param[out] ret_handle  Handle for the calls below.
+ *
+ * @return
+ *          - ESP_OK                  if success (possibly not mapped, see esp_littlefs_mmap_is_mapped)
+ *          - ESP_ERR_INVALID_ARG     if path or ret_handle is NULL
+ *          - ESP_ERR_INVALID_STATE   if not mounted
+ *          - ESP_ERR_NOT_FOUND       if the partition or the file does not exist
+ *          - ESP_ERR_NO_MEM          if out of memory
+ *          - ESP_FAIL                if the file is corrupted
+ */
+esp_err_t esp_littlefs_mmap_open(const char* partition_label, const char* path, esp_littlefs_mmap_handle_t* ret_handle);
+
+/**
+ * Close the file. Pointers handed out by the handle become invalid.
+ */
+esp_err_t esp_littlefs_mmap_close(esp_littlefs_mmap_handle_t handle);
+
+/**
+ * @return size of the file when it was opened
+ */
+size_t esp_littlefs_mmap_size(esp_littlefs_mmap_handle_t handle);
+
+/**
+ * @return true if the data can be reached through pointers, false if every read copies
+ */
+bool esp_littlefs_mmap_is_mapped(esp_littlefs_mmap_handle_t handle);
+
+/**
+ * Contiguous bytes of the file at offset, up to the end of their flash block.
+ *
+ * @param[out] data  Pointer into the mapped partition.
+ *
+ * @return bytes at *data, 0 at the end of the file, -1 if the file is not mapped
+ */
+ssize_t esp_littlefs_mmap_span(esp_littlefs_mmap_handle_t handle, size_t offset, const void** data);
+
+/**
+ * Bytes [offset, offset + size) of the file, cut at its end.
+ *
+ * If the range is contiguous in flash, *data points into the mapped
+ * partition and nothing is copied. Otherwise the range is copied into buf
+ * and *data is buf.
+ *
+ * @param buf        At least size bytes, used only when the range must be copied.
+ * @param[out] data  The bytes.
+ *
+ * @return bytes at *data, or -1 on a read error
+ */
+ssize_t esp_littlefs_mmap_get(esp_littlefs_mmap_handle_t handle, size_t offset, size_t size, void* buf, const void** data);
+
+/**
+ * Bytes handed out by esp_littlefs_mmap_get so far, as pointers and as copies.
+ */
+void esp_littlefs_mmap_stats(esp_littlefs_mmap_handle_t handle, uint64_t* mapped_bytes, uint64_t* copied_bytes);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif
@@ -6,6 +6,7 @@
 
 set(littlefs_py_venv "${CMAKE_CURRENT_BINARY_DIR}/littlefs_py_venv")
 set(littlefs_py_requirements "${CMAKE_CURRENT_LIST_DIR}/image-building-requirements.txt")
+set(littlefs_tools_dir "${CMAKE_CURRENT_LIST_DIR}/tools")
 
 set_directory_properties(PROPERTIES
     ADDITIONAL_CLEAN_FILES "${littlefs_py_venv}"
@@ -81,3 +82,84 @@ function(littlefs_create_partition_image partition base_dir)
 		fail_at_build_time(littlefs_${partition}_bin "${message}")
 	endif()
 endfunction()
+
+# littlefs_create_asset_image
+#
+# Like littlefs_create_partition_image, but built with tools/littlefs_mkimage instead of
+# littlefs-python. Files of at least MIN_SIZE bytes (default one block) are stored on consecutive
+# blocks, the first on a multiple of ALIGN bytes (default one block; 64K for an MMU page), and
+# listed in a manifest inside the image that esp_littlefs_mmap_open looks paths up in
+# (src/littlefs_manifest.h). The manifest is also written next to the image, for inspection.
+
+function(littlefs_create_asset_image partition base_dir)
+	set(options FLASH_IN_PROJECT)
+	set(one ALIGN MIN_SIZE)
+	set(multi DEPENDS)
+	cmake_parse_arguments(arg "${options}" "${one}" "${multi}" "${ARGN}")
+
+	get_filename_component(base_dir_full_path ${base_dir} ABSOLUTE)
+
+	partition_table_get_partition_info(size "--partition-name ${partition}" "size")
+	partition_table_get_partition_info(offset "--partition-name ${partition}" "offset")
+
+	if("${size}" AND "${offset}")
+		set(image_file ${CMAKE_BINARY_DIR}/${partition}.bin)
+		set(manifest_file ${CMAKE_BINARY_DIR}/${partition}.manifest)
+		set(mkimage_dir ${CMAKE_BINARY_DIR}/littlefs_mkimage)
+
+		if(CMAKE_HOST_WIN32)
+			set(mkimage ${mkimage_dir}/littlefs_mkimage.exe)
+		else()
+			set(mkimage ${mkimage_dir}/littlefs_mkimage)
+		endif()
+
+		# Host tool, built once for every partition; the host compiler, not the cross toolchain
+		if(NOT TARGET littlefs_mkimage_host)
+			include(ExternalProject)
+			externalproject_add(littlefs_mkimage_host
+				SOURCE_DIR ${littlefs_tools_dir}
+				BINARY_DIR ${mkimage_dir}
+				INSTALL_COMMAND ""
+				BUILD_BYPRODUCTS ${mkimage}
+				BUILD_ALWAYS 1
+				)
+		endif()
+
+		set(mkimage_args --size ${size} --block-size 4096 --name-max ${CONFIG_LITTLEFS_OBJ_NAME_LEN}
+			--manifest ${manifest_file} -v)
+		if(arg_ALIGN)
+			list(APPEND mkimage_args --align ${arg_ALIGN})
+		endif()
+		if(arg_MIN_SIZE)
+			list(APPEND mkimage_args --min-size ${arg_MIN_SIZE})
+		endif()
+
+		# Always executes, like littlefs_create_partition_image: the contents of base_dir are not watched
+		add_custom_target(littlefs_${partition}_bin ALL
+			COMMAND ${mkimage} ${base_dir_full_path} ${image_file} ${mkimage_args}
+			DEPENDS ${arg_DEPENDS} littlefs_mkimage_host
+			)
+
+		set_property(DIRECTORY "${CMAKE_CURRENT_SOURCE_DIR}" APPEND PROPERTY
+			ADDITIONAL_MAKE_CLEAN_FILES
+			${image_file} ${manifest_file})
+
+		idf_component_get_property(main_args esptool_py FLASH_ARGS)
+		idf_component_get_property(sub_args esptool_py FLASH_SUB_ARGS)
+		esptool_py_flash_target(${partition}-flash "${main_args}" "${sub_args}")
+		esptool_py_flash_target_image(${partition}-flash "${partition}" "${offset}" "${image_file}")
+
+		add_dependencies(${partition}-flash littlefs_${partition}_bin)
+
+		if(arg_FLASH_IN_PROJECT)
+			esptool_py_flash_target_image(flash "${partition}" "${offset}" "${image_file}")
+			add_dependencies(flash littlefs_${partition}_bin)
+		endif()
+
+	else()
+		set(message "Failed to create littlefs image for partition '${partition}'. "
+					"Check project configuration if using the correct partition table file."
+		)
+		fail_at_build_time(littlefs_${partition}_bin "${message}")
+	endif()
+endfunction()
@@ -9,6 +9,7 @@
 #endif // LOG_LOCAL_LEVEL
 
 #include "esp_littlefs.h"
+#include "esp_littlefs_mmap.h"
 #include "littlefs/lfs.h"
 #include "sdkconfig.h"
 #include "esp_log.h"
@@ -17,6 +18,7 @@
 #include "freertos/semphr.h"
 #include "freertos/task.h"
 #include "littlefs_api.h"
+#include "littlefs_mmap.h"
 #include <sys/dirent.h>
 #include <sys/errno.h>
 #include <sys/fcntl.h>
@@ -57,11 +59,6 @@
 
 #define CONFIG_LITTLEFS_BLOCK_SIZE 4096 /* ESP32 can only operate at 4kb */
 
-/* File Descriptor Caching Params */
-#define CONFIG_LITTLEFS_FD_CACHE_REALLOC_FACTOR 2  /* Amount to resize FD cache by */
-#define CONFIG_LITTLEFS_FD_CACHE_MIN_SIZE 4  /* Minimum size of FD cache */
-#define CONFIG_LITTLEFS_FD_CACHE_HYST 4  /* When shrinking, leave this many trailing FD slots available */
-
 /**
  * @brief Last Modified Time
  *
@@ -163,9 +160,15 @@ static void rmdirs(esp_littlefs_t * efs, const char *dir);
 
 static int vfs_littlefs_fcntl(void* ctx, int fd, int cmd, int arg);
 
-static int sem_take(esp_littlefs_t *efs);
-static int sem_give(esp_littlefs_t *efs);
+static void sem_take(esp_littlefs_t *efs);
+static void sem_give(esp_littlefs_t *efs);
+static void sem_take_shared(esp_littlefs_t *efs);
+static void sem_give_shared(esp_littlefs_t *efs);
 static esp_err_t format_from_efs(esp_littlefs_t *efs);
+#ifdef CONFIG_LITTLEFS_MMAP_PARTITION
+static void esp_littlefs_manifest_load(esp_littlefs_t *efs);
+static int esp_littlefs_manifest_touch(esp_littlefs_t *efs, const char *path);
+#endif
 static void get_total_and_used_bytes(esp_littlefs_t *efs, size_t *total_bytes, size_t *used_bytes);
 
 static SemaphoreHandle_t _efs_lock = NULL;
@@ -197,14 +200,10 @@ static inline void * esp_littlefs_calloc(size_t __nmemb, size_t __size) {
 
 static void esp_littlefs_free_fds(esp_littlefs_t * efs) {
     /* Need to free all files that were opened */
-    while (efs->file) {
-        vfs_littlefs_file_t * next = efs->file->next;
-        free(efs->file);
-        efs->file = next;
+    for(int fd = 0; fd < efs->fds.size; fd++) {
+        free(efs->fds.file[fd]);
     }
-    free(efs->cache);
-    efs->cache = 0;
-    efs->cache_size = efs->fd_count = 0;
+    littlefs_fd_deinit(&efs->fds);
 }
 
 static int lfs_errno_remap(enum lfs_error err) {
@@ -234,7 +233,7 @@ esp_err_t format_from_efs(esp_littlefs_t *efs)
     bool was_mounted = false;
 
     /* Unmount if mounted */
-    if(efs->cache_size > 0){
+    if(efs->fds.size > 0){
         int res;
         ESP_LOGV(ESP_LITTLEFS_TAG, "Partition was mounted. Unmounting...");
         was_mounted = true;
@@ -245,6 +244,10 @@ esp_err_t format_from_efs(esp_littlefs_t *efs)
         }
         esp_littlefs_free_fds(efs);
     }
+#ifdef CONFIG_LITTLEFS_MMAP_PARTITION
+    littlefs_manifest_free(&efs->manifest);
+    efs->manifest_checked = false;
+#endif
 
 #ifdef CONFIG_LITTLEFS_SDMMC_SUPPORT
     /* Format the SD card too */
@@ -292,8 +295,11 @@ esp_err_t format_from_efs(esp_littlefs_t *efs)
             ESP_LOGE(ESP_LITTLEFS_TAG, "Failed to re-mount filesystem");
             return ESP_FAIL;
         }
-        efs->cache_size = CONFIG_LITTLEFS_FD_CACHE_MIN_SIZE;  // Initial size of cache; will resize ondemand
-        efs->cache = esp_littlefs_calloc(efs->cache_size, sizeof(*efs->cache));
+        if(littlefs_fd_init(&efs->fds) < 0) {  // Will grow on demand
+            ESP_LOGE(ESP_LITTLEFS_TAG, "Unable to allocate FD table");
+            lfs_unmount(efs->fs);
+            return ESP_ERR_NO_MEM;
+        }
     }
     ESP_LOGV(ESP_LITTLEFS_TAG, "Format Success!");
 
@@ -322,7 +328,7 @@ bool esp_littlefs_mounted(const char* partition_label) {
 
     err = esp_littlefs_by_label(partition_label, &index);
     if(err != ESP_OK) return false;
-    return _efs[index]->cache_size > 0;
+    return _efs[index]->fds.size > 0;
 }
 
 bool esp_littlefs_partition_mounted(const esp_partition_t* partition) {
@@ -330,7 +336,7 @@ bool esp_littlefs_partition_mounted(const esp_partition_t* partition) {
     esp_err_t err = esp_littlefs_by_partition(partition, &index);
 
     if(err != ESP_OK) return false;
-    return _efs[index]->cache_size > 0;
+    return _efs[index]->fds.size > 0;
 }
 
 #ifdef CONFIG_LITTLEFS_SDMMC_SUPPORT
@@ -340,7 +346,7 @@ bool esp_littlefs_sdmmc_mounted(sdmmc_card_t *sdcard)
     esp_err_t err = esp_littlefs_by_sdmmc_handle(sdcard, &index);
 
     if(err != ESP_OK) return false;
-    return _efs[index]->cache_size > 0;
+    return _efs[index]->fds.size > 0;
 }
 #endif
 
@@ -629,6 +635,201 @@ exit:
 }
 #endif
 
+/*** Memory-mapped reads ***/
+
+/**
+ * @brief An esp_littlefs_mmap_handle_t: a read-only FD, or a manifest entry,
+ *        plus its spans.
+ */
+struct esp_littlefs_mmap {
+    esp_littlefs_t *efs;
+    int fd;
+#ifdef CONFIG_LITTLEFS_MMAP_PARTITION
+    const littlefs_manifest_entry_t *entry;  /* Counted in efs->manifest; NULL with an FD */
+#endif
+    littlefs_mmap_t map;
+};
+
+/**
+ * @brief What cannot be mapped is read through the FD, like pread().
+ */
+static lfs_ssize_t esp_littlefs_mmap_read(void *ctx, lfs_off_t off, void *buf, lfs_size_t size) {
+    esp_littlefs_mmap_handle_t handle = ctx;
+    ssize_t res = vfs_littlefs_pread(handle->efs, handle->fd, buf, size, off);
+    return res < 0 ? LFS_ERR_IO : res;
+}
+
+#ifdef CONFIG_LITTLEFS_MMAP_PARTITION
+/**
+ * @brief Read LITTLEFS_MANIFEST_PATH, if the image has one. Lock held.
+ */
+static void esp_littlefs_manifest_load(esp_littlefs_t *efs) {
+    lfs_file_t file;
+    struct lfs_file_config cfg = {0};
+    lfs_soff_t size;
+    void *data = NULL;
+    int res;
+
+    efs->manifest_checked = true;
+    res = lfs_file_opencfg(efs->fs, &file, LITTLEFS_MANIFEST_PATH, LFS_O_RDONLY, &cfg);
+    if(res < 0) return;  /* Not a generated image */
+
+    size = lfs_file_size(efs->fs, &file);
+    if(size > 0) data = malloc(size);
+    res = data ? lfs_file_read(efs->fs, &file, data, size) : LFS_ERR_NOMEM;
+    lfs_file_close(efs->fs, &file);
+    if(res != size) {
+        free(data);
+        ESP_LOGW(ESP_LITTLEFS_TAG, "Failed to read " LITTLEFS_MANIFEST_PATH ". Error %d", res);
+        return;
+    }
+
+    res = littlefs_manifest_load(&efs->manifest, data, size, efs->cfg.block_size, efs->fs->block_count);
+    if(res < 0) {
+        ESP_LOGW(ESP_LITTLEFS_TAG, "Ignoring " LITTLEFS_MANIFEST_PATH ". Error %d", res);
+        return;
+    }
+    ESP_LOGV(ESP_LITTLEFS_TAG, "Manifest: %u contiguous files", (unsigned int)efs->manifest.header->count);
+}
+
+/**
+ * @brief `path` is about to be written, removed or renamed. If the manifest
+ *        describes it (or a directory of it), that part would be stale: drop
+ *        it, and remove the manifest from the filesystem for good. Refused
+ *        while a handle is open on one of those entries: its blocks would be
+ *        freed. Lock held exclusive.
+ *
+ * @return 0, or -1 with errno EBUSY
+ */
+static int esp_littlefs_manifest_touch(esp_littlefs_t *efs, const char *path) {
+    littlefs_manifest_t *m = &efs->manifest;
+
+    if(!efs->mmap_data || efs->read_only) return 0;
+    if(!efs->manifest_checked) esp_littlefs_manifest_load(efs);
+    if(!m->header) return 0;
+
+    if(littlefs_manifest_busy(m, path)) {
+        ESP_LOGE(ESP_LITTLEFS_TAG, "\"%s\" is open through " LITTLEFS_MANIFEST_PATH, path);
+        errno = EBUSY;
+        return -1;
+    }
+    if(littlefs_manifest_drop(m, path) == 0 && strcmp(path, LITTLEFS_MANIFEST_PATH) != 0) return 0;
+
+    ESP_LOGW(ESP_LITTLEFS_TAG, "\"%s\" changes; dropping " LITTLEFS_MANIFEST_PATH, path);
+    lfs_remove(efs->fs, LITTLEFS_MANIFEST_PATH);
+    /* The entries still open keep guarding their files until they are closed */
+    if(m->live == 0) littlefs_manifest_free(m);
+    return 0;
+}
+#endif
+
+esp_err_t esp_littlefs_mmap_open(const char* partition_label, const char* path, esp_littlefs_mmap_handle_t* ret_handle) {
+    int index, res;
+    esp_err_t err;
+    esp_littlefs_t *efs;
+    esp_littlefs_mmap_handle_t handle;
+    const void *base = NULL;
+
+    if(!path || !ret_handle) return ESP_ERR_INVALID_ARG;
+    err = esp_littlefs_by_label(partition_label, &index);
+    if(err != ESP_OK) return err;
+    efs = _efs[index];
+    if(efs->fds.size == 0) return ESP_ERR_INVALID_STATE;
+
+    handle = esp_littlefs_calloc(1, sizeof(*handle));
+    if(!handle) return ESP_ERR_NO_MEM;
+    handle->efs = efs;
+
+#ifdef CONFIG_LITTLEFS_MMAP_PARTITION
+    /* Listed in the manifest: no directory lookup, no FD. The open count of
+     * the entry keeps the file from being written, removed or renamed. */
+    if(efs->mmap_data) {
+        const littlefs_manifest_entry_t *entry;
+        sem_take(efs);
+        if(!efs->manifest_checked) esp_littlefs_manifest_load(efs);
+        entry = littlefs_manifest_acquire(&efs->manifest, path);
+        res = entry ? littlefs_mmap_attach_extent(&handle->map, efs->mmap_data, efs->cfg.block_size,
+                entry->first, entry->blocks, entry->size) : LFS_ERR_NOENT;
+        if(entry && res != LFS_ERR_OK) littlefs_manifest_release(&efs->manifest, entry);
+        sem_give(efs);
+        if(res == LFS_ERR_OK) {
+            handle->entry = entry;
+            handle->fd = -1;
+            *ret_handle = handle;
+            return ESP_OK;
+        }
+        if(res == LFS_ERR_NOMEM) {
+            free(handle);
+            return ESP_ERR_NO_MEM;
+        }
+    }
+#endif
+
+    /* A regular FD: unlink / rename refuse the file while it is open */
+    handle->fd = vfs_littlefs_open(efs, path, O_RDONLY, 0);
+    if(handle->fd < 0) {
+        free(handle);
+        return errno == ENOMEM ? ESP_ERR_NO_MEM : ESP_ERR_NOT_FOUND;
+    }
+
+#ifdef CONFIG_LITTLEFS_MMAP_PARTITION
+    base = efs->mmap_data;  /* NULL on an SD card */
+#endif
+    sem_take(efs);
+    vfs_littlefs_file_t *file = littlefs_fd_get(&efs->fds, handle->fd);
+    res = littlefs_mmap_attach(&handle->map, efs->fs, &file->file, base);
+    sem_give(efs);
+    if(res < 0) {
+        ESP_LOGE(ESP_LITTLEFS_TAG, "Failed to map \"%s\". Error %d", path, res);
+        vfs_littlefs_close(efs, handle->fd);
+        free(handle);
+        return res == LFS_ERR_NOMEM ? ESP_ERR_NO_MEM : ESP_FAIL;
+    }
+
+    ESP_LOGV(ESP_LITTLEFS_TAG, "Opened \"%s\" (%u bytes) %s", path, (unsigned int)handle->map.size,
+            littlefs_mmap_mapped(&handle->map) ? "mapped" : "for copying");
+    *ret_handle = handle;
+    return ESP_OK;
+}
+
+esp_err_t esp_littlefs_mmap_close(esp_littlefs_mmap_handle_t handle) {
+    if(!handle) return ESP_ERR_INVALID_ARG;
+    littlefs_mmap_detach(&handle->map);
+#ifdef CONFIG_LITTLEFS_MMAP_PARTITION
+    if(handle->entry) {
+        sem_take(handle->efs);
+        littlefs_manifest_release(&handle->efs->manifest, handle->entry);
+        sem_give(handle->efs);
+    }
+#endif
+    int res = handle->fd < 0 ? 0 : vfs_littlefs_close(handle->efs, handle->fd);
+    free(handle);
+    return res < 0 ? ESP_FAIL : ESP_OK;
+}
+
+size_t esp_littlefs_mmap_size(esp_littlefs_mmap_handle_t handle) {
+    return handle->map.size;
+}
+
+bool esp_littlefs_mmap_is_mapped(esp_littlefs_mmap_handle_t handle) {
+    return littlefs_mmap_mapped(&handle->map);
+}
+
+ssize_t esp_littlefs_mmap_span(esp_littlefs_mmap_handle_t handle, size_t offset, const void** data) {
+    lfs_ssize_t res = littlefs_mmap_span(&handle->map, offset, data);
+    return res < 0 ? -1 : res;
+}
+
+ssize_t esp_littlefs_mmap_get(esp_littlefs_mmap_handle_t handle, size_t offset, size_t size, void* buf, const void** data) {
+    lfs_ssize_t res = littlefs_mmap_get(&handle->map, offset, size, buf, data, esp_littlefs_mmap_read, handle);
+    return res < 0 ? -1 : res;
+}
+
+void esp_littlefs_mmap_stats(esp_littlefs_mmap_handle_t handle, uint64_t* mapped_bytes, uint64_t* copied_bytes) {
+    if(mapped_bytes) *mapped_bytes = handle->map.mapped;
+    if(copied_bytes) *copied_bytes = handle->map.copied;
+}
+
 /********************
  * Static Functions *
  ********************/
@@ -733,13 +934,14 @@ static void esp_littlefs_free(esp_littlefs_t ** efs)
     *efs = NULL;
 
     if (e->fs) {
-        if(e->cache_size > 0) lfs_unmount(e->fs);
+        if(e->fds.size > 0) lfs_unmount(e->fs);
         free(e->fs);
     }
-    if(e->lock) vSemaphoreDelete(e->lock);
+    littlefs_rwlock_deinit(&e->lock);
 
 #ifdef CONFIG_LITTLEFS_MMAP_PARTITION
     esp_partition_munmap(e->mmap_handle);
+    littlefs_manifest_free(&e->manifest);
 #endif
 
     esp_littlefs_free_fds(e);
@@ -956,8 +1158,7 @@ static esp_err_t esp_littlefs_init_sdcard(esp_littlefs_t** efs, sdmmc_card_t* sd
 #endif
     }
 
-    (*efs)->lock = xSemaphoreCreateRecursiveMutex();
-    if ((*efs)->lock == NULL) {
+    if (littlefs_rwlock_init(&(*efs)->lock) < 0) {
         ESP_LOGE(ESP_LITTLEFS_TAG, "mutex lock could not be created");
         return ESP_ERR_NO_MEM;
     }
@@ -1025,8 +1226,7 @@ static esp_err_t esp_littlefs_init_efs(esp_littlefs_t** efs, const esp_partition
 #endif
     }
 
-    (*efs)->lock = xSemaphoreCreateRecursiveMutex();
-    if ((*efs)->lock == NULL) {
+    if (littlefs_rwlock_init(&(*efs)->lock) < 0) {
         ESP_LOGE(ESP_LITTLEFS_TAG, "mutex lock could not be created");
         return ESP_ERR_NO_MEM;
     }
@@ -1163,8 +1363,12 @@ static esp_err_t esp_littlefs_init(const esp_vfs_littlefs_conf_t* conf, int *ind
             err = ESP_FAIL;
             goto exit;
         }
-        efs->cache_size = 4;
-        efs->cache = esp_littlefs_calloc(efs->cache_size, sizeof(*efs->cache));
+        if(littlefs_fd_init(&efs->fds) < 0) {
+            ESP_LOGE(ESP_LITTLEFS_TAG, "Unable to allocate FD table");
+            lfs_unmount(efs->fs);
+            err = ESP_ERR_NO_MEM;
+            goto exit;
+        }
 
         if(conf->grow_on_mount){
 #ifdef CONFIG_LITTLEFS_SDMMC_SUPPORT
@@ -1199,81 +1403,122 @@ exit:
 }
 
 /**
- * @brief
+ * @brief Take the filesystem lock exclusively (recursive)
  * @parameter efs file system context
  */
-static inline int sem_take(esp_littlefs_t *efs) {
-    int res;
+static inline void sem_take(esp_littlefs_t *efs) {
 #if LOG_LOCAL_LEVEL >= 5
     ESP_LOGV(ESP_LITTLEFS_TAG, "------------------------ Sem Taking [%s]", pcTaskGetName(NULL));
 #endif
-    res = xSemaphoreTakeRecursive(efs->lock, portMAX_DELAY);
+    littlefs_rwlock_write_lock(&efs->lock);
 #if LOG_LOCAL_LEVEL >= 5
     ESP_LOGV(ESP_LITTLEFS_TAG, "--------------------->>> Sem Taken [%s]", pcTaskGetName(NULL));
 #endif
-    return res;
 }
 
 /**
  * @brief
  * @parameter efs file system context
  */
-static inline int sem_give(esp_littlefs_t *efs) {
+static inline void sem_give(esp_littlefs_t *efs) {
 #if LOG_LOCAL_LEVEL >= 5
     ESP_LOGV(ESP_LITTLEFS_TAG, "---------------------<<< Sem Give [%s]", pcTaskGetName(NULL));
 #endif
-    return xSemaphoreGiveRecursive(efs->lock);
+    littlefs_rwlock_write_unlock(&efs->lock);
+}
+
+/**
+ * @brief Take the filesystem lock shared, see littlefs_rwlock.h
+ * @parameter efs file system context
+ * @warning Must not be followed by sem_take before sem_give_shared
+ */
+static inline void sem_take_shared(esp_littlefs_t *efs) {
+#if LOG_LOCAL_LEVEL >= 5
+    ESP_LOGV(ESP_LITTLEFS_TAG, "------------------------ Sem Taking shared [%s]", pcTaskGetName(NULL));
+#endif
+    littlefs_rwlock_read_lock(&efs->lock);
+}
+
+/**
+ * @brief
+ * @parameter efs file system context
+ */
+static inline void sem_give_shared(esp_littlefs_t *efs) {
+#if LOG_LOCAL_LEVEL >= 5
+    ESP_LOGV(ESP_LITTLEFS_TAG, "---------------------<<< Sem Give shared [%s]", pcTaskGetName(NULL));
+#endif
+    littlefs_rwlock_read_unlock(&efs->lock);
 }
 
+/**
+ * @brief Lock an open file for a read-only operation (read, pread, lseek).
+ *
+ * Shared with readers of other files when littlefs_file_shareable allows it,
+ * exclusive otherwise.
+ * @param[out] shared how the lock was taken, for esp_littlefs_give_file
+ * @return the file, or NULL (nothing held) if fd is not open
+ */
+static vfs_littlefs_file_t * esp_littlefs_take_file(esp_littlefs_t *efs, int fd, bool *shared) {
+    vfs_littlefs_file_t *file;
+
+    sem_take_shared(efs);
+    file = littlefs_fd_get(&efs->fds, fd);
+    if(file) {
+        littlefs_rwlock_file_lock(&efs->lock, fd);
+        if(littlefs_file_shareable(&file->file)) {
+            *shared = true;
+            return file;
+        }
+        littlefs_rwlock_file_unlock(&efs->lock, fd);
+    }
+    sem_give_shared(efs);
+    if(!file) return NULL;
+
+    /* Buffered writes or inline data: goes through the lfs_t caches */
+    sem_take(efs);
+    *shared = false;
+    file = littlefs_fd_get(&efs->fds, fd);  /* May have been closed meanwhile */
+    if(!file) sem_give(efs);
+    return file;
+}
 
-/* We are using a double allocation system here, which an array and a linked list.
-   The array contains the pointer to the file descriptor (the index in the array is what's returned to the user).
-   The linked list is used for file descriptors.
-   This means that position of nodes in the list must stay consistent:
-   - Allocation is obvious (append to the list from the head, and realloc the pointers array)
-     There is still a O(N) search in the cache for a free position to store
-   - Searching is a O(1) process (good)
-   - Deallocation is more tricky. That is, for example,
-     if you need to remove node 5 in a 12 nodes list, you'll have to:
-       1) Mark the 5th position as freed (if it's the last position of the array realloc smaller)
-       2) Walk the list until finding the pointer to the node O(N) and scrub the node so the chained list stays consistent
-       3) Deallocate the node
+/**
+ * @brief Release what esp_littlefs_take_file took.
+ */
+static void esp_littlefs_give_file(esp_littlefs_t *efs, int fd, bool shared) {
+    if(shared) {
+        littlefs_rwlock_file_unlock(&efs->lock, fd);
+        sem_give_shared(efs);
+    } else {
+        sem_give(efs);
+    }
+}
+
+
+/* File descriptors live in a littlefs_fd_table_t (see littlefs_fd.h):
+   - Allocation pops the table's free list, doubling the table when it is full: O(1) amortized
+   - Getting the file of a FD indexes an array: O(1)
+   - Releasing pushes the FD back on the free list: O(1)
+   - Finding the FD of an open path (unlink, rename) probes a hash index: O(1) expected
+   The vfs_littlefs_file_t of each FD is a separate allocation owned by this file.
 */
 
 /**
  * @brief Get a file descriptor
  * @param[in,out] efs       file system context
  * @param[out]    file      pointer to a file that'll be filled with a file object
+ * @param[in]     hash      hash of the file path, see compute_hash
  * @param[in]     path_len  the length of the filepath in bytes (including terminating zero byte)
  * @return integer file descriptor. Returns -1 if a FD cannot be obtained.
  * @warning This must be called with lock taken
  */
-static int esp_littlefs_allocate_fd(esp_littlefs_t *efs, vfs_littlefs_file_t ** file
+static int esp_littlefs_allocate_fd(esp_littlefs_t *efs, vfs_littlefs_file_t ** file, uint32_t hash
 #ifndef CONFIG_LITTLEFS_USE_ONLY_HASH
   , const size_t path_len
 #endif
     )
 {
-    int i = -1;
-
-    assert( efs->fd_count < UINT16_MAX );
-    assert( efs->cache_size < UINT16_MAX );
-
-    /* Make sure there is enough space in the cache to store new fd */
-    if (efs->fd_count + 1 > efs->cache_size) {
-        uint16_t new_size = (uint16_t)MIN(UINT16_MAX, CONFIG_LITTLEFS_FD_CACHE_REALLOC_FACTOR * efs->cache_size);
-        /* Resize the cache */
-        vfs_littlefs_file_t ** new_cache = realloc(efs->cache, new_size * sizeof(*efs->cache));
-        if (!new_cache) {
-            ESP_LOGE(ESP_LITTLEFS_TAG, "Unable to allocate file cache");
-            return -1; /* If it fails here, no harm is done to the filesystem, so it's safe */
-        }
-        /* Zero out the new portions of the cache */
-        memset(&new_cache[efs->cache_size], 0, (new_size - efs->cache_size) * sizeof(*efs->cache));
-        efs->cache = new_cache;
-        efs->cache_size = new_size;
-    }
-
+    int fd;
 
     /* Allocate file descriptor here now */
 #ifndef CONFIG_LITTLEFS_USE_ONLY_HASH
@@ -1283,19 +1528,27 @@ static int esp_littlefs_allocate_fd(esp_littlefs_t *efs, vfs_littlefs_file_t **
 #endif
 
     if (*file == NULL) {
-        /* If it fails here, the file system might have a larger cache, but it's harmless, no need to reverse it */
         ESP_LOGE(ESP_LITTLEFS_TAG, "Unable to allocate FD");
         return -1;
     }
 
+    fd = littlefs_fd_alloc(&efs->fds, *file, hash);
+    if (fd < 0) {
+        /* The table is left as it was, no harm is done to the filesystem */
+        ESP_LOGE(ESP_LITTLEFS_TAG, "Unable to grow FD table (%d open)", efs->fds.count);
+        free(*file);
+        *file = NULL;
+        return -1;
+    }
+
     /* Starting from here, nothing can fail anymore */
 
 #ifndef CONFIG_LITTLEFS_USE_ONLY_HASH
     /* The trick here is to avoid dual allocation so the path pointer
         should point to the next byte after it:
-        file => [ lfs_file | # | next | path | free_space ]
-                                            |  /\
-                                            |__/
+        file => [ lfs_file | # | path | free_space ]
+                                |  /\
+                                |__/
     */
     (*file)->path = (char*)(*file) + sizeof(**file);
 #endif
@@ -1310,93 +1563,26 @@ static int esp_littlefs_allocate_fd(esp_littlefs_t *efs, vfs_littlefs_file_t **
 #endif
     (*file)->lfs_file_config.attr_count = ESP_LITTLEFS_ATTR_COUNT;
 
-    /* Now find a free place in cache */
-    for(i=0; i < efs->cache_size; i++) {
-        if (efs->cache[i] == NULL) {
-            efs->cache[i] = *file;
-            break;
-        }
-    }
-    /* Save file in the list */
-    (*file)->next = efs->file;
-    efs->file = *file;
-    efs->fd_count++;
-    return i;
+    return fd;
 }
 
 /**
  * @brief Release a file descriptor
  * @param[in,out] efs file system context
  * @param[in] fd File Descriptor to release
- * @return 0 on success. -1 if a FD cannot be obtained.
+ * @return 0 on success. -1 if fd is not open.
  * @warning This must be called with lock taken
  */
 static int esp_littlefs_free_fd(esp_littlefs_t *efs, int fd){
-    vfs_littlefs_file_t * file, * head;
+    vfs_littlefs_file_t * file = littlefs_fd_free(&efs->fds, fd);
 
-    if((uint32_t)fd >= efs->cache_size) {
-        ESP_LOGE(ESP_LITTLEFS_TAG, "FD %d must be <%d.", fd, efs->cache_size);
+    if(!file) {
+        ESP_LOGE(ESP_LITTLEFS_TAG, "FD %d is not open.", fd);
         return -1;
     }
 
-    /* Get the file descriptor to free it */
-    file = efs->cache[fd];
-    head = efs->file;
-    /* Search for file in SLL to remove it */
-    if (file == head) {
-        /* Last file, can't fail */
-        efs->file = efs->file->next;
-    } else {
-        while (head && head->next != file) {
-            head = head->next;
-        }
-        if (!head) {
-            ESP_LOGE(ESP_LITTLEFS_TAG, "Inconsistent list");
-            return -1;
-        }
-        /* Transaction starts here and can't fail anymore */
-        head->next = file->next;
-    }
-    efs->cache[fd] = NULL;
-    efs->fd_count--;
-
     ESP_LOGV(ESP_LITTLEFS_TAG, "Clearing FD");
     free(file);
-
-#if 0
-    /* Realloc smaller if its possible
-     *     * Find and realloc based on number of trailing NULL ptrs in cache
-     *     * Leave some hysteris to prevent thrashing around resize points
-     * This is disabled for now because it adds unnecessary complexity
-     * and binary size increase that outweights its ebenfits.
-     */
-    if(efs->cache_size > CONFIG_LITTLEFS_FD_CACHE_MIN_SIZE) {
-        uint16_t n_free;
-        uint16_t new_size = efs->cache_size / CONFIG_LITTLEFS_FD_CACHE_REALLOC_FACTOR;
-
-        if(new_size >= CONFIG_LITTLEFS_FD_CACHE_MIN_SIZE) {
-            /* Count number of trailing NULL ptrs */
-            for(n_free=0; n_free < efs->cache_size; n_free++) {
-                if(efs->cache[efs->cache_size - n_free - 1] != NULL) {
-                    break;
-                }
-            }
-
-            if(n_free >= (efs->cache_size - new_size)){
-                new_size += CONFIG_LITTLEFS_FD_CACHE_HYST;
-                ESP_LOGV(ESP_LITTLEFS_TAG, "Reallocating cache %i -> %i", efs->cache_size, new_size);
-                vfs_littlefs_file_t ** new_cache;
-                new_cache = realloc(efs->cache, new_size * sizeof(*efs->cache));
-                /* No harm on realloc failure, continue using the oversized cache */
-                if(new_cache) {
-                    efs->cache = new_cache;
-                    efs->cache_size = new_size;
-                }
-            }
-        }
-    }
-#endif
-
     return 0;
 }
 
@@ -1415,6 +1601,15 @@ static uint32_t compute_hash(const char * path) {
 }
 
 #ifdef CONFIG_VFS_SUPPORT_DIR
+#ifndef CONFIG_LITTLEFS_USE_ONLY_HASH
+/**
+ * @brief Confirms a hash hit in the FD table, in case of hash collision.
+ */
+static bool esp_littlefs_path_match(const void *file, const void *path) {
+    return strcmp((const char *)path, ((const vfs_littlefs_file_t *)file)->path) == 0;
+}
+#endif
+
 /**
  * @brief finds an open file descriptor by file name.
  * @param[in,out] efs file system context
@@ -1425,25 +1620,18 @@ static uint32_t compute_hash(const char * path) {
  *          erroneous FD may be returned on hash collision.
  */
 static int esp_littlefs_get_fd_by_name(esp_littlefs_t *efs, const char *path){
-    uint32_t hash = compute_hash(path);
-
-    for(uint16_t i=0, j=0; i < efs->cache_size && j < efs->fd_count; i++){
-        if (efs->cache[i]) {
-            ++j;
-
-            if (
-                efs->cache[i]->hash == hash  // Faster than strcmp
 #ifndef CONFIG_LITTLEFS_USE_ONLY_HASH
-                && strcmp(path, efs->cache[i]->path) == 0  // May as well check incase of hash collision. Usually short-circuited.
+    int fd = littlefs_fd_find(&efs->fds, compute_hash(path), esp_littlefs_path_match, path);
+#else
+    int fd = littlefs_fd_find(&efs->fds, compute_hash(path), NULL, NULL);
 #endif
-            ) {
-                ESP_LOGV(ESP_LITTLEFS_TAG, "Found \"%s\" at FD %d.", path, i);
-                return i;
-            }
-        }
+
+    if(fd >= 0) {
+        ESP_LOGV(ESP_LITTLEFS_TAG, "Found \"%s\" at FD %d.", path, fd);
+    } else {
+        ESP_LOGV(ESP_LITTLEFS_TAG, "Unable to get a find FD for \"%s\"", path);
     }
-    ESP_LOGV(ESP_LITTLEFS_TAG, "Unable to get a find FD for \"%s\"", path);
-    return -1;
+    return fd;
 }
 #endif
 
@@ -1474,6 +1662,13 @@ static int vfs_littlefs_open(void* ctx, const char * path, int flags, int mode)
     /* Get a FD */
     sem_take(efs);
 
+#ifdef CONFIG_LITTLEFS_MMAP_PARTITION
+    if(lfs_flags != LFS_O_RDONLY && esp_littlefs_manifest_touch(efs, path) < 0) {
+        sem_give(efs);
+        return LFS_ERR_INVAL;
+    }
+#endif
+
 #if CONFIG_LITTLEFS_OPEN_DIR
     /* Check if it is a file with same path */
     if (flags & O_DIRECTORY) {
@@ -1489,7 +1684,7 @@ static int vfs_littlefs_open(void* ctx, const char * path, int flags, int mode)
     }
 #endif
 
-    fd = esp_littlefs_allocate_fd(efs, &file
+    fd = esp_littlefs_allocate_fd(efs, &file, compute_hash(path)
 #ifndef CONFIG_LITTLEFS_USE_ONLY_HASH
     , path_len
 #endif
@@ -1571,7 +1766,6 @@ static int vfs_littlefs_open(void* ctx, const char * path, int flags, int mode)
     }
 #endif
 
-    file->hash = compute_hash(path);
 #ifndef CONFIG_LITTLEFS_USE_ONLY_HASH
     memcpy(file->path, path, path_len);
 #endif
@@ -1587,13 +1781,13 @@ static ssize_t vfs_littlefs_write(void* ctx, int fd, const void * data, size_t s
     vfs_littlefs_file_t *file = NULL;
 
     sem_take(efs);
-    if((uint32_t)fd > efs->cache_size) {
+    file = littlefs_fd_get(&efs->fds, fd);
+    if(!file) {
         sem_give(efs);
-        ESP_LOGE(ESP_LITTLEFS_TAG, "FD %d must be <%d.", fd, efs->cache_size);
+        ESP_LOGE(ESP_LITTLEFS_TAG, "FD %d is not open.", fd);
         errno = EBADF;
         return -1;
     }
-    file = efs->cache[fd];
     res = lfs_file_write(efs->fs, &file->file, data, size);
 #ifdef CONFIG_LITTLEFS_FLUSH_FILE_EVERY_WRITE
     if(res > 0) {
@@ -1621,17 +1815,16 @@ static ssize_t vfs_littlefs_read(void* ctx, int fd, void * dst, size_t size) {
     esp_littlefs_t * efs = (esp_littlefs_t *)ctx;
     ssize_t res;
     vfs_littlefs_file_t *file = NULL;
+    bool shared;
 
-    sem_take(efs);
-    if((uint32_t)fd > efs->cache_size) {
-        sem_give(efs);
-        ESP_LOGE(ESP_LITTLEFS_TAG, "FD %d must be <%d.", fd, efs->cache_size);
+    file = esp_littlefs_take_file(efs, fd, &shared);
+    if(!file) {
+        ESP_LOGE(ESP_LITTLEFS_TAG, "FD %d is not open.", fd);
         errno = EBADF;
         return -1;
     }
-    file = efs->cache[fd];
     res = lfs_file_read(efs->fs, &file->file, dst, size);
-    sem_give(efs);
+    esp_littlefs_give_file(efs, fd, shared);
 
     if(res < 0){
         errno = lfs_errno_remap(res);
@@ -1655,26 +1848,28 @@ static ssize_t vfs_littlefs_pwrite(void *ctx, int fd, const void *src, size_t si
     vfs_littlefs_file_t *file = NULL;
 
     sem_take(efs);
-    if ((uint32_t)fd > efs->cache_size)
-    {
+    file = littlefs_fd_get(&efs->fds, fd);
+    if(!file) {
         sem_give(efs);
-        ESP_LOGE(ESP_LITTLEFS_TAG, "FD %d must be <%d.", fd, efs->cache_size);
+        ESP_LOGE(ESP_LITTLEFS_TAG, "FD %d is not open.", fd);
         errno = EBADF;
         return -1;
     }
-    file = efs->cache[fd];
 
     off_t old_offset = lfs_file_seek(efs->fs, &file->file, 0, SEEK_CUR);
     if (old_offset < (off_t)0)
     {
         res = old_offset;
+        sem_give(efs);
         goto exit;
     }
 
     /* Set to wanted position.  */
     res = lfs_file_seek(efs->fs, &file->file, offset, SEEK_SET);
-    if (res < (off_t)0)
+    if (res < (off_t)0) {
+        sem_give(efs);
         goto exit;
+    }
 
     /* Write out the data.  */
     res = lfs_file_write(efs->fs, &file->file, src, size);
@@ -1711,28 +1906,29 @@ static ssize_t vfs_littlefs_pread(void *ctx, int fd, void *dst, size_t size, off
     esp_littlefs_t *efs = (esp_littlefs_t *)ctx;
     ssize_t res, save_res;
     vfs_littlefs_file_t *file = NULL;
+    bool shared;
 
-    sem_take(efs);
-    if ((uint32_t)fd > efs->cache_size)
-    {
-        sem_give(efs);
-        ESP_LOGE(ESP_LITTLEFS_TAG, "FD %d must be <%d.", fd, efs->cache_size);
+    file = esp_littlefs_take_file(efs, fd, &shared);
+    if(!file) {
+        ESP_LOGE(ESP_LITTLEFS_TAG, "FD %d is not open.", fd);
         errno = EBADF;
         return -1;
     }
-    file = efs->cache[fd];
 
     off_t old_offset = lfs_file_seek(efs->fs, &file->file, 0, SEEK_CUR);
     if (old_offset < (off_t)0)
     {
         res = old_offset;
+        esp_littlefs_give_file(efs, fd, shared);
         goto exit;
     }
 
     /* Set to wanted position.  */
     res = lfs_file_seek(efs->fs, &file->file, offset, SEEK_SET);
-    if (res < (off_t)0)
+    if (res < (off_t)0) {
+        esp_littlefs_give_file(efs, fd, shared);
         goto exit;
+    }
 
     /* Read the data.  */
     res = lfs_file_read(efs->fs, &file->file, dst, size);
@@ -1745,7 +1941,7 @@ static ssize_t vfs_littlefs_pread(void *ctx, int fd, void *dst, size_t size, off
     {
         res = save_res;
     }
-    sem_give(efs);
+    esp_littlefs_give_file(efs, fd, shared);
 
 exit:
     if (res < 0)
@@ -1770,15 +1966,14 @@ static int vfs_littlefs_close(void* ctx, int fd) {
     vfs_littlefs_file_t *file = NULL;
 
     sem_take(efs);
-    if((uint32_t)fd > efs->cache_size) {
+    file = littlefs_fd_get(&efs->fds, fd);
+    if(!file) {
         sem_give(efs);
-        ESP_LOGE(ESP_LITTLEFS_TAG, "FD %d must be <%d.", fd, efs->cache_size);
+        ESP_LOGE(ESP_LITTLEFS_TAG, "FD %d is not open.", fd);
         errno = EBADF;
         return -1;
     }
 
-    file = efs->cache[fd];
-
 #if CONFIG_LITTLEFS_OPEN_DIR
     if ((file->file.flags & O_DIRECTORY) == 0) {
 #endif
@@ -1815,6 +2010,7 @@ static off_t vfs_littlefs_lseek(void* ctx, int fd, off_t offset, int mode) {
     lfs_soff_t res;
     vfs_littlefs_file_t *file = NULL;
     int whence;
+    bool shared;
 
     switch (mode) {
         case SEEK_SET: whence = LFS_SEEK_SET; break;
@@ -1826,16 +2022,14 @@ static off_t vfs_littlefs_lseek(void* ctx, int fd, off_t offset, int mode) {
             return -1;
     }
 
-    sem_take(efs);
-    if((uint32_t)fd > efs->cache_size) {
-        sem_give(efs);
-        ESP_LOGE(ESP_LITTLEFS_TAG, "FD %d must be <%d.", fd, efs->cache_size);
+    file = esp_littlefs_take_file(efs, fd, &shared);
+    if(!file) {
+        ESP_LOGE(ESP_LITTLEFS_TAG, "FD %d is not open.", fd);
         errno = EBADF;
         return -1;
     }
-    file = efs->cache[fd];
     res = lfs_file_seek(efs->fs, &file->file, offset, whence);
-    sem_give(efs);
+    esp_littlefs_give_file(efs, fd, shared);
 
     if(res < 0){
         errno = lfs_errno_remap(res);
@@ -1860,13 +2054,13 @@ static int vfs_littlefs_fsync(void* ctx, int fd)
 
 
     sem_take(efs);
-    if((uint32_t)fd > efs->cache_size) {
+    file = littlefs_fd_get(&efs->fds, fd);
+    if(!file) {
         sem_give(efs);
-        ESP_LOGE(ESP_LITTLEFS_TAG, "FD %d must be <%d.", fd, efs->cache_size);
+        ESP_LOGE(ESP_LITTLEFS_TAG, "FD %d is not open.", fd);
         errno = EBADF;
         return -1;
     }
-    file = efs->cache[fd];
     res = esp_littlefs_file_sync(efs, file);
     sem_give(efs);
 
@@ -1887,45 +2081,43 @@ static int vfs_littlefs_fsync(void* ctx, int fd)
 #ifndef CONFIG_LITTLEFS_USE_ONLY_HASH
 static int vfs_littlefs_fstat(void* ctx, int fd, struct stat * st) {
     esp_littlefs_t * efs = (esp_littlefs_t *)ctx;
-    struct lfs_info info;
-    int res;
     vfs_littlefs_file_t *file = NULL;
 
     memset(st, 0, sizeof(struct stat));
     st->st_blksize = efs->cfg.block_size;
 
-    sem_take(efs);
-    if((uint32_t)fd > efs->cache_size) {
-        sem_give(efs);
-        ESP_LOGE(ESP_LITTLEFS_TAG, "FD must be <%d.", efs->cache_size);
+    /* Answered from the open file instead of lfs_stat on its path: nothing
+     * goes through the lfs_t caches, so this runs alongside other readers.
+     * The size includes writes that are not synced yet. */
+    sem_take_shared(efs);
+    file = littlefs_fd_get(&efs->fds, fd);
+    if(!file) {
+        sem_give_shared(efs);
+        ESP_LOGE(ESP_LITTLEFS_TAG, "FD %d is not open.", fd);
         errno = EBADF;
         return -1;
     }
-    file = efs->cache[fd];
-    res = lfs_stat(efs->fs, file->path, &info);
-    if (res < 0) {
-        errno = lfs_errno_remap(res);
-        sem_give(efs);
-        ESP_LOGV(ESP_LITTLEFS_TAG, "Failed to stat file \"%s\". Error %s (%d)",
-                file->path, esp_littlefs_errno(res), res);
-        return -1;
+    littlefs_rwlock_file_lock(&efs->lock, fd);
+
+#if CONFIG_LITTLEFS_OPEN_DIR
+    if (file->file.flags & O_DIRECTORY) {
+        // Directory
+        st->st_mode = S_IFDIR;
+        st->st_size = 0;
+    } else
+#endif
+    {
+        // Regular File
+        st->st_mode = S_IFREG;
+        st->st_size = lfs_file_size(efs->fs, &file->file);
     }
 
 #if CONFIG_LITTLEFS_USE_MTIME
     st->st_mtime = file->lfs_attr_time_buffer;
 #endif
 
-    sem_give(efs);
-    if(info.type==LFS_TYPE_REG){
-        // Regular File
-        st->st_mode = S_IFREG;
-        st->st_size = info.size;
-    }
-    else{
-        // Directory
-        st->st_mode = S_IFDIR;
-        st->st_size = 0;  // info.size is only valid for REG files
-    }
+    littlefs_rwlock_file_unlock(&efs->lock, fd);
+    sem_give_shared(efs);
     return 0;
 }
 #endif
@@ -1999,6 +2191,13 @@ static int vfs_littlefs_unlink(void* ctx, const char *path) {
         return -1;
     }
 
+#ifdef CONFIG_LITTLEFS_MMAP_PARTITION
+    if(esp_littlefs_manifest_touch(efs, path) < 0) {
+        sem_give(efs);
+        return -1;
+    }
+#endif
+
     res = lfs_remove(efs->fs, path);
     if (res < 0) {
         errno = lfs_errno_remap(res);
@@ -2038,6 +2237,17 @@ static int vfs_littlefs_rename(void* ctx, const char *src, const char *dst) {
         return -1;
     }
 
+#ifdef CONFIG_LITTLEFS_MMAP_PARTITION
+    /* Both checked before either drops its entries */
+    if(littlefs_manifest_busy(&efs->manifest, dst) ||
+            esp_littlefs_manifest_touch(efs, src) < 0 || esp_littlefs_manifest_touch(efs, dst) < 0) {
+        sem_give(efs);
+        ESP_LOGE(ESP_LITTLEFS_TAG, "Cannot rename; \"%s\" or \"%s\" is open.", src, dst);
+        errno = EBUSY;
+        return -1;
+    }
+#endif
+
 #if CONFIG_LITTLEFS_SPIFFS_COMPAT
     /* Create all parent directories to dst (if necessary) */
     ESP_LOGV(ESP_LITTLEFS_TAG, "LITTLEFS_SPIFFS_COMPAT attempting to create all directories for %s", src);
@@ -2284,14 +2494,13 @@ static ssize_t vfs_littlefs_truncate( void *ctx, const char *path, off_t size )
     int fd = vfs_littlefs_open( ctx, path, LFS_O_RDWR, 438 );
 
     sem_take(efs);
-    if((uint32_t)fd > efs->cache_size)
-    {
+    file = littlefs_fd_get(&efs->fds, fd);
+    if(!file) {
         sem_give(efs);
-        ESP_LOGE(ESP_LITTLEFS_TAG, "FD %d must be <%d.", fd, efs->cache_size);
+        ESP_LOGE(ESP_LITTLEFS_TAG, "FD %d is not open.", fd);
         errno = EBADF;
         return -1;
     }
-    file = efs->cache[fd];
     res = lfs_file_truncate( efs->fs, &file->file, size );
     sem_give(efs);
 
@@ -2323,13 +2532,13 @@ static int vfs_littlefs_ftruncate(void *ctx, int fd, off_t size)
     vfs_littlefs_file_t *file = NULL;
 
     sem_take(efs);
-    if((uint32_t)fd > efs->cache_size) {
+    file = littlefs_fd_get(&efs->fds, fd);
+    if(!file) {
         sem_give(efs);
-        ESP_LOGE(ESP_LITTLEFS_TAG, "FD %d must be <%d.", fd, efs->cache_size);
+        ESP_LOGE(ESP_LITTLEFS_TAG, "FD %d is not open.", fd);
         errno = EBADF;
         return -1;
     }
-    file = efs->cache[fd];
     res = lfs_file_truncate( efs->fs, &file->file, size );
     sem_give(efs);
 
@@ -2523,21 +2732,14 @@ static int vfs_littlefs_fcntl(void* ctx, int fd, int cmd, int arg)
     const uint32_t flags_mask = LFS_O_WRONLY | LFS_O_RDONLY | LFS_O_RDWR;
 
     sem_take(efs);
-    if((uint32_t)fd > efs->cache_size) {
-        sem_give(efs);
-        ESP_LOGE(ESP_LITTLEFS_TAG, "FD %d must be <%d.", fd, efs->cache_size);
-        errno = EBADF;
-        return -1;
-    }
-
-    file = efs->cache[fd];
-    if (file) {
-        lfs_file = &efs->cache[fd]->file;
-    } else {
+    file = littlefs_fd_get(&efs->fds, fd);
+    if(!file) {
         sem_give(efs);
+        ESP_LOGE(ESP_LITTLEFS_TAG, "FD %d is not open.", fd);
         errno = EBADF;
         return -1;
     }
+    lfs_file = &file->file;
 
     if (cmd == F_GETFL) {
         if ((lfs_file->flags & flags_mask) == LFS_O_WRONLY) {
@@ -9,6 +9,9 @@
 #include "esp_vfs.h"
 #include "esp_partition.h"
 #include "littlefs/lfs.h"
+#include "littlefs_fd.h"
+#include "littlefs_manifest.h"
+#include "littlefs_rwlock.h"
 #include "sdkconfig.h"
 
 #ifdef CONFIG_LITTLEFS_SDMMC_SUPPORT
@@ -27,7 +30,7 @@ extern "C" {
 
 /**
  * @brief a file descriptor
- * That's also a singly linked list used for keeping tracks of all opened file descriptor 
+ * Open files are tracked by the FD table of esp_littlefs_t (littlefs_fd.h)
  *
  * Shortcomings/potential issues of 32-bit hash (when CONFIG_LITTLEFS_USE_ONLY_HASH) listed here:
  *     * unlink - If a different file is open that generates a hash collision, it will report an
@@ -52,8 +55,6 @@ typedef struct _vfs_littlefs_file_t {
     time_t lfs_attr_time_buffer;
 #endif
 
-    uint32_t hash;
-    struct _vfs_littlefs_file_t * next;       /*!< Pointer to next file in Singly Linked List */
 #ifndef CONFIG_LITTLEFS_USE_ONLY_HASH
     char     * path;
 #endif
@@ -64,7 +65,7 @@ typedef struct _vfs_littlefs_file_t {
  */
 typedef struct {
     lfs_t *fs;                                /*!< Handle to the underlying littlefs */
-    SemaphoreHandle_t lock;                   /*!< FS lock */
+    littlefs_rwlock_t lock;                   /*!< FS lock: shared for reads of open files, else exclusive */
 
 #ifdef CONFIG_LITTLEFS_SDMMC_SUPPORT
     sdmmc_card_t *sdcard;                     /*!< The SD card driver handle on which littlefs is located */
@@ -75,17 +76,15 @@ typedef struct {
 #ifdef CONFIG_LITTLEFS_MMAP_PARTITION
     const void *mmap_data;                    /*!< Buffer of mmapped partition */
     esp_partition_mmap_handle_t mmap_handle;  /*!< Handle to mmapped partition */
+    littlefs_manifest_t manifest;             /*!< Contiguous files of a generated image (littlefs_mkimage) */
+    bool manifest_checked;                    /*!< The manifest was looked for since the mount */
 #endif
 
     char base_path[ESP_VFS_PATH_MAX+1];       /*!< Mount point */
 
     struct lfs_config cfg;                    /*!< littlefs Mount configuration */
 
-    vfs_littlefs_file_t *file;                /*!< Singly Linked List of files */
-
-    vfs_littlefs_file_t **cache;              /*!< A cache of pointers to the opened files */
-    uint16_t             cache_size;          /*!< The cache allocated size (in pointers) */
-    uint16_t             fd_count;            /*!< The count of opened file descriptor used to speed up computation */
+    littlefs_fd_table_t  fds;                 /*!< Opened files by FD and by path hash; size is 0 while unmounted */
     bool                 read_only;           /*!< Filesystem is read-only */
 } esp_littlefs_t;
 
@@ -0,0 +1,148 @@
+/**
+ * @file littlefs_fd.c
+ * @brief O(1) file descriptor table, see littlefs_fd.h
+ */
+
+#include "littlefs_fd.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef LITTLEFS_FD_MALLOC
+#define LITTLEFS_FD_MALLOC malloc
+#else
+void *LITTLEFS_FD_MALLOC(size_t size);  /* host/bench_littlefs_fd.c makes it fail on demand */
+#endif
+#ifndef LITTLEFS_FD_FREE
+#define LITTLEFS_FD_FREE free
+#endif
+
+#define FD_NONE LITTLEFS_FD_MAX_SIZE
+
+/**
+ * @brief Home position of a hash in an index of `mask + 1` positions.
+ *
+ * The DJB2 path hash varies mostly in its low bits for paths that share a
+ * prefix, so spread it with a multiplicative mix first.
+ */
+static inline uint32_t fd_home(uint32_t hash, uint32_t mask) {
+    hash *= 0x9E3779B1u;
+    return (hash ^ (hash >> 16)) & mask;
+}
+
+static inline uint32_t fd_index_mask(const littlefs_fd_table_t *t) {
+    return 2u * t->size - 1;
+}
+
+static void fd_index_insert(littlefs_fd_table_t *t, uint16_t fd) {
+    uint32_t mask = fd_index_mask(t);
+    uint32_t i = fd_home(t->hash[fd], mask);
+    while(t->index[i]) i = (i + 1) & mask;
+    t->index[i] = fd + 1;
+}
+
+/**
+ * @brief Remove fd from the index by backward shift, so lookups never need
+ *        tombstones and stay short after many open/close cycles.
+ */
+static void fd_index_remove(littlefs_fd_table_t *t, uint16_t fd) {
+    uint32_t mask = fd_index_mask(t);
+    uint32_t i = fd_home(t->hash[fd], mask);
+    while(t->index[i] != fd + 1) i = (i + 1) & mask;
+
+    uint32_t j = i;
+    for(;;) {
+        j = (j + 1) & mask;
+        if(!t->index[j]) break;
+        uint32_t k = fd_home(t->hash[t->index[j] - 1], mask);
+        /* Entry j may move back to i only if its home is not within (i, j] */
+        if(i <= j ? (i < k && k <= j) : (i < k || k <= j)) continue;
+        t->index[i] = t->index[j];
+        i = j;
+    }
+    t->index[i] = 0;
+}
+
+/**
+ * @brief Allocate the arrays for `size` slots and move the old table over.
+ * @return 0 on success, -1 if out of memory (t is left untouched)
+ */
+static int fd_resize(littlefs_fd_table_t *t, uint32_t size) {
+    size_t bytes = size * (sizeof(void *) + sizeof(uint32_t) + 3 * sizeof(uint16_t));
+    uint8_t *mem = LITTLEFS_FD_MALLOC(bytes);
+    if(!mem) return -1;
+    memset(mem, 0, bytes);
+
+    littlefs_fd_table_t n = {
+        .file      = (void **)mem,
+        .hash      = (uint32_t *)(mem + size * sizeof(void *)),
+        .next_free = (uint16_t *)(mem + size * (sizeof(void *) + sizeof(uint32_t))),
+        .index     = (uint16_t *)(mem + size * (sizeof(void *) + sizeof(uint32_t) + sizeof(uint16_t))),
+        .size      = (uint16_t)size,
+        .count     = t->count,
+        .free_head = t->size,
+    };
+    if(t->size) {
+        memcpy(n.file, t->file, t->size * sizeof(*n.file));
+        memcpy(n.hash, t->hash, t->size * sizeof(*n.hash));
+        LITTLEFS_FD_FREE(t->file);
+    }
+    /* Only grown when full: the old slots are all open, the new ones all free */
+    for(uint32_t fd = t->size; fd < size; fd++) {
+        n.next_free[fd] = fd + 1 < size ? fd + 1 : FD_NONE;
+    }
+    for(uint32_t fd = 0; fd < t->size; fd++) {
+        fd_index_insert(&n, fd);
+    }
+    *t = n;
+    return 0;
+}
+
+int littlefs_fd_init(littlefs_fd_table_t *t) {
+    memset(t, 0, sizeof(*t));
+    return fd_resize(t, LITTLEFS_FD_MIN_SIZE);
+}
+
+void littlefs_fd_deinit(littlefs_fd_table_t *t) {
+    if(t->size) LITTLEFS_FD_FREE(t->file);
+    memset(t, 0, sizeof(*t));
+}
+
+int littlefs_fd_alloc(littlefs_fd_table_t *t, void *file, uint32_t hash) {
+    if(!t->size) return -1;
+    if(t->free_head == FD_NONE) {
+        if(t->size >= LITTLEFS_FD_MAX_SIZE || fd_resize(t, 2u * t->size) < 0) return -1;
+    }
+
+    uint16_t fd = t->free_head;
+    t->free_head = t->next_free[fd];
+    t->file[fd] = file;
+    t->hash[fd] = hash;
+    fd_index_insert(t, fd);
+    t->count++;
+    return fd;
+}
+
+void *littlefs_fd_free(littlefs_fd_table_t *t, int fd) {
+    void *file = littlefs_fd_get(t, fd);
+    if(!file) return NULL;
+
+    fd_index_remove(t, (uint16_t)fd);
+    t->file[fd] = NULL;
+    t->next_free[fd] = t->free_head;
+    t->free_head = (uint16_t)fd;
+    t->count--;
+    return file;
+}
+
+int littlefs_fd_find(const littlefs_fd_table_t *t, uint32_t hash,
+                     littlefs_fd_match_t match, const void *ctx) {
+    if(!t->count) return -1;
+
+    uint32_t mask = fd_index_mask(t);
+    for(uint32_t i = fd_home(hash, mask); t->index[i]; i = (i + 1) & mask) {
+        uint16_t fd = t->index[i] - 1;
+        if(t->hash[fd] == hash && (!match || match(t->file[fd], ctx))) return fd;
+    }
+    return -1;
+}
@@ -0,0 +1,101 @@
+/**
+ * @file littlefs_fd.h
+ * @brief File descriptor table of the VFS wrapper
+ *
+ * Maps the integer FDs handed out to the VFS onto open files, and open paths
+ * (by hash) back onto FDs, all in O(1):
+ *   - allocation pops a free list, release pushes the FD back on it
+ *     (no scan for an empty slot, no walk of a list of open files);
+ *   - lookup by path (unlink / rename of an open file) probes an open
+ *     addressing index keyed by the path hash instead of comparing every
+ *     open file.
+ *
+ * Only RAM bookkeeping, nothing here touches the on-disk format. Does not
+ * depend on ESP-IDF so it can be exercised on the host (host/bench_littlefs_fd.c).
+ */
+#ifndef ESP_LITTLEFS_FD_H__
+#define ESP_LITTLEFS_FD_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define LITTLEFS_FD_MIN_SIZE 4      /*!< Slots allocated on mount, doubled on demand */
+#define LITTLEFS_FD_MAX_SIZE 32768  /*!< FDs and index positions must fit in a uint16_t */
+
+/**
+ * @brief Compare an open file with the path being looked up.
+ * @return true if file is the one that was looked for
+ */
+typedef bool (*littlefs_fd_match_t)(const void *file, const void *ctx);
+
+/**
+ * @brief FD table
+ *
+ * All arrays live in a single allocation of `size` slots; the index has
+ * 2 * `size` positions so its load factor never exceeds 1/2.
+ */
+typedef struct {
+    void     **file;       /*!< FD -> open file, NULL if the FD is free */
+    uint32_t  *hash;       /*!< FD -> path hash of the open file */
+    uint16_t  *next_free;  /*!< Free list links, LITTLEFS_FD_MAX_SIZE ends it */
+    uint16_t  *index;      /*!< Linear probing on hash: FD + 1, 0 = empty */
+    uint16_t   size;       /*!< Number of FD slots, 0 if not initialised */
+    uint16_t   count;      /*!< Number of open FDs */
+    uint16_t   free_head;  /*!< First free FD */
+} littlefs_fd_table_t;
+
+/**
+ * @brief Allocate LITTLEFS_FD_MIN_SIZE empty slots.
+ * @return 0 on success, -1 if out of memory (the table stays uninitialised)
+ */
+int littlefs_fd_init(littlefs_fd_table_t *t);
+
+/**
+ * @brief Release the table memory; the files themselves are not freed.
+ */
+void littlefs_fd_deinit(littlefs_fd_table_t *t);
+
+/**
+ * @brief Register an open file under a new FD.
+ *
+ * Doubles the table when it is full; if that fails nothing changes.
+ * @param[in] file non-NULL file pointer stored in the slot
+ * @param[in] hash hash of the file path, used by littlefs_fd_find
+ * @return FD, or -1 if the table cannot grow
+ */
+int littlefs_fd_alloc(littlefs_fd_table_t *t, void *file, uint32_t hash);
+
+/**
+ * @brief Release a FD; it will be the next one handed out.
+ * @return the file that was stored there, NULL if fd was not open
+ */
+void *littlefs_fd_free(littlefs_fd_table_t *t, int fd);
+
+/**
+ * @brief The file of an open FD.
+ * @return NULL if fd is out of range or not open
+ */
+static inline void *littlefs_fd_get(const littlefs_fd_table_t *t, int fd) {
+    if((uint32_t)fd >= t->size) return NULL;
+    return t->file[fd];
+}
+
+/**
+ * @brief Find an open FD by path hash.
+ * @param[in] match confirms a hash hit (e.g. strcmp of the stored path);
+ *                  NULL trusts the hash alone
+ * @return FD, or -1 if no open file matches
+ */
+int littlefs_fd_find(const littlefs_fd_table_t *t, uint32_t hash,
+                     littlefs_fd_match_t match, const void *ctx);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ESP_LITTLEFS_FD_H__ */
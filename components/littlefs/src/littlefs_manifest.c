@@ -0,0 +1,144 @@
+/**
+ * @file littlefs_manifest.c
+ * @brief Loading and lookup of an image manifest, see littlefs_manifest.h
+ */
+
+#include "littlefs_manifest.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+static int manifest_corrupt(littlefs_manifest_t *m, void *data) {
+    free(data);
+    memset(m, 0, sizeof(*m));
+    return LFS_ERR_CORRUPT;
+}
+
+/* Entry i is `path` or inside the directory `path` */
+static bool manifest_covers(const littlefs_manifest_t *m, uint32_t i, const char *path, size_t len) {
+    const char *name = m->names + m->entries[i].name;
+    return strncmp(name, path, len) == 0 &&
+            (name[len] == '\0' || name[len] == '/' || (len == 1 && path[0] == '/'));
+}
+
+int littlefs_manifest_load(littlefs_manifest_t *m, void *data, lfs_size_t size,
+                           lfs_size_t block_size, lfs_size_t block_count) {
+    memset(m, 0, sizeof(*m));
+    if(size < sizeof(littlefs_manifest_header_t)) return manifest_corrupt(m, data);
+
+    littlefs_manifest_header_t *h = data;
+    uint32_t *words = data;
+    for(size_t i = 0; i < sizeof(*h) / 4; i++) words[i] = lfs_fromle32(words[i]);
+    if(h->magic != LITTLEFS_MANIFEST_MAGIC || h->version != LITTLEFS_MANIFEST_VERSION ||
+            h->block_size != block_size || h->block_count != block_count ||
+            h->count >= 0xffff || h->nbuckets <= h->count || (h->nbuckets & (h->nbuckets - 1))) {
+        return manifest_corrupt(m, data);
+    }
+
+    /* 64-bit so that a damaged count cannot wrap the sum */
+    uint64_t expect = sizeof(*h) + (uint64_t)h->count * sizeof(littlefs_manifest_entry_t) +
+            (uint64_t)h->nbuckets * sizeof(uint16_t) + h->names_size;
+    if(expect != size || h->names_size == 0) return manifest_corrupt(m, data);
+    if(lfs_crc(0xffffffff, h + 1, size - sizeof(*h)) != h->crc) return manifest_corrupt(m, data);
+
+    littlefs_manifest_entry_t *entries = (littlefs_manifest_entry_t *)(h + 1);
+    uint16_t *buckets = (uint16_t *)(entries + h->count);
+    char *names = (char *)(buckets + h->nbuckets);
+    if(names[h->names_size - 1] != '\0') return manifest_corrupt(m, data);
+
+    words = (uint32_t *)entries;
+    for(size_t i = 0; i < h->count * sizeof(*entries) / 4; i++) words[i] = lfs_fromle32(words[i]);
+    uint32_t used = 0;
+    for(uint32_t i = 0; i < h->nbuckets; i++) {
+        const uint8_t *b = (const uint8_t *)&buckets[i];
+        buckets[i] = b[0] | (b[1] << 8);
+        if(buckets[i] > h->count) return manifest_corrupt(m, data);
+        used += buckets[i] != 0;
+    }
+    if(used != h->count) return manifest_corrupt(m, data);  /* Else a lookup might never stop */
+    for(uint32_t i = 0; i < h->count; i++) {
+        const littlefs_manifest_entry_t *e = &entries[i];
+        if(e->name >= h->names_size || littlefs_manifest_hash(names + e->name) != e->hash ||
+                e->blocks == 0 || e->first >= block_count || e->blocks > block_count - e->first ||
+                e->size > (uint64_t)e->blocks * block_size) {
+            return manifest_corrupt(m, data);
+        }
+    }
+
+    /* +1: calloc(0) may give NULL */
+    m->opens = calloc(h->count + 1, sizeof(*m->opens));
+    if(!m->opens) {
+        manifest_corrupt(m, data);
+        return LFS_ERR_NOMEM;
+    }
+    m->live = h->count;
+    m->data = data;
+    m->header = h;
+    m->entries = entries;
+    m->buckets = buckets;
+    m->names = names;
+    return 0;
+}
+
+void littlefs_manifest_free(littlefs_manifest_t *m) {
+    free(m->opens);
+    free(m->data);
+    memset(m, 0, sizeof(*m));
+}
+
+const littlefs_manifest_entry_t *littlefs_manifest_find(const littlefs_manifest_t *m, const char *path) {
+    if(!m->header) return NULL;
+
+    uint32_t hash = littlefs_manifest_hash(path);
+    uint32_t mask = m->header->nbuckets - 1;
+    /* nbuckets > count: there is always an empty bucket to stop at */
+    for(uint32_t i = hash & mask;; i = (i + 1) & mask) {
+        uint16_t b = m->buckets[i];
+        if(b == 0) return NULL;
+        const littlefs_manifest_entry_t *e = &m->entries[b - 1];
+        if(e->hash == hash && strcmp(m->names + e->name, path) == 0) {
+            return m->opens[b - 1] == LITTLEFS_MANIFEST_DROPPED ? NULL : e;
+        }
+    }
+}
+
+const littlefs_manifest_entry_t *littlefs_manifest_acquire(littlefs_manifest_t *m, const char *path) {
+    const littlefs_manifest_entry_t *e = littlefs_manifest_find(m, path);
+    if(!e || m->opens[e - m->entries] == LITTLEFS_MANIFEST_DROPPED - 1) return NULL;
+    m->opens[e - m->entries]++;
+    m->open++;
+    return e;
+}
+
+void littlefs_manifest_release(littlefs_manifest_t *m, const littlefs_manifest_entry_t *e) {
+    m->opens[e - m->entries]--;
+    m->open--;
+}
+
+bool littlefs_manifest_busy(const littlefs_manifest_t *m, const char *path) {
+    if(m->open == 0) return false;
+    if(strcmp(path, LITTLEFS_MANIFEST_PATH) == 0) return true;
+    size_t len = strlen(path);
+    /* Only while a handle is open; a directory needs the scan anyway */
+    for(uint32_t i = 0; i < m->header->count; i++) {
+        if(m->opens[i] != 0 && m->opens[i] != LITTLEFS_MANIFEST_DROPPED && manifest_covers(m, i, path, len)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+uint32_t littlefs_manifest_drop(littlefs_manifest_t *m, const char *path) {
+    if(!m->header) return 0;
+    bool all = strcmp(path, LITTLEFS_MANIFEST_PATH) == 0;
+    size_t len = strlen(path);
+    uint32_t dropped = 0;
+    for(uint32_t i = 0; i < m->header->count; i++) {
+        if(m->opens[i] != LITTLEFS_MANIFEST_DROPPED && (all || manifest_covers(m, i, path, len))) {
+            m->opens[i] = LITTLEFS_MANIFEST_DROPPED;
+            dropped++;
+        }
+    }
+    m->live -= dropped;
+    return dropped;
+}
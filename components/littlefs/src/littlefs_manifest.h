@@ -0,0 +1,132 @@
+/**
+ * @file littlefs_manifest.h
+ * @brief Index of the block-contiguous files of a generated image
+ *
+ * littlefs_mkimage (components/littlefs/tools) writes the large read-only
+ * files of an image on consecutive blocks, CTZ index i on block first + i,
+ * and records them in LITTLEFS_MANIFEST_PATH inside the same image. With the
+ * manifest and a mapped partition a file is found by hashing its path: no
+ * directory traversal, no CTZ walk.
+ *
+ * Layout, all little-endian:
+ *
+ *     littlefs_manifest_header_t
+ *     littlefs_manifest_entry_t   entries[count]
+ *     uint16_t                    buckets[nbuckets]  entry index + 1, 0 if empty
+ *     char                        names[names_size]  NUL-terminated paths
+ *
+ * `crc` is lfs_crc(0xffffffff, ...) of everything after the header. Paths
+ * are hashed with littlefs_manifest_hash and probed linearly.
+ *
+ * In memory each entry also counts the handles open on its blocks. A path
+ * that changes drops the entries describing it, which are then no longer
+ * found; littlefs_manifest_busy tells the caller to refuse the change
+ * instead while one of them is open.
+ *
+ * Does not depend on ESP-IDF (host/bench_littlefs_image.c).
+ */
+#ifndef LITTLEFS_MANIFEST_H__
+#define LITTLEFS_MANIFEST_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "littlefs/lfs.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define LITTLEFS_MANIFEST_PATH    "/.manifest"
+#define LITTLEFS_MANIFEST_MAGIC   0x4d53464c  /* "LFSM" */
+#define LITTLEFS_MANIFEST_VERSION 1
+#define LITTLEFS_MANIFEST_DROPPED 0xffff  /* In opens: the entry is stale */
+
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t block_size;    /*!< Geometry of the image, must match the mount */
+    uint32_t block_count;
+    uint32_t count;         /*!< Entries */
+    uint32_t nbuckets;      /*!< Power of 2, more than count */
+    uint32_t names_size;
+    uint32_t crc;
+} littlefs_manifest_header_t;
+
+typedef struct {
+    uint32_t hash;          /*!< littlefs_manifest_hash of the path */
+    uint32_t first;         /*!< Block of CTZ index 0 */
+    uint32_t blocks;        /*!< Blocks [first, first + blocks) */
+    uint32_t size;          /*!< File size in bytes */
+    uint32_t crc;           /*!< lfs_crc(0xffffffff, data, size) */
+    uint32_t name;          /*!< Offset of the path in names */
+} littlefs_manifest_entry_t;
+
+typedef struct {
+    void                            *data;      /*!< The loaded file, owned */
+    const littlefs_manifest_header_t *header;   /*!< NULL if there is no manifest */
+    const littlefs_manifest_entry_t  *entries;
+    const uint16_t                   *buckets;
+    const char                       *names;
+    uint16_t                         *opens;    /*!< Per entry: open handles, or LITTLEFS_MANIFEST_DROPPED */
+    uint32_t                          open;     /*!< Sum of the open handles */
+    uint32_t                          live;     /*!< Entries not dropped */
+} littlefs_manifest_t;
+
+/**
+ * @brief FNV-1a of a path, as stored in the entries.
+ */
+static inline uint32_t littlefs_manifest_hash(const char *path) {
+    uint32_t hash = 2166136261u;
+    while(*path) {
+        hash ^= (uint8_t)*path++;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+/**
+ * @brief Take over a manifest read into `data` (malloc'd) and check it.
+ *
+ * Converts it in place to host byte order. On success the manifest owns
+ * `data`; on failure `data` is freed and the manifest is empty.
+ *
+ * @return 0, LFS_ERR_NOMEM, or LFS_ERR_CORRUPT if the manifest is damaged,
+ *         does not match the geometry, or points outside the filesystem
+ */
+int littlefs_manifest_load(littlefs_manifest_t *m, void *data, lfs_size_t size,
+                           lfs_size_t block_size, lfs_size_t block_count);
+
+void littlefs_manifest_free(littlefs_manifest_t *m);
+
+/**
+ * @brief Entry of `path` (e.g. "/img/logo.bin"), O(1).
+ * @return NULL if the path is not in the manifest, was dropped, or there is none
+ */
+const littlefs_manifest_entry_t *littlefs_manifest_find(const littlefs_manifest_t *m, const char *path);
+
+/**
+ * @brief littlefs_manifest_find, counting one more handle on the entry.
+ *        Every entry returned is given back with littlefs_manifest_release.
+ */
+const littlefs_manifest_entry_t *littlefs_manifest_acquire(littlefs_manifest_t *m, const char *path);
+
+void littlefs_manifest_release(littlefs_manifest_t *m, const littlefs_manifest_entry_t *e);
+
+/**
+ * @brief An open entry would be changed by writing, removing or renaming
+ *        `path`: the path itself, a directory of it, or the manifest.
+ */
+bool littlefs_manifest_busy(const littlefs_manifest_t *m, const char *path);
+
+/**
+ * @brief Drop the entries that `path` changes, none of them open
+ *        (littlefs_manifest_busy is false).
+ * @return entries dropped, 0 if the manifest does not describe `path`
+ */
+uint32_t littlefs_manifest_drop(littlefs_manifest_t *m, const char *path);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LITTLEFS_MANIFEST_H__ */
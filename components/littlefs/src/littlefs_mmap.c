@@ -0,0 +1,119 @@
+/**
+ * @file littlefs_mmap.c
+ * @brief Spans of open files in a mapped partition, see littlefs_mmap.h
+ */
+
+#include "littlefs_mmap.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @brief CTZ index of the block holding file offset *off, and the offset
+ *        within that block (pointers included), as lfs_ctz_index in lfs.c.
+ */
+static lfs_off_t mmap_ctz_index(lfs_size_t block_size, lfs_off_t *off) {
+    lfs_off_t size = *off;
+    lfs_off_t b = block_size - 2*4;
+    lfs_off_t i = size / b;
+    if(i == 0) return 0;
+
+    i = (size - 4*(lfs_popc(i-1)+2)) / b;
+    *off = size - b*i - 4*lfs_popc(i);
+    return i;
+}
+
+int littlefs_mmap_attach(littlefs_mmap_t *m, lfs_t *lfs, const lfs_file_t *file, const void *base) {
+    memset(m, 0, sizeof(*m));
+    m->base = base;
+    m->block_size = lfs->cfg->block_size;
+    m->size = file->ctz.size;
+    if(file->flags & LFS_F_WRITING) m->size = lfs_max(file->pos, file->ctz.size);
+
+    if(!base || m->size == 0 || (file->flags & (LFS_F_INLINE | LFS_F_WRITING))) return 0;
+
+    lfs_off_t last_off = m->size - 1;
+    lfs_off_t last = mmap_ctz_index(m->block_size, &last_off);
+    m->blocks = malloc((last + 1) * sizeof(*m->blocks));
+    if(!m->blocks) return LFS_ERR_NOMEM;
+
+    /* The head is the last block; pointer 0 of block i is block i - 1 */
+    lfs_block_t block = file->ctz.head;
+    for(lfs_off_t i = last;; i--) {
+        if(block >= lfs->block_count) {
+            littlefs_mmap_detach(m);
+            return LFS_ERR_CORRUPT;
+        }
+        m->blocks[i] = block;
+        if(i == 0) break;
+
+        uint32_t ptr;
+        memcpy(&ptr, m->base + (size_t)block * m->block_size, sizeof(ptr));
+        block = lfs_fromle32(ptr);
+    }
+    return 0;
+}
+
+int littlefs_mmap_attach_extent(littlefs_mmap_t *m, const void *base, lfs_size_t block_size,
+                                lfs_block_t first, lfs_size_t blocks, lfs_size_t size) {
+    memset(m, 0, sizeof(*m));
+    m->base = base;
+    m->block_size = block_size;
+    m->size = size;
+
+    lfs_off_t last_off = lfs_max(size, 1) - 1;
+    lfs_off_t last = mmap_ctz_index(block_size, &last_off);
+    if(last + 1 != blocks) return LFS_ERR_CORRUPT;
+    if(!base || size == 0) return 0;
+
+    m->blocks = malloc(blocks * sizeof(*m->blocks));
+    if(!m->blocks) return LFS_ERR_NOMEM;
+    for(lfs_size_t i = 0; i < blocks; i++) m->blocks[i] = first + i;
+    return 0;
+}
+
+void littlefs_mmap_detach(littlefs_mmap_t *m) {
+    free(m->blocks);
+    m->blocks = NULL;
+}
+
+lfs_ssize_t littlefs_mmap_span(const littlefs_mmap_t *m, lfs_off_t off, const void **data) {
+    if(off >= m->size) return 0;
+    if(!m->blocks) return LFS_ERR_INVAL;
+
+    lfs_off_t in_block = off;
+    lfs_off_t i = mmap_ctz_index(m->block_size, &in_block);
+    *data = m->base + (size_t)m->blocks[i] * m->block_size + in_block;
+    return lfs_min(m->block_size - in_block, m->size - off);
+}
+
+lfs_ssize_t littlefs_mmap_get(littlefs_mmap_t *m, lfs_off_t off, lfs_size_t size, void *buf,
+                              const void **data, littlefs_mmap_read_t read, void *ctx) {
+    if(off >= m->size) return 0;
+    size = lfs_min(size, m->size - off);
+
+    if(!m->blocks) {
+        lfs_ssize_t res = read(ctx, off, buf, size);
+        if(res > 0) m->copied += res;
+        *data = buf;
+        return res;
+    }
+
+    const void *span;
+    lfs_ssize_t n = littlefs_mmap_span(m, off, &span);
+    if((lfs_size_t)n >= size) {
+        m->mapped += size;
+        *data = span;
+        return size;
+    }
+
+    /* Crosses a block boundary: gather the spans */
+    for(lfs_size_t done = 0; done < size; done += n) {
+        n = littlefs_mmap_span(m, off + done, &span);
+        n = lfs_min((lfs_size_t)n, size - done);
+        memcpy((uint8_t *)buf + done, span, n);
+    }
+    m->copied += size;
+    *data = buf;
+    return size;
+}
@@ -0,0 +1,101 @@
+/**
+ * @file littlefs_mmap.h
+ * @brief Where the bytes of an open file live in a memory-mapped partition
+ *
+ * A file that does not fit in its directory entry is a CTZ skip-list: block 0
+ * holds only data, every later block i starts with ctz(i) + 1 pointers to
+ * earlier blocks and holds data after them. So the data of one block is
+ * contiguous in flash, but two blocks never join, even when they are
+ * neighbours. littlefs_mmap_span hands out a pointer to the data left in the
+ * block holding an offset; a file that fits in one block (up to block_size
+ * bytes) is a single span.
+ *
+ * The block of every CTZ index is resolved once, from the mapping, when the
+ * file is attached, so a span costs O(1) and needs neither the lfs_t nor any
+ * lock. Inline files (data inside the metadata pair), files with buffered
+ * writes and partitions that are not mapped fall back to a read callback.
+ *
+ * Does not depend on ESP-IDF (host/bench_littlefs_mmap.c).
+ */
+#ifndef LITTLEFS_MMAP_H__
+#define LITTLEFS_MMAP_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "littlefs/lfs.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Copying read of file bytes, used for what cannot be mapped.
+ * @return bytes read, or a negative lfs error
+ */
+typedef lfs_ssize_t (*littlefs_mmap_read_t)(void *ctx, lfs_off_t off, void *buf, lfs_size_t size);
+
+typedef struct {
+    const uint8_t *base;        /*!< Mapping of block 0 */
+    lfs_block_t   *blocks;      /*!< CTZ index -> block, NULL if the file is not mapped */
+    lfs_size_t     block_size;
+    lfs_size_t     size;        /*!< File size when attached */
+    uint64_t       mapped;      /*!< Bytes handed out as pointers into the mapping */
+    uint64_t       copied;      /*!< Bytes copied, from the mapping or by the read callback */
+} littlefs_mmap_t;
+
+/**
+ * @brief Attach an open file.
+ *
+ * Reads the CTZ pointers of the file straight from `base`; call with the
+ * file locked against writers. The spans stay valid while the file is open
+ * and not written (through any FD) and the partition stays mapped.
+ *
+ * @param base mapping of the partition, NULL if it is not mapped
+ * @return 0 (check littlefs_mmap_mapped), LFS_ERR_NOMEM, or LFS_ERR_CORRUPT
+ *         if a pointer leaves the filesystem
+ */
+int littlefs_mmap_attach(littlefs_mmap_t *m, lfs_t *lfs, const lfs_file_t *file, const void *base);
+
+/**
+ * @brief Attach a file stored on consecutive blocks, CTZ index i on block
+ *        first + i, as littlefs_mkimage lays them out (littlefs_manifest.h).
+ *
+ * Nothing is read: the spans are valid for as long as the image is not
+ * changed under them.
+ *
+ * @param blocks blocks the file occupies, checked against `size`
+ * @return 0, LFS_ERR_NOMEM, or LFS_ERR_CORRUPT if `blocks` does not match
+ */
+int littlefs_mmap_attach_extent(littlefs_mmap_t *m, const void *base, lfs_size_t block_size,
+                                lfs_block_t first, lfs_size_t blocks, lfs_size_t size);
+
+void littlefs_mmap_detach(littlefs_mmap_t *m);
+
+static inline bool littlefs_mmap_mapped(const littlefs_mmap_t *m) {
+    return m->blocks != NULL;
+}
+
+/**
+ * @brief Contiguous file bytes at `off`, up to the end of their block.
+ * @param[out] data pointer into the mapping
+ * @return bytes at *data, 0 at end of file, LFS_ERR_INVAL if not mapped
+ */
+lfs_ssize_t littlefs_mmap_span(const littlefs_mmap_t *m, lfs_off_t off, const void **data);
+
+/**
+ * @brief Bytes [off, off + size) of the file, without a copy when possible.
+ *
+ * If the range is one span, *data points into the mapping. Otherwise it is
+ * copied into `buf` (span by span, or through `read` when the file is not
+ * mapped) and *data is `buf`. The range is cut at the end of the file.
+ *
+ * @return bytes at *data, or a negative lfs error
+ */
+lfs_ssize_t littlefs_mmap_get(littlefs_mmap_t *m, lfs_off_t off, lfs_size_t size, void *buf,
+                              const void **data, littlefs_mmap_read_t read, void *ctx);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LITTLEFS_MMAP_H__ */
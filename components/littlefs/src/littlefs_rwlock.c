@@ -0,0 +1,138 @@
+/**
+ * @file littlefs_rwlock.c
+ * @brief Reader/writer lock of a mounted filesystem, see littlefs_rwlock.h
+ */
+
+#include "littlefs_rwlock.h"
+
+#include <string.h>
+
+/*** Platform primitives ***/
+
+#ifdef ESP_PLATFORM
+static bool mutex_create(littlefs_mutex_t *m, bool recursive) {
+    *m = recursive ? xSemaphoreCreateRecursiveMutex() : xSemaphoreCreateMutex();
+    return *m != NULL;
+}
+static void mutex_delete(littlefs_mutex_t *m) {
+    if(*m) vSemaphoreDelete(*m);
+}
+static void mutex_take_recursive(littlefs_mutex_t *m) { xSemaphoreTakeRecursive(*m, portMAX_DELAY); }
+static void mutex_give_recursive(littlefs_mutex_t *m) { xSemaphoreGiveRecursive(*m); }
+static void mutex_take(littlefs_mutex_t *m) { xSemaphoreTake(*m, portMAX_DELAY); }
+static void mutex_give(littlefs_mutex_t *m) { xSemaphoreGive(*m); }
+
+static bool sem_create(littlefs_sem_t *s) {
+    *s = xSemaphoreCreateBinary();
+    return *s != NULL;
+}
+static void sem_delete(littlefs_sem_t *s) {
+    if(*s) vSemaphoreDelete(*s);
+}
+static void sem_wait_(littlefs_sem_t *s) { xSemaphoreTake(*s, portMAX_DELAY); }
+static void sem_post_(littlefs_sem_t *s) { xSemaphoreGive(*s); }
+#else
+static bool mutex_create(littlefs_mutex_t *m, bool recursive) {
+    pthread_mutexattr_t attr;
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_settype(&attr, recursive ? PTHREAD_MUTEX_RECURSIVE : PTHREAD_MUTEX_NORMAL);
+    bool ok = pthread_mutex_init(m, &attr) == 0;
+    pthread_mutexattr_destroy(&attr);
+    return ok;
+}
+static void mutex_delete(littlefs_mutex_t *m) { pthread_mutex_destroy(m); }
+static void mutex_take_recursive(littlefs_mutex_t *m) { pthread_mutex_lock(m); }
+static void mutex_give_recursive(littlefs_mutex_t *m) { pthread_mutex_unlock(m); }
+static void mutex_take(littlefs_mutex_t *m) { pthread_mutex_lock(m); }
+static void mutex_give(littlefs_mutex_t *m) { pthread_mutex_unlock(m); }
+
+static bool sem_create(littlefs_sem_t *s) { return sem_init(s, 0, 0) == 0; }
+static void sem_delete(littlefs_sem_t *s) { sem_destroy(s); }
+static void sem_wait_(littlefs_sem_t *s) { while(sem_wait(s) != 0) {} }
+static void sem_post_(littlefs_sem_t *s) { sem_post(s); }
+#endif
+
+/*** Lock ***/
+
+int littlefs_rwlock_init(littlefs_rwlock_t *l) {
+    int files = 0;
+
+    memset(l, 0, sizeof(*l));
+    if(!mutex_create(&l->entry, true)) return -1;
+    if(!sem_create(&l->drained)) goto fail_entry;
+    for(; files < LITTLEFS_RWLOCK_FILE_LOCKS; files++) {
+        if(!mutex_create(&l->file[files], false)) goto fail_files;
+    }
+    l->ready = true;
+    return 0;
+
+fail_files:
+    while(files--) mutex_delete(&l->file[files]);
+    sem_delete(&l->drained);
+fail_entry:
+    mutex_delete(&l->entry);
+    memset(l, 0, sizeof(*l));
+    return -1;
+}
+
+void littlefs_rwlock_deinit(littlefs_rwlock_t *l) {
+    if(!l->ready) return;
+    for(int i = 0; i < LITTLEFS_RWLOCK_FILE_LOCKS; i++) {
+        mutex_delete(&l->file[i]);
+    }
+    sem_delete(&l->drained);
+    mutex_delete(&l->entry);
+    memset(l, 0, sizeof(*l));
+}
+
+void littlefs_rwlock_write_lock(littlefs_rwlock_t *l) {
+    mutex_take_recursive(&l->entry);
+    if(l->depth++) return;
+
+    /* No reader can enter any more; wait for the ones inside. A reader
+     * leaving between the two loads below sees `draining` and posts, so the
+     * wakeup cannot be lost. A stale post from an earlier writer only costs
+     * one more pass of the loop. */
+    __atomic_store_n(&l->draining, 1, __ATOMIC_SEQ_CST);
+    while(__atomic_load_n(&l->readers, __ATOMIC_SEQ_CST) != 0) {
+        sem_wait_(&l->drained);
+    }
+    __atomic_store_n(&l->draining, 0, __ATOMIC_SEQ_CST);
+}
+
+void littlefs_rwlock_write_unlock(littlefs_rwlock_t *l) {
+    l->depth--;
+    mutex_give_recursive(&l->entry);
+}
+
+void littlefs_rwlock_read_lock(littlefs_rwlock_t *l) {
+    /* Queue behind a writer that holds or waits for the lock. The writer's
+     * own task passes through, as the mutex is recursive. */
+    mutex_take_recursive(&l->entry);
+    __atomic_add_fetch(&l->readers, 1, __ATOMIC_SEQ_CST);
+    mutex_give_recursive(&l->entry);
+}
+
+void littlefs_rwlock_read_unlock(littlefs_rwlock_t *l) {
+    if(__atomic_sub_fetch(&l->readers, 1, __ATOMIC_SEQ_CST) == 0
+            && __atomic_load_n(&l->draining, __ATOMIC_SEQ_CST)) {
+        sem_post_(&l->drained);
+    }
+}
+
+/**
+ * @brief Per-file lock of an FD. Tasks that open the same files in the same
+ *        order get FDs a fixed stride apart, so mix before taking the bits.
+ */
+static inline littlefs_mutex_t *file_mutex(littlefs_rwlock_t *l, int fd) {
+    uint32_t h = (uint32_t)fd * 0x9E3779B1u;
+    return &l->file[(h >> 16) % LITTLEFS_RWLOCK_FILE_LOCKS];
+}
+
+void littlefs_rwlock_file_lock(littlefs_rwlock_t *l, int fd) {
+    mutex_take(file_mutex(l, fd));
+}
+
+void littlefs_rwlock_file_unlock(littlefs_rwlock_t *l, int fd) {
+    mutex_give(file_mutex(l, fd));
+}
@@ -0,0 +1,91 @@
+/**
+ * @file littlefs_rwlock.h
+ * @brief Reader/writer lock of a mounted filesystem
+ *
+ * littlefs is single threaded: anything that may touch the lfs_t (its read
+ * and program caches, the block allocator, metadata commits) must be
+ * exclusive. Reading an open file whose data lives in its own CTZ blocks
+ * only goes through that file's cache, so such reads (read, pread, lseek,
+ * fstat) take the lock shared plus a per-file lock, and run alongside
+ * reads of other files. See littlefs_file_shareable for when a read cannot.
+ *
+ * Writers are preferred: a writer waiting for readers to drain holds the
+ * entry mutex, so new readers queue behind it. The exclusive side is
+ * recursive, as the single mutex it replaces was. A task holding the lock
+ * shared must not take it exclusive.
+ *
+ * FreeRTOS on ESP-IDF, pthreads elsewhere (host/bench_littlefs_rw.c).
+ */
+#ifndef ESP_LITTLEFS_RWLOCK_H__
+#define ESP_LITTLEFS_RWLOCK_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "littlefs/lfs.h"
+
+#ifdef ESP_PLATFORM
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+typedef SemaphoreHandle_t littlefs_mutex_t;
+typedef SemaphoreHandle_t littlefs_sem_t;
+#else
+#include <pthread.h>
+#include <semaphore.h>
+typedef pthread_mutex_t littlefs_mutex_t;
+typedef sem_t littlefs_sem_t;
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define LITTLEFS_RWLOCK_FILE_LOCKS 8  /*!< Per-file locks, FDs are hashed onto them */
+
+typedef struct {
+    littlefs_mutex_t  entry;      /*!< Held by writers (recursive), briefly by entering readers */
+    littlefs_sem_t    drained;    /*!< Given by the last reader out while a writer waits */
+    littlefs_mutex_t  file[LITTLEFS_RWLOCK_FILE_LOCKS];  /*!< Serialise readers of the same FD */
+    uint32_t          readers;    /*!< Readers inside (__atomic_*) */
+    uint32_t          draining;   /*!< A writer waits for readers to leave (__atomic_*) */
+    uint32_t          depth;      /*!< Recursion of the writer holding entry */
+    bool              ready;      /*!< Everything above was created */
+} littlefs_rwlock_t;
+
+/**
+ * @return 0 on success, -1 if out of memory (nothing is left allocated)
+ */
+int littlefs_rwlock_init(littlefs_rwlock_t *l);
+
+/**
+ * @brief Safe on a zeroed or failed-init lock.
+ */
+void littlefs_rwlock_deinit(littlefs_rwlock_t *l);
+
+void littlefs_rwlock_write_lock(littlefs_rwlock_t *l);
+void littlefs_rwlock_write_unlock(littlefs_rwlock_t *l);
+
+void littlefs_rwlock_read_lock(littlefs_rwlock_t *l);
+void littlefs_rwlock_read_unlock(littlefs_rwlock_t *l);
+
+/**
+ * @brief Per-file lock, taken inside the read lock before touching the file.
+ */
+void littlefs_rwlock_file_lock(littlefs_rwlock_t *l, int fd);
+void littlefs_rwlock_file_unlock(littlefs_rwlock_t *l, int fd);
+
+/**
+ * @brief Whether reading / seeking this open file stays within the file.
+ *
+ * Not for files with buffered writes (the read flushes them: allocation and
+ * commits) or inline files (their data is read from the metadata pair
+ * through the lfs_t read cache). Call with the file lock held.
+ */
+static inline bool littlefs_file_shareable(const lfs_file_t *file) {
+    return (file->flags & (LFS_F_WRITING | LFS_F_INLINE)) == 0;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ESP_LITTLEFS_RWLOCK_H__ */
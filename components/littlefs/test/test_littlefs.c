@@ -873,6 +873,59 @@ TEST_CASE("open with flag O_DIRECTORY", "[littlefs]")
 }
 #endif
 
+#if CONFIG_VFS_SUPPORT_DIR
+TEST_CASE("open files cannot be unlinked or renamed, closed ones can", "[littlefs]")
+{
+    const int n = 32;  /* Grows the FD table several times */
+    int fds[n];
+    char name[32], other[32];
+
+    test_setup();
+
+    for(int i = 0; i < n; i++) {
+        snprintf(name, sizeof(name), "/littlefs/fd%d.txt", i);
+        fds[i] = open(name, O_CREAT | O_WRONLY);
+        TEST_ASSERT_GREATER_OR_EQUAL_INT(0, fds[i]);
+    }
+
+    /* Close every other file, the rest stay in the FD table */
+    for(int i = 0; i < n; i += 2) {
+        TEST_ASSERT_EQUAL(0, close(fds[i]));
+    }
+
+    for(int i = 0; i < n; i++) {
+        snprintf(name, sizeof(name), "/littlefs/fd%d.txt", i);
+        snprintf(other, sizeof(other), "/littlefs/moved%d.txt", i);
+        if(i % 2) {
+            TEST_ASSERT_EQUAL(-1, unlink(name));
+            TEST_ASSERT_EQUAL(EBUSY, errno);
+            TEST_ASSERT_EQUAL(-1, rename(name, other));
+            TEST_ASSERT_EQUAL(EBUSY, errno);
+        } else {
+            TEST_ASSERT_EQUAL(0, rename(name, other));
+            TEST_ASSERT_EQUAL(0, unlink(other));
+        }
+    }
+
+    /* Freed FDs are handed out again and looked up under their new path */
+    for(int i = 0; i < n; i += 2) {
+        snprintf(name, sizeof(name), "/littlefs/fd%d.txt", i);
+        fds[i] = open(name, O_CREAT | O_WRONLY);
+        TEST_ASSERT_GREATER_OR_EQUAL_INT(0, fds[i]);
+        TEST_ASSERT_EQUAL(-1, unlink(name));
+        TEST_ASSERT_EQUAL(EBUSY, errno);
+    }
+
+    for(int i = 0; i < n; i++) {
+        TEST_ASSERT_EQUAL(0, close(fds[i]));
+        snprintf(name, sizeof(name), "/littlefs/fd%d.txt", i);
+        TEST_ASSERT_EQUAL(0, unlink(name));
+    }
+
+    test_teardown();
+}
+#endif
+
 TEST_CASE("fcntl get flags", "[littlefs]")
 {
     int fd;
@@ -0,0 +1,505 @@
+/**
+ * @file littlefs_mkimage.c
+ * @brief Build a littlefs image from a directory, with its large files on
+ *        consecutive, aligned blocks and a manifest of where they are.
+ *
+ * littlefs allocates blocks linearly from a moving cursor, so a file written
+ * in one go usually lands on consecutive blocks, but nothing guarantees it:
+ * a metadata commit in between, or the cursor wrapping at the end of the
+ * partition, splits it. Each large file is therefore written, its CTZ chain
+ * walked in the image, and the file written again further on when the
+ * chain is not first, first + 1, ... from an aligned block. One-block
+ * padding files move the cursor to the alignment and are removed once the
+ * file is written.
+ *
+ * The large files go in first, biggest first, then the small ones, then
+ * LITTLEFS_MANIFEST_PATH (littlefs_manifest.h). The image is an ordinary
+ * littlefs: it mounts and can be written like any other.
+ *
+ * Runs on the build host (project_include.cmake, host/CMakeLists.txt).
+ */
+
+#include <dirent.h>
+#include <errno.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#include "littlefs/lfs.h"
+#include "littlefs/bd/lfs_rambd.h"
+#include "littlefs_manifest.h"
+
+#define MKIMAGE_IO_SIZE       128   /* CONFIG_LITTLEFS_READ_SIZE / WRITE_SIZE */
+#define MKIMAGE_CACHE_SIZE    512   /* CONFIG_LITTLEFS_CACHE_SIZE, also the inline limit */
+#define MKIMAGE_LOOKAHEAD     128
+#define MKIMAGE_ATTEMPTS      8     /* Placements tried per file before giving up */
+#define MKIMAGE_PAD_FORMAT    "/.pad%u"
+#define MKIMAGE_NO_BLOCK      ((lfs_block_t)-1)  /* Inline file */
+
+typedef struct {
+    char    *path;          /* In the image, "/img/logo.bin" */
+    char    *host_path;
+    bool     dir;
+    size_t   size;
+    bool     placed;        /* Large file: consecutive blocks, in the manifest */
+    littlefs_manifest_entry_t entry;
+} mkimage_item_t;
+
+typedef struct {
+    lfs_t                   lfs;
+    struct lfs_config       cfg;
+    lfs_rambd_t             bd;
+    struct lfs_rambd_config bd_cfg;
+    uint8_t                *image;
+    lfs_size_t              align_blocks;
+    unsigned                pads;
+
+    mkimage_item_t         *items;
+    size_t                  count;
+    size_t                  cap;
+} mkimage_t;
+
+static int usage(const char *argv0) {
+    fprintf(stderr,
+            "usage: %s <dir> <image> --size BYTES [--block-size BYTES] [--name-max N]\n"
+            "          [--align BYTES] [--min-size BYTES] [--manifest FILE] [-v]\n"
+            "\n"
+            "  --size        filesystem size, the partition size (0x100000, 1024K, 1M)\n"
+            "  --block-size  default 4096\n"
+            "  --name-max    CONFIG_LITTLEFS_OBJ_NAME_LEN, default 64\n"
+            "  --align       first block of a large file on a multiple of this, default the block size\n"
+            "  --min-size    files of at least this many bytes are large, default the block size\n"
+            "  --manifest    also write the manifest to FILE\n"
+            "  -v            list the large files\n",
+            argv0);
+    return 2;
+}
+
+static bool parse_size(const char *s, unsigned long *out) {
+    char *end;
+    errno = 0;
+    unsigned long v = strtoul(s, &end, 0);
+    if(errno || end == s) return false;
+    if(*end == 'K' || *end == 'k') { v *= 1024; end++; }
+    else if(*end == 'M' || *end == 'm') { v *= 1024 * 1024; end++; }
+    if(*end) return false;
+    *out = v;
+    return true;
+}
+
+/**
+ * @brief Blocks of a CTZ file of `size` bytes, as lfs_ctz_index in lfs.c.
+ */
+static lfs_size_t ctz_blocks(lfs_size_t block_size, lfs_size_t size) {
+    lfs_off_t off = lfs_max(size, 1) - 1;
+    lfs_off_t b = block_size - 2*4;
+    lfs_off_t i = off / b;
+    if(i == 0) return 1;
+    return (off - 4*(lfs_popc(i-1)+2)) / b + 1;
+}
+
+static char *join(const char *a, const char *b) {
+    size_t la = strlen(a), lb = strlen(b);
+    char *s = malloc(la + lb + 2);
+    if(!s) return NULL;
+    memcpy(s, a, la);
+    s[la] = '/';
+    memcpy(s + la + 1, b, lb + 1);
+    return s;
+}
+
+static int item_cmp(const void *a, const void *b) {
+    return strcmp(((const mkimage_item_t *)a)->path, ((const mkimage_item_t *)b)->path);
+}
+
+/*** Source tree ***/
+
+static int scan(mkimage_t *t, const char *host_dir, const char *path) {
+    DIR *d = opendir(host_dir);
+    if(!d) {
+        fprintf(stderr, "%s: %s\n", host_dir, strerror(errno));
+        return -1;
+    }
+    struct dirent *de;
+    int res = 0;
+    while(res == 0 && (de = readdir(d))) {
+        if(!strcmp(de->d_name, ".") || !strcmp(de->d_name, "..")) continue;
+
+        mkimage_item_t it = {0};
+        it.host_path = join(host_dir, de->d_name);
+        it.path = join(path, de->d_name);
+        struct stat st;
+        if(!it.host_path || !it.path || stat(it.host_path, &st) != 0) {
+            fprintf(stderr, "%s: %s\n", it.host_path ? it.host_path : de->d_name, strerror(errno ? errno : ENOMEM));
+            free(it.host_path);
+            free(it.path);
+            res = -1;
+            break;
+        }
+        if(!S_ISDIR(st.st_mode) && !S_ISREG(st.st_mode)) {
+            free(it.host_path);
+            free(it.path);
+            continue;
+        }
+        if(!strcmp(it.path, LITTLEFS_MANIFEST_PATH)) {
+            fprintf(stderr, "%s: " LITTLEFS_MANIFEST_PATH " is reserved for the manifest\n", it.host_path);
+            free(it.host_path);
+            free(it.path);
+            res = -1;
+            break;
+        }
+        it.dir = S_ISDIR(st.st_mode);
+        it.size = it.dir ? 0 : (size_t)st.st_size;
+
+        if(t->count == t->cap) {
+            t->cap = t->cap ? 2 * t->cap : 64;
+            t->items = realloc(t->items, t->cap * sizeof(*t->items));
+            if(!t->items) {
+                res = -1;
+                break;
+            }
+        }
+        t->items[t->count++] = it;
+        if(it.dir) res = scan(t, it.host_path, it.path);
+    }
+    closedir(d);
+    return res;
+}
+
+static uint8_t *load(const mkimage_item_t *it) {
+    uint8_t *data = malloc(it->size ? it->size : 1);
+    FILE *f = fopen(it->host_path, "rb");
+    if(!data || !f || fread(data, 1, it->size, f) != it->size) {
+        fprintf(stderr, "%s: cannot read\n", it->host_path);
+        free(data);
+        data = NULL;
+    }
+    if(f) fclose(f);
+    return data;
+}
+
+/*** Image ***/
+
+static int write_file(mkimage_t *t, const char *path, const void *data, size_t size, lfs_block_t *head) {
+    lfs_file_t f;
+    int res = lfs_file_open(&t->lfs, &f, path, LFS_O_WRONLY | LFS_O_CREAT | LFS_O_TRUNC);
+    if(res < 0) return res;
+    lfs_ssize_t n = lfs_file_write(&t->lfs, &f, data, size);
+    res = n < 0 ? (int)n : lfs_file_sync(&t->lfs, &f);
+    if(res == 0 && head) *head = (f.flags & LFS_F_INLINE) ? MKIMAGE_NO_BLOCK : f.ctz.head;
+    int close = lfs_file_close(&t->lfs, &f);
+    return res < 0 ? res : close;
+}
+
+/**
+ * @brief Move the allocation cursor until the next block is aligned.
+ */
+static int pad(mkimage_t *t) {
+    if(t->align_blocks <= 1) return 0;
+
+    static uint8_t fill[64 * 1024];
+    memset(fill, 0xff, t->cfg.block_size);
+    for(lfs_size_t i = 0; i <= t->align_blocks; i++) {
+        char path[32];
+        lfs_block_t block = MKIMAGE_NO_BLOCK;
+        snprintf(path, sizeof(path), MKIMAGE_PAD_FORMAT, t->pads++);
+        /* Above the inline limit, within one block */
+        int res = write_file(t, path, fill, t->cfg.block_size, &block);
+        if(res < 0) return res;
+        if((block + 1) % t->align_blocks == 0) return 0;
+    }
+    return 0;  /* Keeps missing, most likely wrapping; the placement check decides */
+}
+
+/**
+ * @brief Remove the padding files. The cursor does not move back: their
+ *        blocks only come around again after it wraps.
+ */
+static int unpad(mkimage_t *t) {
+    for(; t->pads > 0; t->pads--) {
+        char path[32];
+        snprintf(path, sizeof(path), MKIMAGE_PAD_FORMAT, t->pads - 1);
+        int res = lfs_remove(&t->lfs, path);
+        if(res < 0) return res;
+    }
+    return 0;
+}
+
+/**
+ * @brief Is the CTZ chain ending at `head` first, first + 1, ... from an aligned first?
+ */
+static bool consecutive(const mkimage_t *t, lfs_block_t head, lfs_size_t blocks, lfs_block_t *first) {
+    if(head == MKIMAGE_NO_BLOCK || head + 1 < blocks) return false;
+    *first = head + 1 - blocks;
+    if(*first % t->align_blocks) return false;
+
+    lfs_block_t block = head;
+    for(lfs_size_t i = blocks - 1; i > 0; i--, block--) {
+        uint32_t ptr;
+        memcpy(&ptr, t->image + (size_t)block * t->cfg.block_size, sizeof(ptr));
+        if(lfs_fromle32(ptr) != block - 1) return false;
+    }
+    return true;
+}
+
+static int place(mkimage_t *t, mkimage_item_t *it, const uint8_t *data) {
+    lfs_size_t blocks = ctz_blocks(t->cfg.block_size, it->size);
+    for(int attempt = 0; attempt < MKIMAGE_ATTEMPTS; attempt++) {
+        lfs_block_t head = MKIMAGE_NO_BLOCK, first = MKIMAGE_NO_BLOCK;
+        int res = pad(t);
+        if(res == 0) res = write_file(t, it->path, data, it->size, &head);
+        if(res == 0) res = unpad(t);
+        if(res < 0) {
+            fprintf(stderr, "%s: %d, out of space?\n", it->path, res);
+            return res;
+        }
+        if(consecutive(t, head, blocks, &first)) {
+            it->placed = true;
+            it->entry.first = first;
+            it->entry.blocks = blocks;
+            it->entry.size = it->size;
+            it->entry.crc = lfs_crc(0xffffffff, data, it->size);
+            it->entry.hash = littlefs_manifest_hash(it->path);
+            return 0;
+        }
+        /* The cursor has moved past the split; try again from there */
+        res = lfs_remove(&t->lfs, it->path);
+        if(res < 0) return res;
+    }
+    fprintf(stderr, "%s: no run of %u consecutive blocks found, the image is too full\n",
+            it->path, (unsigned)blocks);
+    return LFS_ERR_NOSPC;
+}
+
+static int size_desc(const void *a, const void *b) {
+    const mkimage_item_t *x = *(mkimage_item_t * const *)a, *y = *(mkimage_item_t * const *)b;
+    if(x->size != y->size) return x->size < y->size ? 1 : -1;
+    return strcmp(x->path, y->path);
+}
+
+static int write_manifest(mkimage_t *t, uint8_t **out, size_t *out_size) {
+    uint32_t count = 0, names_size = 0, nbuckets = 1;
+    for(size_t i = 0; i < t->count; i++) {
+        if(!t->items[i].placed) continue;
+        count++;
+        names_size += strlen(t->items[i].path) + 1;
+    }
+    if(count >= 0xffff) {
+        fprintf(stderr, "too many large files for the manifest\n");
+        return LFS_ERR_INVAL;
+    }
+    while(nbuckets < 2 * count || nbuckets <= count) nbuckets *= 2;
+    names_size = lfs_max(names_size, 1);
+
+    size_t size = sizeof(littlefs_manifest_header_t) + count * sizeof(littlefs_manifest_entry_t) +
+            nbuckets * sizeof(uint16_t) + names_size;
+    uint8_t *buf = calloc(1, size);
+    if(!buf) return LFS_ERR_NOMEM;
+    littlefs_manifest_header_t *h = (littlefs_manifest_header_t *)buf;
+    littlefs_manifest_entry_t *entries = (littlefs_manifest_entry_t *)(h + 1);
+    uint16_t *buckets = (uint16_t *)(entries + count);
+    char *names = (char *)(buckets + nbuckets);
+
+    uint32_t n = 0, name = 0;
+    for(size_t i = 0; i < t->count; i++) {
+        mkimage_item_t *it = &t->items[i];
+        if(!it->placed) continue;
+        it->entry.name = name;
+        memcpy(names + name, it->path, strlen(it->path) + 1);
+        name += strlen(it->path) + 1;
+
+        uint32_t b = it->entry.hash & (nbuckets - 1);
+        while(buckets[b]) b = (b + 1) & (nbuckets - 1);
+        buckets[b] = n + 1;
+
+        const uint32_t *src = (const uint32_t *)&it->entry;
+        uint32_t *dst = (uint32_t *)&entries[n++];
+        for(size_t w = 0; w < sizeof(it->entry) / 4; w++) dst[w] = lfs_tole32(src[w]);
+    }
+    for(uint32_t i = 0; i < nbuckets; i++) {
+        uint16_t v = buckets[i];
+        ((uint8_t *)&buckets[i])[0] = v & 0xff;
+        ((uint8_t *)&buckets[i])[1] = v >> 8;
+    }
+
+    littlefs_manifest_header_t hdr = {
+        .magic = LITTLEFS_MANIFEST_MAGIC,
+        .version = LITTLEFS_MANIFEST_VERSION,
+        .block_size = t->cfg.block_size,
+        .block_count = t->cfg.block_count,
+        .count = count,
+        .nbuckets = nbuckets,
+        .names_size = names_size,
+        .crc = lfs_crc(0xffffffff, h + 1, size - sizeof(*h)),
+    };
+    const uint32_t *src = (const uint32_t *)&hdr;
+    uint32_t *dst = (uint32_t *)h;
+    for(size_t w = 0; w < sizeof(hdr) / 4; w++) dst[w] = lfs_tole32(src[w]);
+
+    int res = write_file(t, LITTLEFS_MANIFEST_PATH, buf, size, NULL);
+    if(res < 0) {
+        free(buf);
+        return res;
+    }
+    *out = buf;
+    *out_size = size;
+    return 0;
+}
+
+static int build(mkimage_t *t, unsigned long min_size, uint8_t **manifest, size_t *manifest_size) {
+    int res = lfs_format(&t->lfs, &t->cfg);
+    if(res == 0) res = lfs_mount(&t->lfs, &t->cfg);
+    if(res < 0) return res;
+
+    /* Directories first (sorted, so parents before children): later commits
+       into them rarely need a new block */
+    for(size_t i = 0; i < t->count && res == 0; i++) {
+        if(t->items[i].dir) res = lfs_mkdir(&t->lfs, t->items[i].path);
+    }
+
+    mkimage_item_t **large = calloc(t->count + 1, sizeof(*large));
+    size_t nlarge = 0;
+    if(!large) res = LFS_ERR_NOMEM;
+    for(size_t i = 0; i < t->count && res == 0; i++) {
+        mkimage_item_t *it = &t->items[i];
+        if(!it->dir && it->size >= min_size && it->size > MKIMAGE_CACHE_SIZE) large[nlarge++] = it;
+    }
+    qsort(large, nlarge, sizeof(*large), size_desc);
+    for(size_t i = 0; i < nlarge && res == 0; i++) {
+        uint8_t *data = load(large[i]);
+        res = data ? place(t, large[i], data) : LFS_ERR_IO;
+        free(data);
+    }
+    free(large);
+
+    for(size_t i = 0; i < t->count && res == 0; i++) {
+        mkimage_item_t *it = &t->items[i];
+        if(it->dir || it->placed) continue;
+        uint8_t *data = load(it);
+        res = data ? write_file(t, it->path, data, it->size, NULL) : LFS_ERR_IO;
+        free(data);
+    }
+
+    if(res == 0) res = write_manifest(t, manifest, manifest_size);
+
+    int unmount = lfs_unmount(&t->lfs);
+    return res < 0 ? res : unmount;
+}
+
+int main(int argc, char **argv) {
+    const char *dir = NULL, *image_path = NULL, *manifest_path = NULL;
+    unsigned long size = 0, block_size = 4096, name_max = 64, align = 0, min_size = 0;
+    bool verbose = false, has_min_size = false;
+
+    for(int i = 1; i < argc; i++) {
+        const char *a = argv[i];
+        bool has_val = i + 1 < argc;
+        if(!strcmp(a, "--size") && has_val) {
+            if(!parse_size(argv[++i], &size)) return usage(argv[0]);
+        } else if(!strcmp(a, "--block-size") && has_val) {
+            if(!parse_size(argv[++i], &block_size)) return usage(argv[0]);
+        } else if(!strcmp(a, "--name-max") && has_val) {
+            if(!parse_size(argv[++i], &name_max)) return usage(argv[0]);
+        } else if(!strcmp(a, "--align") && has_val) {
+            if(!parse_size(argv[++i], &align)) return usage(argv[0]);
+        } else if(!strcmp(a, "--min-size") && has_val) {
+            if(!parse_size(argv[++i], &min_size)) return usage(argv[0]);
+            has_min_size = true;
+        } else if(!strcmp(a, "--manifest") && has_val) {
+            manifest_path = argv[++i];
+        } else if(!strcmp(a, "-v")) {
+            verbose = true;
+        } else if(a[0] != '-' && !dir) {
+            dir = a;
+        } else if(a[0] != '-' && !image_path) {
+            image_path = a;
+        } else {
+            return usage(argv[0]);
+        }
+    }
+    if(!align) align = block_size;
+    if(!has_min_size) min_size = block_size;
+    if(!dir || !image_path || block_size < 128 || block_size > 64 * 1024 || size < 2 * block_size ||
+            size % block_size || align % block_size || name_max == 0 || name_max > LFS_NAME_MAX) {
+        return usage(argv[0]);
+    }
+
+    mkimage_t t = {0};
+    t.align_blocks = align / block_size;
+    if(scan(&t, dir, "") < 0) return 1;
+    qsort(t.items, t.count, sizeof(*t.items), item_cmp);
+
+    t.image = malloc(size);
+    if(!t.image) return 1;
+    t.bd_cfg = (struct lfs_rambd_config){
+        .read_size = MKIMAGE_IO_SIZE,
+        .prog_size = MKIMAGE_IO_SIZE,
+        .erase_size = block_size,
+        .erase_count = size / block_size,
+        .buffer = t.image,
+    };
+    t.cfg = (struct lfs_config){
+        .context = &t.bd,
+        .read = lfs_rambd_read,
+        .prog = lfs_rambd_prog,
+        .erase = lfs_rambd_erase,
+        .sync = lfs_rambd_sync,
+        .read_size = MKIMAGE_IO_SIZE,
+        .prog_size = MKIMAGE_IO_SIZE,
+        .block_size = block_size,
+        .block_count = size / block_size,
+        .block_cycles = -1,  /* No wear-levelling moves while placing */
+        .cache_size = MKIMAGE_CACHE_SIZE,
+        .lookahead_size = MKIMAGE_LOOKAHEAD,
+        .name_max = name_max,
+    };
+    if(lfs_rambd_create(&t.cfg, &t.bd_cfg) < 0) return 1;
+    memset(t.image, 0xff, size);  /* Erased flash; lfs_rambd_create zeroes it */
+
+    uint8_t *manifest = NULL;
+    size_t manifest_size = 0;
+    int res = build(&t, min_size, &manifest, &manifest_size);
+    if(res < 0) {
+        fprintf(stderr, "%s: failed (%d)\n", image_path, res);
+        return 1;
+    }
+
+    FILE *f = fopen(image_path, "wb");
+    if(!f || fwrite(t.image, 1, size, f) != size || fclose(f) != 0) {
+        fprintf(stderr, "%s: %s\n", image_path, strerror(errno));
+        return 1;
+    }
+    if(manifest_path) {
+        f = fopen(manifest_path, "wb");
+        if(!f || fwrite(manifest, 1, manifest_size, f) != manifest_size || fclose(f) != 0) {
+            fprintf(stderr, "%s: %s\n", manifest_path, strerror(errno));
+            return 1;
+        }
+    }
+
+    size_t files = 0, placed = 0;
+    for(size_t i = 0; i < t.count; i++) {
+        const mkimage_item_t *it = &t.items[i];
+        files += !it->dir;
+        placed += it->placed;
+        if(verbose && it->placed) {
+            printf("  %-40s blocks %4u..%-4u %9u B  crc %08x\n", it->path, (unsigned)it->entry.first,
+                    (unsigned)(it->entry.first + it->entry.blocks - 1), (unsigned)it->entry.size,
+                    (unsigned)it->entry.crc);
+        }
+    }
+    printf("%s: %zu files, %zu on consecutive blocks (align %lu), manifest %zu B\n",
+            image_path, files, placed, align, manifest_size);
+
+    lfs_rambd_destroy(&t.cfg);  /* The buffer is ours */
+    free(t.image);
+    free(manifest);
+    for(size_t i = 0; i < t.count; i++) {
+        free(t.items[i].path);
+        free(t.items[i].host_path);
+    }
+    free(t.items);
+    return 0;
+}
@@ -0,0 +1,283 @@
+/*
+ * bench_blend - kernelurile SSE2 / AVX2 din host/blend_x86 fata de buclele C din LVGL.
+ *
+ * Pentru fiecare caz de blend spre RGB565 (fill, RGB565, RGB888, XRGB8888, ARGB8888,
+ * fiecare cu / fara opa si masca):
+ *   - check: zone, stride-uri si aliniamente aleatoare, rezultatul fiecarui nivel
+ *            trebuie sa fie identic bit cu bit cu nivelul "c" (inclusiv in afara zonei)
+ *   - timp : Mpx/s pe o zona de marimea ecranului
+ * Iese cu 1 la prima nepotrivire.
+ *
+ * Usage: bench_blend [--iters N] [--seed N] [--ms N] [--csv]
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "lvgl.h"
+#include "lvgl_private.h"
+#include "src/draw/sw/blend/lv_draw_sw_blend_to_rgb565.h"
+
+#include "lv_blend_x86.h"
+
+#define LCD_WIDTH  (320)
+#define LCD_HEIGHT (240)
+#define BUF_PAD    (24)  // Pixeli in plus pe rand, pentru stride-uri si zone decalate
+#define BUF_W      (LCD_WIDTH + BUF_PAD)
+#define BUF_H      (LCD_HEIGHT + 4)
+
+/**********************
+ *   BENCH VARIABLES
+ **********************/
+typedef enum {
+    OPA_FULL = 0,  // opa >= LV_OPA_MAX
+    OPA_PART,
+} bench_opa_t;
+
+typedef struct {
+    const char*       name;
+    bool              fill;
+    lv_color_format_t cf;  // Source format when !fill
+    bool              mask;
+    bench_opa_t       opa;
+} bench_case_t;
+
+static uint16_t s_dest_ref[BUF_W * BUF_H];
+static uint16_t s_dest_simd[BUF_W * BUF_H];
+static uint16_t s_dest_init[BUF_W * BUF_H];
+static uint8_t  s_src[BUF_W * BUF_H * 4];
+static uint8_t  s_mask[BUF_W * BUF_H];
+static uint32_t s_rng = 1;
+
+/**********************
+ *   BENCH FUNCTIONS
+ **********************/
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000u + (uint64_t) ts.tv_nsec;
+}
+//---------
+static uint32_t rnd(void) {
+    // xorshift32, acelasi sir pentru acelasi --seed
+    s_rng ^= s_rng << 13;
+    s_rng ^= s_rng >> 17;
+    s_rng ^= s_rng << 5;
+    return s_rng;
+}
+//---------
+/* Alpha / masca: multe 0 si 255 (interior si exterior), restul margini antialiasate */
+static uint8_t rnd_alpha(void) {
+    uint32_t r = rnd() % 4;
+    return r == 0 ? 0 : (r == 1 ? 255 : (uint8_t) rnd());
+}
+//---------
+static void fill_inputs(void) {
+    for (size_t i = 0; i < sizeof(s_src); i++) {
+        s_src[i] = (uint8_t) rnd();
+    }
+    for (size_t i = 3; i < sizeof(s_src); i += 4) {
+        s_src[i] = rnd_alpha();
+    }
+    for (size_t i = 0; i < sizeof(s_mask); i++) {
+        s_mask[i] = rnd_alpha();
+    }
+    for (size_t i = 0; i < BUF_W * BUF_H; i++) {
+        // Din cand in cand destinatia e egala cu sursa RGB565 (cazul c1 == c2 din lv_color_16_16_mix)
+        s_dest_init[i] = (rnd() % 8 == 0) ? ((const uint16_t*) s_src)[i] : (uint16_t) rnd();
+    }
+}
+//---------
+static uint32_t src_px_size(lv_color_format_t cf) {
+    return cf == LV_COLOR_FORMAT_RGB565 ? 2 : (cf == LV_COLOR_FORMAT_RGB888 ? 3 : 4);
+}
+//---------
+static void run_blend(const bench_case_t* c, uint16_t* dest, int32_t x, int32_t y, int32_t w, int32_t h, int32_t dest_stride_px,
+    lv_opa_t opa, lv_color_t color) {
+    if (c->fill) {
+        lv_draw_sw_blend_fill_dsc_t dsc;
+        memset(&dsc, 0, sizeof(dsc));
+        dsc.dest_buf    = dest + (size_t) y * dest_stride_px + x;
+        dsc.dest_w      = w;
+        dsc.dest_h      = h;
+        dsc.dest_stride = dest_stride_px * 2;
+        dsc.mask_buf    = c->mask ? s_mask + (size_t) y * BUF_W + x : NULL;
+        dsc.mask_stride = BUF_W;
+        dsc.color       = color;
+        dsc.opa         = opa;
+        lv_draw_sw_blend_color_to_rgb565(&dsc);
+    } else {
+        uint32_t                     px = src_px_size(c->cf);
+        lv_draw_sw_blend_image_dsc_t dsc;
+        memset(&dsc, 0, sizeof(dsc));
+        dsc.dest_buf         = dest + (size_t) y * dest_stride_px + x;
+        dsc.dest_w           = w;
+        dsc.dest_h           = h;
+        dsc.dest_stride      = dest_stride_px * 2;
+        dsc.mask_buf         = c->mask ? s_mask + (size_t) y * BUF_W + x : NULL;
+        dsc.mask_stride      = BUF_W;
+        dsc.src_buf          = s_src + ((size_t) y * BUF_W + x) * px;
+        dsc.src_stride       = BUF_W * px;
+        dsc.src_color_format = c->cf;
+        dsc.opa              = opa;
+        dsc.blend_mode       = LV_BLEND_MODE_NORMAL;
+        lv_draw_sw_blend_image_to_rgb565(&dsc);
+    }
+}
+//---------
+static lv_opa_t rnd_opa(const bench_case_t* c) {
+    if (c->opa == OPA_FULL) {
+        return (lv_opa_t) (LV_OPA_MAX + rnd() % (256 - LV_OPA_MAX));  // 253..255 merg toate pe ramura fara opa
+    }
+    return (lv_opa_t) (1 + rnd() % (LV_OPA_MAX - 1));
+}
+//---------
+/* Compara nivelul curent cu "c" pe iters zone aleatoare, intoarce numarul de nepotriviri */
+static uint32_t check_case(const bench_case_t* c, lv_blend_x86_level_t level, uint32_t iters) {
+    uint32_t bad = 0;
+    for (uint32_t i = 0; i < iters && !bad; i++) {
+        int32_t w = (i % 4 == 0) ? LCD_WIDTH : 1 + (int32_t) (rnd() % 70);  // Latimi scurte = capete de rand
+        int32_t h = 1 + (int32_t) (rnd() % 12);
+        int32_t x = (int32_t) (rnd() % (BUF_W - w + 1));
+        int32_t y = (int32_t) (rnd() % (BUF_H - h + 1));
+        int32_t stride = BUF_W - (int32_t) (rnd() % (BUF_W - (x + w) + 1));  // Stride intre x + w si BUF_W
+        if (stride < x + w) {
+            stride = BUF_W;
+        }
+        lv_opa_t   opa   = rnd_opa(c);
+        lv_color_t color = lv_color_hex(rnd() & 0xFFFFFF);
+        if (rnd() % 8 == 0) {
+            color = lv_color_hex(0x000000);
+        }
+
+        memcpy(s_dest_ref, s_dest_init, sizeof(s_dest_ref));
+        memcpy(s_dest_simd, s_dest_init, sizeof(s_dest_simd));
+        lv_blend_x86_set_level(LV_BLEND_X86_C);
+        run_blend(c, s_dest_ref, x, y, w, h, stride, opa, color);
+        lv_blend_x86_set_level(level);
+        run_blend(c, s_dest_simd, x, y, w, h, stride, opa, color);
+
+        for (size_t p = 0; p < BUF_W * BUF_H; p++) {
+            if (s_dest_ref[p] != s_dest_simd[p]) {
+                fprintf(stderr, "MISMATCH %s [%s] area %dx%d @%d,%d stride %d opa %u: px %zu c=0x%04X %s=0x%04X\n", c->name,
+                    lv_blend_x86_level_name(level), (int) w, (int) h, (int) x, (int) y, (int) stride, opa, p, s_dest_ref[p],
+                    lv_blend_x86_level_name(level), s_dest_simd[p]);
+                bad++;
+                break;
+            }
+        }
+    }
+    return bad;
+}
+//---------
+/* Mpx/s pe toata zona ecranului, repetat cel putin ms milisecunde */
+static double time_case(const bench_case_t* c, lv_blend_x86_level_t level, uint32_t ms) {
+    lv_blend_x86_set_level(level);
+    lv_opa_t   opa   = c->opa == OPA_FULL ? LV_OPA_COVER : LV_OPA_50;
+    lv_color_t color = lv_color_hex(0x3080C0);
+    memcpy(s_dest_simd, s_dest_init, sizeof(s_dest_simd));
+
+    uint64_t start = now_ns();
+    uint64_t end   = start;
+    uint32_t runs  = 0;
+    do {
+        for (int i = 0; i < 8; i++) {
+            run_blend(c, s_dest_simd, 0, 0, LCD_WIDTH, LCD_HEIGHT, BUF_W, opa, color);
+        }
+        runs += 8;
+        end = now_ns();
+    } while (end - start < (uint64_t) ms * 1000000u);
+    return (double) runs * LCD_WIDTH * LCD_HEIGHT * 1e3 / (double) (end - start);
+}
+
+/*
+███    ███  █████  ██ ███    ██
+████  ████ ██   ██ ██ ████   ██
+██ ████ ██ ███████ ██ ██ ██  ██
+██  ██  ██ ██   ██ ██ ██  ██ ██
+██      ██ ██   ██ ██ ██   ████
+*/
+int main(int argc, char** argv) {
+    uint32_t iters = 2000;
+    uint32_t seed  = 1;
+    uint32_t ms    = 200;
+    bool     csv   = false;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--iters") == 0 && i + 1 < argc) {
+            iters = (uint32_t) strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            seed = (uint32_t) strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--ms") == 0 && i + 1 < argc) {
+            ms = (uint32_t) strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--csv") == 0) {
+            csv = true;
+        } else {
+            fprintf(stderr, "usage: %s [--iters N] [--seed N] [--ms N] [--csv]\n", argv[0]);
+            return 1;
+        }
+    }
+    s_rng = seed ? seed : 1;
+    lv_init();
+    fill_inputs();
+
+    static const bench_case_t cases[] = {
+        {"fill opa", true, LV_COLOR_FORMAT_UNKNOWN, false, OPA_PART},
+        {"fill mask", true, LV_COLOR_FORMAT_UNKNOWN, true, OPA_FULL},
+        {"fill mask+opa", true, LV_COLOR_FORMAT_UNKNOWN, true, OPA_PART},
+        {"rgb565 opa", false, LV_COLOR_FORMAT_RGB565, false, OPA_PART},
+        {"rgb565 mask", false, LV_COLOR_FORMAT_RGB565, true, OPA_FULL},
+        {"rgb565 mask+opa", false, LV_COLOR_FORMAT_RGB565, true, OPA_PART},
+        {"rgb888", false, LV_COLOR_FORMAT_RGB888, false, OPA_FULL},
+        {"rgb888 opa", false, LV_COLOR_FORMAT_RGB888, false, OPA_PART},
+        {"rgb888 mask", false, LV_COLOR_FORMAT_RGB888, true, OPA_FULL},
+        {"rgb888 mask+opa", false, LV_COLOR_FORMAT_RGB888, true, OPA_PART},
+        {"xrgb8888", false, LV_COLOR_FORMAT_XRGB8888, false, OPA_FULL},
+        {"xrgb8888 opa", false, LV_COLOR_FORMAT_XRGB8888, false, OPA_PART},
+        {"xrgb8888 mask", false, LV_COLOR_FORMAT_XRGB8888, true, OPA_FULL},
+        {"xrgb8888 m+opa", false, LV_COLOR_FORMAT_XRGB8888, true, OPA_PART},
+        {"argb8888", false, LV_COLOR_FORMAT_ARGB8888, false, OPA_FULL},
+        {"argb8888 opa", false, LV_COLOR_FORMAT_ARGB8888, false, OPA_PART},
+        {"argb8888 mask", false, LV_COLOR_FORMAT_ARGB8888, true, OPA_FULL},
+        {"argb8888 m+opa", false, LV_COLOR_FORMAT_ARGB8888, true, OPA_PART},
+    };
+    const lv_blend_x86_level_t best = lv_blend_x86_detect();
+
+    if (csv) {
+        printf("case,level,mpx_per_s,speedup,check\n");
+    } else {
+        printf("CPU: %s, %u random areas per case and level\n", lv_blend_x86_level_name(best), iters);
+        printf("%-16s %10s %10s %10s %8s %8s %6s\n", "CASE", "c[Mpx/s]", "sse2", "avx2", "x sse2", "x avx2", "check");
+    }
+    uint32_t total_bad = 0;
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        const bench_case_t* c = &cases[i];
+        double              mpx[LV_BLEND_X86_AVX2 + 1];
+        uint32_t            bad = 0;
+        for (int l = LV_BLEND_X86_C; l <= LV_BLEND_X86_AVX2; l++) {
+            mpx[l] = 0.0;
+            if (l > (int) best) {
+                continue;
+            }
+            if (l != LV_BLEND_X86_C) {
+                bad += check_case(c, (lv_blend_x86_level_t) l, iters);
+            }
+            mpx[l] = time_case(c, (lv_blend_x86_level_t) l, ms);
+        }
+        total_bad += bad;
+        if (csv) {
+            for (int l = LV_BLEND_X86_C; l <= (int) best; l++) {
+                printf("%s,%s,%.1f,%.2f,%s\n", c->name, lv_blend_x86_level_name((lv_blend_x86_level_t) l), mpx[l], mpx[l] / mpx[0],
+                    bad ? "FAIL" : "ok");
+            }
+        } else {
+            printf("%-16s %10.1f %10.1f %10.1f %8.2f %8.2f %6s\n", c->name, mpx[0], mpx[1], mpx[2], mpx[1] / mpx[0], mpx[2] / mpx[0],
+                bad ? "FAIL" : "ok");
+        }
+    }
+    lv_deinit();
+    return total_bad ? 1 : 0;
+}
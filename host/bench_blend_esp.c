@@ -0,0 +1,319 @@
+/*
+ * bench_blend_esp - verificarea pe Linux a kernelurilor de pe placa (mylibs/lv-blend-v001).
+ *
+ * Pentru fiecare operatie (fill / RGB565 / ARGB8888, cu si fara opa / masca) si fiecare
+ * destinatie (RGB565, RGB565_SWAPPED), pe aceleasi intrari aleatoare:
+ *   - lv_blend_esp_ref_table (referinta pixel cu pixel) trebuie sa dea exact ce dau
+ *     buclele C din LVGL (lv_draw_sw_blend_*_to_rgb565[_swapped])
+ *   - lv_blend_esp_table (ce ruleaza pe placa, fara PIE pe host) trebuie sa dea exact
+ *     ce da referinta, pe tot bufferul (si in afara zonei)
+ *   - timp: Mpx/s referinta vs tabel pe o zona de marimea ecranului
+ * Iese cu 1 la prima nepotrivire.
+ *
+ * Rutinele PIE (ESP32-S3) nu pot rula aici; ele intra in tabel doar pentru umplerea
+ * simpla si copierea RGB565, care au aceeasi semantica cu kernelurile C verificate.
+ *
+ * Usage: bench_blend_esp [--iters N] [--seed N] [--ms N] [--csv]
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "lvgl.h"
+#include "lvgl_private.h"
+#include "src/draw/sw/blend/lv_draw_sw_blend_to_rgb565.h"
+#include "src/draw/sw/blend/lv_draw_sw_blend_to_rgb565_swapped.h"
+
+#include "lv_blend_esp_kernels.h"
+
+#if defined(LV_HOST_BLEND_X86) && LV_HOST_BLEND_X86
+    #include "lv_blend_x86.h"
+#endif /* #if defined(LV_HOST_BLEND_X86) && LV_HOST_BLEND_X86 */
+
+#define LCD_WIDTH  (320)
+#define LCD_HEIGHT (240)
+#define BUF_PAD    (24)  // Pixeli in plus pe rand, pentru stride-uri si zone decalate
+#define BUF_W      (LCD_WIDTH + BUF_PAD)
+#define BUF_H      (LCD_HEIGHT + 4)
+
+/**********************
+ *   BENCH VARIABLES
+ **********************/
+typedef enum {
+    DEST_RGB565 = 0,
+    DEST_RGB565_SWAPPED,
+    DEST_CNT,
+} bench_dest_t;
+
+typedef struct {
+    int32_t    x, y, w, h;
+    int32_t    stride_px;
+    lv_opa_t   opa;
+    lv_color_t color;
+} bench_area_t;
+
+static const char* const s_dest_names[DEST_CNT] = {"rgb565", "swapped"};
+
+static uint16_t s_dest_lvgl[BUF_W * BUF_H];
+static uint16_t s_dest_ref[BUF_W * BUF_H];
+static uint16_t s_dest_tab[BUF_W * BUF_H];
+static uint16_t s_dest_init[BUF_W * BUF_H];
+static uint8_t  s_src[BUF_W * BUF_H * 4];
+static uint8_t  s_mask[BUF_W * BUF_H];
+static uint32_t s_rng = 1;
+
+/**********************
+ *   BENCH FUNCTIONS
+ **********************/
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000u + (uint64_t) ts.tv_nsec;
+}
+//---------
+static uint32_t rnd(void) {
+    // xorshift32, acelasi sir pentru acelasi --seed
+    s_rng ^= s_rng << 13;
+    s_rng ^= s_rng >> 17;
+    s_rng ^= s_rng << 5;
+    return s_rng;
+}
+//---------
+/* Alpha / masca: multe 0 si 255 (interior si exterior), restul margini antialiasate */
+static uint8_t rnd_alpha(void) {
+    uint32_t r = rnd() % 4;
+    return r == 0 ? 0 : (r == 1 ? 255 : (uint8_t) rnd());
+}
+//---------
+static void fill_inputs(void) {
+    for (size_t i = 0; i < sizeof(s_src); i++) {
+        s_src[i] = (uint8_t) rnd();
+    }
+    for (size_t i = 3; i < sizeof(s_src); i += 4) {
+        s_src[i] = rnd_alpha();
+    }
+    for (size_t i = 0; i < sizeof(s_mask); i++) {
+        // Si rulari de 4 bytes de 0 / 255, ca sa treaca prin scurtaturile pe cuvinte
+        s_mask[i] = (rnd() % 3 == 0 && i >= 4) ? s_mask[i - 4] : rnd_alpha();
+    }
+    for (size_t i = 0; i < BUF_W * BUF_H; i++) {
+        // Din cand in cand destinatia e egala cu sursa RGB565 (cazul c1 == c2 din lv_color_16_16_mix)
+        s_dest_init[i] = (rnd() % 8 == 0) ? ((const uint16_t*) s_src)[i] : (uint16_t) rnd();
+    }
+}
+//---------
+static bool op_is_fill(lv_blend_esp_op_t op) {
+    return op <= LV_BLEND_ESP_FILL_MASK_OPA;
+}
+//---------
+static bool op_has_mask(lv_blend_esp_op_t op) {
+    return (op % 4) >= 2;  // Ordinea din enum: PLAIN, OPA, MASK, MASK_OPA
+}
+//---------
+static bool op_has_opa(lv_blend_esp_op_t op) {
+    return (op % 4) == 1 || (op % 4) == 3;
+}
+//---------
+static uint32_t op_px_size(lv_blend_esp_op_t op) {
+    return op_is_fill(op) ? 0 : (op <= LV_BLEND_ESP_RGB565_MASK_OPA ? 2 : 4);
+}
+//---------
+static const uint8_t* area_src(lv_blend_esp_op_t op, const bench_area_t* a) {
+    return s_src + ((size_t) a->y * BUF_W + a->x) * op_px_size(op);
+}
+//---------
+/* Bucla C din LVGL, aleasa de LVGL din opa / masca exact ca pe placa */
+static void run_lvgl(lv_blend_esp_op_t op, bench_dest_t dest, uint16_t* buf, const bench_area_t* a) {
+    if (op_is_fill(op)) {
+        lv_draw_sw_blend_fill_dsc_t dsc;
+        memset(&dsc, 0, sizeof(dsc));
+        dsc.dest_buf    = buf + (size_t) a->y * a->stride_px + a->x;
+        dsc.dest_w      = a->w;
+        dsc.dest_h      = a->h;
+        dsc.dest_stride = a->stride_px * 2;
+        dsc.mask_buf    = op_has_mask(op) ? s_mask + (size_t) a->y * BUF_W + a->x : NULL;
+        dsc.mask_stride = BUF_W;
+        dsc.color       = a->color;
+        dsc.opa         = a->opa;
+        if (dest == DEST_RGB565) {
+            lv_draw_sw_blend_color_to_rgb565(&dsc);
+        } else {
+            lv_draw_sw_blend_color_to_rgb565_swapped(&dsc);
+        }
+    } else {
+        lv_draw_sw_blend_image_dsc_t dsc;
+        memset(&dsc, 0, sizeof(dsc));
+        dsc.dest_buf         = buf + (size_t) a->y * a->stride_px + a->x;
+        dsc.dest_w           = a->w;
+        dsc.dest_h           = a->h;
+        dsc.dest_stride      = a->stride_px * 2;
+        dsc.mask_buf         = op_has_mask(op) ? s_mask + (size_t) a->y * BUF_W + a->x : NULL;
+        dsc.mask_stride      = BUF_W;
+        dsc.src_buf          = area_src(op, a);
+        dsc.src_stride       = BUF_W * op_px_size(op);
+        dsc.src_color_format = op_px_size(op) == 2 ? LV_COLOR_FORMAT_RGB565 : LV_COLOR_FORMAT_ARGB8888;
+        dsc.opa              = a->opa;
+        dsc.blend_mode       = LV_BLEND_MODE_NORMAL;
+        if (dest == DEST_RGB565) {
+            lv_draw_sw_blend_image_to_rgb565(&dsc);
+        } else {
+            lv_draw_sw_blend_image_to_rgb565_swapped(&dsc);
+        }
+    }
+}
+//---------
+static void run_table(const lv_blend_esp_table_t* table, lv_blend_esp_op_t op, bench_dest_t dest, uint16_t* buf,
+    const bench_area_t* a) {
+    lv_blend_esp_dsc_t dsc = {
+        .opa         = a->opa,
+        .dst_buf     = buf + (size_t) a->y * a->stride_px + a->x,
+        .dst_w       = (uint32_t) a->w,
+        .dst_h       = (uint32_t) a->h,
+        .dst_stride  = (uint32_t) a->stride_px * 2,
+        .src_buf     = op_is_fill(op) ? (const void*) &a->color : (const void*) area_src(op, a),
+        .src_stride  = BUF_W * op_px_size(op),
+        .mask_buf    = op_has_mask(op) ? s_mask + (size_t) a->y * BUF_W + a->x : NULL,
+        .mask_stride = BUF_W,
+    };
+    const lv_blend_esp_fn_t* row = dest == DEST_RGB565 ? table->to_rgb565 : table->to_rgb565_swapped;
+    row[op](&dsc);
+}
+//---------
+static lv_opa_t rnd_opa(lv_blend_esp_op_t op) {
+    if (!op_has_opa(op)) {
+        return (lv_opa_t) (LV_OPA_MAX + rnd() % (256 - LV_OPA_MAX));  // 253..255 merg toate pe ramura fara opa
+    }
+    return (lv_opa_t) (rnd() % LV_OPA_MAX);  // Inclusiv 0..3 si 249..252 (mix5 = 0 / 32)
+}
+//---------
+static bool compare(const char* what, lv_blend_esp_op_t op, bench_dest_t dest, const bench_area_t* a, const uint16_t* exp,
+    const uint16_t* got) {
+    for (size_t p = 0; p < BUF_W * BUF_H; p++) {
+        if (exp[p] != got[p]) {
+            fprintf(stderr, "MISMATCH %s %s -> %s, area %dx%d @%d,%d stride %d opa %u: px %zu expected 0x%04X got 0x%04X\n", what,
+                lv_blend_esp_op_name(op), s_dest_names[dest], (int) a->w, (int) a->h, (int) a->x, (int) a->y, (int) a->stride_px,
+                a->opa, p, exp[p], got[p]);
+            return false;
+        }
+    }
+    return true;
+}
+//---------
+/* LVGL vs referinta vs tabel pe iters zone aleatoare, intoarce numarul de nepotriviri */
+static uint32_t check_op(lv_blend_esp_op_t op, bench_dest_t dest, uint32_t iters) {
+    uint32_t bad = 0;
+    for (uint32_t i = 0; i < iters && !bad; i++) {
+        bench_area_t a;
+        a.w = (i % 4 == 0) ? LCD_WIDTH : 1 + (int32_t) (rnd() % 70);  // Latimi scurte = capete de rand
+        a.h = 1 + (int32_t) (rnd() % 12);
+        a.x = (int32_t) (rnd() % (BUF_W - a.w + 1));
+        a.y = (int32_t) (rnd() % (BUF_H - a.h + 1));
+        a.stride_px = BUF_W - (int32_t) (rnd() % (BUF_W - (a.x + a.w) + 1));  // Stride intre x + w si BUF_W
+        if (a.stride_px < a.x + a.w) {
+            a.stride_px = BUF_W;
+        }
+        a.opa   = rnd_opa(op);
+        a.color = lv_color_hex(rnd() & 0xFFFFFF);
+        if (rnd() % 8 == 0) {
+            a.color = lv_color_hex(0x000000);
+        }
+
+        memcpy(s_dest_lvgl, s_dest_init, sizeof(s_dest_lvgl));
+        memcpy(s_dest_ref, s_dest_init, sizeof(s_dest_ref));
+        memcpy(s_dest_tab, s_dest_init, sizeof(s_dest_tab));
+        run_lvgl(op, dest, s_dest_lvgl, &a);
+        run_table(&lv_blend_esp_ref_table, op, dest, s_dest_ref, &a);
+        run_table(&lv_blend_esp_table, op, dest, s_dest_tab, &a);
+
+        if (!compare("ref vs lvgl", op, dest, &a, s_dest_lvgl, s_dest_ref) ||
+            !compare("table vs ref", op, dest, &a, s_dest_ref, s_dest_tab)) {
+            bad++;
+        }
+    }
+    return bad;
+}
+//---------
+/* Mpx/s pe toata zona ecranului, repetat cel putin ms milisecunde */
+static double time_op(const lv_blend_esp_table_t* table, lv_blend_esp_op_t op, bench_dest_t dest, uint32_t ms) {
+    bench_area_t a = {
+        .x = 0, .y = 0, .w = LCD_WIDTH, .h = LCD_HEIGHT, .stride_px = BUF_W,
+        .opa   = op_has_opa(op) ? LV_OPA_50 : LV_OPA_COVER,
+        .color = lv_color_hex(0x3080C0),
+    };
+    memcpy(s_dest_tab, s_dest_init, sizeof(s_dest_tab));
+
+    uint64_t start = now_ns();
+    uint64_t end   = start;
+    uint32_t runs  = 0;
+    do {
+        for (int i = 0; i < 8; i++) {
+            run_table(table, op, dest, s_dest_tab, &a);
+        }
+        runs += 8;
+        end = now_ns();
+    } while (end - start < (uint64_t) ms * 1000000u);
+    return (double) runs * LCD_WIDTH * LCD_HEIGHT * 1e3 / (double) (end - start);
+}
+
+/*
+███    ███  █████  ██ ███    ██
+████  ████ ██   ██ ██ ████   ██
+██ ████ ██ ███████ ██ ██ ██  ██
+██  ██  ██ ██   ██ ██ ██  ██ ██
+██      ██ ██   ██ ██ ██   ████
+*/
+int main(int argc, char** argv) {
+    uint32_t iters = 2000;
+    uint32_t seed  = 1;
+    uint32_t ms    = 200;
+    bool     csv   = false;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--iters") == 0 && i + 1 < argc) {
+            iters = (uint32_t) strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            seed = (uint32_t) strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--ms") == 0 && i + 1 < argc) {
+            ms = (uint32_t) strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--csv") == 0) {
+            csv = true;
+        } else {
+            fprintf(stderr, "usage: %s [--iters N] [--seed N] [--ms N] [--csv]\n", argv[0]);
+            return 1;
+        }
+    }
+    s_rng = seed ? seed : 1;
+    lv_init();
+#if defined(LV_HOST_BLEND_X86) && LV_HOST_BLEND_X86
+    lv_blend_x86_set_level(LV_BLEND_X86_C);  // Comparam cu buclele C din LVGL, nu cu SSE2 / AVX2
+#endif /* #if defined(LV_HOST_BLEND_X86) && LV_HOST_BLEND_X86 */
+    fill_inputs();
+
+    if (csv) {
+        printf("op,dest,ref_mpx_per_s,table_mpx_per_s,speedup,check\n");
+    } else {
+        printf("%u random areas per op and destination (lvgl == ref == table)\n", iters);
+        printf("%-18s %-8s %10s %10s %8s %6s\n", "OP", "DEST", "ref[Mpx/s]", "table", "x", "check");
+    }
+    uint32_t total_bad = 0;
+    for (int d = 0; d < DEST_CNT; d++) {
+        for (int o = 0; o < LV_BLEND_ESP_OP_CNT; o++) {
+            lv_blend_esp_op_t op  = (lv_blend_esp_op_t) o;
+            uint32_t          bad = check_op(op, (bench_dest_t) d, iters);
+            double            ref = time_op(&lv_blend_esp_ref_table, op, (bench_dest_t) d, ms);
+            double            tab = time_op(&lv_blend_esp_table, op, (bench_dest_t) d, ms);
+            total_bad += bad;
+            if (csv) {
+                printf("%s,%s,%.1f,%.1f,%.2f,%s\n", lv_blend_esp_op_name(op), s_dest_names[d], ref, tab, tab / ref, bad ? "FAIL" : "ok");
+            } else {
+                printf("%-18s %-8s %10.1f %10.1f %8.2f %6s\n", lv_blend_esp_op_name(op), s_dest_names[d], ref, tab, tab / ref,
+                    bad ? "FAIL" : "ok");
+            }
+        }
+    }
+    lv_deinit();
+    return total_bad ? 1 : 0;
+}
@@ -0,0 +1,586 @@
+/*
+ * bench_cli_history - istoricul consolei (mylibs/one-cli-v005/src/history.c) pe littlefs
+ *
+ * littlefs din components/littlefs peste lfs_emubd (flash emulat in RAM) cu geometria de pe
+ * placa (partitia littlefs de 1 MB, blocuri de 4 KB, read/prog 128, cache 512, lookahead 128,
+ * block_cycles 512). Fiecare prog() si erase() al block device-ului e numarat.
+ *
+ *   1. cost per --commands comenzi (implicit 1000):
+ *        - inainte: linenoiseHistorySave() dupa fiecare comanda = rescrierea fisierului cu
+ *          ultimele 100 de comenzi
+ *        - jurnalul scris dupa fiecare comanda (cel mai rau caz: pauza > CONSOLE_HISTORY_FLUSH_MS
+ *          intre comenzi) si in loturi de --batch comenzi (debounce-ul task-ului cli_hist)
+ *      operatii prog / bytes / erase si uzura maxima a unui bloc; dupa fiecare scenariu
+ *      remount + load == ultimele 100 de comenzi
+ *   2. cazuri: fisier vechi (linii simple) importat si convertit, ultima linie rupta, inregistrare
+ *      corupta, fisier .tmp ramas, append care esueaza la jumatate (fara dubluri la reincercare),
+ *      buffer plin, lot nescris la care se adauga comenzile noi
+ *   3. pierderea alimentarii: lfs_emubd taie curentul la al K-lea prog/erase (longjmp din
+ *      callback), pentru K din toata rularea; dupa remount, istoricul incarcat trebuie sa fie
+ *      ultimele comenzi pana la un lot complet: toate loturile scrise inainte de taiere, plus
+ *      eventual cel intrerupt (littlefs face append-ul vizibil atomic la close)
+ *
+ * Usage: bench_cli_history [--commands N] [--batch N] [--stride N]
+ */
+
+#include <setjmp.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bd/lfs_emubd.h"
+#include "history.h"
+#include "lfs.h"
+
+#define BLOCK_SIZE   (4096)
+#define BLOCK_COUNT  (256)  // Partitia littlefs din partition.csv: 1 MB
+#define IO_SIZE      (128)  // CONFIG_LITTLEFS_READ_SIZE / _WRITE_SIZE
+#define CACHE_SIZE   (512)  // CONFIG_LITTLEFS_CACHE_SIZE
+#define LOOKAHEAD    (128)
+#define MAX_LEN      (100)   // CONSOLE_HISTORY_MAX_LEN
+#define PENDING      (1024)  // CONSOLE_HISTORY_PENDING
+#define HISTORY_FILE "/history.txt"
+#define MAX_COMMANDS (20000)
+#define MAX_OPEN     (4)
+
+/**********************
+ *   FLASH EMULAT + CONTOARE
+ **********************/
+static lfs_emubd_t               s_bd;
+static struct lfs_emubd_config   s_bd_cfg;
+static struct lfs_config         s_cfg;
+static lfs_t                     s_lfs;
+static uint8_t                   s_read_buf[CACHE_SIZE], s_prog_buf[CACHE_SIZE], s_lookahead_buf[LOOKAHEAD];
+static uint64_t                  s_progs, s_erases;
+static jmp_buf                   s_powerloss_jmp;
+
+static int bench_prog(const struct lfs_config* c, lfs_block_t block, lfs_off_t off, const void* buf, lfs_size_t size) {
+    s_progs++;
+    return lfs_emubd_prog(c, block, off, buf, size);
+}
+//---------
+static int bench_erase(const struct lfs_config* c, lfs_block_t block) {
+    s_erases++;
+    return lfs_emubd_erase(c, block);
+}
+//---------
+static void bench_powerloss(void* data) {
+    (void) data;
+    longjmp(s_powerloss_jmp, 1);
+}
+//---------
+static void flash_create(void) {
+    s_bd_cfg = (struct lfs_emubd_config){
+        .read_size          = IO_SIZE,
+        .prog_size          = IO_SIZE,
+        .erase_size         = BLOCK_SIZE,
+        .erase_count        = BLOCK_COUNT,
+        .erase_value        = 0xff,
+        .erase_cycles       = 1000000,  // Doar pentru contorul de uzura, fara blocuri stricate
+        .powerloss_behavior = LFS_EMUBD_POWERLOSS_NOOP,
+        .powerloss_cb       = bench_powerloss,
+    };
+    s_cfg = (struct lfs_config){
+        .context          = &s_bd,
+        .read             = lfs_emubd_read,
+        .prog             = bench_prog,
+        .erase            = bench_erase,
+        .sync             = lfs_emubd_sync,
+        .read_size        = IO_SIZE,
+        .prog_size        = IO_SIZE,
+        .block_size       = BLOCK_SIZE,
+        .block_count      = BLOCK_COUNT,
+        .block_cycles     = 512,
+        .cache_size       = CACHE_SIZE,
+        .lookahead_size   = LOOKAHEAD,
+        .read_buffer      = s_read_buf,
+        .prog_buffer      = s_prog_buf,
+        .lookahead_buffer = s_lookahead_buf,
+    };
+    if (lfs_emubd_create(&s_cfg, &s_bd_cfg) || lfs_format(&s_lfs, &s_cfg) || lfs_mount(&s_lfs, &s_cfg)) {
+        fprintf(stderr, "littlefs setup failed\n");
+        exit(1);
+    }
+    s_progs  = 0;
+    s_erases = 0;
+    lfs_emubd_setproged(&s_cfg, 0);
+    lfs_emubd_seterased(&s_cfg, 0);
+}
+//---------
+static void flash_destroy(void) {
+    lfs_unmount(&s_lfs);
+    lfs_emubd_destroy(&s_cfg);
+}
+//---------
+static uint32_t flash_max_wear(void) {
+    uint32_t max = 0;
+    for (lfs_block_t b = 0; b < BLOCK_COUNT; b++) {
+        lfs_emubd_swear_t w = lfs_emubd_wear(&s_cfg, b);
+        max                 = w > (lfs_emubd_swear_t) max ? (uint32_t) w : max;
+    }
+    return max;
+}
+
+/**********************
+ *   IO PESTE LITTLEFS (in locul stdio/VFS de pe placa)
+ **********************/
+typedef struct {
+    lfs_file_t             file;
+    struct lfs_file_config cfg;  // littlefs pastreaza pointerul pana la close
+    uint8_t                buffer[CACHE_SIZE];
+    bool                   used;
+} bench_file_t;
+
+static bench_file_t s_files[MAX_OPEN];  // Static: un longjmp din mijlocul unei scrieri nu pierde memorie
+static long         s_fail_after = -1;  // >= 0: dupa atatia bytes (in oricate write-uri) scrierea esueaza
+
+static void* io_open(void* ctx, const char* path, const char* mode) {
+    int flags = mode[0] == 'r' ? LFS_O_RDONLY
+              : mode[0] == 'a' ? LFS_O_WRONLY | LFS_O_CREAT | LFS_O_APPEND
+                               : LFS_O_WRONLY | LFS_O_CREAT | LFS_O_TRUNC;
+    for (int i = 0; i < MAX_OPEN; i++) {
+        if (!s_files[i].used) {
+            s_files[i].cfg = (struct lfs_file_config){.buffer = s_files[i].buffer};
+            if (lfs_file_opencfg(ctx, &s_files[i].file, path, flags, &s_files[i].cfg) < 0) {
+                return NULL;
+            }
+            s_files[i].used = true;
+            return &s_files[i];
+        }
+    }
+    return NULL;
+}
+//---------
+static int io_read(void* ctx, void* file, void* buf, size_t len) {
+    return (int) lfs_file_read(ctx, &((bench_file_t*) file)->file, buf, (lfs_size_t) len);
+}
+//---------
+static int io_write(void* ctx, void* file, const void* buf, size_t len) {
+    bool fail = false;
+    if (s_fail_after >= 0 && (size_t) s_fail_after <= len) {
+        len          = (size_t) s_fail_after;
+        s_fail_after = -1;
+        fail         = true;
+    } else if (s_fail_after >= 0) {
+        s_fail_after -= (long) len;
+    }
+    lfs_ssize_t n = len ? lfs_file_write(ctx, &((bench_file_t*) file)->file, buf, (lfs_size_t) len) : 0;
+    return (fail || n != (lfs_ssize_t) len) ? -1 : 0;
+}
+//---------
+static int io_close(void* ctx, void* file) {
+    ((bench_file_t*) file)->used = false;
+    return lfs_file_close(ctx, &((bench_file_t*) file)->file) < 0 ? -1 : 0;
+}
+//---------
+static int io_rename(void* ctx, const char* from, const char* to) {
+    return lfs_rename(ctx, from, to) < 0 ? -1 : 0;
+}
+//---------
+static int io_remove(void* ctx, const char* path) {
+    return lfs_remove(ctx, path) < 0 ? -1 : 0;
+}
+
+static const cli_history_io_t s_io = {io_open, io_read, io_write, io_close, io_rename, io_remove, &s_lfs};
+
+/**********************
+ *   HELPERS
+ **********************/
+static char s_cmds[MAX_COMMANDS][48];
+
+static bool expect(bool cond, const char* what) {
+    printf("  %-64s %s\n", what, cond ? "ok" : "FAIL");
+    return cond;
+}
+//---------
+static void make_commands(uint32_t n) {
+    static const char* const pool[] = {"tasks", "tasks --watch -i 500", "info", "uptime", "set log wifi debug",
+        "wifi join lab-ap secret", "perfmon", "restart", "tasks sort cpu", "help"};
+    for (uint32_t i = 0; i < n; i++) {
+        snprintf(s_cmds[i], sizeof(s_cmds[i]), "%s #%u", pool[i % 10], (unsigned) i);
+    }
+}
+//---------
+typedef struct {
+    char     lines[MAX_LEN * 2][CLI_HISTORY_LINE_MAX];
+    uint32_t count;
+} capture_t;
+
+static capture_t s_got;
+
+static void capture_add(void* ctx, const char* line) {
+    capture_t* c = ctx;
+    if (c->count < MAX_LEN * 2) {
+        snprintf(c->lines[c->count], sizeof(c->lines[0]), "%s", line);
+    }
+    c->count++;
+}
+//---------
+/* Remount si load intr-un cli_history_t nou, ca la un boot */
+static uint32_t reload(cli_history_t* h) {
+    memset(s_files, 0, sizeof(s_files));
+    lfs_unmount(&s_lfs);
+    if (lfs_mount(&s_lfs, &s_cfg)) {
+        return UINT32_MAX;
+    }
+    cli_history_deinit(h);
+    cli_history_init(h, &s_io, HISTORY_FILE, MAX_LEN, PENDING);
+    s_got.count = 0;
+    return cli_history_load(h, capture_add, &s_got);
+}
+//---------
+/* s_got == comenzile [first, first + n) */
+static bool got_range(uint32_t first, uint32_t n) {
+    if (s_got.count != n) {
+        return false;
+    }
+    for (uint32_t i = 0; i < n; i++) {
+        if (strcmp(s_got.lines[i], s_cmds[first + i]) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+//---------
+static bool got_list(const char* const* list, uint32_t n) {
+    if (s_got.count != n) {
+        return false;
+    }
+    for (uint32_t i = 0; i < n; i++) {
+        if (strcmp(s_got.lines[i], list[i]) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+//---------
+static void write_raw(const char* path, const char* text) {
+    lfs_file_t f;
+    lfs_file_open(&s_lfs, &f, path, LFS_O_WRONLY | LFS_O_CREAT | LFS_O_TRUNC);
+    lfs_file_write(&s_lfs, &f, text, (lfs_size_t) strlen(text));
+    lfs_file_close(&s_lfs, &f);
+}
+//---------
+static size_t read_raw(const char* path, char* out, size_t size) {
+    lfs_file_t f;
+    if (lfs_file_open(&s_lfs, &f, path, LFS_O_RDONLY) < 0) {
+        return 0;
+    }
+    lfs_ssize_t n = lfs_file_read(&s_lfs, &f, out, (lfs_size_t) size - 1);
+    lfs_file_close(&s_lfs, &f);
+    out[n > 0 ? n : 0] = '\0';
+    return n > 0 ? (size_t) n : 0;
+}
+
+/**********************
+ *   1. COST PER N COMENZI
+ **********************/
+typedef struct {
+    const char* name;
+    uint64_t    progs;
+    uint64_t    prog_bytes;
+    uint64_t    erases;
+    uint32_t    max_wear;
+} cost_t;
+
+static void cost_take(cost_t* c, const char* name) {
+    c->name       = name;
+    c->progs      = s_progs;
+    c->prog_bytes = (uint64_t) lfs_emubd_proged(&s_cfg);
+    c->erases     = s_erases;
+    c->max_wear   = flash_max_wear();
+}
+//---------
+/* Ce facea one-cli.c: linenoiseHistoryAdd + linenoiseHistorySave (fopen "w", toate liniile, fclose) */
+static void run_linenoise_save(uint32_t n) {
+    for (uint32_t i = 0; i < n; i++) {
+        lfs_file_t f;
+        lfs_file_open(&s_lfs, &f, HISTORY_FILE, LFS_O_WRONLY | LFS_O_CREAT | LFS_O_TRUNC);
+        for (uint32_t j = i + 1 > MAX_LEN ? i + 1 - MAX_LEN : 0; j <= i; j++) {
+            lfs_file_write(&s_lfs, &f, s_cmds[j], (lfs_size_t) strlen(s_cmds[j]));
+            lfs_file_write(&s_lfs, &f, "\n", 1);
+        }
+        lfs_file_close(&s_lfs, &f);
+    }
+}
+//---------
+static bool run_log(cli_history_t* h, uint32_t n, uint32_t batch) {
+    bool ok = true;
+    for (uint32_t i = 0; i < n; i++) {
+        cli_history_push(h, s_cmds[i]);
+        if ((i + 1) % batch == 0 || i + 1 == n) {
+            ok &= cli_history_flush(h) == 0;
+        }
+    }
+    return ok;
+}
+//---------
+static bool check_cost(uint32_t n, uint32_t batch) {
+    bool          ok = true;
+    cost_t        cost[3];
+    cli_history_t h  = {0};
+    char          what[96];
+    uint32_t      tail = n < MAX_LEN ? n : MAX_LEN;
+
+    flash_create();
+    run_linenoise_save(n);
+    cost_take(&cost[0], "linenoiseHistorySave per command");
+    // Fisierul vechi, incarcat de noul cod: ultimele 100, convertit in jurnal
+    uint32_t loaded = reload(&h);
+    snprintf(what, sizeof(what), "before: legacy file imported, %u commands", (unsigned) loaded);
+    ok &= expect(got_range(n - tail, tail), what);
+    flash_destroy();
+
+    static const char* const names[] = {"log, flushed per command", "log, flushed per batch"};
+    uint32_t                 batches[] = {1, batch};
+    for (int s = 0; s < 2; s++) {
+        flash_create();
+        cli_history_deinit(&h);
+        cli_history_init(&h, &s_io, HISTORY_FILE, MAX_LEN, PENDING);
+        cli_history_load(&h, capture_add, &s_got);
+        ok &= expect(run_log(&h, n, batches[s]), "every flush returned 0");
+        uint32_t compactions = h.compactions;
+        cost_take(&cost[1 + s], names[s]);
+        reload(&h);
+        snprintf(what, sizeof(what), "batch %u: reload == last %u commands (%u compactions)", (unsigned) batches[s],
+            (unsigned) tail, (unsigned) compactions);
+        ok &= expect(got_range(n - tail, tail), what);
+        flash_destroy();
+    }
+    cli_history_deinit(&h);
+
+    printf("\n  per %u commands (batch = %u)      %10s %12s %8s %10s\n", (unsigned) n, (unsigned) batch, "prog ops",
+        "prog bytes", "erases", "max wear");
+    for (int s = 0; s < 3; s++) {
+        printf("  %-34s %10llu %12llu %8llu %10u\n", cost[s].name, (unsigned long long) cost[s].progs,
+            (unsigned long long) cost[s].prog_bytes, (unsigned long long) cost[s].erases, (unsigned) cost[s].max_wear);
+    }
+    for (int s = 1; s < 3; s++) {
+        printf("  %-34s %9.1fx fewer prog bytes, %.1fx fewer erases\n", cost[s].name,
+            (double) cost[0].prog_bytes / (double) (cost[s].prog_bytes ? cost[s].prog_bytes : 1),
+            (double) cost[0].erases / (double) (cost[s].erases ? cost[s].erases : 1));
+    }
+    printf("\n");
+    ok &= expect(cost[1].prog_bytes < cost[0].prog_bytes && cost[1].erases < cost[0].erases,
+        "log per command: fewer prog bytes and erases than before");
+    if (batch > 1) {
+        ok &= expect(cost[2].prog_bytes < cost[1].prog_bytes && cost[2].erases <= cost[1].erases,
+            "batched: fewer again");
+    }
+    return ok;
+}
+
+/**********************
+ *   2. CAZURI
+ **********************/
+static bool check_cases(void) {
+    bool          ok = true;
+    cli_history_t h  = {0};
+    char          raw[4096];
+
+    // Fisier vechi scris de linenoiseHistorySave, cu o linie goala
+    flash_create();
+    write_raw(HISTORY_FILE, "help\ntasks\n\ninfo\n");
+    static const char* const legacy[] = {"help", "tasks", "info"};
+    reload(&h);
+    ok &= expect(got_list(legacy, 3), "legacy file: lines loaded in order");
+    read_raw(HISTORY_FILE, raw, sizeof(raw));
+    ok &= expect(h.compactions == 1 && strlen(raw) > 18 && raw[8] == '#' && raw[26] == ' ' &&
+                     strstr(raw, " info\n") != NULL,
+        "legacy file: converted (header + records)");
+    cli_history_push(&h, "uptime");
+    cli_history_flush(&h);
+    static const char* const legacy2[] = {"help", "tasks", "info", "uptime"};
+    reload(&h);
+    ok &= expect(got_list(legacy2, 4) && h.compactions == 0 && h.log_records == 1,
+        "legacy file: next command appended to the log");
+
+    // O inregistrare corupta in fisierul compactat, ultima linie din jurnal rupta (append
+    // intrerupt pe un filesystem fara scrieri atomice)
+    read_raw(HISTORY_FILE, raw, sizeof(raw));
+    strstr(raw, " help\n")[1] = 'H';  // hash-ul nu se mai potriveste
+    write_raw(HISTORY_FILE, raw);
+    size_t len = read_raw(HISTORY_FILE ".log", raw, sizeof(raw));
+    snprintf(raw + len, sizeof(raw) - len, "1234abcd rest");
+    write_raw(HISTORY_FILE ".log", raw);
+    static const char* const damaged[] = {"tasks", "info", "uptime"};
+    reload(&h);
+    ok &= expect(got_list(damaged, 3) && h.skipped == 2, "torn tail + bad hash: skipped, the rest loaded");
+    cli_history_push(&h, "perfmon");
+    cli_history_flush(&h);
+    static const char* const damaged2[] = {"tasks", "info", "uptime", "perfmon"};
+    reload(&h);
+    ok &= expect(got_list(damaged2, 4) && h.skipped == 0, "compacted on load, next append is clean");
+
+    // Compactare intrerupta inainte de rename: .tmp ramas
+    write_raw(HISTORY_FILE ".tmp", "garbage");
+    reload(&h);
+    struct lfs_info info;
+    ok &= expect(got_list(damaged2, 4) && lfs_stat(&s_lfs, HISTORY_FILE ".tmp", &info) == LFS_ERR_NOENT,
+        "stale .tmp removed, history untouched");
+
+    // Compactare terminata, dar jurnalul vechi n-a mai fost sters: generatia lui e alta
+    read_raw(HISTORY_FILE ".log", raw, sizeof(raw));
+    write_raw(HISTORY_FILE ".old", raw);
+    reload(&h);
+    cli_history_push(&h, "compact");
+    uint32_t compactions = h.compactions;
+    h.log_bytes    = CLI_HISTORY_LOG_MAX;  // Forteaza compactarea cu tot cu lot
+    cli_history_flush(&h);
+    lfs_rename(&s_lfs, HISTORY_FILE ".old", HISTORY_FILE ".log");
+    static const char* const regen[] = {"tasks", "info", "uptime", "perfmon", "compact"};
+    reload(&h);
+    ok &= expect(h.compactions == 0 && compactions == 0 && got_list(regen, 5) &&
+                     lfs_stat(&s_lfs, HISTORY_FILE ".log", &info) == LFS_ERR_NOENT,
+        "log of an older generation: ignored and removed");
+
+    // Append care scrie doar o parte din lot: reincercarea nu dubleaza ce a ajuns deja
+    cli_history_push(&h, "a1");
+    cli_history_push(&h, "a2");
+    cli_history_push(&h, "a3");
+    s_fail_after = 18 + 25;  // Antetul jurnalului nou, "xxxxxxxx a1\n", "xxxxxxxx a2\n", un byte din a3
+    bool failed  = cli_history_flush(&h) != 0;
+    ok &= expect(failed && h.damaged && h.writing_count == 3, "partial append: error, batch kept");
+    cli_history_push(&h, "a4");
+    ok &= expect(cli_history_flush(&h) == 0 && !h.damaged, "retry: compaction + rest of the batch");
+    static const char* const retry[] = {"tasks", "info", "uptime", "perfmon", "compact", "a1", "a2", "a3", "a4"};
+    reload(&h);
+    ok &= expect(got_list(retry, 9) && h.skipped == 0, "retry: no duplicates, nothing lost");
+
+    // Lot nescris (write esuat fara niciun byte): comenzile noi se adauga dupa el
+    cli_history_push(&h, "b1");
+    cli_history_swap(&h);
+    s_fail_after = 0;
+    cli_history_write(&h);
+    cli_history_push(&h, "b2");
+    cli_history_swap(&h);
+    ok &= expect(h.writing_count == 2 && h.pending_len == 0, "unwritten batch: new commands appended to it");
+    cli_history_write(&h);
+    static const char* const later[] = {
+        "tasks", "info", "uptime", "perfmon", "compact", "a1", "a2", "a3", "a4", "b1", "b2"};
+    reload(&h);
+    ok &= expect(got_list(later, 11), "unwritten batch: written in order");
+    flash_destroy();
+    cli_history_deinit(&h);
+
+    // Buffer plin: push semnaleaza, comenzile in plus sunt numarate
+    cli_history_init(&h, &s_io, HISTORY_FILE, MAX_LEN, 64);
+    bool urgent = cli_history_push(&h, "0123456789012345678901234567890123456789");  // 50 > 64 * 3/4
+    cli_history_push(&h, "more");
+    cli_history_push(&h, "0123456789012345678901234567890123456789");
+    ok &= expect(urgent && h.pending_count == 2 && h.dropped == 1, "full buffer: urgent flag, overflow counted");
+    cli_history_deinit(&h);
+    return ok;
+}
+
+/**********************
+ *   3. PIERDEREA ALIMENTARII
+ **********************/
+static bool check_powerloss(uint32_t n, uint32_t batch, uint32_t stride) {
+    // Rularea fara taiere, ca sa stim cate operatii are
+    flash_create();
+    cli_history_t h = {0};
+    cli_history_init(&h, &s_io, HISTORY_FILE, MAX_LEN, PENDING);
+    cli_history_load(&h, capture_add, &s_got);
+    run_log(&h, n, batch);
+    uint64_t total = s_progs + s_erases;
+    flash_destroy();
+
+    uint32_t cuts = 0, bad = 0, lost_batches = 0;
+    for (uint64_t k = 1; k <= total; k += stride) {
+        flash_create();
+        memset(s_files, 0, sizeof(s_files));
+        cli_history_deinit(&h);
+        cli_history_init(&h, &s_io, HISTORY_FILE, MAX_LEN, PENDING);
+        cli_history_load(&h, capture_add, &s_got);
+        lfs_emubd_setpowercycles(&s_cfg, (lfs_emubd_powercycles_t) k);
+
+        volatile uint32_t durable   = 0;  // Comenzi dintr-un flush terminat cu 0
+        volatile uint32_t attempted = 0;  // ... plus lotul in curs de scriere
+        volatile bool     cut       = false;
+        if (setjmp(s_powerloss_jmp) == 0) {
+            for (uint32_t i = 0; i < n; i++) {
+                cli_history_push(&h, s_cmds[i]);
+                if ((i + 1) % batch == 0 || i + 1 == n) {
+                    attempted = i + 1;
+                    if (cli_history_flush(&h) == 0) {
+                        durable = i + 1;
+                    }
+                }
+            }
+        } else {
+            cut = true;
+        }
+        lfs_emubd_setpowercycles(&s_cfg, 0);
+        if (!cut) {
+            flash_destroy();
+            break;
+        }
+        cuts++;
+        uint32_t loaded = reload(&h);
+        // Ultimele comenzi pana la e, cu e = durable sau attempted
+        uint32_t e     = s_got.count ? (uint32_t) atoi(strrchr(s_got.lines[s_got.count - 1], '#') + 1) + 1 : 0;
+        uint32_t tail  = e < MAX_LEN ? e : MAX_LEN;
+        bool     match = loaded != UINT32_MAX && (e == durable || e == attempted) && got_range(e - tail, tail);
+        if (!match) {
+            if (bad++ < 3) {
+                printf("  cut at op %llu: loaded %u, last #%d, durable %u, attempted %u\n", (unsigned long long) k,
+                    (unsigned) s_got.count, (int) e - 1, (unsigned) durable, (unsigned) attempted);
+            }
+        }
+        lost_batches += e == durable && durable != attempted;
+        // Dupa boot se scrie din nou normal
+        cli_history_push(&h, "after-boot");
+        bool after = cli_history_flush(&h) == 0 && reload(&h) == (tail < MAX_LEN ? tail + 1 : MAX_LEN) &&
+                     strcmp(s_got.lines[s_got.count - 1], "after-boot") == 0;
+        if (!after && bad++ < 3) {
+            printf("  cut at op %llu: append after reboot failed\n", (unsigned long long) k);
+        }
+        flash_destroy();
+    }
+    cli_history_deinit(&h);
+
+    char what[96];
+    printf("  %u cuts over %llu prog/erase ops (stride %u), %u of them lost the batch being written\n",
+        (unsigned) cuts, (unsigned long long) total, (unsigned) stride, (unsigned) lost_batches);
+    snprintf(what, sizeof(what), "every cut: flushed commands kept, suffix intact, appends resume");
+    return expect(cuts > 0 && bad == 0, what);
+}
+
+//---------
+int main(int argc, char** argv) {
+    uint32_t commands = 1000;
+    uint32_t batch    = 10;
+    uint32_t stride   = 1;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--commands") && i + 1 < argc) {
+            commands = (uint32_t) atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--batch") && i + 1 < argc) {
+            batch = (uint32_t) atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--stride") && i + 1 < argc) {
+            stride = (uint32_t) atoi(argv[++i]);
+        } else {
+            fprintf(stderr, "usage: %s [--commands N] [--batch N] [--stride N]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (commands < MAX_LEN || commands > MAX_COMMANDS || batch == 0 || stride == 0) {
+        fprintf(stderr, "--commands must be %d..%d (a full history), --batch and --stride >= 1\n", MAX_LEN,
+            MAX_COMMANDS);
+        return 2;
+    }
+    make_commands(commands > 300 ? commands : 300);
+
+    bool ok = true;
+    printf("cost (littlefs on lfs_emubd, %d x %d B blocks):\n", BLOCK_COUNT, BLOCK_SIZE);
+    ok &= check_cost(commands, batch);
+    printf("\ncases:\n");
+    ok &= check_cases();
+    printf("\npower loss (300 commands, batch %u):\n", (unsigned) batch);
+    ok &= check_powerloss(300, batch, stride);
+
+    printf("\n%s\n", ok ? "all checks passed" : "FAILED");
+    return ok ? 0 : 1;
+}
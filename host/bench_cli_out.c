@@ -0,0 +1,558 @@
+/*
+ * bench_cli_out - iesirea structurata a comenzilor (mylibs/one-cli-v005/src/cli_out.c) si
+ *                 decodorul de pe PC (mylibs/one-cli-v005/tools/cli_out_dec.c)
+ *
+ *   1. JSON: linii exacte pentru inregistrari cunoscute (escape-uri, limitele intregilor,
+ *      float-uri, containere goale si imbricate), utilizare gresita, `--json`/`--bin` scoase
+ *      din linia de comanda
+ *   2. bin: decodat == JSON-ul aceleiasi secvente de apeluri, pe cazuri speciale (blocuri COBS
+ *      pline, chei peste 13 / peste CLI_OUT_KEYS) si pe --records inregistrari aleatoare
+ *   3. flux: frame-uri cu text intre ele, "\n" -> "\r\n" ca pe consola placii, bucati aleatoare,
+ *      un frame stricat; nicio alocare in emitter
+ *   4. cost: bytes per inregistrare (tabel text / JSON / bin) si ns per inregistrare
+ *
+ * Usage: bench_cli_out [--records N]
+ */
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "cli_out.h"
+#include "cli_out_dec.h"
+
+#define SINK_SIZE (4u * 1024u * 1024u)
+#define JSON_MAX  (16u * 1024u)
+
+/**********************
+ *   HELPERS
+ **********************/
+static uint32_t s_rng = 1;
+static size_t   s_mallocs;
+
+void* __real_malloc(size_t size);
+void* __wrap_malloc(size_t size) {
+    s_mallocs++;
+    return __real_malloc(size);
+}
+
+static uint32_t rnd(uint32_t n) {
+    s_rng ^= s_rng << 13;
+    s_rng ^= s_rng >> 17;
+    s_rng ^= s_rng << 5;
+    return s_rng % n;
+}
+//---------
+static bool expect(bool cond, const char* what) {
+    printf("  %-64s %s\n", what, cond ? "ok" : "FAIL");
+    return cond;
+}
+//---------
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000ull + (uint64_t) ts.tv_nsec;
+}
+//---------
+typedef struct {
+    uint8_t data[SINK_SIZE];
+    size_t  len;
+    size_t  writes;
+} sink_t;
+
+static void sink_write(void* ctx, const void* data, size_t len) {
+    sink_t* s = ctx;
+    if (s->len + len <= SINK_SIZE) {
+        memcpy(s->data + s->len, data, len);
+        s->len += len;
+    }
+    s->writes++;
+}
+//---------
+static void sink_discard(void* ctx, const void* data, size_t len) {
+    (void) data;
+    *(size_t*) ctx += len;
+}
+//---------
+typedef struct {
+    char   text[SINK_SIZE];
+    size_t len;
+} lines_t;
+
+static void lines_add(void* ctx, const char* json, size_t len) {
+    lines_t* l = ctx;
+    if (l->len + len < SINK_SIZE) {
+        memcpy(l->text + l->len, json, len);
+        l->len += len;
+        l->text[l->len] = '\0';
+    }
+}
+
+typedef void (*emit_fn_t)(cli_out_t* o, uint32_t seed);
+
+static sink_t  s_json, s_bin;
+static lines_t s_lines;
+
+/* Aceeasi secventa in ambele moduri; bin trecut prin decodor */
+static void emit_both(emit_fn_t emit, uint32_t seed) {
+    cli_out_t o;
+    memset(&s_json, 0, sizeof(s_json));
+    memset(&s_bin, 0, sizeof(s_bin));
+    cli_out_init(&o, CLI_OUT_JSON, sink_write, &s_json);
+    emit(&o, seed);
+    cli_out_flush(&o);
+    s_json.data[s_json.len] = '\0';
+    cli_out_init(&o, CLI_OUT_BIN, sink_write, &s_bin);
+    emit(&o, seed);
+    cli_out_flush(&o);
+}
+//---------
+static bool decoded_equals_json(bool crlf) {
+    static uint8_t frame[SINK_SIZE];
+    static char    json[JSON_MAX];
+    cli_out_dec_t  d;
+    memset(&s_lines, 0, sizeof(s_lines));
+    cli_out_dec_init(&d, frame, sizeof(frame), json, sizeof(json), crlf, lines_add, &s_lines);
+    cli_out_dec_feed(&d, s_bin.data, s_bin.len);
+    return d.skipped == 0 && strcmp(s_lines.text, (const char*) s_json.data) == 0;
+}
+
+/**********************
+ *   INREGISTRARI
+ **********************/
+static void emit_uptime(cli_out_t* o, uint32_t seed) {
+    (void) seed;
+    cli_out_record_begin(o, "uptime");
+    cli_out_uint(o, "us", 1234567);
+    cli_out_record_end(o);
+}
+//---------
+static void emit_values(cli_out_t* o, uint32_t seed) {
+    (void) seed;
+    cli_out_record_begin(o, "values");
+    cli_out_uint(o, "u0", 0);
+    cli_out_uint(o, "umax", UINT64_MAX);
+    cli_out_int(o, "imin", INT64_MIN);
+    cli_out_int(o, "neg", -1);
+    cli_out_float(o, "f", 0.1f);
+    cli_out_float(o, "big", 1e10f);
+    cli_out_float(o, "nan", NAN);
+    cli_out_bool(o, "t", true);
+    cli_out_bool(o, "f2", false);
+    cli_out_null(o, "n");
+    cli_out_str(o, "s", "a\"b\\c\n\t\x01 ț");
+    cli_out_str(o, "null_str", NULL);
+    cli_out_strn(o, "zero", "a\0b", 3);
+    cli_out_record_end(o);
+}
+//---------
+static void emit_nested(cli_out_t* o, uint32_t seed) {
+    (void) seed;
+    cli_out_record_begin(o, "nested");
+    cli_out_array_begin(o, "empty_a");
+    cli_out_array_end(o);
+    cli_out_object_begin(o, "empty_o");
+    cli_out_object_end(o);
+    cli_out_array_begin(o, "rows");
+    for (int i = 0; i < 2; i++) {
+        cli_out_object_begin(o, NULL);
+        cli_out_uint(o, "id", (uint64_t) i);
+        cli_out_array_begin(o, "xs");
+        cli_out_int(o, NULL, -i);
+        cli_out_str(o, NULL, "x");
+        cli_out_array_end(o);
+        cli_out_object_end(o);
+    }
+    cli_out_array_end(o);
+    cli_out_record_end(o);
+    cli_out_record_begin(o, "second");
+    cli_out_uint(o, "id", 7);
+    cli_out_record_end(o);
+}
+//---------
+/* Ca tasks_info_record() din tasks_cmd.c */
+static const char* const s_task_names[] = {"IDLE0", "IDLE1", "main", "console", "sysmon", "lv_main", "wifi", "tiT",
+    "esp_timer", "ipc0", "ipc1", "cli_hist", "sys_evt", "httpd", "tt_agg", "Tmr Svc", "ui_queue", "flush", "touch",
+    "lfs_gc"};
+#define TASKS (sizeof(s_task_names) / sizeof(s_task_names[0]))
+
+static void emit_tasks(cli_out_t* o, uint32_t seed) {
+    s_rng = seed | 1;
+    cli_out_record_begin(o, "tasks");
+    cli_out_array_begin(o, "tasks");
+    for (size_t i = 0; i < TASKS; i++) {
+        cli_out_object_begin(o, NULL);
+        cli_out_str(o, "name", s_task_names[i]);
+        cli_out_uint(o, "num", i + 1);
+        cli_out_float(o, "load", (float) rnd(10000) / 100.0f);
+        cli_out_uint(o, "stack", 400 + rnd(6000));
+        cli_out_str(o, "state", i < 2 ? "Ready" : "Blocked");
+        if (i % 3 == 0) {
+            cli_out_null(o, "core");
+        } else {
+            cli_out_int(o, "core", (int64_t) (i & 1));
+        }
+        cli_out_uint(o, "prio", rnd(25));
+        cli_out_object_end(o);
+    }
+    cli_out_array_end(o);
+    cli_out_record_end(o);
+}
+//---------
+static size_t tasks_text_bytes(uint32_t seed) {
+    // Formatul din tasks_info(): header + o linie per task
+    char   line[128];
+    size_t bytes = (size_t) snprintf(line, sizeof(line), "%.4s\t%.6s\t%.8s\t%.8s\t%.4s\t%-20s\n", "Load", "Stack",
+        "State", "CoreID", "PRIO", "Name");
+    s_rng = seed | 1;
+    for (size_t i = 0; i < TASKS; i++) {
+        char name[19];
+        snprintf(name, sizeof(name), "[%-16s]", s_task_names[i]);
+        float    load  = (float) rnd(10000) / 100.0f;
+        uint32_t stack = 400 + rnd(6000);
+        uint32_t prio  = rnd(25);
+        bytes += (size_t) snprintf(line, sizeof(line), "%.2f\t%u\t%-4s\t%-4s\t%-4u\t%-19s\n", load, stack,
+            i < 2 ? "Ready" : "Blocked", i % 3 == 0 ? "1/2" : (i & 1 ? "1" : "0"), prio, name);
+    }
+    return bytes + 2 * 64;  // "\n\r" + liniile ESP_LOGI de inceput / sfarsit
+}
+//---------
+static void emit_long(cli_out_t* o, uint32_t seed) {
+    (void) seed;
+    static char text[1000];
+    for (size_t i = 0; i < sizeof(text); i++) {
+        text[i] = (char) ('a' + i % 26);
+    }
+    cli_out_record_begin(o, "long");
+    cli_out_strn(o, "s254", text, 254 - 8);  // Blocuri COBS pline la mai multe aliniamente
+    cli_out_strn(o, "s1000", text, sizeof(text));
+    cli_out_uint(o, "after", 0);
+    cli_out_record_end(o);
+}
+//---------
+static void emit_many_keys(cli_out_t* o, uint32_t seed) {
+    (void) seed;
+    static char keys[48][8];
+    cli_out_record_begin(o, "keys");
+    for (int pass = 0; pass < 2; pass++) {  // A doua trecere foloseste indexurile
+        cli_out_object_begin(o, pass ? "again" : "first");
+        for (int i = 0; i < 48; i++) {
+            snprintf(keys[i], sizeof(keys[i]), "k%d", i);
+            cli_out_uint(o, keys[i], (uint64_t) i * 1000);
+        }
+        cli_out_object_end(o);
+    }
+    cli_out_record_end(o);
+}
+//---------
+/* Arbore aleator de inregistrari, acelasi pentru acelasi seed */
+static void emit_random_value(cli_out_t* o, const char* key, int depth) {
+    static const char* const keys[] = {"a", "b", "name", "value", "x", "count", "items", "id", "t", "e", "q", "z"};
+    static const char* const strs[] = {"", "x", "hello world", "quote\"d", "line\nbreak", "\x7f\x01\x02", "ț"};
+    switch (rnd(depth < CLI_OUT_DEPTH - 1 ? 10 : 8)) {
+        case 0: cli_out_uint(o, key, (uint64_t) rnd(1000000) << rnd(40)); break;
+        case 1: cli_out_int(o, key, -(int64_t) rnd(1000000) << rnd(40)); break;
+        case 2: cli_out_float(o, key, (float) ((int) rnd(2000000) - 1000000) / (float) (1 + rnd(1000))); break;
+        case 3: cli_out_str(o, key, strs[rnd(7)]); break;
+        case 4: cli_out_bool(o, key, rnd(2)); break;
+        case 5: cli_out_null(o, key); break;
+        case 6: cli_out_uint(o, key, rnd(3)); break;
+        case 7: cli_out_int(o, key, 0); break;
+        case 8: {
+            cli_out_array_begin(o, key);
+            for (uint32_t n = rnd(5); n; n--) {
+                emit_random_value(o, NULL, depth + 1);
+            }
+            cli_out_array_end(o);
+            break;
+        }
+        default: {
+            cli_out_object_begin(o, key);
+            for (uint32_t n = rnd(5); n; n--) {
+                emit_random_value(o, keys[rnd(12)], depth + 1);
+            }
+            cli_out_object_end(o);
+            break;
+        }
+    }
+}
+
+static uint32_t s_random_records = 2000;
+
+static void emit_random(cli_out_t* o, uint32_t seed) {
+    s_rng = seed | 1;
+    for (uint32_t r = 0; r < s_random_records; r++) {
+        cli_out_record_begin(o, r % 2 ? "rand" : "r");
+        for (uint32_t n = rnd(6); n; n--) {
+            emit_random_value(o, "k", 1);
+        }
+        cli_out_record_end(o);
+    }
+}
+
+/**********************
+ *   1. JSON
+ **********************/
+static bool check_json(void) {
+    bool ok = true;
+    emit_both(emit_uptime, 0);
+    ok &= expect(!strcmp((char*) s_json.data, "{\"type\":\"uptime\",\"us\":1234567}\n"), "uptime record");
+
+    emit_both(emit_values, 0);
+    ok &= expect(!strcmp((char*) s_json.data,
+                     "{\"type\":\"values\",\"u0\":0,\"umax\":18446744073709551615,\"imin\":-9223372036854775808,"
+                     "\"neg\":-1,\"f\":0.1,\"big\":1e+10,\"nan\":null,\"t\":true,\"f2\":false,\"n\":null,"
+                     "\"s\":\"a\\\"b\\\\c\\n\\t\\u0001 ț\",\"null_str\":null,\"zero\":\"a\\u0000b\"}\n"),
+        "scalars: integer limits, floats, escapes");
+
+    emit_both(emit_nested, 0);
+    ok &= expect(!strcmp((char*) s_json.data,
+                     "{\"type\":\"nested\",\"empty_a\":[],\"empty_o\":{},\"rows\":[{\"id\":0,\"xs\":[0,\"x\"]},"
+                     "{\"id\":1,\"xs\":[-1,\"x\"]}]}\n{\"type\":\"second\",\"id\":7}\n"),
+        "nested arrays / objects, two records");
+
+    // Utilizare gresita: semnalata, iesirea ramane JSON valid
+    cli_out_t o;
+    memset(&s_json, 0, sizeof(s_json));
+    cli_out_init(&o, CLI_OUT_JSON, sink_write, &s_json);
+    cli_out_uint(&o, "outside", 1);
+    bool outside = o.error && s_json.len == 0;
+    o.error      = false;
+    cli_out_record_begin(&o, "open");
+    cli_out_array_begin(&o, "a");
+    cli_out_object_begin(&o, NULL);
+    cli_out_object_end(&o);
+    cli_out_object_end(&o);  // Array-ul e deschis, nu un obiect
+    cli_out_record_end(&o);  // Inchide array-ul
+    s_json.data[s_json.len] = '\0';
+    ok &= expect(outside && o.error && !strcmp((char*) s_json.data, "{\"type\":\"open\",\"a\":[{}]}\n"),
+        "misuse flagged, containers closed at record end");
+
+    cli_out_init(&o, CLI_OUT_TEXT, sink_write, &s_json);
+    s_json.len = 0;
+    emit_values(&o, 0);
+    ok &= expect(s_json.len == 0 && !o.error, "text mode writes nothing");
+
+    struct {
+        const char*    in;
+        const char*    out;
+        cli_out_mode_t mode;
+    } flags[] = {
+        {"uptime", "uptime", CLI_OUT_TEXT},
+        {"uptime --json", "uptime", CLI_OUT_JSON},
+        {"--bin tasks info", "tasks info", CLI_OUT_BIN},
+        {"info  --json  ram", "info  ram", CLI_OUT_JSON},
+        {"echo \"--json\" --jsonx", "echo \"--json\" --jsonx", CLI_OUT_TEXT},
+        {"echo \"a --bin\" --bin", "echo \"a --bin\"", CLI_OUT_BIN},
+        {"tasks --json --bin", "tasks", CLI_OUT_BIN},
+    };
+    bool flags_ok = true;
+    for (size_t i = 0; i < sizeof(flags) / sizeof(flags[0]); i++) {
+        char line[64];
+        snprintf(line, sizeof(line), "%s", flags[i].in);
+        cli_out_mode_t mode = cli_out_take_flag(line);
+        if (mode != flags[i].mode || strcmp(line, flags[i].out) != 0) {
+            printf("    \"%s\" -> \"%s\" (%d)\n", flags[i].in, line, mode);
+            flags_ok = false;
+        }
+    }
+    ok &= expect(flags_ok, "--json / --bin taken off the command line");
+    return ok;
+}
+
+/**********************
+ *   2. BIN
+ **********************/
+static bool check_bin(uint32_t records) {
+    bool ok = true;
+    const struct {
+        emit_fn_t   emit;
+        const char* what;
+    } cases[] = {
+        {emit_uptime, "uptime"},
+        {emit_values, "scalars, '\\0' inside values"},
+        {emit_nested, "nested containers, two frames"},
+        {emit_tasks, "tasks record (keys sent once)"},
+        {emit_long, "strings across full COBS blocks"},
+        {emit_many_keys, "48 keys: indexed past 13, unindexed past CLI_OUT_KEYS"},
+    };
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        emit_both(cases[i].emit, 7);
+        char what[80];
+        snprintf(what, sizeof(what), "decode(bin) == json: %s", cases[i].what);
+        ok &= expect(decoded_equals_json(false), what);
+    }
+
+    s_random_records = records;
+    bool random_ok   = true;
+    for (uint32_t seed = 1; seed <= 4 && random_ok; seed++) {
+        emit_both(emit_random, seed * 7919);
+        random_ok = decoded_equals_json(false);
+    }
+    char what[80];
+    snprintf(what, sizeof(what), "decode(bin) == json: 4 x %u random records", (unsigned) records);
+    ok &= expect(random_ok, what);
+
+    // Niciun '\0' in interiorul frame-urilor: fiecare inregistrare = exact 2 delimitatori
+    emit_both(emit_random, 3);
+    size_t zeros = 0;
+    for (size_t i = 0; i < s_bin.len; i++) {
+        zeros += s_bin.data[i] == 0;
+    }
+    ok &= expect(zeros == 2 * (size_t) records, "only the frame delimiters are '\\0'");
+    return ok;
+}
+
+/**********************
+ *   3. FLUX
+ **********************/
+static bool check_stream(void) {
+    static uint8_t wire[2 * SINK_SIZE], frame[4096];
+    static char    json[JSON_MAX];
+    static char    expected[SINK_SIZE];
+    bool           ok = true;
+
+    // Inregistrari cu log-uri intre ele, apoi "\n" -> "\r\n" ca usb_serial_jtag_vfs
+    s_random_records = 300;
+    emit_both(emit_random, 11);
+    snprintf(expected, sizeof(expected), "%s", (char*) s_json.data);
+    const char* noise[] = {"I (1234) CLI: 'uptime' command registered.\n", "esp32s3> ", "\x1b[0;32mlog\x1b[0m\r\n"};
+    size_t      len = 0, frames = 0, inserted = 0;
+    for (size_t i = 0; i < s_bin.len; i++) {
+        uint8_t b = s_bin.data[i];
+        if (b == '\n') {
+            wire[len++] = '\r';
+        }
+        wire[len++] = b;
+        if (b == 0 && ++frames % 6 == 0) {  // Dupa fiecare a treia inregistrare
+            const char* n = noise[rnd(3)];
+            inserted++;
+            for (; *n; n++) {
+                if (*n == '\n') {
+                    wire[len++] = '\r';
+                }
+                wire[len++] = (uint8_t) *n;
+            }
+        }
+    }
+
+    wire[len++] = 0;  // Textul de dupa ultimul frame se termina la urmatorul frame
+
+    cli_out_dec_t d;
+    memset(&s_lines, 0, sizeof(s_lines));
+    cli_out_dec_init(&d, frame, sizeof(frame), json, sizeof(json), true, lines_add, &s_lines);
+    for (size_t pos = 0; pos < len;) {
+        size_t n = 1 + rnd(64);
+        n        = n < len - pos ? n : len - pos;
+        cli_out_dec_feed(&d, wire + pos, n);
+        pos += n;
+    }
+    ok &= expect(!strcmp(s_lines.text, expected) && d.records == 300 && d.skipped == inserted,
+        "CRLF, text between frames, random chunks: every record");
+
+    // Un byte stricat: doar frame-ul lui se pierde
+    emit_both(emit_random, 12);
+    size_t victim = s_bin.len / 2;
+    while (s_bin.data[victim] == 0 || s_bin.data[victim] == 0x10 || s_bin.data[victim - 1] == 0) {
+        victim++;
+    }
+    s_bin.data[victim] ^= 0x10;
+    memset(&s_lines, 0, sizeof(s_lines));
+    cli_out_dec_init(&d, frame, sizeof(frame), json, sizeof(json), false, lines_add, &s_lines);
+    cli_out_dec_feed(&d, s_bin.data, s_bin.len);
+    ok &= expect(d.records == 299 && d.skipped == 1, "corrupted byte: only its frame is dropped");
+
+    // Frame mai mare decat bufferul decodorului: sarit, urmatorul e bun
+    cli_out_dec_init(&d, frame, 64, json, sizeof(json), false, lines_add, &s_lines);
+    emit_both(emit_tasks, 1);
+    cli_out_dec_feed(&d, s_bin.data, s_bin.len);
+    emit_both(emit_uptime, 1);
+    cli_out_dec_feed(&d, s_bin.data, s_bin.len);
+    ok &= expect(d.skipped == 1 && d.records == 1, "frame larger than the decoder buffer is skipped");
+
+    // Emitter-ul nu aloca, iar o inregistrare ajunge la write() in cat mai putine bucati
+    s_mallocs = 0;
+    emit_both(emit_tasks, 5);
+    ok &= expect(s_mallocs == 0, "no allocations while emitting");
+    printf("    tasks record: %zu write() calls for %zu bytes (bin, CLI_OUT_BUF = %d)\n", s_bin.writes, s_bin.len,
+        CLI_OUT_BUF);
+    return ok;
+}
+
+/**********************
+ *   4. COST
+ **********************/
+static void bench_cost(void) {
+    const int iterations = 20000;
+    emit_both(emit_tasks, 9);
+    size_t text = tasks_text_bytes(9);
+    printf("\n  tasks record (%zu tasks)       bytes   ns/record\n", TASKS);
+    printf("  %-28s %6zu %11s\n", "text table", text, "-");
+
+    const struct {
+        cli_out_mode_t mode;
+        const char*    name;
+        size_t         bytes;
+    } modes[] = {
+        {CLI_OUT_JSON, "--json", s_json.len},
+        {CLI_OUT_BIN, "--bin", s_bin.len},
+    };
+    for (size_t m = 0; m < 2; m++) {
+        size_t    total = 0;
+        cli_out_t o;
+        cli_out_init(&o, modes[m].mode, sink_discard, &total);
+        uint64_t t0 = now_ns();
+        for (int i = 0; i < iterations; i++) {
+            emit_tasks(&o, 9);
+        }
+        uint64_t dt = now_ns() - t0;
+        printf("  %-28s %6zu %11.0f\n", modes[m].name, modes[m].bytes, (double) dt / iterations);
+    }
+
+    static uint8_t frame[4096];
+    static char    json[JSON_MAX];
+    cli_out_dec_t  d;
+    cli_out_dec_init(&d, frame, sizeof(frame), json, sizeof(json), true, lines_add, &s_lines);
+    uint64_t t0 = now_ns();
+    for (int i = 0; i < iterations; i++) {
+        s_lines.len = 0;
+        cli_out_dec_feed(&d, s_bin.data, s_bin.len);
+    }
+    uint64_t dt = now_ns() - t0;
+    printf("  %-28s %6s %11.0f\n", "decode --bin -> JSON (PC)", "-", (double) dt / iterations);
+}
+
+/**********************
+ *   MAIN
+ **********************/
+int main(int argc, char** argv) {
+    uint32_t records = 2000;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--records") && i + 1 < argc) {
+            records = (uint32_t) atoi(argv[++i]);
+        } else {
+            fprintf(stderr, "usage: %s [--records N]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (records == 0 || records > 10000) {
+        fprintf(stderr, "--records must be 1..10000\n");
+        return 2;
+    }
+
+    bool ok = true;
+    printf("json:\n");
+    ok &= check_json();
+    printf("\nbin:\n");
+    ok &= check_bin(records);
+    printf("\nstream:\n");
+    ok &= check_stream();
+    bench_cost();
+
+    printf("\n%s\n", ok ? "all checks passed" : "FAILED");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,402 @@
+/*
+ * bench_cli_script - scripturile lui `run` (mylibs/one-cli-v005/modules/run_cmd/cli_script.c)
+ *
+ *   1. parser: separatori (linie noua, `;`, `|`), ghilimele si `\`, comentarii, CRLF, erorile de
+ *      sintaxa cu linia lor, limitele (etape, lungimea unei comenzi)
+ *   2. executie pe un registru fals de comenzi (echo, tasks, cat, fail, slow, big) cu un ceas
+ *      fals: nimic nu ruleaza daca scriptul are o eroare de sintaxa, oprirea la prima comanda
+ *      esuata / --keep-going, pipe-uri prin filtre (grep, head, tail, wc) si prin comenzi
+ *      (stdin-ul lui cat), trunchierea, timpii din raport
+ *   3. cost: ns per comanda (parsare + executie, fara comenzile propriu-zise)
+ *
+ * Usage: bench_cli_script [--iterations N]
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "cli_script.h"
+
+#define CONSOLE_SIZE (64u * 1024u)
+
+/**********************
+ *   HELPERS
+ **********************/
+static bool expect(bool cond, const char* what) {
+    printf("  %-64s %s\n", what, cond ? "ok" : "FAIL");
+    return cond;
+}
+//---------
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000ull + (uint64_t) ts.tv_nsec;
+}
+
+/**********************
+ *   FAKE REGISTRY
+ **********************/
+typedef struct {
+    char     console[CONSOLE_SIZE];  // Tot ce ajunge la consola
+    size_t   console_len;
+    char     calls[1024];  // "echo|fail|..." in ordinea apelurilor
+    char     last_input[CLI_SCRIPT_PIPE_MAX + 1];
+    int64_t  clock_us;
+    uint32_t execs;
+    bool     discard;  // Pentru masuratori: consola nu se pastreaza
+} fake_t;
+
+static void fake_print(void* ctx, const char* text, size_t len) {
+    fake_t* f = ctx;
+    if (f->discard) {
+        return;
+    }
+    if (f->console_len + len < CONSOLE_SIZE) {
+        memcpy(f->console + f->console_len, text, len);
+        f->console_len += len;
+        f->console[f->console_len] = '\0';
+    }
+}
+//---------
+static int64_t fake_now_us(void* ctx) {
+    return ((fake_t*) ctx)->clock_us;
+}
+//---------
+static void fake_out(fake_t* f, cli_script_out_t* out, const char* text) {
+    if (out) {
+        cli_script_out_write(out, text, strlen(text));
+    } else {
+        fake_print(f, text, strlen(text));
+    }
+}
+//---------
+/* Ca esp_console_split_argv, destul pentru comenzile de aici */
+static int fake_split(char* buf, char** argv, int max) {
+    int   argc = 0;
+    char* in   = buf;
+    while (*in && argc < max) {
+        while (*in == ' ') {
+            in++;
+        }
+        if (!*in) {
+            break;
+        }
+        char* out    = in;
+        argv[argc++] = out;
+        bool quoted  = false;
+        for (; *in; in++) {
+            if (*in == '\\' && in[1]) {
+                *out++ = *++in;
+            } else if (*in == '"') {
+                quoted = !quoted;
+            } else if (!quoted && *in == ' ') {
+                in++;
+                break;
+            } else {
+                *out++ = *in;
+            }
+        }
+        *out = '\0';
+    }
+    return argc;
+}
+//---------
+static int fake_exec(void* ctx, const char* cmdline, const char* input, size_t input_len, cli_script_out_t* out,
+    int* ret) {
+    fake_t* f = ctx;
+    char    buf[CLI_SCRIPT_LINE_MAX + 1];
+    char*   argv[8];
+    snprintf(buf, sizeof(buf), "%s", cmdline);
+    int argc = fake_split(buf, argv, 8);
+    if (argc == 0) {
+        return CLI_SCRIPT_EXEC_ERROR;
+    }
+    f->execs++;
+    if (f->calls[0]) {
+        strncat(f->calls, "|", sizeof(f->calls) - strlen(f->calls) - 1);
+    }
+    strncat(f->calls, argv[0], sizeof(f->calls) - strlen(f->calls) - 1);
+    *ret = 0;
+
+    if (!strcmp(argv[0], "echo")) {
+        for (int i = 1; i < argc; i++) {
+            fake_out(f, out, argv[i]);
+            fake_out(f, out, i + 1 < argc ? " " : "");
+        }
+        fake_out(f, out, "\n");
+    } else if (!strcmp(argv[0], "tasks")) {
+        fake_out(f, out,
+            "Name       State Prio  Stack\n"
+            "IDLE0      R     0     1012\n"
+            "IDLE1      R     0     1008\n"
+            "console    X     2     2104\n"
+            "sysmon     B     3     1320\n"
+            "lv_main    B     5     6216\n");
+    } else if (!strcmp(argv[0], "cat")) {
+        size_t n = input_len < CLI_SCRIPT_PIPE_MAX ? input_len : CLI_SCRIPT_PIPE_MAX;
+        memcpy(f->last_input, input ? input : "", n);
+        f->last_input[n] = '\0';
+        fake_out(f, out, f->last_input);
+    } else if (!strcmp(argv[0], "fail")) {
+        *ret = 2;
+    } else if (!strcmp(argv[0], "slow")) {
+        f->clock_us += argc > 1 ? atoi(argv[1]) * 1000 : 1000;
+    } else if (!strcmp(argv[0], "big")) {
+        for (int i = 0; i < 100; i++) {
+            fake_out(f, out, "0123456789012345678901234567890123456789012345678\n");  // 50 B
+        }
+    } else if (!strcmp(argv[0], "noop")) {
+    } else {
+        f->execs--;
+        return CLI_SCRIPT_EXEC_NOT_FOUND;
+    }
+    return CLI_SCRIPT_EXEC_OK;
+}
+
+static fake_t       s_fake;
+static cli_script_t s_script;
+
+static const cli_script_env_t s_env = {
+    .exec   = fake_exec,
+    .now_us = fake_now_us,
+    .print  = fake_print,
+    .ctx    = &s_fake,
+};
+
+static int run(const char* text, uint32_t flags) {
+    memset(&s_fake, 0, sizeof(s_fake));
+    return cli_script_run(&s_script, &s_env, flags, text, strlen(text));
+}
+//---------
+/* Consola fara liniile de raport (cele care incep cu "# ") */
+static const char* console_output(void) {
+    static char out[CONSOLE_SIZE];
+    size_t      len = 0;
+    const char* p   = s_fake.console;
+    while (*p) {
+        const char* nl = strchr(p, '\n');
+        size_t      n  = nl ? (size_t) (nl - p) + 1 : strlen(p);
+        if (strncmp(p, "# ", 2) != 0) {
+            memcpy(out + len, p, n);
+            len += n;
+        }
+        p += n;
+    }
+    out[len] = '\0';
+    return out;
+}
+
+/**********************
+ *   1. PARSER
+ **********************/
+typedef struct {
+    const char*         text;
+    cli_script_status_t status;      // Primul status != OK
+    uint32_t            pipelines;   // Pipeline-uri OK inainte de el
+    uint32_t            line;        // Linia ultimului pipeline / a erorii
+    const char*         stages;      // Etapele tuturor pipeline-urilor: "a,b;c"
+    const char*         what;
+} parse_case_t;
+
+static cli_script_status_t parse_all(const char* text, uint32_t* pipelines, uint32_t* line, char* stages, size_t size) {
+    cli_script_parser_t   p;
+    cli_script_pipeline_t pl;
+    cli_script_status_t   status;
+    *pipelines = 0;
+    stages[0]  = '\0';
+    cli_script_parser_init(&p, text, strlen(text));
+    while ((status = cli_script_next(&p, &pl)) == CLI_SCRIPT_OK) {
+        for (uint32_t i = 0; i < pl.count; i++) {
+            size_t len = strlen(stages);
+            snprintf(stages + len, size - len, "%s%.*s", len == 0 ? "" : (i == 0 ? ";" : ","), (int) pl.stage[i].len,
+                pl.stage[i].start);
+        }
+        (*pipelines)++;
+        *line = pl.line;
+    }
+    if (status != CLI_SCRIPT_END) {
+        *line = pl.line;
+    }
+    return status;
+}
+//---------
+static bool check_parser(void) {
+    static char long_ok[CLI_SCRIPT_LINE_MAX + 1], long_bad[CLI_SCRIPT_LINE_MAX + 2];
+    memset(long_ok, 'x', CLI_SCRIPT_LINE_MAX);
+    memset(long_bad, 'x', CLI_SCRIPT_LINE_MAX + 1);
+
+    const parse_case_t cases[] = {
+        {"", CLI_SCRIPT_END, 0, 0, "", "empty script"},
+        {"\n\n  \n# only a comment\n;;\n", CLI_SCRIPT_END, 0, 0, "", "blank lines, comments, stray ';'"},
+        {"a; b\n c | d  |e", CLI_SCRIPT_END, 3, 2, "a;b;c,d,e", "';', newline and '|'"},
+        {"a\r\nb\r\n", CLI_SCRIPT_END, 2, 2, "a;b", "CRLF line ends"},
+        {"echo \"a;b|c\" | wc", CLI_SCRIPT_END, 1, 1, "echo \"a;b|c\",wc", "separators inside quotes"},
+        {"echo a\\;b\\|c", CLI_SCRIPT_END, 1, 1, "echo a\\;b\\|c", "escaped separators"},
+        {"echo a \\\n b\nc", CLI_SCRIPT_END, 2, 3, "echo a \\\n b;c", "'\\' + newline continues the command"},
+        {"echo a # b\n  # c\nd", CLI_SCRIPT_END, 2, 3, "echo a # b;d", "'#' only starts a comment at a command"},
+        {"a\nb\necho \"x\nc", CLI_SCRIPT_ERR_QUOTE, 2, 3, "a;b", "unterminated quote, with its line"},
+        {"a | | b", CLI_SCRIPT_ERR_EMPTY, 0, 1, "", "empty stage in the middle"},
+        {"a\nb |\nc", CLI_SCRIPT_ERR_EMPTY, 1, 2, "a", "pipeline ending in '|'"},
+        {"| a", CLI_SCRIPT_ERR_EMPTY, 0, 1, "", "pipeline starting with '|'"},
+        {"a|b|c|d|e|f|g|h", CLI_SCRIPT_END, 1, 1, "a,b,c,d,e,f,g,h", "CLI_SCRIPT_MAX_STAGES stages"},
+        {"a|b|c|d|e|f|g|h|i", CLI_SCRIPT_ERR_STAGES, 0, 1, "", "one stage too many"},
+        {long_ok, CLI_SCRIPT_END, 1, 1, long_ok, "command of CLI_SCRIPT_LINE_MAX chars"},
+        {long_bad, CLI_SCRIPT_ERR_TOO_LONG, 0, 1, "", "command one char too long"},
+    };
+
+    bool ok = true;
+    char stages[4096];
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        const parse_case_t* c         = &cases[i];
+        uint32_t            pipelines = 0, line = 0;
+        cli_script_status_t status    = parse_all(c->text, &pipelines, &line, stages, sizeof(stages));
+        bool                good      = status == c->status && pipelines == c->pipelines &&
+                        (c->pipelines == 0 && status == CLI_SCRIPT_END ? true : line == c->line) &&
+                        strcmp(stages, c->stages) == 0;
+        if (!good) {
+            printf("    got %s, %u pipelines, line %u, \"%s\"\n", cli_script_status_str(status), (unsigned) pipelines,
+                (unsigned) line, stages);
+        }
+        ok &= expect(good, c->what);
+    }
+    return ok;
+}
+
+/**********************
+ *   2. EXECUTIE
+ **********************/
+static bool check_exec(void) {
+    bool ok = true;
+    int  ret;
+
+    ret = run("echo one\necho two\necho \"x\n", 0);
+    ok &= expect(ret == 1 && s_fake.execs == 0 && s_script.result.syntax == CLI_SCRIPT_ERR_QUOTE &&
+                     s_script.result.error_line == 3 && strstr(s_fake.console, "line 3: unterminated quote"),
+        "syntax error: nothing runs, line reported");
+
+    ret = run("echo hi; fail; echo after", 0);
+    ok &= expect(ret == 1 && !strcmp(s_fake.calls, "echo|fail") && s_script.result.failed == 1 &&
+                     s_script.result.error_line == 1 && !strstr(s_fake.console, "after"),
+        "stops at the first failed command");
+
+    ret = run("echo hi\nfail\necho after", CLI_SCRIPT_KEEP_GOING);
+    ok &= expect(ret == 1 && !strcmp(s_fake.calls, "echo|fail|echo") && s_script.result.failed == 1 &&
+                     s_script.result.commands == 3 && s_script.result.error_line == 2 && strstr(s_fake.console, "after"),
+        "--keep-going runs the rest, reports the first failure");
+
+    ret = run("nosuch arg; echo after", 0);
+    ok &= expect(ret == 1 && s_fake.execs == 0 && strstr(s_fake.console, "Unrecognized command: nosuch arg") &&
+                     strstr(s_fake.console, "unknown"),
+        "unknown command fails the script");
+
+    ret = run("fail | echo never", 0);
+    ok &= expect(ret == 1 && !strcmp(s_fake.calls, "fail"), "failed stage stops its pipeline");
+
+    ret = run("echo \"a;b|c\"; echo a\\;b", 0);
+    ok &= expect(ret == 0 && !strcmp(console_output(), "a;b|c\na;b\n"), "quoted / escaped separators reach the command");
+
+    ret = run("tasks | grep IDLE | wc -l", 0);
+    ok &= expect(ret == 0 && !strcmp(console_output(), "2\n"), "tasks | grep IDLE | wc -l");
+
+    ret = run("tasks | grep -v IDLE | head -n 2", 0);
+    ok &= expect(ret == 0 && !strcmp(console_output(), "Name       State Prio  Stack\nconsole    X     2     2104\n"),
+        "grep -v | head -n 2");
+
+    ret = run("tasks | tail 1; tasks | grep -c B", 0);
+    ok &= expect(ret == 0 && !strcmp(console_output(), "lv_main    B     5     6216\n2\n"), "tail 1, grep -c");
+
+    ret = run("tasks | grep nothing", 0);
+    ok &= expect(ret == 1 && s_script.result.failed == 1, "grep without a match fails, like grep");
+
+    ret = run("echo a b c | wc; wc; head 0; echo x | tail 0", 0);
+    ok &= expect(ret == 0 && !strcmp(console_output(), "1 3 6\n0 0 0\n"), "wc, filters on empty input, 0 lines");
+
+    ret = run("echo one two | cat | cat", 0);
+    ok &= expect(ret == 0 && !strcmp(s_fake.last_input, "one two\n") && !strcmp(console_output(), "one two\n"),
+        "command output becomes the next command's stdin");
+
+    ret = run("wc -x", 0);
+    ok &= expect(ret == 1 && strstr(s_fake.console, "usage: wc"), "bad filter arguments");
+
+    ret = run("big | wc", 0);
+    ok &= expect(ret == 0 && !strcmp(console_output(), "81 82 4096\n") && strstr(s_fake.console, "trunc"),
+        "stage output truncated at CLI_SCRIPT_PIPE_MAX, reported");
+
+    ret = run("slow 12\nslow 3 | cat\n", 0);
+    ok &= expect(ret == 0 && strstr(s_fake.console, "#   1     12.000 ms  ok      slow 12\n") &&
+                     strstr(s_fake.console, "#   2      3.000 ms  ok      slow 3\n") &&
+                     strstr(s_fake.console, "#   2      0.000 ms  ok      cat\n") &&
+                     strstr(s_fake.console, "# 3 commands, 0 failed, 15.000 ms\n"),
+        "per-command time, line and total in the report");
+
+    ret = run("slow 1; echo x", CLI_SCRIPT_QUIET);
+    ok &= expect(ret == 0 && !strcmp(console_output(), "x\n") && !strstr(s_fake.console, "slow") &&
+                     strstr(s_fake.console, "# 2 commands, 0 failed, 1.000 ms"),
+        "quiet: only the summary");
+    return ok;
+}
+
+/**********************
+ *   3. COST
+ **********************/
+static void bench_cost(int iterations) {
+    enum { LINES = 200 };
+    static char text[LINES * 32];
+    size_t      len = 0;
+    for (int i = 0; i < LINES; i++) {
+        len += (size_t) snprintf(text + len, sizeof(text) - len, "noop %d | noop | wc -l\n", i);
+    }
+
+    const struct {
+        uint32_t    flags;
+        const char* name;
+    } modes[] = {
+        {0, "with report"},
+        {CLI_SCRIPT_QUIET, "quiet"},
+    };
+    printf("\n  %-14s %10s %12s\n", "mode", "commands", "ns/command");
+    for (size_t m = 0; m < sizeof(modes) / sizeof(modes[0]); m++) {
+        memset(&s_fake, 0, sizeof(s_fake));
+        s_fake.discard = true;
+        uint64_t t0    = now_ns();
+        for (int i = 0; i < iterations; i++) {
+            cli_script_run(&s_script, &s_env, modes[m].flags, text, len);
+        }
+        uint64_t dt       = now_ns() - t0;
+        uint64_t commands = (uint64_t) iterations * LINES * 3;
+        printf("  %-14s %10llu %12.1f\n", modes[m].name, (unsigned long long) commands, (double) dt / (double) commands);
+    }
+}
+
+/**********************
+ *   MAIN
+ **********************/
+int main(int argc, char** argv) {
+    int iterations = 200;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--iterations") && i + 1 < argc) {
+            iterations = atoi(argv[++i]);
+        } else {
+            fprintf(stderr, "usage: %s [--iterations N]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (iterations <= 0) {
+        fprintf(stderr, "--iterations must be > 0\n");
+        return 2;
+    }
+
+    bool ok = true;
+    printf("parser:\n");
+    ok &= check_parser();
+    printf("\nexecution:\n");
+    ok &= check_exec();
+    bench_cost(iterations);
+
+    printf("\n%s\n", ok ? "all checks passed" : "FAILED");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,380 @@
+/*
+ * bench_display - frame time benchmark for the main.cpp display pipeline on Linux.
+ *
+ * Construieste acelasi UI (create_tabs_ui din main/ui.h) pe un ST7789 simulat
+ * (mock_panel) si ruleaza acelasi scenariu pentru fiecare combinatie
+ * BUFFER_MODE x RENDER_MODE x DOUBLE_BUFFER_MODE x COLOR_MODE.
+ *
+ * COLOR_MODE_RGB565 ruleaza panoul cu swap_color_bytes (inversarea per pixel din mock_panel),
+ * COLOR_MODE_RGB565_SWAPPED deseneaza direct in ordinea panoului si il ruleaza fara swap.
+ * GRAM-ul final al fiecarei combinatii trebuie sa fie identic cu al primei (PARTIAL, RGB565),
+ * coloana "gram". In DIRECT flush_cb primeste tot bufferul ecranului, cu stride-ul ecranului.
+ *
+ * Usage: bench_display [--frames N] [--color rgb565|swapped|both] [--csv]
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "lvgl.h"
+#include "lvgl_private.h"
+
+#include "display_modes.h"
+#include "mock_panel.h"
+#include "ui.h"
+
+#define LCD_WIDTH  (320)
+#define LCD_HEIGHT (240)
+#define LV_DELAY   (5)  // Acelasi pas ca lv_main_task din main.cpp
+
+/**********************
+ *   BENCH VARIABLES
+ **********************/
+typedef struct {
+    uint32_t buffer_mode;
+    uint32_t render_mode;
+    bool     double_buffer;
+    uint32_t color_mode;
+} bench_combo_t;
+
+typedef struct {
+    uint32_t frames;          // Frames that actually flushed something
+    uint64_t p50_us;          // Median render+flush time
+    uint64_t p99_us;          // 99th percentile render+flush time
+    double   bytes_per_frame; // Average bytes pushed to the panel per frame
+    double   flush_per_frame; // Average flush_cb calls per frame
+    double   areas_per_frame; // Average invalidated (joined) areas per frame
+    uint64_t gram_hash;       // FNV-1a of the panel GRAM after the last frame
+} bench_result_t;
+
+static uint32_t      s_sim_tick_ms = 0;
+static mock_panel_t* s_panel       = NULL;
+static uint64_t      s_refr_start_us;
+static uint64_t*     s_frame_us    = NULL;
+static uint32_t      s_frame_cnt   = 0;
+static uint32_t      s_frame_cap   = 0;
+static uint64_t      s_area_cnt    = 0;
+static uint64_t      s_flush_start = 0;
+
+/**********************
+ *   BENCH FUNCTIONS
+ **********************/
+static uint64_t now_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000u + (uint64_t) ts.tv_nsec / 1000u;
+}
+//---------
+static uint32_t sim_tick_cb(void) {
+    return s_sim_tick_ms;
+}
+//---------
+static const char* buffer_mode_name(uint32_t mode) {
+    switch (mode) {
+        case BUFFER_20LINES:
+            return "20LINES";
+        case BUFFER_40LINES:
+            return "40LINES";
+        case BUFFER_60LINES:
+            return "60LINES";
+        case BUFFER_DEVIDED4:
+            return "DEVIDED4";
+        case BUFFER_FULL:
+            return "FULL";
+        default:
+            return "?";
+    }
+}
+//---------
+static const char* render_mode_name(uint32_t mode) {
+    switch (mode) {
+        case RENDER_MODE_PARTIAL:
+            return "PARTIAL";
+        case RENDER_MODE_FULL:
+            return "FULL";
+        case RENDER_MODE_DIRECT:
+            return "DIRECT";
+        default:
+            return "?";
+    }
+}
+//---------
+static const char* color_mode_name(uint32_t mode) {
+    return mode == COLOR_MODE_RGB565_SWAPPED ? "SWAPPED" : "RGB565";
+}
+//---------
+static uint64_t gram_hash(const mock_panel_t* panel) {
+    const uint8_t* gram = mock_panel_get_gram(panel);
+    size_t         size = mock_panel_get_gram_size(panel);
+    uint64_t       h    = 1469598103934665603ULL;
+    for (size_t i = 0; i < size; i++) {
+        h = (h ^ gram[i]) * 1099511628211ULL;
+    }
+    return h;
+}
+//---------
+static int cmp_u64(const void* a, const void* b) {
+    uint64_t x = *(const uint64_t*) a;
+    uint64_t y = *(const uint64_t*) b;
+    return (x > y) - (x < y);
+}
+//---------
+static uint64_t percentile(uint64_t* sorted, uint32_t n, uint32_t pct) {
+    if (n == 0) {
+        return 0;
+    }
+    uint32_t idx = (uint32_t) (((uint64_t) (n - 1) * pct + 50) / 100);
+    return sorted[idx];
+}
+//---------
+/* Same job as lv_disp_flush in main.cpp, against the mock panel */
+static void bench_disp_flush(lv_display_t* disp, const lv_area_t* area, uint8_t* px_map) {
+    if (disp->render_mode == LV_DISPLAY_RENDER_MODE_DIRECT) {
+        // px_map e tot bufferul ecranului: randurile intregi ale zonei, ca in main.cpp
+        size_t stride = lv_display_get_buf_active(disp)->header.stride;
+        mock_panel_draw_bitmap(s_panel, 0, area->y1, LCD_WIDTH, area->y2 + 1, (const void*) (px_map + (size_t) area->y1 * stride));
+        return;
+    }
+    mock_panel_draw_bitmap(s_panel, area->x1, area->y1, area->x2 + 1, area->y2 + 1, (const void*) px_map);
+}
+//---------
+/* Same job as panel_io_trans_done_callback in main.cpp */
+static bool bench_trans_done(mock_panel_t* panel, void* user_ctx) {
+    (void) panel;
+    lv_display_t* d = (lv_display_t*) user_ctx;
+    if (d) {
+        lv_display_flush_ready(d);
+    }
+    return false;
+}
+//---------
+static void bench_display_event_cb(lv_event_t* e) {
+    lv_display_t* d = (lv_display_t*) lv_event_get_target(e);
+    switch (lv_event_get_code(e)) {
+        case LV_EVENT_REFR_START:
+            s_refr_start_us = now_us();
+            s_flush_start   = mock_panel_get_stats(s_panel)->flush_count;
+            break;
+        case LV_EVENT_RENDER_START:
+            for (uint32_t i = 0; i < d->inv_p; i++) {
+                if (!d->inv_area_joined[i]) {
+                    s_area_cnt++;
+                }
+            }
+            break;
+        case LV_EVENT_REFR_READY:
+            // Frame-urile fara nimic de desenat nu conteaza
+            if (mock_panel_get_stats(s_panel)->flush_count != s_flush_start && s_frame_cnt < s_frame_cap) {
+                s_frame_us[s_frame_cnt++] = now_us() - s_refr_start_us;
+            }
+            break;
+        default:
+            break;
+    }
+}
+//---------
+/* Scenario: slider sweep every frame, tab change every 60 frames (animated) */
+static void bench_scenario_step(lv_obj_t* tabview, uint32_t frame) {
+    if (frame % 60 == 0) {
+        uint32_t tab_cnt = lv_tabview_get_tab_count(tabview);
+        lv_tabview_set_active(tabview, (frame / 60) % tab_cnt, LV_ANIM_ON);
+    }
+    int32_t value = (int32_t) (frame % 200);
+    if (value > 100) {
+        value = 200 - value;
+    }
+    lv_slider_set_value(slider_tab4, value, LV_ANIM_OFF);
+    lv_obj_send_event(slider_tab4, LV_EVENT_VALUE_CHANGED, NULL);
+}
+//---------
+static void bench_run_combo(const bench_combo_t* combo, uint32_t frames, bench_result_t* out) {
+    memset(out, 0, sizeof(*out));
+
+    s_sim_tick_ms = 0;  // Acelasi sir de tick-uri pentru fiecare combinatie (GRAM comparabil)
+    lv_init();
+    lv_tick_set_cb(sim_tick_cb);
+    lv_display_t* disp = lv_display_create(LCD_WIDTH, LCD_HEIGHT);
+    lv_display_set_color_format(disp, display_color_mode_format(combo->color_mode));
+
+    mock_panel_config_t panel_config = {
+        .h_res            = LCD_WIDTH,
+        .v_res            = LCD_HEIGHT,
+        .bits_per_pixel   = 16,
+        .swap_color_bytes = display_color_mode_swap_bytes(combo->color_mode),
+    };
+    s_panel = mock_panel_create(&panel_config);
+    mock_panel_register_trans_done(s_panel, bench_trans_done, disp);
+
+    uint32_t lines   = display_buffer_mode_lines(combo->buffer_mode, LCD_HEIGHT);
+    uint32_t bufSize = LCD_WIDTH * lines * lv_color_format_get_size(lv_display_get_color_format(disp));
+    void*    buf1    = calloc(1, bufSize);
+    void*    buf2    = combo->double_buffer ? calloc(1, bufSize) : NULL;
+
+    lv_display_set_buffers(disp, buf1, buf2, bufSize, (lv_display_render_mode_t) combo->render_mode);
+    lv_display_set_antialiasing(disp, true);
+    lv_display_set_flush_cb(disp, bench_disp_flush);
+    lv_display_add_event_cb(disp, bench_display_event_cb, LV_EVENT_ALL, NULL);
+
+    create_tabs_ui();
+    lv_obj_t* tabview = lv_obj_get_child(lv_screen_active(), 0);
+    // Eticheta de drift si monitoarele LVGL afiseaza timp real / heap, GRAM-ul n-ar mai fi comparabil intre rulari
+    lv_obj_add_flag(label_drift, LV_OBJ_FLAG_HIDDEN);
+#if LV_USE_PERF_MONITOR
+    lv_sysmon_hide_performance(disp);
+#endif /* #if LV_USE_PERF_MONITOR */
+#if LV_USE_MEM_MONITOR
+    lv_sysmon_hide_memory(disp);
+#endif /* #if LV_USE_MEM_MONITOR */
+
+    // Primul frame (ecranul complet) nu intra in statistica
+    s_frame_cap = 0;
+    lv_refr_now(disp);
+    mock_panel_reset_stats(s_panel);
+
+    s_frame_us  = (uint64_t*) calloc(frames, sizeof(uint64_t));
+    s_frame_cap = frames;
+    s_frame_cnt = 0;
+    s_area_cnt  = 0;
+
+    for (uint32_t f = 0; f < frames; f++) {
+        bench_scenario_step(tabview, f);
+        s_sim_tick_ms += LV_DELAY;
+        lv_timer_handler();
+    }
+
+    const mock_panel_stats_t* stats = mock_panel_get_stats(s_panel);
+    qsort(s_frame_us, s_frame_cnt, sizeof(uint64_t), cmp_u64);
+    out->frames = s_frame_cnt;
+    out->p50_us = percentile(s_frame_us, s_frame_cnt, 50);
+    out->p99_us = percentile(s_frame_us, s_frame_cnt, 99);
+    if (s_frame_cnt) {
+        out->bytes_per_frame = (double) stats->flushed_bytes / s_frame_cnt;
+        out->flush_per_frame = (double) stats->flush_count / s_frame_cnt;
+        out->areas_per_frame = (double) s_area_cnt / s_frame_cnt;
+    }
+    out->gram_hash = gram_hash(s_panel);
+
+    lv_deinit();
+    mock_panel_delete(s_panel);
+    s_panel = NULL;
+    free(s_frame_us);
+    s_frame_us  = NULL;
+    s_frame_cap = 0;
+    free(buf1);
+    free(buf2);
+}
+
+/*
+███    ███  █████  ██ ███    ██
+████  ████ ██   ██ ██ ████   ██
+██ ████ ██ ███████ ██ ██ ██  ██
+██  ██  ██ ██   ██ ██ ██  ██ ██
+██      ██ ██   ██ ██ ██   ████
+*/
+int main(int argc, char** argv) {
+    uint32_t frames = 600;
+    bool     csv    = false;
+    uint32_t colors[2];
+    size_t   color_cnt = 0;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc) {
+            frames = (uint32_t) strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--color") == 0 && i + 1 < argc) {
+            const char* c = argv[++i];
+            color_cnt     = 0;
+            if (strcmp(c, "rgb565") == 0 || strcmp(c, "both") == 0) {
+                colors[color_cnt++] = COLOR_MODE_RGB565;
+            }
+            if (strcmp(c, "swapped") == 0 || strcmp(c, "both") == 0) {
+                colors[color_cnt++] = COLOR_MODE_RGB565_SWAPPED;
+            }
+            if (color_cnt == 0) {
+                fprintf(stderr, "unknown --color %s\n", c);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--csv") == 0) {
+            csv = true;
+        } else {
+            fprintf(stderr, "usage: %s [--frames N] [--color rgb565|swapped|both] [--csv]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (color_cnt == 0) {
+        colors[color_cnt++] = COLOR_MODE_RGB565;
+        colors[color_cnt++] = COLOR_MODE_RGB565_SWAPPED;
+    }
+
+    static const uint32_t buffer_modes[] = {BUFFER_20LINES, BUFFER_40LINES, BUFFER_60LINES, BUFFER_DEVIDED4, BUFFER_FULL};
+    static const uint32_t render_modes[] = {RENDER_MODE_PARTIAL, RENDER_MODE_FULL, RENDER_MODE_DIRECT};
+    static const bool     double_modes[] = {false, true};
+
+    if (csv) {
+        printf("buffer_mode,render_mode,double_buffer,color_mode,frames,p50_us,p99_us,bytes_per_frame,flush_per_frame,areas_per_frame,"
+               "gram\n");
+    } else {
+        printf("%-9s %-8s %-6s %-8s %7s %9s %9s %12s %9s %9s %5s\n", "BUFFER", "RENDER", "DOUBLE", "COLOR", "frames", "p50[us]", "p99[us]",
+            "bytes/frame", "flush/fr", "areas/fr", "gram");
+    }
+
+    uint32_t gram_bad = 0;
+    uint64_t ref_hash = 0;
+    bool     have_ref = false;
+    for (size_t b = 0; b < sizeof(buffer_modes) / sizeof(buffer_modes[0]); b++) {
+        for (size_t r = 0; r < sizeof(render_modes) / sizeof(render_modes[0]); r++) {
+            for (size_t d = 0; d < sizeof(double_modes) / sizeof(double_modes[0]); d++) {
+                for (size_t c = 0; c < color_cnt; c++) {
+                    bench_combo_t combo = {buffer_modes[b], render_modes[r], double_modes[d], colors[c]};
+                    // FULL si DIRECT cer un buffer cat tot ecranul
+                    if (combo.render_mode != RENDER_MODE_PARTIAL && combo.buffer_mode != BUFFER_FULL) {
+                        continue;
+                    }
+                    bench_result_t res;
+                    bench_run_combo(&combo, frames, &res);
+                    // Panoul trebuie sa arate la fel indiferent de buffer, render mode si cine inverseaza byte-ii:
+                    // referinta e prima combinatie (PARTIAL, RGB565 daca e in --color)
+                    const char* gram = "ref";
+                    if (!have_ref) {
+                        ref_hash = res.gram_hash;
+                        have_ref = true;
+                    } else {
+                        gram = res.gram_hash == ref_hash ? "ok" : "DIFF";
+                        gram_bad += res.gram_hash != ref_hash;
+                    }
+                    if (csv) {
+                        printf("%s,%s,%d,%s,%u,%llu,%llu,%.0f,%.2f,%.2f,%s\n",
+                            buffer_mode_name(combo.buffer_mode),
+                            render_mode_name(combo.render_mode),
+                            combo.double_buffer,
+                            color_mode_name(combo.color_mode),
+                            res.frames,
+                            (unsigned long long) res.p50_us,
+                            (unsigned long long) res.p99_us,
+                            res.bytes_per_frame,
+                            res.flush_per_frame,
+                            res.areas_per_frame,
+                            gram);
+                    } else {
+                        printf("%-9s %-8s %-6s %-8s %7u %9llu %9llu %12.0f %9.2f %9.2f %5s\n",
+                            buffer_mode_name(combo.buffer_mode),
+                            render_mode_name(combo.render_mode),
+                            combo.double_buffer ? "yes" : "no",
+                            color_mode_name(combo.color_mode),
+                            res.frames,
+                            (unsigned long long) res.p50_us,
+                            (unsigned long long) res.p99_us,
+                            res.bytes_per_frame,
+                            res.flush_per_frame,
+                            res.areas_per_frame,
+                            gram);
+                    }
+                }
+            }
+        }
+    }
+    return gram_bad ? 1 : 0;
+}
+
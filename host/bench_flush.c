@@ -0,0 +1,337 @@
+/*
+ * bench_flush - whole-area flush vs. striped flush (main/flush_engine.c) on a simulated i80 bus.
+ *
+ * Acelasi UI ca bench_display, dar mock_panel are magistrala simulata (latime de banda,
+ * coada de trans_queue_depth, cost de cache sync pentru PSRAM), iar fiecare frame
+ * redeseneaza tot ecranul. Pentru fiecare strategie de buffer ruleaza:
+ *   - "area"   : o singura transmisie per zona (ca esp_lcd_panel_draw_bitmap)
+ *   - "stripe" : zona impartita in benzi RAMWR + RAMWRC puse toate in coada
+ * In DIRECT zona sta in bufferul cat tot ecranul (stride = latimea ecranului), iar GRAM-ul
+ * trebuie sa fie acelasi ca al primei strategii (PARTIAL). Dreptunghiul din mijloc de la sfarsit
+ * nu are voie sa plece in mai mult de QUEUE_DEPTH transferuri.
+ *
+ * Usage: bench_flush [--frames N] [--stripe BYTES] [--bus BYTES_PER_SEC] [--csv]
+ */
+
+#include <sched.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "lvgl.h"
+#include "lvgl_private.h"
+
+#include "flush_engine.h"
+#include "mock_panel.h"
+#include "ui.h"
+
+#define LCD_WIDTH          (320)
+#define LCD_HEIGHT         (240)
+#define BUS_BYTES_PER_SEC  (20u * 1000u * 1000u)  // i80 8 biti @ 20 MHz, ca in main.cpp
+#define QUEUE_DEPTH        (10)                   // trans_queue_depth din main.cpp
+#define PSRAM_SYNC_PER_SEC (80u * 1000u * 1000u)  // esp_cache_msync pe PSRAM, aproximativ
+
+/**********************
+ *   BENCH VARIABLES
+ **********************/
+typedef struct {
+    const char* name;
+    uint32_t    lines;
+    bool        double_buffer;
+    bool        spiram;  // Adds the cache sync cost to every transfer
+    uint32_t    render_mode;
+} bench_buf_t;
+
+typedef struct {
+    uint32_t frames;
+    double   fps;
+    uint64_t p50_us;
+    uint64_t p99_us;
+    double   bus_idle_pct;
+    double   stall_us_per_frame;
+    double   stripes_per_area;
+    uint32_t max_in_flight;
+    uint32_t mid_stripes;  // Transfers of the last, mid-screen area
+    uint32_t gram_hash;
+} bench_result_t;
+
+static mock_panel_t*  s_panel;
+static flush_engine_t s_engine;
+static uint64_t       s_start_us;
+static uint64_t       s_refr_start_us;
+static uint64_t*      s_frame_us;
+static uint32_t       s_frame_cnt;
+static uint32_t       s_frame_cap;
+
+/**********************
+ *   BENCH FUNCTIONS
+ **********************/
+static uint64_t now_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000u + (uint64_t) ts.tv_nsec / 1000u;
+}
+//---------
+static uint32_t real_tick_cb(void) {
+    return (uint32_t) ((now_us() - s_start_us) / 1000u);
+}
+//---------
+static int cmp_u64(const void* a, const void* b) {
+    uint64_t x = *(const uint64_t*) a;
+    uint64_t y = *(const uint64_t*) b;
+    return (x > y) - (x < y);
+}
+//---------
+static uint64_t percentile(uint64_t* sorted, uint32_t n, uint32_t pct) {
+    if (n == 0) {
+        return 0;
+    }
+    uint32_t idx = (uint32_t) (((uint64_t) (n - 1) * pct + 50) / 100);
+    return sorted[idx];
+}
+//---------
+static uint32_t fnv1a(const uint8_t* data, size_t len) {
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < len; i++) {
+        h = (h ^ data[i]) * 16777619u;
+    }
+    return h;
+}
+//---------
+/* flush_engine_io_t over the mock panel, same shape as the esp_lcd adapter in main.cpp */
+static int bench_set_window(void* io, int x1, int y1, int x2, int y2) {
+    return mock_panel_set_window((mock_panel_t*) io, x1, y1, x2 + 1, y2 + 1);
+}
+//---------
+static int bench_tx_color(void* io, bool first, const void* data, size_t len) {
+    return mock_panel_tx_color((mock_panel_t*) io, first ? MOCK_PANEL_CMD_RAMWR : MOCK_PANEL_CMD_RAMWRC, data, len);
+}
+//---------
+static bool bench_trans_done(mock_panel_t* panel, void* user_ctx) {
+    (void) panel;
+    (void) user_ctx;
+    flush_engine_on_trans_done(&s_engine);
+    return false;
+}
+//---------
+static void bench_engine_done(void* user_ctx) {
+    lv_display_flush_ready((lv_display_t*) user_ctx);
+}
+//---------
+/* Same job as lv_disp_flush in main.cpp: in DIRECT px_map is the whole screen buffer */
+static void bench_disp_flush(lv_display_t* disp, const lv_area_t* area, uint8_t* px_map) {
+    size_t stride = 0;
+    if (disp->render_mode == LV_DISPLAY_RENDER_MODE_DIRECT) {
+        stride = LCD_WIDTH * 2;
+        px_map += (size_t) area->y1 * stride + (size_t) area->x1 * 2;
+    }
+    flush_engine_flush(&s_engine, area->x1, area->y1, area->x2, area->y2, px_map, stride, 2);
+}
+//---------
+/* Thread-ul magistralei trebuie sa apuce CPU-ul si pe o masina cu un singur core */
+static void bench_flush_wait(lv_display_t* disp) {
+    while (disp->flushing) {
+        sched_yield();
+    }
+}
+//---------
+static void bench_display_event_cb(lv_event_t* e) {
+    switch (lv_event_get_code(e)) {
+        case LV_EVENT_REFR_START:
+            s_refr_start_us = now_us();
+            break;
+        case LV_EVENT_REFR_READY:
+            if (s_frame_cnt < s_frame_cap) {
+                s_frame_us[s_frame_cnt++] = now_us() - s_refr_start_us;
+            }
+            break;
+        case LV_EVENT_FLUSH_WAIT_START:
+            flush_engine_stall_begin(&s_engine);
+            break;
+        case LV_EVENT_FLUSH_WAIT_FINISH:
+            flush_engine_stall_end(&s_engine);
+            break;
+        default:
+            break;
+    }
+}
+//---------
+static void bench_run(const bench_buf_t* buf, size_t stripe_bytes, uint32_t bus_bytes_per_sec, uint32_t frames, bench_result_t* out) {
+    memset(out, 0, sizeof(*out));
+
+    lv_init();
+    s_start_us = now_us();
+    lv_tick_set_cb(real_tick_cb);
+    lv_display_t* disp = lv_display_create(LCD_WIDTH, LCD_HEIGHT);
+
+    mock_panel_config_t panel_config = {
+        .h_res                    = LCD_WIDTH,
+        .v_res                    = LCD_HEIGHT,
+        .bits_per_pixel           = 16,
+        .swap_color_bytes         = true,
+        .bus_bytes_per_sec        = bus_bytes_per_sec,
+        .queue_depth              = QUEUE_DEPTH,
+        .cache_sync_bytes_per_sec = buf->spiram ? PSRAM_SYNC_PER_SEC : 0,
+    };
+    s_panel = mock_panel_create(&panel_config);
+    mock_panel_register_trans_done(s_panel, bench_trans_done, NULL);
+
+    flush_engine_config_t engine_config = {
+        .stripe_bytes = stripe_bytes,
+        .queue_depth  = QUEUE_DEPTH,
+        .now_us       = now_us,
+    };
+    flush_engine_io_t engine_io = {
+        .set_window = bench_set_window,
+        .tx_color   = bench_tx_color,
+        .io         = s_panel,
+    };
+    flush_engine_init(&s_engine, &engine_config, &engine_io, bench_engine_done, disp);
+
+    uint32_t bufSize = LCD_WIDTH * buf->lines * 2;
+    void*    buf1    = calloc(1, bufSize);
+    void*    buf2    = buf->double_buffer ? calloc(1, bufSize) : NULL;
+    lv_display_set_buffers(disp, buf1, buf2, bufSize, (lv_display_render_mode_t) buf->render_mode);
+    lv_display_set_antialiasing(disp, true);
+    lv_display_set_flush_cb(disp, bench_disp_flush);
+    lv_display_set_flush_wait_cb(disp, bench_flush_wait);
+    lv_display_add_event_cb(disp, bench_display_event_cb, LV_EVENT_ALL, NULL);
+
+    create_tabs_ui();
+
+    // Primul frame nu intra in statistica
+    s_frame_cap = 0;
+    lv_refr_now(disp);
+    mock_panel_wait_idle(s_panel);
+    flush_engine_reset_stats(&s_engine);
+
+    s_frame_us  = (uint64_t*) calloc(frames, sizeof(uint64_t));
+    s_frame_cap = frames;
+    s_frame_cnt = 0;
+
+    uint64_t t0 = now_us();
+    for (uint32_t f = 0; f < frames; f++) {
+        lv_obj_invalidate(lv_screen_active());
+        lv_refr_now(disp);
+    }
+    mock_panel_wait_idle(s_panel);
+    uint64_t total_us = now_us() - t0;
+
+    flush_engine_stats_t stats;
+    flush_engine_get_stats(&s_engine, &stats);
+    qsort(s_frame_us, s_frame_cnt, sizeof(uint64_t), cmp_u64);
+    out->frames = s_frame_cnt;
+    out->fps    = total_us ? (double) s_frame_cnt * 1e6 / (double) total_us : 0.0;
+    out->p50_us = percentile(s_frame_us, s_frame_cnt, 50);
+    out->p99_us = percentile(s_frame_us, s_frame_cnt, 99);
+    if (stats.bus_busy_us + stats.bus_idle_us) {
+        out->bus_idle_pct = 100.0 * (double) stats.bus_idle_us / (double) (stats.bus_busy_us + stats.bus_idle_us);
+    }
+    if (s_frame_cnt) {
+        out->stall_us_per_frame = (double) stats.render_stall_us / s_frame_cnt;
+    }
+    if (stats.areas) {
+        out->stripes_per_area = (double) stats.stripes / stats.areas;
+    }
+    out->max_in_flight = stats.max_in_flight;
+
+    // La sfarsit doar un dreptunghi din mijloc: in DIRECT randurile lui nu sunt lipite in buffer
+    lv_area_t mid = {LCD_WIDTH / 4, LCD_HEIGHT / 4, LCD_WIDTH * 3 / 4 - 1, LCD_HEIGHT * 3 / 4 - 1};
+    lv_obj_invalidate_area(lv_screen_active(), &mid);
+    flush_engine_reset_stats(&s_engine);
+    lv_refr_now(disp);
+    mock_panel_wait_idle(s_panel);
+    flush_engine_get_stats(&s_engine, &stats);
+    out->mid_stripes = stats.stripes;
+    out->gram_hash = fnv1a(mock_panel_get_gram(s_panel), mock_panel_get_gram_size(s_panel));
+
+    lv_deinit();
+    mock_panel_delete(s_panel);
+    s_panel = NULL;
+    free(s_frame_us);
+    s_frame_us  = NULL;
+    s_frame_cap = 0;
+    free(buf1);
+    free(buf2);
+}
+
+/*
+███    ███  █████  ██ ███    ██
+████  ████ ██   ██ ██ ████   ██
+██ ████ ██ ███████ ██ ██ ██  ██
+██  ██  ██ ██   ██ ██ ██  ██ ██
+██      ██ ██   ██ ██ ██   ████
+*/
+int main(int argc, char** argv) {
+    uint32_t frames       = 60;
+    size_t   stripe_bytes = 8 * 1024;
+    uint32_t bus          = BUS_BYTES_PER_SEC;
+    bool     csv          = false;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc) {
+            frames = (uint32_t) strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--stripe") == 0 && i + 1 < argc) {
+            stripe_bytes = (size_t) strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--bus") == 0 && i + 1 < argc) {
+            bus = (uint32_t) strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--csv") == 0) {
+            csv = true;
+        } else {
+            fprintf(stderr, "usage: %s [--frames N] [--stripe BYTES] [--bus BYTES_PER_SEC] [--csv]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (bus == 0) {
+        fprintf(stderr, "--bus must be > 0\n");
+        return 1;
+    }
+
+    static const bench_buf_t bufs[] = {
+        {"40L int double", 40, true, false, LV_DISPLAY_RENDER_MODE_PARTIAL},
+        {"40L int single", 40, false, false, LV_DISPLAY_RENDER_MODE_PARTIAL},
+        {"full psram double", LCD_HEIGHT, true, true, LV_DISPLAY_RENDER_MODE_PARTIAL},
+        {"full psram single", LCD_HEIGHT, false, true, LV_DISPLAY_RENDER_MODE_PARTIAL},
+        {"direct psram dbl", LCD_HEIGHT, true, true, LV_DISPLAY_RENDER_MODE_DIRECT},
+        {"direct psram sgl", LCD_HEIGHT, false, true, LV_DISPLAY_RENDER_MODE_DIRECT},
+    };
+
+    if (csv) {
+        printf("buffer,flush,frames,fps,p50_us,p99_us,bus_idle_pct,stall_us_per_frame,stripes_per_area,max_in_flight,gram_match\n");
+    } else {
+        printf("%-18s %-7s %6s %7s %9s %9s %9s %12s %9s %7s %5s\n", "BUFFER", "FLUSH", "frames", "fps", "p50[us]", "p99[us]", "idle[%]",
+            "stall[us]/fr", "stripes", "queued", "gram");
+    }
+
+    uint32_t ref_hash = 0;
+    uint32_t gram_bad = 0, queue_bad = 0;
+    for (size_t b = 0; b < sizeof(bufs) / sizeof(bufs[0]); b++) {
+        bench_result_t res[2];
+        bench_run(&bufs[b], 0, bus, frames, &res[0]);
+        bench_run(&bufs[b], stripe_bytes, bus, frames, &res[1]);
+        if (b == 0) {
+            ref_hash = res[0].gram_hash;
+        }
+        for (int m = 0; m < 2; m++) {
+            const char* flush = m ? "stripe" : "area";
+            const char* match = res[m].gram_hash == ref_hash ? "ok" : "DIFF";
+            gram_bad += res[m].gram_hash != ref_hash;
+            queue_bad += res[m].mid_stripes > QUEUE_DEPTH;  // Peste coada tx_color blocheaza
+            if (csv) {
+                printf("%s,%s,%u,%.1f,%llu,%llu,%.1f,%.0f,%.2f,%u,%s\n", bufs[b].name, flush, res[m].frames, res[m].fps,
+                    (unsigned long long) res[m].p50_us, (unsigned long long) res[m].p99_us, res[m].bus_idle_pct,
+                    res[m].stall_us_per_frame, res[m].stripes_per_area, res[m].max_in_flight, match);
+            } else {
+                printf("%-18s %-7s %6u %7.1f %9llu %9llu %9.1f %12.0f %9.2f %7u %5s\n", bufs[b].name, flush, res[m].frames, res[m].fps,
+                    (unsigned long long) res[m].p50_us, (unsigned long long) res[m].p99_us, res[m].bus_idle_pct,
+                    res[m].stall_us_per_frame, res[m].stripes_per_area, res[m].max_in_flight, match);
+            }
+        }
+    }
+    if (queue_bad) {
+        printf("%u runs sent the mid-screen area in more than %u transfers\n", queue_bad, QUEUE_DEPTH);
+    }
+    return gram_bad || queue_bad ? 1 : 0;
+}
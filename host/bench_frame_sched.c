@@ -0,0 +1,257 @@
+/*
+ * bench_frame_sched - main/frame_scheduler.c pe un ceas simulat.
+ *
+ * Nu foloseste LVGL: timerele (indev), invalidarile, costul de desenare si pulsul TE
+ * sunt simulate, iar timpul avanseaza doar prin render / sleep / wait_te. Fiecare
+ * scenariu ruleaza cu bucla veche din lv_main_task (lv_timer_handler la fiecare
+ * LV_DELAY = 5 ms) si cu frame_sched (target_fps, apoi pe TE).
+ *
+ * Usage: bench_frame_sched [--seconds N] [--fps N] [--csv]
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "frame_scheduler.h"
+
+#define LV_DELAY_US      (5000)   // lv_main_task: vTaskDelayUntil(LV_DELAY)
+#define TIMER_COST_US    (40)     // lv_timer_handler cu nimic de desenat
+#define TE_PERIOD_US     (16667)  // ST7789 la ~60 Hz
+#define TE_PHASE_US      (3100)
+#define TE_ALIGNED_US    (1000)   // frame pornit in prima ms dupa TE = fara tearing
+
+/**********************
+ *   BENCH VARIABLES
+ **********************/
+typedef struct {
+    const char* name;
+    uint32_t    render_us;       // Cost of one frame
+    uint64_t    anim_from_us;    // Continuous animation in [from, to)
+    uint64_t    anim_to_us;
+    uint32_t    touch_every_us;  // One invalidation every N us (0 = none)
+} bench_scenario_t;
+
+typedef enum {
+    POLICY_FIXED_DELAY = 0,  // Old lv_main_task loop
+    POLICY_PACED,            // frame_sched, target_fps
+    POLICY_TE,               // frame_sched, wait for TE
+} bench_policy_t;
+
+typedef struct {
+    const bench_scenario_t* sc;
+    uint64_t                now;
+    uint64_t                next_indev;
+    uint32_t                indev_period_us;
+    uint64_t                next_touch;
+    bool                    touch_pending;
+    uint64_t                busy_us;
+    uint32_t                wakeups;
+    uint32_t                frames;
+    uint32_t                te_aligned;
+    uint64_t                last_frame;
+    uint32_t                intervals;
+    double                  interval_sum;
+} bench_sim_t;
+
+typedef struct {
+    uint32_t frames;
+    double   fps;
+    double   wakeups_per_s;
+    double   cpu_pct;
+    double   te_aligned_pct;
+    uint32_t overruns;
+    uint32_t skipped;
+} bench_result_t;
+
+/**********************
+ *   SIMULATED PORT
+ **********************/
+static uint64_t sim_now_us(void* ctx) {
+    return ((bench_sim_t*) ctx)->now;
+}
+//---------
+static bool sim_animating(const bench_sim_t* sim) {
+    return sim->now >= sim->sc->anim_from_us && sim->now < sim->sc->anim_to_us;
+}
+//---------
+static uint32_t sim_run_timers(void* ctx) {
+    bench_sim_t* sim = (bench_sim_t*) ctx;
+    sim->wakeups++;
+    sim->now += TIMER_COST_US;
+    sim->busy_us += TIMER_COST_US;
+    while (sim->next_indev <= sim->now) {
+        sim->next_indev += sim->indev_period_us;
+        // Touch-ul invalideaza ceva doar cand e citit
+        if (sim->sc->touch_every_us && sim->now >= sim->next_touch) {
+            sim->touch_pending = true;
+            sim->next_touch += sim->sc->touch_every_us;
+        }
+    }
+    return (uint32_t) ((sim->next_indev - sim->now + 999) / 1000);
+}
+//---------
+static bool sim_frame_dirty(void* ctx) {
+    bench_sim_t* sim = (bench_sim_t*) ctx;
+    return sim->touch_pending || sim_animating(sim);
+}
+//---------
+static void sim_render(void* ctx) {
+    bench_sim_t* sim = (bench_sim_t*) ctx;
+    if (sim->now >= TE_PHASE_US && (sim->now - TE_PHASE_US) % TE_PERIOD_US < TE_ALIGNED_US) {
+        sim->te_aligned++;
+    }
+    if (sim_animating(sim) && sim->frames) {
+        double dt = (double) (sim->now - sim->last_frame);
+        sim->interval_sum += dt;
+        sim->intervals++;
+    }
+    sim->last_frame    = sim->now;
+    sim->touch_pending = false;
+    sim->frames++;
+    sim->now += sim->sc->render_us;
+    sim->busy_us += sim->sc->render_us;
+}
+//---------
+static void sim_sleep_us(void* ctx, uint32_t us) {
+    ((bench_sim_t*) ctx)->now += us;
+}
+//---------
+static bool sim_wait_te(void* ctx, uint32_t timeout_us) {
+    bench_sim_t* sim  = (bench_sim_t*) ctx;
+    uint64_t     next = TE_PHASE_US;
+    if (sim->now > TE_PHASE_US) {
+        next += ((sim->now - TE_PHASE_US + TE_PERIOD_US - 1) / TE_PERIOD_US) * TE_PERIOD_US;
+    }
+    if (next - sim->now > timeout_us) {
+        sim->now += timeout_us;
+        return false;
+    }
+    sim->now = next;
+    return true;
+}
+
+/**********************
+ *   BENCH FUNCTIONS
+ **********************/
+static void bench_run(const bench_scenario_t* sc, bench_policy_t policy, uint32_t fps, uint64_t duration_us, bench_result_t* out) {
+    bench_sim_t sim;
+    memset(&sim, 0, sizeof(sim));
+    memset(out, 0, sizeof(*out));
+    sim.sc              = sc;
+    sim.next_touch      = sc->touch_every_us;
+    sim.indev_period_us = (policy == POLICY_FIXED_DELAY) ? 1000 : 1000000 / fps;  // LV_DEF_REFR_PERIOD = 1 ms
+    sim.next_indev      = sim.indev_period_us;
+
+    frame_sched_t sched;
+    if (policy == POLICY_FIXED_DELAY) {
+        while (sim.now < duration_us) {
+            uint64_t start = sim.now;
+            sim_run_timers(&sim);
+            if (sim_frame_dirty(&sim)) {
+                sim_render(&sim);
+            }
+            // vTaskDelayUntil: daca am depasit, nu mai doarme
+            if (sim.now < start + LV_DELAY_US) {
+                sim.now = start + LV_DELAY_US;
+            }
+        }
+    } else {
+        frame_sched_config_t config = {
+            .target_fps    = fps,
+            .max_idle_ms   = 100,
+            .use_te        = (policy == POLICY_TE),
+            .te_timeout_us = 0,
+        };
+        frame_sched_port_t port = {
+            .now_us      = sim_now_us,
+            .run_timers  = sim_run_timers,
+            .frame_dirty = sim_frame_dirty,
+            .render      = sim_render,
+            .sleep_us    = sim_sleep_us,
+            .wait_te     = sim_wait_te,
+            .ctx         = &sim,
+        };
+        frame_sched_init(&sched, &config, &port);
+        while (sim.now < duration_us) {
+            frame_sched_run_once(&sched);
+        }
+        frame_sched_stats_t stats;
+        frame_sched_get_stats(&sched, &stats);
+        out->overruns = stats.overruns;
+        out->skipped  = stats.skipped_slots;
+    }
+
+    double seconds     = (double) sim.now / 1e6;
+    out->frames        = sim.frames;
+    out->wakeups_per_s = sim.wakeups / seconds;
+    out->cpu_pct       = 100.0 * (double) sim.busy_us / (double) sim.now;
+    if (sc->anim_to_us > sc->anim_from_us) {
+        out->fps = sim.intervals ? 1e6 * sim.intervals / sim.interval_sum : 0.0;
+    } else {
+        out->fps = sim.frames / seconds;
+    }
+    if (sim.frames) {
+        out->te_aligned_pct = 100.0 * sim.te_aligned / sim.frames;
+    }
+}
+
+/*
+███    ███  █████  ██ ███    ██
+████  ████ ██   ██ ██ ████   ██
+██ ████ ██ ███████ ██ ██ ██  ██
+██  ██  ██ ██   ██ ██ ██  ██ ██
+██      ██ ██   ██ ██ ██   ████
+*/
+int main(int argc, char** argv) {
+    uint32_t seconds = 10;
+    uint32_t fps     = 60;
+    bool     csv     = false;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--seconds") == 0 && i + 1 < argc) {
+            seconds = (uint32_t) strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--fps") == 0 && i + 1 < argc) {
+            fps = (uint32_t) strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--csv") == 0) {
+            csv = true;
+        } else {
+            fprintf(stderr, "usage: %s [--seconds N] [--fps N] [--csv]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (fps == 0 || seconds == 0) {
+        fprintf(stderr, "--fps and --seconds must be > 0\n");
+        return 1;
+    }
+    const uint64_t duration = (uint64_t) seconds * 1000000u;
+
+    const bench_scenario_t scenarios[] = {
+        {"idle", 3000, 0, 0, 0},
+        {"touch 10/s", 3000, 0, 0, 100000},
+        {"anim 6 ms", 6000, 0, duration, 0},
+        {"anim 22 ms", 22000, 0, duration, 0},
+    };
+    static const char* policy_names[] = {"delay 5ms", "paced", "paced+TE"};
+
+    if (csv) {
+        printf("scenario,policy,frames,fps,wakeups_per_s,cpu_pct,te_aligned_pct,overruns,skipped\n");
+    } else {
+        printf("%-11s %-10s %7s %7s %10s %7s %8s %8s %8s\n", "SCENARIO", "POLICY", "frames", "fps", "wakeups/s", "cpu[%]",
+            "te[%]", "overrun", "skipped");
+    }
+    for (size_t s = 0; s < sizeof(scenarios) / sizeof(scenarios[0]); s++) {
+        for (int p = POLICY_FIXED_DELAY; p <= POLICY_TE; p++) {
+            bench_result_t res;
+            bench_run(&scenarios[s], (bench_policy_t) p, fps, duration, &res);
+            if (csv) {
+                printf("%s,%s,%u,%.1f,%.1f,%.2f,%.1f,%u,%u\n", scenarios[s].name, policy_names[p], res.frames, res.fps, res.wakeups_per_s, res.cpu_pct, res.te_aligned_pct, res.overruns, res.skipped);
+            } else {
+                printf("%-11s %-10s %7u %7.1f %10.1f %7.2f %8.1f %8u %8u\n", scenarios[s].name, policy_names[p], res.frames, res.fps,
+                    res.wakeups_per_s, res.cpu_pct, res.te_aligned_pct, res.overruns, res.skipped);
+            }
+        }
+    }
+    return 0;
+}
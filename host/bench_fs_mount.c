@@ -0,0 +1,535 @@
+/*
+ * bench_fs_mount - montarea in paralel din mylibs/filesystem-v003/src/fs_mount.c, cu backend-uri
+ * false (latenta simulata) pe pthread in loc de task-uri FreeRTOS si event group
+ *
+ *   1. configuratia placii (filesystem-os.c): fs_mount_start nu blocheaza, LittleFS e gata cu
+ *      mult inainte de SD, SD incepe abia dupa FAT intern (doua montari FAT nu se suprapun),
+ *      timpii pe backend, fata de vechiul init_filesystem_sys (pe rand + 3 x vTaskDelay(100))
+ *   2. backend-uri care esueaza, task-uri care nu pornesc (banda montata pe loc), validarea
+ *      lui fs_mount_add, potrivirea cailor
+ *   3. configuratii aleatoare (benzi, needs, latente, spawn esuat) cu mai multe task-uri care
+ *      asteapta: ordinea pe banda si needs respectate, fiecare asteptare vede starea finala
+ *
+ * Usage: bench_fs_mount [--runs N] [--seed S]
+ */
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "fs_mount.h"
+
+#define ERR_TIMEOUT (0x107)  // ESP_ERR_TIMEOUT: card lipsa
+#define ERR_FAIL    (-1)     // ESP_FAIL
+
+/**********************
+ *   HELPERS
+ **********************/
+static bool expect(bool cond, const char* what) {
+    printf("  %-64s %s\n", what, cond ? "ok" : "FAIL");
+    return cond;
+}
+//---------
+static int64_t now_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t) ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+//---------
+static void sleep_us(int64_t us) {
+    struct timespec ts = {(time_t) (us / 1000000), (long) (us % 1000000) * 1000};
+    while (us > 0 && nanosleep(&ts, &ts) != 0) {
+    }
+}
+//---------
+static uint32_t rnd(uint32_t* state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 17;
+    *state ^= *state << 5;
+    return *state;
+}
+
+/**********************
+ *   HOST ENV
+ **********************/
+/* Ce face filesystem-os.c cu FreeRTOS: un thread pe banda, bitii intr-un "event group" */
+typedef struct host_env host_env_t;
+
+typedef struct {
+    host_env_t* h;
+    void (*fn)(void* arg);
+    void* arg;
+} host_worker_t;
+
+struct host_env {
+    pthread_mutex_t lock;
+    pthread_cond_t  cond;
+    uint32_t        bits;
+    uint32_t        spawn_fail;  // Benzile al caror worker "nu porneste"
+    pthread_t       threads[FS_MOUNT_MAX];
+    size_t          thread_count;
+    host_worker_t   workers[FS_MOUNT_MAX];
+    uint32_t        done_calls;
+    uint32_t        last_calls;
+    bool            last_saw_all;  // La last, toate starile erau finale
+};
+
+static void* host_worker(void* parameter) {
+    host_worker_t* w = parameter;
+    w->fn(w->arg);
+    return NULL;
+}
+//---------
+static bool host_spawn(void* ctx, uint8_t lane, void (*fn)(void* arg), void* arg) {
+    host_env_t* h = ctx;
+    if (h->spawn_fail & (1u << lane)) {
+        return false;
+    }
+    h->workers[lane] = (host_worker_t) {h, fn, arg};
+    if (pthread_create(&h->threads[h->thread_count], NULL, host_worker, &h->workers[lane]) != 0) {
+        return false;
+    }
+    h->thread_count++;
+    return true;
+}
+//---------
+static void host_done(void* ctx, const fs_mount_t* m, size_t index, bool last) {
+    host_env_t* h = ctx;
+    pthread_mutex_lock(&h->lock);
+    h->bits |= 1u << index;
+    h->done_calls++;
+    if (last) {
+        h->last_calls++;
+        h->last_saw_all = true;
+        for (size_t i = 0; i < m->count; i++) {
+            h->last_saw_all &= m->entries[i].state == FS_MOUNT_READY || m->entries[i].state == FS_MOUNT_FAILED;
+        }
+    }
+    pthread_cond_broadcast(&h->cond);
+    pthread_mutex_unlock(&h->lock);
+}
+//---------
+static uint32_t host_wait(void* ctx, uint32_t mask, uint32_t timeout_ms) {
+    host_env_t*     h = ctx;
+    struct timespec deadline;
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+    deadline.tv_sec += timeout_ms / 1000;
+    deadline.tv_nsec += (long) (timeout_ms % 1000) * 1000000;
+    if (deadline.tv_nsec >= 1000000000) {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000;
+    }
+    pthread_mutex_lock(&h->lock);
+    while ((h->bits & mask) != mask) {
+        if (timeout_ms == FS_MOUNT_WAIT_FOREVER) {
+            pthread_cond_wait(&h->cond, &h->lock);
+        } else if (timeout_ms == 0 || pthread_cond_timedwait(&h->cond, &h->lock, &deadline) != 0) {
+            break;
+        }
+    }
+    uint32_t bits = h->bits;
+    pthread_mutex_unlock(&h->lock);
+    return bits;
+}
+//---------
+static int64_t host_now_us(void* ctx) {
+    (void) ctx;
+    return now_us();
+}
+//---------
+static void host_init(host_env_t* h, fs_mount_t* m) {
+    memset(h, 0, sizeof(*h));
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&h->cond, &attr);
+    pthread_condattr_destroy(&attr);
+    pthread_mutex_init(&h->lock, NULL);
+    const fs_mount_env_t env = {
+        .spawn  = host_spawn,
+        .done   = host_done,
+        .wait   = host_wait,
+        .now_us = host_now_us,
+        .ctx    = h,
+    };
+    fs_mount_init(m, &env);
+}
+//---------
+static void host_join(host_env_t* h) {
+    for (size_t i = 0; i < h->thread_count; i++) {
+        pthread_join(h->threads[i], NULL);
+    }
+    pthread_cond_destroy(&h->cond);
+    pthread_mutex_destroy(&h->lock);
+}
+
+/**********************
+ *   FAKE BACKENDS
+ **********************/
+static volatile uint32_t s_fat_active;  // Montari FAT in curs (FATFS: drive ales la inceput)
+static volatile uint32_t s_fat_overlap;
+
+typedef struct {
+    int64_t  latency_us;
+    int      err;
+    bool     fat;
+    uint32_t calls;
+} fake_backend_t;
+
+static int fake_mount(void* arg) {
+    fake_backend_t* b = arg;
+    if (b->fat && __atomic_add_fetch(&s_fat_active, 1, __ATOMIC_ACQ_REL) > 1) {
+        __atomic_add_fetch(&s_fat_overlap, 1, __ATOMIC_RELAXED);
+    }
+    sleep_us(b->latency_us);
+    if (b->fat) {
+        __atomic_sub_fetch(&s_fat_active, 1, __ATOMIC_ACQ_REL);
+    }
+    __atomic_add_fetch(&b->calls, 1, __ATOMIC_RELAXED);
+    return b->err;
+}
+
+/**********************
+ *   BOARD CONFIG
+ **********************/
+/* Acelasi tabel ca s_backends din filesystem-os.c (benzile din defines.h) */
+enum { B_FAT, B_SD, B_LITTLEFS, B_SPIFFS, B_COUNT };
+
+static const char* const s_board_names[B_COUNT] = {"fat", "sdmmc", "littlefs", "spiffs"};
+static const char* const s_board_paths[B_COUNT] = {"/spiflash", "/sdcard", "/littlefs", "/spiffs"};
+static const uint8_t     s_board_lanes[B_COUNT] = {1, 0, 2, 3};
+
+static void board_add(fs_mount_t* m, fake_backend_t* fake) {
+    for (int i = 0; i < B_COUNT; i++) {
+        const fs_mount_backend_t b = {
+            .name  = s_board_names[i],
+            .path  = s_board_paths[i],
+            .mount = fake_mount,
+            .arg   = &fake[i],
+            .lane  = s_board_lanes[i],
+            .needs = i == B_SD ? 1u << B_FAT : 0,
+        };
+        fs_mount_add(m, &b);
+    }
+}
+//---------
+static bool check_board(void) {
+    bool ok = true;
+    // Latente ca pe placa: un card SD lent, SPIFFS cu SPIFFS_check, restul cateva zeci de ms
+    fake_backend_t fake[B_COUNT] = {
+        [B_FAT]      = {.latency_us = 40000, .fat = true},
+        [B_SD]       = {.latency_us = 600000, .fat = true},
+        [B_LITTLEFS] = {.latency_us = 30000},
+        [B_SPIFFS]   = {.latency_us = 250000},
+    };
+    host_env_t h;
+    fs_mount_t m;
+    host_init(&h, &m);
+    board_add(&m, fake);
+    s_fat_overlap = 0;
+
+    int64_t t0      = now_us();
+    size_t  workers = fs_mount_start(&m);
+    int64_t start   = now_us() - t0;
+    ok &= expect(workers == B_COUNT, "one worker per lane");
+    ok &= expect(start < fake[B_LITTLEFS].latency_us, "fs_mount_start returns before any mount ends");
+    ok &= expect(fs_mount_wait(&m, B_SD, 0) == FS_MOUNT_QUEUED || fs_mount_wait(&m, B_SD, 0) == FS_MOUNT_RUNNING,
+        "sdmmc is not mounted yet");
+
+    fs_mount_state_t lfs      = fs_mount_wait_path(&m, "/littlefs/history.txt", FS_MOUNT_WAIT_FOREVER);
+    int64_t          lfs_at   = now_us() - t0;
+    fs_mount_state_t sd_state = fs_mount_wait(&m, B_SD, 0);
+    ok &= expect(lfs == FS_MOUNT_READY, "history path (/littlefs) awaited alone: ready");
+    ok &= expect(sd_state == FS_MOUNT_QUEUED || sd_state == FS_MOUNT_RUNNING, "...while sdmmc is still pending");
+    ok &= expect(lfs_at < fake[B_FAT].latency_us + fake[B_SD].latency_us / 2, "...long before sdmmc is done");
+    ok &= expect(fs_mount_wait_path(&m, "/sdcard", 50) == FS_MOUNT_RUNNING, "waiting 50 ms on /sdcard times out");
+
+    ok &= expect(fs_mount_wait_all(&m, FS_MOUNT_WAIT_FOREVER), "all backends finish");
+    int64_t all_at = now_us() - t0;
+    host_join(&h);
+
+    bool all_ready = true;
+    for (int i = 0; i < B_COUNT; i++) {
+        all_ready &= m.entries[i].state == FS_MOUNT_READY && m.entries[i].err == 0 && fake[i].calls == 1;
+    }
+    ok &= expect(all_ready, "every backend mounted exactly once");
+    ok &= expect(s_fat_overlap == 0, "the two FAT mounts never overlap");
+    ok &= expect(m.entries[B_SD].start_us >= m.entries[B_FAT].start_us + m.entries[B_FAT].time_us,
+        "sdmmc starts after fat is done (needs)");
+    ok &= expect(m.entries[B_LITTLEFS].start_us < m.entries[B_FAT].time_us, "littlefs does not wait for fat");
+    ok &= expect(h.done_calls == B_COUNT && h.last_calls == 1 && h.last_saw_all, "done once per backend, last once");
+
+    int64_t serial = fs_mount_serial_us(&m);
+    int64_t wall   = fs_mount_wall_us(&m);
+    int64_t lane0  = fake[B_FAT].latency_us + fake[B_SD].latency_us;
+    ok &= expect(wall < serial && wall < lane0 + 50000, "wall time is the longest lane, not the sum");
+
+    printf("\n  %-10s %-10s %5s %10s %10s  %s\n", "backend", "path", "lane", "start ms", "mount ms", "state");
+    for (int i = 0; i < B_COUNT; i++) {
+        const fs_mount_entry_t* e = &m.entries[i];
+        printf("  %-10s %-10s %5u %10.1f %10.1f  %s\n", e->backend.name, e->backend.path, (unsigned) e->backend.lane,
+            e->start_us / 1000.0, e->time_us / 1000.0, fs_mount_state_name(e->state));
+    }
+    // Vechiul init_filesystem_sys: pe rand, cu vTaskDelay(100) (100 ms la 1000 Hz) dupa SD, LittleFS, SPIFFS
+    printf("\n  %-44s %10s %10s\n", "", "before", "after");
+    printf("  %-44s %10.1f %10.1f\n", "app_main blocked (ms)", (serial + 300000) / 1000.0, start / 1000.0);
+    printf("  %-44s %10.1f %10.1f\n", "/littlefs usable (ms)",
+        (fake[B_SD].latency_us + 100000 + fake[B_FAT].latency_us + fake[B_LITTLEFS].latency_us) / 1000.0,
+        lfs_at / 1000.0);
+    printf("  %-44s %10.1f %10.1f\n\n", "all mounted (ms)", (serial + 300000) / 1000.0, all_at / 1000.0);
+    return ok;
+}
+
+/**********************
+ *   EDGE CASES
+ **********************/
+static bool check_failures(void) {
+    bool           ok              = true;
+    fake_backend_t fake[B_COUNT]   = {
+        [B_FAT]      = {.latency_us = 2000, .err = ERR_FAIL, .fat = true},
+        [B_SD]       = {.latency_us = 5000, .err = ERR_TIMEOUT, .fat = true},
+        [B_LITTLEFS] = {.latency_us = 1000},
+        [B_SPIFFS]   = {.latency_us = 3000},
+    };
+    host_env_t h;
+    fs_mount_t m;
+    host_init(&h, &m);
+    board_add(&m, fake);
+    fs_mount_start(&m);
+    ok &= expect(fs_mount_wait_path(&m, "/sdcard/x", FS_MOUNT_WAIT_FOREVER) == FS_MOUNT_FAILED,
+        "missing SD card: waiter gets failed");
+    ok &= expect(fs_mount_wait_all(&m, FS_MOUNT_WAIT_FOREVER), "all finish");
+    host_join(&h);
+    ok &= expect(m.entries[B_SD].err == ERR_TIMEOUT && m.entries[B_FAT].err == ERR_FAIL, "error codes recorded");
+    ok &= expect(fake[B_SD].calls == 1, "a failed need still unblocks (order, not success)");
+    ok &= expect(m.entries[B_LITTLEFS].state == FS_MOUNT_READY && m.entries[B_SPIFFS].state == FS_MOUNT_READY,
+        "other backends unaffected");
+    ok &= expect(h.last_calls == 1 && h.last_saw_all, "last reported once");
+    return ok;
+}
+//---------
+static bool check_spawn_failures(void) {
+    bool ok = true;
+
+    // Doua benzi fara worker: montate pe loc, in fs_mount_start
+    fake_backend_t fake[B_COUNT] = {
+        [B_FAT] = {.latency_us = 1000, .fat = true}, [B_SD] = {.latency_us = 3000, .fat = true},
+        [B_LITTLEFS] = {.latency_us = 1000},         [B_SPIFFS] = {.latency_us = 1000},
+    };
+    host_env_t h;
+    fs_mount_t m;
+    host_init(&h, &m);
+    h.spawn_fail = (1u << s_board_lanes[B_LITTLEFS]) | (1u << s_board_lanes[B_SPIFFS]);
+    board_add(&m, fake);
+    size_t workers = fs_mount_start(&m);
+    ok &= expect(workers == 2, "2 of 4 workers start");
+    ok &= expect(fs_mount_wait(&m, B_LITTLEFS, 0) == FS_MOUNT_READY && fs_mount_wait(&m, B_SPIFFS, 0) == FS_MOUNT_READY,
+        "lanes without a worker are mounted inside fs_mount_start");
+    ok &= expect(fs_mount_wait_all(&m, FS_MOUNT_WAIT_FOREVER), "the others finish on their workers");
+    host_join(&h);
+
+    // Banda A: 0, 3; banda B: 1, 2; 3 are nevoie de 2. Pe loc, pe benzi, A ar astepta dupa B
+    fake_backend_t f2[4] = {{.latency_us = 500}, {.latency_us = 500}, {.latency_us = 500}, {.latency_us = 500}};
+    const char*    paths[4]   = {"/a0", "/b1", "/b2", "/a3"};
+    const uint8_t  lanes[4]   = {0, 1, 1, 0};
+    const uint32_t needs[4]   = {0, 0, 0, 1u << 2};
+    const uint32_t fail[3]    = {0x3, 0x1, 0x2};
+    const char*    what[3]    = {"no worker at all: everything inline, needs across lanes hold",
+           "lane A inline waits for lane B on its worker", "lane B inline while lane A's worker waits for it"};
+    for (int c = 0; c < 3; c++) {
+        host_init(&h, &m);
+        h.spawn_fail = fail[c];
+        for (int i = 0; i < 4; i++) {
+            f2[i].calls              = 0;
+            const fs_mount_backend_t b = {
+                .name = paths[i], .path = paths[i], .mount = fake_mount, .arg = &f2[i], .lane = lanes[i],
+                .needs = needs[i]};
+            fs_mount_add(&m, &b);
+        }
+        fs_mount_start(&m);
+        bool done = fs_mount_wait_all(&m, 2000);
+        host_join(&h);
+        ok &= expect(done && m.entries[3].start_us >= m.entries[2].start_us + m.entries[2].time_us, what[c]);
+    }
+    return ok;
+}
+//---------
+static bool check_add_and_paths(void) {
+    bool           ok   = true;
+    fake_backend_t fake = {0};
+    host_env_t     h;
+    fs_mount_t     m;
+    host_init(&h, &m);
+
+    fs_mount_backend_t b = {.name = "root", .path = "/data", .mount = fake_mount, .arg = &fake};
+    ok &= expect(fs_mount_add(&m, &b) == 0, "add returns the index");
+    b.needs = 1u << 1;
+    ok &= expect(fs_mount_add(&m, &b) == -1, "needs on itself / a later backend refused");
+    b.needs = 0;
+    b.lane  = FS_MOUNT_MAX;
+    ok &= expect(fs_mount_add(&m, &b) == -1, "lane out of range refused");
+    b.lane  = 0;
+    b.mount = NULL;
+    ok &= expect(fs_mount_add(&m, &b) == -1, "no mount function refused");
+    b.mount = fake_mount;
+    b.path  = "/data/sd";
+    ok &= expect(fs_mount_add(&m, &b) == 1, "nested mount point added");
+    ok &= expect(fs_mount_wait_path(&m, "/data", 0) == FS_MOUNT_IDLE, "before start: idle");
+
+    ok &= expect(fs_mount_find(&m, "/data") == 0 && fs_mount_find(&m, "/data/x.txt") == 0, "/data, /data/x.txt -> /data");
+    ok &= expect(fs_mount_find(&m, "/data/sd/x") == 1 && fs_mount_find(&m, "/data/sd") == 1, "longest mount point wins");
+    ok &= expect(fs_mount_find(&m, "/data2/x") == -1 && fs_mount_find(&m, "/dat") == -1, "/data2, /dat: no backend");
+    ok &= expect(fs_mount_find(&m, "/data/sdx") == 0, "/data/sdx -> /data, not /data/sd");
+
+    fs_mount_start(&m);
+    ok &= expect(fs_mount_wait_path(&m, "/other/file", FS_MOUNT_WAIT_FOREVER) == FS_MOUNT_IDLE,
+        "path of no backend: idle, no wait");
+    ok &= expect(fs_mount_add(&m, &b) == -1, "add after start refused");
+    ok &= expect(fs_mount_start(&m) == 0, "second start does nothing");
+    ok &= expect(fs_mount_wait_all(&m, FS_MOUNT_WAIT_FOREVER) && fake.calls == 2, "each mounted once");
+    host_join(&h);
+
+    fs_mount_t full;
+    host_env_t h2;
+    host_init(&h2, &full);
+    for (int i = 0; i < FS_MOUNT_MAX; i++) {
+        fs_mount_add(&full, &b);
+    }
+    ok &= expect(fs_mount_add(&full, &b) == -1, "FS_MOUNT_MAX backends, then refused");
+
+    fs_mount_t empty;
+    host_env_t h3;
+    host_init(&h3, &empty);
+    ok &= expect(fs_mount_start(&empty) == 0 && fs_mount_wait_all(&empty, 0), "no backends: nothing to wait for");
+    host_join(&h2);
+    host_join(&h3);
+    return ok;
+}
+
+/**********************
+ *   RANDOM CONFIGS
+ **********************/
+typedef struct {
+    fs_mount_t*      m;
+    const char*      path;
+    uint32_t         timeout_ms;
+    fs_mount_state_t got;
+} waiter_t;
+
+static void* waiter_run(void* arg) {
+    waiter_t* w = arg;
+    w->got      = fs_mount_wait_path(w->m, w->path, w->timeout_ms);
+    return NULL;
+}
+//---------
+static bool check_random(int runs, uint32_t seed) {
+    static const char* const paths[FS_MOUNT_MAX] = {"/p0", "/p1", "/p2", "/p3", "/p4", "/p5", "/p6", "/p7"};
+    uint32_t                 state = seed ? seed : 1;
+    int                      bad_order = 0, bad_needs = 0, bad_wait = 0, bad_done = 0, inline_runs = 0;
+    int64_t                  sum_wall = 0, sum_serial = 0;
+
+    for (int r = 0; r < runs; r++) {
+        host_env_t     h;
+        fs_mount_t     m;
+        fake_backend_t fake[FS_MOUNT_MAX];
+        host_init(&h, &m);
+        size_t  count     = 1 + rnd(&state) % FS_MOUNT_MAX;
+        uint8_t lanes_max = (uint8_t) (1 + rnd(&state) % 4);
+        for (size_t i = 0; i < count; i++) {
+            fake[i] = (fake_backend_t) {.latency_us = rnd(&state) % 300, .err = (rnd(&state) % 8) == 0 ? ERR_FAIL : 0};
+            uint32_t needs = i > 0 && rnd(&state) % 3 == 0 ? (rnd(&state) & ((1u << i) - 1)) : 0;
+            const fs_mount_backend_t b = {.name = paths[i], .path = paths[i], .mount = fake_mount, .arg = &fake[i],
+                .lane = (uint8_t) (rnd(&state) % lanes_max), .needs = needs};
+            fs_mount_add(&m, &b);
+        }
+        if (rnd(&state) % 10 == 0) {
+            h.spawn_fail = rnd(&state) & 0xF;
+            inline_runs++;
+        }
+
+        // Asteptari pornite inainte de montare, cu si fara timeout
+        waiter_t  w[3];
+        pthread_t wt[3];
+        for (int k = 0; k < 3; k++) {
+            w[k] = (waiter_t) {&m, paths[rnd(&state) % count], k == 0 ? FS_MOUNT_WAIT_FOREVER : 1000, FS_MOUNT_IDLE};
+        }
+        fs_mount_start(&m);
+        for (int k = 0; k < 3; k++) {
+            pthread_create(&wt[k], NULL, waiter_run, &w[k]);
+        }
+        bool all = fs_mount_wait_all(&m, 5000);
+        for (int k = 0; k < 3; k++) {
+            pthread_join(wt[k], NULL);
+        }
+        host_join(&h);
+
+        bad_done += !all || h.done_calls != count || h.last_calls != 1 || !h.last_saw_all;
+        for (size_t i = 0; i < count; i++) {
+            const fs_mount_entry_t* e = &m.entries[i];
+            bad_done += fake[i].calls != 1 || e->state != (fake[i].err ? FS_MOUNT_FAILED : FS_MOUNT_READY);
+            for (size_t j = 0; j < i; j++) {
+                const fs_mount_entry_t* p   = &m.entries[j];
+                int64_t                 end = p->start_us + p->time_us;
+                bad_needs += (e->backend.needs & (1u << j)) && e->start_us < end;
+                bad_order += p->backend.lane == e->backend.lane && e->start_us < end;
+            }
+        }
+        for (int k = 0; k < 3; k++) {
+            bad_wait += w[k].got != m.entries[fs_mount_find(&m, w[k].path)].state;
+        }
+        sum_wall += fs_mount_wall_us(&m);
+        sum_serial += fs_mount_serial_us(&m);
+    }
+
+    char what[96];
+    bool ok = true;
+    snprintf(what, sizeof(what), "%d runs (%d with workers missing): all finish, done/last once", runs, inline_runs);
+    ok &= expect(bad_done == 0, what);
+    ok &= expect(bad_order == 0, "same lane: one after another, in add order");
+    ok &= expect(bad_needs == 0, "needs: started only after every needed backend ended");
+    ok &= expect(bad_wait == 0, "concurrent waiters see the final state");
+    printf("  mount time: %.2f ms in parallel vs %.2f ms one after another (average per run)\n",
+        sum_wall / 1000.0 / runs, sum_serial / 1000.0 / runs);
+    return ok;
+}
+
+/**********************
+ *   MAIN
+ **********************/
+int main(int argc, char** argv) {
+    int      runs = 300;
+    uint32_t seed = 0x5eed;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--runs") && i + 1 < argc) {
+            runs = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--seed") && i + 1 < argc) {
+            seed = (uint32_t) strtoul(argv[++i], NULL, 0);
+        } else {
+            fprintf(stderr, "usage: %s [--runs N] [--seed S]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (runs <= 0) {
+        fprintf(stderr, "--runs must be > 0\n");
+        return 2;
+    }
+
+    bool ok = true;
+    printf("board config:\n");
+    ok &= check_board();
+    printf("failures:\n");
+    ok &= check_failures();
+    printf("\nworkers that do not start:\n");
+    ok &= check_spawn_failures();
+    printf("\nfs_mount_add / paths:\n");
+    ok &= check_add_and_paths();
+    printf("\nrandom configs:\n");
+    ok &= check_random(runs, seed);
+
+    printf("\n%s\n", ok ? "all checks passed" : "FAILED");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,602 @@
+/*
+ * bench_littlefs_fd - tabela de FD-uri din components/littlefs/src/littlefs_fd.c (wrapper-ul VFS
+ * esp_littlefs) fata de vechea alocare: cache de pointeri cautat liniar + lista simplu inlantuita
+ *
+ *   1. tabela fata de un model, pe operatii aleatoare: FD-ul intors de get / find, reutilizarea
+ *      FD-urilor eliberate, coliziuni de hash (find cu si fara strcmp, ca la
+ *      CONFIG_LITTLEFS_USE_ONLY_HASH), FD-uri invalide
+ *   2. malloc care esueaza la crestere / init: tabela ramane neschimbata si utilizabila
+ *   3. open+close si cautarea dupa cale (unlink / rename pe un fisier deschis) cu N fisiere
+ *      deschise, veche vs noua, in operatii pe secunda
+ *   4. acelasi lucru cap-coada pe littlefs peste lfs_rambd: mii de fisiere deschise cu
+ *      lfs_file_opencfg si inchise in ordine aleatoare
+ *
+ * Usage: bench_littlefs_fd [--ops N] [--seed S]
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "bd/lfs_rambd.h"
+#include "lfs.h"
+#include "littlefs_fd.h"
+
+#define BLOCK_SIZE  (4096)  // Ca CONFIG_LITTLEFS_BLOCK_SIZE
+#define BLOCK_COUNT (512)
+#define IO_SIZE     (128)  // CONFIG_LITTLEFS_READ_SIZE / WRITE_SIZE
+#define CACHE_SIZE  (512)  // CONFIG_LITTLEFS_CACHE_SIZE, si bufferul fiecarui fisier
+#define LOOKAHEAD   (128)
+#define PATH_MAX_   (32)
+
+/**********************
+ *   HELPERS
+ **********************/
+static bool expect(bool cond, const char* what) {
+    printf("  %-64s %s\n", what, cond ? "ok" : "FAIL");
+    return cond;
+}
+//---------
+static int64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t) ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+//---------
+static uint32_t rnd(uint32_t* state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 17;
+    *state ^= *state << 5;
+    return *state;
+}
+//---------
+static void shuffle(int* v, int n, uint32_t* seed) {
+    for (int i = n - 1; i > 0; i--) {
+        int j = (int) (rnd(seed) % (uint32_t) (i + 1));
+        int t = v[i];
+        v[i]  = v[j];
+        v[j]  = t;
+    }
+}
+//---------
+/* compute_hash din esp_littlefs.c (DJB2) */
+static uint32_t djb2(const char* path) {
+    uint32_t hash = 5381;
+    char     c;
+    while ((c = *path++)) {
+        hash = ((hash << 5) + hash) + c;
+    }
+    return hash;
+}
+
+/* Malloc-ul tabelei (LITTLEFS_FD_MALLOC), ca sa poata esua la comanda */
+static bool s_fail_malloc;
+void* bench_fd_malloc(size_t size) {
+    return s_fail_malloc ? NULL : malloc(size);
+}
+
+/**********************
+ *   FILES
+ **********************/
+/* vfs_littlefs_file_t, cu calea in aceeasi alocare */
+typedef struct bench_file {
+    lfs_file_t             file;
+    struct lfs_file_config cfg;
+    uint8_t                buffer[CACHE_SIZE];
+    uint32_t               hash;
+    struct bench_file*     next;  // Doar pentru varianta veche
+    char                   path[];
+} bench_file_t;
+
+static bench_file_t* file_new(const char* path) {
+    size_t        len = strlen(path) + 1;
+    bench_file_t* f   = calloc(1, sizeof(*f) + len);
+    memcpy(f->path, path, len);
+    f->cfg.buffer = f->buffer;
+    return f;
+}
+//---------
+static bool path_match(const void* file, const void* path) {
+    return strcmp((const char*) path, ((const bench_file_t*) file)->path) == 0;
+}
+
+/**********************
+ *   OLD TABLE
+ **********************/
+/* esp_littlefs_allocate_fd / free_fd / get_fd_by_name de dinainte, fara log-uri */
+typedef struct {
+    bench_file_t*  file;  // Lista cu toate fisierele deschise
+    bench_file_t** cache;
+    uint16_t       cache_size;
+    uint16_t       fd_count;
+} old_table_t;
+
+static void old_init(old_table_t* t) {
+    t->file       = NULL;
+    t->cache_size = 4;
+    t->fd_count   = 0;
+    t->cache      = calloc(t->cache_size, sizeof(*t->cache));
+}
+//---------
+static void old_deinit(old_table_t* t) {
+    free(t->cache);
+}
+//---------
+static int old_alloc(old_table_t* t, bench_file_t* file) {
+    if (t->fd_count + 1 > t->cache_size) {
+        uint16_t       new_size  = (uint16_t) (2 * t->cache_size);
+        bench_file_t** new_cache = realloc(t->cache, new_size * sizeof(*t->cache));
+        if (!new_cache) {
+            return -1;
+        }
+        memset(&new_cache[t->cache_size], 0, (new_size - t->cache_size) * sizeof(*t->cache));
+        t->cache      = new_cache;
+        t->cache_size = new_size;
+    }
+    int i;
+    for (i = 0; i < t->cache_size; i++) {
+        if (t->cache[i] == NULL) {
+            t->cache[i] = file;
+            break;
+        }
+    }
+    file->next = t->file;
+    t->file    = file;
+    t->fd_count++;
+    return i;
+}
+//---------
+static bench_file_t* old_free(old_table_t* t, int fd) {
+    bench_file_t* file = t->cache[fd];
+    bench_file_t* head = t->file;
+    if (file == head) {
+        t->file = t->file->next;
+    } else {
+        while (head && head->next != file) {
+            head = head->next;
+        }
+        head->next = file->next;
+    }
+    t->cache[fd] = NULL;
+    t->fd_count--;
+    return file;
+}
+//---------
+static int old_find(const old_table_t* t, const char* path) {
+    uint32_t hash = djb2(path);
+    for (uint16_t i = 0, j = 0; i < t->cache_size && j < t->fd_count; i++) {
+        if (t->cache[i]) {
+            ++j;
+            if (t->cache[i]->hash == hash && strcmp(path, t->cache[i]->path) == 0) {
+                return i;
+            }
+        }
+    }
+    return -1;
+}
+
+/**********************
+ *   MODEL
+ **********************/
+#define MODEL_PATHS (300)
+#define MODEL_HASHES (13)  // Multe cai pe acelasi hash
+
+static bool check_model(int ops, uint32_t seed) {
+    littlefs_fd_table_t t;
+    int                 fd_of[MODEL_PATHS];  // Calea i -> FD, -1 = inchisa
+    char                paths[MODEL_PATHS][PATH_MAX_];
+    for (int i = 0; i < MODEL_PATHS; i++) {
+        snprintf(paths[i], sizeof(paths[i]), "/littlefs/m%03d", i);
+        fd_of[i] = -1;
+    }
+
+    bool ok_get = true, ok_find = true, ok_only_hash = true, ok_reuse = true, ok_bad = true;
+    bool ok_init = littlefs_fd_init(&t) == 0 && t.size == LITTLEFS_FD_MIN_SIZE && t.count == 0;
+    int  open = 0, max_open = 0, last_freed = -1;
+
+    for (int op = 0; op < ops; op++) {
+        int p = (int) (rnd(&seed) % MODEL_PATHS);
+        if (fd_of[p] < 0) {
+            bench_file_t* f = file_new(paths[p]);
+            int           fd = littlefs_fd_alloc(&t, f, djb2(paths[p]) % MODEL_HASHES);
+            // Cel mai recent FD eliberat e primul refolosit
+            ok_reuse &= fd >= 0 && (last_freed < 0 || fd == last_freed);
+            fd_of[p]   = fd;
+            last_freed = -1;
+            open++;
+        } else {
+            bench_file_t* f = littlefs_fd_free(&t, fd_of[p]);
+            ok_get &= f != NULL && strcmp(f->path, paths[p]) == 0;
+            ok_bad &= littlefs_fd_free(&t, fd_of[p]) == NULL;  // Dublu close
+            ok_bad &= littlefs_fd_get(&t, fd_of[p]) == NULL;
+            last_freed = fd_of[p];
+            fd_of[p]   = -1;
+            free(f);
+            open--;
+        }
+        max_open = open > max_open ? open : max_open;
+
+        // Din cand in cand toata tabela, altfel doar cateva cai
+        int from = op % 64 == 0 ? 0 : (int) (rnd(&seed) % MODEL_PATHS);
+        int to   = op % 64 == 0 ? MODEL_PATHS : from + 1;
+        for (int i = from; i < to; i++) {
+            uint32_t hash = djb2(paths[i]) % MODEL_HASHES;
+            int      fd   = littlefs_fd_find(&t, hash, path_match, paths[i]);
+            ok_find &= fd == fd_of[i];
+            if (fd_of[i] >= 0) {
+                bench_file_t* f = littlefs_fd_get(&t, fd_of[i]);
+                ok_get &= f != NULL && strcmp(f->path, paths[i]) == 0;
+            }
+            // Fara strcmp: orice fisier deschis cu acelasi hash (coliziunile din USE_ONLY_HASH)
+            int any = littlefs_fd_find(&t, hash, NULL, NULL);
+            ok_only_hash &= any < 0 ? fd_of[i] < 0 : (djb2(((bench_file_t*) littlefs_fd_get(&t, any))->path) %
+                                                         MODEL_HASHES) == hash;
+        }
+        ok_get &= t.count == open;
+    }
+    ok_bad &= littlefs_fd_get(&t, -1) == NULL && littlefs_fd_get(&t, t.size) == NULL &&
+              littlefs_fd_free(&t, t.size + 3) == NULL;
+
+    for (int i = 0; i < MODEL_PATHS; i++) {
+        if (fd_of[i] >= 0) {
+            free(littlefs_fd_free(&t, fd_of[i]));
+        }
+    }
+    bool ok_empty = t.count == 0 && littlefs_fd_find(&t, djb2(paths[0]) % MODEL_HASHES, NULL, NULL) < 0;
+    // Fara FD-uri pierdute: se umple exact cat ramasese
+    for (int i = 0; i < t.size; i++) {
+        ok_empty &= littlefs_fd_alloc(&t, paths[0], 0) >= 0;
+    }
+    ok_empty &= t.count == t.size;
+    littlefs_fd_deinit(&t);
+
+    char what[80];
+    snprintf(what, sizeof(what), "%d ops, up to %d open, %d hashes", ops, max_open, MODEL_HASHES);
+    bool ok = expect(ok_init, "init: LITTLEFS_FD_MIN_SIZE free slots");
+    ok &= expect(ok_get && ok_find, what);
+    ok &= expect(ok_only_hash, "find without match returns a file with that hash");
+    ok &= expect(ok_reuse, "last freed FD is the next one handed out");
+    ok &= expect(ok_bad, "double free / out of range / closed FD -> NULL");
+    ok &= expect(ok_empty, "all closed: nothing found, every slot allocatable");
+    return ok;
+}
+
+/**********************
+ *   MALLOC FAILURES
+ **********************/
+static bool check_malloc_failures(void) {
+    littlefs_fd_table_t t;
+    char                paths[LITTLEFS_FD_MIN_SIZE][PATH_MAX_];
+
+    s_fail_malloc = true;
+    bool ok_init  = littlefs_fd_init(&t) < 0 && t.size == 0 && littlefs_fd_alloc(&t, paths, 1) < 0 &&
+                   littlefs_fd_get(&t, 0) == NULL && littlefs_fd_find(&t, 1, NULL, NULL) < 0;
+    s_fail_malloc = false;
+
+    littlefs_fd_init(&t);
+    for (int i = 0; i < LITTLEFS_FD_MIN_SIZE; i++) {
+        snprintf(paths[i], sizeof(paths[i]), "/littlefs/g%d", i);
+        littlefs_fd_alloc(&t, file_new(paths[i]), djb2(paths[i]));
+    }
+    s_fail_malloc = true;
+    bool ok_grow  = littlefs_fd_alloc(&t, paths, 1) < 0 && t.size == LITTLEFS_FD_MIN_SIZE &&
+                   t.count == LITTLEFS_FD_MIN_SIZE;
+    for (int i = 0; i < LITTLEFS_FD_MIN_SIZE; i++) {
+        ok_grow &= littlefs_fd_find(&t, djb2(paths[i]), path_match, paths[i]) == i;
+    }
+    // Un FD eliberat se refoloseste fara alocare
+    free(littlefs_fd_free(&t, 2));
+    int fd = littlefs_fd_alloc(&t, file_new(paths[2]), djb2(paths[2]));
+    s_fail_malloc = false;
+    bool ok_after = fd == 2 && littlefs_fd_alloc(&t, paths, 1) == LITTLEFS_FD_MIN_SIZE &&
+                    t.size == 2 * LITTLEFS_FD_MIN_SIZE;
+    for (int i = 0; i < LITTLEFS_FD_MIN_SIZE; i++) {
+        ok_after &= littlefs_fd_find(&t, djb2(paths[i]), path_match, paths[i]) == i;
+        free(littlefs_fd_get(&t, i));
+    }
+    littlefs_fd_deinit(&t);
+
+    bool ok = expect(ok_init, "init fails: table unusable, size 0 (= not mounted)");
+    ok &= expect(ok_grow, "grow fails: alloc -1, open FDs and index unchanged");
+    ok &= expect(ok_after, "freed FD reused without malloc, grows once malloc works");
+    return ok;
+}
+
+/**********************
+ *   TABLE THROUGHPUT
+ **********************/
+typedef struct {
+    double open_close;  // Perechi open + close pe secunda
+    double lookup;      // Cautari dupa cale pe secunda
+} rate_t;
+
+static int    s_n;
+static char (*s_paths)[PATH_MAX_];
+static int*   s_order;
+static int*   s_fds;
+static volatile int s_sink;
+
+static rate_t run_old(int rounds, uint32_t seed) {
+    old_table_t t;
+    old_init(&t);
+    int64_t t0 = now_ns();
+    for (int r = 0; r < rounds; r++) {
+        for (int i = 0; i < s_n; i++) {
+            bench_file_t* f = file_new(s_paths[i]);
+            f->hash         = djb2(s_paths[i]);
+            s_fds[i]        = old_alloc(&t, f);
+        }
+        shuffle(s_order, s_n, &seed);
+        for (int i = 0; i < s_n; i++) {
+            free(old_free(&t, s_fds[s_order[i]]));
+        }
+    }
+    int64_t t1 = now_ns();
+
+    for (int i = 0; i < s_n; i++) {
+        bench_file_t* f = file_new(s_paths[i]);
+        f->hash         = djb2(s_paths[i]);
+        s_fds[i]        = old_alloc(&t, f);
+    }
+    // Jumatate deschise (EBUSY), jumatate cai care nu sunt deschise (unlink obisnuit)
+    int     lookups = rounds * s_n * 2;
+    int64_t t2      = now_ns();
+    for (int i = 0; i < lookups / 2; i++) {
+        s_sink += old_find(&t, s_paths[i % s_n]);
+        s_sink += old_find(&t, s_paths[s_n + i % s_n]);
+    }
+    int64_t t3 = now_ns();
+    for (int i = 0; i < s_n; i++) {
+        free(old_free(&t, s_fds[i]));
+    }
+    old_deinit(&t);
+    return (rate_t){(double) rounds * s_n * 1e9 / (double) (t1 - t0), (double) lookups * 1e9 / (double) (t3 - t2)};
+}
+//---------
+static rate_t run_new(int rounds, uint32_t seed, bool* ok) {
+    littlefs_fd_table_t t;
+    littlefs_fd_init(&t);
+    int64_t t0 = now_ns();
+    for (int r = 0; r < rounds; r++) {
+        for (int i = 0; i < s_n; i++) {
+            s_fds[i] = littlefs_fd_alloc(&t, file_new(s_paths[i]), djb2(s_paths[i]));
+        }
+        shuffle(s_order, s_n, &seed);
+        for (int i = 0; i < s_n; i++) {
+            free(littlefs_fd_free(&t, s_fds[s_order[i]]));
+        }
+    }
+    int64_t t1 = now_ns();
+
+    for (int i = 0; i < s_n; i++) {
+        s_fds[i] = littlefs_fd_alloc(&t, file_new(s_paths[i]), djb2(s_paths[i]));
+    }
+    int     lookups = rounds * s_n * 2;
+    int64_t t2      = now_ns();
+    for (int i = 0; i < lookups / 2; i++) {
+        const char* open   = s_paths[i % s_n];
+        const char* closed = s_paths[s_n + i % s_n];
+        s_sink += littlefs_fd_find(&t, djb2(open), path_match, open);
+        s_sink += littlefs_fd_find(&t, djb2(closed), path_match, closed);
+    }
+    int64_t t3 = now_ns();
+    for (int i = 0; i < s_n; i++) {
+        *ok &= littlefs_fd_find(&t, djb2(s_paths[i]), path_match, s_paths[i]) == s_fds[i] &&
+               littlefs_fd_find(&t, djb2(s_paths[s_n + i]), path_match, s_paths[s_n + i]) < 0;
+    }
+    for (int i = 0; i < s_n; i++) {
+        free(littlefs_fd_free(&t, s_fds[i]));
+    }
+    *ok &= t.count == 0 && t.size >= s_n;
+    littlefs_fd_deinit(&t);
+    return (rate_t){(double) rounds * s_n * 1e9 / (double) (t1 - t0), (double) lookups * 1e9 / (double) (t3 - t2)};
+}
+//---------
+static bool check_throughput(int ops, uint32_t seed) {
+    static const int counts[] = {16, 256, 1024, 4096};
+    bool             ok = true;
+    rate_t           last_old = {0}, last_new = {0};
+
+    printf("  %-10s %14s %14s %14s %14s\n", "open", "old open+close", "new open+close", "old lookup",
+        "new lookup");
+    for (size_t c = 0; c < sizeof(counts) / sizeof(counts[0]); c++) {
+        s_n     = counts[c];
+        s_paths = malloc(sizeof(*s_paths) * 2 * s_n);
+        s_order = malloc(sizeof(int) * s_n);
+        s_fds   = malloc(sizeof(int) * s_n);
+        for (int i = 0; i < 2 * s_n; i++) {
+            snprintf(s_paths[i], PATH_MAX_, "/littlefs/log/f%05d.txt", i);
+        }
+        for (int i = 0; i < s_n; i++) {
+            s_order[i] = i;
+        }
+        int rounds = ops / s_n > 0 ? ops / s_n : 1;
+        last_old   = run_old(rounds, seed);
+        last_new   = run_new(rounds, seed, &ok);
+        printf("  %-10d %12.0f/s %12.0f/s %12.0f/s %12.0f/s\n", s_n, last_old.open_close, last_new.open_close,
+            last_old.lookup, last_new.lookup);
+        free(s_paths);
+        free(s_order);
+        free(s_fds);
+    }
+    ok = expect(ok, "every open path found at its FD, closed paths not found");
+    // Pe N mare vechea cale e O(N) pe operatie; pragurile lasa loc pentru masini incarcate
+    ok &= expect(last_new.open_close > 2 * last_old.open_close, "4096 open: open+close > 2x the old cache + list");
+    ok &= expect(last_new.lookup > 4 * last_old.lookup, "4096 open: lookup by path > 4x the old linear scan");
+    return ok;
+}
+
+/**********************
+ *   LITTLEFS ON RAMBD
+ **********************/
+#define LFS_DIRS  (32)
+#define LFS_FILES (64)  // Pe director
+
+static lfs_t                  s_lfs;
+static lfs_rambd_t            s_bd;
+static struct lfs_rambd_config s_bd_cfg;
+static struct lfs_config      s_cfg;
+
+static bool lfs_setup(char (*paths)[PATH_MAX_], int n) {
+    s_bd_cfg = (struct lfs_rambd_config){
+        .read_size   = IO_SIZE,
+        .prog_size   = IO_SIZE,
+        .erase_size  = BLOCK_SIZE,
+        .erase_count = BLOCK_COUNT,
+    };
+    s_cfg = (struct lfs_config){
+        .context        = &s_bd,
+        .read           = lfs_rambd_read,
+        .prog           = lfs_rambd_prog,
+        .erase          = lfs_rambd_erase,
+        .sync           = lfs_rambd_sync,
+        .read_size      = IO_SIZE,
+        .prog_size      = IO_SIZE,
+        .block_size     = BLOCK_SIZE,
+        .block_count    = BLOCK_COUNT,
+        .block_cycles   = 512,
+        .cache_size     = CACHE_SIZE,
+        .lookahead_size = LOOKAHEAD,
+    };
+    if (lfs_rambd_create(&s_cfg, &s_bd_cfg) || lfs_format(&s_lfs, &s_cfg) || lfs_mount(&s_lfs, &s_cfg)) {
+        return false;
+    }
+    for (int d = 0; d < LFS_DIRS; d++) {
+        char dir[PATH_MAX_];
+        snprintf(dir, sizeof(dir), "/d%02d", d);
+        if (lfs_mkdir(&s_lfs, dir)) {
+            return false;
+        }
+    }
+    for (int i = 0; i < n; i++) {
+        lfs_file_t f;
+        snprintf(paths[i], PATH_MAX_, "/d%02d/f%03d.txt", i % LFS_DIRS, i / LFS_DIRS);
+        if (lfs_file_open(&s_lfs, &f, paths[i], LFS_O_WRONLY | LFS_O_CREAT) || lfs_file_close(&s_lfs, &f)) {
+            return false;
+        }
+    }
+    return true;
+}
+//---------
+/* Ce face vfs_littlefs_open / unlink / close: FD + lfs_file_opencfg, cautare dupa cale, close + FD */
+static double lfs_run_old(char (*paths)[PATH_MAX_], int n, int* order, int* fds, int rounds, uint32_t seed,
+    bool* ok) {
+    old_table_t t;
+    old_init(&t);
+    int64_t t0 = now_ns();
+    for (int r = 0; r < rounds; r++) {
+        for (int i = 0; i < n; i++) {
+            bench_file_t* f = file_new(paths[i]);
+            f->hash         = djb2(paths[i]);
+            fds[i]          = old_alloc(&t, f);
+            *ok &= lfs_file_opencfg(&s_lfs, &f->file, paths[i], LFS_O_RDONLY, &f->cfg) == 0;
+        }
+        shuffle(order, n, &seed);
+        for (int i = 0; i < n; i++) {
+            *ok &= old_find(&t, paths[order[i]]) == fds[order[i]];  // unlink -> EBUSY
+            bench_file_t* f = old_free(&t, fds[order[i]]);
+            *ok &= lfs_file_close(&s_lfs, &f->file) == 0;
+            free(f);
+        }
+    }
+    int64_t t1 = now_ns();
+    old_deinit(&t);
+    return (double) rounds * n * 1e9 / (double) (t1 - t0);
+}
+//---------
+static double lfs_run_new(char (*paths)[PATH_MAX_], int n, int* order, int* fds, int rounds, uint32_t seed,
+    bool* ok) {
+    littlefs_fd_table_t t;
+    littlefs_fd_init(&t);
+    int64_t t0 = now_ns();
+    for (int r = 0; r < rounds; r++) {
+        for (int i = 0; i < n; i++) {
+            bench_file_t* f = file_new(paths[i]);
+            fds[i]          = littlefs_fd_alloc(&t, f, djb2(paths[i]));
+            *ok &= lfs_file_opencfg(&s_lfs, &f->file, paths[i], LFS_O_RDONLY, &f->cfg) == 0;
+        }
+        shuffle(order, n, &seed);
+        for (int i = 0; i < n; i++) {
+            const char* path = paths[order[i]];
+            *ok &= littlefs_fd_find(&t, djb2(path), path_match, path) == fds[order[i]];
+            bench_file_t* f = littlefs_fd_free(&t, fds[order[i]]);
+            *ok &= lfs_file_close(&s_lfs, &f->file) == 0;
+            free(f);
+        }
+    }
+    int64_t t1 = now_ns();
+    *ok &= t.count == 0;
+    littlefs_fd_deinit(&t);
+    return (double) rounds * n * 1e9 / (double) (t1 - t0);
+}
+//---------
+static bool check_littlefs(int ops, uint32_t seed) {
+    static const int counts[] = {16, 256, 2048};
+    const int        max_n    = LFS_DIRS * LFS_FILES;
+    char (*paths)[PATH_MAX_]  = malloc(sizeof(*paths) * max_n);
+    int* order                = malloc(sizeof(int) * max_n);
+    int* fds                  = malloc(sizeof(int) * max_n);
+    bool ok_setup             = lfs_setup(paths, max_n);
+    bool ok_old = true, ok_new = true;
+
+    printf("  %-10s %14s %14s\n", "open", "old", "new");
+    for (size_t c = 0; c < sizeof(counts) / sizeof(counts[0]) && ok_setup; c++) {
+        int n = counts[c];
+        for (int i = 0; i < n; i++) {
+            order[i] = i;
+        }
+        // lfs_file_close cauta fisierul in lista lui littlefs, deci si aici ramane O(N)
+        int    rounds  = ops / 40 / n > 0 ? ops / 40 / n : 1;
+        double old_ops = lfs_run_old(paths, n, order, fds, rounds, seed, &ok_old);
+        double new_ops = lfs_run_new(paths, n, order, fds, rounds, seed, &ok_new);
+        printf("  %-10d %12.0f/s %12.0f/s   open + lookup + close\n", n, old_ops, new_ops);
+    }
+    if (ok_setup) {
+        lfs_unmount(&s_lfs);
+        lfs_rambd_destroy(&s_cfg);
+    }
+    free(paths);
+    free(order);
+    free(fds);
+
+    char what[80];
+    snprintf(what, sizeof(what), "%d files on lfs_rambd, %d dirs", max_n, LFS_DIRS);
+    bool ok = expect(ok_setup, what);
+    ok &= expect(ok_old && ok_new, "opencfg / close ok, open file found at its FD");
+    return ok;
+}
+
+int main(int argc, char** argv) {
+    int      ops  = 400000;
+    uint32_t seed = 0x5eed;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--ops") && i + 1 < argc) {
+            ops = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--seed") && i + 1 < argc) {
+            seed = (uint32_t) strtoul(argv[++i], NULL, 0);
+        } else {
+            fprintf(stderr, "usage: %s [--ops N] [--seed S]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (ops <= 0 || seed == 0) {
+        fprintf(stderr, "--ops must be > 0, --seed != 0\n");
+        return 2;
+    }
+
+    bool ok = true;
+    printf("FD table vs model:\n");
+    ok &= check_model(ops / 10, seed);
+    printf("\nmalloc failures:\n");
+    ok &= check_malloc_failures();
+    printf("\nFD table, ops/s:\n");
+    ok &= check_throughput(ops, seed);
+    printf("\nlittlefs on lfs_rambd, ops/s:\n");
+    ok &= check_littlefs(ops, seed);
+
+    printf("\n%s\n", ok ? "all checks passed" : "FAILED");
+    return ok ? 0 : 1;
+}
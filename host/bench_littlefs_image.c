@@ -0,0 +1,641 @@
+/*
+ * bench_littlefs_image - generatorul de imagini LittleFS din components/littlefs/tools/littlefs_mkimage.c
+ * si manifestul lui (components/littlefs/src/littlefs_manifest.c)
+ *
+ * Un arbore de asset-uri (texte inline, json-uri de un bloc, imagini, fonturi, sunete) e scris intr-un
+ * director temporar si dat lui littlefs_mkimage, ca in project_include.cmake.
+ *
+ *   1. imaginea montata cu lfs_filebd: fiecare fisier si director exact ca pe disc, fara fisiere de
+ *      padding ramase, si inca se poate scrie in ea
+ *   2. manifestul: citit din imagine = cel scris cu --manifest; un entry pentru fiecare fisier mare,
+ *      cu dimensiunea si crc-ul datelor; blocurile chiar consecutive (lantul CTZ din imagine) si aliniate;
+ *      span-urile din manifest dau continutul. Manifest stricat / alta geometrie = LFS_ERR_CORRUPT;
+ *      un entry deschis tine ocupate calea lui, directoarele ei si manifestul
+ *   3. acelasi arbore cu --align 64K (pagina MMU) pe 2 MiB; erori: fisier prea mare, cale rezervata,
+ *      argumente gresite
+ *   4. open + read pe imaginea din RAM (in locul partitiei mapate): lfs_file_open + lfs_file_read vs
+ *      lfs_file_open + littlefs_mmap_attach vs cautare in manifest + littlefs_mmap_attach_extent
+ *
+ * Usage: bench_littlefs_image [--rounds N]
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "bd/lfs_filebd.h"
+#include "bd/lfs_rambd.h"
+#include "lfs.h"
+#include "littlefs_manifest.h"
+#include "littlefs_mmap.h"
+
+#ifndef LITTLEFS_MKIMAGE
+#define LITTLEFS_MKIMAGE "littlefs_mkimage"
+#endif
+
+#define BLOCK_SIZE (4096)  // Ca CONFIG_LITTLEFS_BLOCK_SIZE
+#define IO_SIZE    (128)   // CONFIG_LITTLEFS_READ_SIZE / WRITE_SIZE
+#define CACHE_SIZE (512)   // CONFIG_LITTLEFS_CACHE_SIZE, si bufferul fiecarui fisier
+#define LOOKAHEAD  (128)
+#define PART_SIZE  (1024 * 1024)  // Partitia littlefs din partition.csv
+#define BIG_SIZE   (2 * 1024 * 1024)
+#define MAX_FILE   (200000)
+
+/**********************
+ *   HELPERS
+ **********************/
+static bool expect(bool cond, const char* what) {
+    printf("  %-64s %s\n", what, cond ? "ok" : "FAIL");
+    return cond;
+}
+//---------
+static int64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t) ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+//---------
+static int cmp_i64(const void* a, const void* b) {
+    int64_t x = *(const int64_t*) a, y = *(const int64_t*) b;
+    return (x > y) - (x < y);
+}
+//---------
+static uint8_t pattern(int id, uint32_t off) {
+    uint32_t x = (uint32_t) id * 0x9E3779B1u + off * 0x85EBCA6Bu;
+    return (uint8_t) (x ^ (x >> 13) ^ (x >> 24));
+}
+//---------
+static bool pattern_ok(int id, uint32_t off, const void* buf, size_t len) {
+    const uint8_t* p = (const uint8_t*) buf;
+    for (size_t i = 0; i < len; i++) {
+        if (p[i] != pattern(id, off + (uint32_t) i)) {
+            return false;
+        }
+    }
+    return true;
+}
+//---------
+static uint8_t* read_host(const char* path, size_t* size) {
+    FILE* f = fopen(path, "rb");
+    if (!f) {
+        return NULL;
+    }
+    fseek(f, 0, SEEK_END);
+    *size        = (size_t) ftell(f);
+    uint8_t* buf = malloc(*size ? *size : 1);
+    fseek(f, 0, SEEK_SET);
+    if (fread(buf, 1, *size, f) != *size) {
+        free(buf);
+        buf = NULL;
+    }
+    fclose(f);
+    return buf;
+}
+//---------
+/* Exit code-ul lui littlefs_mkimage, iesirea lui in /dev/null */
+static int mkimage(const char* args) {
+    char cmd[1024];
+    snprintf(cmd, sizeof(cmd), "\"%s\" %s >/dev/null 2>&1", LITTLEFS_MKIMAGE, args);
+    int st = system(cmd);
+    return WIFEXITED(st) ? WEXITSTATUS(st) : -1;
+}
+
+/**********************
+ *   ASSETS
+ **********************/
+typedef struct {
+    const char* path;  // NULL = director
+    const char* dir;
+    uint32_t    size;
+} asset_t;
+
+/* id = indexul. Mari (>= un bloc): in manifest; restul inline sau intr-un bloc, prin alocatorul normal */
+static const asset_t s_assets[] = {
+    {NULL, "/cfg", 0},
+    {NULL, "/img", 0},
+    {NULL, "/img/icons", 0},
+    {NULL, "/fonts", 0},
+    {NULL, "/snd", 0},
+    {"/readme.txt", NULL, 60},
+    {"/cfg/wifi.json", NULL, 300},
+    {"/cfg/ui.json", NULL, 2000},
+    {"/img/bg.bin", NULL, 153612},  // 320x240 RGB565 + antet
+    {"/img/splash.bin", NULL, 76812},
+    {"/img/icons/i0.bin", NULL, 4096},
+    {"/img/icons/i1.bin", NULL, 4097},
+    {"/img/icons/i2.bin", NULL, 5500},
+    {"/img/icons/i3.bin", NULL, 7000},
+    {"/img/icons/i4.bin", NULL, 8188},
+    {"/img/icons/i5.bin", NULL, 10000},
+    {"/img/icons/i6.bin", NULL, 11500},
+    {"/img/icons/i7.bin", NULL, 13000},
+    {"/fonts/roboto_24.bin", NULL, 90000},
+    {"/fonts/roboto_48.bin", NULL, MAX_FILE},
+    {"/snd/click.wav", NULL, 20000},
+};
+#define ASSETS ((int) (sizeof(s_assets) / sizeof(s_assets[0])))
+
+static bool asset_large(int id) {
+    return s_assets[id].path && s_assets[id].size >= BLOCK_SIZE;
+}
+//---------
+static bool write_tree(const char* root) {
+    static uint8_t buf[MAX_FILE];
+    char           host[512];
+    for (int id = 0; id < ASSETS; id++) {
+        const asset_t* a = &s_assets[id];
+        snprintf(host, sizeof(host), "%s%s", root, a->path ? a->path : a->dir);
+        if (!a->path) {
+            if (mkdir(host, 0755) != 0) {
+                return false;
+            }
+            continue;
+        }
+        for (uint32_t o = 0; o < a->size; o++) {
+            buf[o] = pattern(id, o);
+        }
+        FILE* f = fopen(host, "wb");
+        if (!f || fwrite(buf, 1, a->size, f) != a->size || fclose(f) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+//---------
+static void remove_tree(const char* root) {
+    char cmd[600];
+    snprintf(cmd, sizeof(cmd), "rm -rf \"%s\"", root);
+    if (system(cmd) != 0) {
+        fprintf(stderr, "cannot remove %s\n", root);
+    }
+}
+
+/**********************
+ *   IMAGE
+ **********************/
+static struct lfs_config make_cfg(void* bd, uint32_t size) {
+    return (struct lfs_config){
+        .context        = bd,
+        .read_size      = IO_SIZE,
+        .prog_size      = IO_SIZE,
+        .block_size     = BLOCK_SIZE,
+        .block_count    = size / BLOCK_SIZE,
+        .block_cycles   = 512,
+        .cache_size     = CACHE_SIZE,
+        .lookahead_size = LOOKAHEAD,
+        .name_max       = 64,  // CONFIG_LITTLEFS_OBJ_NAME_LEN
+    };
+}
+//---------
+/* Lantul CTZ al unui entry, citit din imagine: blocul i arata spre i - 1 */
+static bool chain_consecutive(const uint8_t* image, const littlefs_manifest_entry_t* e) {
+    for (uint32_t i = e->blocks - 1; i > 0; i--) {
+        uint32_t ptr;
+        memcpy(&ptr, image + (size_t) (e->first + i) * BLOCK_SIZE, sizeof(ptr));
+        if (lfs_fromle32(ptr) != e->first + i - 1) {
+            return false;
+        }
+    }
+    return true;
+}
+//---------
+static bool check_image(const char* image_path, const char* manifest_path, uint32_t size, uint32_t align) {
+    static uint8_t buf[MAX_FILE];
+    lfs_filebd_t   bd;
+    struct lfs_filebd_config bd_cfg = {IO_SIZE, IO_SIZE, BLOCK_SIZE, size / BLOCK_SIZE};
+    struct lfs_config        cfg    = make_cfg(&bd, size);
+    cfg.read                        = lfs_filebd_read;
+    cfg.prog                        = lfs_filebd_prog;
+    cfg.erase                       = lfs_filebd_erase;
+    cfg.sync                        = lfs_filebd_sync;
+    lfs_t lfs;
+    bool  ok = expect(lfs_filebd_create(&cfg, image_path, &bd_cfg) == 0 && lfs_mount(&lfs, &cfg) == 0,
+         "image mounts with lfs_filebd");
+    if (!ok) {
+        return false;
+    }
+
+    // 1. Continutul, prin littlefs
+    bool ok_files = true;
+    for (int id = 0; id < ASSETS; id++) {
+        const asset_t*  a = &s_assets[id];
+        struct lfs_info info;
+        if (!a->path) {
+            ok_files &= lfs_stat(&lfs, a->dir, &info) == 0 && info.type == LFS_TYPE_DIR;
+            continue;
+        }
+        lfs_file_t f;
+        ok_files &= lfs_file_open(&lfs, &f, a->path, LFS_O_RDONLY) == 0;
+        if (!ok_files) {
+            break;
+        }
+        lfs_ssize_t n = lfs_file_read(&lfs, &f, buf, sizeof(buf));
+        ok_files &= n == (lfs_ssize_t) a->size && pattern_ok(id, 0, buf, a->size);
+        lfs_file_close(&lfs, &f);
+    }
+    ok &= expect(ok_files, "every file and directory as in the source tree");
+
+    // Nimic in plus: doar arborele si manifestul
+    int entries = 0;
+    bool ok_extra = true;
+    const char* dirs[] = {"/", "/cfg", "/img", "/img/icons", "/fonts", "/snd"};
+    for (size_t d = 0; d < sizeof(dirs) / sizeof(dirs[0]); d++) {
+        lfs_dir_t       dir;
+        struct lfs_info info;
+        ok_extra &= lfs_dir_open(&lfs, &dir, dirs[d]) == 0;
+        while (ok_extra && lfs_dir_read(&lfs, &dir, &info) > 0) {
+            if (strcmp(info.name, ".") && strcmp(info.name, "..")) {
+                entries++;
+                ok_extra &= strncmp(info.name, ".pad", 4) != 0;
+            }
+        }
+        lfs_dir_close(&lfs, &dir);
+    }
+    ok &= expect(ok_extra && entries == ASSETS + 1, "nothing else in the image but the manifest, no padding left");
+
+    // 2. Manifestul
+    lfs_file_t  f;
+    lfs_ssize_t msize = -1;
+    if (lfs_file_open(&lfs, &f, LITTLEFS_MANIFEST_PATH, LFS_O_RDONLY) == 0) {
+        msize = lfs_file_read(&lfs, &f, buf, sizeof(buf));
+        lfs_file_close(&lfs, &f);
+    }
+    if (manifest_path) {
+        size_t   fsize;
+        uint8_t* file = read_host(manifest_path, &fsize);
+        ok &= expect(file && msize == (lfs_ssize_t) fsize && memcmp(file, buf, fsize) == 0,
+            "manifest in the image == the one written with --manifest");
+        free(file);
+    }
+
+    size_t   isize;
+    uint8_t* image  = read_host(image_path, &isize);
+    void*    mdata  = malloc(msize > 0 ? (size_t) msize : 1);
+    memcpy(mdata, buf, msize > 0 ? (size_t) msize : 0);
+    littlefs_manifest_t m;
+    ok &= expect(image && isize == size && msize > 0 &&
+                     littlefs_manifest_load(&m, mdata, (lfs_size_t) msize, BLOCK_SIZE, size / BLOCK_SIZE) == 0,
+        "manifest loads");
+    if (!image || !m.header) {
+        free(image);
+        lfs_unmount(&lfs);
+        lfs_filebd_destroy(&cfg);
+        return false;
+    }
+
+    bool     ok_entries = true, ok_layout = true, ok_spans = true;
+    uint32_t large      = 0;
+    for (int id = 0; id < ASSETS; id++) {
+        const asset_t* a = &s_assets[id];
+        const littlefs_manifest_entry_t* e = littlefs_manifest_find(&m, a->path ? a->path : a->dir);
+        if (!asset_large(id)) {
+            ok_entries &= e == NULL;
+            continue;
+        }
+        large++;
+        ok_entries &= e && e->size == a->size && !strcmp(m.names + e->name, a->path);
+        if (!e) {
+            continue;
+        }
+        ok_layout &= e->first % (align / BLOCK_SIZE) == 0 && chain_consecutive(image, e);
+
+        // Span-urile din manifest, fara littlefs: continutul si crc-ul
+        littlefs_mmap_t map;
+        uint32_t        crc = 0xffffffff, off = 0;
+        ok_spans &= littlefs_mmap_attach_extent(&map, image, BLOCK_SIZE, e->first, e->blocks, e->size) == 0;
+        while (ok_spans && off < e->size) {
+            const void* d;
+            lfs_ssize_t n = littlefs_mmap_span(&map, off, &d);
+            ok_spans &= n > 0 && pattern_ok(id, off, d, (size_t) n);
+            crc = lfs_crc(crc, d, n > 0 ? (size_t) n : 0);
+            off += n > 0 ? (uint32_t) n : e->size;
+        }
+        ok_spans &= crc == e->crc;
+        littlefs_mmap_detach(&map);
+    }
+    char what[96];
+    snprintf(what, sizeof(what), "one entry per large file (%u), with its size and path; none else", large);
+    ok &= expect(ok_entries && m.header->count == large, what);
+    snprintf(what, sizeof(what), "blocks consecutive in the CTZ chain, first block %u KiB aligned", align / 1024);
+    ok &= expect(ok_layout, what);
+    ok &= expect(ok_spans, "spans from the manifest alone: right bytes, crc as recorded");
+    ok &= expect(!littlefs_manifest_find(&m, "/nope.bin") && !littlefs_manifest_find(&m, "/img/bg") &&
+                     !littlefs_manifest_find(&m, LITTLEFS_MANIFEST_PATH),
+        "missing paths, prefixes and the manifest itself not found");
+
+    // Stricat: un octet din nume, alta geometrie, trunchiat
+    bool ok_corrupt = true;
+    for (int k = 0; k < 3; k++) {
+        void* copy = malloc((size_t) msize);
+        memcpy(copy, buf, (size_t) msize);
+        lfs_size_t csize = (lfs_size_t) msize, count = size / BLOCK_SIZE;
+        if (k == 0) {
+            ((uint8_t*) copy)[msize - 3] ^= 0x20;
+        } else if (k == 1) {
+            count *= 2;
+        } else {
+            csize -= 2;
+        }
+        littlefs_manifest_t bad;
+        ok_corrupt &= littlefs_manifest_load(&bad, copy, csize, BLOCK_SIZE, count) == LFS_ERR_CORRUPT && !bad.header &&
+                      !littlefs_manifest_find(&bad, s_assets[8].path);
+    }
+    ok &= expect(ok_corrupt, "damaged, other geometry, truncated: LFS_ERR_CORRUPT, empty");
+
+    // Handle deschis pe /img/bg.bin: fisierul, /img, / si manifestul sunt ocupate, /img/splash.bin nu.
+    // Dupa drop-ul lui splash bg ramane gasit si ocupat; dupa close bg se poate si el scoate.
+    const char*                      bg   = s_assets[8].path;
+    const littlefs_manifest_entry_t* held = littlefs_manifest_acquire(&m, bg);
+    bool ok_busy = held && littlefs_manifest_busy(&m, bg) && littlefs_manifest_busy(&m, "/img") &&
+                   littlefs_manifest_busy(&m, "/") && littlefs_manifest_busy(&m, LITTLEFS_MANIFEST_PATH) &&
+                   !littlefs_manifest_busy(&m, s_assets[9].path) && !littlefs_manifest_busy(&m, "/im") &&
+                   !littlefs_manifest_busy(&m, "/img/bg") && !littlefs_manifest_busy(&m, "/nope.bin");
+    ok_busy &= littlefs_manifest_drop(&m, s_assets[9].path) == 1 && !littlefs_manifest_find(&m, s_assets[9].path) &&
+               littlefs_manifest_find(&m, bg) == held && littlefs_manifest_busy(&m, bg);
+    if (held) {
+        littlefs_manifest_release(&m, held);
+    }
+    uint32_t in_img = 0;  // Mari sub /img, fara splash
+    for (int id = 10; id < ASSETS; id++) {
+        in_img += asset_large(id) && !strncmp(s_assets[id].path, "/img/", 5);
+    }
+    ok_busy &= !littlefs_manifest_busy(&m, bg) && !littlefs_manifest_busy(&m, LITTLEFS_MANIFEST_PATH) &&
+               littlefs_manifest_drop(&m, "/img") == in_img + 1 && !littlefs_manifest_find(&m, bg) &&
+               littlefs_manifest_drop(&m, LITTLEFS_MANIFEST_PATH) == large - in_img - 2 && m.live == 0;
+    ok &= expect(ok_busy, "open entries guard their path and directories; drop the rest");
+    littlefs_manifest_free(&m);
+
+    // O imagine littlefs obisnuita: se scrie in ea si se remonteaza
+    bool ok_write = lfs_file_open(&lfs, &f, "/new.txt", LFS_O_WRONLY | LFS_O_CREAT) == 0 &&
+                    lfs_file_write(&lfs, &f, "hello", 5) == 5 && lfs_file_close(&lfs, &f) == 0 &&
+                    lfs_remove(&lfs, "/readme.txt") == 0 && lfs_unmount(&lfs) == 0 && lfs_mount(&lfs, &cfg) == 0;
+    struct lfs_info info;
+    ok_write &= lfs_stat(&lfs, "/new.txt", &info) == 0 && info.size == 5 && lfs_stat(&lfs, "/readme.txt", &info) < 0;
+    ok &= expect(ok_write, "still an ordinary littlefs: write, remove, remount");
+
+    free(image);
+    lfs_unmount(&lfs);
+    lfs_filebd_destroy(&cfg);
+    return ok;
+}
+
+/**********************
+ *   BASELINE
+ **********************/
+/* Ce face littlefs-python create: directoarele si fisierele in ordinea arborelui, alocatorul normal */
+static void plain_image(uint8_t* image, uint32_t* consecutive, uint32_t* aligned64) {
+    static uint8_t buf[MAX_FILE];
+    lfs_rambd_t    bd;
+    struct lfs_rambd_config bd_cfg = {IO_SIZE, IO_SIZE, BLOCK_SIZE, PART_SIZE / BLOCK_SIZE, image};
+    struct lfs_config       cfg    = make_cfg(&bd, PART_SIZE);
+    cfg.read                       = lfs_rambd_read;
+    cfg.prog                       = lfs_rambd_prog;
+    cfg.erase                      = lfs_rambd_erase;
+    cfg.sync                       = lfs_rambd_sync;
+    lfs_t lfs;
+    lfs_rambd_create(&cfg, &bd_cfg);
+    memset(image, 0xff, PART_SIZE);  // Flash sters
+    lfs_format(&lfs, &cfg);
+    lfs_mount(&lfs, &cfg);
+    *consecutive = *aligned64 = 0;
+    for (int id = 0; id < ASSETS; id++) {
+        const asset_t* a = &s_assets[id];
+        if (!a->path) {
+            lfs_mkdir(&lfs, a->dir);
+            continue;
+        }
+        lfs_file_t f;
+        for (uint32_t o = 0; o < a->size; o++) {
+            buf[o] = pattern(id, o);
+        }
+        lfs_file_open(&lfs, &f, a->path, LFS_O_WRONLY | LFS_O_CREAT);
+        lfs_file_write(&lfs, &f, buf, a->size);
+        lfs_file_sync(&lfs, &f);
+        littlefs_mmap_t map;
+        if (asset_large(id) && littlefs_mmap_attach(&map, &lfs, &f, image) == 0 && littlefs_mmap_mapped(&map)) {
+            // Lantul CTZ, rezolvat la atasare: un span pe bloc
+            uint32_t n = 0;
+            for (uint32_t off = 0; off < a->size; n++) {
+                const void* d;
+                off += (uint32_t) littlefs_mmap_span(&map, off, &d);
+            }
+            bool cons = true;
+            for (uint32_t i = 1; i < n; i++) {
+                cons &= map.blocks[i] == map.blocks[0] + i;
+            }
+            *consecutive += cons;
+            *aligned64 += cons && map.blocks[0] % 16 == 0;
+            littlefs_mmap_detach(&map);
+        }
+        lfs_file_close(&lfs, &f);
+    }
+    lfs_unmount(&lfs);
+    lfs_rambd_destroy(&cfg);
+}
+
+/**********************
+ *   LATENCY
+ **********************/
+typedef enum { OPEN_LFS, OPEN_LFS_MMAP, OPEN_MANIFEST } open_mode_t;
+
+static const char* s_mode_names[] = {"lfs_file_open+read", "lfs_file_open+mmap", "manifest+extent"};
+
+static bool latency(const uint8_t* src, int rounds) {
+    static uint8_t buf[MAX_FILE];
+    uint8_t*       image = malloc(PART_SIZE);
+    lfs_rambd_t    bd;
+    struct lfs_rambd_config bd_cfg = {IO_SIZE, IO_SIZE, BLOCK_SIZE, PART_SIZE / BLOCK_SIZE, image};
+    struct lfs_config       cfg    = make_cfg(&bd, PART_SIZE);
+    cfg.read                       = lfs_rambd_read;
+    cfg.prog                       = lfs_rambd_prog;
+    cfg.erase                      = lfs_rambd_erase;
+    cfg.sync                       = lfs_rambd_sync;
+    lfs_t lfs;
+    bool  ok = lfs_rambd_create(&cfg, &bd_cfg) == 0;
+    memcpy(image, src, PART_SIZE);  // lfs_rambd_create il sterge
+    ok &= lfs_mount(&lfs, &cfg) == 0;
+
+    lfs_file_t  f;
+    lfs_ssize_t msize = -1;
+    if (ok && lfs_file_open(&lfs, &f, LITTLEFS_MANIFEST_PATH, LFS_O_RDONLY) == 0) {
+        msize = lfs_file_read(&lfs, &f, buf, sizeof(buf));
+        lfs_file_close(&lfs, &f);
+    }
+    littlefs_manifest_t m = {0};
+    void*               mdata = malloc(msize > 0 ? (size_t) msize : 1);
+    memcpy(mdata, buf, msize > 0 ? (size_t) msize : 0);
+    ok &= msize > 0 && littlefs_manifest_load(&m, mdata, (lfs_size_t) msize, BLOCK_SIZE, PART_SIZE / BLOCK_SIZE) == 0;
+    if (!ok) {
+        free(image);
+        return expect(false, "image on lfs_rambd, manifest loaded");
+    }
+
+    int large[ASSETS], nlarge = 0;
+    for (int id = 0; id < ASSETS; id++) {
+        if (asset_large(id)) {
+            large[nlarge++] = id;
+        }
+    }
+    int      samples = rounds * nlarge;
+    int64_t* t_open  = malloc(sizeof(int64_t) * (size_t) samples);
+    int64_t* t_small = malloc(sizeof(int64_t) * (size_t) samples);  // open + read de un fisier < 16 KiB
+    double   p50_open[3], p50_small[3], mb_s[3];
+    bool     ok_data = true;
+
+    printf("  %-20s %12s %12s %16s %10s\n", "path", "open p50 ns", "open p99 ns", "icon open+read us", "MB/s");
+    for (int mode = 0; mode < 3; mode++) {
+        uint64_t bytes = 0;
+        int      n = 0, ns = 0;
+        int64_t  total = 0;
+        for (int r = 0; r < rounds; r++) {
+            for (int k = 0; k < nlarge; k++) {
+                int            id = large[k];
+                const asset_t* a  = &s_assets[id];
+                uint32_t       sum = 0;
+                uint8_t        fbuf[CACHE_SIZE];
+                struct lfs_file_config fcfg = {.buffer = fbuf};  // littlefs il tine pana la close
+                littlefs_mmap_t map;
+                int64_t        t0 = now_ns(), t1;
+                if (mode == OPEN_MANIFEST) {
+                    const littlefs_manifest_entry_t* e = littlefs_manifest_find(&m, a->path);
+                    ok_data &= e && littlefs_mmap_attach_extent(&map, image, BLOCK_SIZE, e->first, e->blocks, e->size) == 0;
+                } else {
+                    ok_data &= lfs_file_opencfg(&lfs, &f, a->path, LFS_O_RDONLY, &fcfg) == 0;
+                    if (mode == OPEN_LFS_MMAP) {
+                        ok_data &= littlefs_mmap_attach(&map, &lfs, &f, image) == 0;
+                    }
+                }
+                t1 = now_ns();
+                if (mode == OPEN_LFS) {
+                    lfs_ssize_t got = lfs_file_read(&lfs, &f, buf, a->size);
+                    ok_data &= got == (lfs_ssize_t) a->size;
+                    sum += buf[0] + buf[a->size - 1];
+                } else {
+                    for (uint32_t off = 0; off < a->size;) {
+                        const void* d;
+                        lfs_ssize_t got = littlefs_mmap_span(&map, off, &d);
+                        if (got <= 0) {
+                            ok_data = false;
+                            break;
+                        }
+                        sum += ((const uint8_t*) d)[0] + ((const uint8_t*) d)[got - 1];
+                        off += (uint32_t) got;
+                    }
+                    littlefs_mmap_detach(&map);
+                }
+                if (mode != OPEN_MANIFEST) {
+                    lfs_file_close(&lfs, &f);
+                }
+                int64_t t2 = now_ns();
+                ok_data &= sum != 0xFFFFFFFFu;
+                t_open[n++] = t1 - t0;
+                if (a->size < 16384) {
+                    t_small[ns++] = t2 - t0;
+                }
+                total += t2 - t0;
+                bytes += a->size;
+            }
+        }
+        qsort(t_open, (size_t) n, sizeof(int64_t), cmp_i64);
+        qsort(t_small, (size_t) ns, sizeof(int64_t), cmp_i64);
+        p50_open[mode]  = (double) t_open[n / 2];
+        p50_small[mode] = (double) t_small[ns / 2] / 1000.0;
+        mb_s[mode]      = (double) bytes / ((double) total / 1e9) / 1e6;
+        printf("  %-20s %12.0f %12lld %16.2f %10.0f\n", s_mode_names[mode], p50_open[mode], (long long) t_open[n * 99 / 100],
+            p50_small[mode], mb_s[mode]);
+    }
+    free(t_open);
+    free(t_small);
+    littlefs_manifest_free(&m);
+    lfs_unmount(&lfs);
+    lfs_rambd_destroy(&cfg);
+    free(image);
+
+    ok &= expect(ok_data, "every open and read succeeded");
+    ok &= expect(p50_open[OPEN_MANIFEST] * 4 < p50_open[OPEN_LFS], "manifest lookup: open at least 4x faster than lfs_file_open");
+    ok &= expect(p50_small[OPEN_MANIFEST] * 4 < p50_small[OPEN_LFS] && p50_small[OPEN_MANIFEST] * 4 < p50_small[OPEN_LFS_MMAP],
+        "icon open+read: manifest at least 4x faster than both lfs opens");
+    return ok;
+}
+
+int main(int argc, char** argv) {
+    int rounds = 300;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--rounds") && i + 1 < argc) {
+            rounds = atoi(argv[++i]);
+        } else {
+            fprintf(stderr, "usage: %s [--rounds N]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (rounds <= 0) {
+        fprintf(stderr, "--rounds > 0\n");
+        return 2;
+    }
+
+    char root[] = "/tmp/bench_littlefs_image.XXXXXX";
+    if (!mkdtemp(root)) {
+        perror("mkdtemp");
+        return 1;
+    }
+    char tree[300], image[300], image64[300], manifest[300], args[1024];
+    snprintf(tree, sizeof(tree), "%s/data", root);
+    snprintf(image, sizeof(image), "%s/littlefs.bin", root);
+    snprintf(image64, sizeof(image64), "%s/littlefs64.bin", root);
+    snprintf(manifest, sizeof(manifest), "%s/manifest.bin", root);
+
+    bool ok = expect(mkdir(tree, 0755) == 0 && write_tree(tree), "asset tree written");
+    printf("\nimage, 1 MiB, default alignment:\n");
+    snprintf(args, sizeof(args), "\"%s\" \"%s\" --size 0x100000 --manifest \"%s\"", tree, image, manifest);
+    ok &= expect(mkimage(args) == 0, "littlefs_mkimage");
+    ok &= check_image(image, manifest, PART_SIZE, BLOCK_SIZE);
+
+    printf("\nimage, 2 MiB, --align 64K:\n");
+    snprintf(args, sizeof(args), "\"%s\" \"%s\" --size 2M --align 64K", tree, image64);
+    ok &= expect(mkimage(args) == 0, "littlefs_mkimage --align 64K");
+    ok &= check_image(image64, NULL, BIG_SIZE, 64 * 1024);
+
+    printf("\nerrors:\n");
+    snprintf(args, sizeof(args), "\"%s\" \"%s/x.bin\" --size 256K", tree, root);
+    ok &= expect(mkimage(args) == 1, "tree larger than the image: exit 1");
+    snprintf(args, sizeof(args), "\"%s\" \"%s/x.bin\" --size 1M --align 6K", tree, root);
+    ok &= expect(mkimage(args) == 2, "alignment not a multiple of the block: exit 2");
+    snprintf(args, sizeof(args), "\"%s/missing\" \"%s/x.bin\" --size 1M", root, root);
+    ok &= expect(mkimage(args) == 1, "missing source directory: exit 1");
+    char reserved[400];
+    snprintf(reserved, sizeof(reserved), "%s%s", tree, LITTLEFS_MANIFEST_PATH);
+    FILE* rf = fopen(reserved, "wb");
+    if (rf) {
+        fclose(rf);
+    }
+    snprintf(args, sizeof(args), "\"%s\" \"%s/x.bin\" --size 1M", tree, root);
+    ok &= expect(mkimage(args) == 1, LITTLEFS_MANIFEST_PATH " in the source tree: exit 1");
+    unlink(reserved);
+
+    printf("\nlayout of the large files:\n");
+    size_t   isize;
+    uint8_t* img = read_host(image, &isize);
+    uint8_t* plain = malloc(PART_SIZE);
+    uint32_t cons, al64, nlarge = 0;
+    for (int id = 0; id < ASSETS; id++) {
+        nlarge += asset_large(id);
+    }
+    plain_image(plain, &cons, &al64);
+    printf("  plain littlefs writer: %u of %u on consecutive blocks, %u of them 64 KiB aligned, no manifest\n", cons, nlarge, al64);
+    printf("  littlefs_mkimage:      %u of %u on consecutive blocks, checked, in the manifest\n", nlarge, nlarge);
+    free(plain);
+
+    printf("\nopen + read of the %u large files on lfs_rambd x %d:\n", nlarge, rounds);
+    ok &= img && isize == PART_SIZE && latency(img, rounds);
+    free(img);
+
+    remove_tree(root);
+    printf("\n%s\n", ok ? "all checks passed" : "FAILED");
+    return ok ? 0 : 1;
+}
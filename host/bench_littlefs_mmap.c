@@ -0,0 +1,558 @@
+/*
+ * bench_littlefs_mmap - citiri fara copiere din partitia LittleFS mapata: components/littlefs/src/
+ * littlefs_mmap.c si drive-ul LVGL din mylibs/filesystem-v003/src/lv_fs_littlefs.c
+ *
+ * Partitia e un lfs_rambd: un singur buffer, ca esp_partition_mmap pe placa. esp_littlefs_mmap_*
+ * (esp_littlefs.c, doar ESP-IDF) sunt refacute aici peste acelasi littlefs_mmap_t.
+ *
+ *   1. span-uri: fiecare fisier (gol, inline, un bloc, doua, zeci) parcurs span cu span: pointeri in
+ *      buffer, continut corect, un span pe bloc, fisierele de cel mult un bloc intr-un singur span
+ *   2. get pe intervale aleatoare, verificate: fara copiere cand intervalul e intr-un bloc, copiat
+ *      altfel; inline si partitie nemapata trec prin littlefs. Pointer corupt = LFS_ERR_CORRUPT.
+ *      Span-urile unui fisier deschis raman valide cat timp alte fisiere sunt scrise / sterse
+ *   3. drive-ul LVGL: lv_fs_open / read / seek / tell pe "L:/...", scrierea refuzata, imaginea mica
+ *      ca lv_image_dsc_t direct din flash, cea mare refuzata
+ *   4. citirea tuturor fisierelor mari: lfs_file_read vs get + memcpy (drive-ul LVGL) vs span-uri,
+ *      cu octetii copiati de littlefs / block device si cei dati direct din mapare
+ *
+ * Usage: bench_littlefs_mmap [--rounds N] [--seed S]
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "bd/lfs_rambd.h"
+#include "esp_littlefs_mmap.h"
+#include "lfs.h"
+#include "littlefs_mmap.h"
+#include "lv_fs_littlefs.h"
+#include "lvgl.h"
+
+#define BLOCK_SIZE  (4096)  // Ca CONFIG_LITTLEFS_BLOCK_SIZE
+#define BLOCK_COUNT (256)   // 1 MiB, ca partitia littlefs din partition.csv
+#define IO_SIZE     (128)   // CONFIG_LITTLEFS_READ_SIZE / WRITE_SIZE
+#define CACHE_SIZE  (512)   // CONFIG_LITTLEFS_CACHE_SIZE, si bufferul fiecarui fisier
+#define LOOKAHEAD   (128)
+#define CHUNK       (1024)  // Cat cere un decodor LVGL pe apel, cam
+
+#define ICON_W (40)  // 40x40 RGB565: 3212 octeti, un bloc
+#define IMG_W  (100) // 100x100 RGB565: 20012 octeti, 5 blocuri
+
+/**********************
+ *   HELPERS
+ **********************/
+static bool expect(bool cond, const char* what) {
+    printf("  %-64s %s\n", what, cond ? "ok" : "FAIL");
+    return cond;
+}
+//---------
+static int64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t) ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+//---------
+static uint32_t rnd(uint32_t* state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 17;
+    *state ^= *state << 5;
+    return *state;
+}
+//---------
+static uint8_t pattern(int id, uint32_t off) {
+    uint32_t x = (uint32_t) id * 0x9E3779B1u + off * 0x85EBCA6Bu;
+    return (uint8_t) (x ^ (x >> 13) ^ (x >> 24));
+}
+
+/**********************
+ *   FLASH
+ **********************/
+static lfs_rambd_t              s_bd;
+static struct lfs_rambd_config  s_bd_cfg;
+static struct lfs_config        s_cfg;
+static lfs_t                    s_lfs;
+static const uint8_t*           s_base;       // "Maparea"; NULL = ca fara CONFIG_LITTLEFS_MMAP_PARTITION
+static uint64_t                 s_bd_copied;  // Octeti copiati de block device in cache-urile littlefs
+
+static int bench_read(const struct lfs_config* c, lfs_block_t block, lfs_off_t off, void* buf, lfs_size_t size) {
+    s_bd_copied += size;
+    return lfs_rambd_read(c, block, off, buf, size);
+}
+//---------
+static bool in_mapping(const void* p, size_t len) {
+    const uint8_t* b = (const uint8_t*) p;
+    return b >= s_bd.buffer && b + len <= s_bd.buffer + (size_t) BLOCK_SIZE * BLOCK_COUNT;
+}
+
+typedef struct {
+    const char* path;
+    uint32_t    size;
+    bool        image;  // .bin LVGL RGB565, patratul de latura size
+} asset_t;
+
+/* id = indexul; dimensiunile acopera fiecare caz al span-urilor */
+static const asset_t s_assets[] = {
+    {"/empty.bin", 0, false},
+    {"/cfg.txt", 100, false},     // Inline in director
+    {"/icon.bin", ICON_W, true},  // Un bloc
+    {"/one.bin", BLOCK_SIZE, false},
+    {"/two.bin", BLOCK_SIZE + 1, false},
+    {"/img.bin", IMG_W, true},
+    {"/font.bin", 60000, false},
+    {"/big.bin", 300000, false},
+};
+#define ASSETS ((int) (sizeof(s_assets) / sizeof(s_assets[0])))
+
+static uint32_t asset_size(int id) {
+    const asset_t* a = &s_assets[id];
+    return a->image ? (uint32_t) (sizeof(lv_image_header_t) + a->size * a->size * 2) : a->size;
+}
+//---------
+/* Continutul: antet LVGL pentru imagini, apoi pattern(id, off) peste tot restul */
+static void asset_fill(int id, uint8_t* buf) {
+    uint32_t size = asset_size(id);
+    for (uint32_t o = 0; o < size; o++) {
+        buf[o] = pattern(id, o);
+    }
+    if (s_assets[id].image) {
+        lv_image_header_t h = {0};
+        h.magic             = LV_IMAGE_HEADER_MAGIC;
+        h.cf                = LV_COLOR_FORMAT_RGB565;
+        h.w                 = s_assets[id].size;
+        h.h                 = s_assets[id].size;
+        h.stride            = s_assets[id].size * 2;
+        memcpy(buf, &h, sizeof(h));
+    }
+}
+//---------
+static bool asset_ok(int id, uint32_t off, const void* data, size_t len) {
+    static uint8_t ref[300000];
+    asset_fill(id, ref);
+    return off + len <= asset_size(id) && memcmp(ref + off, data, len) == 0;
+}
+//---------
+static bool fs_setup(void) {
+    s_bd_cfg = (struct lfs_rambd_config){
+        .read_size   = IO_SIZE,
+        .prog_size   = IO_SIZE,
+        .erase_size  = BLOCK_SIZE,
+        .erase_count = BLOCK_COUNT,
+    };
+    s_cfg = (struct lfs_config){
+        .context        = &s_bd,
+        .read           = bench_read,
+        .prog           = lfs_rambd_prog,
+        .erase          = lfs_rambd_erase,
+        .sync           = lfs_rambd_sync,
+        .read_size      = IO_SIZE,
+        .prog_size      = IO_SIZE,
+        .block_size     = BLOCK_SIZE,
+        .block_count    = BLOCK_COUNT,
+        .block_cycles   = 512,
+        .cache_size     = CACHE_SIZE,
+        .lookahead_size = LOOKAHEAD,
+    };
+    if (lfs_rambd_create(&s_cfg, &s_bd_cfg) || lfs_format(&s_lfs, &s_cfg) || lfs_mount(&s_lfs, &s_cfg)) {
+        return false;
+    }
+    static uint8_t data[300000];
+    for (int id = 0; id < ASSETS; id++) {
+        lfs_file_t f;
+        asset_fill(id, data);
+        if (lfs_file_open(&s_lfs, &f, s_assets[id].path, LFS_O_WRONLY | LFS_O_CREAT) ||
+            lfs_file_write(&s_lfs, &f, data, asset_size(id)) != (lfs_ssize_t) asset_size(id) ||
+            lfs_file_close(&s_lfs, &f)) {
+            return false;
+        }
+    }
+    s_base = s_bd.buffer;
+    return true;
+}
+
+/**********************
+ *   esp_littlefs_mmap_* PE HOST
+ **********************/
+/* Ca in esp_littlefs.c: un FD read-only si span-urile lui; pread pentru ce nu e mapat */
+struct esp_littlefs_mmap {
+    lfs_file_t             file;
+    struct lfs_file_config cfg;
+    uint8_t                buffer[CACHE_SIZE];
+    littlefs_mmap_t        map;
+};
+
+static lfs_ssize_t host_pread(void* ctx, lfs_off_t off, void* buf, lfs_size_t size) {
+    esp_littlefs_mmap_handle_t handle = (esp_littlefs_mmap_handle_t) ctx;
+    lfs_soff_t                 res    = lfs_file_seek(&s_lfs, &handle->file, off, LFS_SEEK_SET);
+    return res < 0 ? res : lfs_file_read(&s_lfs, &handle->file, buf, size);
+}
+//---------
+esp_err_t esp_littlefs_mmap_open(const char* partition_label, const char* path, esp_littlefs_mmap_handle_t* ret_handle) {
+    (void) partition_label;
+    esp_littlefs_mmap_handle_t handle = calloc(1, sizeof(*handle));
+    handle->cfg.buffer                = handle->buffer;
+    if (lfs_file_opencfg(&s_lfs, &handle->file, path, LFS_O_RDONLY, &handle->cfg) < 0) {
+        free(handle);
+        return ESP_ERR_NOT_FOUND;
+    }
+    int res = littlefs_mmap_attach(&handle->map, &s_lfs, &handle->file, s_base);
+    if (res < 0) {
+        lfs_file_close(&s_lfs, &handle->file);
+        free(handle);
+        return res == LFS_ERR_NOMEM ? ESP_ERR_NO_MEM : ESP_FAIL;
+    }
+    *ret_handle = handle;
+    return ESP_OK;
+}
+//---------
+esp_err_t esp_littlefs_mmap_close(esp_littlefs_mmap_handle_t handle) {
+    littlefs_mmap_detach(&handle->map);
+    int res = lfs_file_close(&s_lfs, &handle->file);
+    free(handle);
+    return res < 0 ? ESP_FAIL : ESP_OK;
+}
+//---------
+size_t esp_littlefs_mmap_size(esp_littlefs_mmap_handle_t handle) {
+    return handle->map.size;
+}
+//---------
+bool esp_littlefs_mmap_is_mapped(esp_littlefs_mmap_handle_t handle) {
+    return littlefs_mmap_mapped(&handle->map);
+}
+//---------
+ssize_t esp_littlefs_mmap_span(esp_littlefs_mmap_handle_t handle, size_t offset, const void** data) {
+    lfs_ssize_t res = littlefs_mmap_span(&handle->map, offset, data);
+    return res < 0 ? -1 : res;
+}
+//---------
+ssize_t esp_littlefs_mmap_get(esp_littlefs_mmap_handle_t handle, size_t offset, size_t size, void* buf, const void** data) {
+    lfs_ssize_t res = littlefs_mmap_get(&handle->map, offset, size, buf, data, host_pread, handle);
+    return res < 0 ? -1 : res;
+}
+//---------
+void esp_littlefs_mmap_stats(esp_littlefs_mmap_handle_t handle, uint64_t* mapped_bytes, uint64_t* copied_bytes) {
+    *mapped_bytes = handle->map.mapped;
+    *copied_bytes = handle->map.copied;
+}
+
+/**********************
+ *   SPANS
+ **********************/
+static bool check_spans(void) {
+    bool ok_walk = true, ok_single = true, ok_inline = true, ok_count = true;
+    for (int id = 0; id < ASSETS; id++) {
+        esp_littlefs_mmap_handle_t h;
+        if (esp_littlefs_mmap_open(NULL, s_assets[id].path, &h) != ESP_OK) {
+            ok_walk = false;
+            continue;
+        }
+        uint32_t size = asset_size(id);
+        if (size <= CACHE_SIZE) {
+            // Inline (sau gol): nu e mapat, span-ul refuza, get trece prin littlefs
+            const void* d;
+            ok_inline &= !esp_littlefs_mmap_is_mapped(h) && (size == 0 || esp_littlefs_mmap_span(h, 0, &d) == -1);
+        } else {
+            uint32_t off = 0, spans = 0;
+            while (off < size) {
+                const void* d;
+                ssize_t     n = esp_littlefs_mmap_span(h, off, &d);
+                ok_walk &= n > 0 && in_mapping(d, (size_t) n) && asset_ok(id, off, d, (size_t) n);
+                if (n <= 0) {
+                    break;
+                }
+                // Un span nu trece de blocul lui
+                ok_walk &= ((uintptr_t) ((const uint8_t*) d - s_bd.buffer) % BLOCK_SIZE) + (size_t) n <= BLOCK_SIZE;
+                off += (uint32_t) n;
+                spans++;
+            }
+            const void* d;
+            ok_walk &= off == size && esp_littlefs_mmap_span(h, size, &d) == 0;
+            ok_single &= size > BLOCK_SIZE || spans == 1;
+            // Blocul 0 are BLOCK_SIZE octeti de date, restul mai putin cu pointerii lor: cel putin
+            // ceil(size / BLOCK_SIZE) span-uri, si nu mai mult de unul la ~4 KiB - 8
+            ok_count &= spans >= (size + BLOCK_SIZE - 1) / BLOCK_SIZE && spans <= size / (BLOCK_SIZE - 8) + 1;
+        }
+        esp_littlefs_mmap_close(h);
+    }
+    bool ok = expect(ok_walk, "spans walk every file: in the mapping, right bytes, end at EOF");
+    ok &= expect(ok_single, "files of up to one block are a single span");
+    ok &= expect(ok_count, "one span per block");
+    ok &= expect(ok_inline, "empty and inline files are not mapped");
+    return ok;
+}
+
+/**********************
+ *   GET
+ **********************/
+static bool check_get(uint32_t seed) {
+    static uint8_t buf[300000];
+    bool           ok_data = true, ok_single = true, ok_inline = true;
+    uint64_t       mapped = 0, copied = 0;
+    for (int id = 0; id < ASSETS; id++) {
+        esp_littlefs_mmap_handle_t h;
+        if (esp_littlefs_mmap_open(NULL, s_assets[id].path, &h) != ESP_OK) {
+            ok_data = false;
+            continue;
+        }
+        uint32_t size = asset_size(id);
+        for (int i = 0; i < 2000; i++) {
+            uint32_t    off = size ? rnd(&seed) % (size + 16) : 0;  // Si dupa final
+            uint32_t    len = 1 + rnd(&seed) % (i % 64 == 0 ? 20000 : 600);
+            const void* d   = NULL;
+            ssize_t     n   = esp_littlefs_mmap_get(h, off, len, buf, &d);
+            size_t      exp = off >= size ? 0 : (len < size - off ? len : size - off);
+            ok_data &= n == (ssize_t) exp && (n == 0 || asset_ok(id, off, d, (size_t) n));
+            // Direct din mapare exact cand intervalul e intr-un span
+            const void* s;
+            ssize_t     span = esp_littlefs_mmap_is_mapped(h) ? esp_littlefs_mmap_span(h, off, &s) : 0;
+            ok_data &= n <= 0 || (d != buf) == (span >= n);
+        }
+        uint64_t m, c;
+        esp_littlefs_mmap_stats(h, &m, &c);
+        mapped += m;
+        copied += c;
+        ok_single &= !(size > CACHE_SIZE && size <= BLOCK_SIZE) || c == 0;
+        ok_inline &= size > CACHE_SIZE || m == 0;
+        esp_littlefs_mmap_close(h);
+    }
+    char what[96];
+    bool ok = expect(ok_data, "random gets: right bytes, pointer iff the range is one span");
+    ok &= expect(ok_single, "single-block files: nothing copied");
+    ok &= expect(ok_inline, "inline files: everything copied through littlefs");
+    snprintf(what, sizeof(what), "random gets: %.1f MB mapped, %.1f MB copied", mapped / 1e6, copied / 1e6);
+    ok &= expect(mapped > copied, what);
+
+    // Fara mapare (CONFIG_LITTLEFS_MMAP_PARTITION oprit, sau card SD): totul prin littlefs
+    s_base                       = NULL;
+    esp_littlefs_mmap_handle_t h = NULL;
+    bool ok_unmapped = esp_littlefs_mmap_open(NULL, "/font.bin", &h) == ESP_OK && !esp_littlefs_mmap_is_mapped(h);
+    for (uint32_t off = 0; ok_unmapped && off < asset_size(6); off += 3000) {
+        const void* d;
+        ssize_t     n = esp_littlefs_mmap_get(h, off, 3000, buf, &d);
+        ok_unmapped &= n > 0 && d == buf && asset_ok(6, off, d, (size_t) n);
+    }
+    uint64_t m = 0, c = 0;
+    if (h) {
+        esp_littlefs_mmap_stats(h, &m, &c);
+        esp_littlefs_mmap_close(h);
+    }
+    ok &= expect(ok_unmapped && m == 0 && c == asset_size(6), "partition not mapped: copies through littlefs");
+    s_base = s_bd.buffer;
+
+    // Pointer CTZ corupt in ultimul bloc: attach refuza in loc sa citeasca in afara partitiei
+    lfs_file_t f;
+    uint8_t    fbuf[CACHE_SIZE];
+    lfs_file_opencfg(&s_lfs, &f, "/big.bin", LFS_O_RDONLY, &(struct lfs_file_config){.buffer = fbuf});
+    uint8_t* ptr = s_bd.buffer + (size_t) f.ctz.head * BLOCK_SIZE;
+    uint8_t  saved[4];
+    memcpy(saved, ptr, 4);
+    memset(ptr, 0xA5, 4);
+    littlefs_mmap_t map;
+    int             res = littlefs_mmap_attach(&map, &s_lfs, &f, s_base);
+    memcpy(ptr, saved, 4);
+    lfs_file_close(&s_lfs, &f);
+    ok &= expect(res == LFS_ERR_CORRUPT && !littlefs_mmap_mapped(&map), "corrupted CTZ pointer: LFS_ERR_CORRUPT");
+
+    // Un fisier deschis isi pastreaza blocurile: scrieri si stergeri de alte fisiere nu ating span-urile
+    bool ok_stable = esp_littlefs_mmap_open(NULL, "/font.bin", &h) == ESP_OK;
+    for (int round = 0; ok_stable && round < 40; round++) {
+        char path[32];
+        snprintf(path, sizeof(path), "/churn%d.bin", round % 4);
+        lfs_file_open(&s_lfs, &f, path, LFS_O_WRONLY | LFS_O_CREAT | LFS_O_TRUNC);
+        memset(buf, round, 50000);
+        ok_stable &= lfs_file_write(&s_lfs, &f, buf, 50000) == 50000 && lfs_file_close(&s_lfs, &f) == 0;
+        if (round % 4 == 3) {
+            for (int k = 0; k < 4; k++) {
+                snprintf(path, sizeof(path), "/churn%d.bin", k);
+                ok_stable &= lfs_remove(&s_lfs, path) == 0;
+            }
+        }
+    }
+    for (uint32_t off = 0; ok_stable && off < asset_size(6);) {
+        const void* d;
+        ssize_t     n = esp_littlefs_mmap_span(h, off, &d);
+        ok_stable &= n > 0 && asset_ok(6, off, d, (size_t) n);
+        off += n > 0 ? (uint32_t) n : 0;
+    }
+    if (h) {
+        esp_littlefs_mmap_close(h);
+    }
+    ok &= expect(ok_stable, "spans of an open file survive 2 MB of writes to other files");
+    return ok;
+}
+
+/**********************
+ *   LVGL DRIVE
+ **********************/
+static bool check_lv_fs(void) {
+    static uint8_t buf[300000];
+    lv_fs_littlefs_init('L', "littlefs");
+
+    lv_fs_file_t f;
+    bool         ok_read = lv_fs_open(&f, "L:/font.bin", LV_FS_MODE_RD) == LV_FS_RES_OK;
+    uint32_t     total   = 0, br;
+    while (ok_read) {
+        ok_read &= lv_fs_read(&f, buf + total, 700, &br) == LV_FS_RES_OK;
+        total += br;
+        if (br < 700) {
+            break;
+        }
+    }
+    ok_read &= total == asset_size(6) && asset_ok(6, 0, buf, total);
+    uint32_t pos = 0;
+    ok_read &= lv_fs_seek(&f, 5000, LV_FS_SEEK_SET) == LV_FS_RES_OK && lv_fs_read(&f, buf, 100, &br) == LV_FS_RES_OK &&
+               br == 100 && asset_ok(6, 5000, buf, 100) && lv_fs_tell(&f, &pos) == LV_FS_RES_OK && pos == 5100;
+    ok_read &= lv_fs_seek(&f, 0, LV_FS_SEEK_END) == LV_FS_RES_OK && lv_fs_read(&f, buf, 100, &br) == LV_FS_RES_OK && br == 0;
+    lv_fs_close(&f);
+
+    bool ok_inline = lv_fs_open(&f, "L:/cfg.txt", LV_FS_MODE_RD) == LV_FS_RES_OK &&
+                     lv_fs_read(&f, buf, 1000, &br) == LV_FS_RES_OK && br == 100 && asset_ok(1, 0, buf, br);
+    lv_fs_close(&f);
+    bool ok_refuse = lv_fs_open(&f, "L:/font.bin", LV_FS_MODE_WR) != LV_FS_RES_OK &&
+                     lv_fs_open(&f, "L:/missing.bin", LV_FS_MODE_RD) != LV_FS_RES_OK;
+
+    uint64_t mapped, copied;
+    lv_fs_littlefs_stats(&mapped, &copied);
+    char what[96];
+    bool ok = expect(ok_read, "L:/font.bin: read in 700 byte chunks, seek, tell, EOF");
+    ok &= expect(ok_inline, "L:/cfg.txt (inline): read through littlefs");
+    ok &= expect(ok_refuse, "write mode and missing files refused");
+    snprintf(what, sizeof(what), "drive: %llu bytes from the mapping, %llu copied", (unsigned long long) mapped,
+        (unsigned long long) copied);
+    ok &= expect(mapped > 4 * copied, what);  // 700 din 4096: un read din ~6 trece granita
+
+    // Imaginea de un bloc direct din flash; cea de 5 blocuri nu se poate
+    lv_image_dsc_t             dsc;
+    lv_image_header_t          header;
+    esp_littlefs_mmap_handle_t h;
+    bool ok_icon = lv_fs_littlefs_image("/icon.bin", &dsc, &h);
+    if (ok_icon) {
+        ok_icon = in_mapping(dsc.data, dsc.data_size) && dsc.header.w == ICON_W && dsc.header.h == ICON_W &&
+                  dsc.data_size == ICON_W * ICON_W * 2 && asset_ok(2, sizeof(lv_image_header_t), dsc.data, dsc.data_size) &&
+                  lv_image_decoder_get_info(&dsc, &header) == LV_RESULT_OK && header.w == ICON_W;
+        lv_fs_littlefs_image_close(h);
+    }
+    ok &= expect(ok_icon, "/icon.bin as lv_image_dsc_t straight from the mapping");
+    ok &= expect(!lv_fs_littlefs_image("/img.bin", &dsc, &h) && !lv_fs_littlefs_image("/font.bin", &dsc, &h),
+        "multi-block image and non-image refused");
+    return ok;
+}
+
+/**********************
+ *   THROUGHPUT
+ **********************/
+typedef enum { READ_LFS, READ_GET, READ_SPAN } read_mode_t;
+
+static const char* s_mode_names[] = {"lfs_file_read", "mmap_get+memcpy", "mmap_span"};
+
+static bool read_all(read_mode_t mode, int rounds, double* mb_s, uint64_t* delivered, uint64_t* device, uint64_t* copied,
+    uint64_t* mapped) {
+    static uint8_t buf[CHUNK];
+    uint32_t       sum = 0;
+    bool           ok  = true;
+    *delivered = *copied = *mapped = 0;
+    s_bd_copied                    = 0;
+    int64_t t0                     = now_ns();
+    for (int r = 0; r < rounds; r++) {
+        for (int id = 5; id < ASSETS; id++) {  // img, font, big
+            uint32_t size = asset_size(id);
+            if (mode == READ_LFS) {
+                lfs_file_t f;
+                uint8_t    fbuf[CACHE_SIZE];
+                ok &= lfs_file_opencfg(&s_lfs, &f, s_assets[id].path, LFS_O_RDONLY, &(struct lfs_file_config){.buffer = fbuf}) == 0;
+                lfs_ssize_t n;
+                while ((n = lfs_file_read(&s_lfs, &f, buf, CHUNK)) > 0) {
+                    sum += buf[0] + buf[n - 1];
+                    *delivered += (uint64_t) n;
+                    *copied += (uint64_t) n;  // Din cache-ul fisierului in buf; device = flash -> cache
+                }
+                lfs_file_close(&s_lfs, &f);
+                continue;
+            }
+            esp_littlefs_mmap_handle_t h;
+            if (esp_littlefs_mmap_open(NULL, s_assets[id].path, &h) != ESP_OK) {
+                ok = false;
+                continue;
+            }
+            for (uint32_t off = 0; off < size;) {
+                const void* d;
+                ssize_t     n = mode == READ_GET ? esp_littlefs_mmap_get(h, off, CHUNK, buf, &d) : esp_littlefs_mmap_span(h, off, &d);
+                if (n <= 0) {
+                    ok = false;
+                    break;
+                }
+                if (mode == READ_GET && d != buf) {
+                    memcpy(buf, d, (size_t) n);  // Ca fs_read din drive-ul LVGL
+                    *copied += (uint64_t) n;
+                }
+                sum += ((const uint8_t*) d)[0] + ((const uint8_t*) d)[n - 1];
+                *delivered += (uint64_t) n;
+                off += (uint32_t) n;
+            }
+            uint64_t m, c;
+            esp_littlefs_mmap_stats(h, &m, &c);
+            *mapped += m + (mode == READ_SPAN ? size : 0);
+            *copied += c;
+            esp_littlefs_mmap_close(h);
+        }
+    }
+    *mb_s   = (double) *delivered / ((double) (now_ns() - t0) / 1e9) / 1e6;
+    *device = s_bd_copied;
+    return ok && sum != 0xFFFFFFFFu;
+}
+//---------
+static bool check_throughput(int rounds) {
+    double   mb_s[3];
+    uint64_t delivered[3], device[3], copied[3], mapped[3];
+    bool     ok_run = true;
+    printf("  %-18s %8s %12s %12s %12s %12s\n", "path", "MB/s", "delivered", "device read", "copied", "mapped");
+    for (int m = 0; m < 3; m++) {
+        ok_run &= read_all((read_mode_t) m, rounds, &mb_s[m], &delivered[m], &device[m], &copied[m], &mapped[m]);
+        printf("  %-18s %8.0f %12llu %12llu %12llu %12llu\n", s_mode_names[m], mb_s[m], (unsigned long long) delivered[m],
+            (unsigned long long) device[m], (unsigned long long) copied[m], (unsigned long long) mapped[m]);
+    }
+    bool ok = expect(ok_run && delivered[0] == delivered[1] && delivered[1] == delivered[2], "all three paths deliver every byte");
+    ok &= expect(device[0] >= delivered[0] && copied[0] == delivered[0], "lfs_file_read: device -> cache -> buffer, two copies");
+    ok &= expect(copied[1] == delivered[1] && device[1] < delivered[1] / 10, "mmap_get+memcpy: one copy, device only for metadata");
+    ok &= expect(copied[2] == 0 && mapped[2] == delivered[2] && device[2] < delivered[2] / 10, "mmap_span: zero copies");
+    ok &= expect(mb_s[1] > mb_s[0], "mmap_get+memcpy faster than lfs_file_read");
+    return ok;
+}
+
+int main(int argc, char** argv) {
+    int      rounds = 40;
+    uint32_t seed   = 0x5eed;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--rounds") && i + 1 < argc) {
+            rounds = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--seed") && i + 1 < argc) {
+            seed = (uint32_t) strtoul(argv[++i], NULL, 0);
+        } else {
+            fprintf(stderr, "usage: %s [--rounds N] [--seed S]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (rounds <= 0 || seed == 0) {
+        fprintf(stderr, "--rounds > 0, --seed != 0\n");
+        return 2;
+    }
+    lv_init();
+
+    bool ok = expect(fs_setup(), "littlefs on lfs_rambd, assets written");
+    printf("\nspans:\n");
+    ok &= check_spans();
+    printf("\nget:\n");
+    ok &= check_get(seed);
+    printf("\nLVGL drive:\n");
+    ok &= check_lv_fs();
+    printf("\nreading img + font + big (%u KB) x %d:\n", (unsigned) ((asset_size(5) + asset_size(6) + asset_size(7)) / 1000), rounds);
+    ok &= check_throughput(rounds);
+
+    lfs_unmount(&s_lfs);
+    lfs_rambd_destroy(&s_cfg);
+    printf("\n%s\n", ok ? "all checks passed" : "FAILED");
+    return ok ? 0 : 1;
+}
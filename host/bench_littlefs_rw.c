@@ -0,0 +1,736 @@
+/*
+ * bench_littlefs_rw - blocarea cititor/scriitor din components/littlefs/src/littlefs_rwlock.c, cu mai
+ * multe thread-uri pe littlefs peste lfs_emubd (citiri de flash cu latenta simulata)
+ *
+ * esp_littlefs.c nu se compileaza pe host, asa ca fs_*() de aici fac ce fac vfs_littlefs_*: tabela
+ * de FD-uri, lacatul, esp_littlefs_take_file (shared + lacatul fisierului daca
+ * littlefs_file_shareable, altfel exclusiv) pentru read / pread / lseek / fstat, exclusiv restul.
+ *
+ *   1. lacatul singur: cititori in paralel, scriitorul singur, scriitorul nu e depasit de cititori
+ *      noi, exclusiv recursiv, shared in interiorul exclusivului
+ *   2. stres: cititori pe fisiere mari (CTZ, shared) si mici (inline, trec pe exclusiv) plus un FD
+ *      folosit de toti, in timp ce un scriitor adauga in log (write / fsync, ca salvarea istoricului
+ *      din consola) si face create / rename / remove. Fiecare citire e verificata, la final log-ul si
+ *      fisierele dupa remount. Acelasi lucru cu un singur lacat exclusiv (ca inainte), pentru
+ *      ops/s, MB/s si p99 la cititori
+ *
+ * Usage: bench_littlefs_rw [--ms N] [--readers N] [--seed S]
+ */
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/prctl.h>
+#include <time.h>
+
+#include "bd/lfs_emubd.h"
+#include "lfs.h"
+#include "littlefs_fd.h"
+#include "littlefs_rwlock.h"
+
+#define BLOCK_SIZE  (4096)  // Ca CONFIG_LITTLEFS_BLOCK_SIZE
+#define BLOCK_COUNT (256)
+#define IO_SIZE     (128)  // CONFIG_LITTLEFS_READ_SIZE / WRITE_SIZE
+#define CACHE_SIZE  (512)  // CONFIG_LITTLEFS_CACHE_SIZE, si bufferul fiecarui fisier
+#define LOOKAHEAD   (128)
+
+#define READ_NS      (10000)  // Latenta unei citiri de flash + ~40 MB/s
+#define READ_NS_BYTE (25)
+#define PROG_NS      (60000)
+#define ERASE_NS     (2000000)  // Scalat: un sector NOR real are zeci de ms
+
+#define ASSETS      (6)
+#define ASSET_SIZE  (24 * 1024)  // Imagini / fonturi LVGL: peste inline_max, deci CTZ
+#define SMALLS      (2)
+#define SMALL_SIZE  (96)  // Inline in directorul parinte
+#define RECORD      (200)
+#define MAX_READERS (16)
+#define WRITER_GAP_NS (5000000)  // 200 inregistrari / s, mult peste ritmul real al consolei
+
+/**********************
+ *   HELPERS
+ **********************/
+static bool expect(bool cond, const char* what) {
+    printf("  %-64s %s\n", what, cond ? "ok" : "FAIL");
+    return cond;
+}
+//---------
+static int64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t) ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+//---------
+static void sleep_ns(int64_t ns) {
+    struct timespec ts = {(time_t) (ns / 1000000000), (long) (ns % 1000000000)};
+    while (ns > 0 && nanosleep(&ts, &ts) != 0) {
+    }
+}
+//---------
+static uint32_t rnd(uint32_t* state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 17;
+    *state ^= *state << 5;
+    return *state;
+}
+//---------
+/* Continutul fisierului `id` la offset-ul `off`, ca fiecare citire sa poata fi verificata */
+static uint8_t pattern(int id, uint32_t off) {
+    uint32_t x = (uint32_t) id * 0x9E3779B1u + off * 0x85EBCA6Bu;
+    return (uint8_t) (x ^ (x >> 13) ^ (x >> 24));
+}
+//---------
+static bool pattern_ok(int id, uint32_t off, const uint8_t* buf, size_t len) {
+    for (size_t i = 0; i < len; i++) {
+        if (buf[i] != pattern(id, off + (uint32_t) i)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**********************
+ *   FLASH
+ **********************/
+static lfs_emubd_t              s_bd;
+static struct lfs_emubd_config  s_bd_cfg;
+static struct lfs_config        s_cfg;
+static pthread_mutex_t          s_bd_mutex = PTHREAD_MUTEX_INITIALIZER;
+static uint64_t                 s_bd_reads;
+
+/* lfs_emubd_read numara octetii cititi (neatomic), latenta e simulata in afara */
+static int bench_read(const struct lfs_config* c, lfs_block_t block, lfs_off_t off, void* buf, lfs_size_t size) {
+    pthread_mutex_lock(&s_bd_mutex);
+    int err = lfs_emubd_read(c, block, off, buf, size);
+    s_bd_reads++;
+    pthread_mutex_unlock(&s_bd_mutex);
+    sleep_ns(READ_NS + (int64_t) size * READ_NS_BYTE);
+    return err;
+}
+
+/**********************
+ *   VFS GLUE
+ **********************/
+/* vfs_littlefs_file_t fara cale */
+typedef struct {
+    lfs_file_t             file;
+    struct lfs_file_config cfg;
+    uint8_t                buffer[CACHE_SIZE];
+} bench_file_t;
+
+static lfs_t               s_lfs;
+static littlefs_fd_table_t s_fds;
+static littlefs_rwlock_t   s_lock;
+static bool                s_rw;  // false = tot exclusiv, ca vechiul mutex unic
+static uint64_t            s_shared_takes, s_exclusive_takes;  // __atomic_*
+
+/* esp_littlefs_take_file */
+static bench_file_t* take_file(int fd, bool* shared) {
+    bench_file_t* file = NULL;
+    if (s_rw) {
+        littlefs_rwlock_read_lock(&s_lock);
+        file = littlefs_fd_get(&s_fds, fd);
+        if (file) {
+            littlefs_rwlock_file_lock(&s_lock, fd);
+            if (littlefs_file_shareable(&file->file)) {
+                __atomic_add_fetch(&s_shared_takes, 1, __ATOMIC_RELAXED);
+                *shared = true;
+                return file;
+            }
+            littlefs_rwlock_file_unlock(&s_lock, fd);
+        }
+        littlefs_rwlock_read_unlock(&s_lock);
+        if (!file) {
+            return NULL;
+        }
+    }
+    littlefs_rwlock_write_lock(&s_lock);
+    __atomic_add_fetch(&s_exclusive_takes, 1, __ATOMIC_RELAXED);
+    *shared = false;
+    file    = littlefs_fd_get(&s_fds, fd);
+    if (!file) {
+        littlefs_rwlock_write_unlock(&s_lock);
+    }
+    return file;
+}
+//---------
+static void give_file(int fd, bool shared) {
+    if (shared) {
+        littlefs_rwlock_file_unlock(&s_lock, fd);
+        littlefs_rwlock_read_unlock(&s_lock);
+    } else {
+        littlefs_rwlock_write_unlock(&s_lock);
+    }
+}
+//---------
+static uint32_t path_hash(const char* path) {
+    uint32_t hash = 5381;
+    char     c;
+    while ((c = *path++)) {
+        hash = ((hash << 5) + hash) + c;
+    }
+    return hash;
+}
+//---------
+static int fs_open(const char* path, int flags) {
+    bench_file_t* f = calloc(1, sizeof(*f));
+    f->cfg.buffer   = f->buffer;
+    littlefs_rwlock_write_lock(&s_lock);
+    int fd = littlefs_fd_alloc(&s_fds, f, path_hash(path));
+    if (fd >= 0 && lfs_file_opencfg(&s_lfs, &f->file, path, flags, &f->cfg) < 0) {
+        littlefs_fd_free(&s_fds, fd);
+        fd = -1;
+    }
+    littlefs_rwlock_write_unlock(&s_lock);
+    if (fd < 0) {
+        free(f);
+    }
+    return fd;
+}
+//---------
+static int fs_close(int fd) {
+    littlefs_rwlock_write_lock(&s_lock);
+    bench_file_t* f   = littlefs_fd_free(&s_fds, fd);
+    int           res = f ? lfs_file_close(&s_lfs, &f->file) : LFS_ERR_BADF;
+    littlefs_rwlock_write_unlock(&s_lock);
+    free(f);
+    return res;
+}
+//---------
+static lfs_ssize_t fs_read(int fd, void* buf, size_t len) {
+    bool          shared;
+    bench_file_t* f = take_file(fd, &shared);
+    if (!f) {
+        return LFS_ERR_BADF;
+    }
+    lfs_ssize_t res = lfs_file_read(&s_lfs, &f->file, buf, len);
+    give_file(fd, shared);
+    return res;
+}
+//---------
+static lfs_ssize_t fs_pread(int fd, void* buf, size_t len, lfs_off_t off) {
+    bool          shared;
+    bench_file_t* f = take_file(fd, &shared);
+    if (!f) {
+        return LFS_ERR_BADF;
+    }
+    lfs_soff_t  old = lfs_file_seek(&s_lfs, &f->file, 0, LFS_SEEK_CUR);
+    lfs_ssize_t res = lfs_file_seek(&s_lfs, &f->file, off, LFS_SEEK_SET);
+    if (res >= 0) {
+        res = lfs_file_read(&s_lfs, &f->file, buf, len);
+        lfs_file_seek(&s_lfs, &f->file, old, LFS_SEEK_SET);
+    }
+    give_file(fd, shared);
+    return res;
+}
+//---------
+static lfs_soff_t fs_lseek(int fd, lfs_soff_t off, int whence) {
+    bool          shared;
+    bench_file_t* f = take_file(fd, &shared);
+    if (!f) {
+        return LFS_ERR_BADF;
+    }
+    lfs_soff_t res = lfs_file_seek(&s_lfs, &f->file, off, whence);
+    give_file(fd, shared);
+    return res;
+}
+//---------
+/* vfs_littlefs_fstat: din fisierul deschis, mereu shared */
+static lfs_soff_t fs_fstat_size(int fd) {
+    if (s_rw) {
+        littlefs_rwlock_read_lock(&s_lock);
+    } else {
+        littlefs_rwlock_write_lock(&s_lock);
+    }
+    bench_file_t* f   = littlefs_fd_get(&s_fds, fd);
+    lfs_soff_t    res = LFS_ERR_BADF;
+    if (f) {
+        littlefs_rwlock_file_lock(&s_lock, fd);
+        res = lfs_file_size(&s_lfs, &f->file);
+        littlefs_rwlock_file_unlock(&s_lock, fd);
+    }
+    if (s_rw) {
+        littlefs_rwlock_read_unlock(&s_lock);
+    } else {
+        littlefs_rwlock_write_unlock(&s_lock);
+    }
+    return res;
+}
+//---------
+static lfs_ssize_t fs_write(int fd, const void* buf, size_t len) {
+    littlefs_rwlock_write_lock(&s_lock);
+    bench_file_t* f   = littlefs_fd_get(&s_fds, fd);
+    lfs_ssize_t   res = f ? lfs_file_write(&s_lfs, &f->file, buf, len) : LFS_ERR_BADF;
+    littlefs_rwlock_write_unlock(&s_lock);
+    return res;
+}
+//---------
+static int fs_fsync(int fd) {
+    littlefs_rwlock_write_lock(&s_lock);
+    bench_file_t* f   = littlefs_fd_get(&s_fds, fd);
+    int           res = f ? lfs_file_sync(&s_lfs, &f->file) : LFS_ERR_BADF;
+    littlefs_rwlock_write_unlock(&s_lock);
+    return res;
+}
+//---------
+static int fs_rename(const char* from, const char* to) {
+    littlefs_rwlock_write_lock(&s_lock);
+    int res = lfs_rename(&s_lfs, from, to);
+    littlefs_rwlock_write_unlock(&s_lock);
+    return res;
+}
+//---------
+static int fs_remove(const char* path) {
+    littlefs_rwlock_write_lock(&s_lock);
+    int res = lfs_remove(&s_lfs, path);
+    littlefs_rwlock_write_unlock(&s_lock);
+    return res;
+}
+
+/**********************
+ *   LOCK ALONE
+ **********************/
+typedef struct {
+    int       readers_in;  // __atomic_*
+    int       writers_in;
+    int       max_readers;
+    bool      ok;
+    bool      stop;
+    uint64_t  writer_ops;
+    uint64_t  reader_ops;
+} lock_state_t;
+
+static lock_state_t s_ls;
+
+static void* lock_reader(void* arg) {
+    (void) arg;
+    while (!__atomic_load_n(&s_ls.stop, __ATOMIC_ACQUIRE)) {
+        littlefs_rwlock_read_lock(&s_lock);
+        int in = __atomic_add_fetch(&s_ls.readers_in, 1, __ATOMIC_SEQ_CST);
+        if (__atomic_load_n(&s_ls.writers_in, __ATOMIC_SEQ_CST) != 0) {
+            __atomic_store_n(&s_ls.ok, false, __ATOMIC_RELAXED);
+        }
+        int max = __atomic_load_n(&s_ls.max_readers, __ATOMIC_RELAXED);
+        while (in > max && !__atomic_compare_exchange_n(&s_ls.max_readers, &max, in, false, __ATOMIC_RELAXED,
+                                  __ATOMIC_RELAXED)) {
+        }
+        sleep_ns(20000);  // Citire lunga: ceilalti cititori trebuie sa intre intre timp
+        __atomic_sub_fetch(&s_ls.readers_in, 1, __ATOMIC_SEQ_CST);
+        littlefs_rwlock_read_unlock(&s_lock);
+        __atomic_add_fetch(&s_ls.reader_ops, 1, __ATOMIC_RELAXED);
+    }
+    return NULL;
+}
+//---------
+static void* lock_writer(void* arg) {
+    (void) arg;
+    while (!__atomic_load_n(&s_ls.stop, __ATOMIC_ACQUIRE)) {
+        littlefs_rwlock_write_lock(&s_lock);
+        littlefs_rwlock_write_lock(&s_lock);  // Recursiv, ca sem_take in sem_take
+        if (__atomic_add_fetch(&s_ls.writers_in, 1, __ATOMIC_SEQ_CST) != 1 ||
+            __atomic_load_n(&s_ls.readers_in, __ATOMIC_SEQ_CST) != 0) {
+            __atomic_store_n(&s_ls.ok, false, __ATOMIC_RELAXED);
+        }
+        // Shared in interiorul exclusivului, pe acelasi thread: nu se blocheaza
+        littlefs_rwlock_read_lock(&s_lock);
+        littlefs_rwlock_read_unlock(&s_lock);
+        sleep_ns(5000);
+        __atomic_sub_fetch(&s_ls.writers_in, 1, __ATOMIC_SEQ_CST);
+        littlefs_rwlock_write_unlock(&s_lock);
+        littlefs_rwlock_write_unlock(&s_lock);
+        __atomic_add_fetch(&s_ls.writer_ops, 1, __ATOMIC_RELAXED);
+        sleep_ns(200000);
+    }
+    return NULL;
+}
+//---------
+static bool check_lock(int readers) {
+    littlefs_rwlock_t zero;
+    memset(&zero, 0, sizeof(zero));
+    littlefs_rwlock_deinit(&zero);  // Ca esp_littlefs_free dupa un init esuat
+    bool ok_init = littlefs_rwlock_init(&s_lock) == 0 && s_lock.ready;
+
+    memset(&s_ls, 0, sizeof(s_ls));
+    s_ls.ok = true;
+    pthread_t r[MAX_READERS], w[2];
+    for (int i = 0; i < readers; i++) {
+        pthread_create(&r[i], NULL, lock_reader, NULL);
+    }
+    for (int i = 0; i < 2; i++) {
+        pthread_create(&w[i], NULL, lock_writer, NULL);
+    }
+    sleep_ns(300 * 1000000LL);
+    __atomic_store_n(&s_ls.stop, true, __ATOMIC_RELEASE);
+    for (int i = 0; i < readers; i++) {
+        pthread_join(r[i], NULL);
+    }
+    for (int i = 0; i < 2; i++) {
+        pthread_join(w[i], NULL);
+    }
+    littlefs_rwlock_deinit(&s_lock);
+
+    char what[80];
+    snprintf(what, sizeof(what), "%d readers: up to %d inside together", readers, s_ls.max_readers);
+    bool ok = expect(ok_init, "init, deinit of a zeroed lock");
+    ok &= expect(s_ls.max_readers > 1, what);
+    snprintf(what, sizeof(what), "writers alone, recursive, shared inside (%llu / %llu ops)",
+        (unsigned long long) s_ls.writer_ops, (unsigned long long) s_ls.reader_ops);
+    ok &= expect(s_ls.ok, what);
+    // Fara preferinta pentru scriitor, cititorii care se suprapun l-ar tine afara la nesfarsit
+    ok &= expect(s_ls.writer_ops > 100, "writers are not starved by overlapping readers");
+    return ok;
+}
+
+/**********************
+ *   STRESS
+ **********************/
+typedef struct {
+    int      id;
+    uint32_t seed;
+    int      fds[ASSETS + SMALLS];
+    uint32_t pos[ASSETS + SMALLS];  // Pozitia citirii secventiale
+    uint64_t ops, bytes, bad;
+    uint32_t hist[32];  // Latente, pe puteri ale lui 2 (ns)
+} reader_t;
+
+typedef struct {
+    uint64_t records, syncs, renames, bad;
+} writer_t;
+
+static int      s_shared_fd;  // Un asset deschis o data, folosit de toti cititorii
+static bool     s_stop;
+static reader_t s_readers[MAX_READERS];
+static writer_t s_writer;
+
+static int file_id(int i) {
+    return i;  // Asset-urile 0..ASSETS-1, apoi fisierele mici
+}
+//---------
+static uint32_t file_size(int i) {
+    return i < ASSETS ? ASSET_SIZE : SMALL_SIZE;
+}
+//---------
+static void hist_add(uint32_t* hist, int64_t ns) {
+    int b = 0;
+    while (b < 31 && (1LL << (b + 1)) <= ns) {
+        b++;
+    }
+    hist[b]++;
+}
+//---------
+static void* stress_reader(void* arg) {
+    reader_t* r = (reader_t*) arg;
+    uint8_t   buf[2048];
+    while (!__atomic_load_n(&s_stop, __ATOMIC_ACQUIRE)) {
+        uint32_t dice = rnd(&r->seed) % 100;
+        int      i    = dice < 5 ? ASSETS + (int) (rnd(&r->seed) % SMALLS) : (int) (rnd(&r->seed) % ASSETS);
+        int      fd   = r->fds[i];
+        uint32_t size = file_size(i);
+        int64_t  t0   = now_ns();
+        bool     ok   = true;
+        size_t   got  = 0;
+
+        if (dice < 45) {
+            // pread pe propriul FD sau pe cel comun
+            uint32_t off = rnd(&r->seed) % size;
+            uint32_t len = 1 + rnd(&r->seed) % sizeof(buf);
+            if (i < ASSETS && dice % 3 == 0) {
+                fd = s_shared_fd;
+                i  = 0;
+            }
+            lfs_ssize_t n = fs_pread(fd, buf, len, off);
+            ok            = n == (lfs_ssize_t) (len < size - off ? len : size - off) && pattern_ok(file_id(i), off, buf, n);
+            got           = n > 0 ? (size_t) n : 0;
+        } else if (dice < 80) {
+            // read secvential, de la capat la inceput
+            uint32_t    len = 256;
+            lfs_ssize_t n   = fs_read(fd, buf, len);
+            ok = n == (lfs_ssize_t) (len < size - r->pos[i] ? len : size - r->pos[i]) && pattern_ok(file_id(i), r->pos[i], buf, n);
+            r->pos[i] += n > 0 ? (uint32_t) n : 0;
+            got = n > 0 ? (size_t) n : 0;
+            if (r->pos[i] == size) {
+                ok &= fs_lseek(fd, 0, LFS_SEEK_SET) == 0;
+                r->pos[i] = 0;
+            }
+        } else if (dice < 90) {
+            // lseek relativ la final si citire
+            uint32_t   back = 1 + rnd(&r->seed) % size;
+            lfs_soff_t p    = fs_lseek(fd, -(lfs_soff_t) back, LFS_SEEK_END);
+            ok              = p == (lfs_soff_t) (size - back);
+            lfs_ssize_t n   = fs_read(fd, buf, 64);
+            ok &= n == (lfs_ssize_t) (back < 64 ? back : 64) && pattern_ok(file_id(i), size - back, buf, n);
+            r->pos[i] = size - back + (n > 0 ? (uint32_t) n : 0);
+            got       = n > 0 ? (size_t) n : 0;
+            if (r->pos[i] == size) {
+                ok &= fs_lseek(fd, 0, LFS_SEEK_SET) == 0;
+                r->pos[i] = 0;
+            }
+        } else {
+            ok = fs_fstat_size(dice % 2 ? fd : s_shared_fd) == (lfs_soff_t) (dice % 2 ? size : ASSET_SIZE);
+        }
+
+        hist_add(r->hist, now_ns() - t0);
+        r->ops++;
+        r->bytes += got;
+        r->bad += ok ? 0 : 1;
+    }
+    return NULL;
+}
+//---------
+static void record(uint64_t seq, uint8_t* rec) {
+    for (int i = 0; i < RECORD; i++) {
+        rec[i] = pattern(1000, (uint32_t) (seq * RECORD + i));
+    }
+}
+//---------
+/* Salvarea istoricului consolei plus operatii pe metadate in acelasi director */
+static void* stress_writer(void* arg) {
+    (void) arg;
+    uint8_t rec[RECORD];
+    int     fd = fs_open("/log.txt", LFS_O_WRONLY | LFS_O_CREAT | LFS_O_APPEND);
+    s_writer.bad += fd < 0;
+    while (fd >= 0 && !__atomic_load_n(&s_stop, __ATOMIC_ACQUIRE)) {
+        record(s_writer.records, rec);
+        s_writer.bad += fs_write(fd, rec, RECORD) != RECORD;
+        s_writer.records++;
+        if (s_writer.records % 8 == 0) {
+            s_writer.bad += fs_fsync(fd) != 0;
+            s_writer.syncs++;
+        }
+        if (s_writer.records % 32 == 0) {
+            int tmp = fs_open("/tmp.bin", LFS_O_WRONLY | LFS_O_CREAT | LFS_O_TRUNC);
+            s_writer.bad += tmp < 0 || fs_write(tmp, rec, RECORD) != RECORD || fs_close(tmp) != 0;
+            s_writer.bad += fs_rename("/tmp.bin", "/tmp2.bin") != 0 || fs_remove("/tmp2.bin") != 0;
+            s_writer.renames++;
+        }
+        sleep_ns(WRITER_GAP_NS);
+    }
+    s_writer.bad += fd >= 0 && fs_close(fd) != 0;
+    return NULL;
+}
+//---------
+static const char* asset_path(int i, char* buf, size_t size) {
+    if (i < ASSETS) {
+        snprintf(buf, size, "/img%d.bin", i);
+    } else {
+        snprintf(buf, size, "/cfg%d.txt", i - ASSETS);
+    }
+    return buf;
+}
+//---------
+static bool fs_setup(void) {
+    s_bd_cfg = (struct lfs_emubd_config){
+        .read_size   = IO_SIZE,
+        .prog_size   = IO_SIZE,
+        .erase_size  = BLOCK_SIZE,
+        .erase_count = BLOCK_COUNT,
+        .erase_value = 0xff,
+        .prog_sleep  = PROG_NS,
+        .erase_sleep = ERASE_NS,
+    };
+    s_cfg = (struct lfs_config){
+        .context        = &s_bd,
+        .read           = bench_read,
+        .prog           = lfs_emubd_prog,
+        .erase          = lfs_emubd_erase,
+        .sync           = lfs_emubd_sync,
+        .read_size      = IO_SIZE,
+        .prog_size      = IO_SIZE,
+        .block_size     = BLOCK_SIZE,
+        .block_count    = BLOCK_COUNT,
+        .block_cycles   = 512,
+        .cache_size     = CACHE_SIZE,
+        .lookahead_size = LOOKAHEAD,
+    };
+    if (lfs_emubd_create(&s_cfg, &s_bd_cfg) || lfs_format(&s_lfs, &s_cfg) || lfs_mount(&s_lfs, &s_cfg)) {
+        return false;
+    }
+    static uint8_t data[ASSET_SIZE];
+    for (int i = 0; i < ASSETS + SMALLS; i++) {
+        char       path[32];
+        lfs_file_t f;
+        for (uint32_t o = 0; o < file_size(i); o++) {
+            data[o] = pattern(file_id(i), o);
+        }
+        if (lfs_file_open(&s_lfs, &f, asset_path(i, path, sizeof(path)), LFS_O_WRONLY | LFS_O_CREAT) ||
+            lfs_file_write(&s_lfs, &f, data, file_size(i)) != (lfs_ssize_t) file_size(i) ||
+            lfs_file_close(&s_lfs, &f)) {
+            return false;
+        }
+    }
+    return true;
+}
+//---------
+/* Dupa remount: asset-urile intacte, log-ul contine exact inregistrarile scrise, tmp-urile nu exista */
+static bool fs_verify(uint64_t records) {
+    static uint8_t buf[ASSET_SIZE];
+    bool           ok = lfs_unmount(&s_lfs) == 0 && lfs_mount(&s_lfs, &s_cfg) == 0;
+    for (int i = 0; i < ASSETS + SMALLS && ok; i++) {
+        char       path[32];
+        lfs_file_t f;
+        ok &= lfs_file_open(&s_lfs, &f, asset_path(i, path, sizeof(path)), LFS_O_RDONLY) == 0;
+        ok &= ok && lfs_file_read(&s_lfs, &f, buf, sizeof(buf)) == (lfs_ssize_t) file_size(i) &&
+              pattern_ok(file_id(i), 0, buf, file_size(i));
+        lfs_file_close(&s_lfs, &f);
+    }
+    lfs_file_t      f;
+    struct lfs_info info;
+    ok &= lfs_stat(&s_lfs, "/tmp.bin", &info) == LFS_ERR_NOENT && lfs_stat(&s_lfs, "/tmp2.bin", &info) == LFS_ERR_NOENT;
+    ok &= lfs_file_open(&s_lfs, &f, "/log.txt", LFS_O_RDONLY) == 0;
+    ok &= lfs_file_size(&s_lfs, &f) == (lfs_soff_t) (records * RECORD);
+    uint8_t rec[RECORD], got[RECORD];
+    for (uint64_t i = 0; i < records && ok; i++) {
+        record(i, rec);
+        ok &= lfs_file_read(&s_lfs, &f, got, RECORD) == RECORD && memcmp(rec, got, RECORD) == 0;
+    }
+    lfs_file_close(&s_lfs, &f);
+    ok &= lfs_remove(&s_lfs, "/log.txt") == 0;  // Urmatoarea rulare porneste de la zero
+    return ok;
+}
+//---------
+typedef struct {
+    double   ops_s, mb_s, p50_us, p99_us, writes_s;
+    uint64_t bad, writer_bad;
+    bool     verified;
+} run_t;
+
+static double hist_pct(const uint32_t* hist, uint64_t total, double pct) {
+    uint64_t seen = 0;
+    for (int b = 0; b < 32; b++) {
+        seen += hist[b];
+        if (seen >= (uint64_t) (pct * (double) total)) {
+            return (double) (1LL << (b + 1)) / 1000.0;  // Marginea de sus a intervalului
+        }
+    }
+    return 0;
+}
+//---------
+static run_t stress_run(bool rw, int readers, int ms, uint32_t seed) {
+    run_t run = {0};
+    s_rw      = rw;
+    s_stop    = false;
+    memset(&s_writer, 0, sizeof(s_writer));
+    littlefs_fd_init(&s_fds);
+    littlefs_rwlock_init(&s_lock);
+
+    char path[32];
+    s_shared_fd = fs_open(asset_path(0, path, sizeof(path)), LFS_O_RDONLY);
+    for (int r = 0; r < readers; r++) {
+        memset(&s_readers[r], 0, sizeof(s_readers[r]));
+        s_readers[r].id   = r;
+        s_readers[r].seed = seed + (uint32_t) r * 7919u;
+        for (int i = 0; i < ASSETS + SMALLS; i++) {
+            s_readers[r].fds[i] = fs_open(asset_path(i, path, sizeof(path)), LFS_O_RDONLY);
+            s_readers[r].bad += s_readers[r].fds[i] < 0;
+        }
+    }
+
+    pthread_t t[MAX_READERS], w;
+    int64_t   t0 = now_ns();
+    for (int r = 0; r < readers; r++) {
+        pthread_create(&t[r], NULL, stress_reader, &s_readers[r]);
+    }
+    pthread_create(&w, NULL, stress_writer, NULL);
+    sleep_ns((int64_t) ms * 1000000);
+    __atomic_store_n(&s_stop, true, __ATOMIC_RELEASE);
+    for (int r = 0; r < readers; r++) {
+        pthread_join(t[r], NULL);
+    }
+    pthread_join(w, NULL);
+    double secs = (double) (now_ns() - t0) / 1e9;
+
+    uint64_t ops = 0, bytes = 0;
+    uint32_t hist[32] = {0};
+    for (int r = 0; r < readers; r++) {
+        ops += s_readers[r].ops;
+        bytes += s_readers[r].bytes;
+        run.bad += s_readers[r].bad;
+        for (int b = 0; b < 32; b++) {
+            hist[b] += s_readers[r].hist[b];
+        }
+        for (int i = 0; i < ASSETS + SMALLS; i++) {
+            run.bad += fs_close(s_readers[r].fds[i]) != 0;
+        }
+    }
+    run.bad += fs_close(s_shared_fd) != 0 || s_fds.count != 0;
+    run.writer_bad = s_writer.bad;
+    run.ops_s      = (double) ops / secs;
+    run.mb_s       = (double) bytes / secs / 1e6;
+    run.p50_us     = hist_pct(hist, ops, 0.50);
+    run.p99_us     = hist_pct(hist, ops, 0.99);
+    run.writes_s   = (double) s_writer.records / secs;
+    run.verified   = fs_verify(s_writer.records);
+
+    littlefs_rwlock_deinit(&s_lock);
+    littlefs_fd_deinit(&s_fds);
+    return run;
+}
+//---------
+static bool check_stress(int readers, int ms, uint32_t seed) {
+    bool ok_setup = fs_setup();
+    if (!expect(ok_setup, "littlefs on lfs_emubd, assets written")) {
+        return false;
+    }
+
+    run_t single = stress_run(false, readers, ms, seed);
+    __atomic_store_n(&s_shared_takes, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&s_exclusive_takes, 0, __ATOMIC_RELAXED);
+    run_t    rw     = stress_run(true, readers, ms, seed);
+    uint64_t shared = __atomic_load_n(&s_shared_takes, __ATOMIC_RELAXED);
+    uint64_t excl   = __atomic_load_n(&s_exclusive_takes, __ATOMIC_RELAXED);
+    lfs_unmount(&s_lfs);
+    lfs_emubd_destroy(&s_cfg);
+
+    printf("  %-10s %10s %8s %10s %10s %10s\n", "lock", "reads/s", "MB/s", "p50 us", "p99 us", "appends/s");
+    printf("  %-10s %10.0f %8.2f %10.0f %10.0f %10.0f\n", "single", single.ops_s, single.mb_s, single.p50_us,
+        single.p99_us, single.writes_s);
+    printf("  %-10s %10.0f %8.2f %10.0f %10.0f %10.0f\n", "rwlock", rw.ops_s, rw.mb_s, rw.p50_us, rw.p99_us,
+        rw.writes_s);
+    printf("  rwlock: %llu shared, %llu exclusive (inline files, fallback)\n", (unsigned long long) shared,
+        (unsigned long long) excl);
+
+    char what[80];
+    bool ok = expect(single.bad == 0 && rw.bad == 0, "every read / lseek / fstat returned the expected data");
+    ok &= expect(single.writer_bad == 0 && rw.writer_bad == 0, "writer: write / fsync / create / rename / remove");
+    ok &= expect(single.verified && rw.verified, "after remount: assets intact, log has every record");
+    ok &= expect(shared > 0 && excl > 0, "CTZ files read shared, inline files exclusive");
+    snprintf(what, sizeof(what), "%d readers: rwlock reads/s > 1.5x single lock", readers);
+    ok &= expect(readers < 2 || rw.ops_s > 1.5 * single.ops_s, what);
+    ok &= expect(rw.writes_s > 0.25 * single.writes_s, "writer keeps at least 1/4 of its single-lock rate");
+    return ok;
+}
+
+int main(int argc, char** argv) {
+    int      ms      = 500;
+    int      readers = 4;
+    uint32_t seed    = 0x5eed;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--ms") && i + 1 < argc) {
+            ms = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--readers") && i + 1 < argc) {
+            readers = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--seed") && i + 1 < argc) {
+            seed = (uint32_t) strtoul(argv[++i], NULL, 0);
+        } else {
+            fprintf(stderr, "usage: %s [--ms N] [--readers N] [--seed S]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (ms <= 0 || readers < 1 || readers > MAX_READERS || seed == 0) {
+        fprintf(stderr, "--ms > 0, --readers 1..%d, --seed != 0\n", MAX_READERS);
+        return 2;
+    }
+    prctl(PR_SET_TIMERSLACK, 1);  // Latentele simulate de ordinul zecilor de us
+
+    bool ok = true;
+    printf("lock alone:\n");
+    ok &= check_lock(readers);
+    printf("\nstress, %d readers + 1 writer, %d ms per lock:\n", readers, ms);
+    ok &= check_stress(readers, ms, seed);
+
+    printf("\n%s\n", ok ? "all checks passed" : "FAILED");
+    return ok ? 0 : 1;
+}
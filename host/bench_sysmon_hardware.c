@@ -0,0 +1,639 @@
+/*
+ * bench_sysmon_hardware - documentul /hardware din mylibs/sysmon/src/sysmon_hardware.c
+ *
+ * Tabela de partitii, flash-ul si NVS sunt false (definite aici, peste stub-urile din
+ * host/stubs): un flash de 16 MB in memorie, cu imagini de aplicatie scrise de bench, iar
+ * fiecare esp_flash_read(), nvs_get_stats() si esp_partition_find() e numarat.
+ *
+ *   1. corectitudine:
+ *        - primul raspuns JSON == documentul reconstruit aici din tabela falsa (chei,
+ *          ordine, rotunjiri), fara sa citeasca flash-ul
+ *        - raspunsul din cache == raspunsul codat direct (cache-ul nu poate fi alocat,
+ *          realloc forteaza NULL), pentru JSON si CBOR
+ *        - cererile urmatoare: 0 citiri de flash, 0 nvs_get_stats, 0 parcurgeri de partitii,
+ *          dar campurile dinamice (wifi.rssi) se schimba
+ *        - sysmon_hardware_note_nvs_commit() / _note_ota(): exact o reconstructie per format,
+ *          cu utilizarea noua (NVS mai plin, imagine noua in ota_1)
+ *        - dupa sysmon_hardware_cleanup() nu ramane niciun byte alocat
+ *   2. costul unei cereri, cu si fara cache (un hook inainte de fiecare cerere), JSON si CBOR:
+ *      us pe cerere pe host, citiri de flash si apeluri NVS pe cerere. Pe placa fiecare
+ *      esp_flash_read() e o tranzactie SPI cu cache-ul dezactivat, deci diferenta reala e
+ *      mai mare decat cea masurata aici.
+ *
+ * Usage: bench_sysmon_hardware [--requests N] [--segments N]
+ */
+
+#include <malloc.h>
+#include <math.h>
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "esp_chip_info.h"
+#include "esp_clk_tree.h"
+#include "esp_flash.h"
+#include "esp_heap_caps.h"
+#include "esp_image_format.h"
+#include "esp_partition.h"
+#include "esp_system.h"
+#include "nvs_flash.h"
+#include "sysmon.h"
+#include "sysmon_hardware.h"
+#include "sysmon_stream.h"
+
+#define FLASH_SIZE   (16u * 1024u * 1024u)
+#define OUT_SIZE     (64u * 1024u)
+#define MAX_SEGMENTS 16
+#define FAKE_NOW     ((time_t) 1760000000)  // Oct 09 2025 08:53:20 UTC
+
+/**********************
+ *   HEAP ACCOUNTING + FAILING REALLOC
+ **********************/
+void* __real_malloc(size_t size);
+void* __real_realloc(void* ptr, size_t size);
+void  __real_free(void* ptr);
+
+static bool   s_heap_track;
+static size_t s_heap_live;
+static bool   s_realloc_fails;
+
+void* __wrap_malloc(size_t size) {
+    void* p = __real_malloc(size);
+    if (s_heap_track && p) {
+        s_heap_live += malloc_usable_size(p);
+    }
+    return p;
+}
+//---------
+void* __wrap_realloc(void* ptr, size_t size) {
+    if (s_realloc_fails) {
+        return NULL;
+    }
+    if (s_heap_track && ptr) {
+        s_heap_live -= malloc_usable_size(ptr);
+    }
+    void* p = __real_realloc(ptr, size);
+    if (s_heap_track && p) {
+        s_heap_live += malloc_usable_size(p);
+    }
+    return p;
+}
+//---------
+void __wrap_free(void* ptr) {
+    if (s_heap_track && ptr) {
+        s_heap_live -= malloc_usable_size(ptr);
+    }
+    __real_free(ptr);
+}
+//---------
+/* bootTime vine din time(): fix, ca documentul asteptat sa fie determinist */
+time_t __wrap_time(time_t* t) {
+    if (t) {
+        *t = FAKE_NOW;
+    }
+    return FAKE_NOW;
+}
+
+/**********************
+ *   FAKE CHIP / HEAP / WIFI (ESP32-S3R8, ca pe T-HMI)
+ **********************/
+#define DRAM_TOTAL  341284u
+#define PSRAM_TOTAL (8u * 1024u * 1024u)
+
+static int8_t s_rssi = -61;
+
+void esp_chip_info(esp_chip_info_t* out_info) {
+    memset(out_info, 0, sizeof(*out_info));
+    out_info->model    = CHIP_ESP32S3;
+    out_info->features = CHIP_FEATURE_WIFI_BGN | CHIP_FEATURE_BLE | CHIP_FEATURE_EMB_PSRAM;
+    out_info->revision = 2;
+    out_info->cores    = 2;
+}
+//---------
+size_t heap_caps_get_total_size(uint32_t caps) {
+    return (caps & MALLOC_CAP_SPIRAM) ? PSRAM_TOTAL : DRAM_TOTAL;
+}
+//---------
+esp_err_t esp_clk_tree_src_get_freq_hz(soc_module_clk_t clk_src, esp_clk_tree_src_freq_precision_t precision,
+    uint32_t* freq_value) {
+    (void) clk_src;
+    (void) precision;
+    *freq_value = 240000000u;
+    return ESP_OK;
+}
+//---------
+const char* esp_get_idf_version(void) {
+    return "v5.4.1";
+}
+//---------
+/* Ceruta la link de documentele de task-uri din sysmon_stream.c, nefolosite aici */
+const char* _get_task_display_name(const char* task_name) {
+    return task_name;
+}
+//---------
+esp_err_t _get_wifi_ssid(char* ssid_buffer, size_t buffer_size) {
+    snprintf(ssid_buffer, buffer_size, "%s", "lab-2.4G");
+    return ESP_OK;
+}
+//---------
+esp_err_t _get_wifi_rssi(int8_t* rssi) {
+    *rssi = s_rssi;
+    return ESP_OK;
+}
+//---------
+esp_err_t _get_wifi_ip_info(char* ip_buffer, size_t buffer_size) {
+    snprintf(ip_buffer, buffer_size, "%s", "192.168.1.42");
+    return ESP_OK;
+}
+
+/**********************
+ *   FAKE PARTITIONS / FLASH / NVS
+ **********************/
+static const esp_partition_t s_parts[] = {
+    { NULL, ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_DATA_NVS, 0x9000, 0x6000, 0x1000, "nvs", false, false },
+    { NULL, ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_DATA_OTA, 0xf000, 0x2000, 0x1000, "otadata", false, false },
+    { NULL, ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_DATA_PHY, 0x11000, 0x1000, 0x1000, "phy_init", false, false },
+    { NULL, ESP_PARTITION_TYPE_APP, ESP_PARTITION_SUBTYPE_APP_OTA_0, 0x20000, 0x400000, 0x1000, "ota_0", false, false },
+    { NULL, ESP_PARTITION_TYPE_APP, ESP_PARTITION_SUBTYPE_APP_OTA_1, 0x420000, 0x400000, 0x1000, "ota_1", false, false },
+    { NULL, ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_DATA_SPIFFS, 0x820000, 0x7e0000, 0x1000, "storage", false, false },
+};
+#define PART_COUNT ((int) (sizeof(s_parts) / sizeof(s_parts[0])))
+
+struct esp_partition_iterator_opaque_ {
+    int index;
+};
+
+/* Imaginea scrisa in fiecare partitie de aplicatie (0 segmente = flash sters) */
+typedef struct {
+    int      segments;
+    uint32_t data_len[MAX_SEGMENTS];
+} image_t;
+
+static uint8_t* s_flash;
+static image_t  s_images[PART_COUNT];
+static size_t   s_nvs_used = 126;
+static size_t   s_nvs_free = 378;
+
+static uint32_t s_flash_reads;
+static uint32_t s_nvs_stats_calls;
+static uint32_t s_partition_finds;
+static int      s_iterators_live;
+
+esp_partition_iterator_t esp_partition_find(esp_partition_type_t type, esp_partition_subtype_t subtype, const char* label) {
+    (void) type;
+    (void) subtype;
+    (void) label;
+    s_partition_finds++;
+    esp_partition_iterator_t it = (esp_partition_iterator_t) malloc(sizeof(*it));
+    it->index = 0;
+    s_iterators_live++;
+    return it;
+}
+//---------
+const esp_partition_t* esp_partition_get(esp_partition_iterator_t iterator) {
+    return &s_parts[iterator->index];
+}
+//---------
+/* Ca in ESP-IDF: la capat elibereaza iteratorul si intoarce NULL */
+esp_partition_iterator_t esp_partition_next(esp_partition_iterator_t iterator) {
+    if (++iterator->index >= PART_COUNT) {
+        esp_partition_iterator_release(iterator);
+        return NULL;
+    }
+    return iterator;
+}
+//---------
+void esp_partition_iterator_release(esp_partition_iterator_t iterator) {
+    if (iterator) {
+        s_iterators_live--;
+        free(iterator);
+    }
+}
+//---------
+esp_err_t esp_flash_read(esp_flash_t* chip, void* buffer, uint32_t address, uint32_t length) {
+    (void) chip;
+    s_flash_reads++;
+    if ((uint64_t) address + length > FLASH_SIZE) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    memcpy(buffer, s_flash + address, length);
+    return ESP_OK;
+}
+//---------
+esp_err_t esp_flash_get_size(esp_flash_t* chip, uint32_t* out_size) {
+    (void) chip;
+    *out_size = FLASH_SIZE;
+    return ESP_OK;
+}
+//---------
+esp_err_t nvs_get_stats(const char* part_name, nvs_stats_t* nvs_stats) {
+    s_nvs_stats_calls++;
+    if (strcmp(part_name, "nvs") != 0) {
+        return ESP_ERR_NOT_FOUND;
+    }
+    memset(nvs_stats, 0, sizeof(*nvs_stats));
+    nvs_stats->used_entries  = s_nvs_used;
+    nvs_stats->free_entries  = s_nvs_free;
+    nvs_stats->total_entries = s_nvs_used + s_nvs_free;
+    return ESP_OK;
+}
+//---------
+static uint32_t align4(uint32_t n) {
+    return (n + 3u) & ~3u;
+}
+//---------
+/* Scrie headerul imaginii si headerele segmentelor (datele raman 0); 0 segmente = sters */
+static void write_image(int part, int segments, uint32_t first_len) {
+    uint32_t base = s_parts[part].address;
+    image_t* img  = &s_images[part];
+    memset(s_flash + base, 0xff, sizeof(esp_image_header_t));
+    img->segments = segments;
+    if (segments == 0) {
+        return;
+    }
+    esp_image_header_t header;
+    memset(&header, 0, sizeof(header));
+    header.magic         = ESP_IMAGE_HEADER_MAGIC;
+    header.segment_count = (uint8_t) segments;
+    memcpy(s_flash + base, &header, sizeof(header));
+    uint32_t offset = sizeof(esp_image_header_t);
+    for (int i = 0; i < segments; i++) {
+        esp_image_segment_header_t seg = { 0x42000020u + offset, first_len + 4099u * (uint32_t) i + (uint32_t) i };
+        img->data_len[i]               = seg.data_len;
+        memcpy(s_flash + base + offset, &seg, sizeof(seg));
+        offset += sizeof(seg) + align4(seg.data_len);
+    }
+}
+//---------
+/* Citiri de flash asteptate pentru o parcurgere: header + cate unul per segment, 1 daca e sters */
+static uint32_t reads_per_walk(void) {
+    uint32_t reads = 0;
+    for (int i = 0; i < PART_COUNT; i++) {
+        if (s_parts[i].type == ESP_PARTITION_TYPE_APP) {
+            reads += 1u + (uint32_t) s_images[i].segments;
+        }
+    }
+    return reads;
+}
+
+/**********************
+ *   EXPECTED DOCUMENT (reconstruit fara sysmon_hardware.c)
+ **********************/
+typedef struct {
+    char*  data;
+    size_t len;
+} text_t;
+
+static void text_printf(text_t* t, const char* fmt, ...) __attribute__((format(printf, 2, 3)));
+static void text_printf(text_t* t, const char* fmt, ...) {
+    va_list ap;
+    va_start(ap, fmt);
+    int n = vsnprintf(t->data + t->len, OUT_SIZE - t->len, fmt, ap);
+    va_end(ap);
+    t->len += (size_t) n;
+}
+//---------
+/* round(x * 100) / 100, textul cel mai scurt ("12.5", "3") */
+static void text_pct(text_t* t, double pct) {
+    long long scaled = llround((double) (float) pct * 100.0);
+    if (scaled % 100 == 0) {
+        text_printf(t, "%lld", scaled / 100);
+    } else if (scaled % 10 == 0) {
+        text_printf(t, "%lld.%lld", scaled / 100, (scaled % 100) / 10);
+    } else {
+        text_printf(t, "%lld.%02lld", scaled / 100, scaled % 100);
+    }
+}
+//---------
+static uint32_t image_used(int part) {
+    const image_t* img = &s_images[part];
+    if (img->segments == 0) {
+        return s_parts[part].size;
+    }
+    uint32_t used = sizeof(esp_image_header_t) + 32u;
+    for (int i = 0; i < img->segments; i++) {
+        used += sizeof(esp_image_segment_header_t) + align4(img->data_len[i]);
+    }
+    return used < s_parts[part].size ? used : s_parts[part].size;
+}
+//---------
+static void expected_json(text_t* t, const char* compile_time) {
+    char      boot[64];
+    struct tm tm;
+    time_t    now = FAKE_NOW;
+    gmtime_r(&now, &tm);
+    strftime(boot, sizeof(boot), "%b %d %Y %H:%M:%S", &tm);
+
+    t->len = 0;
+    text_printf(t, "{\"chip\":{\"model\":\"ESP32-S3\",\"revision\":2,\"cores\":2,\"variant\":\"ESP32-S3R8\",\"cpuFreqMHz\":240,"
+                   "\"features\":[\"WiFi 2.4GHz\",\"Bluetooth LE\",\"Embedded PSRAM\"]},");
+    text_printf(t, "\"memory\":{\"dramTotal\":%u,\"psramTotal\":%u},\"partitions\":[", DRAM_TOTAL, PSRAM_TOTAL);
+    uint32_t total = 0;
+    bool     first = true;
+    for (int i = 0; i < PART_COUNT; i++) {
+        const esp_partition_t* p = &s_parts[i];
+        if (strcmp(p->label, "phy_init") == 0) {
+            continue;
+        }
+        total += p->size;
+        text_printf(t, "%s{\"label\":\"%s\",\"type\":%d,\"address\":%u,\"size\":%u,", first ? "" : ",", p->label, (int) p->type,
+            p->address, p->size);
+        first         = false;
+        uint32_t used = 0;
+        if (p->type == ESP_PARTITION_TYPE_APP) {
+            used = image_used(i);
+        } else if (p->subtype == ESP_PARTITION_SUBTYPE_DATA_NVS) {
+            used = (uint32_t) ((double) s_nvs_used / (double) (s_nvs_used + s_nvs_free) * p->size);
+        } else {
+            text_printf(t, "\"usageAvailable\":false}");
+            continue;
+        }
+        text_printf(t, "\"usageAvailable\":true,\"used\":%u,\"free\":%u,\"usedPct\":", used, p->size - used);
+        text_pct(t, (double) used / (double) p->size * 100.0);
+        text_printf(t, "}");
+    }
+    text_printf(t, "],\"flashSummary\":{\"totalFlash\":%u,\"totalPartitions\":%u,\"unused\":%u,\"unusedPct\":", FLASH_SIZE,
+        total, FLASH_SIZE - total);
+    text_pct(t, (double) (FLASH_SIZE - total) / (double) FLASH_SIZE * 100.0);
+    text_printf(t, ",\"partitionsPct\":");
+    text_pct(t, (double) total / (double) FLASH_SIZE * 100.0);
+    text_printf(t, "},\"config\":{\"cpuSamplingIntervalMs\":%d,\"sampleCount\":%d},", CONFIG_SYSMON_CPU_SAMPLING_INTERVAL_MS,
+        CONFIG_SYSMON_SAMPLE_COUNT);
+    text_printf(t, "\"system\":{\"idfVersion\":\"v5.4.1\",\"compileTime\":\"%s\",\"bootTime\":\"%s\"},", compile_time, boot);
+    text_printf(t, "\"wifi\":{\"ssid\":\"lab-2.4G\",\"rssi\":%d,\"ip\":\"192.168.1.42\",\"port\":%d}}", s_rssi,
+        CONFIG_SYSMON_HTTPD_SERVER_PORT);
+}
+
+/**********************
+ *   REQUESTS
+ **********************/
+static text_t s_out;
+
+static esp_err_t out_write(void* ctx, const char* data, size_t len) {
+    text_t* t = (text_t*) ctx;
+    if (t->len + len > OUT_SIZE) {
+        return ESP_ERR_NO_MEM;
+    }
+    memcpy(t->data + t->len, data, len);
+    t->len += len;
+    return ESP_OK;
+}
+//---------
+/* O cerere /hardware ca in http_handle_stream_endpoint (starea e goala, ca pentru history_rows 0) */
+static esp_err_t request(sysmon_stream_format_t format, text_t* out) {
+    SysMonState           view;
+    sysmon_stream_query_t query = { 0 };
+    sysmon_stream_t       stream;
+    memset(&view, 0, sizeof(view));
+    out->len = 0;
+    sysmon_stream_init(&stream, format, out_write, out);
+    sysmon_stream_hardware(&stream, &view, &query);
+    return sysmon_stream_finish(&stream);
+}
+//---------
+typedef struct {
+    uint32_t reads;
+    uint32_t nvs;
+    uint32_t finds;
+} counters_t;
+
+static counters_t counters_take(void) {
+    counters_t c      = { s_flash_reads, s_nvs_stats_calls, s_partition_finds };
+    s_flash_reads     = 0;
+    s_nvs_stats_calls = 0;
+    s_partition_finds = 0;
+    return c;
+}
+
+/**********************
+ *   1. CORRECTNESS
+ **********************/
+static bool expect(bool cond, const char* what) {
+    printf("  %-70s %s\n", what, cond ? "ok" : "FAIL");
+    return cond;
+}
+//---------
+static bool same(const text_t* a, const text_t* b) {
+    return a->len == b->len && memcmp(a->data, b->data, a->len) == 0;
+}
+//---------
+/* Valoarea compileTime din raspuns ("Mmm dd yyyy hh:mm:ss", __DATE__ " " __TIME__ din sysmon_hardware.c) */
+static bool compile_time_of(const text_t* t, char* out, size_t size) {
+    static const char key[] = "\"compileTime\":\"";
+    const char*       p     = strstr(t->data, key);
+    if (p == NULL) {
+        return false;
+    }
+    p += sizeof(key) - 1;
+    const char* end = strchr(p, '"');
+    if (end == NULL || (size_t) (end - p) != 20 || (size_t) (end - p) >= size) {
+        return false;
+    }
+    memcpy(out, p, (size_t) (end - p));
+    out[end - p] = '\0';
+    return true;
+}
+//---------
+/* Raspunsul fara cache: realloc esueaza, documentul se codeaza direct in raspuns */
+static esp_err_t request_uncached(sysmon_stream_format_t format, text_t* out) {
+    sysmon_hardware_cleanup();
+    s_realloc_fails = true;
+    esp_err_t err   = request(format, out);
+    s_realloc_fails = false;
+    return err;
+}
+//---------
+static bool check_correctness(uint32_t requests) {
+    text_t     expected = { (char*) malloc(OUT_SIZE), 0 };
+    text_t     direct   = { (char*) malloc(OUT_SIZE), 0 };
+    text_t     cbor     = { (char*) malloc(OUT_SIZE), 0 };
+    char       compile_time[32];
+    counters_t c;
+    bool       ok = true;
+    uint32_t   walk = reads_per_walk();
+
+    s_heap_track = true;
+    s_heap_live  = 0;
+    counters_take();
+
+    // Primul JSON: o parcurgere, documentul complet
+    s_out.data[0] = '\0';
+    ok &= expect(request(SYSMON_STREAM_JSON, &s_out) == ESP_OK, "first JSON request succeeds");
+    s_out.data[s_out.len] = '\0';
+    c = counters_take();
+    ok &= expect(c.finds == 1 && c.reads == walk && c.nvs == 1, "first JSON request walks the partitions once");
+    ok &= expect(compile_time_of(&s_out, compile_time, sizeof(compile_time)), "compileTime has the __DATE__ __TIME__ format");
+    expected_json(&expected, compile_time);
+    ok &= expect(same(&s_out, &expected), "JSON == document rebuilt from the fake table");
+    if (!same(&s_out, &expected)) {
+        printf("    got:      %.*s\n    expected: %.*s\n", (int) s_out.len, s_out.data, (int) expected.len, expected.data);
+    }
+
+    // Cereri repetate: nicio citire, doar campurile dinamice se schimba
+    bool     all_same = true;
+    uint32_t n        = requests < 100 ? requests : 100;
+    for (uint32_t i = 0; i < n; i++) {
+        s_rssi = (int8_t) (-40 - (int) (i % 50));
+        request(SYSMON_STREAM_JSON, &s_out);
+        expected_json(&expected, compile_time);
+        all_same &= same(&s_out, &expected);
+    }
+    c = counters_take();
+    ok &= expect(c.finds == 0 && c.reads == 0 && c.nvs == 0, "cached JSON requests: 0 flash reads, 0 nvs_get_stats, 0 walks");
+    ok &= expect(all_same, "cached JSON requests follow wifi.rssi");
+
+    // CBOR: intrarea proprie, construita o data; din cache == codat direct
+    request(SYSMON_STREAM_CBOR, &cbor);
+    c = counters_take();
+    ok &= expect(c.finds == 1 && c.reads == walk, "first CBOR request walks the partitions once");
+    request(SYSMON_STREAM_CBOR, &cbor);
+    c = counters_take();
+    ok &= expect(c.reads == 0 && c.nvs == 0, "second CBOR request: 0 flash reads");
+    ok &= expect((uint8_t) cbor.data[0] == 0xbf && (uint8_t) cbor.data[cbor.len - 1] == 0xff, "CBOR is one indefinite map");
+    request_uncached(SYSMON_STREAM_CBOR, &direct);
+    ok &= expect(same(&cbor, &direct), "CBOR from the cache == CBOR encoded directly (no cache memory)");
+    request(SYSMON_STREAM_JSON, &s_out);
+    request_uncached(SYSMON_STREAM_JSON, &direct);
+    ok &= expect(same(&s_out, &direct), "JSON from the cache == JSON encoded directly (no cache memory)");
+    request(SYSMON_STREAM_JSON, &s_out);
+    request(SYSMON_STREAM_CBOR, &cbor);
+    counters_take();
+
+    // NVS commit: o reconstructie per format, utilizarea noua
+    s_nvs_used += 37;
+    s_nvs_free -= 37;
+    request(SYSMON_STREAM_JSON, &s_out);
+    ok &= expect(counters_take().reads == 0, "NVS entries added without the hook: cache still served");
+    sysmon_hardware_note_nvs_commit();
+    request(SYSMON_STREAM_JSON, &s_out);
+    request(SYSMON_STREAM_JSON, &s_out);
+    request(SYSMON_STREAM_CBOR, &cbor);
+    request(SYSMON_STREAM_CBOR, &cbor);
+    c = counters_take();
+    ok &= expect(c.finds == 2 && c.nvs == 2 && c.reads == 2 * walk, "note_nvs_commit(): one rebuild per format");
+    expected_json(&expected, compile_time);
+    ok &= expect(same(&s_out, &expected), "rebuilt JSON shows the new NVS usage");
+
+    // OTA: imagine noua in ota_1
+    write_image(4, 5, 70001);
+    walk = reads_per_walk();
+    sysmon_hardware_note_ota();
+    request(SYSMON_STREAM_JSON, &s_out);
+    for (uint32_t i = 0; i < n; i++) {
+        request(SYSMON_STREAM_JSON, &s_out);
+    }
+    c = counters_take();
+    ok &= expect(c.finds == 1 && c.reads == walk, "note_ota(): one rebuild, reads the new image headers");
+    expected_json(&expected, compile_time);
+    ok &= expect(same(&s_out, &expected), "rebuilt JSON shows the new ota_1 image size");
+    request_uncached(SYSMON_STREAM_JSON, &direct);
+    ok &= expect(same(&s_out, &direct), "and still equals the directly encoded document");
+
+    sysmon_hardware_cleanup();
+    ok &= expect(s_iterators_live == 0, "every partition iterator released");
+    ok &= expect(s_heap_live == 0, "nothing left allocated after sysmon_hardware_cleanup()");
+    s_heap_track = false;
+    counters_take();
+
+    free(expected.data);
+    free(direct.data);
+    free(cbor.data);
+    return ok;
+}
+
+/**********************
+ *   2. COST PER REQUEST
+ **********************/
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000u + (uint64_t) ts.tv_nsec;
+}
+//---------
+static double cost_run(sysmon_stream_format_t format, bool cached, uint32_t requests, counters_t* per_walk, size_t* bytes) {
+    sysmon_hardware_cleanup();
+    request(format, &s_out);  // construieste intrarea
+    counters_take();
+    uint64_t t0 = now_ns();
+    for (uint32_t i = 0; i < requests; i++) {
+        if (!cached) {
+            sysmon_hardware_note_nvs_commit();
+        }
+        request(format, &s_out);
+    }
+    double us = (double) (now_ns() - t0) / 1000.0 / requests;
+    *per_walk = counters_take();
+    *bytes    = s_out.len;
+    return us;
+}
+//---------
+static void cost_table(uint32_t requests) {
+    static const struct {
+        sysmon_stream_format_t format;
+        bool                   cached;
+        const char*            name;
+    } runs[] = {
+        { SYSMON_STREAM_JSON, false, "json, rebuilt" },
+        { SYSMON_STREAM_JSON, true, "json, cached" },
+        { SYSMON_STREAM_CBOR, false, "cbor, rebuilt" },
+        { SYSMON_STREAM_CBOR, true, "cbor, cached" },
+    };
+    printf("%-16s | %10s %12s %12s %12s %8s\n", "REQUEST", "US/REQ", "FLASH-RD/REQ", "NVS-STAT/REQ", "WALKS/REQ", "BYTES");
+    for (size_t r = 0; r < sizeof(runs) / sizeof(runs[0]); r++) {
+        double     best = 1e30;
+        counters_t c    = { 0, 0, 0 };
+        size_t     bytes = 0;
+        for (int rep = 0; rep < 5; rep++) {
+            double us = cost_run(runs[r].format, runs[r].cached, requests, &c, &bytes);
+            best      = us < best ? us : best;
+        }
+        printf("%-16s | %10.2f %12.2f %12.2f %12.2f %8zu\n", runs[r].name, best, (double) c.reads / requests,
+            (double) c.nvs / requests, (double) c.finds / requests, bytes);
+    }
+    sysmon_hardware_cleanup();
+    printf("rebuilt = sysmon_hardware_note_nvs_commit() before every request, i.e. the cost of every request before the\n");
+    printf("cache. Host flash reads are memcpy; on the device each one is a SPI flash transaction.\n");
+}
+
+int main(int argc, char** argv) {
+    uint32_t requests = 2000;
+    int      segments = 6;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--requests") && i + 1 < argc) {
+            requests = (uint32_t) atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--segments") && i + 1 < argc) {
+            segments = atoi(argv[++i]);
+        } else {
+            fprintf(stderr, "usage: %s [--requests N] [--segments N]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (requests == 0 || segments < 1 || segments > MAX_SEGMENTS) {
+        fprintf(stderr, "--requests must be >= 1, --segments 1..%d\n", MAX_SEGMENTS);
+        return 2;
+    }
+    setenv("TZ", "UTC", 1);
+    tzset();
+
+    s_flash   = (uint8_t*) calloc(1, FLASH_SIZE);
+    s_out.data = (char*) malloc(OUT_SIZE + 1);
+    write_image(3, segments, 90001);  // ota_0: aplicatia care ruleaza
+    write_image(4, 0, 0);             // ota_1: sters
+    printf("%d partitions, app image of %d segments in ota_0, ota_1 erased: %u flash reads per walk\n\n", PART_COUNT, segments,
+        (unsigned) reads_per_walk());
+
+    bool ok = true;
+    printf("cache:\n");
+    ok &= check_correctness(requests);
+    printf("\ncost per /hardware request, %u requests:\n", (unsigned) requests);
+    cost_table(requests);
+
+    free(s_out.data);
+    free(s_flash);
+    printf("\n%s\n", ok ? "all checks passed" : "FAILED");
+    return ok ? 0 : 1;
+}
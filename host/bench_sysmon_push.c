@@ -0,0 +1,664 @@
+/*
+ * bench_sysmon_push - fan-out-ul /events din mylibs/sysmon/src/sysmon_push.c
+ *
+ * sysmon_push.c nu depinde de ESP-IDF: aici socket-urile sunt peer-i simulati (send/close
+ * din bench), publisher-ul e bucla de test (sau un thread), sender-ul e pump-ul.
+ *
+ *   1. backpressure, determinist: pe acelasi fan-out sunt abonati un client rapid, unul
+ *      blocat (send intoarce mereu 0), unul cu scrieri partiale care tine pasul, unul prea
+ *      lent, unul care da eroare si unul inchis de httpd (detach). Verifica:
+ *        - rapid/partial primesc exact stream-ul asteptat (fiecare frame reconstruit aici
+ *          din sysmon_stream_telemetry/_tasks: "event: ...\nid: N\ndata: {...}\n\n")
+ *        - blocatul e aruncat exact la al CONFIG_SYSMON_PUSH_QUEUE_DEPTH+1 -lea frame, close o data
+ *        - lentul e aruncat si a primit un prefix al stream-ului; eroarea -> close o data
+ *        - detach elibereaza slotul fara close; un fd refolosit nu e confundat cu slotul vechi
+ *        - attach cu toate sloturile ocupate -> -1, iar sloturile eliberate se refolosesc
+ *        - dupa shutdown nu ramane niciun byte alocat (frame-uri, scratch)
+ *   2. thread-uri: un publisher publica --frames frame-uri fara pauza, sender-ul face pump
+ *      si ataseaza/detaseaza clienti aleator; id-urile primite de fiecare sesiune trebuie sa
+ *      fie consecutive (un client aruncat e reatasat ca sesiune noua), fara leak-uri.
+ *   3. costul per client, 1/2/4/8 clienti, un sample pe secunda ca in sysmon_monitor:
+ *        - polling: fiecare client cere /telemetry la fiecare sample si /tasks la fiecare
+ *          10 -> N codari per sample. Doar codarea: accept, parsarea cererii si headerele
+ *          raspunsului din esp_http_server nu exista pe host, deci polling-ul real costa mai mult.
+ *        - push: o codare per sample + N x (enqueue + send).
+ *      Heap-ul (malloc/realloc/free prin -Wl,--wrap): polling-ul nu aloca (encoder-ul sta pe
+ *      stiva httpd), push-ul tine frame-urile pana le trimite ultimul client plus scratch-ul.
+ *
+ * Usage: bench_sysmon_push [--tasks N] [--samples N] [--frames N] [--seed N]
+ */
+
+#define _GNU_SOURCE  // memmem
+
+#include <malloc.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "sysmon.h"
+#include "sysmon_push.h"
+#include "sysmon_stream.h"
+
+#define SAMPLES     CONFIG_SYSMON_SAMPLE_COUNT
+#define DEPTH       CONFIG_SYSMON_PUSH_QUEUE_DEPTH
+#define MAX_CLIENTS CONFIG_SYSMON_PUSH_MAX_CLIENTS
+#define RX_SIZE     (2u * 1024u * 1024u)
+#define MAX_PEERS   16
+
+/**********************
+ *   SYSMON STATE + UTILS
+ **********************/
+SysMonState self;
+
+const char* _get_task_display_name(const char* task_name) {
+    if (task_name != NULL && strcmp(task_name, "main") == 0) {
+        return "app_main";
+    }
+    return task_name;
+}
+//---------
+esp_err_t _get_wifi_rssi(int8_t* rssi) {
+    *rssi = -61;
+    return ESP_OK;
+}
+
+/**********************
+ *   HEAP ACCOUNTING
+ **********************/
+void* __real_malloc(size_t size);
+void* __real_realloc(void* ptr, size_t size);
+void  __real_free(void* ptr);
+
+static bool   s_heap_track;
+static size_t s_heap_live;
+static size_t s_heap_peak;
+
+static void heap_add(void* ptr) {
+    if (__atomic_load_n(&s_heap_track, __ATOMIC_RELAXED) && ptr) {
+        size_t live = __atomic_add_fetch(&s_heap_live, malloc_usable_size(ptr), __ATOMIC_RELAXED);
+        if (live > s_heap_peak) {
+            s_heap_peak = live;
+        }
+    }
+}
+//---------
+static void heap_sub(void* ptr) {
+    if (__atomic_load_n(&s_heap_track, __ATOMIC_RELAXED) && ptr) {
+        __atomic_sub_fetch(&s_heap_live, malloc_usable_size(ptr), __ATOMIC_RELAXED);
+    }
+}
+//---------
+void* __wrap_malloc(size_t size) {
+    void* p = __real_malloc(size);
+    heap_add(p);
+    return p;
+}
+//---------
+void* __wrap_realloc(void* ptr, size_t size) {
+    heap_sub(ptr);
+    void* p = __real_realloc(ptr, size);
+    heap_add(p);
+    return p;
+}
+//---------
+void __wrap_free(void* ptr) {
+    heap_sub(ptr);
+    __real_free(ptr);
+}
+//---------
+static void heap_reset(bool track) {
+    s_heap_live  = 0;
+    s_heap_peak  = 0;
+    s_heap_track = track;
+}
+
+/**********************
+ *   SIMULATED PEERS
+ **********************/
+typedef enum {
+    PEER_FAST,     // ia tot
+    PEER_STALLED,  // send -> 0 mereu
+    PEER_BUDGET,   // cel mult `budget` bytes per pump, in bucati de cel mult `chunk`
+    PEER_ERROR,    // ia `budget` bytes, apoi send -> -1
+    PEER_DISCARD,  // ia tot, numara doar bytes (costul)
+} peer_mode_t;
+
+typedef struct {
+    peer_mode_t mode;
+    size_t      budget;
+    size_t      chunk;
+    size_t      left;    // din budget, pentru pump-ul curent
+    char*       rx;
+    size_t      rx_len;
+    uint32_t    closes;
+    uint32_t    sends;
+    uint32_t    last_id;  // thread-uri: ultimul id primit in sesiunea curenta
+    bool        session;  // thread-uri: atasat
+    bool        broken;   // thread-uri: id-uri neconsecutive
+} peer_t;
+
+static peer_t s_peers[MAX_PEERS];
+
+static int peer_send(void* ctx, int fd, const char* data, size_t len) {
+    (void) ctx;
+    peer_t* p = &s_peers[fd];
+    p->sends++;
+    switch (p->mode) {
+    case PEER_STALLED:
+        return 0;
+    case PEER_DISCARD:
+        p->rx_len += len;
+        return (int) len;
+    case PEER_ERROR:
+        if (p->left == 0) {
+            return -1;
+        }
+        break;
+    default:
+        break;
+    }
+    size_t n = len;
+    if (p->mode != PEER_FAST) {
+        n = n < p->left ? n : p->left;
+        n = (p->chunk && n > p->chunk) ? p->chunk : n;
+        p->left -= n;
+    }
+    if (n == 0) {
+        return 0;
+    }
+    if (p->rx_len + n > RX_SIZE) {
+        return -1;
+    }
+    memcpy(p->rx + p->rx_len, data, n);
+    p->rx_len += n;
+    return (int) n;
+}
+//---------
+static void peer_close(void* ctx, int fd) {
+    (void) ctx;
+    s_peers[fd].closes++;
+}
+//---------
+/* Bugetul PEER_BUDGET e per pump, al PEER_ERROR pe toata sesiunea */
+static void peers_refill(void) {
+    for (int i = 0; i < MAX_PEERS; i++) {
+        if (s_peers[i].mode == PEER_BUDGET) {
+            s_peers[i].left = s_peers[i].budget;
+        }
+    }
+}
+//---------
+static void peers_reset(void) {
+    for (int i = 0; i < MAX_PEERS; i++) {
+        char* rx = s_peers[i].rx;
+        memset(&s_peers[i], 0, sizeof(s_peers[i]));
+        s_peers[i].rx = rx;
+    }
+}
+
+/**********************
+ *   STATE + EXPECTED FRAMES
+ **********************/
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000u + (uint64_t) ts.tv_nsec;
+}
+//---------
+static float frand(float lo, float hi) {
+    return lo + (hi - lo) * ((float) rand() / (float) RAND_MAX);
+}
+//---------
+static void fill_state(uint32_t tasks) {
+    static const char* names[] = { "main", "IDLE0", "IDLE1", "esp_timer", "sysmon", "lvgl", "cli", "wifi", "tiT", "ipc0" };
+    memset(&self, 0, sizeof(self));
+    self.task_capacity               = (int) tasks;
+    self.tasks                       = (TaskUsageSample*) calloc((size_t) tasks, sizeof(TaskUsageSample));
+    self.history.usage_percent       = (float*) calloc((size_t) tasks * SAMPLES, sizeof(float));
+    self.history.stack_usage_bytes   = (uint32_t*) calloc((size_t) tasks * SAMPLES, sizeof(uint32_t));
+    self.history.stack_usage_percent = (float*) calloc((size_t) tasks * SAMPLES, sizeof(float));
+    for (uint32_t i = 0; i < tasks; i++) {
+        TaskUsageSample* t = &self.tasks[i];
+        if (i < sizeof(names) / sizeof(names[0])) {
+            snprintf(t->task_name, sizeof(t->task_name), "%s", names[i]);
+        } else {
+            snprintf(t->task_name, sizeof(t->task_name), "task_%03u", (unsigned) i);
+        }
+        t->is_active             = true;
+        t->core_id               = (int) (i % 2);
+        t->current_priority      = (UBaseType_t) (rand() % 25);
+        t->stack_size_bytes      = (i % 3 == 1) ? 0U : 2048U + 1024U * (uint32_t) (rand() % 8);
+        t->stack_high_water_mark = (uint32_t) (rand() % 2048);
+    }
+    for (int j = 0; j < SAMPLES; j++) {
+        self.dram_total[j]  = 337000U;
+        self.psram_total[j] = 8u * 1024u * 1024u;
+    }
+    self.psram_seen = true;
+}
+//---------
+static void free_state(void) {
+    free(self.tasks);
+    free(self.history.usage_percent);
+    free(self.history.stack_usage_bytes);
+    free(self.history.stack_usage_percent);
+    memset(&self, 0, sizeof(self));
+}
+//---------
+/* Un sample nou, ca _update_series_buffers() */
+static void advance_sample(void) {
+    int w = self.series_write_index;
+    for (int i = 0; i < self.task_capacity; i++) {
+        TaskUsageSample* t                 = &self.tasks[i];
+        size_t           at                = _history_at(&self, w, i);
+        self.history.usage_percent[at]     = frand(0.0f, 100.0f);
+        self.history.stack_usage_bytes[at] = t->stack_size_bytes ? (uint32_t) (rand() % (int) t->stack_size_bytes) : 0U;
+    }
+    self.cpu_overall_percent[w] = frand(0.0f, 100.0f);
+    self.cpu_core_percent[0][w] = frand(0.0f, 100.0f);
+    self.cpu_core_percent[1][w] = frand(0.0f, 100.0f);
+    self.dram_free[w]           = 100000U + (uint32_t) (rand() % 100000);
+    self.dram_largest_block[w]  = self.dram_free[w] / 2;
+    self.dram_used_percent[w]   = 100.0f * (float) (self.dram_total[w] - self.dram_free[w]) / (float) self.dram_total[w];
+    self.psram_free[w]          = self.psram_total[w] - (uint32_t) (rand() % 1000000);
+    self.psram_used_percent[w]  = 100.0f * (float) (self.psram_total[w] - self.psram_free[w]) / (float) self.psram_total[w];
+    self.series_write_index     = (w + 1) % SAMPLES;
+    self.sample_seq++;
+}
+//---------
+typedef struct {
+    char*  data;
+    size_t len;
+} text_t;
+
+static esp_err_t text_write(void* ctx, const char* data, size_t len) {
+    text_t* t = (text_t*) ctx;
+    if (t->len + len > RX_SIZE) {
+        return ESP_ERR_NO_MEM;
+    }
+    memcpy(t->data + t->len, data, len);
+    t->len += len;
+    return ESP_OK;
+}
+//---------
+/* Frame-ul asteptat, construit independent de sysmon_push_encode() */
+static void expect_frame(text_t* out, const char* event, uint32_t id, sysmon_push_doc_fn doc) {
+    char header[48];
+    int  n = snprintf(header, sizeof(header), "event: %s\nid: %u\ndata: ", event, (unsigned) id);
+    text_write(out, header, (size_t) n);
+    sysmon_stream_t       stream;
+    sysmon_stream_query_t query = { 0 };
+    sysmon_stream_init(&stream, SYSMON_STREAM_JSON, text_write, out);
+    doc(&stream, &self, &query);
+    sysmon_stream_finish(&stream);
+    text_write(out, "\n\n", 2);
+}
+//---------
+/* Discard sink pentru polling: encoder-ul pe stiva, chunk-urile nu merg nicaieri */
+static esp_err_t discard_write(void* ctx, const char* data, size_t len) {
+    (void) data;
+    *(size_t*) ctx += len;
+    return ESP_OK;
+}
+
+/**********************
+ *   1. BACKPRESSURE
+ **********************/
+enum { FD_FAST = 1, FD_STALLED, FD_PARTIAL, FD_LAGGING, FD_ERROR, FD_DETACH, FD_FILL1, FD_FILL2, FD_LATE };
+
+static bool expect(bool cond, const char* what) {
+    printf("  %-66s %s\n", what, cond ? "ok" : "FAIL");
+    return cond;
+}
+//---------
+static bool prefix_of(const peer_t* p, const text_t* stream) {
+    return p->rx_len <= stream->len && memcmp(p->rx, stream->data, p->rx_len) == 0;
+}
+//---------
+static bool check_backpressure(uint32_t samples) {
+    sysmon_push_t push;
+    text_t        stream = { (char*) malloc(RX_SIZE), 0 };
+    size_t        max_frame = 0;
+    size_t        detach_at = 0;
+    bool          ok        = true;
+
+    if (MAX_CLIENTS < 8) {
+        printf("backpressure test needs CONFIG_SYSMON_PUSH_MAX_CLIENTS >= 8\n");
+        return false;
+    }
+    // Marimea frame-urilor, pentru bugetele clientilor partial/lent
+    text_t probe = { (char*) malloc(RX_SIZE), 0 };
+    expect_frame(&probe, "tasks", 1, sysmon_stream_tasks);
+    size_t tasks_len = probe.len;
+    probe.len        = 0;
+    expect_frame(&probe, "telemetry", 1, sysmon_stream_telemetry);
+    size_t telemetry_len = probe.len;
+    free(probe.data);
+
+    peers_reset();
+    heap_reset(true);
+    sysmon_push_init(&push, peer_send, peer_close, NULL);
+
+    s_peers[FD_PARTIAL].mode   = PEER_BUDGET;
+    s_peers[FD_PARTIAL].budget = 2 * (tasks_len + telemetry_len);
+    s_peers[FD_PARTIAL].chunk  = 37;
+    s_peers[FD_LAGGING].mode   = PEER_BUDGET;
+    s_peers[FD_LAGGING].budget = telemetry_len / 2;
+    s_peers[FD_STALLED].mode   = PEER_STALLED;
+    s_peers[FD_ERROR].mode     = PEER_ERROR;
+    s_peers[FD_ERROR].left     = 3 * telemetry_len;
+    for (int fd = FD_FAST; fd <= FD_FILL2; fd++) {
+        if (sysmon_push_attach(&push, fd) < 0) {
+            ok = expect(false, "attach");
+        }
+    }
+    ok &= expect(sysmon_push_attach(&push, FD_LATE) == -1, "attach with all slots taken -> -1");
+    ok &= expect(sysmon_push_has_clients(&push), "has_clients");
+
+    uint32_t stalled_dropped_at = 0;
+    for (uint32_t s = 0; s < samples; s++) {
+        advance_sample();
+        s_heap_track = false;
+        expect_frame(&stream, "telemetry", push.seq + 1, sysmon_stream_telemetry);
+        if (s % CONFIG_SYSMON_PUSH_TASKS_EVERY == 0) {
+            expect_frame(&stream, "tasks", push.seq + 2, sysmon_stream_tasks);
+        }
+        s_heap_track = true;
+
+        sysmon_push_frame_t* frame = sysmon_push_encode(&push, "telemetry", sysmon_stream_telemetry, &self);
+        max_frame                  = frame && frame->length > max_frame ? frame->length : max_frame;
+        sysmon_push_publish(&push, frame);
+        if (s % CONFIG_SYSMON_PUSH_TASKS_EVERY == 0) {
+            frame     = sysmon_push_encode(&push, "tasks", sysmon_stream_tasks, &self);
+            max_frame = frame && frame->length > max_frame ? frame->length : max_frame;
+            sysmon_push_publish(&push, frame);
+        }
+        if (stalled_dropped_at == 0 && push.clients[FD_STALLED - 1].state != SYSMON_PUSH_ACTIVE) {
+            stalled_dropped_at = push.seq;
+        }
+        peers_refill();
+        sysmon_push_pump(&push);
+
+        if (s == 5) {
+            // httpd a inchis socket-ul: fara close din fan-out
+            detach_at = stream.len;
+            ok &= expect(sysmon_push_detach(&push, FD_DETACH), "detach of a subscribed fd");
+            ok &= expect(!sysmon_push_detach(&push, FD_DETACH), "second detach of the same fd is a no-op");
+        }
+        if (s == 6) {
+            // Un slot e liber de la detach (si de la clientii aruncati): FD_LATE intra
+            s_peers[FD_LATE].mode = PEER_FAST;
+            ok &= expect(sysmon_push_attach(&push, FD_LATE) >= 0, "attach after slots were freed");
+        }
+    }
+
+    const peer_t* fast = &s_peers[FD_FAST];
+    ok &= expect(fast->rx_len == stream.len && memcmp(fast->rx, stream.data, stream.len) == 0,
+        "fast client: every frame, byte-exact");
+    ok &= expect(s_peers[FD_PARTIAL].rx_len == stream.len && memcmp(s_peers[FD_PARTIAL].rx, stream.data, stream.len) == 0,
+        "partial writes (37 B per send): every frame, byte-exact");
+    ok &= expect(stalled_dropped_at == DEPTH + 1 && s_peers[FD_STALLED].closes == 1 && s_peers[FD_STALLED].rx_len == 0,
+        "stalled client dropped at frame DEPTH+1, closed once");
+    ok &= expect(s_peers[FD_LAGGING].closes == 1 && prefix_of(&s_peers[FD_LAGGING], &stream) && s_peers[FD_LAGGING].rx_len > 0,
+        "lagging client dropped, closed once, got a prefix of the stream");
+    ok &= expect(s_peers[FD_ERROR].closes == 1 && prefix_of(&s_peers[FD_ERROR], &stream),
+        "send error: closed once, got a prefix of the stream");
+    ok &= expect(s_peers[FD_DETACH].closes == 0 && s_peers[FD_DETACH].rx_len == detach_at
+                     && prefix_of(&s_peers[FD_DETACH], &stream),
+        "detached client: never closed by the fan-out, stream up to the detach");
+    ok &= expect(push.dropped == 2, "2 clients dropped for a full queue (stalled, lagging)");
+    ok &= expect(s_peers[FD_LATE].rx_len > 0 && memmem(stream.data, stream.len, s_peers[FD_LATE].rx, s_peers[FD_LATE].rx_len) != NULL,
+        "late client: the frames published after its attach");
+
+    int before_shutdown = sysmon_push_pump(&push);
+    sysmon_push_shutdown(&push);
+    ok &= expect(before_shutdown == 5, "5 clients still active at the end");
+    ok &= expect(s_peers[FD_FAST].closes == 1 && s_peers[FD_DETACH].closes == 0, "shutdown closes the active clients only");
+    printf("  frames up to %zu B, heap peak %zu B, after shutdown %zu B\n", max_frame, s_heap_peak, s_heap_live);
+    ok &= expect(s_heap_live == 0, "no frame or scratch left allocated");
+    heap_reset(false);
+    free(stream.data);
+    return ok;
+}
+
+/**********************
+ *   2. THREADS
+ **********************/
+static uint32_t s_closes_after_detach;
+
+typedef struct {
+    sysmon_push_t* push;
+    uint32_t       frames;
+    volatile bool  done;
+} publisher_t;
+
+static void* publisher_thread(void* arg) {
+    publisher_t* pub = (publisher_t*) arg;
+    for (uint32_t i = 0; i < pub->frames; i++) {
+        bool tasks = (i % CONFIG_SYSMON_PUSH_TASKS_EVERY) == 0;
+        sysmon_push_publish(pub->push, sysmon_push_encode(pub->push, tasks ? "tasks" : "telemetry",
+                                           tasks ? sysmon_stream_tasks : sysmon_stream_telemetry, &self));
+        if ((i & 7) == 0) {
+            sched_yield();
+        }
+    }
+    __atomic_store_n(&pub->done, true, __ATOMIC_RELEASE);
+    return NULL;
+}
+//---------
+/* Peer-ul din testul cu thread-uri verifica id-urile frame cu frame (un client rapid ia frame-ul intreg) */
+static int thread_send(void* ctx, int fd, const char* data, size_t len) {
+    (void) ctx;
+    peer_t*  p  = &s_peers[fd];
+    unsigned id = 0;
+    char     event[16];
+    p->sends++;
+    if (sscanf(data, "event: %15s\nid: %u\n", event, &id) != 2 || data[len - 1] != '\n' || data[len - 2] != '\n') {
+        p->broken = true;
+    } else if (p->last_id != 0 && id != p->last_id + 1) {
+        p->broken = true;
+    }
+    p->last_id = id;
+    p->rx_len += len;
+    return (int) len;
+}
+//---------
+/* Un close pentru o sesiune deja detasata (httpd a inchis socket-ul) ar fi un al doilea close() */
+static void thread_close(void* ctx, int fd) {
+    (void) ctx;
+    if (!s_peers[fd].session) {
+        s_closes_after_detach++;
+    }
+    s_peers[fd].closes++;
+    s_peers[fd].session = false;
+}
+//---------
+static bool check_threads(uint32_t frames) {
+    sysmon_push_t push;
+    publisher_t   pub = { &push, frames, false };
+    pthread_t     thread;
+    uint32_t      attaches = 0, detaches = 0, pumps = 0, sessions_broken = 0;
+
+    peers_reset();
+    s_closes_after_detach = 0;
+    heap_reset(true);
+    sysmon_push_init(&push, thread_send, thread_close, NULL);
+    pthread_create(&thread, NULL, publisher_thread, &pub);
+    while (!__atomic_load_n(&pub.done, __ATOMIC_ACQUIRE)) {
+        int     fd = 1 + rand() % 12;
+        peer_t* p  = &s_peers[fd];
+        if (!p->session && rand() % 8 == 0) {
+            if (sysmon_push_attach(&push, fd) >= 0) {
+                sessions_broken += p->broken;
+                p->session = true;
+                p->last_id = 0;
+                p->broken  = false;
+                attaches++;
+            }
+        } else if (p->session && rand() % 64 == 0) {
+            sysmon_push_detach(&push, fd);
+            p->session = false;
+            detaches++;
+        }
+        sysmon_push_pump(&push);
+        pumps++;
+    }
+    pthread_join(thread, NULL);
+    sysmon_push_pump(&push);
+    for (int fd = 0; fd < MAX_PEERS; fd++) {
+        sessions_broken += s_peers[fd].broken;
+    }
+    uint32_t closes = 0;
+    for (int fd = 0; fd < MAX_PEERS; fd++) {
+        closes += s_peers[fd].closes;
+    }
+    sysmon_push_shutdown(&push);
+
+    bool ok = true;
+    printf("  %u frames, %u pumps, %u attaches, %u detaches, %u drops (slow), %u closes before shutdown\n", (unsigned) frames,
+        (unsigned) pumps, (unsigned) attaches, (unsigned) detaches, (unsigned) push.dropped, (unsigned) closes);
+    ok &= expect(attaches > 0 && sessions_broken == 0, "every session: consecutive ids, whole frames");
+    ok &= expect(closes <= push.dropped && s_closes_after_detach == 0, "dropped clients closed at most once, detached ones never");
+    ok &= expect(s_heap_live == 0, "no frame or scratch left allocated");
+    heap_reset(false);
+    return ok;
+}
+
+/**********************
+ *   3. COST PER CLIENT
+ **********************/
+#define COST_REPS 5  // Se pastreaza cea mai rapida repetare (zgomotul de scheduling doar adauga)
+
+/* Polling: N x /telemetry per sample, N x /tasks la fiecare CONFIG_SYSMON_PUSH_TASKS_EVERY. us per sample */
+static double poll_run(int n, uint32_t samples, size_t* bytes) {
+    uint64_t t0 = now_ns();
+    *bytes      = 0;
+    for (uint32_t s = 0; s < samples; s++) {
+        advance_sample();
+        for (int i = 0; i < n; i++) {
+            sysmon_stream_t       stream;
+            sysmon_stream_query_t query = { 0 };
+            sysmon_stream_init(&stream, SYSMON_STREAM_JSON, discard_write, bytes);
+            sysmon_stream_telemetry(&stream, &self, &query);
+            sysmon_stream_finish(&stream);
+            if (s % CONFIG_SYSMON_PUSH_TASKS_EVERY == 0) {
+                sysmon_stream_init(&stream, SYSMON_STREAM_JSON, discard_write, bytes);
+                sysmon_stream_tasks(&stream, &self, &query);
+                sysmon_stream_finish(&stream);
+            }
+        }
+    }
+    return (double) (now_ns() - t0) / 1000.0 / samples;
+}
+//---------
+/* Push: o codare per sample, N x (enqueue + send). us per sample, heap-ul de varf al fan-out-ului */
+static double push_run(int n, uint32_t samples, size_t* bytes, size_t* heap_peak) {
+    sysmon_push_t push;
+    peers_reset();
+    heap_reset(true);
+    sysmon_push_init(&push, peer_send, peer_close, NULL);
+    for (int i = 0; i < n; i++) {
+        s_peers[i].mode = PEER_DISCARD;
+        sysmon_push_attach(&push, i);
+    }
+    uint64_t t0 = now_ns();
+    for (uint32_t s = 0; s < samples; s++) {
+        advance_sample();
+        sysmon_push_publish(&push, sysmon_push_encode(&push, "telemetry", sysmon_stream_telemetry, &self));
+        if (s % CONFIG_SYSMON_PUSH_TASKS_EVERY == 0) {
+            sysmon_push_publish(&push, sysmon_push_encode(&push, "tasks", sysmon_stream_tasks, &self));
+        }
+        sysmon_push_pump(&push);
+    }
+    double us  = (double) (now_ns() - t0) / 1000.0 / samples;
+    *bytes     = s_peers[0].rx_len;
+    *heap_peak = s_heap_peak;
+    sysmon_push_shutdown(&push);
+    heap_reset(false);
+    return us;
+}
+//---------
+static void cost_table(uint32_t samples) {
+    static const int counts[] = { 1, 2, 4, 8 };
+
+    printf("%-8s | %12s %12s %10s | %12s %12s %10s %10s %10s\n", "CLIENTS", "POLL[us/s]", "PER-CLI[us]", "BYTES/CLI",
+        "PUSH[us/s]", "PER-CLI[us]", "BYTES/CLI", "HEAP-PK[B]", "SLOTS[B]");
+    double poll_one = 0.0, push_one = 0.0;
+    for (size_t c = 0; c < sizeof(counts) / sizeof(counts[0]); c++) {
+        int    n         = counts[c];
+        double poll_us   = 1e30, push_us = 1e30;
+        size_t poll_bytes = 0, push_bytes = 0, heap_peak = 0;
+        for (int r = 0; r < COST_REPS; r++) {
+            double us = poll_run(n, samples, &poll_bytes);
+            poll_us   = us < poll_us ? us : poll_us;
+            us        = push_run(n, samples, &push_bytes, &heap_peak);
+            push_us   = us < push_us ? us : push_us;
+        }
+        if (n == 1) {
+            poll_one = poll_us;
+            push_one = push_us;
+        }
+        printf("%-8d | %12.1f %12.1f %10zu | %12.1f %12.1f %10zu %10zu %10zu\n", n, poll_us,
+            n == 1 ? poll_us : (poll_us - poll_one) / (n - 1), poll_bytes / (size_t) n / samples, push_us,
+            n == 1 ? push_us : (push_us - push_one) / (n - 1), push_bytes / samples, heap_peak,
+            sizeof(sysmon_push_client_t) * (size_t) n);
+    }
+    printf("PER-CLI = cost of each client after the first (for 1 client: the total). Polling counts only the\n");
+    printf("encoding: accepting the request and the HTTP headers (~200 B per poll) come on top on the device.\n");
+    printf("HEAP-PK = frames in flight + scratch; frames are shared, so the worst case is %d queued frames\n", DEPTH);
+    printf("+ scratch whatever the client count. SLOTS = client slots (sysmon_push_t: %d slots, %zu B in .bss).\n",
+        MAX_CLIENTS, sizeof(sysmon_push_t));
+}
+
+int main(int argc, char** argv) {
+    uint32_t tasks   = 24;
+    uint32_t samples = 500;
+    uint32_t frames  = 20000;
+    unsigned seed    = 1;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--tasks") && i + 1 < argc) {
+            tasks = (uint32_t) atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--samples") && i + 1 < argc) {
+            samples = (uint32_t) atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--frames") && i + 1 < argc) {
+            frames = (uint32_t) atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--seed") && i + 1 < argc) {
+            seed = (unsigned) atoi(argv[++i]);
+        } else {
+            fprintf(stderr, "usage: %s [--tasks N] [--samples N] [--frames N] [--seed N]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (tasks == 0 || tasks > SYSMON_MAX_TRACKED_TASKS || samples < 2 * DEPTH + 10 || frames == 0) {
+        fprintf(stderr, "--tasks must be 1..%d, --samples >= %d, --frames >= 1\n", SYSMON_MAX_TRACKED_TASKS, 2 * DEPTH + 10);
+        return 2;
+    }
+    srand(seed);
+
+    for (int i = 0; i < MAX_PEERS; i++) {
+        s_peers[i].rx = (char*) malloc(RX_SIZE);
+    }
+    fill_state(tasks);
+    printf("%u tasks, queue depth %d, %d client slots, tasks event every %d samples\n\n", (unsigned) tasks, DEPTH, MAX_CLIENTS,
+        CONFIG_SYSMON_PUSH_TASKS_EVERY);
+
+    bool ok = true;
+    printf("backpressure (%u samples):\n", (unsigned) samples);
+    ok &= check_backpressure(samples);
+    printf("\npublisher thread + pumping sender with client churn:\n");
+    ok &= check_threads(frames);
+    printf("\ncost per sample (one sample per second on the device), %u samples:\n", (unsigned) samples);
+    cost_table(samples);
+
+    free_state();
+    for (int i = 0; i < MAX_PEERS; i++) {
+        free(s_peers[i].rx);
+    }
+    printf("\n%s\n", ok ? "all checks passed" : "FAILED");
+    return ok ? 0 : 1;
+}
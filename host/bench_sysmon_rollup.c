@@ -0,0 +1,348 @@
+/*
+ * bench_sysmon_rollup - corectitudinea si memoria tier-elor min/avg/max din sysmon
+ *
+ * Trece un sir de sample-uri aleatoare (seriile sistem + --tasks sloturi de task) prin
+ * mylibs/sysmon/src/sysmon_rollup.c, exact ca _update_rollups() din sysmon.c, si pastreaza
+ * separat toate valorile brute. Dupa fiecare bucket inchis il recalculeaza din valorile
+ * brute (min, max, media rotunjita) si il compara cu cel stocat; la final verifica toate
+ * inelele. Pe parcurs:
+ *
+ *   - tabela porneste cu 3/4 din sloturi si creste la --tasks la 1/3 din rulare (in mijlocul
+ *     unui bucket deschis; sloturile noi conteaza 0 pentru sample-urile de dinainte)
+ *   - la fiecare --churn-every sample-uri un slot e dat altui task (sysmon_rollup_clear_slot):
+ *     coloana lui devine 0 in toate sample-urile de pana atunci, ca randul de istorie
+ *
+ * Memoria: malloc/calloc/free sunt interceptate (-Wl,--wrap) si numara octetii ceruti; dupa
+ * resize la --tasks, blocul de randuri + acumulatorii trebuie sa fie exact cat da formula
+ * din header. Tabelul compara cu aceleasi tier-e stocate ca float si cu o istorie bruta
+ * float care ar acoperi aceeasi ora.
+ *
+ * Usage: bench_sysmon_rollup [--tasks N] [--samples N] [--churn-every N] [--seed N]
+ */
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "sysmon_rollup.h"
+
+#define BUCKETS     CONFIG_SYSMON_ROLLUP_BUCKETS
+#define SYS         SYSMON_ROLLUP_SYS_METRICS
+#define TASK        SYSMON_ROLLUP_TASK_METRICS
+#define MAX_ALLOCS  32
+
+/**********************
+ *   HEAP ACCOUNTING
+ **********************/
+void* __real_malloc(size_t size);
+void* __real_calloc(size_t n, size_t size);
+void  __real_free(void* ptr);
+
+typedef struct {
+    void*  ptr;
+    size_t size;
+} alloc_t;
+
+static bool    s_heap_track;
+static alloc_t s_allocs[MAX_ALLOCS];
+static size_t  s_heap_live;
+
+static void heap_add(void* ptr, size_t size) {
+    if (!s_heap_track || ptr == NULL) {
+        return;
+    }
+    for (int i = 0; i < MAX_ALLOCS; i++) {
+        if (s_allocs[i].ptr == NULL) {
+            s_allocs[i] = (alloc_t) { ptr, size };
+            s_heap_live += size;
+            return;
+        }
+    }
+}
+//---------
+static void heap_sub(void* ptr) {
+    for (int i = 0; i < MAX_ALLOCS && ptr != NULL; i++) {
+        if (s_allocs[i].ptr == ptr) {
+            s_heap_live -= s_allocs[i].size;
+            s_allocs[i].ptr = NULL;
+            return;
+        }
+    }
+}
+//---------
+void* __wrap_malloc(size_t size) {
+    void* p = __real_malloc(size);
+    heap_add(p, size);
+    return p;
+}
+//---------
+void* __wrap_calloc(size_t n, size_t size) {
+    void* p = __real_calloc(n, size);
+    heap_add(p, n * size);
+    return p;
+}
+//---------
+void __wrap_free(void* ptr) {
+    heap_sub(ptr);
+    __real_free(ptr);
+}
+
+/**********************
+ *   REFERINTA
+ **********************/
+static uint32_t  s_rng;
+static uint16_t* s_raw_sys;   // [sample][SYS]
+static uint16_t* s_raw_task;  // [sample][tasks][TASK]
+static int       s_tasks;
+
+static uint32_t rng(void) {
+    s_rng ^= s_rng << 13;
+    s_rng ^= s_rng >> 17;
+    s_rng ^= s_rng << 5;
+    return s_rng;
+}
+//---------
+/* Procente in sutimi, KiB pe 16 biti; capetele intervalelor apar des */
+static uint16_t random_value(bool percent) {
+    uint32_t r = rng() % 16;
+    if (r == 0) {
+        return 0;
+    }
+    if (r == 1) {
+        return percent ? 10000 : SYSMON_ROLLUP_VALUE_MAX;
+    }
+    return (uint16_t) (percent ? rng() % 10001 : rng() % (SYSMON_ROLLUP_VALUE_MAX + 1));
+}
+//---------
+static bool sys_is_percent(int metric) {
+    return metric <= SYSMON_ROLLUP_SYS_PSRAM_USED;
+}
+//---------
+/* min/avg/max asteptat pentru o serie peste sample-urile [from, from + width) */
+static void expected(const uint16_t* base, size_t stride, uint32_t from, uint16_t width, uint16_t out[3]) {
+    uint32_t sum = 0;
+    uint16_t lo  = 0xFFFF;
+    uint16_t hi  = 0;
+    for (uint32_t s = from; s < from + width; s++) {
+        uint16_t v = base[(size_t) s * stride];
+        sum += v;
+        lo = v < lo ? v : lo;
+        hi = v > hi ? v : hi;
+    }
+    out[SYSMON_ROLLUP_MIN] = lo;
+    out[SYSMON_ROLLUP_AVG] = (uint16_t) ((sum + width / 2u) / width);
+    out[SYSMON_ROLLUP_MAX] = hi;
+}
+//---------
+static int compare_cell(const sysmon_rollup_tier_t* tier, const uint16_t* stored, const uint16_t exp[3], const char* what, int t,
+                        uint32_t bucket_no, int errors) {
+    bool ok = tier->fields == 1 ? stored[0] == exp[SYSMON_ROLLUP_AVG] && exp[SYSMON_ROLLUP_MIN] == exp[SYSMON_ROLLUP_MAX]
+                                : memcmp(stored, exp, 3 * sizeof(uint16_t)) == 0;
+    if (!ok && errors < 5) {
+        printf("  tier %d bucket %u %s: stored %u/%u/%u, expected %u/%u/%u\n", t, (unsigned) bucket_no, what, stored[0],
+               stored[tier->fields == 1 ? 0 : 1], stored[tier->fields == 1 ? 0 : 2], exp[0], exp[1], exp[2]);
+    }
+    return ok ? 0 : 1;
+}
+//---------
+/* Verifica bucket-ul cu numarul bucket_no (1 = primul inchis) al tier-ului t */
+static int check_bucket(const sysmon_rollup_t* r, int t, uint32_t bucket_no, int errors) {
+    const sysmon_rollup_tier_t* tier = &r->tier[t];
+    int                         b    = (int) ((bucket_no - 1) % BUCKETS);
+    uint32_t                    from = (bucket_no - 1) * tier->width;
+    uint16_t                    exp[3];
+    int                         bad = 0;
+    for (int m = 0; m < SYS; m++) {
+        expected(&s_raw_sys[m], SYS, from, tier->width, exp);
+        bad += compare_cell(tier, &tier->system[sysmon_rollup_sys_at(tier, b, m, 0)], exp, "system", t, bucket_no, errors + bad);
+    }
+    for (int slot = 0; slot < r->capacity; slot++) {
+        for (int m = 0; m < TASK; m++) {
+            expected(&s_raw_task[(size_t) slot * TASK + m], (size_t) s_tasks * TASK, from, tier->width, exp);
+            bad += compare_cell(tier, &tier->tasks[sysmon_rollup_task_at(tier, r->capacity, b, slot, m, 0)], exp, "task", t,
+                                bucket_no, errors + bad);
+        }
+    }
+    return bad;
+}
+
+/**********************
+ *   RULARE
+ **********************/
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000u + (uint64_t) ts.tv_nsec;
+}
+//---------
+static int check_encoders(void) {
+    struct {
+        float    in;
+        uint16_t out;
+    } percent[] = {
+        { -1.0f, 0 }, { 0.0f, 0 }, { NAN, 0 }, { 0.004f, 0 }, { 0.005f, 1 }, { 42.125f, 4213 }, { 99.994f, 9999 }, { 100.0f, 10000 }, { 250.0f, 10000 },
+    };
+    int errors = 0;
+    for (size_t i = 0; i < sizeof(percent) / sizeof(percent[0]); i++) {
+        uint16_t got = sysmon_rollup_percent(percent[i].in);
+        if (got != percent[i].out) {
+            printf("  sysmon_rollup_percent(%g) = %u, expected %u\n", (double) percent[i].in, got, percent[i].out);
+            errors++;
+        }
+    }
+    if (sysmon_rollup_kib(1023) != 0 || sysmon_rollup_kib(300 * 1024 + 1023) != 300 || sysmon_rollup_kib(70u << 20) != SYSMON_ROLLUP_VALUE_MAX) {
+        printf("  sysmon_rollup_kib() rounding/saturation wrong\n");
+        errors++;
+    }
+    return errors;
+}
+//---------
+int main(int argc, char** argv) {
+    int      tasks       = 64;
+    uint32_t samples     = 0;
+    uint32_t churn_every = 97;
+    uint32_t seed        = 12345;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--tasks") && i + 1 < argc) {
+            tasks = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--samples") && i + 1 < argc) {
+            samples = (uint32_t) strtoul(argv[++i], NULL, 0);
+        } else if (!strcmp(argv[i], "--churn-every") && i + 1 < argc) {
+            churn_every = (uint32_t) strtoul(argv[++i], NULL, 0);
+        } else if (!strcmp(argv[i], "--seed") && i + 1 < argc) {
+            seed = (uint32_t) strtoul(argv[++i], NULL, 0);
+        } else {
+            fprintf(stderr, "usage: %s [--tasks N] [--samples N] [--churn-every N] [--seed N]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    sysmon_rollup_t r;
+    sysmon_rollup_init(&r);
+    if (samples == 0) {
+        samples = 2 * BUCKETS * r.tier[SYSMON_ROLLUP_TIERS - 1].width + 17;  // Fiecare inel se umple de doua ori
+    }
+    if (tasks < 4 || samples < 2 || churn_every == 0) {
+        fprintf(stderr, "invalid parameters\n");
+        return 2;
+    }
+    s_tasks    = tasks;
+    s_rng      = seed ? seed : 1;
+    s_raw_sys  = (uint16_t*) calloc((size_t) samples * SYS, sizeof(uint16_t));
+    s_raw_task = (uint16_t*) calloc((size_t) samples * tasks * TASK, sizeof(uint16_t));
+    if (s_raw_sys == NULL || s_raw_task == NULL) {
+        return 1;
+    }
+
+    printf("sysmon rollups: %d tiers x %d buckets of", SYSMON_ROLLUP_TIERS, BUCKETS);
+    for (int t = 0; t < SYSMON_ROLLUP_TIERS; t++) {
+        printf(" %u", r.tier[t].width);
+    }
+    printf(" samples, %d tasks, %u samples, churn every %u\n\n", tasks, (unsigned) samples, (unsigned) churn_every);
+
+    int errors = check_encoders();
+
+    // 1. Memoria la `tasks` sloturi, dintr-un store gol
+    void* old = NULL;
+    s_heap_track = true;
+    sysmon_rollup_resize(&r, tasks, &old);
+    size_t measured = s_heap_live;
+    s_heap_track    = false;
+    size_t values   = 0;
+    size_t floats   = 0;
+    for (int t = 0; t < SYSMON_ROLLUP_TIERS; t++) {
+        values += (size_t) BUCKETS * (SYS + (size_t) tasks * TASK) * r.tier[t].fields;
+        floats += (size_t) BUCKETS * (SYS + (size_t) tasks * TASK) * 3;
+    }
+    size_t exp_block = values * sizeof(uint16_t);
+    size_t exp_acc   = SYSMON_ROLLUP_TIERS * (SYS + (size_t) tasks * TASK) * sizeof(sysmon_rollup_acc_t);
+    size_t span      = (size_t) BUCKETS * r.tier[SYSMON_ROLLUP_TIERS - 1].width;  // sample-uri acoperite de ultimul tier
+    size_t raw_float = span * ((size_t) tasks * 3 + 11) * sizeof(float);        // TaskHistory (3 serii) + seriile sistem
+    bool   mem_ok    = measured == exp_block + exp_acc && sysmon_rollup_block_bytes(tasks) == exp_block &&
+                  sysmon_rollup_acc_bytes(tasks) == exp_acc;
+    printf("  memory for %d tasks                              bytes\n", tasks);
+    printf("  rollup rows, uint16 (1 value per 1-sample bucket) %8zu   (PSRAM when present)\n", exp_block);
+    printf("  accumulators (sampler only)                       %8zu\n", exp_acc);
+    printf("  measured by malloc/calloc                         %8zu   %s\n", measured, mem_ok ? "ok" : "MISMATCH");
+    printf("  same tiers as float min/avg/max                   %8zu   (%.1fx)\n", floats * sizeof(float),
+           (double) (floats * sizeof(float)) / (double) exp_block);
+    printf("  raw float history over the same %zu samples     %8zu   (%.1fx)\n\n", span, raw_float, (double) raw_float / (double) exp_block);
+    errors += mem_ok ? 0 : 1;
+    sysmon_rollup_free(&r);
+
+    // 2. Corectitudinea: porneste cu 3/4 din sloturi, creste in mijlocul unui bucket
+    int capacity = tasks * 3 / 4;
+    sysmon_rollup_resize(&r, capacity, &old);
+    uint32_t grow_at    = samples / 3 + 3;
+    uint32_t checked[SYSMON_ROLLUP_TIERS] = { 0 };
+    uint32_t clears     = 0;
+    uint64_t add_ns     = 0;
+    for (uint32_t s = 0; s < samples; s++) {
+        if (s == grow_at) {
+            if (sysmon_rollup_resize(&r, tasks, &old) != ESP_OK) {
+                printf("  resize failed\n");
+                return 1;
+            }
+            free(old);
+            capacity = tasks;
+        }
+        if (s > 0 && s % churn_every == 0) {
+            int slot = (int) (rng() % (uint32_t) capacity);
+            sysmon_rollup_clear_slot(&r, slot);
+            for (uint32_t p = 0; p < s; p++) {
+                memset(&s_raw_task[((size_t) p * tasks + slot) * TASK], 0, TASK * sizeof(uint16_t));
+            }
+            clears++;
+        }
+
+        uint16_t* sys = &s_raw_sys[(size_t) s * SYS];
+        uint16_t* tv  = &s_raw_task[(size_t) s * tasks * TASK];
+        for (int m = 0; m < SYS; m++) {
+            sys[m] = random_value(sys_is_percent(m));
+        }
+        for (int slot = 0; slot < capacity; slot++) {
+            tv[slot * TASK + SYSMON_ROLLUP_TASK_CPU]   = random_value(true);
+            tv[slot * TASK + SYSMON_ROLLUP_TASK_STACK] = random_value(true);
+        }
+
+        uint64_t t0 = now_ns();
+        sysmon_rollup_put_system(&r, sys);
+        for (int slot = 0; slot < capacity; slot++) {
+            sysmon_rollup_put_task(&r, slot, tv[slot * TASK + SYSMON_ROLLUP_TASK_CPU], tv[slot * TASK + SYSMON_ROLLUP_TASK_STACK]);
+        }
+        sysmon_rollup_commit(&r);
+        add_ns += now_ns() - t0;
+
+        for (int t = 0; t < SYSMON_ROLLUP_TIERS; t++) {
+            if (r.tier[t].bucket_seq != checked[t]) {
+                checked[t] = r.tier[t].bucket_seq;
+                errors += check_bucket(&r, t, checked[t], errors);
+            }
+        }
+    }
+
+    // 3. Inelele intregi la final (bucket-urile vechi, dupa clear-uri si resize)
+    int ring_errors = 0;
+    for (int t = 0; t < SYSMON_ROLLUP_TIERS; t++) {
+        uint32_t seq   = r.tier[t].bucket_seq;
+        uint32_t count = seq < BUCKETS ? seq : BUCKETS;
+        for (uint32_t k = seq - count + 1; k <= seq && count > 0; k++) {
+            ring_errors += check_bucket(&r, t, k, errors + ring_errors);
+        }
+        printf("  tier %d: %3u samples/bucket, %5u buckets closed, %u pending, newest ring index %d\n", t, r.tier[t].width,
+               (unsigned) seq, r.tier[t].pending, sysmon_rollup_newest(&r.tier[t]));
+    }
+    errors += ring_errors;
+    printf("\n  %u slot clears, resize %d -> %d at sample %u, %.0f ns per sample (put + commit, %d tasks)\n", (unsigned) clears,
+           tasks * 3 / 4, tasks, (unsigned) grow_at, (double) add_ns / samples, tasks);
+
+    sysmon_rollup_free(&r);
+    free(s_raw_sys);
+    free(s_raw_task);
+    printf("\n%s\n", errors == 0 ? "all checks passed" : "FAILED");
+    return errors == 0 ? 0 : 1;
+}
@@ -0,0 +1,394 @@
+/*
+ * bench_sysmon_snapshot - seqlock-ul dintre sampler-ul sysmon si handler-ele HTTP
+ *
+ * Un thread "sysmon_monitor" publica un sample la fiecare --period-us: in aceeasi sectiune
+ * de scriere (sysmon_snapshot_write_begin/_end, ca in sysmon.c) scrie numarul sample-ului s
+ * in toate seriile sistem, in randul nou al istoriei fiecarui task activ si in metadatele
+ * task-urilor, apoi avanseaza series_write_index si sample_seq. La fiecare --resize-every
+ * sample-uri tabela creste cu 8 sloturi prin _tasks_resize() (array-urile vechi sunt retrase,
+ * nu eliberate). --readers thread-uri "httpd" iau snapshot-uri (1 rand ca /telemetry, toate
+ * randurile ca /history), verifica view-ul si simuleaza encodarea (--encode-us de busy-wait).
+ *
+ * Un view e rupt (torn) daca vreo valoare nu corespunde lui view->sample_seq: seria de la
+ * k sample-uri in urma trebuie sa fie s - k, istoria unui task tot s - k (sau 0 inainte sa
+ * existe slotul), metadatele s.
+ *
+ * Moduri:
+ *   idle    : doar sampler-ul (referinta pentru jitter)
+ *   seqlock : sysmon_snapshot_take(), encodarea in afara oricarui lock - trebuie 0 rupturi
+ *   mutex   : alternativa respinsa - un mutex tinut de reader pe copiere + encodare,
+ *             sampler-ul asteapta clientii HTTP lenti
+ *   racy    : codul vechi - sampler-ul fara sectiuni de scriere (fara resize), reader-ul
+ *             encodeaza direct din `self`; rupturile sunt doar raportate, arata ce
+ *             prinde seqlock-ul
+ *
+ * Jitter-ul = cat de tarziu e publicat fiecare sample fata de momentul planificat
+ * (p50/p99/max). Orice ruptura in idle/seqlock/mutex -> exit 1.
+ *
+ * Usage: bench_sysmon_snapshot [--samples N] [--period-us N] [--readers N] [--encode-us N]
+ *                              [--tasks N] [--resize-every N]
+ */
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "sysmon.h"
+#include "sysmon_snapshot.h"
+#include "sysmon_tasks.h"
+
+#define SAMPLES       CONFIG_SYSMON_SAMPLE_COUNT
+#define START_TASKS   16
+#define RESIZE_STEP   8
+#define MAX_READERS   16
+#define HOST_TICK_US  100  // vTaskDelay(1) pe host, scalat ca --period-us
+
+/**********************
+ *   SYSMON STATE
+ **********************/
+SysMonState self = { .free_slot = -1 };
+
+/* sysmon_tasks.c -> sysmon_stack.c cer numele task-ului; sysmon_snapshot.c cere vTaskDelay */
+char* pcTaskGetName(TaskHandle_t handle) {
+    (void) handle;
+    return "bench";
+}
+//---------
+void vTaskDelay(const TickType_t ticks) {
+    usleep((useconds_t) ticks * HOST_TICK_US);
+}
+
+/**********************
+ *   PARAMETRI
+ **********************/
+typedef enum {
+    MODE_IDLE = 0,
+    MODE_SEQLOCK,
+    MODE_MUTEX,
+    MODE_RACY,
+} bench_mode_t;
+
+static const char* const MODE_NAMES[] = { "idle", "seqlock", "mutex", "racy" };
+
+typedef struct {
+    uint32_t samples;
+    uint32_t period_us;
+    int      readers;
+    uint32_t encode_us;
+    int      max_tasks;
+    uint32_t resize_every;
+} params_t;
+
+typedef struct {
+    uint64_t takes;
+    uint64_t torn;
+    uint64_t failed;  // ESP_ERR_TIMEOUT / ESP_ERR_NO_MEM
+} reader_stats_t;
+
+static bench_mode_t    s_mode;
+static params_t        s_params;
+static volatile bool   s_stop;
+static pthread_mutex_t s_mutex = PTHREAD_MUTEX_INITIALIZER;
+static reader_stats_t  s_reader_stats[MAX_READERS];
+static uint32_t*       s_lateness_us;
+static uint32_t        s_resizes;
+static uint32_t        s_resizes_deferred;
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000u + (uint64_t) ts.tv_nsec;
+}
+//---------
+static void spin_us(uint32_t us) {
+    uint64_t end = now_ns() + (uint64_t) us * 1000u;
+    while (now_ns() < end) {
+    }
+}
+
+/**********************
+ *   WRITER
+ **********************/
+/* Slotul nou e activat in aceeasi sectiune in care primeste primul sample (prev_run_time_ticks = sample-ul activarii) */
+static void writer_grow(uint32_t s) {
+    int old = self.task_capacity;
+    int cap = old == 0 ? START_TASKS : old + RESIZE_STEP;
+    if (cap > s_params.max_tasks) {
+        cap = s_params.max_tasks;
+    }
+    if (cap <= old) {
+        return;
+    }
+    esp_err_t err = _tasks_resize(cap);
+    if (err == ESP_ERR_NOT_FINISHED) {
+        s_resizes_deferred++;
+        return;
+    }
+    if (err != ESP_OK) {
+        fprintf(stdout, "_tasks_resize(%d) failed\n", cap);
+        exit(1);
+    }
+    s_resizes++;
+    for (int j = old; j < cap; j++) {
+        TaskUsageSample* t     = &self.tasks[j];
+        t->is_active           = true;
+        t->task_id             = (UBaseType_t) j + 1;
+        t->prev_run_time_ticks = s;
+        snprintf(t->task_name, sizeof(t->task_name), "task%d", j);
+    }
+    self.free_slot = -1;
+}
+//---------
+/* Un ciclu al sysmon_monitor: resize ocazional + sample-ul s in serii, istorie si metadate */
+static void writer_publish(uint32_t s) {
+    bool sections = s_mode != MODE_RACY;
+    if (s_mode == MODE_MUTEX) {
+        pthread_mutex_lock(&s_mutex);
+    }
+    if (sections) {
+        sysmon_snapshot_write_begin();
+        if (s_params.resize_every > 0 && s % s_params.resize_every == 0) {
+            writer_grow(s);
+        }
+    }
+
+    int   w = self.series_write_index;
+    float f = (float) s;
+    self.cpu_overall_percent[w] = f;
+    self.cpu_core_percent[0][w] = f;
+    self.cpu_core_percent[1][w] = f;
+    self.dram_free[w]           = s;
+    self.dram_min_free[w]       = s;
+    self.dram_largest_block[w]  = s;
+    self.dram_total[w]          = s;
+    self.dram_used_percent[w]   = f;
+    self.psram_free[w]          = s;
+    self.psram_total[w]         = s;
+    self.psram_used_percent[w]  = f;
+    for (int j = 0; j < self.task_capacity; j++) {
+        size_t at                            = _history_at(&self, w, j);
+        self.history.usage_percent[at]       = f;
+        self.history.stack_usage_bytes[at]   = s;
+        self.history.stack_usage_percent[at] = f;
+        self.tasks[j].total_run_time_ticks   = s;
+        self.tasks[j].last_seen_seq          = s;
+    }
+    self.series_write_index = (w + 1) % SAMPLES;
+    self.sample_seq         = s;
+
+    if (sections) {
+        sysmon_snapshot_write_end();
+    }
+    if (s_mode == MODE_MUTEX) {
+        pthread_mutex_unlock(&s_mutex);
+    }
+}
+//---------
+static void* writer_thread(void* arg) {
+    (void) arg;
+    uint64_t period = (uint64_t) s_params.period_us * 1000u;
+    uint64_t start  = now_ns() + period;
+    for (uint32_t s = 1; s <= s_params.samples; s++) {
+        uint64_t        due = start + (uint64_t) (s - 1) * period;
+        struct timespec ts  = { .tv_sec = (time_t) (due / 1000000000u), .tv_nsec = (long) (due % 1000000000u) };
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) != 0) {
+        }
+        writer_publish(s);
+        uint64_t late        = now_ns() - due;
+        s_lateness_us[s - 1] = (uint32_t) (late / 1000u);
+    }
+    s_stop = true;
+    return NULL;
+}
+
+/**********************
+ *   READERS
+ **********************/
+static uint32_t expected_at(uint32_t s, int back) {
+    return s > (uint32_t) back ? s - (uint32_t) back : 0;
+}
+//---------
+/* Numarul de valori care nu apartin sample-ului s (randul lui e (s - 1) % SAMPLES, series_write_index porneste de la 0) */
+static int check_view(const SysMonState* v, int rows, uint32_t s) {
+    if (s == 0) {
+        return 0;
+    }
+    int bad    = (v->sample_seq != s) + (v->series_write_index != (int) (s % SAMPLES));
+    int newest = (int) ((s - 1) % SAMPLES);
+    for (int k = 0; k < SAMPLES; k++) {
+        int      i  = (newest - k + SAMPLES) % SAMPLES;
+        uint32_t e  = expected_at(s, k);
+        float    ef = (float) e;
+        bad += v->cpu_overall_percent[i] != ef || v->cpu_core_percent[0][i] != ef || v->cpu_core_percent[1][i] != ef;
+        bad += v->dram_free[i] != e || v->dram_min_free[i] != e || v->dram_largest_block[i] != e || v->dram_total[i] != e;
+        bad += v->dram_used_percent[i] != ef || v->psram_free[i] != e || v->psram_total[i] != e || v->psram_used_percent[i] != ef;
+    }
+    for (int j = 0; j < v->task_capacity; j++) {
+        const TaskUsageSample* t = &v->tasks[j];
+        if (!t->is_active) {
+            bad++;
+            continue;
+        }
+        bad += t->total_run_time_ticks != s || t->last_seen_seq != s;
+        for (int r = 0; r < rows; r++) {
+            uint32_t e  = expected_at(s, r);
+            uint32_t ex = e >= t->prev_run_time_ticks ? e : 0;  // Inainte de activare randul e 0
+            size_t   at = _history_at(v, (newest - r + SAMPLES) % SAMPLES, j);
+            bad += v->history.usage_percent[at] != (float) ex || v->history.stack_usage_bytes[at] != ex ||
+                   v->history.stack_usage_percent[at] != (float) ex;
+        }
+    }
+    return bad;
+}
+//---------
+static void* reader_thread(void* arg) {
+    reader_stats_t* st = (reader_stats_t*) arg;
+    for (uint64_t n = 0; !s_stop; n++) {
+        int  rows = (n & 1u) ? SAMPLES : 1;  // /history, apoi /telemetry
+        if (s_mode == MODE_RACY) {
+            // Codul vechi: handler-ul encoda direct din `self` in timp ce sampler-ul scria
+            uint32_t s = self.sample_seq;
+            spin_us(s_params.encode_us);
+            st->takes++;
+            st->torn += check_view(&self, rows, s) != 0;
+            continue;
+        }
+        bool lock = s_mode == MODE_MUTEX;
+        if (lock) {
+            pthread_mutex_lock(&s_mutex);
+        }
+        SysMonState view;
+        esp_err_t   err = sysmon_snapshot_take(&view, rows);
+        if (err == ESP_OK) {
+            st->takes++;
+            st->torn += check_view(&view, rows, view.sample_seq) != 0;
+            spin_us(s_params.encode_us);
+            sysmon_snapshot_release(&view);
+        } else {
+            st->failed++;
+        }
+        if (lock) {
+            pthread_mutex_unlock(&s_mutex);
+        }
+    }
+    return NULL;
+}
+
+/**********************
+ *   RULARE
+ **********************/
+static int cmp_u32(const void* a, const void* b) {
+    uint32_t x = *(const uint32_t*) a;
+    uint32_t y = *(const uint32_t*) b;
+    return (x > y) - (x < y);
+}
+//---------
+static bool run(bench_mode_t mode) {
+    _tasks_free();
+    sysmon_snapshot_cleanup();
+    memset(&self, 0, sizeof(self));
+    self.free_slot     = -1;
+    s_mode             = mode;
+    s_stop             = false;
+    s_resizes          = 0;
+    s_resizes_deferred = 0;
+    memset(s_reader_stats, 0, sizeof(s_reader_stats));
+
+    // Tabela initiala, ca primul _ensure_task_storage_capacity()
+    sysmon_snapshot_write_begin();
+    writer_grow(1);
+    sysmon_snapshot_write_end();
+
+    int       readers = mode == MODE_IDLE ? 0 : s_params.readers;
+    pthread_t writer;
+    pthread_t reader[MAX_READERS];
+    for (int r = 0; r < readers; r++) {
+        pthread_create(&reader[r], NULL, reader_thread, &s_reader_stats[r]);
+    }
+    pthread_create(&writer, NULL, writer_thread, NULL);
+    pthread_join(writer, NULL);
+    for (int r = 0; r < readers; r++) {
+        pthread_join(reader[r], NULL);
+    }
+
+    reader_stats_t total = { 0 };
+    for (int r = 0; r < readers; r++) {
+        total.takes += s_reader_stats[r].takes;
+        total.torn += s_reader_stats[r].torn;
+        total.failed += s_reader_stats[r].failed;
+    }
+    qsort(s_lateness_us, s_params.samples, sizeof(uint32_t), cmp_u32);
+    uint32_t p50 = s_lateness_us[s_params.samples / 2];
+    uint32_t p99 = s_lateness_us[(size_t) s_params.samples * 99 / 100];
+    uint32_t max = s_lateness_us[s_params.samples - 1];
+
+    bool ok = mode == MODE_RACY || total.torn == 0;
+    printf("  %-8s | %7u %7u %8u | %9llu %8llu %6llu | %7u %8u | %3d  %s\n", MODE_NAMES[mode], (unsigned) p50, (unsigned) p99,
+           (unsigned) max, (unsigned long long) total.takes, (unsigned long long) total.torn, (unsigned long long) total.failed,
+           (unsigned) s_resizes, (unsigned) s_resizes_deferred, self.task_capacity,
+           mode == MODE_RACY ? (total.torn > 0 ? "torn (expected)" : "no tear observed") : (ok ? "ok" : "TORN"));
+    return ok;
+}
+//---------
+int main(int argc, char** argv) {
+    s_params = (params_t) {
+        .samples      = 3000,
+        .period_us    = 1000,
+        .readers      = 3,
+        .encode_us    = 300,
+        .max_tasks    = 64,
+        .resize_every = 50,
+    };
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--samples") && i + 1 < argc) {
+            s_params.samples = (uint32_t) strtoul(argv[++i], NULL, 0);
+        } else if (!strcmp(argv[i], "--period-us") && i + 1 < argc) {
+            s_params.period_us = (uint32_t) strtoul(argv[++i], NULL, 0);
+        } else if (!strcmp(argv[i], "--readers") && i + 1 < argc) {
+            s_params.readers = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--encode-us") && i + 1 < argc) {
+            s_params.encode_us = (uint32_t) strtoul(argv[++i], NULL, 0);
+        } else if (!strcmp(argv[i], "--tasks") && i + 1 < argc) {
+            s_params.max_tasks = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--resize-every") && i + 1 < argc) {
+            s_params.resize_every = (uint32_t) strtoul(argv[++i], NULL, 0);
+        } else {
+            fprintf(stderr,
+                    "usage: %s [--samples N] [--period-us N] [--readers N] [--encode-us N] [--tasks N] [--resize-every N]\n",
+                    argv[0]);
+            return 2;
+        }
+    }
+    if (s_params.samples < 2 || s_params.period_us == 0 || s_params.readers < 1 || s_params.readers > MAX_READERS ||
+        s_params.max_tasks < START_TASKS || s_params.max_tasks > SYSMON_MAX_TRACKED_TASKS) {
+        fprintf(stderr, "invalid parameters (readers 1..%d, tasks %d..%d)\n", MAX_READERS, START_TASKS, SYSMON_MAX_TRACKED_TASKS);
+        return 2;
+    }
+    s_lateness_us = (uint32_t*) malloc(s_params.samples * sizeof(uint32_t));
+    if (s_lateness_us == NULL) {
+        return 1;
+    }
+
+    printf("sysmon snapshot: %u samples every %u us, %d readers (1 row / %d rows alternately), encode %u us, %d..%d tasks\n\n",
+           (unsigned) s_params.samples, (unsigned) s_params.period_us, s_params.readers, SAMPLES, (unsigned) s_params.encode_us,
+           START_TASKS, s_params.max_tasks);
+    printf("  mode     |  p50 us  p99 us   max us |     takes     torn failed | resizes deferred | cap\n");
+    printf("  ---------+--------------------------+---------------------------+------------------+-----\n");
+
+    bool ok = true;
+    ok &= run(MODE_IDLE);
+    ok &= run(MODE_SEQLOCK);
+    ok &= run(MODE_MUTEX);
+    run(MODE_RACY);
+
+    _tasks_free();
+    sysmon_snapshot_cleanup();
+    free(s_lateness_us);
+    printf("\n%s\n", ok ? "all checks passed" : "FAILED: torn snapshot");
+    return ok ? 0 : 1;
+}
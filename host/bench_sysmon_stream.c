@@ -0,0 +1,969 @@
+/*
+ * bench_sysmon_stream - /tasks, /history, /telemetry through mylibs/sysmon/src/sysmon_stream.c
+ *
+ * Umple `self` (SysMonState) cu --tasks task-uri si istorii aleatoare, apoi:
+ *
+ *   1. codeaza fiecare document in JSON si CBOR, il decodeaza si il compara cu ce ar fi
+ *      scos builder-ul vechi din sysmon_json.c (aceleasi chei, aceeasi ordine, aceeasi
+ *      rotunjire). cJSON nu exista in build-ul de host, asa ca documentul "legacy" e
+ *      reconstruit aici dupa sysmon_json.c; procentele de stack/memorie erau trimise ca
+ *      float brut, acum au 2 zecimale -> toleranta 0.005 pe cheile *Pct.
+ *   2. verifica /history?since=<seq>: numarul de sample-uri, fallback-ul la istoria
+ *      completa si ca un client care lipeste delta peste istoria veche ajunge la istoria noua.
+ *   3. masoara bytes pe raspuns, timpul de codare si heap-ul folosit in timpul codarii
+ *      (malloc/calloc/realloc prin -Wl,--wrap). Pentru calea cJSON: arbore (40 B per nod
+ *      pe ESP32 + cheile duplicate) + buffer-ul cJSON_Print (textul formatat, creste prin dublare).
+ *
+ * Usage: bench_sysmon_stream [--tasks N] [--iters N] [--seed N]
+ */
+
+#include <malloc.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "sysmon.h"
+#include "sysmon_stream.h"
+#include "sysmon_utils.h"
+
+#define SAMPLES          CONFIG_SYSMON_SAMPLE_COUNT
+#define CAPTURE_SIZE     (4u * 1024u * 1024u)
+#define CJSON_ITEM_BYTES (40u)  // sizeof(cJSON) pe ESP32 (pointeri de 4 B, valuedouble aliniat la 8)
+
+/**********************
+ *   SYSMON STATE + UTILS
+ **********************/
+SysMonState self;
+
+static bool s_rssi_ok = true;
+
+const char* _get_task_display_name(const char* task_name) {
+    if (task_name != NULL && strcmp(task_name, "main") == 0) {
+        return "app_main";
+    }
+    return task_name;
+}
+//---------
+esp_err_t _get_wifi_rssi(int8_t* rssi) {
+    if (!s_rssi_ok) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    *rssi = -61;
+    return ESP_OK;
+}
+
+/**********************
+ *   HEAP ACCOUNTING
+ **********************/
+void* __real_malloc(size_t size);
+void* __real_calloc(size_t n, size_t size);
+void* __real_realloc(void* ptr, size_t size);
+void  __real_free(void* ptr);
+
+static bool   s_heap_track;
+static size_t s_heap_live;
+static size_t s_heap_peak;
+static size_t s_heap_calls;
+
+static void heap_add(void* ptr) {
+    if (s_heap_track && ptr) {
+        s_heap_calls++;
+        s_heap_live += malloc_usable_size(ptr);
+        if (s_heap_live > s_heap_peak) {
+            s_heap_peak = s_heap_live;
+        }
+    }
+}
+//---------
+static void heap_sub(void* ptr) {
+    if (s_heap_track && ptr) {
+        size_t n    = malloc_usable_size(ptr);
+        s_heap_live = s_heap_live > n ? s_heap_live - n : 0;
+    }
+}
+//---------
+void* __wrap_malloc(size_t size) {
+    void* p = __real_malloc(size);
+    heap_add(p);
+    return p;
+}
+//---------
+void* __wrap_calloc(size_t n, size_t size) {
+    void* p = __real_calloc(n, size);
+    heap_add(p);
+    return p;
+}
+//---------
+void* __wrap_realloc(void* ptr, size_t size) {
+    heap_sub(ptr);
+    void* p = __real_realloc(ptr, size);
+    heap_add(p);
+    return p;
+}
+//---------
+void __wrap_free(void* ptr) {
+    heap_sub(ptr);
+    __real_free(ptr);
+}
+
+/**********************
+ *   CAPTURE SINK
+ **********************/
+typedef struct {
+    uint8_t* data;
+    size_t   len;
+    uint32_t chunks;
+} capture_t;
+
+static esp_err_t capture_write(void* ctx, const char* data, size_t len) {
+    capture_t* cap = (capture_t*) ctx;
+    if (cap->len + len > CAPTURE_SIZE) {
+        return ESP_ERR_NO_MEM;
+    }
+    memcpy(cap->data + cap->len, data, len);
+    cap->len += len;
+    cap->chunks++;
+    return ESP_OK;
+}
+
+/**********************
+ *   MINI DOM
+ **********************/
+typedef enum {
+    NODE_NULL = 0,
+    NODE_BOOL,
+    NODE_NUMBER,
+    NODE_STRING,
+    NODE_ARRAY,
+    NODE_OBJECT,
+} node_type_t;
+
+typedef struct node {
+    node_type_t  type;
+    char*        key;
+    char*        str;
+    double       num;
+    bool         b;
+    struct node* child;
+    struct node* last;
+    struct node* next;
+} node_t;
+
+static node_t* node_new(node_type_t type) {
+    node_t* n = (node_t*) calloc(1, sizeof(node_t));
+    n->type   = type;
+    return n;
+}
+//---------
+static void node_free(node_t* n) {
+    while (n) {
+        node_t* next = n->next;
+        node_free(n->child);
+        free(n->key);
+        free(n->str);
+        free(n);
+        n = next;
+    }
+}
+//---------
+static node_t* node_add(node_t* parent, const char* key, node_t* child) {
+    if (key) {
+        child->key = strdup(key);
+    }
+    if (parent->last) {
+        parent->last->next = child;
+    } else {
+        parent->child = child;
+    }
+    parent->last = child;
+    return child;
+}
+//---------
+static node_t* node_num(double v) {
+    node_t* n = node_new(NODE_NUMBER);
+    n->num    = v;
+    return n;
+}
+//---------
+static node_t* node_get(const node_t* obj, const char* key) {
+    for (node_t* c = obj ? obj->child : NULL; c; c = c->next) {
+        if (c->key && !strcmp(c->key, key)) {
+            return c;
+        }
+    }
+    return NULL;
+}
+//---------
+static uint32_t node_count(const node_t* n) {
+    uint32_t cnt = 0;
+    for (; n; n = n->next) {
+        cnt += 1 + node_count(n->child);
+    }
+    return cnt;
+}
+//---------
+static size_t node_key_bytes(const node_t* n) {
+    size_t bytes = 0;
+    for (; n; n = n->next) {
+        bytes += (n->key ? strlen(n->key) + 1 : 0) + node_key_bytes(n->child);
+    }
+    return bytes;
+}
+
+/**********************
+ *   LEGACY DOCUMENTS (sysmon_json.c)
+ **********************/
+static void legacy_stack_remaining(node_t* obj, const TaskUsageSample* t, size_t at) {
+    double stack_bytes = (double) self.history.stack_usage_bytes[at];
+    double stack_pct   = (double) self.history.stack_usage_percent[at];
+    if (stack_bytes > 0.0 && stack_pct > 0.0) {
+        node_add(obj, "stackRemaining", node_num((double) (t->stack_high_water_mark * sizeof(StackType_t))));
+    }
+}
+//---------
+static node_t* legacy_tasks(void) {
+    node_t* root = node_new(NODE_OBJECT);
+    for (int i = 0; i < self.task_capacity; i++) {
+        const TaskUsageSample* t = &self.tasks[i];
+        if (!t->is_active) {
+            continue;
+        }
+        size_t  at  = _history_at(&self, _newest_sample_index(&self), i);
+        node_t* obj = node_new(NODE_OBJECT);
+        node_add(obj, "core", node_num(t->core_id));
+        node_add(obj, "prio", node_num((double) t->current_priority));
+        node_add(obj, "stackSize", node_num((double) t->stack_size_bytes));
+        node_add(obj, "stackUsed", node_num((double) self.history.stack_usage_bytes[at]));
+        node_add(obj, "stackUsedPct", node_num((double) self.history.stack_usage_percent[at]));
+        legacy_stack_remaining(obj, t, at);
+        node_add(root, _get_task_display_name(t->task_name), obj);
+    }
+    return root;
+}
+//---------
+static node_t* legacy_history(void) {
+    node_t* root = node_new(NODE_OBJECT);
+    for (int i = 0; i < self.task_capacity; i++) {
+        const TaskUsageSample* t = &self.tasks[i];
+        if (!t->is_active) {
+            continue;
+        }
+        node_t* obj   = node_new(NODE_OBJECT);
+        node_t* cpu   = node_new(NODE_ARRAY);
+        node_t* stack = t->stack_size_bytes > 0U ? node_new(NODE_ARRAY) : NULL;
+        int     idx   = self.series_write_index;
+        for (int j = 0; j < SAMPLES; j++) {
+            size_t at = _history_at(&self, idx, i);
+            node_add(cpu, NULL, node_num(round(self.history.usage_percent[at] * 10.0) / 10.0));
+            if (stack) {
+                node_add(stack, NULL, node_num((double) self.history.stack_usage_bytes[at]));
+            }
+            idx = (idx + 1) % SAMPLES;
+        }
+        node_add(obj, "cpu", cpu);
+        if (stack) {
+            node_add(obj, "stack", stack);
+        }
+        node_add(root, _get_task_display_name(t->task_name), obj);
+    }
+    return root;
+}
+//---------
+static node_t* legacy_telemetry(void) {
+    int     ri      = (self.series_write_index - 1 + SAMPLES) % SAMPLES;
+    node_t* root    = node_new(NODE_OBJECT);
+    node_t* summary = node_new(NODE_OBJECT);
+
+    node_t* cpu   = node_new(NODE_OBJECT);
+    node_t* cores = node_new(NODE_ARRAY);
+    node_add(cpu, "overall", node_num(round(self.cpu_overall_percent[ri] * 100.0) / 100.0));
+    node_add(cores, NULL, node_num(round(self.cpu_core_percent[0][ri] * 100.0) / 100.0));
+    node_add(cores, NULL, node_num(round(self.cpu_core_percent[1][ri] * 100.0) / 100.0));
+    node_add(cpu, "cores", cores);
+    node_add(summary, "cpu", cpu);
+
+    node_t* mem  = node_new(NODE_OBJECT);
+    node_t* dram = node_new(NODE_OBJECT);
+    node_add(dram, "free", node_num((double) self.dram_free[ri]));
+    node_add(dram, "largest", node_num((double) self.dram_largest_block[ri]));
+    node_add(dram, "total", node_num((double) self.dram_total[ri]));
+    node_add(dram, "usedPct", node_num((double) self.dram_used_percent[ri]));
+    node_add(mem, "dram", dram);
+    node_t* psram = node_new(NODE_OBJECT);
+    node_add(psram, "free", node_num((double) self.psram_free[ri]));
+    node_add(psram, "total", node_num((double) self.psram_total[ri]));
+    node_add(psram, "usedPct", node_num((double) self.psram_used_percent[ri]));
+    node_t* present = node_add(psram, "present", node_new(NODE_BOOL));
+    present->b      = self.psram_seen;
+    node_add(mem, "psram", psram);
+    node_add(summary, "mem", mem);
+
+    int8_t rssi = 0;
+    if (_get_wifi_rssi(&rssi) == ESP_OK) {
+        node_add(summary, "wifiRssi", node_num((double) rssi));
+    } else {
+        node_add(summary, "wifiRssi", node_new(NODE_NULL));
+    }
+    node_add(root, "summary", summary);
+
+    node_t* current = node_new(NODE_OBJECT);
+    for (int i = 0; i < self.task_capacity; i++) {
+        const TaskUsageSample* t = &self.tasks[i];
+        if (!t->is_active) {
+            continue;
+        }
+        size_t  at  = _history_at(&self, _newest_sample_index(&self), i);
+        node_t* obj = node_new(NODE_OBJECT);
+        node_add(obj, "cpu", node_num(round(self.history.usage_percent[at] * 100.0) / 100.0));
+        node_add(obj, "stack", node_num((double) self.history.stack_usage_bytes[at]));
+        node_add(obj, "stackPct", node_num((double) self.history.stack_usage_percent[at]));
+        legacy_stack_remaining(obj, t, at);
+        node_add(current, _get_task_display_name(t->task_name), obj);
+    }
+    node_add(root, "current", current);
+    return root;
+}
+
+/**********************
+ *   cJSON_Print LENGTH (formatted output of cJSON 1.7)
+ **********************/
+static size_t cjson_string_len(const char* s) {
+    size_t n = 2;
+    for (; *s; s++) {
+        unsigned char c = (unsigned char) *s;
+        n += (c == '"' || c == '\\' || c == '\b' || c == '\f' || c == '\n' || c == '\r' || c == '\t') ? 2 : c < 0x20 ? 6 : 1;
+    }
+    return n;
+}
+//---------
+static size_t cjson_number_len(double d) {
+    char   buf[32];
+    double sat = d >= 2147483647.0 ? 2147483647.0 : d <= -2147483648.0 ? -2147483648.0 : d;
+    if (isnan(d) || isinf(d)) {
+        return 4;
+    }
+    if (d == (double) (int) sat) {
+        return (size_t) snprintf(buf, sizeof(buf), "%d", (int) sat);
+    }
+    int len = snprintf(buf, sizeof(buf), "%1.15g", d);
+    if (strtod(buf, NULL) != d) {
+        len = snprintf(buf, sizeof(buf), "%1.17g", d);
+    }
+    return (size_t) len;
+}
+//---------
+static size_t cjson_print_len(const node_t* n, size_t depth) {
+    switch (n->type) {
+        case NODE_NULL:
+            return 4;
+        case NODE_BOOL:
+            return n->b ? 4 : 5;
+        case NODE_NUMBER:
+            return cjson_number_len(n->num);
+        case NODE_STRING:
+            return cjson_string_len(n->str);
+        case NODE_ARRAY: {
+            size_t len = 2;  // "[" ... "]", elementele despartite de ", "
+            for (const node_t* c = n->child; c; c = c->next) {
+                len += cjson_print_len(c, depth + 1) + (c->next ? 2 : 0);
+            }
+            return len;
+        }
+        case NODE_OBJECT: {
+            size_t len = 2 + depth + 1;  // "{\n" ... depth x "\t" + "}"
+            for (const node_t* c = n->child; c; c = c->next) {
+                // depth+1 x "\t", "key", ":\t", valoare, [","], "\n"
+                len += depth + 1 + cjson_string_len(c->key) + 2 + cjson_print_len(c, depth + 1) + (c->next ? 1 : 0) + 1;
+            }
+            return len;
+        }
+    }
+    return 0;
+}
+
+/**********************
+ *   DECODERS
+ **********************/
+typedef struct {
+    const uint8_t* p;
+    const uint8_t* end;
+    bool           ok;
+} reader_t;
+
+static void json_ws(reader_t* r) {
+    while (r->p < r->end && (*r->p == ' ' || *r->p == '\n' || *r->p == '\t' || *r->p == '\r')) {
+        r->p++;
+    }
+}
+//---------
+static char* json_parse_string(reader_t* r) {
+    if (r->p >= r->end || *r->p != '"') {
+        r->ok = false;
+        return NULL;
+    }
+    r->p++;
+    char*  out = (char*) malloc((size_t) (r->end - r->p) + 1);
+    size_t n   = 0;
+    while (r->p < r->end && *r->p != '"') {
+        char c = (char) *r->p++;
+        if (c == '\\' && r->p < r->end) {
+            char e = (char) *r->p++;
+            if (e == 'u' && r->end - r->p >= 4) {
+                char hex[5] = { (char) r->p[0], (char) r->p[1], (char) r->p[2], (char) r->p[3], 0 };
+                c           = (char) strtol(hex, NULL, 16);
+                r->p += 4;
+            } else {
+                c = e == 'n' ? '\n' : e == 't' ? '\t' : e;
+            }
+        }
+        out[n++] = c;
+    }
+    out[n] = '\0';
+    if (r->p >= r->end) {
+        r->ok = false;
+    } else {
+        r->p++;
+    }
+    return out;
+}
+//---------
+static node_t* json_parse_value(reader_t* r) {
+    json_ws(r);
+    if (!r->ok || r->p >= r->end) {
+        r->ok = false;
+        return node_new(NODE_NULL);
+    }
+    char c = (char) *r->p;
+    if (c == '{' || c == '[') {
+        bool    obj  = c == '{';
+        node_t* node = node_new(obj ? NODE_OBJECT : NODE_ARRAY);
+        r->p++;
+        json_ws(r);
+        if (r->p < r->end && *r->p == (obj ? '}' : ']')) {
+            r->p++;
+            return node;
+        }
+        while (r->ok) {
+            char* key = NULL;
+            if (obj) {
+                json_ws(r);
+                key = json_parse_string(r);
+                json_ws(r);
+                if (r->p >= r->end || *r->p++ != ':') {
+                    r->ok = false;
+                }
+            }
+            node_t* child = json_parse_value(r);
+            node_add(node, NULL, child);
+            child->key = key;
+            json_ws(r);
+            if (r->p < r->end && *r->p == ',') {
+                r->p++;
+            } else if (r->p < r->end && *r->p == (obj ? '}' : ']')) {
+                r->p++;
+                break;
+            } else {
+                r->ok = false;
+            }
+        }
+        return node;
+    }
+    if (c == '"') {
+        node_t* node = node_new(NODE_STRING);
+        node->str    = json_parse_string(r);
+        return node;
+    }
+    if (r->end - r->p >= 4 && !memcmp(r->p, "null", 4)) {
+        r->p += 4;
+        return node_new(NODE_NULL);
+    }
+    if (r->end - r->p >= 4 && !memcmp(r->p, "true", 4)) {
+        r->p += 4;
+        node_t* node = node_new(NODE_BOOL);
+        node->b      = true;
+        return node;
+    }
+    if (r->end - r->p >= 5 && !memcmp(r->p, "false", 5)) {
+        r->p += 5;
+        return node_new(NODE_BOOL);
+    }
+    char  buf[64];
+    char* end;
+    size_t n = 0;
+    while (r->p + n < r->end && n < sizeof(buf) - 1 && strchr("-+.eE0123456789", r->p[n])) {
+        buf[n] = (char) r->p[n];
+        n++;
+    }
+    buf[n]    = '\0';
+    double v  = strtod(buf, &end);
+    if (n == 0 || end != buf + n) {
+        r->ok = false;
+    }
+    r->p += n;
+    return node_num(v);
+}
+//---------
+static uint64_t cbor_arg(reader_t* r, uint8_t info) {
+    if (info < 24) {
+        return info;
+    }
+    int bytes = info == 24 ? 1 : info == 25 ? 2 : info == 26 ? 4 : info == 27 ? 8 : 0;
+    if (bytes == 0 || r->end - r->p < bytes) {
+        r->ok = false;
+        return 0;
+    }
+    uint64_t v = 0;
+    for (int i = 0; i < bytes; i++) {
+        v = (v << 8) | *r->p++;
+    }
+    return v;
+}
+//---------
+static node_t* cbor_parse_value(reader_t* r);
+//---------
+static char* cbor_parse_text(reader_t* r) {
+    if (r->p >= r->end || (*r->p >> 5) != 3) {
+        r->ok = false;
+        return NULL;
+    }
+    uint8_t  ib  = *r->p++;
+    uint64_t len = cbor_arg(r, ib & 0x1F);
+    if (!r->ok || (uint64_t) (r->end - r->p) < len) {
+        r->ok = false;
+        return NULL;
+    }
+    char* s = (char*) malloc(len + 1);
+    memcpy(s, r->p, len);
+    s[len] = '\0';
+    r->p += len;
+    return s;
+}
+//---------
+static node_t* cbor_parse_value(reader_t* r) {
+    if (!r->ok || r->p >= r->end) {
+        r->ok = false;
+        return node_new(NODE_NULL);
+    }
+    uint8_t ib    = *r->p;
+    uint8_t major = ib >> 5;
+    uint8_t info  = ib & 0x1F;
+    if (major == 3) {
+        node_t* node = node_new(NODE_STRING);
+        node->str    = cbor_parse_text(r);
+        return node;
+    }
+    r->p++;
+    switch (major) {
+        case 0:
+            return node_num((double) cbor_arg(r, info));
+        case 1:
+            return node_num(-1.0 - (double) cbor_arg(r, info));
+        case 4:
+        case 5: {
+            bool    obj  = major == 5;
+            node_t* node = node_new(obj ? NODE_OBJECT : NODE_ARRAY);
+            if (info != 0x1F) {
+                r->ok = false;  // sysmon_stream scrie doar containere de lungime nedefinita
+                return node;
+            }
+            while (r->ok && r->p < r->end && *r->p != 0xFF) {
+                char*   key   = obj ? cbor_parse_text(r) : NULL;
+                node_t* child = cbor_parse_value(r);
+                node_add(node, NULL, child);
+                child->key = key;
+            }
+            if (r->p >= r->end) {
+                r->ok = false;
+            } else {
+                r->p++;
+            }
+            return node;
+        }
+        case 7:
+            if (ib == 0xF4 || ib == 0xF5) {
+                node_t* node = node_new(NODE_BOOL);
+                node->b      = ib == 0xF5;
+                return node;
+            }
+            if (ib == 0xF6) {
+                return node_new(NODE_NULL);
+            }
+            if (ib == 0xFA && r->end - r->p >= 4) {
+                uint32_t bits = ((uint32_t) r->p[0] << 24) | ((uint32_t) r->p[1] << 16) | ((uint32_t) r->p[2] << 8) | r->p[3];
+                float    f;
+                memcpy(&f, &bits, sizeof(f));
+                r->p += 4;
+                return node_num(f);
+            }
+            break;
+        default:
+            break;
+    }
+    r->ok = false;
+    return node_new(NODE_NULL);
+}
+//---------
+static node_t* decode(sysmon_stream_format_t format, const capture_t* cap) {
+    reader_t r    = { cap->data, cap->data + cap->len, true };
+    node_t*  root = format == SYSMON_STREAM_CBOR ? cbor_parse_value(&r) : json_parse_value(&r);
+    if (format == SYSMON_STREAM_JSON) {
+        json_ws(&r);
+    }
+    if (!r.ok || r.p != r.end) {
+        node_free(root);
+        return NULL;
+    }
+    return root;
+}
+
+/**********************
+ *   COMPARE
+ **********************/
+static bool compare(const node_t* want, const node_t* got, sysmon_stream_format_t format, const char* path) {
+    if (want->type != got->type) {
+        printf("  %s: type %d, expected %d\n", path, got->type, want->type);
+        return false;
+    }
+    switch (want->type) {
+        case NODE_BOOL:
+            if (want->b != got->b) {
+                printf("  %s: bool differs\n", path);
+                return false;
+            }
+            return true;
+        case NODE_NUMBER: {
+            size_t plen = strlen(path);
+            bool   pct  = plen >= 3 && !strcmp(path + plen - 3, "Pct");  // float brut -> 2 zecimale
+            double tol  = pct ? 0.005 + 1e-6 : format == SYSMON_STREAM_CBOR ? 1e-4 : 0.0;
+            if (fabs(want->num - got->num) > tol) {
+                printf("  %s: %.17g, expected %.17g\n", path, got->num, want->num);
+                return false;
+            }
+            return true;
+        }
+        case NODE_STRING:
+            if (strcmp(want->str, got->str)) {
+                printf("  %s: \"%s\", expected \"%s\"\n", path, got->str, want->str);
+                return false;
+            }
+            return true;
+        case NODE_ARRAY:
+        case NODE_OBJECT: {
+            const node_t* a = want->child;
+            const node_t* b = got->child;
+            uint32_t      i = 0;
+            for (; a && b; a = a->next, b = b->next, i++) {
+                char sub[256];
+                if (want->type == NODE_OBJECT) {
+                    if (strcmp(a->key, b->key)) {
+                        printf("  %s: key \"%s\", expected \"%s\"\n", path, b->key, a->key);
+                        return false;
+                    }
+                    snprintf(sub, sizeof(sub), "%s.%s", path, a->key);
+                } else {
+                    snprintf(sub, sizeof(sub), "%s[%u]", path, (unsigned) i);
+                }
+                if (!compare(a, b, format, sub)) {
+                    return false;
+                }
+            }
+            if (a || b) {
+                printf("  %s: %s elements\n", path, a ? "missing" : "extra");
+                return false;
+            }
+            return true;
+        }
+        default:
+            return true;
+    }
+}
+
+/**********************
+ *   BENCH FUNCTIONS
+ **********************/
+typedef esp_err_t (*document_fn_t)(sysmon_stream_t*, const SysMonState*, const sysmon_stream_query_t*);
+
+typedef struct {
+    const char*   uri;
+    document_fn_t stream;
+    node_t* (*legacy)(void);
+} document_t;
+
+static const document_t s_documents[] = {
+    { "/tasks", sysmon_stream_tasks, legacy_tasks },
+    { "/history", sysmon_stream_history, legacy_history },
+    { "/telemetry", sysmon_stream_telemetry, legacy_telemetry },
+};
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000u + (uint64_t) ts.tv_nsec;
+}
+//---------
+static float frand(float lo, float hi) {
+    return lo + (hi - lo) * ((float) rand() / (float) RAND_MAX);
+}
+//---------
+static void fill_state(uint32_t tasks) {
+    static const char* names[] = { "main", "IDLE0", "IDLE1", "esp_timer", "sysmon", "lvgl", "cli", "wifi", "tiT", "ipc0" };
+    free(self.tasks);
+    free(self.history.usage_percent);
+    free(self.history.stack_usage_bytes);
+    free(self.history.stack_usage_percent);
+    memset(&self, 0, sizeof(self));
+    self.task_capacity               = (int) tasks + 4;
+    self.tasks                       = (TaskUsageSample*) calloc((size_t) self.task_capacity, sizeof(TaskUsageSample));
+    self.history.usage_percent       = (float*) calloc((size_t) self.task_capacity * SAMPLES, sizeof(float));
+    self.history.stack_usage_bytes   = (uint32_t*) calloc((size_t) self.task_capacity * SAMPLES, sizeof(uint32_t));
+    self.history.stack_usage_percent = (float*) calloc((size_t) self.task_capacity * SAMPLES, sizeof(float));
+    self.series_write_index          = rand() % SAMPLES;
+    for (uint32_t i = 0; i < tasks; i++) {
+        int              slot = (int) i + (i >= 2 ? 2 : 0);  // doua sloturi goale intre task-uri
+        TaskUsageSample* t    = &self.tasks[slot];
+        if (i < sizeof(names) / sizeof(names[0])) {
+            snprintf(t->task_name, sizeof(t->task_name), "%s", names[i]);
+        } else if (i == sizeof(names) / sizeof(names[0])) {
+            snprintf(t->task_name, sizeof(t->task_name), "q\"uo\\te\t");  // escaping JSON
+        } else {
+            snprintf(t->task_name, sizeof(t->task_name), "task_%03u", (unsigned) i);
+        }
+        t->is_active             = true;
+        t->core_id               = (i % 3 == 2) ? 0x7FFFFFFF : (int) (i % 2);  // tskNO_AFFINITY
+        t->current_priority      = (UBaseType_t) (rand() % 25);
+        t->stack_size_bytes      = (i % 3 == 1) ? 0U : 2048U + 1024U * (uint32_t) (rand() % 8);
+        t->stack_high_water_mark = (uint32_t) (rand() % 2048);
+        for (int j = 0; j < SAMPLES; j++) {
+            size_t at                            = _history_at(&self, j, slot);
+            self.history.usage_percent[at]       = (j % 7 == 0) ? 0.0f : frand(0.0f, 100.0f);
+            self.history.stack_usage_bytes[at]   = t->stack_size_bytes ? (uint32_t) (rand() % (int) t->stack_size_bytes) : 0U;
+            self.history.stack_usage_percent[at] = t->stack_size_bytes ? 100.0f * (float) self.history.stack_usage_bytes[at] / (float) t->stack_size_bytes : 0.0f;
+        }
+    }
+    for (int j = 0; j < SAMPLES; j++) {
+        self.cpu_overall_percent[j] = frand(0.0f, 100.0f);
+        self.cpu_core_percent[0][j] = frand(0.0f, 100.0f);
+        self.cpu_core_percent[1][j] = frand(0.0f, 100.0f);
+        self.dram_total[j]          = 337000U;
+        self.dram_free[j]           = 100000U + (uint32_t) (rand() % 100000);
+        self.dram_largest_block[j]  = self.dram_free[j] / 2;
+        self.dram_used_percent[j]   = 100.0f * (float) (self.dram_total[j] - self.dram_free[j]) / (float) self.dram_total[j];
+        self.psram_total[j]         = 8u * 1024u * 1024u;
+        self.psram_free[j]          = self.psram_total[j] - (uint32_t) (rand() % 1000000);
+        self.psram_used_percent[j]  = 100.0f * (float) (self.psram_total[j] - self.psram_free[j]) / (float) self.psram_total[j];
+    }
+    self.psram_seen = true;
+    self.sample_seq = 1000u + (uint32_t) (rand() % 1000);
+}
+//---------
+/* Un sample nou pentru toate task-urile, ca _update_series_buffers() */
+static void advance_sample(void) {
+    for (int i = 0; i < self.task_capacity; i++) {
+        TaskUsageSample* t = &self.tasks[i];
+        if (!t->is_active) {
+            continue;
+        }
+        size_t at                          = _history_at(&self, self.series_write_index, i);
+        self.history.usage_percent[at]     = frand(0.0f, 100.0f);
+        self.history.stack_usage_bytes[at] = t->stack_size_bytes ? (uint32_t) (rand() % (int) t->stack_size_bytes) : 0U;
+    }
+    self.series_write_index = (self.series_write_index + 1) % SAMPLES;
+    self.sample_seq++;
+}
+//---------
+static esp_err_t encode(const document_t* doc, sysmon_stream_format_t format, sysmon_stream_query_t* query, capture_t* cap) {
+    sysmon_stream_t stream;
+    cap->len    = 0;
+    cap->chunks = 0;
+    sysmon_stream_init(&stream, format, capture_write, cap);
+    sysmon_stream_resolve_query(query, &self);
+    doc->stream(&stream, &self, query);
+    return sysmon_stream_finish(&stream);
+}
+//---------
+static bool check_documents(capture_t* cap, uint32_t iters) {
+    bool ok = true;
+    printf("%-10s %-5s %9s %7s %10s %9s %10s   %s\n", "URI", "FMT", "BYTES", "CHUNKS", "ENCODE[us]", "HEAP[B]", "MALLOCS", "decoded == legacy");
+    for (size_t d = 0; d < sizeof(s_documents) / sizeof(s_documents[0]); d++) {
+        const document_t* doc    = &s_documents[d];
+        node_t*           legacy = doc->legacy();
+        for (int f = 0; f < 2; f++) {
+            sysmon_stream_format_t format = f ? SYSMON_STREAM_CBOR : SYSMON_STREAM_JSON;
+            sysmon_stream_query_t  query  = { 0 };
+
+            s_heap_live = s_heap_peak = s_heap_calls = 0;
+            s_heap_track                             = true;
+            uint64_t  t0                             = now_ns();
+            esp_err_t err                            = ESP_OK;
+            for (uint32_t i = 0; i < iters; i++) {
+                err = encode(doc, format, &query, cap);
+            }
+            uint64_t t1  = now_ns();
+            s_heap_track = false;
+
+            node_t* got   = err == ESP_OK ? decode(format, cap) : NULL;
+            bool    match = got && compare(legacy, got, format, doc->uri);
+            ok &= match;
+            printf("%-10s %-5s %9zu %7u %10.2f %9zu %10zu   %s\n", doc->uri, f ? "cbor" : "json", cap->len,
+                (unsigned) cap->chunks, (double) (t1 - t0) / 1000.0 / iters, s_heap_peak, s_heap_calls,
+                match ? "ok" : got ? "MISMATCH" : "UNDECODABLE");
+            node_free(got);
+        }
+
+        // Calea veche: arbore cJSON + cJSON_Print (formatat)
+        uint32_t nodes = node_count(legacy);
+        size_t   tree  = (size_t) nodes * CJSON_ITEM_BYTES + node_key_bytes(legacy);
+        size_t   text  = cjson_print_len(legacy, 0);
+        printf("%-10s %-5s %9zu %7s %10s %9zu   (%u nodes x %u B + keys = %zu B tree, + print buffer %zu..%zu B)\n", doc->uri,
+            "cJSON", text, "-", "-", tree + text + 1, (unsigned) nodes, CJSON_ITEM_BYTES, tree, text + 1, 2 * (text + 1));
+        node_free(legacy);
+    }
+    return ok;
+}
+//---------
+/* Lungimea fiecarui array "cpu" / "stack" dintr-un raspuns /history */
+static bool history_lengths(const node_t* doc, uint32_t expect) {
+    for (const node_t* task = doc->child; task; task = task->next) {
+        for (const node_t* arr = task->child; arr; arr = arr->next) {
+            uint32_t n = node_count(arr->child);
+            if (n != expect) {
+                printf("  %s.%s: %u samples, expected %u\n", task->key, arr->key, (unsigned) n, (unsigned) expect);
+                return false;
+            }
+        }
+    }
+    return true;
+}
+//---------
+/* old (istoria completa) + delta (ultimele k sample-uri) -> istoria noua, cum face clientul */
+static void merge_history(node_t* old, const node_t* delta) {
+    for (node_t* task = old->child; task; task = task->next) {
+        const node_t* dtask = node_get(delta, task->key);
+        for (node_t* arr = task->child; arr && dtask; arr = arr->next) {
+            const node_t* darr = node_get(dtask, arr->key);
+            for (const node_t* v = darr ? darr->child : NULL; v; v = v->next) {
+                node_t* first = arr->child;  // shift: scoate cel mai vechi, adauga cel nou
+                arr->child    = first->next;
+                first->next   = NULL;
+                node_free(first);
+                node_add(arr, NULL, node_num(v->num));
+            }
+            arr->last = arr->child;
+            while (arr->last && arr->last->next) {
+                arr->last = arr->last->next;
+            }
+        }
+    }
+}
+//---------
+static bool check_since(capture_t* cap) {
+    bool     ok   = true;
+    uint32_t seq  = self.sample_seq;
+    struct {
+        const char* what;
+        bool        has_since;
+        uint32_t    since;
+        uint32_t    expect;
+    } cases[] = {
+        { "no since", false, 0, SAMPLES },
+        { "since = seq", true, seq, 0 },
+        { "since = seq-1", true, seq - 1, 1 },
+        { "since = seq-5", true, seq - 5, 5 },
+        { "since = seq-(N-1)", true, seq - (SAMPLES - 1), SAMPLES - 1 },
+        { "since = seq-N", true, seq - SAMPLES, SAMPLES },
+        { "since = seq-N-1", true, seq - SAMPLES - 1, SAMPLES },
+        { "since > seq (reboot)", true, seq + 10, SAMPLES },
+    };
+    printf("\n/history?since=<seq>, seq = %u, %d samples per series\n", (unsigned) seq, SAMPLES);
+    for (size_t c = 0; c < sizeof(cases) / sizeof(cases[0]); c++) {
+        for (int f = 0; f < 2; f++) {
+            sysmon_stream_format_t format = f ? SYSMON_STREAM_CBOR : SYSMON_STREAM_JSON;
+            sysmon_stream_query_t  query  = { .has_since = cases[c].has_since, .since = cases[c].since };
+            encode(&s_documents[1], format, &query, cap);
+            node_t* got   = decode(format, cap);
+            bool    match = got && query.samples == cases[c].expect && query.seq == seq && history_lengths(got, cases[c].expect);
+            ok &= match;
+            printf("  %-22s %-4s samples %2u %7zu B   %s\n", cases[c].what, f ? "cbor" : "json", (unsigned) query.samples,
+                cap->len, match ? "ok" : "WRONG");
+            node_free(got);
+        }
+    }
+
+    // Clientul tine istoria completa, sysmon mai face 3 sample-uri, clientul cere ?since=<seq vechi>
+    sysmon_stream_query_t query = { 0 };
+    encode(&s_documents[1], SYSMON_STREAM_JSON, &query, cap);
+    node_t*  client = decode(SYSMON_STREAM_JSON, cap);
+    uint32_t since  = query.seq;
+    for (int i = 0; i < 3; i++) {
+        advance_sample();
+    }
+    query = (sysmon_stream_query_t) { .has_since = true, .since = since };
+    encode(&s_documents[1], SYSMON_STREAM_JSON, &query, cap);
+    size_t  delta_bytes = cap->len;
+    node_t* delta       = decode(SYSMON_STREAM_JSON, cap);
+    merge_history(client, delta);
+    node_t* fresh  = legacy_history();
+    bool    merged = client && delta && compare(fresh, client, SYSMON_STREAM_JSON, "/history");
+    query          = (sysmon_stream_query_t) { 0 };
+    encode(&s_documents[1], SYSMON_STREAM_JSON, &query, cap);
+    printf("  full history + delta of 3 samples == new full history: %s (delta %zu B, full %zu B)\n", merged ? "ok" : "WRONG",
+        delta_bytes, cap->len);
+    ok &= merged;
+    node_free(client);
+    node_free(delta);
+    node_free(fresh);
+    return ok;
+}
+//---------
+int main(int argc, char** argv) {
+    uint32_t tasks = 24;
+    uint32_t iters = 200;
+    unsigned seed  = 1;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--tasks") && i + 1 < argc) {
+            tasks = (uint32_t) atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--iters") && i + 1 < argc) {
+            iters = (uint32_t) atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--seed") && i + 1 < argc) {
+            seed = (unsigned) atoi(argv[++i]);
+        } else {
+            fprintf(stderr, "usage: %s [--tasks N] [--iters N] [--seed N]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (tasks == 0 || tasks > SYSMON_MAX_TRACKED_TASKS || iters == 0) {
+        fprintf(stderr, "--tasks must be 1..%d, --iters >= 1\n", SYSMON_MAX_TRACKED_TASKS);
+        return 2;
+    }
+    srand(seed);
+
+    capture_t cap = { (uint8_t*) malloc(CAPTURE_SIZE), 0, 0 };
+    bool      ok  = true;
+    fill_state(tasks);
+    printf("%u tasks, %d samples per series, chunk %d B, sysmon_stream_t %zu B on the httpd stack\n\n", (unsigned) tasks,
+        SAMPLES, SYSMON_STREAM_CHUNK_SIZE, sizeof(sysmon_stream_t));
+    ok &= check_documents(&cap, iters);
+
+    s_rssi_ok = false;  // "wifiRssi": null
+    sysmon_stream_query_t query = { 0 };
+    encode(&s_documents[2], SYSMON_STREAM_CBOR, &query, &cap);
+    node_t* got    = decode(SYSMON_STREAM_CBOR, &cap);
+    node_t* legacy = legacy_telemetry();
+    bool    match  = got && compare(legacy, got, SYSMON_STREAM_CBOR, "/telemetry");
+    printf("/telemetry without WiFi (wifiRssi null): %s\n", match ? "ok" : "MISMATCH");
+    ok &= match;
+    node_free(got);
+    node_free(legacy);
+    s_rssi_ok = true;
+
+    ok &= check_since(&cap);
+
+    free(cap.data);
+    free(self.tasks);
+    printf("\n%s\n", ok ? "all checks passed" : "FAILED");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,543 @@
+/*
+ * bench_sysmon_tasks - costul unui ciclu de sampling al tabelei de task-uri din sysmon
+ *
+ * Simuleaza un kernel cu --tasks N task-uri si churn (task-uri sterse si create in timpul
+ * rularii) si trece acelasi sir de snapshot-uri uxTaskGetSystemState() prin:
+ *
+ *   before : algoritmul vechi din sysmon.c, copiat aici - tabela AoS cu istoriile in fiecare
+ *            intrare, cautare dupa nume (strncmp pe toata tabela) pentru fiecare task,
+ *            calloc/free pentru tasks_seen la fiecare ciclu si registrul de stack scanat liniar
+ *   after  : mylibs/sysmon/src/sysmon_tasks.c + sysmon_index.c + sysmon_stack.c - index hash
+ *            xTaskNumber -> slot, free list, istorii SoA (un rand per sample)
+ *
+ * Churn: la fiecare --churn-every sample-uri un task e sters si altul creat; noul task
+ * primeste pe rand numele celui sters (re-creat, trebuie sa-si pastreze istoria), numele
+ * unui task viu (nume duplicat) sau un nume nou. Ordinea din snapshot e amestecata la
+ * fiecare sample, ca pe dual-core. Cam un task din 16 nu are runtime in sample (lipseste din
+ * trace-ul de comutari, sampled[i] = false) si primeste un ulRunTimeCounter aleator.
+ *
+ * Pentru "after" verifica la fiecare sample: fiecare task viu e in index, cu CPU% si stack
+ * din randul nou egale cu valorile asteptate (0 fara runtime acum sau la sample-ul anterior); numele intrarilor active sunt unice; free
+ * list + intrari active == capacitate. Orice abatere -> exit 1.
+ *
+ * Usage: bench_sysmon_tasks [--tasks N] [--samples N] [--churn-every N] [--seed N] [--verbose]
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "sysmon.h"
+#include "sysmon_snapshot.h"
+#include "sysmon_stack.h"
+#include "sysmon_tasks.h"
+
+#define SAMPLES    CONFIG_SYSMON_SAMPLE_COUNT
+#define MAX_SIM    (SYSMON_MAX_TRACKED_TASKS + 64)
+#define NAME_COUNT 10
+
+/**********************
+ *   SYSMON STATE
+ **********************/
+SysMonState self = { .free_slot = -1 };
+
+/**********************
+ *   KERNEL SIMULAT
+ **********************/
+typedef struct {
+    uint8_t     tcb[64];  // handle = adresa TCB-ului, ca pe FreeRTOS
+    char        name[configMAX_TASK_NAME_LEN];
+    UBaseType_t number;
+    uint32_t    run_time;
+    uint32_t    inc;  // runtime adaugat la ultimul sample
+    uint32_t    stack_size;
+    uint32_t    hwm;
+    bool        live;
+    bool        sampled;      // runtime-ul a intrat in ultimul sample
+    bool        was_sampled;  // ... si in cel dinainte
+} sim_task_t;
+
+static sim_task_t   s_sim[MAX_SIM];
+static int          s_live[MAX_SIM];
+static int          s_live_count;
+static UBaseType_t  s_next_number = 1;
+static uint32_t     s_rng;
+static TaskStatus_t s_snapshot[MAX_SIM];
+static bool         s_sampled[MAX_SIM];
+
+char* pcTaskGetName(TaskHandle_t handle) {
+    sim_task_t* t = (sim_task_t*) handle;
+    return t->name;
+}
+//---------
+void vTaskDelay(const TickType_t ticks) {
+    (void) ticks;
+}
+//---------
+static uint32_t rng(void) {
+    s_rng ^= s_rng << 13;
+    s_rng ^= s_rng >> 17;
+    s_rng ^= s_rng << 5;
+    return s_rng;
+}
+//---------
+static void sim_create(const char* name, bool register_stack) {
+    int slot = 0;
+    while (s_sim[slot].live) {
+        slot++;
+    }
+    sim_task_t* t = &s_sim[slot];
+    memset(t, 0, sizeof(*t));
+    snprintf(t->name, sizeof(t->name), "%s", name);
+    t->number     = s_next_number++;
+    t->live       = true;
+    t->sampled    = true;  // Intrare noua: prev_run_time_ticks = 0 e o baza buna
+    t->stack_size = register_stack ? 2048u + 1024u * (rng() % 6) : 0u;
+    if (register_stack) {
+        sysmon_stack_register((TaskHandle_t) t, t->stack_size);
+    }
+    s_live[s_live_count++] = slot;
+}
+//---------
+static void sim_reset(int tasks, uint32_t seed) {
+    static const char* names[NAME_COUNT] = { "main", "IDLE0", "IDLE1", "esp_timer", "sysmon", "lvgl", "cli", "wifi", "tiT", "ipc0" };
+    memset(s_sim, 0, sizeof(s_sim));
+    s_live_count  = 0;
+    s_next_number = 1;
+    s_rng         = seed ? seed : 1u;
+    for (int i = 0; i < tasks; i++) {
+        char name[configMAX_TASK_NAME_LEN];
+        if (i < NAME_COUNT) {
+            snprintf(name, sizeof(name), "%s", names[i]);
+        } else {
+            snprintf(name, sizeof(name), "worker_%03u", (unsigned) (uint16_t) i);  // i < MAX_SIM: 16 biti ajung
+        }
+        sim_create(name, i % 3 != 1);
+    }
+}
+//---------
+/* Sterge un task si creeaza altul: re-creat cu acelasi nume, nume duplicat sau nume nou */
+static void sim_churn(uint32_t step) {
+    int         victim = (int) (rng() % (uint32_t) s_live_count);
+    sim_task_t* gone   = &s_sim[s_live[victim]];
+    char        name[configMAX_TASK_NAME_LEN];
+    snprintf(name, sizeof(name), "%s", gone->name);
+    gone->live     = false;
+    s_live[victim] = s_live[--s_live_count];
+    switch (step % 3) {
+        case 0:
+            break;  // acelasi nume
+        case 1:
+            snprintf(name, sizeof(name), "%s", s_sim[s_live[rng() % (uint32_t) s_live_count]].name);
+            break;
+        default:
+            snprintf(name, sizeof(name), "job_%u", (unsigned) s_next_number);
+            break;
+    }
+    sim_create(name, step % 2 == 0);
+}
+//---------
+/* Un snapshot uxTaskGetSystemState(): runtime-uri noi, ordine amestecata */
+static UBaseType_t sim_snapshot(uint32_t* delta_total) {
+    for (int i = s_live_count - 1; i > 0; i--) {
+        int j     = (int) (rng() % (uint32_t) (i + 1));
+        int tmp   = s_live[i];
+        s_live[i] = s_live[j];
+        s_live[j] = tmp;
+    }
+    *delta_total = 0;
+    for (int i = 0; i < s_live_count; i++) {
+        sim_task_t*   t = &s_sim[s_live[i]];
+        TaskStatus_t* s = &s_snapshot[i];
+        t->inc          = rng() % 5000u;
+        t->run_time += t->inc;
+        t->hwm = t->stack_size ? rng() % t->stack_size : rng() % 4096u;
+        t->was_sampled = t->sampled;
+        t->sampled     = rng() % 16u != 0;
+        s_sampled[i]   = t->sampled;
+        *delta_total += t->inc;
+
+        memset(s, 0, sizeof(*s));
+        s->xHandle              = (TaskHandle_t) t;
+        s->pcTaskName           = t->name;
+        s->xTaskNumber          = t->number;
+        s->uxCurrentPriority    = t->number % 25;
+        s->uxBasePriority       = t->number % 25;
+        s->ulRunTimeCounter     = t->sampled ? t->run_time : rng();
+        s->usStackHighWaterMark = t->hwm;
+        s->xCoreID              = (BaseType_t) (t->number % 2);
+    }
+    *delta_total += 1000u;  // timpul IDLE care nu apare in delta-urile task-urilor
+    return (UBaseType_t) s_live_count;
+}
+
+/**********************
+ *   BEFORE (sysmon.c + sysmon_stack.c, varianta veche)
+ **********************/
+typedef struct {
+    char        task_name[24];
+    float       usage_percent_history[SAMPLES];
+    uint32_t    stack_usage_bytes_history[SAMPLES];
+    float       stack_usage_percent_history[SAMPLES];
+    int         write_index;
+    bool        is_active;
+    int         consecutive_zero_samples;
+    UBaseType_t task_id;
+    UBaseType_t current_priority;
+    UBaseType_t base_priority;
+    uint32_t    total_run_time_ticks;
+    uint32_t    stack_high_water_mark;
+    uint32_t    stack_size_bytes;
+    int         core_id;
+    uint32_t    prev_run_time_ticks;
+} legacy_task_t;
+
+typedef struct {
+    TaskHandle_t handle;
+    uint32_t     depth_bytes;
+    bool         is_valid;
+} legacy_stack_record_t;
+
+static legacy_task_t*         s_legacy;
+static int                    s_legacy_capacity;
+static legacy_stack_record_t* s_legacy_stack;
+static int                    s_legacy_stack_capacity;
+
+static void legacy_resize(int capacity) {
+    if (capacity > SYSMON_MAX_TRACKED_TASKS) {
+        capacity = SYSMON_MAX_TRACKED_TASKS;
+    }
+    if (capacity <= s_legacy_capacity) {
+        return;
+    }
+    legacy_task_t* tasks = (legacy_task_t*) calloc((size_t) capacity, sizeof(legacy_task_t));
+    if (s_legacy) {
+        memcpy(tasks, s_legacy, (size_t) s_legacy_capacity * sizeof(legacy_task_t));
+    }
+    free(s_legacy);
+    s_legacy          = tasks;
+    s_legacy_capacity = capacity;
+}
+//---------
+/* Registrul de stack vechi: acelasi continut ca indexul din sysmon_stack.c, scanat liniar */
+static void legacy_stack_fill(void) {
+    free(s_legacy_stack);
+    s_legacy_stack_capacity = MAX_SIM;
+    s_legacy_stack          = (legacy_stack_record_t*) calloc(MAX_SIM, sizeof(legacy_stack_record_t));
+    int n                   = 0;
+    for (int i = 0; i < MAX_SIM; i++) {
+        uint32_t depth = 0;
+        if (sysmon_stack_get_size((TaskHandle_t) &s_sim[i], &depth)) {
+            s_legacy_stack[n].handle      = (TaskHandle_t) &s_sim[i];
+            s_legacy_stack[n].depth_bytes = depth;
+            s_legacy_stack[n].is_valid    = true;
+            n++;
+        }
+    }
+}
+//---------
+static bool legacy_stack_get_size(TaskHandle_t handle, uint32_t* stack_size_bytes) {
+    for (int i = 0; i < s_legacy_stack_capacity; i++) {
+        if (s_legacy_stack[i].is_valid && s_legacy_stack[i].handle == handle) {
+            *stack_size_bytes = s_legacy_stack[i].depth_bytes;
+            return true;
+        }
+    }
+    *stack_size_bytes = 0;
+    return false;
+}
+//---------
+static int legacy_find_or_create(const char* task_name) {
+    for (int j = 0; j < s_legacy_capacity; j++) {
+        if (s_legacy[j].is_active && strncmp(s_legacy[j].task_name, task_name, sizeof(s_legacy[j].task_name)) == 0) {
+            return j;
+        }
+    }
+    for (int j = 0; j < s_legacy_capacity; j++) {
+        if (!s_legacy[j].is_active) {
+            memset(&s_legacy[j], 0, sizeof(legacy_task_t));
+            strncpy(s_legacy[j].task_name, task_name, sizeof(s_legacy[j].task_name) - 1);
+            s_legacy[j].is_active = true;
+            return j;
+        }
+    }
+    return -1;
+}
+//---------
+static void legacy_update(const TaskStatus_t* status, UBaseType_t count, uint32_t delta_total) {
+    bool* seen = (bool*) calloc((size_t) s_legacy_capacity, sizeof(bool));
+    for (UBaseType_t i = 0; i < count; i++) {
+        const TaskStatus_t* s   = &status[i];
+        int                 idx = legacy_find_or_create(s->pcTaskName);
+        if (idx == -1) {
+            continue;
+        }
+        legacy_task_t* t     = &s_legacy[idx];
+        uint32_t       delta = s->ulRunTimeCounter >= t->prev_run_time_ticks ? s->ulRunTimeCounter - t->prev_run_time_ticks : 0;
+        t->prev_run_time_ticks                     = s->ulRunTimeCounter;
+        t->consecutive_zero_samples                = 0;
+        t->usage_percent_history[t->write_index]   = delta_total > 0 ? ((float) delta / (float) delta_total) * 100.0f : 0.0f;
+        t->stack_high_water_mark                   = s->usStackHighWaterMark;
+        uint32_t hwm_bytes                         = s->usStackHighWaterMark * sizeof(StackType_t);
+        uint32_t size                              = 0;
+        legacy_stack_get_size(s->xHandle, &size);
+        t->stack_size_bytes = size;
+        uint32_t used       = size > hwm_bytes ? size - hwm_bytes : 0;
+        t->stack_usage_bytes_history[t->write_index]   = used;
+        t->stack_usage_percent_history[t->write_index] = size ? ((float) used / (float) size) * 100.0f : 0.0f;
+        t->write_index                                 = (t->write_index + 1) % SAMPLES;
+        t->task_id                                     = s->xTaskNumber;
+        t->current_priority                            = s->uxCurrentPriority;
+        t->base_priority                               = s->uxBasePriority;
+        t->total_run_time_ticks                        = s->ulRunTimeCounter;
+        t->core_id                                     = s->xCoreID;
+        seen[idx]                                      = true;
+    }
+    for (int j = 0; j < s_legacy_capacity; j++) {
+        legacy_task_t* t = &s_legacy[j];
+        if (t->is_active && !seen[j]) {
+            t->consecutive_zero_samples++;
+            t->usage_percent_history[t->write_index]       = 0.0f;
+            t->stack_usage_bytes_history[t->write_index]   = 0;
+            t->stack_usage_percent_history[t->write_index] = 0.0f;
+            t->write_index                                 = (t->write_index + 1) % SAMPLES;
+            if (t->consecutive_zero_samples >= SAMPLES) {
+                t->is_active                = false;
+                t->consecutive_zero_samples = 0;
+            }
+        }
+    }
+    free(seen);
+}
+
+/**********************
+ *   AFTER (sysmon_tasks.c)
+ **********************/
+/* Ca _ensure_task_storage_capacity() din sysmon.c */
+static void after_ensure_capacity(UBaseType_t count) {
+    int actual = (int) count;
+    if (self.task_capacity > 0 && actual < self.task_capacity && self.free_slot >= 0) {
+        return;
+    }
+    bool full = self.task_capacity > 0;
+    if (full && actual < self.task_capacity) {
+        actual = self.task_capacity;
+    }
+    int growth = actual * (full ? 50 : 20) / 100;
+    int req    = actual + (growth < 1 ? 1 : growth);
+    if (req > SYSMON_MAX_TRACKED_TASKS) {
+        req = SYSMON_MAX_TRACKED_TASKS;
+    }
+    sysmon_snapshot_write_begin();
+    esp_err_t err = _tasks_resize(req);
+    sysmon_snapshot_write_end();
+    if (err != ESP_OK) {
+        fprintf(stdout, "_tasks_resize(%d) failed\n", req);
+        exit(1);
+    }
+}
+//---------
+/* Ca _update_series_buffers(): randul urmator, seq urmator */
+static void after_advance(void) {
+    self.series_write_index = (self.series_write_index + 1) % SAMPLES;
+    self.sample_seq++;
+}
+//---------
+static int after_check(uint32_t delta_total, uint32_t sample) {
+    int errors = 0;
+    int row    = _newest_sample_index(&self);
+    for (int i = 0; i < s_live_count; i++) {
+        const sim_task_t* t    = &s_sim[s_live[i]];
+        uint32_t          slot = 0;
+        if (!sysmon_index_find(&self.task_index, t->number, &slot)) {
+            if (errors++ < 5) {
+                printf("  sample %u: task '%s' #%u not in the index\n", (unsigned) sample, t->name, (unsigned) t->number);
+            }
+            continue;
+        }
+        const TaskUsageSample* e  = &self.tasks[slot];
+        size_t                 at = _history_at(&self, row, (int) slot);
+        // Handle-urile se refolosesc (ca adresele TCB): marimea vine din registru, nu din t->stack_size
+        uint32_t stack_size = 0;
+        sysmon_stack_get_size((TaskHandle_t) t, &stack_size);
+        uint32_t exp_stack = stack_size > t->hwm ? stack_size - t->hwm : 0;
+        // Task nou sau re-creat: prev_run_time_ticks = 0 si runtime-ul simulat porneste de la 0 -> delta = inc.
+        // Fara runtime acum nu e delta; fara runtime la sample-ul anterior valoarea de acum e doar baza.
+        float exp_cpu = (t->sampled && t->was_sampled) ? ((float) t->inc / (float) delta_total) * 100.0f : 0.0f;
+        if (!e->is_active || e->task_id != t->number || e->handle != (TaskHandle_t) t ||
+            self.history.usage_percent[at] != exp_cpu || self.history.stack_usage_bytes[at] != exp_stack) {
+            if (errors++ < 5) {
+                printf("  sample %u: task '%s' #%u slot %u: cpu %.3f (expected %.3f), stack %u (expected %u)\n", (unsigned) sample,
+                       t->name, (unsigned) t->number, (unsigned) slot, (double) self.history.usage_percent[at], (double) exp_cpu,
+                       (unsigned) self.history.stack_usage_bytes[at], (unsigned) exp_stack);
+            }
+        }
+    }
+
+    int active = 0;
+    for (int j = 0; j < self.task_capacity; j++) {
+        if (!self.tasks[j].is_active) {
+            continue;
+        }
+        active++;
+        for (int k = j + 1; k < self.task_capacity; k++) {
+            if (self.tasks[k].is_active && strcmp(self.tasks[j].task_name, self.tasks[k].task_name) == 0) {
+                if (errors++ < 5) {
+                    printf("  sample %u: name '%s' used by slots %d and %d\n", (unsigned) sample, self.tasks[j].task_name, j, k);
+                }
+            }
+        }
+    }
+    int free_count = 0;
+    for (int f = self.free_slot; f >= 0 && free_count <= self.task_capacity; f = self.tasks[f].next_free) {
+        free_count++;
+    }
+    if (active + free_count != self.task_capacity || (int) self.task_index.count != active) {
+        if (errors++ < 5) {
+            printf("  sample %u: active %d + free %d != capacity %d (index %u)\n", (unsigned) sample, active, free_count, self.task_capacity,
+                   (unsigned) self.task_index.count);
+        }
+    }
+    return errors;
+}
+
+/**********************
+ *   RULARE
+ **********************/
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000u + (uint64_t) ts.tv_nsec;
+}
+//---------
+typedef struct {
+    double   ns_per_sample;
+    size_t   table_bytes;
+    int      capacity;
+    int      errors;
+    uint32_t recreated;
+} run_result_t;
+
+static run_result_t run(bool after, int tasks, uint32_t samples, uint32_t churn_every, uint32_t seed) {
+    run_result_t res = { 0 };
+    _tasks_free();
+    sysmon_snapshot_cleanup();
+    sysmon_stack_cleanup();
+    memset(&self, 0, sizeof(self));
+    self.free_slot           = -1;
+    self.monitor_task_handle = (TaskHandle_t) &self;  // sysmon_stack_register() cere sysmon pornit
+    free(s_legacy);
+    s_legacy          = NULL;
+    s_legacy_capacity = 0;
+
+    sim_reset(tasks, seed);
+    uint64_t total_ns = 0;
+    uint32_t warmup   = 2 * SAMPLES;  // task-urile sterse isi tin slotul SAMPLES sample-uri
+    for (uint32_t s = 0; s < warmup + samples; s++) {
+        if (s > 0 && s % churn_every == 0) {
+            sim_churn(s / churn_every);
+        }
+        uint32_t    delta_total = 0;
+        UBaseType_t count       = sim_snapshot(&delta_total);
+
+        if (after) {
+            after_ensure_capacity(count);
+            uint64_t t0 = now_ns();
+            _tasks_update(s_snapshot, s_sampled, count, delta_total);
+            uint64_t t1 = now_ns();
+            after_advance();
+            res.errors += after_check(delta_total, s);
+            if (s >= warmup) {
+                total_ns += t1 - t0;
+            }
+        } else {
+            if (s % churn_every == 0) {
+                legacy_stack_fill();
+            }
+            legacy_resize(count < (UBaseType_t) s_legacy_capacity ? s_legacy_capacity : (int) count * 3 / 2);
+            uint64_t t0 = now_ns();
+            legacy_update(s_snapshot, count, delta_total);
+            uint64_t t1 = now_ns();
+            if (s >= warmup) {
+                total_ns += t1 - t0;
+            }
+        }
+    }
+    res.ns_per_sample = (double) total_ns / samples;
+    if (after) {
+        res.capacity    = self.task_capacity;
+        res.table_bytes = (size_t) self.task_capacity * (sizeof(TaskUsageSample) + SAMPLES * (2 * sizeof(float) + sizeof(uint32_t))) +
+                          (self.task_index.mask + 1) * sizeof(sysmon_index_entry_t);
+    } else {
+        res.capacity    = s_legacy_capacity;
+        res.table_bytes = (size_t) s_legacy_capacity * sizeof(legacy_task_t);
+    }
+    return res;
+}
+//---------
+int main(int argc, char** argv) {
+    int      only_tasks  = 0;
+    uint32_t samples     = 2000;
+    uint32_t churn_every = 4;
+    uint32_t seed        = 12345;
+    bool     verbose     = false;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--tasks") && i + 1 < argc) {
+            only_tasks = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--samples") && i + 1 < argc) {
+            samples = (uint32_t) atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--churn-every") && i + 1 < argc) {
+            churn_every = (uint32_t) atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--seed") && i + 1 < argc) {
+            seed = (uint32_t) atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--verbose")) {
+            verbose = true;
+        } else {
+            fprintf(stderr, "usage: %s [--tasks N] [--samples N] [--churn-every N] [--seed N] [--verbose]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (churn_every == 0 || samples == 0) {
+        fprintf(stderr, "--samples and --churn-every must be > 0\n");
+        return 2;
+    }
+    if (!verbose && !freopen("/dev/null", "w", stderr)) {  // ESP_LOGI din sysmon_tasks.c / sysmon_stack.c
+        return 2;
+    }
+
+    // Task-urile sterse isi tin slotul SAMPLES sample-uri: live + SAMPLES / churn_every <= SYSMON_MAX_TRACKED_TASKS
+    static const int sizes[] = { 50, 100, 128, 200, 240 };
+    int              count   = only_tasks ? 1 : (int) (sizeof(sizes) / sizeof(sizes[0]));
+    int              errors  = 0;
+
+    printf("%u samples per run after %u warm-up samples, one task replaced every %u samples, %d-sample history\n\n", (unsigned) samples,
+           2u * SAMPLES, (unsigned) churn_every, SAMPLES);
+    printf("%6s | %14s %9s %9s | %14s %9s %9s | %7s  %s\n", "TASKS", "before ns/smp", "slots", "table[B]", "after ns/smp", "slots", "table[B]",
+           "speedup", "checks");
+    for (int c = 0; c < count; c++) {
+        int tasks = only_tasks ? only_tasks : sizes[c];
+        if (tasks < 3 || tasks + (int) (SAMPLES / churn_every) > SYSMON_MAX_TRACKED_TASKS) {
+            fprintf(stdout, "--tasks %d: need 3 <= tasks and tasks + %d lingering <= %d\n", tasks, SAMPLES / (int) churn_every,
+                    SYSMON_MAX_TRACKED_TASKS);
+            return 2;
+        }
+        run_result_t before = run(false, tasks, samples, churn_every, seed);
+        run_result_t after  = run(true, tasks, samples, churn_every, seed);
+        errors += after.errors;
+        printf("%6d | %14.0f %9d %9zu | %14.0f %9d %9zu | %6.1fx  %s\n", tasks, before.ns_per_sample, before.capacity, before.table_bytes,
+               after.ns_per_sample, after.capacity, after.table_bytes, before.ns_per_sample / after.ns_per_sample,
+               after.errors ? "FAIL" : "ok");
+    }
+
+    _tasks_free();
+    sysmon_snapshot_cleanup();
+    sysmon_stack_cleanup();
+    free(s_legacy);
+    free(s_legacy_stack);
+    printf("\n%s\n", errors ? "checks FAILED" : "all checks passed");
+    return errors ? 1 : 0;
+}
@@ -0,0 +1,461 @@
+/*
+ * bench_sysmon_www - asset-urile dashboard-ului sysmon prin mylibs/sysmon/src/sysmon_www.c
+ *
+ * Tabelele sunt generate la build de mylibs/sysmon/tools/sysmon_www_pack.py, ca in
+ * componenta: sysmon_www_files cu --bundle (default-ul din Kconfig) si bench_www_plain_files
+ * fara. http_handle_static_file() ruleaza contra unui httpd stub (stubs/esp_http_server.h)
+ * care inregistreaza statusul, headerele si body-ul.
+ *
+ *   1. fiecare asset: 200, Content-Type, Content-Encoding: gzip, ETag, Cache-Control, Vary;
+ *      body-ul dezarhivat (zlib) e fisierul din www/ (index.html: fara ?v=<hash>, respectiv
+ *      cu script-urile inlocuite de continutul lor); fiecare ?v= e prefixul ETag-ului
+ *      asset-ului referit.
+ *   2. If-None-Match: ETag-ul exact, W/"...", intr-o lista, * -> 304 fara body, dar cu ETag
+ *      si Cache-Control; alt ETag, ETag trunchiat, header prea lung -> 200.
+ *   3. un browser simulat (cache dupa Cache-Control/ETag) deschide dashboard-ul de doua ori:
+ *      cereri si bytes de body la prima deschidere si la una cu cache-ul cald, fata de
+ *      handler-ul vechi (10 fisiere necomprimate la fiecare deschidere), plus flash-ul ocupat.
+ *
+ * Usage: bench_sysmon_www
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <zlib.h>
+
+#include "esp_http_server.h"
+#include "sysmon_config.h"
+
+#define MAX_HEADERS  16
+#define MAX_BODY     (1024u * 1024u)
+#define MAX_CACHED   16
+
+extern const static_file_config_t bench_www_plain_files[];
+extern const size_t               bench_www_plain_file_count;
+
+esp_err_t http_handle_static_file(httpd_req_t* request);
+
+/**********************
+ *   HTTPD STUB
+ **********************/
+typedef struct {
+    const char* if_none_match;
+    const char* status;
+    const char* type;
+    const char* hdr_name[MAX_HEADERS];
+    const char* hdr_value[MAX_HEADERS];
+    int         hdr_count;
+    const char* body;
+    ssize_t     body_len;
+    int         sends;
+} bench_req_t;
+
+size_t httpd_req_get_hdr_value_len(httpd_req_t* r, const char* field) {
+    bench_req_t* b = (bench_req_t*) r->aux;
+    if (strcmp(field, "If-None-Match") != 0 || b->if_none_match == NULL) {
+        return 0;
+    }
+    return strlen(b->if_none_match);
+}
+//---------
+esp_err_t httpd_req_get_hdr_value_str(httpd_req_t* r, const char* field, char* val, size_t val_size) {
+    bench_req_t* b   = (bench_req_t*) r->aux;
+    size_t       len = httpd_req_get_hdr_value_len(r, field);
+    if (len == 0) {
+        return ESP_ERR_NOT_FOUND;
+    }
+    snprintf(val, val_size, "%s", b->if_none_match);
+    return len < val_size ? ESP_OK : ESP_ERR_HTTPD_RESULT_TRUNC;
+}
+//---------
+esp_err_t httpd_resp_set_type(httpd_req_t* r, const char* type) {
+    ((bench_req_t*) r->aux)->type = type;
+    return ESP_OK;
+}
+//---------
+esp_err_t httpd_resp_set_hdr(httpd_req_t* r, const char* field, const char* value) {
+    bench_req_t* b = (bench_req_t*) r->aux;
+    if (b->hdr_count == MAX_HEADERS) {
+        return ESP_FAIL;
+    }
+    b->hdr_name[b->hdr_count]  = field;
+    b->hdr_value[b->hdr_count] = value;
+    b->hdr_count++;
+    return ESP_OK;
+}
+//---------
+esp_err_t httpd_resp_set_status(httpd_req_t* r, const char* status) {
+    ((bench_req_t*) r->aux)->status = status;
+    return ESP_OK;
+}
+//---------
+esp_err_t httpd_resp_send(httpd_req_t* r, const char* buf, ssize_t buf_len) {
+    bench_req_t* b = (bench_req_t*) r->aux;
+    b->body        = buf;
+    b->body_len    = buf_len == HTTPD_RESP_USE_STRLEN ? (ssize_t) strlen(buf) : buf_len;
+    b->sends++;
+    return ESP_OK;
+}
+//---------
+esp_err_t httpd_resp_send_500(httpd_req_t* r) {
+    return httpd_resp_set_status(r, "500 Internal Server Error") == ESP_OK ? httpd_resp_send(r, NULL, 0) : ESP_FAIL;
+}
+//---------
+static const char* header(const bench_req_t* b, const char* name) {
+    for (int i = 0; i < b->hdr_count; i++) {
+        if (strcmp(b->hdr_name[i], name) == 0) {
+            return b->hdr_value[i];
+        }
+    }
+    return NULL;
+}
+//---------
+static void request(const static_file_config_t* config, const char* if_none_match, bench_req_t* b) {
+    memset(b, 0, sizeof(*b));
+    b->status           = "200 OK";
+    b->if_none_match    = if_none_match;
+    httpd_req_t req     = { .user_ctx = (void*) config, .aux = b };
+    if (http_handle_static_file(&req) != ESP_OK) {
+        b->status = "handler error";
+    }
+}
+
+/**********************
+ *   UTILS
+ **********************/
+typedef struct {
+    const char*                  name;
+    const static_file_config_t*  files;
+    size_t                       count;
+    bool                         bundled;
+} table_t;
+
+static int s_errors;
+
+#define CHECK(cond, ...)                     \
+    do {                                     \
+        if (!(cond)) {                       \
+            if (s_errors++ < 10) {           \
+                printf("  FAIL: " __VA_ARGS__); \
+                printf("\n");                \
+            }                                \
+        }                                    \
+    } while (0)
+
+static char* read_file(const char* rel, size_t* len) {
+    char path[512];
+    snprintf(path, sizeof(path), "%s/%s", SYSMON_WWW_DIR, rel);
+    FILE* f = fopen(path, "rb");
+    if (f == NULL) {
+        return NULL;
+    }
+    char* data = malloc(MAX_BODY);
+    *len       = fread(data, 1, MAX_BODY - 1, f);
+    data[*len] = '\0';
+    fclose(f);
+    return data;
+}
+//---------
+static size_t gunzip(const char* in, size_t in_len, char* out, size_t out_size) {
+    z_stream zs = { 0 };
+    if (inflateInit2(&zs, 16 + MAX_WBITS) != Z_OK) {
+        return 0;
+    }
+    zs.next_in   = (Bytef*) in;
+    zs.avail_in  = (uInt) in_len;
+    zs.next_out  = (Bytef*) out;
+    zs.avail_out = (uInt) (out_size - 1);
+    int rc       = inflate(&zs, Z_FINISH);
+    size_t len   = rc == Z_STREAM_END ? zs.total_out : 0;
+    inflateEnd(&zs);
+    out[len] = '\0';
+    return len;
+}
+//---------
+static const static_file_config_t* find(const table_t* t, const char* uri, size_t uri_len) {
+    for (size_t i = 0; i < t->count; i++) {
+        if (strlen(t->files[i].uri) == uri_len && strncmp(t->files[i].uri, uri, uri_len) == 0) {
+            return &t->files[i];
+        }
+    }
+    return NULL;
+}
+//---------
+/* Urmatoarea referinta locala '/css/..' sau "/js/.." din html, intoarce pointerul dupa ea */
+static const char* next_ref(const char* p, const char** ref, size_t* ref_len) {
+    for (; *p != '\0'; p++) {
+        if ((p[0] == '"' || p[0] == '\'') && (strncmp(p + 1, "/css/", 5) == 0 || strncmp(p + 1, "/js/", 4) == 0)) {
+            const char* end = strchr(p + 1, p[0]);
+            if (end == NULL) {
+                return NULL;
+            }
+            *ref     = p + 1;
+            *ref_len = (size_t) (end - p - 1);
+            return end + 1;
+        }
+    }
+    return NULL;
+}
+//---------
+static const char* www_path(const char* uri) {
+    return strcmp(uri, "/") == 0 ? "index.html" : uri + 1;
+}
+
+/**********************
+ *   1. CONTINUT + HEADERE
+ **********************/
+static void check_table(const table_t* t, char* html) {
+    char*       buf = malloc(MAX_BODY);
+    bench_req_t b;
+    for (size_t i = 0; i < t->count; i++) {
+        const static_file_config_t* f = &t->files[i];
+        request(f, NULL, &b);
+        CHECK(strcmp(b.status, "200 OK") == 0 && b.sends == 1, "%s %s: status %s", t->name, f->uri, b.status);
+        CHECK(b.type != NULL && strcmp(b.type, f->content_type) == 0, "%s %s: Content-Type", t->name, f->uri);
+        CHECK(header(&b, "Content-Encoding") && !strcmp(header(&b, "Content-Encoding"), "gzip"), "%s %s: Content-Encoding", t->name, f->uri);
+        CHECK(header(&b, "ETag") && !strcmp(header(&b, "ETag"), f->etag), "%s %s: ETag", t->name, f->uri);
+        CHECK(header(&b, "Cache-Control") && !strcmp(header(&b, "Cache-Control"), f->cache_control), "%s %s: Cache-Control", t->name,
+              f->uri);
+        CHECK(header(&b, "Vary") && !strcmp(header(&b, "Vary"), "Accept-Encoding"), "%s %s: Vary", t->name, f->uri);
+        CHECK(strlen(f->etag) == 18 && f->etag[0] == '"' && f->etag[17] == '"', "%s %s: ETag format %s", t->name, f->uri, f->etag);
+        CHECK(b.body == (const char*) f->start && b.body_len == f->end - f->start, "%s %s: body is not the packed data", t->name, f->uri);
+
+        size_t len = gunzip(b.body, (size_t) b.body_len, buf, MAX_BODY);
+        CHECK(len > 0, "%s %s: not gzip", t->name, f->uri);
+        for (size_t j = 0; j < i; j++) {
+            CHECK(strcmp(t->files[j].etag, f->etag) != 0, "%s: %s and %s share an ETag", t->name, f->uri, t->files[j].uri);
+        }
+
+        if (strcmp(f->uri, "/") != 0) {
+            size_t disk_len = 0;
+            char*  disk     = read_file(www_path(f->uri), &disk_len);
+            CHECK(disk != NULL && disk_len == len && memcmp(disk, buf, len) == 0, "%s %s: differs from www/", t->name, f->uri);
+            CHECK(strcmp(f->cache_control, "public, max-age=31536000, immutable") == 0, "%s %s: not immutable", t->name, f->uri);
+            free(disk);
+            continue;
+        }
+
+        CHECK(strcmp(f->cache_control, "no-cache") == 0, "%s /: must be revalidated", t->name);
+        memcpy(html, buf, len + 1);
+
+        // Fiecare referinta locala are ?v=<prefixul ETag-ului>, referintele fara ?v= sunt scoase
+        const char* ref;
+        size_t      ref_len;
+        int         refs = 0;
+        for (const char* p = next_ref(buf, &ref, &ref_len); p != NULL; p = next_ref(p, &ref, &ref_len)) {
+            const char* q = memchr(ref, '?', ref_len);
+            CHECK(q != NULL && ref + ref_len - q == 11, "%s /: reference %.*s not versioned", t->name, (int) ref_len, ref);
+            if (q == NULL) {
+                continue;
+            }
+            const static_file_config_t* target = find(t, ref, (size_t) (q - ref));
+            CHECK(target != NULL && strncmp(q + 3, target->etag + 1, 8) == 0, "%s /: %.*s does not match its ETag", t->name,
+                  (int) ref_len, ref);
+            refs++;
+        }
+        CHECK(refs == (int) t->count - 1, "%s /: %d versioned references for %d assets", t->name, refs, (int) t->count - 1);
+
+        // Cu ?v= scos, index.html e fisierul original (neimpachetat) sau il contine pe fiecare script (impachetat)
+        size_t disk_len = 0;
+        char*  disk     = read_file("index.html", &disk_len);
+        char*  w        = buf;
+        for (const char* r = buf; *r != '\0';) {
+            if (r[0] == '?' && r[1] == 'v' && r[2] == '=') {
+                r += 11;
+                continue;
+            }
+            *w++ = *r++;
+        }
+        *w = '\0';
+        if (!t->bundled) {
+            CHECK(disk != NULL && strcmp(disk, buf) == 0, "%s /: differs from www/index.html", t->name);
+        } else {
+            CHECK(strstr(buf, "<script src=\"/js/") == NULL, "%s /: a local script was not inlined", t->name);
+            const char* scripts[] = { "js/theme.js", "js/config.js", "js/utils.js", "js/charts.js", "js/table.js", "js/app.js" };
+            for (size_t s = 0; s < sizeof(scripts) / sizeof(scripts[0]); s++) {
+                size_t js_len = 0;
+                char*  js     = read_file(scripts[s], &js_len);
+                while (js_len > 0 && js[js_len - 1] == '\n') {
+                    js[--js_len] = '\0';
+                }
+                CHECK(js != NULL && strstr(buf, js) != NULL, "%s /: %s not inlined", t->name, scripts[s]);
+                free(js);
+            }
+        }
+        free(disk);
+    }
+    free(buf);
+}
+
+/**********************
+ *   2. IF-NONE-MATCH
+ **********************/
+static void check_conditional(const table_t* t) {
+    const static_file_config_t* f     = &t->files[0];
+    const static_file_config_t* other = &t->files[1];
+    char                        list[256];
+    char                        weak[64];
+    char                        trunc[64];
+    char                        lng[256];
+    snprintf(list, sizeof(list), "%s, %s", other->etag, f->etag);
+    snprintf(weak, sizeof(weak), "W/%s", f->etag);
+    snprintf(trunc, sizeof(trunc), "%.*s\"", (int) strlen(f->etag) - 2, f->etag);
+    memset(lng, ' ', 200);
+    snprintf(lng + 200, sizeof(lng) - 200, ",%s", f->etag);
+
+    struct {
+        const char* inm;
+        bool        not_modified;
+    } cases[] = {
+        { f->etag, true }, { weak, true }, { list, true }, { " * ", true }, { other->etag, false },
+        { trunc, false },  { "", false },  { lng, false },  { NULL, false },
+    };
+    bench_req_t b;
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        request(f, cases[i].inm, &b);
+        const char* inm = cases[i].inm == NULL ? "(none)" : cases[i].inm == lng ? "(200-byte list)" : cases[i].inm;
+        if (cases[i].not_modified) {
+            CHECK(strcmp(b.status, "304 Not Modified") == 0 && b.body_len == 0, "%s If-None-Match %s: %s, %zd bytes", t->name, inm,
+                  b.status, b.body_len);
+            CHECK(header(&b, "Content-Encoding") == NULL, "%s If-None-Match %s: 304 with Content-Encoding", t->name, inm);
+        } else {
+            CHECK(strcmp(b.status, "200 OK") == 0 && b.body_len == f->end - f->start, "%s If-None-Match %s: %s", t->name, inm, b.status);
+        }
+        CHECK(header(&b, "ETag") && header(&b, "Cache-Control"), "%s If-None-Match %s: ETag/Cache-Control missing", t->name, inm);
+    }
+}
+
+/**********************
+ *   3. BROWSER SIMULAT
+ **********************/
+typedef struct {
+    char        url[128];
+    const char* etag;
+    bool        immutable;
+} cached_t;
+
+typedef struct {
+    cached_t entry[MAX_CACHED];
+    int      count;
+} browser_t;
+
+typedef struct {
+    int    requests;
+    int    not_modified;
+    size_t body_bytes;
+} visit_t;
+
+static cached_t* cache_find(browser_t* br, const char* url, size_t len) {
+    for (int i = 0; i < br->count; i++) {
+        if (strlen(br->entry[i].url) == len && strncmp(br->entry[i].url, url, len) == 0) {
+            return &br->entry[i];
+        }
+    }
+    return NULL;
+}
+//---------
+/* GET url prin cache-ul browserului: nimic daca e imutabil, If-None-Match daca e in cache */
+static void fetch(browser_t* br, const table_t* t, const char* url, size_t len, visit_t* v) {
+    cached_t* c = cache_find(br, url, len);
+    if (c != NULL && c->immutable) {
+        return;
+    }
+    const char*                 q = memchr(url, '?', len);
+    const static_file_config_t* f = find(t, url, q != NULL ? (size_t) (q - url) : len);
+    if (f == NULL) {
+        CHECK(false, "%s: %.*s not served", t->name, (int) len, url);
+        return;
+    }
+    bench_req_t b;
+    request(f, c != NULL ? c->etag : NULL, &b);
+    v->requests++;
+    v->not_modified += strcmp(b.status, "304 Not Modified") == 0;
+    v->body_bytes += (size_t) b.body_len;
+    if (c == NULL && br->count < MAX_CACHED) {
+        c = &br->entry[br->count++];
+        snprintf(c->url, sizeof(c->url), "%.*s", (int) len, url);
+    }
+    if (c != NULL) {
+        c->etag      = header(&b, "ETag");
+        c->immutable = strstr(header(&b, "Cache-Control"), "immutable") != NULL;
+    }
+}
+//---------
+static visit_t open_dashboard(browser_t* br, const table_t* t, const char* html) {
+    visit_t v = { 0 };
+    fetch(br, t, "/", 1, &v);
+    const char* ref;
+    size_t      ref_len;
+    for (const char* p = next_ref(html, &ref, &ref_len); p != NULL; p = next_ref(p, &ref, &ref_len)) {
+        fetch(br, t, ref, ref_len, &v);
+    }
+    return v;
+}
+//---------
+static size_t flash_bytes(const table_t* t) {
+    size_t total = 0;
+    for (size_t i = 0; i < t->count; i++) {
+        total += (size_t) (t->files[i].end - t->files[i].start);
+    }
+    return total;
+}
+
+/**********************
+ *   MAIN
+ **********************/
+int main(int argc, char** argv) {
+    if (argc > 1) {
+        fprintf(stderr, "usage: %s\n", argv[0]);
+        return 2;
+    }
+
+    const table_t tables[] = {
+        { "plain", bench_www_plain_files, bench_www_plain_file_count, false },
+        { "bundled", sysmon_www_files, sysmon_www_file_count, true },
+    };
+
+    // Handler-ul vechi: 10 fisiere TEXT necomprimate, fara ETag/Cache-Control -> toate la fiecare deschidere
+    const char* files[] = { "index.html", "css/sysmon-theme-color-vars.css", "css/sysmon-theme-utility-classes.css", "css/sysmon-theme.css",
+                            "js/theme.js", "js/config.js", "js/utils.js", "js/charts.js", "js/table.js", "js/app.js" };
+    size_t raw = 0;
+    for (size_t i = 0; i < sizeof(files) / sizeof(files[0]); i++) {
+        size_t len  = 0;
+        char*  data = read_file(files[i], &len);
+        if (data == NULL) {
+            fprintf(stderr, "cannot read %s/%s\n", SYSMON_WWW_DIR, files[i]);
+            return 1;
+        }
+        raw += len;
+        free(data);
+    }
+    int n_files = (int) (sizeof(files) / sizeof(files[0]));
+
+    printf("sysmon dashboard assets (%s)\n\n", SYSMON_WWW_DIR);
+    printf("  variant  |   first open    |     warm open       |  flash\n");
+    printf("           |  reqs     bytes | reqs  304s    bytes |  bytes\n");
+    printf("  %-8s | %5d %9zu | %4d %5d %8zu | %6zu\n", "before", n_files, raw, n_files, 0, raw, raw + (size_t) n_files);
+
+    char* html = malloc(MAX_BODY);
+    for (size_t i = 0; i < sizeof(tables) / sizeof(tables[0]); i++) {
+        const table_t* t = &tables[i];
+        check_table(t, html);
+        check_conditional(t);
+
+        browser_t br    = { 0 };
+        visit_t   first = open_dashboard(&br, t, html);
+        visit_t   warm  = open_dashboard(&br, t, html);
+        CHECK(first.requests == (int) t->count && first.not_modified == 0, "%s: first open made %d requests", t->name, first.requests);
+        CHECK(warm.requests == 1 && warm.not_modified == 1 && warm.body_bytes == 0, "%s: warm open made %d requests, %zu bytes", t->name,
+              warm.requests, warm.body_bytes);
+        printf("  %-8s | %5d %9zu | %4d %5d %8zu | %6zu\n", t->name, first.requests, first.body_bytes, warm.requests, warm.not_modified,
+               warm.body_bytes, flash_bytes(t));
+    }
+    free(html);
+
+    printf("\n  first / warm open: requests and body bytes with an empty / warm browser cache\n");
+    printf("\n%s\n", s_errors == 0 ? "all checks passed" : "FAILED");
+    return s_errors == 0 ? 0 : 1;
+}
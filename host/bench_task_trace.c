@@ -0,0 +1,744 @@
+/*
+ * bench_task_trace - agregatorul de comutari din mylibs/task-trace-v001 pe fluxuri sintetice
+ *
+ * Un scheduler simulat (2 core-uri, task-uri cu prioritati si afinitate, idle pe fiecare core)
+ * produce exact evenimentele hook-urilor FreeRTOS (switch in / out, ready, delete) si, separat,
+ * adevarul: timp de rulare, comutari, preemptari, treziri si latente per task, busy per core.
+ *
+ *   1. scenarii scrise de mana: preemptare, latenta de pe alt core, READY vechi, READY cat
+ *      ruleaza, delete + handle refolosit (alta generatie), wrap al stamp-urilor pe 32 de biti,
+ *      ring plin (marker de gap, timp necunoscut)
+ *   2. simulare, un thread: evenimentele trec prin ring-uri si sunt golite la momente aleatoare,
+ *      cu watermark-uri aleatoare -> totalurile == adevarul, exact
+ *   3. simulare, thread-uri: cate un producator per core (ring-uri mici, asteapta cand sunt
+ *      pline) si un consumator care goleste cu watermark = progresul minim al producatorilor
+ *      -> acelasi rezultat
+ *   4. documentul /sched (mylibs/sysmon/src/sysmon_sched.c) peste agregatorul din scenariul 1
+ *   5. costul: ns per eveniment scris in ring (hook) si ns per eveniment agregat
+ *
+ * Usage: bench_task_trace [--steps N] [--seed S]
+ */
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "sysmon.h"
+#include "sysmon_sched.h"
+#include "sysmon_stream.h"
+#include "task_trace.h"
+#include "task_trace_agg.h"
+#include "task_trace_ring.h"
+
+#define SIM_CORES     (2)
+#define SIM_WORKERS   (12)
+#define SIM_TASKS     (SIM_CORES + SIM_WORKERS)
+#define SIM_DEAD_MAX  (3)     // Task-uri sterse in acelasi timp, cel mult
+#define TABLE_SLOTS   (64)
+#define REPLAY_RING   (4096)  // Un thread: incape orice lot dintre doua drain-uri
+#define THREAD_RING   (256)   // Thread-uri: mic, producatorii asteapta des
+#define OUT_SIZE      (16u * 1024u)
+#define STAMP_BASE    (0xFFFFFFFFu - 50000u)  // Stamp-urile trec prin 0 devreme
+
+/**********************
+ *   HELPERS
+ **********************/
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000ull + (uint64_t) ts.tv_nsec;
+}
+//---------
+static uint32_t s_rng = 1;
+
+static uint32_t rnd(uint32_t n) {
+    s_rng ^= s_rng << 13;
+    s_rng ^= s_rng >> 17;
+    s_rng ^= s_rng << 5;
+    return s_rng % n;
+}
+//---------
+static bool expect(bool cond, const char* what) {
+    printf("  %-72s %s\n", what, cond ? "ok" : "FAIL");
+    return cond;
+}
+//---------
+static void name_fn(void* ctx, uint32_t task, char* name, size_t len) {
+    (void) ctx;
+    snprintf(name, len, "T%04x", (unsigned) (task & 0xFFFFu));
+}
+//---------
+/* Cerute la link de documentele de task-uri / telemetrie din sysmon_stream.c, nefolosite aici */
+const char* _get_task_display_name(const char* task_name) {
+    return task_name;
+}
+//---------
+esp_err_t _get_wifi_rssi(int8_t* rssi) {
+    *rssi = 0;
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+/**********************
+ *   1. HAND-WRITTEN SCENARIOS
+ **********************/
+#define A (0x3FCA0100u)
+#define B (0x3FCA0200u)
+#define X (0x3FCA0300u)
+#define I0 (0x3FCA1000u)
+#define I1 (0x3FCA2000u)
+
+static task_trace_task_t s_table[TABLE_SLOTS];
+static task_trace_agg_t  s_agg;
+
+static void ev(uint32_t core, uint32_t stamp, uint32_t task, uint32_t type) {
+    task_trace_agg_event(&s_agg, core, stamp, task | type);
+}
+//---------
+static const task_trace_task_t* row_of(uint32_t task) {
+    static task_trace_task_t copy[TABLE_SLOTS];
+    uint32_t                 n = task_trace_agg_copy(&s_agg, copy, TABLE_SLOTS);
+    for (uint32_t i = 0; i < n; i++) {
+        if (copy[i].task == task) {
+            return &copy[i];
+        }
+    }
+    return NULL;
+}
+//---------
+static bool check_scenarios(void) {
+    bool ok = true;
+
+    // Preemptare si trezire pe acelasi core: A ruleaza, B e trezit la 10 si il preempteaza, B se
+    // blocheaza la 30, A revine (fara READY intre -> preemptat)
+    task_trace_agg_init(&s_agg, s_table, TABLE_SLOTS, 2, name_fn, NULL);
+    task_trace_agg_set_idle(&s_agg, 0, I0);
+    ev(0, 0, A, TASK_TRACE_EV_IN);
+    ev(0, 10, B, TASK_TRACE_EV_READY);
+    ev(0, 10, A, TASK_TRACE_EV_OUT);
+    ev(0, 10, B, TASK_TRACE_EV_IN);
+    ev(0, 30, B, TASK_TRACE_EV_OUT);
+    ev(0, 30, A, TASK_TRACE_EV_IN);
+    task_trace_agg_advance(&s_agg, 50);
+    const task_trace_task_t* a = row_of(A);
+    const task_trace_task_t* b = row_of(B);
+    ok &= expect(a && a->run_us == 30 && a->switches == 2 && a->preemptions == 1 && a->wakeups == 0,
+        "preempted task: 30 us run, 2 switches, 1 preemption, no wakeup");
+    ok &= expect(b && b->run_us == 20 && b->wakeups == 1 && b->latency_sum_us == 0 && b->preemptions == 0,
+        "woken task: 20 us run, 1 wakeup with 0 us latency");
+    ok &= expect(s_agg.cores[0].elapsed_us == 50 && s_agg.cores[0].busy_us == 50 && s_agg.cores[0].switches == 3,
+        "core 0: 50 us elapsed, all busy, 3 switches");
+    ok &= expect(a && strcmp(a->name, "T0100") == 0, "name from the name callback");
+
+    // Latenta de pe alt core: X trezit pe core 1 la 100, rulat pe core 0 la 140; READY vechi ignorat
+    ev(1, 90, I1, TASK_TRACE_EV_IN);
+    ev(1, 100, X, TASK_TRACE_EV_READY);
+    ev(0, 140, A, TASK_TRACE_EV_OUT);
+    ev(0, 140, X, TASK_TRACE_EV_IN);
+    ev(0, 200, X, TASK_TRACE_EV_OUT);
+    ev(0, 200, A, TASK_TRACE_EV_IN);
+    ev(1, 190, X, TASK_TRACE_EV_READY);  // Mai vechi decat switch out-ul de la 200
+    ev(0, 260, A, TASK_TRACE_EV_OUT);
+    ev(0, 260, X, TASK_TRACE_EV_IN);
+    const task_trace_task_t* x = row_of(X);
+    ok &= expect(x && x->wakeups == 1 && x->latency_sum_us == 40 && x->latency_max_us == 40 && x->preemptions == 1,
+        "cross-core wakeup: 40 us latency; stale READY ignored (preemption)");
+
+    // READY cat ruleaza (prioritate schimbata) nu e o trezire
+    ev(1, 270, X, TASK_TRACE_EV_READY);
+    ev(0, 300, X, TASK_TRACE_EV_OUT);
+    ev(0, 300, A, TASK_TRACE_EV_IN);
+    ev(0, 320, A, TASK_TRACE_EV_OUT);
+    ev(0, 320, X, TASK_TRACE_EV_IN);
+    x = row_of(X);
+    ok &= expect(x && x->wakeups == 1 && x->preemptions == 2, "READY while running is not a wakeup");
+
+    // Delete cat ruleaza (vTaskDelete(NULL)), handle refolosit de un task nou
+    uint32_t old_gen = x ? x->generation : 0;
+    ev(0, 330, X, TASK_TRACE_EV_DELETE);
+    ev(0, 335, X, TASK_TRACE_EV_OUT);
+    ev(0, 335, A, TASK_TRACE_EV_IN);
+    ok &= expect(row_of(X) == NULL && s_agg.deleted == 1, "deleted task leaves the table, late switch out ignored");
+    ok &= expect(s_agg.cores[0].unknown_us == 5, "time between delete and next switch in is unknown (5 us)");
+    ev(1, 340, X, TASK_TRACE_EV_READY);
+    ev(1, 350, I1, TASK_TRACE_EV_OUT);
+    ev(1, 350, X, TASK_TRACE_EV_IN);
+    x = row_of(X);
+    static task_trace_task_t copy[TABLE_SLOTS];
+    uint32_t                 n = task_trace_agg_copy(&s_agg, copy, TABLE_SLOTS);
+    ok &= expect(x && x->generation != old_gen && x->run_us == 0 && x->switches == 1 && x->wakeups == 1 &&
+                     x->latency_sum_us == 10 && task_trace_find(copy, n, X, old_gen) == NULL &&
+                     task_trace_find(copy, n, X, x->generation) != NULL,
+        "reused handle: new generation, counters from zero, old generation not found");
+
+    // Wrap: stamp-urile trec prin 0xFFFFFFFF
+    task_trace_agg_init(&s_agg, s_table, TABLE_SLOTS, 1, NULL, NULL);
+    ev(0, 0xFFFFFFF0u, A, TASK_TRACE_EV_IN);
+    ev(0, 0x00000010u, B, TASK_TRACE_EV_READY);
+    ev(0, 0x00000010u, A, TASK_TRACE_EV_OUT);
+    ev(0, 0x00000010u, B, TASK_TRACE_EV_IN);
+    task_trace_agg_advance(&s_agg, 0x00000030u);
+    a = row_of(A);
+    b = row_of(B);
+    ok &= expect(a && b && a->run_us == 32 && b->run_us == 32 && s_agg.cores[0].elapsed_us == 64,
+        "32 bit stamps wrap: 32 us + 32 us across 0xFFFFFFFF");
+
+    // Ring plin: evenimentele pierdute sunt numarate, timpul din gap e necunoscut
+    task_trace_event_t slots[16];
+    task_trace_ring_t  ring;
+    task_trace_ring_init(&ring, slots, 16);
+    task_trace_agg_init(&s_agg, s_table, TABLE_SLOTS, 1, NULL, NULL);
+    uint32_t stamp = 0, pushed = 0, dropped = 0;
+    for (int i = 0; i < 41; i++, stamp += 10) {
+        uint32_t word = (i & 1) ? ((i & 2) ? A : B) | TASK_TRACE_EV_OUT : ((i & 2) ? B : A) | TASK_TRACE_EV_IN;
+        if (task_trace_ring_push(&ring, stamp, word)) {
+            pushed++;
+        } else {
+            dropped++;
+        }
+    }
+    uint32_t first_lost = 10u * pushed;
+    task_trace_agg_drain(&s_agg, &ring, stamp);
+    task_trace_ring_push(&ring, 1000, X | TASK_TRACE_EV_IN);
+    task_trace_agg_drain(&s_agg, &ring, 1100);
+    ok &= expect(pushed == 16 && dropped == 25 && s_agg.cores[0].lost == 25 && s_agg.cores[0].gaps == 1,
+        "full ring: 16 kept, 25 dropped and counted, one gap marker");
+    ok &= expect(s_agg.cores[0].unknown_us == 1000 - first_lost && s_agg.cores[0].running == X &&
+                     s_agg.cores[0].elapsed_us == 1100,
+        "gap: unknown from the first lost event to the next switch in");
+    return ok;
+}
+
+/**********************
+ *   2./3. SIMULATED SCHEDULER + GROUND TRUTH
+ **********************/
+typedef enum { SIM_BLOCKED = 0, SIM_READY, SIM_RUNNING, SIM_DEAD } sim_state_t;
+
+typedef struct {
+    uint64_t run_us;
+    uint32_t switches;
+    uint32_t preemptions;
+    uint32_t wakeups;
+    uint64_t latency_sum_us;
+    uint32_t latency_max_us;
+} truth_t;
+
+typedef struct {
+    uint32_t    handle;
+    int         prio;
+    int         affinity;  // -1 = any core
+    sim_state_t state;
+    bool        woken;     // Made ready since its last switch out (or since created)
+    bool        had_out;   // Switched out at least once in this incarnation
+    uint64_t    ready_at;  // When it became ready (wake latency, FIFO among equal priorities)
+    uint64_t    since;     // Start of the running slice
+    truth_t     truth;
+} sim_task_t;
+
+typedef struct {
+    task_trace_event_t* ev;
+    uint32_t            count;
+    uint32_t            cap;
+} stream_t;
+
+static sim_task_t s_tasks[SIM_TASKS];
+static int        s_running[SIM_CORES];
+static stream_t   s_stream[SIM_CORES];
+static uint64_t   s_busy[SIM_CORES];
+static uint32_t   s_switches[SIM_CORES];
+static uint64_t   s_end;
+
+static void emit(int core, uint64_t t, uint32_t word) {
+    stream_t* s = &s_stream[core];
+    if (s->count == s->cap) {
+        s->cap = s->cap ? s->cap * 2 : 4096;
+        s->ev  = realloc(s->ev, s->cap * sizeof(task_trace_event_t));
+    }
+    s->ev[s->count++] = (task_trace_event_t) {(uint32_t) (STAMP_BASE + t), word};
+}
+//---------
+static int sim_pick(int core) {
+    int best = -1;
+    for (int i = 0; i < SIM_TASKS; i++) {
+        sim_task_t* k = &s_tasks[i];
+        if (k->state != SIM_READY || (k->affinity >= 0 && k->affinity != core)) {
+            continue;
+        }
+        if (best < 0 || k->prio > s_tasks[best].prio ||
+            (k->prio == s_tasks[best].prio && k->ready_at < s_tasks[best].ready_at)) {
+            best = i;
+        }
+    }
+    return best;
+}
+//---------
+static void sim_switch_in(int core, uint64_t t, int i) {
+    sim_task_t* k = &s_tasks[i];
+    emit(core, t, k->handle | TASK_TRACE_EV_IN);
+    if (k->woken) {
+        uint32_t latency = (uint32_t) (t - k->ready_at);
+        k->truth.wakeups++;
+        k->truth.latency_sum_us += latency;
+        if (latency > k->truth.latency_max_us) {
+            k->truth.latency_max_us = latency;
+        }
+    } else if (k->had_out) {
+        k->truth.preemptions++;
+    }
+    k->truth.switches++;
+    k->woken      = false;
+    k->state      = SIM_RUNNING;
+    k->since      = t;
+    s_running[core] = i;
+    s_switches[core]++;
+}
+//---------
+static void sim_charge(int core, uint64_t t) {
+    sim_task_t* k = &s_tasks[s_running[core]];
+    k->truth.run_us += t - k->since;
+    if (s_running[core] >= SIM_CORES) {  // Primele SIM_CORES task-uri sunt idle-urile
+        s_busy[core] += t - k->since;
+    }
+    k->since = t;
+}
+//---------
+static void sim_switch_out(int core, uint64_t t, bool blocks) {
+    sim_task_t* k = &s_tasks[s_running[core]];
+    emit(core, t, k->handle | TASK_TRACE_EV_OUT);
+    sim_charge(core, t);
+    k->had_out      = true;
+    k->state        = blocks ? SIM_BLOCKED : SIM_READY;
+    k->ready_at     = t;
+    s_running[core] = -1;
+}
+//---------
+static void sim_reschedule(uint64_t t) {
+    for (int core = 0; core < SIM_CORES; core++) {
+        int next = sim_pick(core);
+        if (s_running[core] < 0) {
+            sim_switch_in(core, t, next);  // Idle-ul e mereu ready
+        } else if (next >= 0 && s_tasks[next].prio > s_tasks[s_running[core]].prio) {
+            sim_switch_out(core, t, false);
+            sim_switch_in(core, t, next);
+        }
+    }
+}
+//---------
+static int sim_random_task(sim_state_t state) {
+    int start = SIM_CORES + (int) rnd(SIM_WORKERS);
+    for (int n = 0; n < SIM_WORKERS; n++) {
+        int i = SIM_CORES + (start - SIM_CORES + n) % SIM_WORKERS;
+        if (s_tasks[i].state == state) {
+            return i;
+        }
+    }
+    return -1;
+}
+//---------
+static void sim_make_ready(int i, uint64_t t) {
+    sim_task_t* k = &s_tasks[i];
+    emit((int) rnd(SIM_CORES), t, k->handle | TASK_TRACE_EV_READY);
+    k->state    = SIM_READY;
+    k->woken    = true;
+    k->ready_at = t;
+}
+//---------
+static void simulate(uint32_t steps, uint32_t seed) {
+    s_rng = seed;
+    memset(s_tasks, 0, sizeof(s_tasks));
+    for (int core = 0; core < SIM_CORES; core++) {
+        free(s_stream[core].ev);
+        memset(&s_stream[core], 0, sizeof(s_stream[core]));
+        s_running[core]  = -1;
+        s_busy[core]     = 0;
+        s_switches[core] = 0;
+    }
+    for (int i = 0; i < SIM_TASKS; i++) {
+        sim_task_t* k = &s_tasks[i];
+        k->handle     = 0x3FCA0000u + (uint32_t) i * 0x158u;
+        k->prio       = i < SIM_CORES ? 0 : 1 + (int) rnd(5);
+        k->affinity   = i < SIM_CORES ? i : (int) rnd(3) - 1;
+        // Creare: toate devin ready pe core 0, idle-urile nu sunt "trezite"
+        emit(0, 0, k->handle | TASK_TRACE_EV_READY);
+        k->state = SIM_READY;
+        k->woken = true;
+    }
+    sim_reschedule(0);
+
+    uint64_t t    = 0;
+    int      dead = 0;
+    for (uint32_t step = 0; step < steps; step++) {
+        t += 1 + rnd(150);
+        int      core = (int) rnd(SIM_CORES);
+        uint32_t r    = rnd(100);
+        int      i;
+        if (r < 35) {  // Trezire (ISR / alt task)
+            if ((i = sim_random_task(SIM_BLOCKED)) >= 0) {
+                sim_make_ready(i, t);
+            }
+        } else if (r < 65) {  // Task-ul care ruleaza se blocheaza
+            if (s_running[core] >= SIM_CORES) {
+                sim_switch_out(core, t, true);
+                s_running[core] = -1;
+            }
+        } else if (r < 80) {  // Tick: round robin intre prioritati egale
+            int next = sim_pick(core);
+            if (next >= 0 && s_tasks[next].prio == s_tasks[s_running[core]].prio) {
+                sim_switch_out(core, t, false);
+            }
+        } else if (r < 85) {  // Delete al unui task blocat
+            if (dead < SIM_DEAD_MAX && (i = sim_random_task(SIM_BLOCKED)) >= 0) {
+                dead++;
+                emit((int) rnd(SIM_CORES), t, s_tasks[i].handle | TASK_TRACE_EV_DELETE);
+                s_tasks[i].state = SIM_DEAD;
+            }
+        } else if (r < 88) {  // Task nou pe un handle eliberat
+            if ((i = sim_random_task(SIM_DEAD)) >= 0) {
+                dead--;
+                memset(&s_tasks[i].truth, 0, sizeof(truth_t));
+                s_tasks[i].had_out = false;
+                sim_make_ready(i, t);
+            }
+        } else if (r < 90) {  // vTaskDelete(NULL): delete, apoi switch out
+            if (dead < SIM_DEAD_MAX && (i = s_running[core]) >= SIM_CORES) {
+                dead++;
+                emit(core, t, s_tasks[i].handle | TASK_TRACE_EV_DELETE);
+                emit(core, t, s_tasks[i].handle | TASK_TRACE_EV_OUT);
+                sim_charge(core, t);
+                s_tasks[i].state = SIM_DEAD;
+                s_running[core]  = -1;
+            }
+        }
+        sim_reschedule(t);
+    }
+    s_end = t + 100;
+    for (int core = 0; core < SIM_CORES; core++) {
+        sim_charge(core, s_end);
+    }
+}
+//---------
+static bool matches_truth(const char* label) {
+    static task_trace_task_t copy[TABLE_SLOTS];
+    uint32_t                 n      = task_trace_agg_copy(&s_agg, copy, TABLE_SLOTS);
+    uint32_t                 live   = 0;
+    uint32_t                 wrong  = 0;
+    for (int i = 0; i < SIM_TASKS; i++) {
+        const sim_task_t* k = &s_tasks[i];
+        if (k->state == SIM_DEAD) {
+            continue;
+        }
+        live++;
+        const task_trace_task_t* row = NULL;
+        for (uint32_t j = 0; j < n; j++) {
+            if (copy[j].task == k->handle) {
+                row = &copy[j];
+            }
+        }
+        if (!row || row->run_us != k->truth.run_us || row->switches != k->truth.switches ||
+            row->preemptions != k->truth.preemptions || row->wakeups != k->truth.wakeups ||
+            row->latency_sum_us != k->truth.latency_sum_us || row->latency_max_us != k->truth.latency_max_us) {
+            if (wrong++ < 3) {
+                printf("    task %d: run %llu/%llu sw %u/%u pre %u/%u wk %u/%u lat %llu/%llu max %u/%u\n", i,
+                    row ? (unsigned long long) row->run_us : 0ull, (unsigned long long) k->truth.run_us,
+                    row ? row->switches : 0, k->truth.switches, row ? row->preemptions : 0, k->truth.preemptions,
+                    row ? row->wakeups : 0, k->truth.wakeups, row ? (unsigned long long) row->latency_sum_us : 0ull,
+                    (unsigned long long) k->truth.latency_sum_us, row ? row->latency_max_us : 0,
+                    k->truth.latency_max_us);
+            }
+        }
+    }
+    bool cores_ok = true;
+    for (int core = 0; core < SIM_CORES; core++) {
+        const task_trace_core_t* c = &s_agg.cores[core];
+        cores_ok &= c->elapsed_us == s_end && c->busy_us == s_busy[core] && c->unknown_us == 0 &&
+                    c->switches == s_switches[core] && c->gaps == 0;
+    }
+    char what[128];
+    snprintf(what, sizeof(what), "%s: %u live tasks == truth, per-core busy/elapsed/switches", label,
+        (unsigned) live);
+    return expect(wrong == 0 && n == live && cores_ok, what);
+}
+//---------
+static void agg_reset(void) {
+    task_trace_agg_init(&s_agg, s_table, TABLE_SLOTS, SIM_CORES, name_fn, NULL);
+    for (int core = 0; core < SIM_CORES; core++) {
+        task_trace_agg_set_idle(&s_agg, (uint32_t) core, s_tasks[core].handle);
+    }
+}
+//---------
+/* Un thread: se scriu in ring-uri evenimentele pana la un moment aleator, apoi drain cu un watermark aleator */
+static bool replay_single(uint64_t* agg_ns, uint64_t* events) {
+    static task_trace_event_t slots[SIM_CORES][REPLAY_RING];
+    task_trace_ring_t         rings[SIM_CORES];
+    uint32_t                  next[SIM_CORES] = {0};
+    for (int core = 0; core < SIM_CORES; core++) {
+        task_trace_ring_init(&rings[core], slots[core], REPLAY_RING);
+    }
+    agg_reset();
+
+    bool     pushed_all = true;
+    uint64_t t          = 0;
+    uint64_t ns         = 0;
+    while (t < s_end) {
+        t += 1 + rnd(20000);
+        if (t > s_end) {
+            t = s_end;
+        }
+        for (int core = 0; core < SIM_CORES; core++) {
+            stream_t* s = &s_stream[core];
+            while (next[core] < s->count && (uint64_t) (s->ev[next[core]].stamp - STAMP_BASE) <= t) {
+                pushed_all &= task_trace_ring_push(&rings[core], s->ev[next[core]].stamp, s->ev[next[core]].word);
+                next[core]++;
+            }
+        }
+        uint64_t watermark = t - rnd(3000) % (t + 1);  // Uneori in urma evenimentelor deja scrise
+        uint64_t t0        = now_ns();
+        task_trace_agg_drain(&s_agg, rings, (uint32_t) (STAMP_BASE + watermark));
+        ns += now_ns() - t0;
+    }
+    task_trace_agg_drain(&s_agg, rings, (uint32_t) (STAMP_BASE + s_end));
+    *agg_ns = ns;
+    *events = s_agg.events;
+    return pushed_all;
+}
+
+/* Thread-uri: un producator per core, un consumator */
+typedef struct {
+    int                core;
+    task_trace_ring_t* ring;
+    volatile uint32_t* progress;
+    volatile bool*     done;
+} producer_arg_t;
+
+static void* producer(void* p) {
+    producer_arg_t* a = p;
+    stream_t*       s = &s_stream[a->core];
+    for (uint32_t i = 0; i < s->count; i++) {
+        while (a->ring->head - __atomic_load_n(&a->ring->tail, __ATOMIC_ACQUIRE) > a->ring->mask) {
+            sched_yield();  // Plin: pe placa evenimentul s-ar pierde, aici asteptam
+        }
+        task_trace_ring_push(a->ring, s->ev[i].stamp, s->ev[i].word);
+        // Toate evenimentele cu stamp <= progress sunt in ring
+        uint32_t progress = i + 1 < s->count ? s->ev[i + 1].stamp - 1u : (uint32_t) (STAMP_BASE + s_end);
+        __atomic_store_n(a->progress, progress, __ATOMIC_RELEASE);
+    }
+    __atomic_store_n(a->done, true, __ATOMIC_RELEASE);
+    return NULL;
+}
+//---------
+static bool replay_threads(uint32_t* drains) {
+    static task_trace_event_t slots[SIM_CORES][THREAD_RING];
+    task_trace_ring_t         rings[SIM_CORES];
+    volatile uint32_t         progress[SIM_CORES];
+    volatile bool             done[SIM_CORES];
+    pthread_t                 threads[SIM_CORES];
+    producer_arg_t            args[SIM_CORES];
+    agg_reset();
+    for (int core = 0; core < SIM_CORES; core++) {
+        task_trace_ring_init(&rings[core], slots[core], THREAD_RING);
+        progress[core] = s_stream[core].ev[0].stamp - 1u;
+        done[core]     = false;
+        args[core]     = (producer_arg_t) {core, &rings[core], &progress[core], &done[core]};
+        pthread_create(&threads[core], NULL, producer, &args[core]);
+    }
+    uint32_t n = 0;
+    for (;;) {
+        bool     finished  = true;
+        uint32_t watermark = 0;
+        for (int core = 0; core < SIM_CORES; core++) {
+            finished &= __atomic_load_n(&done[core], __ATOMIC_ACQUIRE);
+            uint32_t p = __atomic_load_n(&progress[core], __ATOMIC_ACQUIRE);
+            if (core == 0 || (int32_t) (p - watermark) < 0) {
+                watermark = p;
+            }
+        }
+        task_trace_agg_drain(&s_agg, rings, watermark);
+        n++;
+        sched_yield();
+        if (finished) {
+            break;
+        }
+    }
+    for (int core = 0; core < SIM_CORES; core++) {
+        pthread_join(threads[core], NULL);
+    }
+    task_trace_agg_drain(&s_agg, rings, (uint32_t) (STAMP_BASE + s_end));
+    *drains = n;
+    return true;
+}
+
+/**********************
+ *   4. /sched DOCUMENT (task_trace.h served from s_agg)
+ **********************/
+static bool s_trace_running = true;
+
+bool task_trace_is_running(void) {
+    return s_trace_running;
+}
+//---------
+uint32_t task_trace_snapshot(task_trace_task_t* tasks, uint32_t max, task_trace_summary_t* summary) {
+    if (summary) {
+        summary->now        = s_agg.cores[0].clock;
+        summary->task_count = s_agg.count;
+        summary->core_count = s_agg.core_count;
+        summary->untracked  = s_agg.untracked;
+        memcpy(summary->cores, s_agg.cores, sizeof(summary->cores));
+    }
+    return tasks ? task_trace_agg_copy(&s_agg, tasks, max) : 0;
+}
+//---------
+typedef struct {
+    char   data[OUT_SIZE];
+    size_t len;
+} text_t;
+
+static esp_err_t out_write(void* ctx, const char* data, size_t len) {
+    text_t* t = ctx;
+    if (t->len + len > OUT_SIZE) {
+        return ESP_ERR_NO_MEM;
+    }
+    memcpy(t->data + t->len, data, len);
+    t->len += len;
+    return ESP_OK;
+}
+//---------
+static bool check_sched_document(void) {
+    bool ok = true;
+    task_trace_agg_init(&s_agg, s_table, TABLE_SLOTS, 2, name_fn, NULL);
+    task_trace_agg_set_idle(&s_agg, 0, I0);
+    ev(0, 0, A, TASK_TRACE_EV_IN);
+    ev(1, 5, B, TASK_TRACE_EV_READY);
+    ev(0, 10, A, TASK_TRACE_EV_OUT);
+    ev(0, 10, B, TASK_TRACE_EV_IN);
+    task_trace_agg_advance(&s_agg, 50);
+
+    static text_t         out;
+    SysMonState           view;
+    sysmon_stream_query_t query = {0};
+    sysmon_stream_t       stream;
+    memset(&view, 0, sizeof(view));
+    out.len = 0;
+    sysmon_stream_init(&stream, SYSMON_STREAM_JSON, out_write, &out);
+    sysmon_stream_sched(&stream, &view, &query);
+    ok &= expect(sysmon_stream_finish(&stream) == ESP_OK, "/sched encodes");
+    out.data[out.len] = '\0';
+
+    // Ordinea task-urilor e cea din tabela: documentul asteptat o urmeaza. Core 1 a vazut doar
+    // READY-ul de la 5: ceasul lui porneste acolo, fara switch in timpul e necunoscut
+    static task_trace_task_t copy[TABLE_SLOTS];
+    uint32_t                 n = task_trace_agg_copy(&s_agg, copy, TABLE_SLOTS);
+    static char              expected[OUT_SIZE];
+    size_t                   len = (size_t) snprintf(expected, sizeof(expected),
+        "{\"enabled\":true,\"now\":50,\"untracked\":0,\"cores\":["
+        "{\"elapsedUs\":50,\"busyUs\":50,\"unknownUs\":0,\"switches\":2,\"lost\":0},"
+        "{\"elapsedUs\":45,\"busyUs\":0,\"unknownUs\":45,\"switches\":0,\"lost\":0}],\"tasks\":[");
+    for (uint32_t i = 0; i < n; i++) {
+        const task_trace_task_t* t = &copy[i];
+        len += (size_t) snprintf(expected + len, sizeof(expected) - len,
+            "%s{\"name\":\"%s\",\"handle\":%u,\"generation\":%u,\"core\":%d,\"runUs\":%llu,\"switches\":%u,"
+            "\"preemptions\":%u,\"wakeups\":%u,\"latencySumUs\":%llu,\"latencyMaxUs\":%u}",
+            i ? "," : "", t->name, (unsigned) t->task, (unsigned) t->generation, t->core,
+            (unsigned long long) t->run_us, (unsigned) t->switches, (unsigned) t->preemptions,
+            (unsigned) t->wakeups, (unsigned long long) t->latency_sum_us, (unsigned) t->latency_max_us);
+    }
+    snprintf(expected + len, sizeof(expected) - len, "]}");
+    ok &= expect(strcmp(out.data, expected) == 0, "/sched JSON == expected document (cores, tasks, totals)");
+    if (strcmp(out.data, expected) != 0) {
+        printf("    got:      %s\n    expected: %s\n", out.data, expected);
+    }
+    const task_trace_task_t* b = row_of(B);
+    ok &= expect(b && b->run_us == 40 && b->wakeups == 1 && b->latency_sum_us == 5, "B: 40 us run, woken from core 1 after 5 us");
+
+    s_trace_running = false;
+    out.len         = 0;
+    sysmon_stream_init(&stream, SYSMON_STREAM_JSON, out_write, &out);
+    sysmon_stream_sched(&stream, &view, &query);
+    sysmon_stream_finish(&stream);
+    out.data[out.len] = '\0';
+    ok &= expect(strcmp(out.data, "{\"enabled\":false}") == 0, "trace off: {\"enabled\":false}");
+    s_trace_running = true;
+    return ok;
+}
+
+/**********************
+ *   5. COST
+ **********************/
+static void cost_table(uint64_t agg_ns, uint64_t agg_events) {
+    static task_trace_event_t slots[1024];
+    static task_trace_event_t out[1024];
+    task_trace_ring_t         ring;
+    task_trace_ring_init(&ring, slots, 1024);
+    const uint32_t rounds = 20000;
+    uint64_t       best   = UINT64_MAX;
+    for (int run = 0; run < 5; run++) {
+        uint64_t t0 = now_ns();
+        for (uint32_t r = 0; r < rounds; r++) {
+            for (uint32_t i = 0; i < 512; i++) {
+                task_trace_ring_push(&ring, r * 512u + i, (A + (i & 7u) * 0x100u) | (i & 1u));
+            }
+            task_trace_ring_read(&ring, out, 1024);
+        }
+        uint64_t ns = now_ns() - t0;
+        best        = ns < best ? ns : best;
+    }
+    printf("  %-40s %8.2f ns/event\n", "ring push (hook side, host)", (double) best / (rounds * 512.0));
+    printf("  %-40s %8.2f ns/event  (%llu events)\n", "aggregate (drain, 2-way merge)",
+        (double) agg_ns / (double) agg_events, (unsigned long long) agg_events);
+}
+
+//---------
+int main(int argc, char** argv) {
+    uint32_t steps = 200000;
+    uint32_t seed  = 12345;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--steps") && i + 1 < argc) {
+            steps = (uint32_t) atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--seed") && i + 1 < argc) {
+            seed = (uint32_t) strtoul(argv[++i], NULL, 0);
+        } else {
+            fprintf(stderr, "usage: %s [--steps N] [--seed S]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (steps == 0 || seed == 0) {
+        fprintf(stderr, "--steps and --seed must be >= 1\n");
+        return 2;
+    }
+
+    bool ok = true;
+    printf("scenarios:\n");
+    ok &= check_scenarios();
+
+    simulate(steps, seed);
+    uint32_t events = s_stream[0].count + s_stream[1].count;
+    printf("\nsimulation: %u steps, %u tasks, %.1f s simulated, %u events (core 0: %u, core 1: %u)\n",
+        (unsigned) steps, SIM_TASKS, (double) s_end / 1e6, (unsigned) events, (unsigned) s_stream[0].count,
+        (unsigned) s_stream[1].count);
+    uint64_t agg_ns = 0, agg_events = 0;
+    s_rng           = seed * 7u + 1u;
+    ok &= expect(replay_single(&agg_ns, &agg_events), "single thread: every event fit in the rings");
+    ok &= matches_truth("single thread, random drains and watermarks");
+    ok &= expect(agg_events == events, "single thread: every event aggregated once");
+    uint32_t drains = 0;
+    replay_threads(&drains);
+    ok &= matches_truth("threads, 256-slot rings, watermark = producer progress");
+    ok &= expect(s_agg.events == events, "threads: every event aggregated once");
+    printf("  (%u drains while the producers ran)\n", (unsigned) drains);
+
+    printf("\n/sched:\n");
+    ok &= check_sched_document();
+
+    printf("\ncost:\n");
+    cost_table(agg_ns, agg_events);
+    printf("  %-40s %8.0f events/s per core\n", "simulated load", (double) events / SIM_CORES / ((double) s_end / 1e6));
+
+    for (int core = 0; core < SIM_CORES; core++) {
+        free(s_stream[core].ev);
+    }
+    printf("\n%s\n", ok ? "all checks passed" : "FAILED");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,419 @@
+/*
+ * bench_tasks_top - formatter-ul lui `tasks --watch` (mylibs/one-cli-v005/modules/tasks_cmd/tasks_top.c)
+ *
+ *   1. golden: un scenariu fix de cadre (primul complet, procente schimbate, reordonare, task
+ *      sters, mai multe task-uri decat randuri, cadru identic, iesire) comparat byte cu byte cu
+ *      fisierele din host/golden/tasks_top/ (ESC scris ca \e, cate o linie per pozitionare)
+ *   2. terminal virtual: iesirea fiecarui cadru aplicata peste ecranul anterior == ecranul unui
+ *      redraw complet al aceluiasi cadru, pe --frames cadre aleatoare (task-uri create / sterse,
+ *      load-uri care se schimba)
+ *   3. bytes per cadru: diferente vs redraw complet, cate cadre incap in buffer-ul TX de 256 B
+ *
+ * Usage: bench_tasks_top [--frames N] [--update]
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "tasks_top.h"
+
+#define TERM_LINES (TASKS_TOP_MAX_LINES + 2)
+#define TERM_COLS  (TASKS_TOP_WIDTH + 16)
+#define OUT_SIZE   (64u * 1024u)
+#define TX_BUFFER  (256)  // tx_buffer_size din initialize_console_peripheral()
+#define MAX_TASKS  (48)
+
+/**********************
+ *   HELPERS
+ **********************/
+static uint32_t s_rng = 1;
+
+static uint32_t rnd(uint32_t n) {
+    s_rng ^= s_rng << 13;
+    s_rng ^= s_rng >> 17;
+    s_rng ^= s_rng << 5;
+    return s_rng % n;
+}
+//---------
+static bool expect(bool cond, const char* what) {
+    printf("  %-64s %s\n", what, cond ? "ok" : "FAIL");
+    return cond;
+}
+//---------
+typedef struct {
+    char   data[OUT_SIZE];
+    size_t len;
+    size_t writes;
+    size_t max_write;
+} out_t;
+
+static void out_write(void* ctx, const char* data, size_t len) {
+    out_t* o = ctx;
+    if (o->len + len <= OUT_SIZE) {
+        memcpy(o->data + o->len, data, len);
+        o->len += len;
+    }
+    o->writes++;
+    o->max_write = len > o->max_write ? len : o->max_write;
+}
+
+/**********************
+ *   VIRTUAL TERMINAL
+ **********************/
+typedef struct {
+    char     grid[TERM_LINES][TERM_COLS];
+    uint32_t line;
+    uint32_t col;
+    bool     cursor_visible;
+    bool     bad;  // Secventa necunoscuta sau scris in afara ecranului
+} term_t;
+
+static void term_init(term_t* t) {
+    memset(t->grid, '.', sizeof(t->grid));  // Nu spatii: un ecran nesters se vede la comparatie
+    t->line           = 0;
+    t->col            = 0;
+    t->cursor_visible = true;
+    t->bad            = false;
+}
+//---------
+static void term_feed(term_t* t, const char* data, size_t len) {
+    for (size_t i = 0; i < len; i++) {
+        char c = data[i];
+        if (c == '\x1b') {
+            if (i + 1 >= len || data[i + 1] != '[') {
+                t->bad = true;
+                return;
+            }
+            i += 2;
+            unsigned a = 0, b = 0;
+            bool     second = false, private_mode = false;
+            if (i < len && data[i] == '?') {
+                private_mode = true;
+                i++;
+            }
+            for (; i < len; i++) {
+                if (data[i] >= '0' && data[i] <= '9') {
+                    if (second) {
+                        b = b * 10 + (unsigned) (data[i] - '0');
+                    } else {
+                        a = a * 10 + (unsigned) (data[i] - '0');
+                    }
+                } else if (data[i] == ';') {
+                    second = true;
+                } else {
+                    break;
+                }
+            }
+            char cmd = i < len ? data[i] : 0;
+            if (private_mode && a == 25 && (cmd == 'l' || cmd == 'h')) {
+                t->cursor_visible = cmd == 'h';
+            } else if (!private_mode && cmd == 'J' && a == 2) {
+                memset(t->grid, ' ', sizeof(t->grid));
+            } else if (!private_mode && cmd == 'H') {
+                t->line = (a ? a : 1) - 1;
+                t->col  = (b ? b : 1) - 1;
+            } else {
+                t->bad = true;
+            }
+        } else if (c == '\n') {
+            t->line++;
+            t->col = 0;
+        } else {
+            if (t->line >= TERM_LINES || t->col >= TERM_COLS) {
+                t->bad = true;
+                continue;
+            }
+            t->grid[t->line][t->col++] = c;
+        }
+    }
+}
+//---------
+static bool term_equal(const term_t* a, const term_t* b, uint32_t lines) {
+    for (uint32_t l = 0; l < lines; l++) {
+        if (memcmp(a->grid[l], b->grid[l], TASKS_TOP_WIDTH) != 0) {
+            printf("    line %u:\n      diff: %.*s\n      full: %.*s\n", (unsigned) l, TASKS_TOP_WIDTH, a->grid[l],
+                TASKS_TOP_WIDTH, b->grid[l]);
+            return false;
+        }
+    }
+    return true;
+}
+
+/**********************
+ *   1. GOLDEN
+ **********************/
+static const tasks_top_row_t s_base[] = {
+    {"IDLE0", 0x3FC90010u, 8120, 0, TASKS_TOP_READY, 0, 812},
+    {"IDLE1", 0x3FC90020u, 9650, 1, TASKS_TOP_RUNNING, 0, 808},
+    {"lv_main", 0x3FC90030u, 1540, 1, TASKS_TOP_BLOCKED, 5, 6216},
+    {"wifi", 0x3FC90040u, 210, 0, TASKS_TOP_BLOCKED, 23, 2964},
+    {"sysmon", 0x3FC90050u, 95, TASKS_TOP_CORE_ANY, TASKS_TOP_BLOCKED, 3, 1844},
+    {"console", 0x3FC90060u, 12, TASKS_TOP_CORE_ANY, TASKS_TOP_RUNNING, 2, 3300},
+};
+#define BASE_COUNT (sizeof(s_base) / sizeof(s_base[0]))
+
+/* ESC devine \e si fiecare pozitionare incepe o linie noua: fisierele se pot citi si compara in git */
+static size_t golden_encode(const char* data, size_t len, char* text, size_t size) {
+    size_t n = 0;
+    for (size_t i = 0; i < len && n + 4 < size; i++) {
+        if (data[i] == '\x1b') {
+            if (n && text[n - 1] != '\n' && i + 2 < len && data[i + 2] >= '0' && data[i + 2] <= '9') {
+                text[n++] = '\n';
+            }
+            text[n++] = '\\';
+            text[n++] = 'e';
+        } else if (data[i] == '\n') {
+            text[n++] = '\\';
+            text[n++] = 'n';
+        } else {
+            text[n++] = data[i];
+        }
+    }
+    text[n++] = '\n';
+    text[n]   = '\0';
+    return n;
+}
+//---------
+static bool golden_check(const char* name, const out_t* out, bool update) {
+    static char text[OUT_SIZE * 2];
+    static char file[OUT_SIZE * 2];
+    size_t      len = golden_encode(out->data, out->len, text, sizeof(text));
+    char        path[512];
+    snprintf(path, sizeof(path), "%s/%s.txt", TASKS_TOP_GOLDEN_DIR, name);
+    char what[96];
+    snprintf(what, sizeof(what), "%-22s %5zu bytes == golden", name, out->len);
+    if (update) {
+        FILE* f = fopen(path, "wb");
+        bool  ok = f && fwrite(text, 1, len, f) == len;
+        if (f) {
+            fclose(f);
+        }
+        snprintf(what, sizeof(what), "%-22s %5zu bytes, golden written", name, out->len);
+        return expect(ok, what);
+    }
+    FILE* f = fopen(path, "rb");
+    if (!f) {
+        printf("    %s missing (run with --update)\n", path);
+        return expect(false, what);
+    }
+    size_t flen = fread(file, 1, sizeof(file) - 1, f);
+    fclose(f);
+    file[flen] = '\0';
+    bool ok    = flen == len && memcmp(file, text, len) == 0;
+    if (!ok) {
+        printf("    got:\n%s    expected (%s):\n%s", text, path, file);
+    }
+    return expect(ok, what);
+}
+//---------
+static bool check_golden(bool update) {
+    static out_t        out;
+    static tasks_top_t  top;
+    tasks_top_row_t     rows[MAX_TASKS];
+    tasks_top_summary_t summary = {1000, 3725, 187392, BASE_COUNT, 2, {3450, 1180}};
+    bool                ok      = true;
+
+    // Sortare: load descrescator, apoi nume
+    memcpy(rows, s_base, sizeof(s_base));
+    tasks_top_sort(rows, BASE_COUNT);
+    ok &= expect(strcmp(rows[0].name, "IDLE1") == 0 && strcmp(rows[1].name, "IDLE0") == 0 &&
+                     strcmp(rows[5].name, "console") == 0,
+        "sorted by load, descending");
+    tasks_top_row_t tie[2] = {{"b", 2, 100, 0, 0, 1, 1}, {"a", 1, 100, 0, 0, 1, 1}};
+    tasks_top_sort(tie, 2);
+    ok &= expect(strcmp(tie[0].name, "a") == 0, "equal load: by name");
+
+    tasks_top_init(&top, TASKS_TOP_HEADER + 8, out_write, &out);
+
+    out.len = 0;
+    tasks_top_render(&top, &summary, rows, BASE_COUNT);
+    ok &= golden_check("01_first_frame", &out, update);
+
+    // Doar cateva procente si uptime-ul
+    summary.uptime_s++;
+    summary.core_load[0] = 3512;
+    memcpy(rows, s_base, sizeof(s_base));
+    rows[0].load = 8101;
+    rows[2].load = 1561;
+    tasks_top_sort(rows, BASE_COUNT);
+    out.len = 0;
+    tasks_top_render(&top, &summary, rows, BASE_COUNT);
+    ok &= golden_check("02_loads_changed", &out, update);
+
+    // sysmon urca pe locul 3
+    summary.uptime_s++;
+    rows[4].load = 2000;
+    tasks_top_sort(rows, BASE_COUNT);
+    out.len = 0;
+    tasks_top_render(&top, &summary, rows, BASE_COUNT);
+    ok &= golden_check("03_reordered", &out, update);
+
+    // wifi sters: ultimul rand se goleste
+    summary.uptime_s++;
+    summary.task_count = BASE_COUNT - 1;
+    uint32_t n         = 0;
+    for (uint32_t i = 0; i < BASE_COUNT; i++) {
+        if (strcmp(rows[i].name, "wifi") != 0) {
+            rows[n++] = rows[i];
+        }
+    }
+    out.len = 0;
+    tasks_top_render(&top, &summary, rows, n);
+    ok &= golden_check("04_task_deleted", &out, update);
+
+    // Mai multe task-uri decat randuri: ultimul rand spune cate lipsesc
+    summary.uptime_s++;
+    for (uint32_t i = n; i < 12; i++) {
+        rows[i] = (tasks_top_row_t) {"", 0x3FCA0000u + i * 0x10u, (uint16_t) (12 - i), 0, TASKS_TOP_SUSPENDED, 1, 1024};
+        snprintf(rows[i].name, sizeof(rows[i].name), "worker_%02u", (unsigned) i);
+    }
+    n                  = 12;
+    summary.task_count = (uint16_t) n;
+    tasks_top_sort(rows, n);
+    out.len = 0;
+    tasks_top_render(&top, &summary, rows, n);
+    ok &= golden_check("05_overflow", &out, update);
+
+    // Acelasi cadru: nimic de trimis
+    out.len      = 0;
+    size_t bytes = tasks_top_render(&top, &summary, rows, n);
+    ok &= expect(bytes == 0 && out.len == 0, "identical frame: 0 bytes");
+
+    out.len = 0;
+    tasks_top_finish(&top);
+    ok &= golden_check("06_finish", &out, update);
+    return ok;
+}
+
+/**********************
+ *   2./3. RANDOM FRAMES ON A VIRTUAL TERMINAL
+ **********************/
+static bool check_random(uint32_t frames) {
+    static out_t       diff_out, full_out;
+    static tasks_top_t top, full;
+    static term_t      screen, fresh;
+    tasks_top_row_t    tasks[MAX_TASKS];
+    tasks_top_row_t    rows[MAX_TASKS];
+    uint32_t           count = 14;
+    uint32_t           next  = 0;
+    const uint32_t     lines = TASKS_TOP_HEADER + 20;
+
+    for (uint32_t i = 0; i < count; i++, next++) {
+        tasks[i] = (tasks_top_row_t) {"", 0x3FC80000u + next * 0x20u, (uint16_t) rnd(3000), (int8_t) (rnd(3) - 1),
+            (uint8_t) rnd(4), (uint8_t) rnd(25), 512 + rnd(8000)};
+        snprintf(tasks[i].name, sizeof(tasks[i].name), "task_%u", (unsigned) next);
+    }
+    tasks_top_summary_t summary = {500, 0, 200000, 0, 2, {0, 0}};
+
+    tasks_top_init(&top, lines, out_write, &diff_out);
+    term_init(&screen);
+    uint64_t diff_bytes = 0, full_bytes = 0, first_bytes = 0;
+    uint32_t fit = 0, worst = 0, bad_frames = 0;
+    diff_out.max_write = 0;
+
+    for (uint32_t f = 0; f < frames; f++) {
+        // Load-urile se schimba putin, din cand in cand un task apare sau dispare
+        for (uint32_t i = 0; i < count; i++) {
+            if (rnd(4) == 0) {
+                int32_t load = (int32_t) tasks[i].load + (int32_t) rnd(201) - 100;
+                tasks[i].load = (uint16_t) (load < 0 ? 0 : load > 10000 ? 10000 : load);
+            }
+            if (rnd(20) == 0) {
+                tasks[i].state = (uint8_t) rnd(4);
+            }
+        }
+        if (rnd(10) == 0 && count < MAX_TASKS) {
+            tasks[count] = (tasks_top_row_t) {"", 0x3FC80000u + next * 0x20u, (uint16_t) rnd(500), -1, 2, 3, 2048};
+            snprintf(tasks[count].name, sizeof(tasks[count].name), "task_%u", (unsigned) next++);
+            count++;
+        }
+        if (rnd(10) == 0 && count > 4) {
+            uint32_t gone = rnd(count);
+            tasks[gone] = tasks[--count];
+        }
+        summary.uptime_s++;
+        summary.free_heap  = 200000 - rnd(5000);
+        summary.task_count = (uint16_t) count;
+        summary.core_load[0] = (uint16_t) rnd(10001);
+        summary.core_load[1] = (uint16_t) rnd(10001);
+        memcpy(rows, tasks, count * sizeof(tasks_top_row_t));
+        tasks_top_sort(rows, count);
+
+        diff_out.len = 0;
+        size_t bytes = tasks_top_render(&top, &summary, rows, count);
+        term_feed(&screen, diff_out.data, diff_out.len);
+
+        // Acelasi cadru desenat complet, pe un terminal nou
+        full_out.len = 0;
+        tasks_top_init(&full, lines, out_write, &full_out);
+        tasks_top_render(&full, &summary, rows, count);
+        term_init(&fresh);
+        term_feed(&fresh, full_out.data, full_out.len);
+
+        if (screen.bad || fresh.bad || !term_equal(&screen, &fresh, lines)) {
+            if (bad_frames++ == 0) {
+                printf("    frame %u differs\n", (unsigned) f);
+            }
+        }
+        if (f == 0) {
+            first_bytes = bytes;
+            continue;
+        }
+        diff_bytes += bytes;
+        full_bytes += full_out.len;
+        fit += bytes <= TX_BUFFER;
+        worst = bytes > worst ? (uint32_t) bytes : worst;
+    }
+    diff_out.len = 0;
+    tasks_top_finish(&top);
+    term_feed(&screen, diff_out.data, diff_out.len);
+
+    bool ok = true;
+    char what[96];
+    snprintf(what, sizeof(what), "%u frames: screen after diffs == full redraw, every frame", (unsigned) frames);
+    ok &= expect(bad_frames == 0, what);
+    ok &= expect(!screen.bad && screen.cursor_visible && screen.line == lines + 1 && screen.col == 0,
+        "finish: cursor shown, below the table");
+    ok &= expect(diff_out.max_write <= TASKS_TOP_OUT_CHUNK, "no write larger than TASKS_TOP_OUT_CHUNK");
+
+    uint32_t n = frames > 1 ? frames - 1 : 1;
+    printf("\n  %-34s %10s %12s\n", "bytes per frame", "average", "worst");
+    printf("  %-34s %10.0f %12s\n", "full redraw (clear + every cell)", (double) full_bytes / n, "");
+    printf("  %-34s %10.0f %12u\n", "diff (changed cells only)", (double) diff_bytes / n, (unsigned) worst);
+    printf("  %-34s %10llu\n", "first frame", (unsigned long long) first_bytes);
+    printf("  frames within the %d B TX buffer: %u of %u (%.1f%%), %.1fx fewer bytes\n", TX_BUFFER, (unsigned) fit,
+        (unsigned) n, 100.0 * fit / n, diff_bytes ? (double) full_bytes / (double) diff_bytes : 0.0);
+    return ok;
+}
+
+//---------
+int main(int argc, char** argv) {
+    uint32_t frames = 5000;
+    bool     update = false;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--frames") && i + 1 < argc) {
+            frames = (uint32_t) atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--update")) {
+            update = true;
+        } else {
+            fprintf(stderr, "usage: %s [--frames N] [--update]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (frames == 0) {
+        fprintf(stderr, "--frames must be >= 1\n");
+        return 2;
+    }
+
+    bool ok = true;
+    printf("golden (%s):\n", TASKS_TOP_GOLDEN_DIR);
+    ok &= check_golden(update);
+    printf("\nvirtual terminal:\n");
+    ok &= check_random(frames);
+
+    printf("\n%s\n", ok ? "all checks passed" : "FAILED");
+    return ok ? 0 : 1;
+}
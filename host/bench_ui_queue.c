@@ -0,0 +1,266 @@
+/*
+ * bench_ui_queue - producer latency of UI updates: s_lvgl_mutex vs ui_queue (main/ui_queue.h).
+ *
+ * Un thread LVGL (ca lv_main_task: lv_timer_handler la fiecare LV_DELAY ms) si N producatori
+ * (thread-uri din OSAL-ul pthread al LVGL, ca task-urile sysmon / CLI de pe placa) care
+ * actualizeaza fiecare label-ul si bara lui la fiecare --period-us.
+ *
+ *   mutex: producatorul ia mutex-ul tinut de thread-ul LVGL pe tot lv_timer_handler (render inclus)
+ *   queue: producatorul pune comanda in ui_queue, thread-ul LVGL o aplica inainte de lv_timer_handler
+ *
+ * Latenta = cat sta producatorul in apelul de update. La final fiecare label trebuie sa arate
+ * ultimul text trimis de producatorul lui (coloana "final"); comenzile refuzate (coada plina)
+ * sunt numarate, nu se reincearca.
+ *
+ * Usage: bench_ui_queue [--producers N] [--seconds S] [--period-us US] [--mode mutex|queue|both]
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "lvgl.h"
+#include "lvgl_private.h"
+
+#include "ui_queue.h"
+
+#define LCD_WIDTH     (320)
+#define LCD_HEIGHT    (240)
+#define LV_DELAY      (5)  // Acelasi pas ca lv_main_task din main.cpp
+#define MAX_PRODUCERS (32)
+
+/**********************
+ *   BENCH VARIABLES
+ **********************/
+typedef enum {
+    BENCH_MODE_MUTEX = 0,
+    BENCH_MODE_QUEUE,
+} bench_mode_t;
+
+typedef struct {
+    uint32_t    id;
+    lv_thread_t thread;
+    lv_obj_t*   label;
+    lv_obj_t*   bar;
+    uint64_t*   lat_ns;  // One entry per update call
+    uint32_t    lat_cnt;
+    uint32_t    lat_cap;
+    uint32_t    refused;
+    char        last_text[UI_QUEUE_TEXT_MAX];
+} producer_t;
+
+static bench_mode_t      s_mode;
+static lv_mutex_t        s_lvgl_mutex;  // s_lvgl_mutex din main.cpp
+static ui_queue_t        s_ui_queue;
+static volatile bool     s_running;
+static uint32_t          s_period_us = 5000;
+static producer_t        s_producers[MAX_PRODUCERS];
+static uint8_t           s_draw_buf[LCD_WIDTH * 40 * 2];
+static volatile uint32_t s_frames;
+
+/**********************
+ *   BENCH FUNCTIONS
+ **********************/
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000u + (uint64_t) ts.tv_nsec;
+}
+//---------
+static uint32_t tick_cb(void) {
+    return (uint32_t) (now_ns() / 1000000u);
+}
+//---------
+static void flush_cb(lv_display_t* disp, const lv_area_t* area, uint8_t* px_map) {
+    LV_UNUSED(area);
+    LV_UNUSED(px_map);
+    if (lv_display_flush_is_last(disp)) {
+        s_frames++;
+    }
+    lv_display_flush_ready(disp);
+}
+//---------
+static int cmp_u64(const void* a, const void* b) {
+    uint64_t x = *(const uint64_t*) a;
+    uint64_t y = *(const uint64_t*) b;
+    return (x > y) - (x < y);
+}
+//---------
+static const char* mode_name(bench_mode_t mode) {
+    return mode == BENCH_MODE_MUTEX ? "mutex" : "queue";
+}
+//---------
+static void producer_update(producer_t* p, uint32_t seq) {
+    char text[UI_QUEUE_TEXT_MAX];
+    snprintf(text, sizeof(text), "P%02u seq %u", (unsigned) p->id, (unsigned) seq);
+    if (s_mode == BENCH_MODE_MUTEX) {
+        lv_mutex_lock(&s_lvgl_mutex);
+        lv_label_set_text(p->label, text);
+        lv_bar_set_value(p->bar, (int32_t) (seq % 100), LV_ANIM_OFF);
+        lv_mutex_unlock(&s_lvgl_mutex);
+        memcpy(p->last_text, text, sizeof(text));
+        return;
+    }
+    if (ui_queue_set_text(&s_ui_queue, p->label, text)) {
+        memcpy(p->last_text, text, sizeof(text));
+    } else {
+        p->refused++;
+    }
+    if (!ui_queue_set_value(&s_ui_queue, p->bar, (int32_t) (seq % 100))) {
+        p->refused++;
+    }
+}
+//---------
+static void producer_thread(void* arg) {
+    producer_t* p   = (producer_t*) arg;
+    uint32_t    seq = 0;
+    while (s_running && p->lat_cnt < p->lat_cap) {
+        uint64_t t0 = now_ns();
+        producer_update(p, seq++);
+        p->lat_ns[p->lat_cnt++] = now_ns() - t0;
+        usleep(s_period_us);
+    }
+}
+//---------
+static lv_display_t* bench_display_create(void) {
+    lv_display_t* disp = lv_display_create(LCD_WIDTH, LCD_HEIGHT);
+    lv_display_set_color_format(disp, LV_COLOR_FORMAT_RGB565);
+    lv_display_set_buffers(disp, s_draw_buf, NULL, sizeof(s_draw_buf), LV_DISPLAY_RENDER_MODE_PARTIAL);
+    lv_display_set_flush_cb(disp, flush_cb);
+    return disp;
+}
+//---------
+static void bench_ui_create(uint32_t producers) {
+    lv_obj_t* scr = lv_screen_active();
+    lv_obj_clean(scr);
+    lv_obj_set_flex_flow(scr, LV_FLEX_FLOW_COLUMN_WRAP);
+    for (uint32_t i = 0; i < producers; i++) {
+        producer_t* p = &s_producers[i];
+        p->label      = lv_label_create(scr);
+        p->bar        = lv_bar_create(scr);
+        lv_label_set_text(p->label, "-");
+        lv_obj_set_size(p->bar, 120, 8);
+    }
+}
+//---------
+static bool bench_run(bench_mode_t mode, uint32_t producers, uint32_t seconds) {
+    s_mode   = mode;
+    s_frames = 0;
+    ui_queue_init(&s_ui_queue, NULL, NULL);
+    lv_mutex_lock(&s_lvgl_mutex);
+    bench_ui_create(producers);
+    lv_refr_now(NULL);
+    lv_mutex_unlock(&s_lvgl_mutex);
+    s_frames = 0;
+
+    uint32_t cap = (uint32_t) ((uint64_t) seconds * 1000000u / (s_period_us ? s_period_us : 1)) + 16;
+    s_running    = true;
+    for (uint32_t i = 0; i < producers; i++) {
+        producer_t* p = &s_producers[i];
+        p->id         = i;
+        p->lat_cnt    = 0;
+        p->lat_cap    = cap;
+        p->refused    = 0;
+        p->lat_ns     = (uint64_t*) malloc(sizeof(uint64_t) * cap);
+        strcpy(p->last_text, "-");
+        lv_thread_init(&p->thread, "producer", LV_THREAD_PRIO_MID, producer_thread, 64 * 1024, p);
+    }
+
+    // Thread-ul LVGL: ca lv_main_task, cu mutex-ul tinut pe tot lv_timer_handler
+    uint64_t end = now_ns() + (uint64_t) seconds * 1000000000u;
+    while (now_ns() < end) {
+        lv_mutex_lock(&s_lvgl_mutex);
+        if (mode == BENCH_MODE_QUEUE) {
+            ui_queue_drain(&s_ui_queue);
+        }
+        lv_timer_handler();
+        lv_mutex_unlock(&s_lvgl_mutex);
+        usleep(LV_DELAY * 1000);
+    }
+    s_running = false;
+    for (uint32_t i = 0; i < producers; i++) {
+        lv_thread_delete(&s_producers[i].thread);
+    }
+    lv_mutex_lock(&s_lvgl_mutex);
+    if (mode == BENCH_MODE_QUEUE) {
+        ui_queue_drain(&s_ui_queue);
+    }
+    lv_timer_handler();
+    lv_mutex_unlock(&s_lvgl_mutex);
+
+    // Latente + verificarea textului final
+    uint64_t total = 0;
+    uint32_t refused = 0;
+    bool     final_ok = true;
+    for (uint32_t i = 0; i < producers; i++) {
+        total += s_producers[i].lat_cnt;
+        refused += s_producers[i].refused;
+        if (strcmp(lv_label_get_text(s_producers[i].label), s_producers[i].last_text) != 0) {
+            final_ok = false;
+        }
+    }
+    uint64_t* all = (uint64_t*) malloc(sizeof(uint64_t) * (total ? total : 1));
+    uint64_t  n   = 0;
+    for (uint32_t i = 0; i < producers; i++) {
+        memcpy(&all[n], s_producers[i].lat_ns, sizeof(uint64_t) * s_producers[i].lat_cnt);
+        n += s_producers[i].lat_cnt;
+        free(s_producers[i].lat_ns);
+    }
+    qsort(all, n, sizeof(uint64_t), cmp_u64);
+#define PCT(p) (n ? (double) all[(uint64_t) ((n - 1) * (p))] / 1000.0 : 0.0)
+    printf("%-6s %9llu %9.2f %9.2f %9.2f %10.2f %10.2f %7u %8u %7u %9u  %s\n", mode_name(mode),
+        (unsigned long long) n, PCT(0.50), PCT(0.90), PCT(0.99), PCT(0.999), n ? (double) all[n - 1] / 1000.0 : 0.0,
+        (unsigned) s_frames, (unsigned) (mode == BENCH_MODE_QUEUE ? s_ui_queue.stats.applied : 0),
+        (unsigned) (mode == BENCH_MODE_QUEUE ? s_ui_queue.stats.coalesced : 0), (unsigned) refused,
+        final_ok ? "ok" : "WRONG");
+#undef PCT
+    free(all);
+    return final_ok;
+}
+//---------
+int main(int argc, char** argv) {
+    uint32_t producers = 8;
+    uint32_t seconds   = 3;
+    int      modes     = 3;  // bit 0 mutex, bit 1 queue
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--producers") && i + 1 < argc) {
+            producers = (uint32_t) atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--seconds") && i + 1 < argc) {
+            seconds = (uint32_t) atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--period-us") && i + 1 < argc) {
+            s_period_us = (uint32_t) atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--mode") && i + 1 < argc) {
+            i++;
+            modes = !strcmp(argv[i], "mutex") ? 1 : !strcmp(argv[i], "queue") ? 2 : 3;
+        } else {
+            fprintf(stderr, "usage: %s [--producers N] [--seconds S] [--period-us US] [--mode mutex|queue|both]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (producers == 0 || producers > MAX_PRODUCERS) {
+        fprintf(stderr, "--producers must be 1..%d\n", MAX_PRODUCERS);
+        return 2;
+    }
+
+    lv_init();
+    lv_tick_set_cb(tick_cb);
+    lv_mutex_init(&s_lvgl_mutex);
+    bench_display_create();
+
+    printf("%u producers, one update (text + bar) every %u us each, %u s per mode, ring of %d slots\n\n",
+        (unsigned) producers, (unsigned) s_period_us, (unsigned) seconds, UI_QUEUE_DEPTH);
+    printf("%-6s %9s %9s %9s %9s %10s %10s %7s %8s %7s %9s  %s\n", "MODE", "UPDATES", "P50[us]", "P90[us]", "P99[us]",
+        "P99.9[us]", "MAX[us]", "FRAMES", "APPLIED", "COALESC", "REFUSED", "final");
+    bool ok = true;
+    if (modes & 1) {
+        ok &= bench_run(BENCH_MODE_MUTEX, producers, seconds);
+    }
+    if (modes & 2) {
+        ok &= bench_run(BENCH_MODE_QUEUE, producers, seconds);
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,136 @@
+#include "lv_blend_x86.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "lv_blend_x86_kernels.h"
+
+#define LV_BLEND_X86_UNSET (-1)
+
+// Citit din 2 draw unit-uri (LV_DRAW_SW_DRAW_UNIT_CNT), initializarea lenesa e idempotenta
+static int s_level = LV_BLEND_X86_UNSET;
+
+//---------
+lv_blend_x86_level_t lv_blend_x86_detect(void) {
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return LV_BLEND_X86_AVX2;
+    }
+    if (__builtin_cpu_supports("sse2")) {
+        return LV_BLEND_X86_SSE2;
+    }
+    return LV_BLEND_X86_C;
+}
+//---------
+lv_blend_x86_level_t lv_blend_x86_set_level(lv_blend_x86_level_t level) {
+    lv_blend_x86_level_t best = lv_blend_x86_detect();
+    if (level > best) {
+        level = best;
+    }
+    __atomic_store_n(&s_level, (int) level, __ATOMIC_RELEASE);
+    return level;
+}
+//---------
+lv_blend_x86_level_t lv_blend_x86_get_level(void) {
+    int level = __atomic_load_n(&s_level, __ATOMIC_ACQUIRE);
+    if (level != LV_BLEND_X86_UNSET) {
+        return (lv_blend_x86_level_t) level;
+    }
+    lv_blend_x86_level_t wanted = LV_BLEND_X86_AVX2;
+    const char*          env    = getenv("LV_BLEND_X86");
+    if (env) {
+        if (strcmp(env, "c") == 0) {
+            wanted = LV_BLEND_X86_C;
+        } else if (strcmp(env, "sse2") == 0) {
+            wanted = LV_BLEND_X86_SSE2;
+        }
+    }
+    return lv_blend_x86_set_level(wanted);
+}
+//---------
+const char* lv_blend_x86_level_name(lv_blend_x86_level_t level) {
+    switch (level) {
+        case LV_BLEND_X86_SSE2:
+            return "sse2";
+        case LV_BLEND_X86_AVX2:
+            return "avx2";
+        default:
+            return "c";
+    }
+}
+//---------
+static const lv_blend_x86_kernels_t* lv_blend_x86_kernels(void) {
+    switch (lv_blend_x86_get_level()) {
+        case LV_BLEND_X86_SSE2:
+            return &lv_blend_x86_kernels_sse2;
+        case LV_BLEND_X86_AVX2:
+            return &lv_blend_x86_kernels_avx2;
+        default:
+            return NULL;
+    }
+}
+//---------
+static void lv_blend_x86_image_args(const lv_draw_sw_blend_image_dsc_t* dsc, lv_blend_x86_args_t* args) {
+    args->dst         = dsc->dest_buf;
+    args->dst_stride  = dsc->dest_stride;
+    args->src         = dsc->src_buf;
+    args->src_stride  = dsc->src_stride;
+    args->mask        = dsc->mask_buf;
+    args->mask_stride = dsc->mask_stride;
+    args->w           = dsc->dest_w;
+    args->h           = dsc->dest_h;
+    args->color       = 0;
+    args->opa         = dsc->opa >= LV_OPA_MAX ? 255 : dsc->opa;
+}
+//---------
+lv_result_t lv_blend_x86_color_to_rgb565(lv_draw_sw_blend_fill_dsc_t* dsc) {
+    const lv_blend_x86_kernels_t* k = lv_blend_x86_kernels();
+    if (!k || (!dsc->mask_buf && dsc->opa >= LV_OPA_MAX)) {
+        return LV_RESULT_INVALID;  // Umplerea simpla din LVGL e deja la viteza memoriei
+    }
+    lv_blend_x86_args_t args = {
+        .dst         = dsc->dest_buf,
+        .dst_stride  = dsc->dest_stride,
+        .mask        = dsc->mask_buf,
+        .mask_stride = dsc->mask_stride,
+        .w           = dsc->dest_w,
+        .h           = dsc->dest_h,
+        .color       = lv_color_to_u16(dsc->color),
+        .opa         = dsc->opa >= LV_OPA_MAX ? 255 : dsc->opa,
+    };
+    k->fill_mix(&args);
+    return LV_RESULT_OK;
+}
+//---------
+lv_result_t lv_blend_x86_rgb565_to_rgb565(lv_draw_sw_blend_image_dsc_t* dsc) {
+    const lv_blend_x86_kernels_t* k = lv_blend_x86_kernels();
+    if (!k) {
+        return LV_RESULT_INVALID;
+    }
+    lv_blend_x86_args_t args;
+    lv_blend_x86_image_args(dsc, &args);
+    k->rgb565(&args);
+    return LV_RESULT_OK;
+}
+//---------
+lv_result_t lv_blend_x86_rgb888_to_rgb565(lv_draw_sw_blend_image_dsc_t* dsc, uint32_t src_px_size) {
+    const lv_blend_x86_kernels_t* k = lv_blend_x86_kernels();
+    if (!k || (src_px_size != 3 && src_px_size != 4)) {
+        return LV_RESULT_INVALID;
+    }
+    lv_blend_x86_args_t args;
+    lv_blend_x86_image_args(dsc, &args);
+    k->rgb888(&args, src_px_size);
+    return LV_RESULT_OK;
+}
+//---------
+lv_result_t lv_blend_x86_argb8888_to_rgb565(lv_draw_sw_blend_image_dsc_t* dsc) {
+    const lv_blend_x86_kernels_t* k = lv_blend_x86_kernels();
+    if (!k) {
+        return LV_RESULT_INVALID;
+    }
+    lv_blend_x86_args_t args;
+    lv_blend_x86_image_args(dsc, &args);
+    k->argb8888(&args);
+    return LV_RESULT_OK;
+}
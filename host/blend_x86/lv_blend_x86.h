@@ -0,0 +1,74 @@
+#pragma once
+#ifndef LV_BLEND_X86_H
+#define LV_BLEND_X86_H
+
+/*
+ * LV_DRAW_SW_ASM_CUSTOM_INCLUDE pentru build-ul de host (lv_conf_host.h, optiunea
+ * CMake HOST_BLEND_X86): blend-urile SW de la LVGL spre RGB565 trec prin kernelurile
+ * SSE2 / AVX2 din host/blend_x86, alese la runtime dupa CPU.
+ *
+ * Acoperite: fill cu o culoare cu opa / masca si imaginile RGB565 / RGB888 / XRGB8888 /
+ * ARGB8888 in mod NORMAL. Umplerea simpla si copierea RGB565 fara opa / masca raman
+ * in LVGL (lv_memcpy / bucla pe 32 biti, deja limitate de memorie).
+ * Cand hook-ul intoarce LV_RESULT_INVALID (nivel C sau alt caz) ruleaza bucla C din LVGL.
+ *
+ * Nivelul se poate forta cu LV_BLEND_X86=c|sse2|avx2 in environment
+ * sau cu lv_blend_x86_set_level() (host/bench_blend.c compara nivelurile intre ele).
+ */
+
+#include "src/draw/sw/blend/lv_draw_sw_blend_private.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* #ifdef __cplusplus */
+
+typedef enum {
+    LV_BLEND_X86_C = 0,  // LVGL's own C loops
+    LV_BLEND_X86_SSE2,
+    LV_BLEND_X86_AVX2,
+} lv_blend_x86_level_t;
+
+/* Best level this CPU supports */
+lv_blend_x86_level_t lv_blend_x86_detect(void);
+
+/**
+ * @brief Select the kernels used by the blend hooks
+ * @return The level actually applied (clamped to lv_blend_x86_detect())
+ */
+lv_blend_x86_level_t lv_blend_x86_set_level(lv_blend_x86_level_t level);
+
+lv_blend_x86_level_t lv_blend_x86_get_level(void);
+const char*          lv_blend_x86_level_name(lv_blend_x86_level_t level);
+
+lv_result_t lv_blend_x86_color_to_rgb565(lv_draw_sw_blend_fill_dsc_t* dsc);
+lv_result_t lv_blend_x86_rgb565_to_rgb565(lv_draw_sw_blend_image_dsc_t* dsc);
+lv_result_t lv_blend_x86_rgb888_to_rgb565(lv_draw_sw_blend_image_dsc_t* dsc, uint32_t src_px_size);
+lv_result_t lv_blend_x86_argb8888_to_rgb565(lv_draw_sw_blend_image_dsc_t* dsc);
+
+/**********************
+ *   LVGL HOOKS
+ **********************/
+// Fiecare functie reface din dsc aceeasi alegere (opa / masca) ca LVGL, deci toate variantele merg in ea
+#define LV_DRAW_SW_COLOR_BLEND_TO_RGB565_WITH_OPA(dsc)                         lv_blend_x86_color_to_rgb565(dsc)
+#define LV_DRAW_SW_COLOR_BLEND_TO_RGB565_WITH_MASK(dsc)                        lv_blend_x86_color_to_rgb565(dsc)
+#define LV_DRAW_SW_COLOR_BLEND_TO_RGB565_MIX_MASK_OPA(dsc)                     lv_blend_x86_color_to_rgb565(dsc)
+
+#define LV_DRAW_SW_RGB565_BLEND_NORMAL_TO_RGB565_WITH_OPA(dsc)                 lv_blend_x86_rgb565_to_rgb565(dsc)
+#define LV_DRAW_SW_RGB565_BLEND_NORMAL_TO_RGB565_WITH_MASK(dsc)                lv_blend_x86_rgb565_to_rgb565(dsc)
+#define LV_DRAW_SW_RGB565_BLEND_NORMAL_TO_RGB565_MIX_MASK_OPA(dsc)             lv_blend_x86_rgb565_to_rgb565(dsc)
+
+#define LV_DRAW_SW_RGB888_BLEND_NORMAL_TO_RGB565(dsc, src_px_size)             lv_blend_x86_rgb888_to_rgb565(dsc, src_px_size)
+#define LV_DRAW_SW_RGB888_BLEND_NORMAL_TO_RGB565_WITH_OPA(dsc, src_px_size)    lv_blend_x86_rgb888_to_rgb565(dsc, src_px_size)
+#define LV_DRAW_SW_RGB888_BLEND_NORMAL_TO_RGB565_WITH_MASK(dsc, src_px_size)   lv_blend_x86_rgb888_to_rgb565(dsc, src_px_size)
+#define LV_DRAW_SW_RGB888_BLEND_NORMAL_TO_RGB565_MIX_MASK_OPA(dsc, src_px_size) lv_blend_x86_rgb888_to_rgb565(dsc, src_px_size)
+
+#define LV_DRAW_SW_ARGB8888_BLEND_NORMAL_TO_RGB565(dsc)                        lv_blend_x86_argb8888_to_rgb565(dsc)
+#define LV_DRAW_SW_ARGB8888_BLEND_NORMAL_TO_RGB565_WITH_OPA(dsc)               lv_blend_x86_argb8888_to_rgb565(dsc)
+#define LV_DRAW_SW_ARGB8888_BLEND_NORMAL_TO_RGB565_WITH_MASK(dsc)              lv_blend_x86_argb8888_to_rgb565(dsc)
+#define LV_DRAW_SW_ARGB8888_BLEND_NORMAL_TO_RGB565_MIX_MASK_OPA(dsc)           lv_blend_x86_argb8888_to_rgb565(dsc)
+
+#ifdef __cplusplus
+}
+#endif /* #ifdef __cplusplus */
+
+#endif /* #ifndef LV_BLEND_X86_H */
@@ -0,0 +1,56 @@
+/*
+ * Kernelurile de blend pe AVX2 (8 pixeli per vector). Fisierul e compilat cu -mavx2
+ * (host/CMakeLists.txt) si e apelat doar dupa __builtin_cpu_supports("avx2"),
+ * de aceea nu include nimic din LVGL (vezi lv_blend_x86_kernels.h).
+ */
+#include <immintrin.h>
+#include <stdint.h>
+#include <string.h>
+
+#define VN             (8)
+#define RGB888_TAIL_PX (2)  // v_load_rgb888 citeste 28 bytes pentru 24
+typedef __m256i vec_t;
+
+#define v_zero()        _mm256_setzero_si256()
+#define v_set1(x)       _mm256_set1_epi32((int) (x))
+#define v_and(a, b)     _mm256_and_si256((a), (b))
+#define v_or(a, b)      _mm256_or_si256((a), (b))
+#define v_andnot(m, b)  _mm256_andnot_si256((m), (b))
+#define v_add(a, b)     _mm256_add_epi32((a), (b))
+#define v_sub(a, b)     _mm256_sub_epi32((a), (b))
+#define v_cmpeq(a, b)   _mm256_cmpeq_epi32((a), (b))
+#define v_srli(v, n)    _mm256_srli_epi32((v), (n))
+#define v_slli(v, n)    _mm256_slli_epi32((v), (n))
+#define v_mul16(a, b)   _mm256_mullo_epi16((a), (b))
+#define v_mul32(a, b)   _mm256_mullo_epi32((a), (b))
+
+//---------
+static inline __m256i v_load_u16(const uint16_t* p) {
+    return _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*) p));
+}
+//---------
+static inline void v_store_u16(uint16_t* p, __m256i v) {
+    // packus lucreaza pe jumatati de 128 biti: aducem qword-urile 0 si 2 in jumatatea de jos
+    __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi32(v, v), _MM_SHUFFLE(3, 1, 2, 0));
+    _mm_storeu_si128((__m128i*) p, _mm256_castsi256_si128(packed));
+}
+//---------
+static inline __m256i v_load_u8(const uint8_t* p) {
+    return _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*) p));
+}
+//---------
+static inline __m256i v_load_u32(const uint8_t* p) {
+    return _mm256_loadu_si256((const __m256i*) p);
+}
+//---------
+static inline __m256i v_load_rgb888(const uint8_t* p) {
+    // Cate 4 pixeli in fiecare jumatate de 128 biti, apoi pshufb in interiorul jumatatii
+    const __m256i shuf = _mm256_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1,  //
+        0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+    __m256i raw = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128((const __m128i*) p)),
+        _mm_loadu_si128((const __m128i*) (p + 12)), 1);
+    return _mm256_shuffle_epi8(raw, shuf);
+}
+
+#define LV_BLEND_X86_TABLE lv_blend_x86_kernels_avx2
+#include "lv_blend_x86_kernels.inc"
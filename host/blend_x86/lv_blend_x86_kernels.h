@@ -0,0 +1,47 @@
+#pragma once
+#ifndef LV_BLEND_X86_KERNELS_H
+#define LV_BLEND_X86_KERNELS_H
+
+/*
+ * Kernelurile SSE2 / AVX2 pentru destinatie RGB565, fara niciun header LVGL:
+ * lv_blend_x86_avx2.c e compilat cu -mavx2 si nu trebuie sa emita copii AVX2
+ * ale functiilor inline din LVGL (le-ar putea alege linker-ul si pentru codul comun).
+ *
+ * Toate produc exact pixelii din lv_draw_sw_blend_to_rgb565.c
+ * (lv_color_16_16_mix / lv_color_24_16_mix, LV_OPA_MIX2 / LV_OPA_MIX3).
+ */
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* #ifdef __cplusplus */
+
+typedef struct {
+    void*          dst;          // RGB565
+    int32_t        dst_stride;   // Bytes
+    const void*    src;          // NULL for color fills
+    int32_t        src_stride;   // Bytes
+    const uint8_t* mask;         // NULL = no mask
+    int32_t        mask_stride;  // Bytes
+    int32_t        w;
+    int32_t        h;
+    uint16_t       color;        // Fill color
+    uint8_t        opa;          // 255 = no global opacity (LVGL's opa >= LV_OPA_MAX)
+} lv_blend_x86_args_t;
+
+typedef struct {
+    void (*fill_mix)(const lv_blend_x86_args_t* args);                      // Color with opa and / or mask
+    void (*rgb565)(const lv_blend_x86_args_t* args);                        // RGB565 with opa and / or mask
+    void (*rgb888)(const lv_blend_x86_args_t* args, uint32_t src_px_size);  // RGB888 (3) / XRGB8888 (4), all variants
+    void (*argb8888)(const lv_blend_x86_args_t* args);                      // ARGB8888, all variants
+} lv_blend_x86_kernels_t;
+
+extern const lv_blend_x86_kernels_t lv_blend_x86_kernels_sse2;
+extern const lv_blend_x86_kernels_t lv_blend_x86_kernels_avx2;
+
+#ifdef __cplusplus
+}
+#endif /* #ifdef __cplusplus */
+
+#endif /* #ifndef LV_BLEND_X86_KERNELS_H */
@@ -0,0 +1,63 @@
+/*
+ * Kernelurile de blend pe SSE2 (4 pixeli per vector). SSE2 e garantat pe x86-64,
+ * deci fisierul e compilat fara flag-uri extra.
+ */
+#include <emmintrin.h>
+#include <stdint.h>
+#include <string.h>
+
+#define VN             (4)
+#define RGB888_TAIL_PX (2)  // v_load_rgb888 citeste 16 bytes pentru 12
+typedef __m128i vec_t;
+
+#define v_zero()        _mm_setzero_si128()
+#define v_set1(x)       _mm_set1_epi32((int) (x))
+#define v_and(a, b)     _mm_and_si128((a), (b))
+#define v_or(a, b)      _mm_or_si128((a), (b))
+#define v_andnot(m, b)  _mm_andnot_si128((m), (b))
+#define v_add(a, b)     _mm_add_epi32((a), (b))
+#define v_sub(a, b)     _mm_sub_epi32((a), (b))
+#define v_cmpeq(a, b)   _mm_cmpeq_epi32((a), (b))
+#define v_srli(v, n)    _mm_srli_epi32((v), (n))
+#define v_slli(v, n)    _mm_slli_epi32((v), (n))
+#define v_mul16(a, b)   _mm_mullo_epi16((a), (b))
+
+//---------
+/* SSE2 nu are pmulld: lane-urile pare si impare prin pmuludq, pastram cei 32 de biti de jos */
+static inline __m128i v_mul32(__m128i a, __m128i b) {
+    __m128i even = _mm_mul_epu32(a, b);
+    __m128i odd  = _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+    return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)), _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+}
+//---------
+static inline __m128i v_load_u16(const uint16_t* p) {
+    return _mm_unpacklo_epi16(_mm_loadl_epi64((const __m128i*) p), _mm_setzero_si128());
+}
+//---------
+static inline void v_store_u16(uint16_t* p, __m128i v) {
+    // Fara packus_epi32 (SSE4.1): extindem semnul din 16 biti ca packs sa nu satureze
+    v = _mm_srai_epi32(_mm_slli_epi32(v, 16), 16);
+    _mm_storel_epi64((__m128i*) p, _mm_packs_epi32(v, v));
+}
+//---------
+static inline __m128i v_load_u8(const uint8_t* p) {
+    int32_t m;
+    memcpy(&m, p, sizeof(m));
+    __m128i zero = _mm_setzero_si128();
+    return _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(m), zero), zero);
+}
+//---------
+static inline __m128i v_load_u32(const uint8_t* p) {
+    return _mm_loadu_si128((const __m128i*) p);
+}
+//---------
+static inline __m128i v_load_rgb888(const uint8_t* p) {
+    // Fara pshufb (SSSE3): pixelul i e dword-ul 0 din vectorul decalat cu 3 * i bytes
+    __m128i raw = _mm_loadu_si128((const __m128i*) p);
+    __m128i p01 = _mm_unpacklo_epi32(raw, _mm_srli_si128(raw, 3));
+    __m128i p23 = _mm_unpacklo_epi32(_mm_srli_si128(raw, 6), _mm_srli_si128(raw, 9));
+    return _mm_unpacklo_epi64(p01, p23);
+}
+
+#define LV_BLEND_X86_TABLE lv_blend_x86_kernels_sse2
+#include "lv_blend_x86_kernels.inc"
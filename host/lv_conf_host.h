@@ -0,0 +1,40 @@
+/**
+ * @file lv_conf_host.h
+ * @brief
+ * LVGL configuration for the Linux host build (host/).
+ * Foloseste exact main/lv_conf.h si suprascrie doar ce nu exista pe PC
+ * (FreeRTOS, FATFS, pool-ul de memorie din SPIRAM).
+ */
+
+/* clang-format off */
+#ifndef LV_CONF_HOST_H
+#define LV_CONF_HOST_H
+
+#include "../main/lv_conf.h"
+
+/* FreeRTOS -> pthread, pastram cele 2 draw unit-uri ca pe placa */
+#undef  LV_USE_OS
+#define LV_USE_OS   LV_OS_PTHREAD
+
+/* Nu avem ff.h pe host */
+#undef  LV_USE_FS_FATFS
+#define LV_USE_FS_FATFS 0
+#undef  LV_FS_FATFS_LETTER
+#define LV_FS_FATFS_LETTER '\0'
+
+/* Pool-ul LVGL e alocat static pe host (fara heap_caps_malloc) */
+#undef  LV_MEM_POOL_INCLUDE
+#undef  LV_MEM_POOL_ALLOC
+
+/* Blend-urile spre RGB565 pe SSE2 / AVX2 (host/blend_x86, optiunea CMake HOST_BLEND_X86).
+ * lv_blend_esp.h din main/lv_conf.h e doar pentru placa: pe host il verifica bench_blend_esp. */
+#undef  LV_USE_DRAW_SW_ASM
+#undef  LV_DRAW_SW_ASM_CUSTOM_INCLUDE
+#if defined(LV_HOST_BLEND_X86) && LV_HOST_BLEND_X86
+    #define LV_USE_DRAW_SW_ASM  LV_DRAW_SW_ASM_CUSTOM
+    #define LV_DRAW_SW_ASM_CUSTOM_INCLUDE "lv_blend_x86.h"
+#else
+    #define LV_USE_DRAW_SW_ASM  LV_DRAW_SW_ASM_NONE
+#endif
+
+#endif /*LV_CONF_HOST_H*/
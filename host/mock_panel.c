@@ -0,0 +1,294 @@
+#include "mock_panel.h"
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define MOCK_PANEL_DEFAULT_QUEUE_DEPTH (10)
+
+typedef struct {
+    int            cmd;
+    const uint8_t* data;
+    size_t         len;
+    uint64_t       queued_ns;
+} mock_panel_trans_t;
+
+struct mock_panel_t {
+    mock_panel_config_t        config;
+    mock_panel_stats_t         stats;
+    mock_panel_trans_done_cb_t trans_done_cb;
+    void*                      trans_done_ctx;
+    uint8_t*                   gram;
+    size_t                     gram_size;
+    uint32_t                   bytes_per_pixel;
+
+    // Fereastra curenta (exclusive end) si pozitia in ea, in pixeli
+    int    win_x1, win_y1, win_x2, win_y2;
+    size_t win_cursor;
+
+    // Magistrala simulata (doar cu bus_bytes_per_sec != 0)
+    pthread_t           bus_thread;
+    pthread_mutex_t     lock;
+    pthread_cond_t      not_empty;
+    pthread_cond_t      not_full;
+    pthread_cond_t      idle;
+    mock_panel_trans_t* queue;
+    uint32_t            q_head;
+    uint32_t            q_count;
+    bool                bus_active;  // A transfer was popped and is still on the bus
+    bool                stop;
+    uint64_t            bus_free_ns;  // When the last transfer left the bus
+};
+
+//---------
+static uint64_t mock_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000u + (uint64_t) ts.tv_nsec;
+}
+//---------
+static void mock_sleep_until_ns(uint64_t deadline_ns) {
+    struct timespec ts = {.tv_sec = (time_t) (deadline_ns / 1000000000u), .tv_nsec = (long) (deadline_ns % 1000000000u)};
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) != 0) {
+    }
+}
+//---------
+/* Write len bytes at the window cursor, the same way the controller fills GRAM */
+static void mock_panel_write_gram(mock_panel_t* panel, int cmd, const uint8_t* src, size_t len) {
+    const uint32_t bpp    = panel->bytes_per_pixel;
+    const size_t   win_w  = (size_t) (panel->win_x2 - panel->win_x1);
+    const size_t   win_px = win_w * (size_t) (panel->win_y2 - panel->win_y1);
+    size_t         pixels = len / bpp;
+    if (cmd == MOCK_PANEL_CMD_RAMWR) {
+        panel->win_cursor = 0;
+    }
+    while (pixels > 0 && win_w > 0) {
+        if (panel->win_cursor >= win_px) {
+            panel->win_cursor = 0;  // ST7789 reia de la inceputul ferestrei
+        }
+        size_t col   = panel->win_cursor % win_w;
+        size_t row   = panel->win_cursor / win_w;
+        size_t chunk = win_w - col;
+        if (chunk > pixels) {
+            chunk = pixels;
+        }
+        uint8_t* dst = panel->gram + (((size_t) panel->win_y1 + row) * panel->config.h_res + panel->win_x1 + col) * bpp;
+        if (panel->config.swap_color_bytes && bpp == 2) {
+            // Asta e costul per pixel pe care il face i80 cand swap_color_bytes = 1
+            for (size_t i = 0; i < chunk * 2; i += 2) {
+                dst[i]     = src[i + 1];
+                dst[i + 1] = src[i];
+            }
+        } else {
+            memcpy(dst, src, chunk * bpp);
+        }
+        src += chunk * bpp;
+        pixels -= chunk;
+        panel->win_cursor += chunk;
+    }
+
+    panel->stats.flush_count++;
+    panel->stats.flushed_bytes += len;
+    panel->stats.flushed_pixels += len / bpp;
+    if (len > panel->stats.max_flush_bytes) {
+        panel->stats.max_flush_bytes = (uint32_t) len;
+    }
+}
+//---------
+static void* mock_panel_bus_task(void* arg) {
+    mock_panel_t* panel = (mock_panel_t*) arg;
+    pthread_mutex_lock(&panel->lock);
+    for (;;) {
+        while (panel->q_count == 0 && !panel->stop) {
+            pthread_cond_wait(&panel->not_empty, &panel->lock);
+        }
+        if (panel->q_count == 0 && panel->stop) {
+            break;
+        }
+        mock_panel_trans_t trans = panel->queue[panel->q_head];
+        panel->bus_active        = true;
+        pthread_mutex_unlock(&panel->lock);
+
+        // Un transfer deja in coada pleaca imediat dupa cel dinainte (fara latenta thread-ului),
+        // altfel porneste cand a fost pus in coada
+        uint64_t start = trans.queued_ns;
+        if (panel->bus_free_ns > start) {
+            start = panel->bus_free_ns;
+        }
+        uint64_t duration = (uint64_t) trans.len * 1000000000u / panel->config.bus_bytes_per_sec;
+        mock_sleep_until_ns(start + duration);
+        panel->bus_free_ns = start + duration;
+
+        pthread_mutex_lock(&panel->lock);
+        mock_panel_write_gram(panel, trans.cmd, trans.data, trans.len);
+        panel->stats.bus_busy_us += duration / 1000u;
+        panel->q_head = (panel->q_head + 1) % panel->config.queue_depth;
+        panel->q_count--;
+        pthread_cond_signal(&panel->not_full);
+        pthread_mutex_unlock(&panel->lock);
+
+        // Descriptorul e liber inainte de callback, ca in ISR-ul i80
+        if (panel->trans_done_cb) {
+            panel->trans_done_cb(panel, panel->trans_done_ctx);
+        }
+
+        pthread_mutex_lock(&panel->lock);
+        panel->bus_active = false;
+        if (panel->q_count == 0) {
+            pthread_cond_broadcast(&panel->idle);
+        }
+    }
+    pthread_mutex_unlock(&panel->lock);
+    return NULL;
+}
+//---------
+mock_panel_t* mock_panel_create(const mock_panel_config_t* config) {
+    if (!config || config->h_res <= 0 || config->v_res <= 0 || config->bits_per_pixel % 8 != 0) {
+        return NULL;
+    }
+    mock_panel_t* panel = (mock_panel_t*) calloc(1, sizeof(mock_panel_t));
+    if (!panel) {
+        return NULL;
+    }
+    panel->config          = *config;
+    panel->bytes_per_pixel = config->bits_per_pixel / 8;
+    panel->gram_size       = (size_t) config->h_res * config->v_res * panel->bytes_per_pixel;
+    panel->gram            = (uint8_t*) calloc(1, panel->gram_size);
+    if (!panel->gram) {
+        free(panel);
+        return NULL;
+    }
+    if (panel->config.queue_depth == 0) {
+        panel->config.queue_depth = MOCK_PANEL_DEFAULT_QUEUE_DEPTH;
+    }
+    panel->win_x2 = config->h_res;
+    panel->win_y2 = config->v_res;
+
+    if (panel->config.bus_bytes_per_sec) {
+        panel->queue = (mock_panel_trans_t*) calloc(panel->config.queue_depth, sizeof(mock_panel_trans_t));
+        if (!panel->queue) {
+            free(panel->gram);
+            free(panel);
+            return NULL;
+        }
+        pthread_mutex_init(&panel->lock, NULL);
+        pthread_cond_init(&panel->not_empty, NULL);
+        pthread_cond_init(&panel->not_full, NULL);
+        pthread_cond_init(&panel->idle, NULL);
+        if (pthread_create(&panel->bus_thread, NULL, mock_panel_bus_task, panel) != 0) {
+            free(panel->queue);
+            free(panel->gram);
+            free(panel);
+            return NULL;
+        }
+    }
+    return panel;
+}
+//---------
+void mock_panel_delete(mock_panel_t* panel) {
+    if (panel) {
+        if (panel->config.bus_bytes_per_sec) {
+            pthread_mutex_lock(&panel->lock);
+            panel->stop = true;
+            pthread_cond_signal(&panel->not_empty);
+            pthread_mutex_unlock(&panel->lock);
+            pthread_join(panel->bus_thread, NULL);
+            pthread_mutex_destroy(&panel->lock);
+            pthread_cond_destroy(&panel->not_empty);
+            pthread_cond_destroy(&panel->not_full);
+            pthread_cond_destroy(&panel->idle);
+            free(panel->queue);
+        }
+        free(panel->gram);
+        free(panel);
+    }
+}
+//---------
+void mock_panel_register_trans_done(mock_panel_t* panel, mock_panel_trans_done_cb_t cb, void* user_ctx) {
+    panel->trans_done_cb  = cb;
+    panel->trans_done_ctx = user_ctx;
+}
+//---------
+void mock_panel_wait_idle(mock_panel_t* panel) {
+    if (!panel->config.bus_bytes_per_sec) {
+        return;
+    }
+    pthread_mutex_lock(&panel->lock);
+    while (panel->q_count != 0 || panel->bus_active) {
+        pthread_cond_wait(&panel->idle, &panel->lock);
+    }
+    pthread_mutex_unlock(&panel->lock);
+}
+//---------
+int mock_panel_set_window(mock_panel_t* panel, int x_start, int y_start, int x_end, int y_end) {
+    if (x_start < 0 || y_start < 0 || x_end > panel->config.h_res || y_end > panel->config.v_res || x_start >= x_end ||
+        y_start >= y_end) {
+        return -1;
+    }
+    mock_panel_wait_idle(panel);
+    panel->win_x1     = x_start;
+    panel->win_y1     = y_start;
+    panel->win_x2     = x_end;
+    panel->win_y2     = y_end;
+    panel->win_cursor = 0;
+    return 0;
+}
+//---------
+int mock_panel_tx_color(mock_panel_t* panel, int cmd, const void* color_data, size_t len) {
+    if ((cmd != MOCK_PANEL_CMD_RAMWR && cmd != MOCK_PANEL_CMD_RAMWRC) || !color_data || len == 0 || len % panel->bytes_per_pixel != 0) {
+        return -1;
+    }
+    if (panel->config.cache_sync_bytes_per_sec) {
+        // esp_cache_msync ruleaza pe CPU, in contextul celui care pune transferul in coada
+        uint64_t deadline = mock_now_ns() + (uint64_t) len * 1000000000u / panel->config.cache_sync_bytes_per_sec;
+        while (mock_now_ns() < deadline) {
+        }
+    }
+
+    if (!panel->config.bus_bytes_per_sec) {
+        mock_panel_write_gram(panel, cmd, (const uint8_t*) color_data, len);
+        if (panel->trans_done_cb) {
+            panel->trans_done_cb(panel, panel->trans_done_ctx);
+        }
+        return 0;
+    }
+
+    pthread_mutex_lock(&panel->lock);
+    while (panel->q_count == panel->config.queue_depth) {
+        pthread_cond_wait(&panel->not_full, &panel->lock);
+    }
+    uint32_t tail                = (panel->q_head + panel->q_count) % panel->config.queue_depth;
+    panel->queue[tail].cmd       = cmd;
+    panel->queue[tail].data      = (const uint8_t*) color_data;
+    panel->queue[tail].len       = len;
+    panel->queue[tail].queued_ns = mock_now_ns();
+    panel->q_count++;
+    pthread_cond_signal(&panel->not_empty);
+    pthread_mutex_unlock(&panel->lock);
+    return 0;
+}
+//---------
+int mock_panel_draw_bitmap(mock_panel_t* panel, int x_start, int y_start, int x_end, int y_end, const void* color_data) {
+    if (!color_data || mock_panel_set_window(panel, x_start, y_start, x_end, y_end) != 0) {
+        return -1;
+    }
+    size_t len = (size_t) (x_end - x_start) * (size_t) (y_end - y_start) * panel->bytes_per_pixel;
+    return mock_panel_tx_color(panel, MOCK_PANEL_CMD_RAMWR, color_data, len);
+}
+//---------
+const mock_panel_stats_t* mock_panel_get_stats(const mock_panel_t* panel) {
+    return &panel->stats;
+}
+//---------
+void mock_panel_reset_stats(mock_panel_t* panel) {
+    memset(&panel->stats, 0, sizeof(panel->stats));
+}
+//---------
+const uint8_t* mock_panel_get_gram(const mock_panel_t* panel) {
+    return panel->gram;
+}
+//---------
+size_t mock_panel_get_gram_size(const mock_panel_t* panel) {
+    return panel->gram_size;
+}
@@ -0,0 +1,92 @@
+#pragma once
+#ifndef MOCK_PANEL_H
+#define MOCK_PANEL_H
+
+/*
+ * Mock ST7789 on an i80 bus for the host build.
+ * Are aceeasi forma ca esp_lcd_panel_draw_bitmap (x_end / y_end exclusive) si
+ * on_color_trans_done, dar in loc sa trimita pe magistrala tine un GRAM in RAM
+ * si numara zonele / byte-ii primiti.
+ *
+ * Cu bus_bytes_per_sec != 0 magistrala e simulata: transferurile intra intr-o
+ * coada de queue_depth (ca trans_queue_depth), un thread le "trimite" cu latimea
+ * de banda data si cheama trans_done din thread-ul acela (ca din ISR pe placa).
+ * Pixelii sunt cititi din buffer abia cand transferul ajunge pe magistrala, deci
+ * un buffer refolosit prea devreme se vede in GRAM.
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* #ifdef __cplusplus */
+
+#define MOCK_PANEL_CMD_RAMWR  (0x2C)  // Memory write, starts at the window origin
+#define MOCK_PANEL_CMD_RAMWRC (0x3C)  // Memory write continue, goes on from the last pixel
+
+typedef struct mock_panel_t mock_panel_t;
+
+/* Same meaning as esp_lcd_panel_io_color_trans_done_cb_t */
+typedef bool (*mock_panel_trans_done_cb_t)(mock_panel_t* panel, void* user_ctx);
+
+typedef struct {
+    int32_t  h_res;             // Width in pixels
+    int32_t  v_res;             // Height in pixels
+    uint32_t bits_per_pixel;    // 16 for RGB565
+    bool     swap_color_bytes;  // Same as esp_lcd_panel_io_i80_config_t.flags.swap_color_bytes
+    uint32_t bus_bytes_per_sec;        // 0 = transfers complete inside the call (no bus simulation)
+    uint32_t queue_depth;              // Same as esp_lcd_panel_io_i80_config_t.trans_queue_depth, 0 = 10
+    uint32_t cache_sync_bytes_per_sec; // CPU cost of esp_cache_msync for PSRAM buffers, 0 = none
+} mock_panel_config_t;
+
+typedef struct {
+    uint32_t flush_count;     // Number of color transfers (one per draw_bitmap call)
+    uint64_t flushed_bytes;   // Total bytes pushed to the panel
+    uint64_t flushed_pixels;  // Total pixels pushed to the panel
+    uint32_t max_flush_bytes; // Largest single transfer
+    uint64_t bus_busy_us;     // Simulated time the bus spent sending pixels
+} mock_panel_stats_t;
+
+mock_panel_t* mock_panel_create(const mock_panel_config_t* config);
+void          mock_panel_delete(mock_panel_t* panel);
+
+void mock_panel_register_trans_done(mock_panel_t* panel, mock_panel_trans_done_cb_t cb, void* user_ctx);
+
+/**
+ * @brief Copy a color block into the panel GRAM, like esp_lcd_panel_draw_bitmap()
+ *        (set_window + one RAMWR transfer). Without bus simulation the trans done
+ *        callback is called before returning.
+ * @return 0 on success, -1 on invalid area
+ */
+int mock_panel_draw_bitmap(mock_panel_t* panel, int x_start, int y_start, int x_end, int y_end, const void* color_data);
+
+/**
+ * @brief CASET/RASET (x_end / y_end exclusive). Like esp_lcd_panel_io_tx_param() it
+ *        waits until every queued transfer is done.
+ */
+int mock_panel_set_window(mock_panel_t* panel, int x_start, int y_start, int x_end, int y_end);
+
+/**
+ * @brief Queue a color transfer, like esp_lcd_panel_io_tx_color(). cmd is
+ *        MOCK_PANEL_CMD_RAMWR or MOCK_PANEL_CMD_RAMWRC. Blocks while the queue is full.
+ * @return 0 on success, -1 on invalid command / length
+ */
+int mock_panel_tx_color(mock_panel_t* panel, int cmd, const void* color_data, size_t len);
+
+/* Wait until the simulated bus has sent everything queued */
+void mock_panel_wait_idle(mock_panel_t* panel);
+
+const mock_panel_stats_t* mock_panel_get_stats(const mock_panel_t* panel);
+void                      mock_panel_reset_stats(mock_panel_t* panel);
+
+/* GRAM contents as the panel would show them (after the optional byte swap) */
+const uint8_t* mock_panel_get_gram(const mock_panel_t* panel);
+size_t         mock_panel_get_gram_size(const mock_panel_t* panel);
+
+#ifdef __cplusplus
+}
+#endif /* #ifdef __cplusplus */
+
+#endif /* #ifndef MOCK_PANEL_H */
@@ -0,0 +1,3 @@
+#pragma once
+/* Host stub for cJSON.h - opaque type for headers that declare cJSON builders (not linked on host) */
+typedef struct cJSON cJSON;
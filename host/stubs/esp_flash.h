@@ -0,0 +1,10 @@
+#pragma once
+/* Host stub for esp_flash.h - reads from the default chip (bench defines a fake flash) */
+#include <stdint.h>
+
+#include "esp_err.h"
+
+typedef struct esp_flash_t esp_flash_t;
+
+esp_err_t esp_flash_read(esp_flash_t* chip, void* buffer, uint32_t address, uint32_t length);
+esp_err_t esp_flash_get_size(esp_flash_t* chip, uint32_t* out_size);
@@ -0,0 +1,33 @@
+#pragma once
+/* Host stub for esp_heap_caps.h - every capability is the libc heap */
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#define MALLOC_CAP_8BIT     (1 << 2)
+#define MALLOC_CAP_SPIRAM   (1 << 10)
+#define MALLOC_CAP_INTERNAL (1 << 11)
+#define MALLOC_CAP_DEFAULT  (1 << 12)
+
+static inline void* heap_caps_malloc(size_t size, uint32_t caps) {
+    (void) caps;
+    return malloc(size);
+}
+
+/* Varianta reala incearca pe rand fiecare set de capabilitati */
+static inline void* heap_caps_malloc_prefer(size_t size, size_t num, ...) {
+    (void) num;
+    return malloc(size);
+}
+
+static inline void* heap_caps_calloc_prefer(size_t n, size_t size, size_t num, ...) {
+    (void) num;
+    return calloc(n, size);
+}
+
+static inline void heap_caps_free(void* ptr) {
+    free(ptr);
+}
+
+/* Dimensiunea totala a unei regiuni: definita de benchul care o foloseste */
+size_t heap_caps_get_total_size(uint32_t caps);
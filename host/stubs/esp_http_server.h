@@ -0,0 +1,25 @@
+#pragma once
+/* Host stub for esp_http_server.h - handle types for the benches that never start a server,
+ * plus the request/response calls used by the static file handler (bench_sysmon_www defines them) */
+#include <stddef.h>
+#include <sys/types.h>
+
+#include "esp_err.h"
+
+#define HTTPD_RESP_USE_STRLEN -1
+
+typedef void*              httpd_handle_t;
+typedef struct httpd_req   httpd_req_t;
+
+struct httpd_req {
+    void* user_ctx;
+    void* aux;  // Starea benchului (headere cerute, raspunsul inregistrat)
+};
+
+size_t    httpd_req_get_hdr_value_len(httpd_req_t* r, const char* field);
+esp_err_t httpd_req_get_hdr_value_str(httpd_req_t* r, const char* field, char* val, size_t val_size);
+esp_err_t httpd_resp_set_type(httpd_req_t* r, const char* type);
+esp_err_t httpd_resp_set_hdr(httpd_req_t* r, const char* field, const char* value);
+esp_err_t httpd_resp_set_status(httpd_req_t* r, const char* status);
+esp_err_t httpd_resp_send(httpd_req_t* r, const char* buf, ssize_t buf_len);
+esp_err_t httpd_resp_send_500(httpd_req_t* r);
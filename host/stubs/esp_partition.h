@@ -0,0 +1,40 @@
+#pragma once
+/* Host stub for esp_partition.h - partition table walk (bench defines a fake table) */
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef enum {
+    ESP_PARTITION_TYPE_APP  = 0x00,
+    ESP_PARTITION_TYPE_DATA = 0x01,
+    ESP_PARTITION_TYPE_ANY  = 0xff,
+} esp_partition_type_t;
+
+typedef enum {
+    ESP_PARTITION_SUBTYPE_APP_FACTORY = 0x00,
+    ESP_PARTITION_SUBTYPE_APP_OTA_0   = 0x10,
+    ESP_PARTITION_SUBTYPE_APP_OTA_1   = 0x11,
+    ESP_PARTITION_SUBTYPE_DATA_OTA    = 0x00,
+    ESP_PARTITION_SUBTYPE_DATA_PHY    = 0x01,
+    ESP_PARTITION_SUBTYPE_DATA_NVS    = 0x02,
+    ESP_PARTITION_SUBTYPE_DATA_SPIFFS = 0x82,
+    ESP_PARTITION_SUBTYPE_ANY         = 0xff,
+} esp_partition_subtype_t;
+
+typedef struct {
+    const void*             flash_chip;
+    esp_partition_type_t    type;
+    esp_partition_subtype_t subtype;
+    uint32_t                address;
+    uint32_t                size;
+    uint32_t                erase_size;
+    char                    label[17];
+    bool                    encrypted;
+    bool                    readonly;
+} esp_partition_t;
+
+typedef struct esp_partition_iterator_opaque_* esp_partition_iterator_t;
+
+esp_partition_iterator_t esp_partition_find(esp_partition_type_t type, esp_partition_subtype_t subtype, const char* label);
+const esp_partition_t*   esp_partition_get(esp_partition_iterator_t iterator);
+esp_partition_iterator_t esp_partition_next(esp_partition_iterator_t iterator);
+void                     esp_partition_iterator_release(esp_partition_iterator_t iterator);
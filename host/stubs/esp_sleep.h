@@ -0,0 +1,9 @@
+#pragma once
+/* Host stub for esp_sleep.h - light sleep is a no-op on the PC */
+#include <stdint.h>
+
+#include "esp_err.h"
+
+static inline esp_err_t esp_light_sleep_start(void) {
+    return 0;
+}
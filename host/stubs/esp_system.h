@@ -0,0 +1,4 @@
+#pragma once
+/* Host stub for esp_system.h - bench defines esp_get_idf_version */
+
+const char* esp_get_idf_version(void);
@@ -0,0 +1,29 @@
+#pragma once
+/* Host stub for freertos/FreeRTOS.h - only the types mylibs/sysmon keeps in its state */
+#include <stdint.h>
+
+typedef uint32_t     UBaseType_t;
+typedef int32_t      BaseType_t;
+typedef uint32_t     TickType_t;
+typedef uint8_t      StackType_t;  // Xtensa: stack depth is counted in bytes
+typedef void*        TaskHandle_t;
+typedef unsigned int configRUN_TIME_COUNTER_TYPE;
+
+#define configMAX_TASK_NAME_LEN (16)  // CONFIG_FREERTOS_MAX_TASK_NAME_LEN
+
+#define pdPASS  (1)
+#define pdTRUE  (1)
+#define pdFALSE (0)
+
+/* sysmon.h checks these sdkconfig options */
+#define CONFIG_FREERTOS_USE_TRACE_FACILITY     1
+#define CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS 1
+
+/* Critical sections: the host benches drive sysmon from a single thread */
+typedef struct {
+    volatile uint32_t owner;
+} portMUX_TYPE;
+
+#define portMUX_INITIALIZER_UNLOCKED {0}
+#define portENTER_CRITICAL(mux)      ((void) (mux))
+#define portEXIT_CRITICAL(mux)       ((void) (mux))
@@ -0,0 +1,31 @@
+#pragma once
+/* Host stub for freertos/task.h - TaskStatus_t as filled by uxTaskGetSystemState() */
+#include "freertos/FreeRTOS.h"
+
+typedef enum {
+    eRunning = 0,
+    eReady,
+    eBlocked,
+    eSuspended,
+    eDeleted,
+    eInvalid
+} eTaskState;
+
+typedef struct {
+    TaskHandle_t                xHandle;
+    const char*                 pcTaskName;
+    UBaseType_t                 xTaskNumber;
+    eTaskState                  eCurrentState;
+    UBaseType_t                 uxCurrentPriority;
+    UBaseType_t                 uxBasePriority;
+    configRUN_TIME_COUNTER_TYPE ulRunTimeCounter;
+    StackType_t*                pxStackBase;
+    uint32_t                    usStackHighWaterMark;
+    BaseType_t                  xCoreID;
+} TaskStatus_t;
+
+/* Benches that link sysmon_stack.c provide it */
+char* pcTaskGetName(TaskHandle_t xTaskToQuery);
+
+/* Benches that link sysmon_snapshot.c provide it */
+void vTaskDelay(const TickType_t xTicksToDelay);
@@ -0,0 +1,15 @@
+#pragma once
+/* Host stub for nvs_flash.h / nvs.h - entry statistics of an NVS partition (bench defines it) */
+#include <stddef.h>
+
+#include "esp_err.h"
+
+typedef struct {
+    size_t used_entries;
+    size_t free_entries;
+    size_t available_entries;
+    size_t total_entries;
+    size_t namespace_count;
+} nvs_stats_t;
+
+esp_err_t nvs_get_stats(const char* part_name, nvs_stats_t* nvs_stats);
@@ -0,0 +1,6 @@
+#pragma once
+/* Host stub for soc/clk_tree_defs.h - only the CPU clock */
+
+typedef enum {
+    SOC_MOD_CLK_CPU = 1,
+} soc_module_clk_t;
@@ -0,0 +1,80 @@
+#pragma once
+#ifndef DISPLAY_MODES_H
+#define DISPLAY_MODES_H
+
+/*
+ * Buffer / render / color mode constants shared by main.cpp and the host benchmark (host/).
+ * Selectia efectiva (BUFFER_MODE, BUFFER_MEM, RENDER_MODE, COLOR_MODE) ramane in main.cpp.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "lvgl.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* #ifdef __cplusplus */
+
+/* BUFFER MODE */
+#define BUFFER_20LINES  1
+#define BUFFER_40LINES  2
+#define BUFFER_60LINES  3  // merge
+#define BUFFER_DEVIDED4 4
+#define BUFFER_FULL     5  // merge super ok
+//---------
+/* BUFFER MEMORY TYPE AND DMA */
+#define BUFFER_INTERNAL 1
+#define BUFFER_SPIRAM   2
+//---------
+/* RENDER MODE */
+// Aici e mod mai special pt ca se transmite direct functiei....
+#define RENDER_MODE_PARTIAL (LV_DISPLAY_RENDER_MODE_PARTIAL)
+#define RENDER_MODE_FULL    (LV_DISPLAY_RENDER_MODE_FULL)
+#define RENDER_MODE_DIRECT  (LV_DISPLAY_RENDER_MODE_DIRECT)
+//---------
+/* COLOR MODE */
+// RGB565: LVGL deseneaza RGB565 nativ, i80 inverseaza byte-ii la transfer (swap_color_bytes = 1)
+// RGB565_SWAPPED: LVGL deseneaza direct in ordinea panoului (big endian), i80 trimite bufferul ca atare
+#define COLOR_MODE_RGB565         1
+#define COLOR_MODE_RGB565_SWAPPED 2
+//---------
+
+/**
+ * @brief LVGL display color format for a COLOR_MODE_* value.
+ */
+static inline lv_color_format_t display_color_mode_format(uint32_t color_mode) {
+    return color_mode == COLOR_MODE_RGB565_SWAPPED ? LV_COLOR_FORMAT_RGB565_SWAPPED : LV_COLOR_FORMAT_RGB565;
+}
+
+/**
+ * @brief esp_lcd_panel_io_i80_config_t.flags.swap_color_bytes for a COLOR_MODE_* value
+ *        (the ST7789 wants the high byte first, exactly one side has to swap).
+ */
+static inline bool display_color_mode_swap_bytes(uint32_t color_mode) {
+    return color_mode != COLOR_MODE_RGB565_SWAPPED;
+}
+
+/**
+ * @brief Number of display rows covered by one draw buffer in the given BUFFER_* mode.
+ */
+static inline uint32_t display_buffer_mode_lines(uint32_t buffer_mode, uint32_t ver_res) {
+    switch (buffer_mode) {
+        case BUFFER_20LINES:
+            return 20;
+        case BUFFER_40LINES:
+            return 40;
+        case BUFFER_60LINES:
+            return 60;
+        case BUFFER_DEVIDED4:
+            return ver_res / 4;
+        case BUFFER_FULL:
+        default:
+            return ver_res;
+    }
+}
+
+#ifdef __cplusplus
+}
+#endif /* #ifdef __cplusplus */
+
+#endif /* #ifndef DISPLAY_MODES_H */
@@ -0,0 +1,646 @@
+#include "display_setup.h"
+
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "esp_attr.h"
+#include "esp_console.h"
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "nvs.h"
+#include "nvs_flash.h"
+#include "sysmon_hardware.h"
+#include "ui_queue.h"
+
+static const char* TAG = "DISPLAY";
+
+#define DISPLAY_NVS_NAMESPACE   "display"
+#define DISPLAY_DRAIN_TIMEOUT_MS 200
+#define DISPLAY_AB_MAX_STRATEGIES 8
+#define DISPLAY_AB_MAX_MS         60000  // `display ab [ms]`, per strategy
+
+/**********************
+ *   STATE
+ **********************/
+static lv_display_t*             s_disp   = NULL;
+static display_setup_lock_fn_t   s_lock   = NULL;
+static display_setup_unlock_fn_t s_unlock = NULL;
+
+static display_buf_config_t s_cfg;
+static void*                s_buf1     = NULL;
+static void*                s_buf2     = NULL;
+static size_t               s_buf_size = 0;
+
+/* Flush / render statistics. Writers: lv_main_task and the i80 ISR */
+static atomic_int        s_in_flight = 0;
+static volatile int64_t  s_flush_start_us;
+static volatile uint32_t s_flush_cnt;
+static volatile uint64_t s_flush_sum_us;
+static volatile uint32_t s_flush_max_us;
+static int64_t           s_refr_start_us;
+static bool              s_refr_rendered;
+static uint32_t          s_frame_cnt;
+static uint64_t          s_render_sum_us;
+static int64_t           s_stats_since_us;
+static flush_engine_t*   s_flush_engine = NULL;
+static frame_sched_t*    s_frame_sched  = NULL;
+
+/* A/B */
+static TaskHandle_t         s_ab_task = NULL;
+static display_buf_config_t s_ab_cfgs[DISPLAY_AB_MAX_STRATEGIES];
+static size_t               s_ab_count;
+static uint32_t             s_ab_ms;
+
+static const display_buf_config_t s_ab_default[] = {
+    {.lines = 0, .mem = DISPLAY_BUF_MEM_SPIRAM, .render_mode = LV_DISPLAY_RENDER_MODE_PARTIAL, .double_buffer = true},
+    {.lines = 0, .mem = DISPLAY_BUF_MEM_SPIRAM, .render_mode = LV_DISPLAY_RENDER_MODE_PARTIAL, .double_buffer = false},
+    {.lines = 60, .mem = DISPLAY_BUF_MEM_INTERNAL_DMA, .render_mode = LV_DISPLAY_RENDER_MODE_PARTIAL, .double_buffer = true},
+    {.lines = 40, .mem = DISPLAY_BUF_MEM_INTERNAL_DMA, .render_mode = LV_DISPLAY_RENDER_MODE_PARTIAL, .double_buffer = true},
+    {.lines = 20, .mem = DISPLAY_BUF_MEM_INTERNAL_DMA, .render_mode = LV_DISPLAY_RENDER_MODE_PARTIAL, .double_buffer = true},
+    {.lines = 40, .mem = DISPLAY_BUF_MEM_SPIRAM, .render_mode = LV_DISPLAY_RENDER_MODE_PARTIAL, .double_buffer = true},
+};
+
+/**********************
+ *   HELPERS
+ **********************/
+static uint32_t display_ver_res(void) {
+    return (uint32_t) lv_display_get_original_vertical_resolution(s_disp);
+}
+//---------
+static uint32_t display_cfg_lines(const display_buf_config_t* cfg) {
+    uint32_t ver_res = display_ver_res();
+    if (cfg->lines == 0 || cfg->lines > ver_res) {
+        return ver_res;
+    }
+    return cfg->lines;
+}
+//---------
+static uint32_t display_mem_caps(uint8_t mem) {
+    switch (mem) {
+        case DISPLAY_BUF_MEM_INTERNAL_DMA:
+            return MALLOC_CAP_INTERNAL | MALLOC_CAP_DMA;
+        case DISPLAY_BUF_MEM_INTERNAL:
+            return MALLOC_CAP_INTERNAL;
+        case DISPLAY_BUF_MEM_SPIRAM:
+        default:
+            return MALLOC_CAP_SPIRAM;
+    }
+}
+//---------
+static const char* display_mem_name(uint8_t mem) {
+    switch (mem) {
+        case DISPLAY_BUF_MEM_INTERNAL_DMA:
+            return "internal+DMA";
+        case DISPLAY_BUF_MEM_INTERNAL:
+            return "internal";
+        case DISPLAY_BUF_MEM_SPIRAM:
+            return "spiram";
+        default:
+            return "?";
+    }
+}
+//---------
+static const char* display_render_name(uint8_t mode) {
+    switch (mode) {
+        case LV_DISPLAY_RENDER_MODE_PARTIAL:
+            return "partial";
+        case LV_DISPLAY_RENDER_MODE_FULL:
+            return "full";
+        case LV_DISPLAY_RENDER_MODE_DIRECT:
+            return "direct";
+        default:
+            return "?";
+    }
+}
+//---------
+void display_setup_describe(const display_buf_config_t* cfg, char* out, size_t out_len) {
+    char lines[16];
+    if (cfg->lines == 0) {
+        snprintf(lines, sizeof(lines), "full screen");
+    } else {
+        snprintf(lines, sizeof(lines), "%u lines", (unsigned) cfg->lines);
+    }
+    snprintf(out,
+        out_len,
+        "%s, %s, %s, %s",
+        lines,
+        display_mem_name(cfg->mem),
+        cfg->double_buffer ? "double" : "single",
+        display_render_name(cfg->render_mode));
+}
+//---------
+static void* display_buf_alloc(size_t size, uint8_t mem) {
+    // i80 DMA din PSRAM cere aliniere la 64 (psram_trans_align), altfel LV_DRAW_BUF_ALIGN
+    size_t align = (mem == DISPLAY_BUF_MEM_SPIRAM) ? 64 : LV_DRAW_BUF_ALIGN;
+    void*  buf   = heap_caps_aligned_alloc(align, size, display_mem_caps(mem));
+    if (buf) {
+        memset(buf, 0, size);  // primul frame complet „negru”
+    }
+    return buf;
+}
+//---------
+static bool display_wait_flush_idle(uint32_t timeout_ms) {
+    int64_t deadline = esp_timer_get_time() + (int64_t) timeout_ms * 1000;
+    while (atomic_load(&s_in_flight) > 0) {
+        if (esp_timer_get_time() > deadline) {
+            return false;
+        }
+        vTaskDelay(1);
+    }
+    return true;
+}
+//---------
+static void display_event_cb(lv_event_t* e) {
+    switch (lv_event_get_code(e)) {
+        case LV_EVENT_REFR_START:
+            s_refr_start_us = esp_timer_get_time();
+            s_refr_rendered = false;
+            break;
+        case LV_EVENT_RENDER_START:
+            s_refr_rendered = true;
+            break;
+        case LV_EVENT_REFR_READY:
+            if (s_refr_rendered) {
+                s_frame_cnt++;
+                s_render_sum_us += (uint64_t) (esp_timer_get_time() - s_refr_start_us);
+            }
+            break;
+        case LV_EVENT_FLUSH_WAIT_START:
+            if (s_flush_engine) {
+                flush_engine_stall_begin(s_flush_engine);
+            }
+            break;
+        case LV_EVENT_FLUSH_WAIT_FINISH:
+            if (s_flush_engine) {
+                flush_engine_stall_end(s_flush_engine);
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+/**********************
+ *   API
+ **********************/
+void display_setup_init(lv_display_t* disp, display_setup_lock_fn_t lock, display_setup_unlock_fn_t unlock) {
+    s_disp   = disp;
+    s_lock   = lock;
+    s_unlock = unlock;
+    lv_display_add_event_cb(disp, display_event_cb, LV_EVENT_REFR_START, NULL);
+    lv_display_add_event_cb(disp, display_event_cb, LV_EVENT_RENDER_START, NULL);
+    lv_display_add_event_cb(disp, display_event_cb, LV_EVENT_REFR_READY, NULL);
+    lv_display_add_event_cb(disp, display_event_cb, LV_EVENT_FLUSH_WAIT_START, NULL);
+    lv_display_add_event_cb(disp, display_event_cb, LV_EVENT_FLUSH_WAIT_FINISH, NULL);
+    display_setup_reset_stats();
+}
+//---------
+esp_err_t display_setup_apply(const display_buf_config_t* cfg) {
+    if (!s_disp || !cfg) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (cfg->mem > DISPLAY_BUF_MEM_SPIRAM || cfg->render_mode > LV_DISPLAY_RENDER_MODE_FULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    uint32_t lines = display_cfg_lines(cfg);
+    // FULL si DIRECT cer buffer cat tot ecranul
+    if (cfg->render_mode != LV_DISPLAY_RENDER_MODE_PARTIAL && lines != display_ver_res()) {
+        ESP_LOGE(TAG, "FULL/DIRECT render mode needs a full screen buffer");
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    uint32_t hor_res = (uint32_t) lv_display_get_original_horizontal_resolution(s_disp);
+    size_t   size    = (size_t) hor_res * lines * lv_color_format_get_size(lv_display_get_color_format(s_disp));
+
+    void* buf1 = display_buf_alloc(size, cfg->mem);
+    void* buf2 = cfg->double_buffer ? display_buf_alloc(size, cfg->mem) : NULL;
+    if (!buf1 || (cfg->double_buffer && !buf2)) {
+        ESP_LOGE(TAG, "LVGL buffer allocate failed (%u bytes, %s)", (unsigned) size, display_mem_name(cfg->mem));
+        heap_caps_free(buf1);
+        heap_caps_free(buf2);
+        return ESP_ERR_NO_MEM;
+    }
+
+    // DMA-ul poate inca citi din bufferele vechi
+    if (!display_wait_flush_idle(DISPLAY_DRAIN_TIMEOUT_MS)) {
+        ESP_LOGE(TAG, "Flush still in progress, keeping the current buffers");
+        heap_caps_free(buf1);
+        heap_caps_free(buf2);
+        return ESP_ERR_TIMEOUT;
+    }
+
+    lv_display_set_buffers(s_disp, buf1, buf2, (uint32_t) size, (lv_display_render_mode_t) cfg->render_mode);
+    heap_caps_free(s_buf1);
+    heap_caps_free(s_buf2);
+    s_buf1     = buf1;
+    s_buf2     = buf2;
+    s_buf_size = size;
+    s_cfg      = *cfg;
+
+    lv_obj_invalidate(lv_display_get_screen_active(s_disp));
+
+    char desc[64];
+    display_setup_describe(cfg, desc, sizeof(desc));
+    ESP_LOGI(TAG, "LVGL buffers set: %s (%u bytes each)", desc, (unsigned) size);
+    return ESP_OK;
+}
+//---------
+const display_buf_config_t* display_setup_get_config(void) {
+    return &s_cfg;
+}
+//---------
+size_t display_setup_get_buffer_size(void) {
+    return s_buf_size;
+}
+//---------
+static esp_err_t display_nvs_open(nvs_open_mode_t mode, nvs_handle_t* handle) {
+    esp_err_t err = nvs_open(DISPLAY_NVS_NAMESPACE, mode, handle);
+    if (err == ESP_ERR_NVS_NOT_INITIALIZED) {
+        err = nvs_flash_init();
+        if (err == ESP_ERR_NVS_NO_FREE_PAGES || err == ESP_ERR_NVS_NEW_VERSION_FOUND) {
+            ESP_ERROR_CHECK(nvs_flash_erase());
+            err = nvs_flash_init();
+        }
+        if (err != ESP_OK) {
+            return err;
+        }
+        err = nvs_open(DISPLAY_NVS_NAMESPACE, mode, handle);
+    }
+    return err;
+}
+//---------
+esp_err_t display_setup_load_nvs(display_buf_config_t* cfg) {
+    nvs_handle_t handle;
+    esp_err_t    err = display_nvs_open(NVS_READONLY, &handle);
+    if (err != ESP_OK) {
+        return err;  // ESP_ERR_NVS_NOT_FOUND: nu s-a salvat nimic inca
+    }
+    display_buf_config_t tmp = *cfg;
+    uint8_t              dbl = tmp.double_buffer;
+    err                      = nvs_get_u16(handle, "lines", &tmp.lines);
+    if (err == ESP_OK) {
+        err = nvs_get_u8(handle, "mem", &tmp.mem);
+    }
+    if (err == ESP_OK) {
+        err = nvs_get_u8(handle, "render", &tmp.render_mode);
+    }
+    if (err == ESP_OK) {
+        err = nvs_get_u8(handle, "double", &dbl);
+    }
+    nvs_close(handle);
+    if (err == ESP_OK) {
+        tmp.double_buffer = dbl != 0;
+        *cfg              = tmp;
+    }
+    return err;
+}
+//---------
+esp_err_t display_setup_save_nvs(const display_buf_config_t* cfg) {
+    nvs_handle_t handle;
+    esp_err_t    err = display_nvs_open(NVS_READWRITE, &handle);
+    if (err != ESP_OK) {
+        return err;
+    }
+    err = nvs_set_u16(handle, "lines", cfg->lines);
+    if (err == ESP_OK) {
+        err = nvs_set_u8(handle, "mem", cfg->mem);
+    }
+    if (err == ESP_OK) {
+        err = nvs_set_u8(handle, "render", cfg->render_mode);
+    }
+    if (err == ESP_OK) {
+        err = nvs_set_u8(handle, "double", cfg->double_buffer ? 1 : 0);
+    }
+    if (err == ESP_OK) {
+        err = nvs_commit(handle);
+        if (err == ESP_OK) {
+            sysmon_hardware_note_nvs_commit();
+        }
+    }
+    nvs_close(handle);
+    return err;
+}
+//---------
+void IRAM_ATTR display_setup_flush_begin(void) {
+    atomic_fetch_add(&s_in_flight, 1);
+    s_flush_start_us = esp_timer_get_time();
+}
+//---------
+void IRAM_ATTR display_setup_flush_done(void) {
+    uint32_t dt = (uint32_t) (esp_timer_get_time() - s_flush_start_us);
+    s_flush_cnt++;
+    s_flush_sum_us += dt;
+    if (dt > s_flush_max_us) {
+        s_flush_max_us = dt;
+    }
+    atomic_fetch_sub(&s_in_flight, 1);
+}
+//---------
+void display_setup_get_stats(display_setup_stats_t* out) {
+    memset(out, 0, sizeof(*out));
+    out->frames       = s_frame_cnt;
+    out->flushes      = s_flush_cnt;
+    out->flush_max_us = s_flush_max_us;
+    out->elapsed_ms   = (uint32_t) ((esp_timer_get_time() - s_stats_since_us) / 1000);
+    if (s_flush_cnt) {
+        out->flush_avg_us = (uint32_t) (s_flush_sum_us / s_flush_cnt);
+    }
+    if (s_frame_cnt) {
+        out->render_avg_us = (uint32_t) (s_render_sum_us / s_frame_cnt);
+    }
+}
+//---------
+void display_setup_reset_stats(void) {
+    s_flush_cnt      = 0;
+    s_flush_sum_us   = 0;
+    s_flush_max_us   = 0;
+    s_frame_cnt      = 0;
+    s_render_sum_us  = 0;
+    s_stats_since_us = esp_timer_get_time();
+    if (s_flush_engine) {
+        flush_engine_reset_stats(s_flush_engine);
+    }
+    if (s_frame_sched) {
+        frame_sched_reset_stats(s_frame_sched);
+    }
+}
+//---------
+void display_setup_set_flush_engine(flush_engine_t* fe) {
+    s_flush_engine = fe;
+}
+//---------
+void display_setup_set_frame_sched(frame_sched_t* fs) {
+    s_frame_sched = fs;
+}
+
+/**********************
+ *   A/B MEASUREMENT
+ **********************/
+static void display_ab_load_timer_cb(lv_timer_t* timer) {
+    (void) timer;
+    lv_obj_invalidate(lv_display_get_screen_active(s_disp));  // redraw complet la fiecare refresh
+}
+//---------
+static void display_ab_task(void* parameter) {
+    (void) parameter;
+    display_buf_config_t restore = s_cfg;
+    lv_timer_t*          load    = NULL;
+
+    if (s_lock(portMAX_DELAY)) {
+        load = lv_timer_create(display_ab_load_timer_cb, 1, NULL);
+        s_unlock();
+    }
+
+    ESP_LOGI(TAG, "A/B: %u strategies, %u ms each", (unsigned) s_ab_count, (unsigned) s_ab_ms);
+    for (size_t i = 0; i < s_ab_count; i++) {
+        char desc[64];
+        display_setup_describe(&s_ab_cfgs[i], desc, sizeof(desc));
+
+        esp_err_t err = ESP_FAIL;
+        if (s_lock(portMAX_DELAY)) {
+            err = display_setup_apply(&s_ab_cfgs[i]);
+            s_unlock();
+        }
+        if (err != ESP_OK) {
+            ESP_LOGW(TAG, "A/B [%u] %s: skipped (%s)", (unsigned) i, desc, esp_err_to_name(err));
+            continue;
+        }
+
+        vTaskDelay(pdMS_TO_TICKS(100));  // primul frame dupa schimbare nu conteaza
+        display_setup_reset_stats();
+        vTaskDelay(pdMS_TO_TICKS(s_ab_ms));
+
+        display_setup_stats_t st;
+        display_setup_get_stats(&st);
+        uint32_t fps_x10 = st.elapsed_ms ? (st.frames * 10000u) / st.elapsed_ms : 0;
+        ESP_LOGI(TAG,
+            "A/B [%u] %-44s FPS %3u.%u  render avg %5u us  flush avg %5u us max %5u us  (%u flushes)",
+            (unsigned) i,
+            desc,
+            (unsigned) (fps_x10 / 10),
+            (unsigned) (fps_x10 % 10),
+            (unsigned) st.render_avg_us,
+            (unsigned) st.flush_avg_us,
+            (unsigned) st.flush_max_us,
+            (unsigned) st.flushes);
+    }
+
+    if (s_lock(portMAX_DELAY)) {
+        if (load) {
+            lv_timer_delete(load);
+        }
+        display_setup_apply(&restore);
+        s_unlock();
+    }
+    ESP_LOGI(TAG, "A/B done, strategy restored");
+    s_ab_task = NULL;
+    vTaskDelete(NULL);
+}
+//---------
+esp_err_t display_setup_ab_start(const display_buf_config_t* cfgs, size_t count, uint32_t ms_per_strategy) {
+    if (!s_disp || !s_lock || !s_unlock) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (s_ab_task) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (!cfgs) {
+        cfgs  = s_ab_default;
+        count = sizeof(s_ab_default) / sizeof(s_ab_default[0]);
+    }
+    if (count == 0 || count > DISPLAY_AB_MAX_STRATEGIES) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    memcpy(s_ab_cfgs, cfgs, count * sizeof(display_buf_config_t));
+    s_ab_count = count;
+    s_ab_ms    = ms_per_strategy ? ms_per_strategy : 3000;
+
+    BaseType_t ok = xTaskCreatePinnedToCore(display_ab_task,  // Functia task-ului
+        (const char*) "display_ab",                           // Numele task-ului
+        (uint32_t) (4096),                                     // Dimensiunea stack-ului
+        (NULL),                                                // Parametri
+        (UBaseType_t) tskIDLE_PRIORITY + 1,                    // Prioritatea task-ului
+        &s_ab_task,                                            // Handle-ul task-ului
+        ((0))                                                  // Nucleul pe care ruleaza
+    );
+    return ok == pdPASS ? ESP_OK : ESP_ERR_NO_MEM;
+}
+
+/**********************
+ *   CLI
+ **********************/
+static bool display_parse_mem(const char* s, uint8_t* out) {
+    if (strcmp(s, "dma") == 0) {
+        *out = DISPLAY_BUF_MEM_INTERNAL_DMA;
+    } else if (strcmp(s, "internal") == 0) {
+        *out = DISPLAY_BUF_MEM_INTERNAL;
+    } else if (strcmp(s, "spiram") == 0) {
+        *out = DISPLAY_BUF_MEM_SPIRAM;
+    } else {
+        return false;
+    }
+    return true;
+}
+//---------
+static bool display_parse_lines(const char* s, uint16_t* out) {
+    if (strcmp(s, "full") == 0) {
+        *out = 0;
+        return true;
+    }
+    char*         end;
+    unsigned long lines = strtoul(s, &end, 10);
+    // "-1" trece prin strtoul ca ULONG_MAX, deci iese si el din 1..ver_res
+    if (end == s || *end != '\0' || lines == 0 || lines > display_ver_res()) {
+        return false;
+    }
+    *out = (uint16_t) lines;
+    return true;
+}
+//---------
+static bool display_parse_double(const char* s, bool* out) {
+    if (strcmp(s, "single") == 0) {
+        *out = false;
+    } else if (strcmp(s, "double") == 0) {
+        *out = true;
+    } else {
+        return false;
+    }
+    return true;
+}
+//---------
+static bool display_parse_ab_ms(const char* s, uint32_t* out) {
+    char*         end;
+    unsigned long ms = strtoul(s, &end, 10);
+    if (end == s || *end != '\0' || ms == 0 || ms > DISPLAY_AB_MAX_MS) {
+        return false;
+    }
+    *out = (uint32_t) ms;
+    return true;
+}
+//---------
+static bool display_parse_render(const char* s, uint8_t* out) {
+    if (strcmp(s, "partial") == 0) {
+        *out = LV_DISPLAY_RENDER_MODE_PARTIAL;
+    } else if (strcmp(s, "full") == 0) {
+        *out = LV_DISPLAY_RENDER_MODE_FULL;
+    } else if (strcmp(s, "direct") == 0) {
+        *out = LV_DISPLAY_RENDER_MODE_DIRECT;
+    } else {
+        return false;
+    }
+    return true;
+}
+//---------
+static void display_print_usage(void) {
+    printf("Usage:\n");
+    printf("  display [show]                                          Current strategy and stats\n");
+    printf("  display set <lines|full> <dma|internal|spiram> <single|double> [partial|full|direct]\n");
+    printf("  display save                                            Store current strategy in NVS\n");
+    printf("  display ab [ms]                                         A/B measure built-in strategies\n");
+}
+//---------
+static int display_command(int argc, char** argv) {
+    if (argc < 2 || strcmp(argv[1], "show") == 0) {
+        char desc[64];
+        display_setup_describe(&s_cfg, desc, sizeof(desc));
+        display_setup_stats_t st;
+        display_setup_get_stats(&st);
+        printf("Strategy : %s (%u bytes per buffer)\n", desc, (unsigned) s_buf_size);
+        printf("Color    : %s\n", lv_display_get_color_format(s_disp) == LV_COLOR_FORMAT_RGB565_SWAPPED
+                                       ? "RGB565_SWAPPED (rendered in panel byte order, no i80 swap)"
+                                       : "RGB565 (i80 swaps the color bytes)");
+        printf("Frames   : %u in %u ms\n", (unsigned) st.frames, (unsigned) st.elapsed_ms);
+        printf("Render   : avg %u us\n", (unsigned) st.render_avg_us);
+        printf("Flush    : avg %u us, max %u us (%u flushes)\n", (unsigned) st.flush_avg_us, (unsigned) st.flush_max_us, (unsigned) st.flushes);
+        if (s_flush_engine) {
+            flush_engine_stats_t fs;
+            flush_engine_get_stats(s_flush_engine, &fs);
+            uint64_t bus_total = fs.bus_busy_us + fs.bus_idle_us;
+            printf("Stripes  : %u in %u areas, max %u queued\n", (unsigned) fs.stripes, (unsigned) fs.areas, (unsigned) fs.max_in_flight);
+            printf("Bus      : busy %u ms, idle %u ms (%u%%)\n", (unsigned) (fs.bus_busy_us / 1000), (unsigned) (fs.bus_idle_us / 1000),
+                (unsigned) (bus_total ? fs.bus_idle_us * 100 / bus_total : 0));
+            printf("Stall    : %u ms waiting for flush, %u ms in flush_cb\n", (unsigned) (fs.render_stall_us / 1000), (unsigned) (fs.flush_cb_us / 1000));
+        }
+        if (s_frame_sched) {
+            frame_sched_stats_t ss;
+            frame_sched_get_stats(s_frame_sched, &ss);
+            printf("Pacing   : %u fps target%s, %u frames, %u over budget, %u slots skipped, max %u us\n",
+                (unsigned) s_frame_sched->config.target_fps, s_frame_sched->config.use_te ? " (TE)" : "", (unsigned) ss.frames,
+                (unsigned) ss.overruns, (unsigned) ss.skipped_slots, (unsigned) ss.max_render_us);
+            printf("Idle     : %u wakeups, %u ms asleep, %u TE timeouts\n", (unsigned) ss.wakeups, (unsigned) (ss.idle_us / 1000),
+                (unsigned) ss.te_timeouts);
+        }
+        ui_queue_t* uq = ui_queue_get_default();
+        if (uq) {
+            printf("UI queue : %u posted, %u applied, %u coalesced, %u dropped, max batch %u\n",
+                (unsigned) __atomic_load_n(&uq->stats.posted, __ATOMIC_RELAXED), (unsigned) uq->stats.applied,
+                (unsigned) uq->stats.coalesced, (unsigned) __atomic_load_n(&uq->stats.dropped, __ATOMIC_RELAXED),
+                (unsigned) uq->stats.max_batch);
+        }
+        return 0;
+    }
+    if (strcmp(argv[1], "set") == 0) {
+        if (argc < 5) {
+            display_print_usage();
+            return 1;
+        }
+        display_buf_config_t cfg = s_cfg;
+        cfg.render_mode          = LV_DISPLAY_RENDER_MODE_PARTIAL;
+        if (!display_parse_lines(argv[2], &cfg.lines)) {
+            printf("display set: lines must be 1..%u or full\n", (unsigned) display_ver_res());
+            return 1;
+        }
+        if (!display_parse_mem(argv[3], &cfg.mem) || !display_parse_double(argv[4], &cfg.double_buffer) ||
+            (argc > 5 && !display_parse_render(argv[5], &cfg.render_mode))) {
+            display_print_usage();
+            return 1;
+        }
+        esp_err_t err = ESP_ERR_TIMEOUT;
+        if (s_lock && s_lock(1000)) {
+            err = display_setup_apply(&cfg);
+            s_unlock();
+        }
+        if (err != ESP_OK) {
+            printf("display set failed: %s\n", esp_err_to_name(err));
+            return 1;
+        }
+        display_setup_reset_stats();
+        return 0;
+    }
+    if (strcmp(argv[1], "save") == 0) {
+        esp_err_t err = display_setup_save_nvs(&s_cfg);
+        printf("display save: %s\n", esp_err_to_name(err));
+        return err == ESP_OK ? 0 : 1;
+    }
+    if (strcmp(argv[1], "ab") == 0) {
+        uint32_t ms = 0;
+        if (argc > 2 && !display_parse_ab_ms(argv[2], &ms)) {
+            printf("display ab: ms must be 1..%u\n", (unsigned) DISPLAY_AB_MAX_MS);
+            return 1;
+        }
+        esp_err_t err = display_setup_ab_start(NULL, 0, ms);
+        if (err != ESP_OK) {
+            printf("display ab failed: %s\n", esp_err_to_name(err));
+            return 1;
+        }
+        return 0;
+    }
+    display_print_usage();
+    return 1;
+}
+//---------
+void display_setup_register_cli(void) {
+    const esp_console_cmd_t cmd = {
+        .command = "display",
+        .help    = "Show / change the LVGL display buffer strategy (show, set, save, ab)",
+        .hint    = NULL,
+        .func    = &display_command,
+    };
+    ESP_ERROR_CHECK(esp_console_cmd_register(&cmd));
+    ESP_LOGI(TAG, "'%s' command registered.", cmd.command);
+}
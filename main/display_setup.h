@@ -0,0 +1,103 @@
+#pragma once
+#ifndef DISPLAY_SETUP_H
+#define DISPLAY_SETUP_H
+
+/*
+ * Display buffer strategy chosen at runtime (NVS / CLI) instead of the
+ * BUFFER_MODE / BUFFER_MEM / DOUBLE_BUFFER_MODE #if chains from main.cpp.
+ * Macro-urile din main.cpp raman doar valoarea implicita cand NVS e gol.
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "flush_engine.h"
+#include "frame_scheduler.h"
+#include "lvgl.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* #ifdef __cplusplus */
+
+typedef enum {
+    DISPLAY_BUF_MEM_INTERNAL_DMA = 0,  // MALLOC_CAP_INTERNAL | MALLOC_CAP_DMA
+    DISPLAY_BUF_MEM_INTERNAL     = 1,  // MALLOC_CAP_INTERNAL
+    DISPLAY_BUF_MEM_SPIRAM       = 2,  // MALLOC_CAP_SPIRAM
+} display_buf_mem_t;
+
+typedef struct {
+    uint16_t lines;          // Rows per draw buffer, 0 = full screen
+    uint8_t  mem;            // display_buf_mem_t
+    uint8_t  render_mode;    // lv_display_render_mode_t
+    bool     double_buffer;  // Two buffers (render while the other one is flushed)
+} display_buf_config_t;
+
+typedef struct {
+    uint32_t frames;           // Refreshes that rendered something
+    uint32_t flushes;          // Completed flushes
+    uint32_t flush_avg_us;     // flush_cb -> trans done, average
+    uint32_t flush_max_us;     // flush_cb -> trans done, worst case
+    uint32_t render_avg_us;    // LV_EVENT_REFR_START -> LV_EVENT_REFR_READY, average
+    uint32_t elapsed_ms;       // Time since the last stats reset
+} display_setup_stats_t;
+
+typedef bool (*display_setup_lock_fn_t)(uint32_t timeout_ms);
+typedef void (*display_setup_unlock_fn_t)(void);
+
+/**
+ * @brief Remember the display and the LVGL lock used by the CLI / A-B task.
+ *        Must be called once, before display_setup_apply().
+ */
+void display_setup_init(lv_display_t* disp, display_setup_lock_fn_t lock, display_setup_unlock_fn_t unlock);
+
+/**
+ * @brief Allocate the buffers described by cfg and hand them to lv_display_set_buffers().
+ *        New buffers are allocated first and in-flight flushes are drained before the old
+ *        ones are freed, so on failure the previous strategy stays active.
+ *        Caller must hold the LVGL lock (or LVGL must not be running yet).
+ */
+esp_err_t display_setup_apply(const display_buf_config_t* cfg);
+
+const display_buf_config_t* display_setup_get_config(void);
+size_t                      display_setup_get_buffer_size(void);
+
+/* NVS namespace "display". Load leaves cfg untouched when nothing is stored. */
+esp_err_t display_setup_load_nvs(display_buf_config_t* cfg);
+esp_err_t display_setup_save_nvs(const display_buf_config_t* cfg);
+
+/* Called from the flush path: flush_cb start and on_color_trans_done (ISR safe) */
+void display_setup_flush_begin(void);
+void display_setup_flush_done(void);
+
+void display_setup_get_stats(display_setup_stats_t* out);
+void display_setup_reset_stats(void);
+
+/**
+ * @brief Striped flush engine used by lv_disp_flush (NULL = esp_lcd_panel_draw_bitmap).
+ *        Feeds it the LV_EVENT_FLUSH_WAIT_* events and adds its bus idle / render stall
+ *        counters to `display show`.
+ */
+void display_setup_set_flush_engine(flush_engine_t* fe);
+
+/* Frame scheduler driving lv_main_task (NULL = fixed LV_DELAY loop), its pacing stats go to `display show` */
+void display_setup_set_frame_sched(frame_sched_t* fs);
+
+/**
+ * @brief A/B measurement: apply each strategy for ms_per_strategy while forcing full-screen
+ *        redraws, log FPS and flush latency for each, then restore the active strategy.
+ *        Runs in its own task; cfgs == NULL uses the built-in strategy list.
+ */
+esp_err_t display_setup_ab_start(const display_buf_config_t* cfgs, size_t count, uint32_t ms_per_strategy);
+
+/* Human readable strategy, e.g. "40 lines, internal+DMA, double, partial" */
+void display_setup_describe(const display_buf_config_t* cfg, char* out, size_t out_len);
+
+/* Registers the `display` console command (show / set / save / ab) */
+void display_setup_register_cli(void);
+
+#ifdef __cplusplus
+}
+#endif /* #ifdef __cplusplus */
+
+#endif /* #ifndef DISPLAY_SETUP_H */
@@ -0,0 +1,139 @@
+#include "flush_engine.h"
+
+#include <string.h>
+
+#if defined(ESP_PLATFORM)
+#    include "esp_attr.h"
+#    define FLUSH_ENGINE_ISR_ATTR IRAM_ATTR
+#else
+#    define FLUSH_ENGINE_ISR_ATTR
+#endif /* #if defined(ESP_PLATFORM) */
+
+//---------
+void flush_engine_init(flush_engine_t* fe, const flush_engine_config_t* config, const flush_engine_io_t* io, flush_engine_done_cb_t done_cb, void* done_ctx) {
+    memset(fe, 0, sizeof(*fe));
+    fe->config   = *config;
+    fe->io       = *io;
+    fe->done_cb  = done_cb;
+    fe->done_ctx = done_ctx;
+    if (fe->config.queue_depth == 0) {
+        fe->config.queue_depth = 1;
+    }
+    fe->idle_since_us = fe->config.now_us();
+}
+//---------
+uint32_t flush_engine_stripe_rows(const flush_engine_t* fe, uint32_t width, uint32_t height, uint32_t bytes_per_pixel) {
+    size_t row_bytes = (size_t) width * bytes_per_pixel;
+    if (fe->config.stripe_bytes == 0 || row_bytes == 0) {
+        return height;
+    }
+    uint32_t rows = (uint32_t) (fe->config.stripe_bytes / row_bytes);
+    if (rows == 0) {
+        rows = 1;
+    }
+    // Nu punem mai multe benzi decat incap in coada i80, altfel tx_color ar bloca
+    uint32_t min_rows = (height + fe->config.queue_depth - 1) / fe->config.queue_depth;
+    if (rows < min_rows) {
+        rows = min_rows;
+    }
+    if (rows > height) {
+        rows = height;
+    }
+    return rows;
+}
+//---------
+int flush_engine_flush(flush_engine_t* fe, int x1, int y1, int x2, int y2, const uint8_t* px_map, size_t src_stride, uint32_t bytes_per_pixel) {
+    const uint64_t t0 = fe->config.now_us();
+    if (src_stride != 0 && src_stride != (size_t) (x2 - x1 + 1) * bytes_per_pixel) {
+        // Randurile nu sunt lipite in buffer (DIRECT): trimitem randurile intregi ale ecranului, lipite,
+        // in benzi ca de obicei, nu cate un transfer pe rand (ar depasi coada si ar costa overhead-ul per transfer)
+        px_map -= (size_t) x1 * bytes_per_pixel;
+        x1 = 0;
+        x2 = (int) (src_stride / bytes_per_pixel) - 1;
+    }
+    const uint32_t w         = (uint32_t) (x2 - x1 + 1);
+    const uint32_t h         = (uint32_t) (y2 - y1 + 1);
+    const size_t   row_bytes = (size_t) w * bytes_per_pixel;
+    const uint32_t rows      = flush_engine_stripe_rows(fe, w, h, bytes_per_pixel);
+    const uint32_t n         = (h + rows - 1) / rows;
+
+    fe->stats.areas++;
+    if (fe->idle_since_us) {
+        fe->stats.bus_idle_us += t0 - fe->idle_since_us;
+        fe->idle_since_us = 0;
+    }
+
+    int ret = fe->io.set_window(fe->io.io, x1, y1, x2, y2);
+    if (ret < 0) {
+        // Nimic in coada: LVGL nu trebuie lasat sa astepte un trans_done care nu vine
+        fe->idle_since_us = fe->config.now_us();
+        if (fe->done_cb) {
+            fe->done_cb(fe->done_ctx);
+        }
+        return ret;
+    }
+
+    // pending trebuie setat inainte de prima banda: ISR-ul poate termina banda 0 inainte sa punem banda 1
+    __atomic_store_n(&fe->pending, n, __ATOMIC_RELEASE);
+    fe->busy_since_us = fe->config.now_us();
+
+    for (uint32_t i = 0; i < n; i++) {
+        uint32_t stripe_rows = (i == n - 1) ? h - i * rows : rows;
+        uint32_t queued      = __atomic_add_fetch(&fe->in_flight, 1, __ATOMIC_ACQ_REL);
+        if (queued > fe->stats.max_in_flight) {
+            fe->stats.max_in_flight = queued;
+        }
+        fe->stats.stripes++;
+        ret = fe->io.tx_color(fe->io.io, i == 0, px_map + (size_t) i * rows * row_bytes, (size_t) stripe_rows * row_bytes);
+        if (ret < 0) {
+            // Benzile care nu au intrat in coada nu vor avea trans_done
+            __atomic_sub_fetch(&fe->in_flight, 1, __ATOMIC_ACQ_REL);
+            if (__atomic_sub_fetch(&fe->pending, n - i, __ATOMIC_ACQ_REL) == 0) {
+                fe->idle_since_us = fe->config.now_us();
+                if (fe->done_cb) {
+                    fe->done_cb(fe->done_ctx);
+                }
+            }
+            break;
+        }
+    }
+
+    fe->stats.flush_cb_us += fe->config.now_us() - t0;
+    return ret < 0 ? ret : 0;
+}
+//---------
+bool FLUSH_ENGINE_ISR_ATTR flush_engine_on_trans_done(flush_engine_t* fe) {
+    __atomic_sub_fetch(&fe->in_flight, 1, __ATOMIC_ACQ_REL);
+    if (__atomic_sub_fetch(&fe->pending, 1, __ATOMIC_ACQ_REL) != 0) {
+        return false;
+    }
+    uint64_t now = fe->config.now_us();
+    fe->stats.bus_busy_us += now - fe->busy_since_us;
+    fe->idle_since_us = now;
+    if (fe->done_cb) {
+        fe->done_cb(fe->done_ctx);
+    }
+    return true;
+}
+//---------
+void flush_engine_stall_begin(flush_engine_t* fe) {
+    fe->stall_since_us = fe->config.now_us();
+}
+//---------
+void flush_engine_stall_end(flush_engine_t* fe) {
+    if (fe->stall_since_us) {
+        fe->stats.render_stall_us += fe->config.now_us() - fe->stall_since_us;
+        fe->stall_since_us = 0;
+    }
+}
+//---------
+void flush_engine_get_stats(const flush_engine_t* fe, flush_engine_stats_t* out) {
+    *out = fe->stats;
+}
+//---------
+void flush_engine_reset_stats(flush_engine_t* fe) {
+    memset(&fe->stats, 0, sizeof(fe->stats));
+    if (fe->idle_since_us) {
+        fe->idle_since_us = fe->config.now_us();
+    }
+}
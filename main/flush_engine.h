@@ -0,0 +1,98 @@
+#pragma once
+#ifndef FLUSH_ENGINE_H
+#define FLUSH_ENGINE_H
+
+/*
+ * Flush engine: imparte o zona LVGL in benzi (stripes) de marimea unui transfer DMA
+ * si le pune in coada i80 una dupa alta, fara sa astepte magistrala intre ele.
+ *
+ * Fereastra (CASET/RASET) se trimite o singura data, prima banda merge cu RAMWR,
+ * restul cu RAMWRC (write memory continue), deci nu se mai asteapta golirea cozii
+ * ca la esp_lcd_panel_draw_bitmap pentru fiecare bucata. Cache sync-ul pentru PSRAM
+ * al benzii N+1 se suprapune cu DMA-ul benzii N.
+ *
+ * Nu depinde de ESP-IDF: IO-ul si ceasul vin prin pointeri la functii, asa ca
+ * acelasi cod ruleaza pe placa (esp_lcd_panel_io) si pe host (mock_panel).
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* #ifdef __cplusplus */
+
+typedef struct {
+    /* Set the panel window (inclusive coords). Blocking, only called while the bus is idle */
+    int (*set_window)(void* io, int x1, int y1, int x2, int y2);
+    /* Queue one color transfer; first == true -> RAMWR, else RAMWRC (continue) */
+    int (*tx_color)(void* io, bool first, const void* data, size_t len);
+    void* io;
+} flush_engine_io_t;
+
+typedef struct {
+    size_t   stripe_bytes;  // Max bytes per transfer (rounded down to whole rows), 0 = whole area
+    uint32_t queue_depth;   // Same as esp_lcd_panel_io_i80_config_t.trans_queue_depth
+    uint64_t (*now_us)(void);
+} flush_engine_config_t;
+
+typedef struct {
+    uint32_t areas;            // flush_cb calls
+    uint32_t stripes;          // Transfers queued
+    uint32_t max_in_flight;    // Highest number of queued stripes
+    uint64_t bus_busy_us;      // First stripe queued -> last stripe done, summed
+    uint64_t bus_idle_us;      // Last stripe done -> next stripe queued, summed
+    uint64_t render_stall_us;  // LVGL waiting for a flush to finish (LV_EVENT_FLUSH_WAIT_*)
+    uint64_t flush_cb_us;      // Time spent inside flush_engine_flush (window + cache sync + queue)
+} flush_engine_stats_t;
+
+typedef void (*flush_engine_done_cb_t)(void* user_ctx);
+
+typedef struct {
+    flush_engine_config_t  config;
+    flush_engine_io_t      io;
+    flush_engine_done_cb_t done_cb;
+    void*                  done_ctx;
+    volatile uint32_t      pending;  // Stripes of the current area not yet done (__atomic_*)
+    volatile uint32_t      in_flight;
+    uint64_t               busy_since_us;
+    uint64_t               idle_since_us;
+    uint64_t               stall_since_us;
+    flush_engine_stats_t   stats;
+} flush_engine_t;
+
+void flush_engine_init(flush_engine_t* fe, const flush_engine_config_t* config, const flush_engine_io_t* io, flush_engine_done_cb_t done_cb, void* done_ctx);
+
+/**
+ * @brief Send one LVGL area (inclusive coords) as stripes.
+ *        px_map points at pixel (x1, y1); rows are src_stride bytes apart, 0 = tightly packed
+ *        (PARTIAL / FULL). With a wider stride px_map is inside a buffer of whole screen rows
+ *        (DIRECT): the area is widened to those rows, x = 0 .. src_stride / bytes_per_pixel - 1,
+ *        so they are contiguous and go out in the usual stripes.
+ *        done_cb is called from flush_engine_on_trans_done() once the last stripe is out,
+ *        or right away if the IO rejected the window / a transfer (nothing left in flight).
+ * @return 0 on success, <0 if the IO rejected the window or a transfer
+ */
+int flush_engine_flush(flush_engine_t* fe, int x1, int y1, int x2, int y2, const uint8_t* px_map, size_t src_stride, uint32_t bytes_per_pixel);
+
+/**
+ * @brief Call from on_color_trans_done (ISR on the board). Returns true when the area completed.
+ */
+bool flush_engine_on_trans_done(flush_engine_t* fe);
+
+/* LV_EVENT_FLUSH_WAIT_START / LV_EVENT_FLUSH_WAIT_FINISH */
+void flush_engine_stall_begin(flush_engine_t* fe);
+void flush_engine_stall_end(flush_engine_t* fe);
+
+/* Rows per stripe the engine will use for an area of the given size */
+uint32_t flush_engine_stripe_rows(const flush_engine_t* fe, uint32_t width, uint32_t height, uint32_t bytes_per_pixel);
+
+void flush_engine_get_stats(const flush_engine_t* fe, flush_engine_stats_t* out);
+void flush_engine_reset_stats(flush_engine_t* fe);
+
+#ifdef __cplusplus
+}
+#endif /* #ifdef __cplusplus */
+
+#endif /* #ifndef FLUSH_ENGINE_H */
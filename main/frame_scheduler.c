@@ -0,0 +1,121 @@
+#include "frame_scheduler.h"
+
+#include <string.h>
+
+#define FRAME_SCHED_DEFAULT_IDLE_MS (100)
+
+//---------
+static uint32_t frame_sched_period_us(uint32_t target_fps) {
+    return target_fps ? (1000000u + target_fps / 2) / target_fps : 0;
+}
+//---------
+void frame_sched_init(frame_sched_t* fs, const frame_sched_config_t* config, const frame_sched_port_t* port) {
+    memset(fs, 0, sizeof(*fs));
+    fs->config = *config;
+    fs->port   = *port;
+    if (fs->config.max_idle_ms == 0) {
+        fs->config.max_idle_ms = FRAME_SCHED_DEFAULT_IDLE_MS;
+    }
+    if (!fs->port.wait_te) {
+        fs->config.use_te = false;
+    }
+    fs->frame_us = frame_sched_period_us(fs->config.target_fps);
+}
+//---------
+void frame_sched_set_target_fps(frame_sched_t* fs, uint32_t target_fps) {
+    fs->config.target_fps = target_fps;
+    fs->frame_us          = frame_sched_period_us(target_fps);
+    fs->started           = false;
+}
+//---------
+uint32_t frame_sched_sleep_for(const frame_sched_t* fs, uint64_t now, uint32_t timer_ms, bool dirty) {
+    uint64_t sleep = (uint64_t) fs->config.max_idle_ms * 1000u;
+    if (timer_ms != FRAME_SCHED_NO_TIMER && (uint64_t) timer_ms * 1000u < sleep) {
+        sleep = (uint64_t) timer_ms * 1000u;
+    }
+    if (dirty) {
+        // Ceva de desenat: doar pana la slotul urmator
+        uint64_t until_frame = fs->next_frame_us > now ? fs->next_frame_us - now : 0;
+        if (until_frame < sleep) {
+            sleep = until_frame;
+        }
+    }
+    return (uint32_t) sleep;
+}
+//---------
+static void frame_sched_render(frame_sched_t* fs) {
+    if (fs->config.use_te) {
+        uint32_t timeout = fs->config.te_timeout_us ? fs->config.te_timeout_us : (fs->frame_us ? 2 * fs->frame_us : 40000u);
+        uint64_t t       = fs->port.now_us(fs->port.ctx);
+        if (!fs->port.wait_te(fs->port.ctx, timeout)) {
+            fs->stats.te_timeouts++;
+        }
+        fs->stats.te_wait_us += fs->port.now_us(fs->port.ctx) - t;
+    }
+
+    uint64_t t0 = fs->port.now_us(fs->port.ctx);
+    fs->port.render(fs->port.ctx);
+    uint64_t t1 = fs->port.now_us(fs->port.ctx);
+    uint32_t dt = (uint32_t) (t1 - t0);
+
+    fs->stats.frames++;
+    fs->stats.render_us += dt;
+    if (dt > fs->stats.max_render_us) {
+        fs->stats.max_render_us = dt;
+    }
+    if (!fs->frame_us) {
+        fs->next_frame_us = t1;
+        return;
+    }
+    if (dt > fs->frame_us) {
+        fs->stats.overruns++;
+    }
+    if (fs->config.use_te) {
+        // Faza o da TE-ul: ne trezim cu un sfert de frame inainte de pulsul urmator
+        fs->next_frame_us = t0 + fs->frame_us - fs->frame_us / 4;
+    } else {
+        fs->next_frame_us += fs->frame_us;
+    }
+    if (fs->next_frame_us <= t1) {
+        // Frame-ul a depasit slotul: sarim peste sloturile pierdute, faza ramane aceeasi
+        uint64_t missed = (t1 - fs->next_frame_us) / fs->frame_us + 1;
+        fs->stats.skipped_slots += (uint32_t) missed;
+        fs->next_frame_us += missed * fs->frame_us;
+    }
+}
+//---------
+uint32_t frame_sched_run_once(frame_sched_t* fs) {
+    void* ctx = fs->port.ctx;
+    if (!fs->started) {
+        fs->next_frame_us = fs->port.now_us(ctx);
+        fs->started       = true;
+    }
+    fs->stats.wakeups++;
+
+    uint32_t timer_ms = fs->port.run_timers(ctx);
+    uint64_t now      = fs->port.now_us(ctx);
+    bool     dirty    = fs->port.frame_dirty(ctx);
+    if (dirty && now >= fs->next_frame_us) {
+        if (fs->frame_us && now - fs->next_frame_us >= fs->frame_us) {
+            fs->next_frame_us = now;  // Dupa idle nu e slot pierdut, faza porneste de aici
+        }
+        frame_sched_render(fs);
+        now   = fs->port.now_us(ctx);
+        dirty = fs->port.frame_dirty(ctx);
+    }
+
+    uint32_t sleep = frame_sched_sleep_for(fs, now, timer_ms, dirty);
+    if (sleep) {
+        fs->port.sleep_us(ctx, sleep);
+        fs->stats.idle_us += sleep;
+    }
+    return sleep;
+}
+//---------
+void frame_sched_get_stats(const frame_sched_t* fs, frame_sched_stats_t* out) {
+    *out = fs->stats;
+}
+//---------
+void frame_sched_reset_stats(frame_sched_t* fs) {
+    memset(&fs->stats, 0, sizeof(fs->stats));
+}
@@ -0,0 +1,89 @@
+#pragma once
+#ifndef FRAME_SCHEDULER_H
+#define FRAME_SCHEDULER_H
+
+/*
+ * Frame scheduler pentru lv_main_task: in loc de lv_timer_handler la fiecare 5 ms,
+ * desenarea porneste doar in sloturi de frame (target_fps sau pulsul TE de la ST7789),
+ * iar intre ele task-ul doarme pana la urmatorul timer LVGL.
+ *
+ * Nu depinde de FreeRTOS / LVGL: ceasul, somnul, TE-ul si LVGL-ul vin prin
+ * frame_sched_port_t, deci aceeasi logica ruleaza pe host cu un ceas simulat
+ * (host/bench_frame_sched.c).
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* #ifdef __cplusplus */
+
+#define FRAME_SCHED_NO_TIMER (0xFFFFFFFFu)  // Same value as LV_NO_TIMER_READY
+
+typedef struct {
+    uint32_t target_fps;     // Frame slots per second, 0 = render as soon as something is invalidated
+    uint32_t max_idle_ms;    // Longest sleep when no LVGL timer is due, 0 = 100 ms
+    bool     use_te;         // Start every frame on a TE pulse (port.wait_te must be set)
+    uint32_t te_timeout_us;  // Give up waiting for TE after this long, 0 = two frame periods
+} frame_sched_config_t;
+
+typedef struct {
+    uint64_t (*now_us)(void* ctx);
+    /* lv_timer_handler() without the display refresh; ms until the next timer or FRAME_SCHED_NO_TIMER */
+    uint32_t (*run_timers)(void* ctx);
+    /* Something was invalidated or an animation is running */
+    bool (*frame_dirty)(void* ctx);
+    /* Animations + refresh of the invalidated areas */
+    void (*render)(void* ctx);
+    /* Sleep up to us microseconds, may return earlier (new invalidation from another task) */
+    void (*sleep_us)(void* ctx, uint32_t us);
+    /* Wait for the next TE pulse, false on timeout. NULL = no TE line */
+    bool (*wait_te)(void* ctx, uint32_t timeout_us);
+    void* ctx;
+} frame_sched_port_t;
+
+typedef struct {
+    uint32_t frames;         // render() calls
+    uint32_t overruns;       // Frames whose render took longer than the frame budget
+    uint32_t skipped_slots;  // Frame slots lost because a frame ended late
+    uint32_t te_timeouts;    // wait_te() gave up
+    uint32_t wakeups;        // Scheduler iterations (one lv_timer_handler each)
+    uint32_t max_render_us;  // Longest render()
+    uint64_t render_us;      // Total time in render()
+    uint64_t te_wait_us;     // Total time waiting for TE
+    uint64_t idle_us;        // Total time requested from sleep_us()
+} frame_sched_stats_t;
+
+typedef struct {
+    frame_sched_config_t config;
+    frame_sched_port_t   port;
+    uint32_t             frame_us;  // 0 when target_fps == 0
+    uint64_t             next_frame_us;
+    bool                 started;
+    frame_sched_stats_t  stats;
+} frame_sched_t;
+
+void frame_sched_init(frame_sched_t* fs, const frame_sched_config_t* config, const frame_sched_port_t* port);
+
+/* Change the frame rate at runtime (0 = unpaced), the next slot starts now */
+void frame_sched_set_target_fps(frame_sched_t* fs, uint32_t target_fps);
+
+/**
+ * @brief One scheduler iteration: run LVGL timers, render if a frame slot is due
+ *        and something is dirty, then sleep until the next frame slot or LVGL timer.
+ * @return Microseconds passed to sleep_us() (0 = did not sleep)
+ */
+uint32_t frame_sched_run_once(frame_sched_t* fs);
+
+/* How long run_once() would sleep at `now`, given the next LVGL timer and the dirty flag */
+uint32_t frame_sched_sleep_for(const frame_sched_t* fs, uint64_t now, uint32_t timer_ms, bool dirty);
+
+void frame_sched_get_stats(const frame_sched_t* fs, frame_sched_stats_t* out);
+void frame_sched_reset_stats(frame_sched_t* fs);
+
+#ifdef __cplusplus
+}
+#endif /* #ifdef __cplusplus */
+
+#endif /* #ifndef FRAME_SCHEDULER_H */
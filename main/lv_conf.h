@@ -225,10 +225,11 @@
         #define LV_DRAW_SW_CIRCLE_CACHE_SIZE 16 // 4
     #endif
 
-    #define  LV_USE_DRAW_SW_ASM     LV_DRAW_SW_ASM_NONE
+    /* Blend-urile spre RGB565 / RGB565_SWAPPED din mylibs/lv-blend-v001 (PIE pe ESP32-S3 + C) */
+    #define  LV_USE_DRAW_SW_ASM     LV_DRAW_SW_ASM_CUSTOM
 
     #if LV_USE_DRAW_SW_ASM == LV_DRAW_SW_ASM_CUSTOM
-        #define  LV_DRAW_SW_ASM_CUSTOM_INCLUDE ""
+        #define  LV_DRAW_SW_ASM_CUSTOM_INCLUDE "lv_blend_esp.h"
     #endif /* #if LV_USE_DRAW_SW_ASM == LV_DRAW_SW_ASM_CUSTOM */
 
     /* Enable drawing complex gradients in software: linear at an angle, radial or conical */
@@ -38,6 +38,13 @@
 #define LV_DELAY            TICK_INCREMENTATION
 #define LV_NO_OOP           esp_rom_delay_us(100);
 
+/* lv_main_task inlocuit de frame_scheduler.h: desenare in sloturi de frame (sau pe TE),
+   somn pana la urmatorul timer LVGL in loc de polling la LV_DELAY */
+#define frame_scheduler
+#define FRAME_TARGET_FPS  (60)   // 0 = deseneaza imediat ce s-a invalidat ceva
+#define FRAME_MAX_IDLE_MS (100)  // cel mai lung somn cand nu e niciun timer LVGL
+#define BOARD_TFT_TE      (-1)   // GPIO pentru TE (ST7789), -1 = nu e legat pe T-HMI
+
 //-----------------------------------------------------------
 #define LV_TICK_SOURCE_TIMER    0
 #define LV_TICK_SOURCE_TASK     1
@@ -55,6 +62,13 @@
 #define flush_ready_in_io_trans_done  // mult mai bine asa deoarece se da flush ready in momentul cand display face trans_done
 //---------
 
+/* Zona trimisa in benzi DMA (flush_engine.h) in loc de un singur draw_bitmap.
+   Merge doar impreuna cu flush_ready_in_io_trans_done */
+#define flush_in_stripes
+#define FLUSH_STRIPE_BYTES    (8 * 1024)  // marimea unei benzi, rotunjita la randuri intregi
+#define LCD_TRANS_QUEUE_DEPTH (10)        // esp_lcd_panel_io_i80_config_t.trans_queue_depth
+//---------
+
 //-----------------------------------------------------------
 
 //---------
@@ -62,32 +76,24 @@
 //-----------------------------------------------------------
 
 /* BUFFER MODE */
-#define BUFFER_20LINES     1
-#define BUFFER_40LINES     2
-#define BUFFER_60LINES     3  // merge
-#define BUFFER_DEVIDED4    4
-#define BUFFER_FULL        5            // merge super ok
+// Constantele BUFFER_* / RENDER_MODE_* sunt in display_modes.h (folosite si de host/)
+// Valorile de aici sunt doar strategia implicita, vezi display_setup.h (NVS / comanda `display`)
+#include "display_modes.h"
 #define BUFFER_MODE        BUFFER_FULL  // selecteaza modul de buffer , defaut este BUFFER_FULL
 #define DOUBLE_BUFFER_MODE true
 //---------
 /* BUFFER MEMORY TYPE AND DMA */
-#define BUFFER_INTERNAL 1
-#define BUFFER_SPIRAM   2
-#define BUFFER_MEM      BUFFER_SPIRAM
-#if (BUFFER_MEM == BUFFER_INTERNAL)
-#    define DMA_ON (true)
-#endif /* #if (BUFFER_MEM == BUFFER_INTERNAL) */
+#define BUFFER_MEM BUFFER_SPIRAM  // BUFFER_INTERNAL inseamna INTERNAL + DMA
 //---------
 
 //-----------------------------------------------------------
 /* RENDER MODE */
-// Aici e mod mai special pt ca se transmite direct functiei....
-#define RENDER_MODE_PARTIAL (LV_DISPLAY_RENDER_MODE_PARTIAL)
-#define RENDER_MODE_FULL    (LV_DISPLAY_RENDER_MODE_FULL)
-#define RENDER_MODE_DIRECT  (LV_DISPLAY_RENDER_MODE_DIRECT)
-
 #define RENDER_MODE (RENDER_MODE_PARTIAL)
 //--------------------- --------------------------------------
+/* COLOR MODE */
+// RGB565_SWAPPED: LVGL scrie pixelii deja in ordinea ST7789, i80 nu mai inverseaza byte-ii (swap_color_bytes = 0)
+#define COLOR_MODE (COLOR_MODE_RGB565_SWAPPED)
+//---------
 
 //---------
 
@@ -110,6 +116,7 @@ extern "C" {
 #include "lvgl.h"
 #include <lv_conf.h>
 
+#include "esp_lcd_panel_commands.h"
 #include "esp_lcd_panel_io.h"
 #include "esp_lcd_panel_ops.h"
 #include "esp_lcd_panel_st7789.h"  // Sau driverul real folosit de tine
@@ -120,6 +127,10 @@ extern "C" {
 #include "one-cli.h"
 #include "filesystem-os.h"
 #include "ui.h"
+#include "display_setup.h"
+#include "flush_engine.h"
+#include "frame_scheduler.h"
+#include "ui_queue.h"
 }
 /**********************
  *   GLOBAL VARIABLES
@@ -240,20 +251,70 @@ bool touch_panel_is_touched(void) {
 /**********************
  *   LVGL VARIABLES
  **********************/
-uint32_t      bufSize;           // Dimensiunea buffer-ului
-lv_color_t*   disp_draw_buf;     // Buffer LVGL
-lv_color_t*   disp_draw_buf_II;  // Buffer LVGL secundar
-lv_display_t* disp;              // Display LVGL
+lv_display_t* disp;  // Display LVGL (bufferele sunt in display_setup.c)
+
+#ifdef flush_in_stripes
+#    ifndef LCD_CMD_RAMWRC
+#        define LCD_CMD_RAMWRC 0x3C  // Memory write continue
+#    endif /* #ifndef LCD_CMD_RAMWRC */
+static flush_engine_t s_flush_engine;
+#endif /* #ifdef flush_in_stripes */
 
 /**********************
  *   LVGL FUNCTIONS
  **********************/
 
+#ifdef flush_in_stripes
+/* flush_engine IO peste esp_lcd: CASET/RASET o data, apoi RAMWR + RAMWRC pentru benzi */
+static int lcd_flush_set_window(void* io, int x1, int y1, int x2, int y2) {
+    esp_lcd_panel_io_handle_t handle   = (esp_lcd_panel_io_handle_t) io;
+    uint8_t                   caset[4] = {(uint8_t) (x1 >> 8), (uint8_t) x1, (uint8_t) (x2 >> 8), (uint8_t) x2};
+    uint8_t                   raset[4] = {(uint8_t) (y1 >> 8), (uint8_t) y1, (uint8_t) (y2 >> 8), (uint8_t) y2};
+    if (esp_lcd_panel_io_tx_param(handle, LCD_CMD_CASET, caset, sizeof(caset)) != ESP_OK) {
+        return -1;
+    }
+    return esp_lcd_panel_io_tx_param(handle, LCD_CMD_RASET, raset, sizeof(raset)) == ESP_OK ? 0 : -1;
+}
+//---------
+static int lcd_flush_tx_color(void* io, bool first, const void* data, size_t len) {
+    return esp_lcd_panel_io_tx_color((esp_lcd_panel_io_handle_t) io, first ? LCD_CMD_RAMWR : LCD_CMD_RAMWRC, data, len) == ESP_OK ? 0 : -1;
+}
+//---------
+static uint64_t lcd_flush_now_us(void) {
+    return (uint64_t) esp_timer_get_time();
+}
+//---------
+/* Ultima banda a zonei a plecat: bufferul e liber pentru LVGL */
+static void IRAM_ATTR lcd_flush_done(void* user_ctx) {
+    display_setup_flush_done();
+    lv_disp_flush_ready((lv_display_t*) user_ctx);
+}
+#endif /* #ifdef flush_in_stripes */
+//---------
+
 /* Display flushing function callback */
 void lv_disp_flush(lv_display_t* disp, const lv_area_t* area, uint8_t* px_map) { /* #if LVGL_BENCH_TEST */
-    esp_lcd_panel_draw_bitmap(
-        panel_handle, area->x1, area->y1, area->x2 + 1, area->y2 + 1, (const void*) px_map);
+    display_setup_flush_begin();
+    // In DIRECT px_map e tot bufferul ecranului (stride = un rand de ecran), nu doar zona
+    const bool   direct = display_setup_get_config()->render_mode == LV_DISPLAY_RENDER_MODE_DIRECT;
+    const size_t stride = direct ? lv_display_get_buf_active(disp)->header.stride : 0;
+#ifdef flush_in_stripes
+    if (direct) {
+        px_map += (size_t) area->y1 * stride + (size_t) area->x1 * sizeof(uint16_t);
+    }
+    flush_engine_flush(&s_flush_engine, area->x1, area->y1, area->x2, area->y2, px_map, stride, sizeof(uint16_t));
+#else
+    if (direct) {
+        // draw_bitmap vrea pixelii lipiti: randurile intregi ale zonei, tot un singur transfer (un singur trans_done)
+        esp_lcd_panel_draw_bitmap(panel_handle, 0, area->y1, lv_display_get_horizontal_resolution(disp), area->y2 + 1,
+            (const void*) (px_map + (size_t) area->y1 * stride));
+    } else {
+        esp_lcd_panel_draw_bitmap(
+            panel_handle, area->x1, area->y1, area->x2 + 1, area->y2 + 1, (const void*) px_map);
+    }
+#endif /* #ifdef flush_in_stripes */
 #ifdef flush_ready_in_disp_flush
+    display_setup_flush_done();
     lv_disp_flush_ready(disp);
 #endif /* #ifdef (flush_ready_in_disp_flush) */
 }
@@ -311,11 +372,14 @@ void lv_touchpad_read_v2(lv_indev_t* indev_drv, lv_indev_data_t* data) {
 }
 //---------
 bool panel_io_trans_done_callback(esp_lcd_panel_io_handle_t panel_io, esp_lcd_panel_io_event_data_t* edata, void* user_ctx) {
-#ifdef flush_ready_in_io_trans_done
+#if defined(flush_ready_in_io_trans_done) && defined(flush_in_stripes)
+    flush_engine_on_trans_done(&s_flush_engine);  // flush ready doar dupa ultima banda
+#elif defined(flush_ready_in_io_trans_done)
     lv_display_t* d = (lv_display_t*) user_ctx;
+    display_setup_flush_done();
     if (d)
         lv_disp_flush_ready(d);
-#endif /* #ifdef flush_ready_in_io_trans_done */
+#endif /* #if defined(flush_ready_in_io_trans_done) */
     return false;
 }
 //---------
@@ -364,6 +428,21 @@ void s_lvgl_unlock(void) {
 
 // -------------------------------
 
+// Task-urile din afara LVGL (sysmon, CLI ...) schimba UI-ul prin coada asta, fara s_lvgl_mutex.
+// Mutex-ul ramane pentru cine are nevoie de LVGL sincron (comanda `display`, initializarea).
+static ui_queue_t s_ui_queue;
+
+#ifdef frame_scheduler
+static void s_ui_queue_wake(void* ctx) {
+    // Cu frame_scheduler task-ul LVGL poate dormi pana la FRAME_MAX_IDLE_MS, il trezim sa goleasca coada
+    if (xHandle_lv_main_task && xTaskGetCurrentTaskHandle() != xHandle_lv_main_task) {
+        xTaskNotifyGive(xHandle_lv_main_task);
+    }
+}
+#endif /* #ifdef frame_scheduler */
+
+// -------------------------------
+
 // -------------------------------
 
 /************************************************** */
@@ -395,6 +474,7 @@ void lv_main_task(void* parameter) {
     tick                   = xTaskGetTickCount();
     while (true) {
         if (s_lvgl_lock(portMAX_DELAY)) {
+            ui_queue_drain(&s_ui_queue);
             lv_timer_handler();
             // xTaskGenericNotifyFromISR(xHandle_lv_main_task, tskDEFAULT_INDEX_TO_NOTIFY, 0x01, eSetBits);
         }
@@ -425,6 +505,7 @@ void lv_main_task(void* parameter) {
     tick                   = xTaskGetTickCount();  // Inițializare corectă
     while (true) {
         if (s_lvgl_lock(portMAX_DELAY)) {  // <— ADD
+            ui_queue_drain(&s_ui_queue);
             lv_timer_handler();
             s_lvgl_unlock();  // <— ADD
         }
@@ -443,6 +524,7 @@ void lv_main_task(void* parameter) {
     tick                   = xTaskGetTickCount();  // Inițializare corectă
     while (true) {
         if (s_lvgl_lock(portMAX_DELAY)) {  // <— ADD
+            ui_queue_drain(&s_ui_queue);
             lv_timer_handler();
             s_lvgl_unlock();  // <— ADD
         }
@@ -452,6 +534,137 @@ void lv_main_task(void* parameter) {
 
 #endif /* #if LV_TICK_SOURCE == LV_TICK_SOURCE_TIMER */
 
+#ifdef frame_scheduler
+#    ifndef LCD_CMD_TEON
+#        define LCD_CMD_TEON 0x35  // Tearing effect line on
+#    endif /* #ifndef LCD_CMD_TEON */
+static frame_sched_t     s_frame_sched;
+static volatile bool     s_frame_dirty = true;
+static SemaphoreHandle_t s_te_sem      = NULL;
+
+/* frame_sched_port_t pe FreeRTOS + LVGL */
+static uint64_t frame_port_now_us(void* ctx) {
+    return (uint64_t) esp_timer_get_time();
+}
+//---------
+static uint32_t frame_port_run_timers(void* ctx) {
+    uint32_t next_ms = FRAME_SCHED_NO_TIMER;
+    if (s_lvgl_lock(portMAX_DELAY)) {
+        ui_queue_drain(&s_ui_queue);  // invalidarile lor intra in frame-ul de acum
+        next_ms = lv_timer_handler();
+        s_lvgl_unlock();
+    }
+    return next_ms;
+}
+//---------
+static bool frame_port_frame_dirty(void* ctx) {
+    bool anim = false;
+    if (s_lvgl_lock(portMAX_DELAY)) {
+        anim = lv_anim_count_running() > 0;
+        s_lvgl_unlock();
+    }
+    return s_frame_dirty || anim;
+}
+//---------
+static void frame_port_render(void* ctx) {
+    if (s_lvgl_lock(portMAX_DELAY)) {
+        s_frame_dirty = false;
+        lv_refr_now(disp);  // animatii + zonele invalidate
+        s_lvgl_unlock();
+    }
+}
+//---------
+static void frame_port_sleep_us(void* ctx, uint32_t us) {
+    TickType_t ticks = pdMS_TO_TICKS((us + 999) / 1000);
+    ulTaskNotifyTake(pdTRUE, ticks ? ticks : 1);  // trezit mai devreme de frame_refr_request_cb
+}
+//---------
+static bool frame_port_wait_te(void* ctx, uint32_t timeout_us) {
+    xSemaphoreTake(s_te_sem, 0);  // un puls vechi nu conteaza
+    return xSemaphoreTake(s_te_sem, pdMS_TO_TICKS((timeout_us + 999) / 1000)) == pdTRUE;
+}
+//---------
+static void IRAM_ATTR frame_te_isr_handler(void* arg) {
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+    xSemaphoreGiveFromISR(s_te_sem, &xHigherPriorityTaskWoken);
+    if (xHigherPriorityTaskWoken) {
+        portYIELD_FROM_ISR();
+    }
+}
+//---------
+/* LVGL reporneste refr_timer la fiecare invalidare; il oprim, desenarea o porneste frame_sched */
+static void frame_refr_request_cb(lv_event_t* e) {
+    lv_timer_pause(lv_display_get_refr_timer(disp));
+    s_frame_dirty = true;
+    if (xHandle_lv_main_task && xTaskGetCurrentTaskHandle() != xHandle_lv_main_task) {
+        xTaskNotifyGive(xHandle_lv_main_task);
+    }
+}
+//---------
+static void frame_te_init(void) {
+    if (BOARD_TFT_TE < 0) {
+        return;
+    }
+    s_te_sem                = xSemaphoreCreateBinary();
+    gpio_config_t te_config = {
+        .pin_bit_mask = 1ULL << BOARD_TFT_TE,
+        .mode         = GPIO_MODE_INPUT,
+        .pull_up_en   = GPIO_PULLUP_DISABLE,
+        .pull_down_en = GPIO_PULLDOWN_DISABLE,
+        .intr_type    = GPIO_INTR_POSEDGE,  // inceputul v-blank
+    };
+    gpio_config(&te_config);
+    gpio_install_isr_service(ESP_INTR_FLAG_LEVEL1);  // ESP_ERR_INVALID_STATE daca exista deja
+    gpio_isr_handler_add((gpio_num_t) BOARD_TFT_TE, frame_te_isr_handler, NULL);
+    uint8_t te_mode = 0;  // doar V-blank
+    esp_lcd_panel_io_tx_param(lcd_io_handle, LCD_CMD_TEON, &te_mode, 1);
+}
+
+/********************************************** */
+/*                   TASK                       */
+/********************************************** */
+void lv_frame_task(void* parameter) {
+    xHandle_lv_main_task = xTaskGetCurrentTaskHandle();
+    frame_te_init();
+    if (s_lvgl_lock(portMAX_DELAY)) {
+        // Animatiile si touch-ul nu mai au nevoie de perioada de 1 ms (LV_DEF_REFR_PERIOD)
+        lv_timer_set_period(lv_anim_get_timer(), 1000 / (FRAME_TARGET_FPS ? FRAME_TARGET_FPS : 100));
+        lv_indev_t* indev = lv_indev_get_next(NULL);
+        if (indev) {
+            lv_timer_set_period(lv_indev_get_read_timer(indev), 1000 / (FRAME_TARGET_FPS ? FRAME_TARGET_FPS : 100));
+        }
+        lv_display_add_event_cb(disp, frame_refr_request_cb, LV_EVENT_REFR_REQUEST, NULL);
+        lv_timer_pause(lv_display_get_refr_timer(disp));
+        s_lvgl_unlock();
+    }
+    frame_sched_config_t config = {
+        .target_fps    = FRAME_TARGET_FPS,
+        .max_idle_ms   = FRAME_MAX_IDLE_MS,
+        .use_te        = (BOARD_TFT_TE >= 0),
+        .te_timeout_us = 0,
+    };
+    frame_sched_port_t port = {
+        .now_us      = frame_port_now_us,
+        .run_timers  = frame_port_run_timers,
+        .frame_dirty = frame_port_frame_dirty,
+        .render      = frame_port_render,
+        .sleep_us    = frame_port_sleep_us,
+        .wait_te     = (BOARD_TFT_TE >= 0) ? frame_port_wait_te : NULL,
+        .ctx         = NULL,
+    };
+    frame_sched_init(&s_frame_sched, &config, &port);
+    display_setup_set_frame_sched(&s_frame_sched);
+    while (true) {
+        if (frame_sched_run_once(&s_frame_sched) == 0) {
+            vTaskDelay(1);  // fara target_fps nu lasam core 1 fara IDLE
+        }
+    }
+}
+#    define LV_MAIN_TASK_FUNCTION lv_frame_task
+#else
+#    define LV_MAIN_TASK_FUNCTION lv_main_task
+#endif /* #ifdef frame_scheduler */
+
 /********************************************** */
 /*                   TASK                       */
 /********************************************** */
@@ -506,6 +719,10 @@ extern "C" void app_main(void) {
     gfx_set_backlight(1);
     esp_log_level_set("*", ESP_LOG_INFO);
 
+    // Montarea ruleaza pe task-uri, in paralel cu initializarea display-ului; un card SD lent
+    // nu mai intarzie UI-ul. Cine are nevoie de un filesystem il asteapta cu filesystem_wait_path()
+    init_filesystem_sys();
+
     boot_count++;
     // ESP_LOGI("RTC", "Boot count (from RTC RAM): %lu", boot_count);
     // esp_sleep_enable_timer_wakeup(5000000);  // 5 secunde în microsecunde
@@ -523,6 +740,7 @@ extern "C" void app_main(void) {
     // bootloader_desc.idf_ver); printf("\tESP-IDF version from app: %s\n", IDF_VER);
 
     lv_init();
+    filesystem_lv_init();  // "L:/..." citeste din flash-ul mapat, fara copia prin littlefs
 
 #if LV_TICK_SOURCE == LV_TICK_SOURCE_CALLBACK
     // Next function comment because create problems with lvgl timers and esp32 timers
@@ -532,6 +750,8 @@ extern "C" void app_main(void) {
     disp = lv_display_create(
         (int32_t) LCD_WIDTH,
         (int32_t) LCD_HEIGHT);
+    // Inainte de buffere: layer-ele, decodoarele si blend-urile iau formatul de aici
+    lv_display_set_color_format(disp, display_color_mode_format(COLOR_MODE));
 
     esp_lcd_i80_bus_config_t lcd_bus_config = {.dc_gpio_num = (gpio_num_t) BOARD_TFT_DC,
         .wr_gpio_num                                        = (gpio_num_t) BOARD_TFT_WR,
@@ -559,7 +779,7 @@ extern "C" void app_main(void) {
         //.pclk_hz             = 30000000,
         //.pclk_hz             = 26000000,
         .pclk_hz             = 20000000,
-        .trans_queue_depth   = 10,
+        .trans_queue_depth   = LCD_TRANS_QUEUE_DEPTH,
         .on_color_trans_done = panel_io_trans_done_callback,
         .user_ctx            = disp,
         .lcd_cmd_bits        = 8,
@@ -573,7 +793,7 @@ extern "C" void app_main(void) {
         .flags = {
             .cs_active_high     = 0,
             .reverse_color_bits = 0,
-            .swap_color_bytes   = 1,
+            .swap_color_bytes   = display_color_mode_swap_bytes(COLOR_MODE),  // 0 in COLOR_MODE_RGB565_SWAPPED
             .pclk_active_neg    = 0,
             .pclk_idle_low      = 0,
         },
@@ -662,80 +882,47 @@ extern "C" void app_main(void) {
     ESP_ERROR_CHECK(esp_lcd_touch_new_spi_xpt2046(touch_io_handle, &touch_config, &touch_handle));
     ESP_LOGI("LVGL", "Touch panel created");
 
-#if (BUFFER_MODE == BUFFER_FULL)
-    bufSize = ((LCD_WIDTH * LCD_HEIGHT) * lv_color_format_get_size(lv_display_get_color_format(disp)));
-#elif (BUFFER_MODE == BUFFER_60LINES)
-    bufSize = ((LCD_WIDTH * 60) * lv_color_format_get_size(lv_display_get_color_format(disp)));
-#elif (BUFFER_MODE == BUFFER_40LINES)
-    bufSize = ((LCD_WIDTH * 40) * lv_color_format_get_size(lv_display_get_color_format(disp)));
-#elif (BUFFER_MODE == BUFFER_20LINES)
-    bufSize = ((LCD_WIDTH * 20) * lv_color_format_get_size(lv_display_get_color_format(disp)));
-#elif (BUFFER_MODE == BUFFER_DEVIDED4)
-    bufSize = ((LCD_WIDTH * LCD_HEIGHT) * lv_color_format_get_size(lv_display_get_color_format(disp)) / 4);
-#endif
-#if (BUFFER_MEM == BUFFER_SPIRAM)
-#    if (DOUBLE_BUFFER_MODE == 1)
-    disp_draw_buf    = (lv_color_t*) heap_caps_malloc(bufSize, MALLOC_CAP_SPIRAM);
-    disp_draw_buf_II = (lv_color_t*) heap_caps_malloc(bufSize, MALLOC_CAP_SPIRAM);
-    ESP_LOGI("LVGL", "LVGL buffers created in SPIRAM");
-#    else
-    disp_draw_buf = (lv_color_t*) heap_caps_malloc(bufSize, MALLOC_CAP_SPIRAM);
-#    endif
-#elif (BUFFER_MEM == BUFFER_INTERNAL)
-#    if (DMA_ON == 1)
-#        if (DOUBLE_BUFFER_MODE == 1)
-    disp_draw_buf    = (lv_color_t*) heap_caps_malloc(bufSize, MALLOC_CAP_INTERNAL | MALLOC_CAP_DMA);
-    disp_draw_buf_II = (lv_color_t*) heap_caps_malloc(bufSize, MALLOC_CAP_INTERNAL | MALLOC_CAP_DMA);
-    ESP_LOGI("LVGL", "LVGL buffers created in SPIRAM");
-#        else
-    disp_draw_buf = (lv_color_t*) heap_caps_malloc(bufSize, MALLOC_CAP_INTERNAL | MALLOC_CAP_DMA);
-#        endif
-#    else
-#        if (DOUBLE_BUFFER_MODE == 1)
-    disp_draw_buf    = (lv_color_t*) heap_caps_malloc(bufSize, MALLOC_CAP_INTERNAL);
-    disp_draw_buf_II = (lv_color_t*) heap_caps_malloc(bufSize, MALLOC_CAP_INTERNAL);
-    ESP_LOGI("LVGL", "LVGL buffers created in SPIRAM");
-#        else
-    disp_draw_buf = (lv_color_t*) heap_caps_malloc(bufSize, MALLOC_CAP_INTERNAL);
-#        endif
-#    endif
-#endif /* #if (BUFFER_MEM == BUFFER_SPIRAM) */
-
-    // --- memset pentru curățare frame-uri ---
-    // Asta îți garantează că primul frame e complet „negru”
-
-    if (disp_draw_buf) {
-        memset(disp_draw_buf, 0, bufSize);
-    }
-    if (disp_draw_buf_II) {
-        memset(disp_draw_buf_II, 0, bufSize);
-    }
-
-    if (!disp_draw_buf) {  // VERIFICA DACA PRIMUL BUFFER ESTE CREAT
-        ESP_LOGE("LVGL", "LVGL disp_draw_buf allocate failed!");
+    // Strategia de buffer: macro-urile de sus sunt doar valoarea implicita,
+    // NVS (comanda `display save`) o suprascrie fara recompilare
+    display_setup_init(disp, s_lvgl_lock, s_lvgl_unlock);
+    display_buf_config_t buf_cfg = {
+        .lines         = (uint16_t) display_buffer_mode_lines(BUFFER_MODE, LCD_HEIGHT),
+        .mem           = (uint8_t) ((BUFFER_MEM == BUFFER_SPIRAM) ? DISPLAY_BUF_MEM_SPIRAM : DISPLAY_BUF_MEM_INTERNAL_DMA),
+        .render_mode   = (uint8_t) RENDER_MODE,
+        .double_buffer = (DOUBLE_BUFFER_MODE == 1),
+    };
+    if (display_setup_load_nvs(&buf_cfg) == ESP_OK) {
+        ESP_LOGI("LVGL", "LVGL buffer strategy loaded from NVS");
     }
-#if (DOUBLE_BUFFER_MODE == 1)
-    if (!disp_draw_buf_II) {  // VERIFICA DACA AL DOILEA BUFFER ESTE CREAT
-        ESP_LOGE("LVGL", "LVGL disp_draw_buf_II allocate failed!");
+    if (display_setup_apply(&buf_cfg) != ESP_OK) {
+        ESP_LOGE("LVGL", "LVGL buffer strategy rejected, falling back to 40 lines internal+DMA");
+        display_buf_config_t fallback = {
+            .lines = 40, .mem = DISPLAY_BUF_MEM_INTERNAL_DMA, .render_mode = (uint8_t) RENDER_MODE_PARTIAL, .double_buffer = true};
+        ESP_ERROR_CHECK(display_setup_apply(&fallback));
     }
-#endif
-
-#if (DOUBLE_BUFFER_MODE == 1)
-    lv_display_set_buffers(
-        disp, disp_draw_buf, disp_draw_buf_II, bufSize, (lv_display_render_mode_t) RENDER_MODE);
-    ESP_LOGI("LVGL", "LVGL buffers set");
-#else
-    lv_display_set_buffers(disp, disp_draw_buf, NULL, bufSize, (lv_display_render_mode_t) RENDER_MODE);
-#endif
 
     lv_display_set_resolution(disp, LCD_WIDTH, LCD_HEIGHT);           // Seteaza rezolutia software
     lv_display_set_physical_resolution(disp, LCD_WIDTH, LCD_HEIGHT);  // Actualizeaza rezolutia reala
     lv_display_set_rotation(disp, (lv_display_rotation_t) 0);         // Seteaza rotatia lvgl
-    lv_display_set_render_mode(disp,
-        (lv_display_render_mode_t) RENDER_MODE);  // Seteaza (lv_display_render_mode_t)
-    lv_display_set_antialiasing(disp, true);      // Antialiasing DA sau NU
+    lv_display_set_antialiasing(disp, true);                          // Antialiasing DA sau NU
     ESP_LOGI("LVGL", "LVGL display settings done");
 
+#ifdef flush_in_stripes
+    flush_engine_config_t flush_config = {
+        .stripe_bytes = FLUSH_STRIPE_BYTES,
+        .queue_depth  = LCD_TRANS_QUEUE_DEPTH,
+        .now_us       = lcd_flush_now_us,
+    };
+    flush_engine_io_t flush_io = {
+        .set_window = lcd_flush_set_window,
+        .tx_color   = lcd_flush_tx_color,
+        .io         = lcd_io_handle,
+    };
+    flush_engine_init(&s_flush_engine, &flush_config, &flush_io, lcd_flush_done, disp);
+    display_setup_set_flush_engine(&s_flush_engine);
+    ESP_LOGI("LVGL", "LVGL flush in %u byte stripes", (unsigned) FLUSH_STRIPE_BYTES);
+#endif /* #ifdef flush_in_stripes */
+
     lv_display_set_flush_cb(disp, lv_disp_flush);  // Set the flush callback which will be called to
                                                    // copy the rendered image to the display.
     ESP_LOGI("LVGL", "LVGL display flush callback set");
@@ -748,8 +935,16 @@ extern "C" void app_main(void) {
 
     vTaskDelay(500);
 
-    init_filesystem_sys();
+#ifdef frame_scheduler
+    ui_queue_init(&s_ui_queue, s_ui_queue_wake, NULL);
+#else
+    ui_queue_init(&s_ui_queue, NULL, NULL);  // lv_main_task o goleste oricum la fiecare LV_DELAY
+#endif /* #ifdef frame_scheduler */
+    ui_queue_set_default(&s_ui_queue);  // inainte de CLI si de celelalte task-uri care posteaza
+
     // initialize_filesystem_sdmmc() ;
+    cli_set_history_wait(filesystem_wait_path);            // istoricul e pe MOUNT_PATH, montat in fundal
+    cli_add_external_command(display_setup_register_cli);  // comanda `display`
      StartCLI();
 
     s_lvgl_port_init_locking_mutex();
@@ -759,7 +954,7 @@ extern "C" void app_main(void) {
     s_lvgl_unlock();
     esp_rom_delay_us(100);
 
-    xTaskCreatePinnedToCore(lv_main_task,        // Functia task-ului
+    xTaskCreatePinnedToCore(LV_MAIN_TASK_FUNCTION,  // Functia task-ului
         (const char*) "LVGL Main Task",          // Numele task-ului
         (uint32_t) (4096 + 4096),                // Dimensiunea stack-ului
         (NULL),                                  // Parametri (daca exista)
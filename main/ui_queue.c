@@ -0,0 +1,199 @@
+#include "ui_queue.h"
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+#define UI_QUEUE_MASK (UI_QUEUE_DEPTH - 1)
+
+_Static_assert((UI_QUEUE_DEPTH & UI_QUEUE_MASK) == 0, "UI_QUEUE_DEPTH must be a power of 2");
+_Static_assert(UI_QUEUE_DEPTH <= 64, "ui_queue_drain keeps the coalesced slots in a uint64_t");
+
+static ui_queue_t* s_default_queue = NULL;
+
+//---------
+void ui_queue_init(ui_queue_t* q, ui_queue_wake_cb_t wake, void* wake_ctx) {
+    memset(q, 0, sizeof(*q));
+    for (uint32_t i = 0; i < UI_QUEUE_DEPTH; i++) {
+        q->slots[i].seq = i;
+    }
+    q->wake     = wake;
+    q->wake_ctx = wake_ctx;
+}
+//---------
+void ui_queue_set_default(ui_queue_t* q) {
+    s_default_queue = q;
+}
+//---------
+ui_queue_t* ui_queue_get_default(void) {
+    return s_default_queue;
+}
+//---------
+/* Rezerva un slot: CAS pe head doar cand slotul de la head e liber (seq == pos) */
+static ui_cmd_slot_t* ui_queue_claim(ui_queue_t* q, uint32_t* pos_out) {
+    uint32_t pos = __atomic_load_n(&q->head, __ATOMIC_RELAXED);
+    while (true) {
+        ui_cmd_slot_t* slot = &q->slots[pos & UI_QUEUE_MASK];
+        uint32_t       seq  = __atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE);
+        int32_t        dif  = (int32_t) (seq - pos);
+        if (dif == 0) {
+            if (__atomic_compare_exchange_n(&q->head, &pos, pos + 1, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                *pos_out = pos;
+                return slot;
+            }
+            // pos a fost reincarcat de CAS, mai incercam
+        } else if (dif < 0) {
+            __atomic_fetch_add(&q->stats.dropped, 1, __ATOMIC_RELAXED);
+            return NULL;  // plin: consumatorul n-a eliberat inca slotul de acum UI_QUEUE_DEPTH pozitii
+        } else {
+            pos = __atomic_load_n(&q->head, __ATOMIC_RELAXED);  // alt producator a luat slotul
+        }
+    }
+}
+//---------
+static void ui_queue_publish(ui_queue_t* q, ui_cmd_slot_t* slot, uint32_t pos) {
+    __atomic_store_n(&slot->seq, pos + 1, __ATOMIC_RELEASE);
+    __atomic_fetch_add(&q->stats.posted, 1, __ATOMIC_RELAXED);
+    if (q->wake) {
+        q->wake(q->wake_ctx);
+    }
+}
+//---------
+static ui_cmd_slot_t* ui_queue_begin(ui_queue_t** q, uint32_t* pos, uint8_t kind, lv_obj_t* obj) {
+    if (*q == NULL) {
+        *q = s_default_queue;
+    }
+    if (*q == NULL || obj == NULL) {
+        return NULL;
+    }
+    ui_cmd_slot_t* slot = ui_queue_claim(*q, pos);
+    if (slot) {
+        slot->kind = kind;
+        slot->obj  = obj;
+    }
+    return slot;
+}
+//---------
+bool ui_queue_set_text(ui_queue_t* q, lv_obj_t* label, const char* text) {
+    uint32_t       pos;
+    ui_cmd_slot_t* slot = ui_queue_begin(&q, &pos, UI_CMD_SET_TEXT, label);
+    if (!slot) {
+        return false;
+    }
+    size_t len = text ? strnlen(text, UI_QUEUE_TEXT_MAX - 1) : 0;
+    memcpy(slot->arg.text, text ? text : "", len);
+    slot->arg.text[len] = '\0';
+    ui_queue_publish(q, slot, pos);
+    return true;
+}
+//---------
+bool ui_queue_set_text_fmt(ui_queue_t* q, lv_obj_t* label, const char* fmt, ...) {
+    uint32_t       pos;
+    ui_cmd_slot_t* slot = ui_queue_begin(&q, &pos, UI_CMD_SET_TEXT, label);
+    if (!slot) {
+        return false;
+    }
+    va_list args;
+    va_start(args, fmt);
+    vsnprintf(slot->arg.text, sizeof(slot->arg.text), fmt, args);  // direct in slot, fara buffer pe stack
+    va_end(args);
+    ui_queue_publish(q, slot, pos);
+    return true;
+}
+//---------
+bool ui_queue_set_value(ui_queue_t* q, lv_obj_t* obj, int32_t value) {
+    uint32_t       pos;
+    ui_cmd_slot_t* slot = ui_queue_begin(&q, &pos, UI_CMD_SET_VALUE, obj);
+    if (!slot) {
+        return false;
+    }
+    slot->arg.value = value;
+    ui_queue_publish(q, slot, pos);
+    return true;
+}
+//---------
+bool ui_queue_invalidate(ui_queue_t* q, lv_obj_t* obj) {
+    uint32_t       pos;
+    ui_cmd_slot_t* slot = ui_queue_begin(&q, &pos, UI_CMD_INVALIDATE, obj);
+    if (!slot) {
+        return false;
+    }
+    ui_queue_publish(q, slot, pos);
+    return true;
+}
+//---------
+bool ui_queue_pending(const ui_queue_t* q) {
+    const ui_cmd_slot_t* slot = &q->slots[q->tail & UI_QUEUE_MASK];
+    return __atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE) == q->tail + 1;
+}
+//---------
+static void ui_queue_apply(const ui_cmd_slot_t* slot) {
+    switch (slot->kind) {
+        case UI_CMD_SET_TEXT:
+            lv_label_set_text(slot->obj, slot->arg.text);
+            break;
+        case UI_CMD_SET_VALUE:
+            if (lv_obj_check_type(slot->obj, &lv_slider_class)) {
+                lv_slider_set_value(slot->obj, slot->arg.value, LV_ANIM_OFF);
+            } else if (lv_obj_check_type(slot->obj, &lv_bar_class)) {
+                lv_bar_set_value(slot->obj, slot->arg.value, LV_ANIM_OFF);
+            } else if (lv_obj_check_type(slot->obj, &lv_arc_class)) {
+                lv_arc_set_value(slot->obj, slot->arg.value);
+            }
+            break;
+        case UI_CMD_INVALIDATE:
+            lv_obj_invalidate(slot->obj);
+            break;
+        default:
+            break;
+    }
+}
+//---------
+uint32_t ui_queue_drain(ui_queue_t* q) {
+    // Lotul: sloturile gata, consecutive de la tail. Un producator care a rezervat dar n-a
+    // publicat inca opreste lotul acolo, restul vine la urmatorul drain.
+    uint32_t n = 0;
+    while (n < UI_QUEUE_DEPTH) {
+        const ui_cmd_slot_t* slot = &q->slots[(q->tail + n) & UI_QUEUE_MASK];
+        if (__atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE) != q->tail + n + 1) {
+            break;
+        }
+        n++;
+    }
+    if (n == 0) {
+        return 0;
+    }
+
+    // De la coada spre cap: prima aparitie a unei perechi (obj, kind) e cea mai noua, restul se sar
+    uint64_t skip = 0;
+    for (uint32_t i = n; i-- > 0;) {
+        const ui_cmd_slot_t* a = &q->slots[(q->tail + i) & UI_QUEUE_MASK];
+        for (uint32_t j = i + 1; j < n; j++) {
+            const ui_cmd_slot_t* b = &q->slots[(q->tail + j) & UI_QUEUE_MASK];
+            if (b->obj == a->obj && b->kind == a->kind) {
+                skip |= 1ULL << i;
+                break;
+            }
+        }
+    }
+
+    uint32_t applied = 0;
+    for (uint32_t i = 0; i < n; i++) {
+        ui_cmd_slot_t* slot = &q->slots[(q->tail + i) & UI_QUEUE_MASK];
+        if (!(skip & (1ULL << i))) {
+            ui_queue_apply(slot);
+            applied++;
+        }
+        // Slotul redevine liber pentru pozitia tail + i + UI_QUEUE_DEPTH
+        __atomic_store_n(&slot->seq, q->tail + i + UI_QUEUE_DEPTH, __ATOMIC_RELEASE);
+    }
+    q->tail += n;
+
+    q->stats.applied += applied;
+    q->stats.coalesced += n - applied;
+    q->stats.batches++;
+    if (n > q->stats.max_batch) {
+        q->stats.max_batch = n;
+    }
+    return applied;
+}
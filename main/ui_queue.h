@@ -0,0 +1,100 @@
+#pragma once
+#ifndef UI_QUEUE_H
+#define UI_QUEUE_H
+
+/*
+ * Coada de comenzi UI (MPSC, fara lock): task-urile din afara LVGL (sysmon, CLI, senzori)
+ * nu mai iau s_lvgl_mutex ca sa schimbe un label, ci pun comanda intr-un ring fix
+ * si se intorc imediat. lv_main_task / lv_frame_task goleste coada intre doua refresh-uri
+ * (ui_queue_drain), deja in contextul LVGL.
+ *
+ * Producatorii: fara heap, fara mutex, un CAS pe `head` (ring Vyukov cu numar de secventa
+ * pe slot). Coada plina -> comanda e refuzata (false), producatorul nu asteapta niciodata.
+ * La golire, comenzile repetate pe acelasi obiect (acelasi tip) din acelasi lot se reduc
+ * la ultima, deci un label actualizat de 10 ori intre doua frame-uri se deseneaza o data.
+ *
+ * Obiectele trebuie sa traiasca cat UI-ul (ca cele globale din ui.h): coada tine doar
+ * pointerul, nu afla daca obiectul a fost sters intre post si drain.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "lvgl.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* #ifdef __cplusplus */
+
+#define UI_QUEUE_DEPTH    (64)  // Slots, power of 2, max 64 (coalescing uses a 64 bit mask), ~5 KB
+#define UI_QUEUE_TEXT_MAX (64)  // Longer texts are truncated
+
+typedef enum {
+    UI_CMD_NONE = 0,
+    UI_CMD_SET_TEXT,    // lv_label_set_text
+    UI_CMD_SET_VALUE,   // lv_bar / lv_slider / lv_arc set_value, picked from the object class
+    UI_CMD_INVALIDATE,  // lv_obj_invalidate
+} ui_cmd_kind_t;
+
+typedef struct {
+    volatile uint32_t seq;  // Vyukov sequence: == pos free for producers, == pos + 1 ready for the consumer
+    uint8_t           kind;
+    lv_obj_t*         obj;
+    union {
+        int32_t value;
+        char    text[UI_QUEUE_TEXT_MAX];
+    } arg;
+} ui_cmd_slot_t;
+
+typedef struct {
+    volatile uint32_t posted;     // Accepted by ui_queue_* (__atomic_*)
+    volatile uint32_t dropped;    // Refused because the ring was full (__atomic_*)
+    uint32_t          applied;    // Commands executed by ui_queue_drain
+    uint32_t          coalesced;  // Commands skipped because a later one replaced them
+    uint32_t          batches;    // ui_queue_drain calls that found something
+    uint32_t          max_batch;  // Most commands taken in one drain
+} ui_queue_stats_t;
+
+typedef void (*ui_queue_wake_cb_t)(void* ctx);
+
+typedef struct {
+    ui_cmd_slot_t      slots[UI_QUEUE_DEPTH];
+    volatile uint32_t  head;  // Next position claimed by a producer (__atomic CAS)
+    uint32_t           tail;  // Next position read by the consumer, consumer only
+    ui_queue_wake_cb_t wake;  // Called after every post, e.g. xTaskNotifyGive to the LVGL task
+    void*              wake_ctx;
+    ui_queue_stats_t   stats;
+} ui_queue_t;
+
+/* wake may be NULL (lv_main_task polls every LV_DELAY anyway) */
+void ui_queue_init(ui_queue_t* q, ui_queue_wake_cb_t wake, void* wake_ctx);
+
+/* Queue used by the ui_queue_* helpers that take no queue (set once at boot, before other tasks post) */
+void        ui_queue_set_default(ui_queue_t* q);
+ui_queue_t* ui_queue_get_default(void);
+
+/**
+ * @brief Producer side, any task. Never blocks and never allocates.
+ * @return false if the ring is full (the command is lost, counted in stats.dropped)
+ */
+bool ui_queue_set_text(ui_queue_t* q, lv_obj_t* label, const char* text);
+bool ui_queue_set_text_fmt(ui_queue_t* q, lv_obj_t* label, const char* fmt, ...) LV_FORMAT_ATTRIBUTE(3, 4);
+bool ui_queue_set_value(ui_queue_t* q, lv_obj_t* obj, int32_t value);
+bool ui_queue_invalidate(ui_queue_t* q, lv_obj_t* obj);
+
+/**
+ * @brief Consumer side, only from the LVGL task (LVGL already locked).
+ *        Takes every command that is ready, drops the ones replaced later in the
+ *        same batch and applies the rest in posting order.
+ * @return Commands applied
+ */
+uint32_t ui_queue_drain(ui_queue_t* q);
+
+/* At least one command is ready for ui_queue_drain */
+bool ui_queue_pending(const ui_queue_t* q);
+
+#ifdef __cplusplus
+}
+#endif /* #ifdef __cplusplus */
+
+#endif /* #ifndef UI_QUEUE_H */
@@ -1,5 +1,21 @@
 #pragma once
 
+/**********************
+ *   MOUNT MANAGER
+ **********************/
+// Fiecare backend pe banda lui (montari in paralel); aceeasi banda = unul dupa altul, un task mai putin
+#define FS_LANE_SDMMC    (0)
+#define FS_LANE_FAT      (1)
+#define FS_LANE_LITTLEFS (2)
+#define FS_LANE_SPIFFS   (3)
+#define FS_MOUNT_TASK_STACK (4096)  // esp_vfs_fat_sdmmc_mount + sdmmc_card_print_info
+#define FS_MOUNT_TASK_PRIO  (5)
+//---
+// hello.txt / example.txt / test_sd.txt scrise si citite la fiecare boot, doar pentru depanare
+// #define FS_DEMO_IO
+
+//-------------------------
+
 /**********************
  * INTERNAL MMC DEFINES
  **********************/
@@ -9,6 +25,15 @@
 
 //-------------------------
 
+/**********************
+ *   LITTLEFS DEFINES
+ **********************/
+#define LITTLEFS_MOUNT_PATH      "/littlefs"
+#define LITTLEFS_PARTITION_LABEL "littlefs"
+#define LITTLEFS_LV_LETTER       'L'  // Drive LVGL, ex. "L:/img/logo.bin" (lv_fs_littlefs.h)
+
+//-------------------------
+
 /**********************
  *   SD MMC DEFINES
  **********************/
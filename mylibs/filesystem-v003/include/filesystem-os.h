@@ -9,13 +9,22 @@
 #include "FAT_fs.h"
 #include "LITTLE_fs.h"
 #include "SPIF_fs.h"
+#include "fs_mount.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif /* __cplusplus */
 
 // PROTOTYPES
-bool init_filesystem_sys();
+bool init_filesystem_sys();  // porneste montarea in fundal si se intoarce imediat
+
+/* true = filesystem-ul care serveste path e montat (asteapta cel mult timeout_ms, FS_MOUNT_WAIT_FOREVER) */
+bool filesystem_wait_path(const char* path, uint32_t timeout_ms);
+bool filesystem_wait_all(uint32_t timeout_ms);  // true = toate au terminat, montate sau nu
+const fs_mount_t* filesystem_mounts(void);      // stare si timpi pe backend, NULL inainte de init
+
+/* Drive-ul LVGL LITTLEFS_LV_LETTER pe LittleFS (lv_fs_littlefs.h), dupa lv_init; nu asteapta montarea */
+void filesystem_lv_init(void);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,128 @@
+#pragma once
+#ifndef FS_MOUNT_H
+#define FS_MOUNT_H
+
+/*
+ * Montarea filesystem-urilor in fundal, in paralel.
+ *
+ * Fiecare backend (SD-MMC, FAT intern, LittleFS, SPIFFS) are o banda (lane): backend-urile de pe
+ * aceeasi banda se monteaza unul dupa altul, pe acelasi worker, iar benzile ruleaza in paralel.
+ * `needs` cere ca alte backend-uri (adaugate inainte) sa fi terminat inainte de a incepe, de ex.
+ * doua montari FAT nu au voie sa se suprapuna (FATFS alege numarul de drive la inceputul montarii
+ * si il ocupa abia la sfarsit). Ordinea conteaza, nu reusita: un backend esuat tot deblocheaza.
+ *
+ * Cine are nevoie de un filesystem asteapta doar punctul lui de montare (fs_mount_wait_path), nu
+ * tot sistemul; pentru fiecare backend raman starea, codul de eroare si timpii.
+ *
+ * Nu depinde de ESP-IDF: task-urile, event group-ul si ceasul vin prin fs_mount_env_t
+ * (FreeRTOS in filesystem-os.c, pthread in host/bench_fs_mount.c).
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+#define FS_MOUNT_MAX          (8)  // Un bit pe backend (event group FreeRTOS: 24 de biti)
+#define FS_MOUNT_WAIT_FOREVER (UINT32_MAX)
+
+typedef enum {
+    FS_MOUNT_IDLE = 0,  // fs_mount_start nu a fost apelat (sau calea nu e a niciunui backend)
+    FS_MOUNT_QUEUED,    // asteapta banda sau needs
+    FS_MOUNT_RUNNING,
+    FS_MOUNT_READY,
+    FS_MOUNT_FAILED,
+} fs_mount_state_t;
+
+/* 0 = montat, altfel codul de eroare (esp_err_t pe placa) */
+typedef int (*fs_mount_fn_t)(void* arg);
+
+typedef struct {
+    const char*   name;  // Pentru log-uri
+    const char*   path;  // Punctul de montare, ex. "/sdcard"
+    fs_mount_fn_t mount;
+    void*         arg;
+    uint8_t       lane;   // < FS_MOUNT_MAX
+    uint32_t      needs;  // Bitul i = backend-ul cu indexul i (doar indexuri mai mici)
+} fs_mount_backend_t;
+
+typedef struct {
+    fs_mount_backend_t        backend;
+    volatile fs_mount_state_t state;
+    int                       err;
+    int64_t                   start_us;  // Fata de fs_mount_start
+    int64_t                   time_us;   // Doar mount(), fara asteptarea benzii / needs
+} fs_mount_entry_t;
+
+struct fs_mount;
+
+typedef struct {
+    /* Ruleaza fn(arg) pe un task nou; false = nu s-a putut porni (banda ruleaza atunci pe loc) */
+    bool (*spawn)(void* ctx, uint8_t lane, void (*fn)(void* arg), void* arg);
+    /*
+     * Backend-ul index a terminat (starea e finala): trebuie sa seteze bitul (1 << index) pentru
+     * wait. last = ultimul backend, tot sistemul e gata.
+     */
+    void (*done)(void* ctx, const struct fs_mount* m, size_t index, bool last);
+    /* Asteapta toti bitii din mask, cel mult timeout_ms; intoarce bitii setati */
+    uint32_t (*wait)(void* ctx, uint32_t mask, uint32_t timeout_ms);
+    int64_t (*now_us)(void* ctx);
+    void* ctx;
+} fs_mount_env_t;
+
+typedef struct {
+    struct fs_mount* m;
+    uint8_t          id;
+} fs_mount_lane_t;
+
+typedef struct fs_mount {
+    fs_mount_env_t   env;
+    fs_mount_entry_t entries[FS_MOUNT_MAX];
+    fs_mount_lane_t  lanes[FS_MOUNT_MAX];
+    size_t           count;
+    int64_t          t0_us;
+    bool             started;
+    volatile uint32_t finished;  // Backend-uri terminate (__atomic_*)
+} fs_mount_t;
+
+void fs_mount_init(fs_mount_t* m, const fs_mount_env_t* env);
+
+/**
+ * @brief Adauga un backend, inainte de fs_mount_start.
+ * @return indexul lui sau -1 (plin, lane prea mare, needs catre un backend care nu e inainte)
+ */
+int fs_mount_add(fs_mount_t* m, const fs_mount_backend_t* backend);
+
+/**
+ * @brief Porneste cate un worker pe banda si se intoarce imediat.
+ * Benzile al caror worker nu a pornit sunt montate aici, pe task-ul apelantului.
+ * @return numarul de workere pornite
+ */
+size_t fs_mount_start(fs_mount_t* m);
+
+/* Starea dupa cel mult timeout_ms (0 = doar verifica); READY / FAILED sunt finale */
+fs_mount_state_t fs_mount_wait(fs_mount_t* m, size_t index, uint32_t timeout_ms);
+
+/* Backend-ul care serveste path (cel mai lung punct de montare potrivit) sau -1 */
+int fs_mount_find(const fs_mount_t* m, const char* path);
+
+/* fs_mount_wait pentru backend-ul lui path; FS_MOUNT_IDLE daca nu e al niciunuia */
+fs_mount_state_t fs_mount_wait_path(fs_mount_t* m, const char* path, uint32_t timeout_ms);
+
+/* true = toate backend-urile au terminat (montate sau esuate) in timeout_ms */
+bool fs_mount_wait_all(fs_mount_t* m, uint32_t timeout_ms);
+
+/* Dupa ce toate au terminat: cat a durat tot (ultimul sfarsit) si cat ar fi durat pe rand */
+int64_t fs_mount_wall_us(const fs_mount_t* m);
+int64_t fs_mount_serial_us(const fs_mount_t* m);
+
+const char* fs_mount_state_name(fs_mount_state_t state);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* FS_MOUNT_H */
@@ -0,0 +1,43 @@
+#pragma once
+#ifndef LV_FS_LITTLEFS_H
+#define LV_FS_LITTLEFS_H
+
+/*
+ * Drive LVGL peste partitia LittleFS, citita prin esp_littlefs_mmap (components/littlefs).
+ *
+ * Cu CONFIG_LITTLEFS_MMAP_PARTITION, lv_fs_read copiaza direct din flash-ul mapat in bufferul lui
+ * LVGL: fara lfs_file_read, fara cache-ul fisierului, fara lacatul filesystem-ului. Fara mmap (sau
+ * pentru fisierele inline) citirea trece prin littlefs, ca inainte.
+ *
+ * Pentru zero copii, lv_fs_littlefs_image da un lv_image_dsc_t cu datele direct in flash, daca
+ * imaginea (.bin LVGL, necomprimata) e contigua, adica incape intr-un bloc de 4 KiB. Altfel se
+ * foloseste calea "L:/..." ca sursa, cu o copiere.
+ */
+
+#include <stdbool.h>
+#include "esp_littlefs_mmap.h"
+#include "lvgl.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/* Inregistreaza drive-ul `letter` (ex. 'L') pentru partitia `partition_label`. Poate fi apelat
+   inainte de montare: lv_fs_open esueaza pana cand partitia e montata. */
+void lv_fs_littlefs_init(char letter, const char* partition_label);
+
+/* Imaginea `path` (fara litera si fara punctul de montare) ca sursa in memorie, fara copiere.
+   `dsc` ramane valid pana la lv_fs_littlefs_image_close(*handle). false = imaginea nu e mapata
+   contiguu sau nu e un .bin LVGL valid; nimic nu ramane deschis. */
+bool lv_fs_littlefs_image(const char* path, lv_image_dsc_t* dsc, esp_littlefs_mmap_handle_t* handle);
+void lv_fs_littlefs_image_close(esp_littlefs_mmap_handle_t handle);
+
+/* Octetii cititi prin drive de la inregistrare: direct din flash-ul mapat / copiati prin littlefs
+   (sau adunati din mai multe blocuri) */
+void lv_fs_littlefs_stats(uint64_t* mapped_bytes, uint64_t* copied_bytes);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* LV_FS_LITTLEFS_H */
@@ -33,8 +33,8 @@ esp_err_t initialize_filesystem_littlefs() {
     ESP_LOGI(LITTLEFS_TAG, "Initializing LittleFS");
 
     esp_vfs_littlefs_conf_t conf = {
-        .base_path              = "/littlefs",
-        .partition_label        = "littlefs",
+        .base_path              = LITTLEFS_MOUNT_PATH,
+        .partition_label        = LITTLEFS_PARTITION_LABEL,
         .format_if_mount_failed = true,
         .dont_mount             = false,
     };
@@ -70,6 +70,7 @@ esp_err_t initialize_filesystem_littlefs() {
         ESP_LOGI(LITTLEFS_TAG, "Partition size: total: %d, used: %d", total, used);
     }
 
+#ifdef FS_DEMO_IO
     // Use POSIX and C standard library functions to work with files.
     // First create a file.
     ESP_LOGI(LITTLEFS_TAG, "Opening file");
@@ -121,6 +122,7 @@ esp_err_t initialize_filesystem_littlefs() {
         *pos = '\0';
     }
     ESP_LOGI(LITTLEFS_TAG, "Read from file: '%s'", line);
+#endif /* FS_DEMO_IO */
     return ESP_OK;
 }
 
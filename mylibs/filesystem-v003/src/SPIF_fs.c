@@ -77,6 +77,7 @@ esp_err_t initialize_filesystem_spiffs(){
         }
     }
 
+#ifdef FS_DEMO_IO
     // Use POSIX and C standard library functions to work with files.
     // First create a file.
     ESP_LOGI(SPIFFS_TAG, "Opening file");
@@ -136,6 +137,7 @@ esp_err_t initialize_filesystem_spiffs(){
         *pos = '\0';
     }
     ESP_LOGI(SPIFFS_TAG, "Read from file: '%s'", line);
+#endif /* FS_DEMO_IO */
 
     return ESP_OK;
 }
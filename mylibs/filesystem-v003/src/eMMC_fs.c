@@ -70,7 +70,9 @@ esp_err_t initialize_filesystem_sdmmc() {
     ESP_LOGI(SDMMC_TAG, "SD card mounted at %s", mount_point);
     sdmmc_card_print_info(stdout, card);
     // sdmmc_card_print_info(stdout, card);
+#ifdef FS_DEMO_IO
     fs_test_sdmmc();
+#endif /* FS_DEMO_IO */
     return ESP_OK;
 }
 
@@ -1,6 +1,7 @@
 
 #include "defines.h"
 #include "filesystem-os.h"
+#include "lv_fs_littlefs.h"
 
 // --------------------------------------- //
 
@@ -12,6 +13,10 @@
 
 #include "esp_console.h"
 #include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/event_groups.h"
+#include "freertos/task.h"
 
 
 
@@ -46,20 +51,140 @@
 
 static const char* FS_TAG = "FS";
 
+/*
+ * Backend-urile se monteaza pe task-uri (fs_mount.c), app_main nu mai asteapta dupa ele:
+ * UI-ul porneste in timp ce cardul SD inca se initializeaza. Cine are nevoie de un filesystem
+ * il asteapta cu filesystem_wait_path().
+ */
+static fs_mount_t         s_mounts;
+static EventGroupHandle_t s_mount_events;
+static struct {
+    void (*fn)(void* arg);
+    void* arg;
+} s_mount_workers[FS_MOUNT_MAX];
+
+//---------
+
+static int mount_sdmmc(void* arg) {
+    return initialize_filesystem_sdmmc();
+}
+static int mount_fat(void* arg) {
+    return initialize_internal_fat_filesystem();
+}
+static int mount_littlefs(void* arg) {
+    return initialize_filesystem_littlefs();
+}
+static int mount_spiffs(void* arg) {
+    return initialize_filesystem_spiffs();
+}
+
+//---------
+
+// Indexul din tabel e bitul din needs
+static const fs_mount_backend_t s_backends[] = {
+    {.name = "fat", .path = FAT_MOUNT_PATH, .mount = mount_fat, .lane = FS_LANE_FAT},
+    // Dupa FAT intern: FATFS alege drive-ul la inceputul montarii si il ocupa abia la sfarsit,
+    // deci doua montari FAT suprapuse pot primi acelasi numar
+    {.name = "sdmmc", .path = SD_MOUNT_PATH, .mount = mount_sdmmc, .lane = FS_LANE_SDMMC, .needs = 1u << 0},
+    {.name = "littlefs", .path = LITTLEFS_MOUNT_PATH, .mount = mount_littlefs, .lane = FS_LANE_LITTLEFS},
+    {.name = "spiffs", .path = "/spiffs", .mount = mount_spiffs, .lane = FS_LANE_SPIFFS},
+};
+
+//---------
+
+static void fs_mount_worker(void* parameter) {
+    uint8_t lane = (uint8_t) (uintptr_t) parameter;
+    s_mount_workers[lane].fn(s_mount_workers[lane].arg);
+    vTaskDelete(NULL);
+}
+//---------
+static bool fs_mount_spawn(void* ctx, uint8_t lane, void (*fn)(void* arg), void* arg) {
+    char name[configMAX_TASK_NAME_LEN];
+    snprintf(name, sizeof(name), "fs_mount%u", (unsigned) lane);
+    s_mount_workers[lane].fn  = fn;
+    s_mount_workers[lane].arg = arg;
+    return xTaskCreatePinnedToCore(fs_mount_worker, name, FS_MOUNT_TASK_STACK, (void*) (uintptr_t) lane,
+               FS_MOUNT_TASK_PRIO, NULL, tskNO_AFFINITY) == pdPASS;
+}
+//---------
+static void fs_mount_done(void* ctx, const fs_mount_t* m, size_t index, bool last) {
+    const fs_mount_entry_t* e = &m->entries[index];
+    if (e->state == FS_MOUNT_READY) {
+        ESP_LOGI(FS_TAG, "%s mounted at %s in %lld ms (started at +%lld ms)", e->backend.name, e->backend.path,
+            (long long) (e->time_us / 1000), (long long) (e->start_us / 1000));
+    } else {
+        ESP_LOGE(FS_TAG, "%s not mounted (%s) after %lld ms", e->backend.name, esp_err_to_name(e->err),
+            (long long) (e->time_us / 1000));
+    }
+    xEventGroupSetBits(s_mount_events, 1u << index);
+    if (last) {
+        ESP_LOGI(FS_TAG, "Filesystem mounted in %lld ms (%lld ms one after another)", (long long) (fs_mount_wall_us(m) / 1000),
+            (long long) (fs_mount_serial_us(m) / 1000));
+    }
+}
+//---------
+static uint32_t fs_mount_wait_bits(void* ctx, uint32_t mask, uint32_t timeout_ms) {
+    TickType_t ticks = timeout_ms == FS_MOUNT_WAIT_FOREVER ? portMAX_DELAY : pdMS_TO_TICKS(timeout_ms);
+    return (uint32_t) xEventGroupWaitBits(s_mount_events, mask, pdFALSE, pdTRUE, ticks);
+}
+//---------
+static int64_t fs_mount_now_us(void* ctx) {
+    return esp_timer_get_time();
+}
+
+//---------
+
 bool init_filesystem_sys() {
-    initialize_filesystem_sdmmc();
-    vTaskDelay(100);
-    initialize_internal_fat_filesystem();
-    initialize_filesystem_littlefs();
-    vTaskDelay(100);
-    initialize_filesystem_spiffs();
-    vTaskDelay(100);
-    ESP_LOGI(FS_TAG, "Filesystem mounted");
+    if (s_mount_events != NULL) {
+        return true;
+    }
+    s_mount_events = xEventGroupCreate();
+    if (s_mount_events == NULL) {
+        ESP_LOGE(FS_TAG, "No memory for the mount event group");
+        return false;
+    }
+    const fs_mount_env_t env = {
+        .spawn  = fs_mount_spawn,
+        .done   = fs_mount_done,
+        .wait   = fs_mount_wait_bits,
+        .now_us = fs_mount_now_us,
+        .ctx    = NULL,
+    };
+    fs_mount_init(&s_mounts, &env);
+
+    for (size_t i = 0; i < sizeof(s_backends) / sizeof(s_backends[0]); i++) {
+        if (fs_mount_add(&s_mounts, &s_backends[i]) < 0) {
+            ESP_LOGE(FS_TAG, "%s: invalid lane or needs, not mounted", s_backends[i].name);
+        }
+    }
+    size_t workers = fs_mount_start(&s_mounts);
+    ESP_LOGI(FS_TAG, "Mounting %u filesystems on %u tasks", (unsigned) s_mounts.count, (unsigned) workers);
     return 1;
 }
 
 // --------------------------------------- //
 
+bool filesystem_wait_path(const char* path, uint32_t timeout_ms) {
+    if (s_mount_events == NULL) {
+        return false;
+    }
+    return fs_mount_wait_path(&s_mounts, path, timeout_ms) == FS_MOUNT_READY;
+}
+//---------
+bool filesystem_wait_all(uint32_t timeout_ms) {
+    return s_mount_events != NULL && fs_mount_wait_all(&s_mounts, timeout_ms);
+}
+//---------
+const fs_mount_t* filesystem_mounts(void) {
+    return s_mount_events != NULL ? &s_mounts : NULL;
+}
+//---------
+void filesystem_lv_init(void) {
+    lv_fs_littlefs_init(LITTLEFS_LV_LETTER, LITTLEFS_PARTITION_LABEL);
+}
+
+// --------------------------------------- //
+
 /*************************************************************************/
 /*************************************************************************/
 
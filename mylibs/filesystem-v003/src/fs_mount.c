@@ -0,0 +1,166 @@
+#include "fs_mount.h"
+
+#include <string.h>
+
+// --------------------------------------- //
+
+static void fs_mount_set_state(fs_mount_entry_t* e, fs_mount_state_t state) {
+    __atomic_store_n(&e->state, state, __ATOMIC_RELEASE);
+}
+//---------
+static fs_mount_state_t fs_mount_get_state(const fs_mount_entry_t* e) {
+    return __atomic_load_n(&e->state, __ATOMIC_ACQUIRE);
+}
+//---------
+static void fs_mount_one(fs_mount_t* m, size_t index) {
+    fs_mount_entry_t* e = &m->entries[index];
+    if (e->backend.needs != 0) {
+        m->env.wait(m->env.ctx, e->backend.needs, FS_MOUNT_WAIT_FOREVER);
+    }
+
+    fs_mount_set_state(e, FS_MOUNT_RUNNING);
+    int64_t start = m->env.now_us(m->env.ctx);
+    e->start_us   = start - m->t0_us;
+    e->err        = e->backend.mount(e->backend.arg);
+    e->time_us    = m->env.now_us(m->env.ctx) - start;
+    fs_mount_set_state(e, e->err == 0 ? FS_MOUNT_READY : FS_MOUNT_FAILED);
+
+    uint32_t finished = __atomic_add_fetch(&m->finished, 1, __ATOMIC_ACQ_REL);
+    m->env.done(m->env.ctx, m, index, finished == m->count);
+}
+//---------
+/* Worker-ul unei benzi: backend-urile ei, in ordinea in care au fost adaugate */
+static void fs_mount_lane_run(void* arg) {
+    fs_mount_lane_t* lane = (fs_mount_lane_t*) arg;
+    fs_mount_t*      m    = lane->m;
+    for (size_t i = 0; i < m->count; i++) {
+        if (m->entries[i].backend.lane == lane->id) {
+            fs_mount_one(m, i);
+        }
+    }
+}
+
+// --------------------------------------- //
+
+void fs_mount_init(fs_mount_t* m, const fs_mount_env_t* env) {
+    memset(m, 0, sizeof(*m));
+    m->env = *env;
+}
+//---------
+int fs_mount_add(fs_mount_t* m, const fs_mount_backend_t* backend) {
+    uint32_t before = (1u << m->count) - 1;  // needs doar inapoi: fara cicluri, fara blocaje
+    if (m->started || m->count == FS_MOUNT_MAX || backend->mount == NULL || backend->path == NULL ||
+        backend->lane >= FS_MOUNT_MAX || (backend->needs & ~before) != 0) {
+        return -1;
+    }
+    fs_mount_entry_t* e = &m->entries[m->count];
+    memset(e, 0, sizeof(*e));
+    e->backend = *backend;
+    return (int) m->count++;
+}
+//---------
+size_t fs_mount_start(fs_mount_t* m) {
+    if (m->started) {
+        return 0;
+    }
+    m->started = true;
+    m->t0_us   = m->env.now_us(m->env.ctx);
+    for (size_t i = 0; i < m->count; i++) {
+        fs_mount_set_state(&m->entries[i], FS_MOUNT_QUEUED);
+    }
+
+    uint32_t seen = 0, local = 0;
+    size_t   spawned = 0;
+    for (size_t i = 0; i < m->count; i++) {
+        uint8_t id = m->entries[i].backend.lane;
+        if (seen & (1u << id)) {
+            continue;
+        }
+        seen |= 1u << id;
+        m->lanes[id].m  = m;
+        m->lanes[id].id = id;
+        if (m->env.spawn(m->env.ctx, id, fs_mount_lane_run, &m->lanes[id])) {
+            spawned++;
+        } else {
+            local |= 1u << id;
+        }
+    }
+
+    // Benzile fara worker, pe loc si in ordinea indexurilor: needs arata doar inapoi, deci
+    // orice backend asteptat e fie deja montat aici, fie pe un worker pornit
+    for (size_t i = 0; i < m->count && local != 0; i++) {
+        if (local & (1u << m->entries[i].backend.lane)) {
+            fs_mount_one(m, i);
+        }
+    }
+    return spawned;
+}
+
+// --------------------------------------- //
+
+fs_mount_state_t fs_mount_wait(fs_mount_t* m, size_t index, uint32_t timeout_ms) {
+    if (!m->started || index >= m->count) {
+        return FS_MOUNT_IDLE;
+    }
+    m->env.wait(m->env.ctx, 1u << index, timeout_ms);
+    return fs_mount_get_state(&m->entries[index]);
+}
+//---------
+int fs_mount_find(const fs_mount_t* m, const char* path) {
+    int    found     = -1;
+    size_t found_len = 0;
+    for (size_t i = 0; i < m->count; i++) {
+        const char* mount = m->entries[i].backend.path;
+        size_t      len   = strlen(mount);
+        // "/sdcard" serveste "/sdcard" si "/sdcard/x", dar nu "/sdcard2"
+        if (strncmp(path, mount, len) == 0 && (path[len] == '\0' || path[len] == '/') &&
+            (found < 0 || len > found_len)) {
+            found     = (int) i;
+            found_len = len;
+        }
+    }
+    return found;
+}
+//---------
+fs_mount_state_t fs_mount_wait_path(fs_mount_t* m, const char* path, uint32_t timeout_ms) {
+    int index = fs_mount_find(m, path);
+    return index < 0 ? FS_MOUNT_IDLE : fs_mount_wait(m, (size_t) index, timeout_ms);
+}
+//---------
+bool fs_mount_wait_all(fs_mount_t* m, uint32_t timeout_ms) {
+    if (!m->started) {
+        return m->count == 0;
+    }
+    uint32_t all = (1u << m->count) - 1;
+    return all == 0 || (m->env.wait(m->env.ctx, all, timeout_ms) & all) == all;
+}
+
+// --------------------------------------- //
+
+int64_t fs_mount_wall_us(const fs_mount_t* m) {
+    int64_t wall = 0;
+    for (size_t i = 0; i < m->count; i++) {
+        int64_t end = m->entries[i].start_us + m->entries[i].time_us;
+        wall        = end > wall ? end : wall;
+    }
+    return wall;
+}
+//---------
+int64_t fs_mount_serial_us(const fs_mount_t* m) {
+    int64_t sum = 0;
+    for (size_t i = 0; i < m->count; i++) {
+        sum += m->entries[i].time_us;
+    }
+    return sum;
+}
+//---------
+const char* fs_mount_state_name(fs_mount_state_t state) {
+    switch (state) {
+        case FS_MOUNT_IDLE: return "idle";
+        case FS_MOUNT_QUEUED: return "queued";
+        case FS_MOUNT_RUNNING: return "running";
+        case FS_MOUNT_READY: return "ready";
+        case FS_MOUNT_FAILED: return "failed";
+    }
+    return "?";
+}
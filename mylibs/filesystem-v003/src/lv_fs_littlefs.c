@@ -0,0 +1,146 @@
+#include "lv_fs_littlefs.h"
+
+#include <string.h>
+
+// --------------------------------------- //
+
+typedef struct {
+    esp_littlefs_mmap_handle_t map;
+    uint32_t                   pos;
+} lv_fs_littlefs_file_t;
+
+static lv_fs_drv_t s_drv;
+static const char* s_label;
+static uint64_t    s_mapped, s_copied;  // Fisierele inchise; cele deschise se aduna la close
+
+// --------------------------------------- //
+
+static void stats_add(esp_littlefs_mmap_handle_t map) {
+    uint64_t mapped, copied;
+    esp_littlefs_mmap_stats(map, &mapped, &copied);
+    __atomic_add_fetch(&s_mapped, mapped, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&s_copied, copied, __ATOMIC_RELAXED);
+}
+//---------
+static void* fs_open(lv_fs_drv_t* drv, const char* path, lv_fs_mode_t mode) {
+    LV_UNUSED(drv);
+    if (mode != LV_FS_MODE_RD) {
+        return NULL;  // Doar citire: datele mapate nu au voie sa se schimbe sub pointeri
+    }
+    lv_fs_littlefs_file_t* f = lv_malloc(sizeof(*f));
+    if (f == NULL) {
+        return NULL;
+    }
+    f->pos = 0;
+    if (esp_littlefs_mmap_open(s_label, path, &f->map) != ESP_OK) {
+        lv_free(f);
+        return NULL;
+    }
+    return f;
+}
+//---------
+static lv_fs_res_t fs_close(lv_fs_drv_t* drv, void* file_p) {
+    LV_UNUSED(drv);
+    lv_fs_littlefs_file_t* f = (lv_fs_littlefs_file_t*) file_p;
+    stats_add(f->map);
+    esp_err_t err = esp_littlefs_mmap_close(f->map);
+    lv_free(f);
+    return err == ESP_OK ? LV_FS_RES_OK : LV_FS_RES_FS_ERR;
+}
+//---------
+static lv_fs_res_t fs_read(lv_fs_drv_t* drv, void* file_p, void* buf, uint32_t btr, uint32_t* br) {
+    LV_UNUSED(drv);
+    lv_fs_littlefs_file_t* f = (lv_fs_littlefs_file_t*) file_p;
+    const void*            data;
+    ssize_t                n = esp_littlefs_mmap_get(f->map, f->pos, btr, buf, &data);
+    if (n < 0) {
+        *br = 0;
+        return LV_FS_RES_HW_ERR;
+    }
+    if (data != buf) {
+        memcpy(buf, data, n);  // Singura copiere, direct din flash-ul mapat
+    }
+    f->pos += (uint32_t) n;
+    *br = (uint32_t) n;
+    return LV_FS_RES_OK;
+}
+//---------
+static lv_fs_res_t fs_seek(lv_fs_drv_t* drv, void* file_p, uint32_t pos, lv_fs_whence_t whence) {
+    LV_UNUSED(drv);
+    lv_fs_littlefs_file_t* f    = (lv_fs_littlefs_file_t*) file_p;
+    uint32_t               size = (uint32_t) esp_littlefs_mmap_size(f->map);
+    switch (whence) {
+        case LV_FS_SEEK_SET:
+            f->pos = pos;
+            break;
+        case LV_FS_SEEK_CUR:
+            f->pos += pos;
+            break;
+        case LV_FS_SEEK_END:
+            f->pos = size + pos;
+            break;
+        default:
+            return LV_FS_RES_INV_PARAM;
+    }
+    return LV_FS_RES_OK;  // Dupa final: read da 0 octeti, ca lseek
+}
+//---------
+static lv_fs_res_t fs_tell(lv_fs_drv_t* drv, void* file_p, uint32_t* pos_p) {
+    LV_UNUSED(drv);
+    *pos_p = ((lv_fs_littlefs_file_t*) file_p)->pos;
+    return LV_FS_RES_OK;
+}
+
+// --------------------------------------- //
+
+void lv_fs_littlefs_init(char letter, const char* partition_label) {
+    s_label = partition_label;
+    lv_fs_drv_init(&s_drv);
+    s_drv.letter     = letter;
+    s_drv.cache_size = 0;  // Citirile din flash-ul mapat nu au nevoie de cache-ul lui LVGL
+    s_drv.open_cb    = fs_open;
+    s_drv.close_cb   = fs_close;
+    s_drv.read_cb    = fs_read;
+    s_drv.seek_cb    = fs_seek;
+    s_drv.tell_cb    = fs_tell;
+    lv_fs_drv_register(&s_drv);
+}
+//---------
+bool lv_fs_littlefs_image(const char* path, lv_image_dsc_t* dsc, esp_littlefs_mmap_handle_t* handle) {
+    esp_littlefs_mmap_handle_t map;
+    if (esp_littlefs_mmap_open(s_label, path, &map) != ESP_OK) {
+        return false;
+    }
+    const void* data;
+    size_t      size = esp_littlefs_mmap_size(map);
+    ssize_t     n    = esp_littlefs_mmap_span(map, 0, &data);
+    if (n < 0 || (size_t) n != size || size < sizeof(lv_image_header_t)) {
+        esp_littlefs_mmap_close(map);  // Mai multe blocuri, inline sau partitie nemapata
+        return false;
+    }
+
+    lv_image_header_t header;
+    memcpy(&header, data, sizeof(header));
+    if (header.magic != LV_IMAGE_HEADER_MAGIC || (header.flags & LV_IMAGE_FLAGS_COMPRESSED) ||
+        (size_t) header.stride * header.h > size - sizeof(header)) {
+        esp_littlefs_mmap_close(map);
+        return false;
+    }
+
+    memset(dsc, 0, sizeof(*dsc));
+    dsc->header    = header;
+    dsc->data      = (const uint8_t*) data + sizeof(header);
+    dsc->data_size = (uint32_t) (size - sizeof(header));
+    __atomic_add_fetch(&s_mapped, size, __ATOMIC_RELAXED);
+    *handle = map;
+    return true;
+}
+//---------
+void lv_fs_littlefs_image_close(esp_littlefs_mmap_handle_t handle) {
+    esp_littlefs_mmap_close(handle);
+}
+//---------
+void lv_fs_littlefs_stats(uint64_t* mapped_bytes, uint64_t* copied_bytes) {
+    *mapped_bytes = __atomic_load_n(&s_mapped, __ATOMIC_RELAXED);
+    *copied_bytes = __atomic_load_n(&s_copied, __ATOMIC_RELAXED);
+}
@@ -0,0 +1,69 @@
+#pragma once
+#ifndef LV_BLEND_ESP_H
+#define LV_BLEND_ESP_H
+
+/*
+ * LV_DRAW_SW_ASM_CUSTOM_INCLUDE pentru placa (main/lv_conf.h): blend-urile SW din LVGL
+ * spre RGB565 si RGB565_SWAPPED trec prin lv_blend_esp_table (lv_blend_esp_kernels.h).
+ *
+ * Acoperite: fill cu o culoare (simplu / opa / masca / masca + opa), imaginile RGB565 si
+ * ARGB8888 in mod NORMAL, pe ambele destinatii. Restul formatelor (RGB888, L8, AL88, I1 ...)
+ * raman pe buclele C din LVGL (hook-urile lor nu sunt definite aici).
+ *
+ * Headerul e inclus de toate lv_draw_sw_blend_to_*.c, de aceea aduce singur tipurile LVGL.
+ * Componenta isi adauga directorul include in lvgl (mylibs/lv-blend-v001/CMakeLists.txt).
+ */
+
+#include "src/draw/sw/blend/lv_draw_sw_blend_private.h"
+#include "lv_blend_esp_kernels.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* #ifdef __cplusplus */
+
+lv_result_t lv_blend_esp_color(lv_draw_sw_blend_fill_dsc_t* dsc, const lv_blend_esp_fn_t* row);
+lv_result_t lv_blend_esp_rgb565(lv_draw_sw_blend_image_dsc_t* dsc, const lv_blend_esp_fn_t* row);
+lv_result_t lv_blend_esp_argb8888(lv_draw_sw_blend_image_dsc_t* dsc, const lv_blend_esp_fn_t* row);
+
+/**********************
+ *   LVGL HOOKS
+ **********************/
+// Fiecare functie reface din dsc aceeasi alegere (opa / masca) ca LVGL, deci toate variantele merg in ea
+#define LV_BLEND_ESP_TO_RGB565          (lv_blend_esp_table.to_rgb565)
+#define LV_BLEND_ESP_TO_RGB565_SWAPPED  (lv_blend_esp_table.to_rgb565_swapped)
+
+#define LV_DRAW_SW_COLOR_BLEND_TO_RGB565(dsc)                                 lv_blend_esp_color(dsc, LV_BLEND_ESP_TO_RGB565)
+#define LV_DRAW_SW_COLOR_BLEND_TO_RGB565_WITH_OPA(dsc)                        lv_blend_esp_color(dsc, LV_BLEND_ESP_TO_RGB565)
+#define LV_DRAW_SW_COLOR_BLEND_TO_RGB565_WITH_MASK(dsc)                       lv_blend_esp_color(dsc, LV_BLEND_ESP_TO_RGB565)
+#define LV_DRAW_SW_COLOR_BLEND_TO_RGB565_MIX_MASK_OPA(dsc)                    lv_blend_esp_color(dsc, LV_BLEND_ESP_TO_RGB565)
+
+#define LV_DRAW_SW_RGB565_BLEND_NORMAL_TO_RGB565(dsc)                         lv_blend_esp_rgb565(dsc, LV_BLEND_ESP_TO_RGB565)
+#define LV_DRAW_SW_RGB565_BLEND_NORMAL_TO_RGB565_WITH_OPA(dsc)                lv_blend_esp_rgb565(dsc, LV_BLEND_ESP_TO_RGB565)
+#define LV_DRAW_SW_RGB565_BLEND_NORMAL_TO_RGB565_WITH_MASK(dsc)               lv_blend_esp_rgb565(dsc, LV_BLEND_ESP_TO_RGB565)
+#define LV_DRAW_SW_RGB565_BLEND_NORMAL_TO_RGB565_MIX_MASK_OPA(dsc)            lv_blend_esp_rgb565(dsc, LV_BLEND_ESP_TO_RGB565)
+
+#define LV_DRAW_SW_ARGB8888_BLEND_NORMAL_TO_RGB565(dsc)                       lv_blend_esp_argb8888(dsc, LV_BLEND_ESP_TO_RGB565)
+#define LV_DRAW_SW_ARGB8888_BLEND_NORMAL_TO_RGB565_WITH_OPA(dsc)              lv_blend_esp_argb8888(dsc, LV_BLEND_ESP_TO_RGB565)
+#define LV_DRAW_SW_ARGB8888_BLEND_NORMAL_TO_RGB565_WITH_MASK(dsc)             lv_blend_esp_argb8888(dsc, LV_BLEND_ESP_TO_RGB565)
+#define LV_DRAW_SW_ARGB8888_BLEND_NORMAL_TO_RGB565_MIX_MASK_OPA(dsc)          lv_blend_esp_argb8888(dsc, LV_BLEND_ESP_TO_RGB565)
+
+#define LV_DRAW_SW_COLOR_BLEND_TO_RGB565_SWAPPED(dsc)                         lv_blend_esp_color(dsc, LV_BLEND_ESP_TO_RGB565_SWAPPED)
+#define LV_DRAW_SW_COLOR_BLEND_TO_RGB565_SWAPPED_WITH_OPA(dsc)                lv_blend_esp_color(dsc, LV_BLEND_ESP_TO_RGB565_SWAPPED)
+#define LV_DRAW_SW_COLOR_BLEND_TO_RGB565_SWAPPED_WITH_MASK(dsc)               lv_blend_esp_color(dsc, LV_BLEND_ESP_TO_RGB565_SWAPPED)
+#define LV_DRAW_SW_COLOR_BLEND_TO_RGB565_SWAPPED_MIX_MASK_OPA(dsc)            lv_blend_esp_color(dsc, LV_BLEND_ESP_TO_RGB565_SWAPPED)
+
+#define LV_DRAW_SW_RGB565_BLEND_NORMAL_TO_RGB565_SWAPPED(dsc)                 lv_blend_esp_rgb565(dsc, LV_BLEND_ESP_TO_RGB565_SWAPPED)
+#define LV_DRAW_SW_RGB565_BLEND_NORMAL_TO_RGB565_SWAPPED_WITH_OPA(dsc)        lv_blend_esp_rgb565(dsc, LV_BLEND_ESP_TO_RGB565_SWAPPED)
+#define LV_DRAW_SW_RGB565_BLEND_NORMAL_TO_RGB565_SWAPPED_WITH_MASK(dsc)       lv_blend_esp_rgb565(dsc, LV_BLEND_ESP_TO_RGB565_SWAPPED)
+#define LV_DRAW_SW_RGB565_BLEND_NORMAL_TO_RGB565_SWAPPED_MIX_MASK_OPA(dsc)    lv_blend_esp_rgb565(dsc, LV_BLEND_ESP_TO_RGB565_SWAPPED)
+
+#define LV_DRAW_SW_ARGB8888_BLEND_NORMAL_TO_RGB565_SWAPPED(dsc)               lv_blend_esp_argb8888(dsc, LV_BLEND_ESP_TO_RGB565_SWAPPED)
+#define LV_DRAW_SW_ARGB8888_BLEND_NORMAL_TO_RGB565_SWAPPED_WITH_OPA(dsc)      lv_blend_esp_argb8888(dsc, LV_BLEND_ESP_TO_RGB565_SWAPPED)
+#define LV_DRAW_SW_ARGB8888_BLEND_NORMAL_TO_RGB565_SWAPPED_WITH_MASK(dsc)     lv_blend_esp_argb8888(dsc, LV_BLEND_ESP_TO_RGB565_SWAPPED)
+#define LV_DRAW_SW_ARGB8888_BLEND_NORMAL_TO_RGB565_SWAPPED_MIX_MASK_OPA(dsc)  lv_blend_esp_argb8888(dsc, LV_BLEND_ESP_TO_RGB565_SWAPPED)
+
+#ifdef __cplusplus
+}
+#endif /* #ifdef __cplusplus */
+
+#endif /* #ifndef LV_BLEND_ESP_H */
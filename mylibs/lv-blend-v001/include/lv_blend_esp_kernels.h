@@ -0,0 +1,68 @@
+#pragma once
+#ifndef LV_BLEND_ESP_KERNELS_H
+#define LV_BLEND_ESP_KERNELS_H
+
+/*
+ * Kernelurile de blend spre RGB565 / RGB565_SWAPPED, fara niciun header LVGL:
+ * se compileaza la fel pe placa si in host/bench_blend_esp.c (verificarea pe Linux).
+ *
+ * Descriptorul are exact layout-ul asm_dsc_t din esp_lvgl_port/src/lvgl9/simd,
+ * asa ca rutinele PIE de pe ESP32-S3 intra direct in tabel langa cele in C.
+ * Toate produc exact pixelii din lv_draw_sw_blend_to_rgb565*.c.
+ */
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* #ifdef __cplusplus */
+
+typedef struct {
+    uint32_t       opa;          // 0..255, used only by the *_OPA ops
+    void*          dst_buf;      // RGB565 or RGB565_SWAPPED
+    uint32_t       dst_w;
+    uint32_t       dst_h;
+    uint32_t       dst_stride;   // Bytes
+    const void*    src_buf;      // Fill: lv_color_t (b, g, r bytes), image: RGB565 / ARGB8888 pixels
+    uint32_t       src_stride;   // Bytes
+    const uint8_t* mask_buf;     // NULL for the ops without mask
+    uint32_t       mask_stride;  // Bytes
+} lv_blend_esp_dsc_t;
+
+/* Same contract as the PIE routines: returns 1 when the area was blended */
+typedef int (*lv_blend_esp_fn_t)(lv_blend_esp_dsc_t* dsc);
+
+typedef enum {
+    LV_BLEND_ESP_FILL = 0,
+    LV_BLEND_ESP_FILL_OPA,
+    LV_BLEND_ESP_FILL_MASK,
+    LV_BLEND_ESP_FILL_MASK_OPA,
+    LV_BLEND_ESP_RGB565,
+    LV_BLEND_ESP_RGB565_OPA,
+    LV_BLEND_ESP_RGB565_MASK,
+    LV_BLEND_ESP_RGB565_MASK_OPA,
+    LV_BLEND_ESP_ARGB8888,
+    LV_BLEND_ESP_ARGB8888_OPA,
+    LV_BLEND_ESP_ARGB8888_MASK,
+    LV_BLEND_ESP_ARGB8888_MASK_OPA,
+    LV_BLEND_ESP_OP_CNT,
+} lv_blend_esp_op_t;
+
+typedef struct {
+    lv_blend_esp_fn_t to_rgb565[LV_BLEND_ESP_OP_CNT];
+    lv_blend_esp_fn_t to_rgb565_swapped[LV_BLEND_ESP_OP_CNT];
+} lv_blend_esp_table_t;
+
+/* Used by the LVGL hooks: PIE on ESP32-S3 where it exists, optimized C for the rest */
+extern const lv_blend_esp_table_t lv_blend_esp_table;
+
+/* Pixel-by-pixel reference, written like LVGL's loops (for the cross-check only) */
+extern const lv_blend_esp_table_t lv_blend_esp_ref_table;
+
+const char* lv_blend_esp_op_name(lv_blend_esp_op_t op);
+
+#ifdef __cplusplus
+}
+#endif /* #ifdef __cplusplus */
+
+#endif /* #ifndef LV_BLEND_ESP_KERNELS_H */
@@ -0,0 +1,52 @@
+#include "lv_blend_esp.h"
+
+//---------
+static lv_blend_esp_op_t lv_blend_esp_variant(lv_blend_esp_op_t plain, const lv_opa_t* mask, lv_opa_t opa) {
+    // Aceeasi ordine ca in enum: PLAIN, OPA, MASK, MASK_OPA
+    if (mask) {
+        return opa >= LV_OPA_MAX ? plain + 2 : plain + 3;
+    }
+    return opa >= LV_OPA_MAX ? plain : plain + 1;
+}
+//---------
+static lv_result_t lv_blend_esp_image(lv_draw_sw_blend_image_dsc_t* dsc, const lv_blend_esp_fn_t* row,
+    lv_blend_esp_op_t plain) {
+    if (dsc->blend_mode != LV_BLEND_MODE_NORMAL) {
+        return LV_RESULT_INVALID;
+    }
+    lv_blend_esp_dsc_t asm_dsc = {
+        .opa         = dsc->opa,
+        .dst_buf     = dsc->dest_buf,
+        .dst_w       = (uint32_t) dsc->dest_w,
+        .dst_h       = (uint32_t) dsc->dest_h,
+        .dst_stride  = (uint32_t) dsc->dest_stride,
+        .src_buf     = dsc->src_buf,
+        .src_stride  = (uint32_t) dsc->src_stride,
+        .mask_buf    = dsc->mask_buf,
+        .mask_stride = (uint32_t) dsc->mask_stride,
+    };
+    return row[lv_blend_esp_variant(plain, dsc->mask_buf, dsc->opa)](&asm_dsc) ? LV_RESULT_OK : LV_RESULT_INVALID;
+}
+//---------
+lv_result_t lv_blend_esp_color(lv_draw_sw_blend_fill_dsc_t* dsc, const lv_blend_esp_fn_t* row) {
+    lv_blend_esp_dsc_t asm_dsc = {
+        .opa         = dsc->opa,
+        .dst_buf     = dsc->dest_buf,
+        .dst_w       = (uint32_t) dsc->dest_w,
+        .dst_h       = (uint32_t) dsc->dest_h,
+        .dst_stride  = (uint32_t) dsc->dest_stride,
+        .src_buf     = &dsc->color,  // Ca in esp_lvgl_port: rutina de fill citeste lv_color_t
+        .mask_buf    = dsc->mask_buf,
+        .mask_stride = (uint32_t) dsc->mask_stride,
+    };
+    lv_blend_esp_op_t op = lv_blend_esp_variant(LV_BLEND_ESP_FILL, dsc->mask_buf, dsc->opa);
+    return row[op](&asm_dsc) ? LV_RESULT_OK : LV_RESULT_INVALID;
+}
+//---------
+lv_result_t lv_blend_esp_rgb565(lv_draw_sw_blend_image_dsc_t* dsc, const lv_blend_esp_fn_t* row) {
+    return lv_blend_esp_image(dsc, row, LV_BLEND_ESP_RGB565);
+}
+//---------
+lv_result_t lv_blend_esp_argb8888(lv_draw_sw_blend_image_dsc_t* dsc, const lv_blend_esp_fn_t* row) {
+    return lv_blend_esp_image(dsc, row, LV_BLEND_ESP_ARGB8888);
+}
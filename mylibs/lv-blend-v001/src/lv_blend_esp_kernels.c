@@ -0,0 +1,399 @@
+/*
+ * Kernelurile din lv_blend_esp_table.
+ *
+ * Pe ESP32-S3 umplerea simpla si copierea RGB565 -> RGB565 folosesc rutinele PIE (128 biti)
+ * din esp_lvgl_port/src/lvgl9/simd. Restul (opa / masca / ARGB8888 si destinatia swapped)
+ * sunt in C, scrise pentru Xtensa: masca citita cate 4 bytes (0 = sarim, 0xFFFFFFFF = copiem),
+ * culoarea "imprastiata" o singura data pe linie, nicio citire nealiniata.
+ *
+ * lv_color_16_16_mix(c1, c2, mix) e aceeasi formula pentru orice mix cu mix5 = (mix + 4) >> 3
+ * (mix5 = 0 da c2, mix5 = 32 da c1), de aceea cazurile speciale de mai jos sunt doar scurtaturi.
+ */
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "lv_blend_esp_kernels.h"
+
+#if defined(ESP_PLATFORM)
+    #include "esp_attr.h"
+    #include "sdkconfig.h"
+    #define BLEND_FAST_MEM IRAM_ATTR  // Apelate din ambele draw unit-uri pentru fiecare zona desenata
+#else
+    #define BLEND_FAST_MEM
+#endif /* #if defined(ESP_PLATFORM) */
+
+#if defined(CONFIG_IDF_TARGET_ESP32S3)
+    #define LV_BLEND_ESP_PIE 1
+int lv_color_blend_to_rgb565_esp(lv_blend_esp_dsc_t* dsc);          // lv_color_blend_to_rgb565_esp32s3.S
+int lv_rgb565_blend_normal_to_rgb565_esp(lv_blend_esp_dsc_t* dsc);  // lv_rgb565_blend_normal_to_rgb565_esp32s3.S
+#else
+    #define LV_BLEND_ESP_PIE 0
+#endif /* #if defined(CONFIG_IDF_TARGET_ESP32S3) */
+
+#define BLEND_INLINE static inline __attribute__((always_inline))
+#define MIX_MASK     (0x7E0F81FU)
+
+/*********************
+ *   PIXEL HELPERS
+ *********************/
+//---------
+BLEND_INLINE uint16_t px_swap(uint16_t c) {
+    return __builtin_bswap16(c);
+}
+//---------
+BLEND_INLINE uint16_t px_load(const uint16_t* p, bool swapped) {
+    return swapped ? px_swap(*p) : *p;
+}
+//---------
+BLEND_INLINE void px_store(uint16_t* p, uint16_t c, bool swapped) {
+    *p = swapped ? px_swap(c) : c;
+}
+//---------
+BLEND_INLINE uint16_t px_from_888(const uint8_t* c) {
+    return (uint16_t) (((c[2] & 0xF8) << 8) | ((c[1] & 0xFC) << 3) | (c[0] >> 3));
+}
+//---------
+BLEND_INLINE uint32_t px_spread(uint16_t c) {
+    return (c | ((uint32_t) c << 16)) & MIX_MASK;
+}
+//---------
+// lv_color_16_16_mix cu fg deja imprastiat si mix5 = (mix + 4) >> 3
+BLEND_INLINE uint16_t px_mix_16(uint32_t fg, uint16_t c2, uint32_t mix5) {
+    uint32_t bg  = px_spread(c2);
+    uint32_t res = ((((fg - bg) * mix5) >> 5) + bg) & MIX_MASK;
+    return (uint16_t) ((res >> 16) | res);
+}
+//---------
+// lv_color_24_16_mix pentru 0 < mix < 255
+BLEND_INLINE uint16_t px_mix_24(const uint8_t* c1, uint16_t c2, uint32_t mix) {
+    uint32_t inv = 255 - mix;
+    return (uint16_t) (((((c1[2] >> 3) * mix + ((c2 >> 11) & 0x1F) * inv) << 3) & 0xF800) +
+                       ((((c1[1] >> 2) * mix + ((c2 >> 5) & 0x3F) * inv) >> 3) & 0x07E0) +
+                       (((c1[0] >> 3) * mix + (c2 & 0x1F) * inv) >> 8));
+}
+//---------
+BLEND_INLINE uint32_t mask_word(const uint8_t* mask) {
+    return *(const uint32_t*) mask;  // Doar pe adrese aliniate la 4
+}
+//---------
+BLEND_INLINE uint16_t color_of(const lv_blend_esp_dsc_t* dsc) {
+    return px_from_888((const uint8_t*) dsc->src_buf);
+}
+//---------
+BLEND_INLINE uint16_t* dst_next(uint16_t* row, uint32_t stride) {
+    return (uint16_t*) ((uint8_t*) row + stride);
+}
+
+/*********************
+ *   COLOR FILL
+ *********************/
+//---------
+BLEND_INLINE void fill_row(uint16_t* dst, int32_t w, uint16_t c) {
+    if (w > 0 && ((uintptr_t) dst & 0x3)) {
+        *dst++ = c;
+        w--;
+    }
+    uint32_t  c32   = c | ((uint32_t) c << 16);
+    uint32_t* dst32 = (uint32_t*) dst;
+    for (; w >= 2; w -= 2) {
+        *dst32++ = c32;
+    }
+    if (w) {
+        *(uint16_t*) dst32 = c;
+    }
+}
+//---------
+BLEND_INLINE void fill_px(uint16_t* dst, uint32_t fg, uint16_t c_out, uint32_t mix, bool swapped) {
+    uint32_t mix5 = (mix + 4) >> 3;
+    if (mix5 == 32) {
+        *dst = c_out;
+    } else if (mix5) {
+        px_store(dst, px_mix_16(fg, px_load(dst, swapped), mix5), swapped);
+    }
+}
+//---------
+BLEND_INLINE int fill_plain(lv_blend_esp_dsc_t* dsc, bool swapped) {
+    uint16_t  c   = swapped ? px_swap(color_of(dsc)) : color_of(dsc);
+    uint16_t* dst = dsc->dst_buf;
+    for (uint32_t y = 0; y < dsc->dst_h; y++) {
+        fill_row(dst, (int32_t) dsc->dst_w, c);
+        dst = dst_next(dst, dsc->dst_stride);
+    }
+    return 1;
+}
+//---------
+BLEND_INLINE int fill_opa(lv_blend_esp_dsc_t* dsc, bool swapped) {
+    uint16_t  c    = color_of(dsc);
+    uint32_t  fg   = px_spread(c);
+    uint32_t  mix5 = (dsc->opa + 4) >> 3;
+    uint16_t* dst  = dsc->dst_buf;
+    if (mix5 == 0) {
+        return 1;  // Sub 4/255 rezultatul e chiar destinatia
+    }
+    if (mix5 == 32) {
+        return fill_plain(dsc, swapped);
+    }
+    for (uint32_t y = 0; y < dsc->dst_h; y++) {
+        // Fundalurile sunt de obicei uniforme: refolosim ultimul rezultat (ca bucla din LVGL)
+        uint16_t last_in  = (uint16_t) (dst[0] + 1);
+        uint16_t last_out = 0;
+        for (uint32_t x = 0; x < dsc->dst_w; x++) {
+            if (dst[x] != last_in) {
+                last_in  = dst[x];
+                last_out = swapped ? px_swap(px_mix_16(fg, px_swap(last_in), mix5)) : px_mix_16(fg, last_in, mix5);
+            }
+            dst[x] = last_out;
+        }
+        dst = dst_next(dst, dsc->dst_stride);
+    }
+    return 1;
+}
+//---------
+BLEND_INLINE int fill_mask(lv_blend_esp_dsc_t* dsc, bool swapped, bool with_opa) {
+    uint16_t       c     = color_of(dsc);
+    uint16_t       c_out = swapped ? px_swap(c) : c;
+    uint32_t       fg    = px_spread(c);
+    uint32_t       opa   = dsc->opa;
+    uint16_t*      dst   = dsc->dst_buf;
+    const uint8_t* mask  = dsc->mask_buf;
+    int32_t        w     = (int32_t) dsc->dst_w;
+    for (uint32_t y = 0; y < dsc->dst_h; y++) {
+        int32_t x = 0;
+        for (; x < w && ((uintptr_t) &mask[x] & 0x3); x++) {
+            fill_px(&dst[x], fg, c_out, with_opa ? (mask[x] * opa) >> 8 : mask[x], swapped);
+        }
+        for (; x + 4 <= w; x += 4) {
+            uint32_t m4 = mask_word(&mask[x]);
+            if (m4 == 0) {
+                continue;
+            }
+            if (!with_opa && m4 == 0xFFFFFFFFU) {
+                dst[x] = dst[x + 1] = dst[x + 2] = dst[x + 3] = c_out;
+                continue;
+            }
+            for (int32_t i = 0; i < 4; i++) {
+                fill_px(&dst[x + i], fg, c_out, with_opa ? (mask[x + i] * opa) >> 8 : mask[x + i], swapped);
+            }
+        }
+        for (; x < w; x++) {
+            fill_px(&dst[x], fg, c_out, with_opa ? (mask[x] * opa) >> 8 : mask[x], swapped);
+        }
+        dst = dst_next(dst, dsc->dst_stride);
+        mask += dsc->mask_stride;
+    }
+    return 1;
+}
+
+/*********************
+ *   RGB565 IMAGE
+ *********************/
+//---------
+BLEND_INLINE void rgb565_px(uint16_t* dst, uint16_t s, uint32_t mix, bool swapped) {
+    uint32_t mix5 = (mix + 4) >> 3;
+    if (mix5 == 32) {
+        px_store(dst, s, swapped);
+    } else if (mix5) {
+        px_store(dst, px_mix_16(px_spread(s), px_load(dst, swapped), mix5), swapped);
+    }
+}
+//---------
+BLEND_INLINE int rgb565_plain(lv_blend_esp_dsc_t* dsc, bool swapped) {
+    uint16_t*       dst = dsc->dst_buf;
+    const uint16_t* src = dsc->src_buf;
+    for (uint32_t y = 0; y < dsc->dst_h; y++) {
+        if (swapped) {
+            for (uint32_t x = 0; x < dsc->dst_w; x++) {
+                dst[x] = px_swap(src[x]);
+            }
+        } else {
+            memcpy(dst, src, dsc->dst_w * 2);
+        }
+        dst = dst_next(dst, dsc->dst_stride);
+        src = (const uint16_t*) ((const uint8_t*) src + dsc->src_stride);
+    }
+    return 1;
+}
+//---------
+BLEND_INLINE int rgb565_opa(lv_blend_esp_dsc_t* dsc, bool swapped) {
+    uint32_t        mix5 = (dsc->opa + 4) >> 3;
+    uint16_t*       dst  = dsc->dst_buf;
+    const uint16_t* src  = dsc->src_buf;
+    if (mix5 == 0) {
+        return 1;
+    }
+    if (mix5 == 32) {
+        return rgb565_plain(dsc, swapped);
+    }
+    for (uint32_t y = 0; y < dsc->dst_h; y++) {
+        for (uint32_t x = 0; x < dsc->dst_w; x++) {
+            px_store(&dst[x], px_mix_16(px_spread(src[x]), px_load(&dst[x], swapped), mix5), swapped);
+        }
+        dst = dst_next(dst, dsc->dst_stride);
+        src = (const uint16_t*) ((const uint8_t*) src + dsc->src_stride);
+    }
+    return 1;
+}
+//---------
+BLEND_INLINE int rgb565_mask(lv_blend_esp_dsc_t* dsc, bool swapped, bool with_opa) {
+    uint32_t        opa  = dsc->opa;
+    uint16_t*       dst  = dsc->dst_buf;
+    const uint16_t* src  = dsc->src_buf;
+    const uint8_t*  mask = dsc->mask_buf;
+    int32_t         w    = (int32_t) dsc->dst_w;
+    for (uint32_t y = 0; y < dsc->dst_h; y++) {
+        int32_t x = 0;
+        for (; x < w && ((uintptr_t) &mask[x] & 0x3); x++) {
+            rgb565_px(&dst[x], src[x], with_opa ? (mask[x] * opa) >> 8 : mask[x], swapped);
+        }
+        for (; x + 4 <= w; x += 4) {
+            uint32_t m4 = mask_word(&mask[x]);
+            if (m4 == 0) {
+                continue;
+            }
+            if (!with_opa && m4 == 0xFFFFFFFFU) {
+                for (int32_t i = 0; i < 4; i++) {
+                    px_store(&dst[x + i], src[x + i], swapped);
+                }
+                continue;
+            }
+            for (int32_t i = 0; i < 4; i++) {
+                rgb565_px(&dst[x + i], src[x + i], with_opa ? (mask[x + i] * opa) >> 8 : mask[x + i], swapped);
+            }
+        }
+        for (; x < w; x++) {
+            rgb565_px(&dst[x], src[x], with_opa ? (mask[x] * opa) >> 8 : mask[x], swapped);
+        }
+        dst = dst_next(dst, dsc->dst_stride);
+        src = (const uint16_t*) ((const uint8_t*) src + dsc->src_stride);
+        mask += dsc->mask_stride;
+    }
+    return 1;
+}
+
+/*********************
+ *   ARGB8888 IMAGE
+ *********************/
+//---------
+BLEND_INLINE void argb8888_px(uint16_t* dst, const uint8_t* s, uint32_t mix, bool swapped) {
+    if (mix == 255) {
+        px_store(dst, px_from_888(s), swapped);
+    } else if (mix) {
+        px_store(dst, px_mix_24(s, px_load(dst, swapped), mix), swapped);
+    }
+}
+//---------
+BLEND_INLINE int argb8888_blend(lv_blend_esp_dsc_t* dsc, bool swapped, bool with_mask, bool with_opa) {
+    uint32_t       opa  = dsc->opa;
+    uint16_t*      dst  = dsc->dst_buf;
+    const uint8_t* src  = dsc->src_buf;
+    const uint8_t* mask = dsc->mask_buf;
+    int32_t        w    = (int32_t) dsc->dst_w;
+    for (uint32_t y = 0; y < dsc->dst_h; y++) {
+        for (int32_t x = 0; x < w; x++) {
+            const uint8_t* s = &src[x * 4];
+            uint32_t       mix;
+            // Aceleasi rotunjiri ca LV_OPA_MIX2 / LV_OPA_MIX3 (ex. 255 * 255 >> 8 = 254, nu 255)
+            if (with_mask && with_opa) {
+                mix = (s[3] * mask[x] * opa) >> 16;
+            } else if (with_mask) {
+                mix = (s[3] * mask[x]) >> 8;
+            } else if (with_opa) {
+                mix = (s[3] * opa) >> 8;
+            } else {
+                mix = s[3];
+            }
+            argb8888_px(&dst[x], s, mix, swapped);
+        }
+        dst = dst_next(dst, dsc->dst_stride);
+        src += dsc->src_stride;
+        if (with_mask) {
+            mask += dsc->mask_stride;
+        }
+    }
+    return 1;
+}
+
+/*********************
+ *   ENTRY POINTS
+ *********************/
+// Cate o functie concreta pentru fiecare destinatie: flag-urile sunt constante si dispar la compilare.
+#define BLEND_FN_RGB565(name, call)                                                                                    \
+    static int BLEND_FAST_MEM name##_rgb565(lv_blend_esp_dsc_t* dsc) {                                                 \
+        return call(dsc, false);                                                                                       \
+    }
+#define BLEND_FN_SWAPPED(name, call)                                                                                   \
+    static int BLEND_FAST_MEM name##_rgb565_swapped(lv_blend_esp_dsc_t* dsc) {                                         \
+        return call(dsc, true);                                                                                        \
+    }
+#define BLEND_FN(name, call) BLEND_FN_RGB565(name, call) BLEND_FN_SWAPPED(name, call)
+
+#define FILL_MASK_PLAIN(dsc, sw)      fill_mask(dsc, sw, false)
+#define FILL_MASK_OPA(dsc, sw)        fill_mask(dsc, sw, true)
+#define RGB565_MASK_PLAIN(dsc, sw)    rgb565_mask(dsc, sw, false)
+#define RGB565_MASK_OPA(dsc, sw)      rgb565_mask(dsc, sw, true)
+#define ARGB8888_PLAIN(dsc, sw)       argb8888_blend(dsc, sw, false, false)
+#define ARGB8888_OPA(dsc, sw)         argb8888_blend(dsc, sw, false, true)
+#define ARGB8888_MASK_PLAIN(dsc, sw)  argb8888_blend(dsc, sw, true, false)
+#define ARGB8888_MASK_OPA(dsc, sw)    argb8888_blend(dsc, sw, true, true)
+
+BLEND_FN(k_fill_opa, fill_opa)
+BLEND_FN(k_fill_mask, FILL_MASK_PLAIN)
+BLEND_FN(k_fill_mask_opa, FILL_MASK_OPA)
+BLEND_FN_SWAPPED(k_rgb565, rgb565_plain)
+BLEND_FN(k_rgb565_opa, rgb565_opa)
+BLEND_FN(k_rgb565_mask, RGB565_MASK_PLAIN)
+BLEND_FN(k_rgb565_mask_opa, RGB565_MASK_OPA)
+BLEND_FN(k_argb8888, ARGB8888_PLAIN)
+BLEND_FN(k_argb8888_opa, ARGB8888_OPA)
+BLEND_FN(k_argb8888_mask, ARGB8888_MASK_PLAIN)
+BLEND_FN(k_argb8888_mask_opa, ARGB8888_MASK_OPA)
+
+// Umplerea simpla si copierea RGB565 -> RGB565 in C doar fara PIE; umplerea swapped trece mereu prin
+// fill_swapped_rgb565_swapped de mai jos, deci si pe host se verifica aceeasi cale ca pe placa
+#if LV_BLEND_ESP_PIE
+    #define FILL_RGB565   lv_color_blend_to_rgb565_esp
+    #define COPY_RGB565   lv_rgb565_blend_normal_to_rgb565_esp
+#else
+BLEND_FN_RGB565(k_fill, fill_plain)
+BLEND_FN_RGB565(k_rgb565, rgb565_plain)
+    #define FILL_RGB565   k_fill_rgb565
+    #define COPY_RGB565   k_rgb565_rgb565
+#endif /* #if LV_BLEND_ESP_PIE */
+
+//---------
+// Umplerea swapped e o umplere normala cu culoarea deja inversata. Rutina de fill citeste un lv_color_t
+// si il converteste singura in RGB565; orice valoare pe 16 biti se poate scrie asa, deci o codam invers.
+static int BLEND_FAST_MEM fill_swapped_rgb565_swapped(lv_blend_esp_dsc_t* dsc) {
+    uint16_t           s        = px_swap(color_of(dsc));
+    uint8_t            color[3] = {(uint8_t) ((s & 0x1F) << 3), (uint8_t) (((s >> 5) & 0x3F) << 2), (uint8_t) ((s >> 11) << 3)};
+    lv_blend_esp_dsc_t d        = *dsc;
+    d.src_buf                   = color;
+    return FILL_RGB565(&d);
+}
+
+const lv_blend_esp_table_t lv_blend_esp_table = {
+    .to_rgb565 =
+        {
+            FILL_RGB565, k_fill_opa_rgb565, k_fill_mask_rgb565, k_fill_mask_opa_rgb565,                  //
+            COPY_RGB565, k_rgb565_opa_rgb565, k_rgb565_mask_rgb565, k_rgb565_mask_opa_rgb565,            //
+            k_argb8888_rgb565, k_argb8888_opa_rgb565, k_argb8888_mask_rgb565, k_argb8888_mask_opa_rgb565,  //
+        },
+    .to_rgb565_swapped =
+        {
+            fill_swapped_rgb565_swapped, k_fill_opa_rgb565_swapped, k_fill_mask_rgb565_swapped,                   //
+            k_fill_mask_opa_rgb565_swapped, k_rgb565_rgb565_swapped, k_rgb565_opa_rgb565_swapped,                 //
+            k_rgb565_mask_rgb565_swapped, k_rgb565_mask_opa_rgb565_swapped, k_argb8888_rgb565_swapped,            //
+            k_argb8888_opa_rgb565_swapped, k_argb8888_mask_rgb565_swapped, k_argb8888_mask_opa_rgb565_swapped,    //
+        },
+};
+
+//---------
+const char* lv_blend_esp_op_name(lv_blend_esp_op_t op) {
+    static const char* const names[LV_BLEND_ESP_OP_CNT] = {
+        "fill", "fill opa", "fill mask", "fill mask+opa",                      //
+        "rgb565", "rgb565 opa", "rgb565 mask", "rgb565 mask+opa",              //
+        "argb8888", "argb8888 opa", "argb8888 mask", "argb8888 mask+opa",      //
+    };
+    return (unsigned) op < LV_BLEND_ESP_OP_CNT ? names[op] : "?";
+}
@@ -0,0 +1,154 @@
+/*
+ * Referinta pixel cu pixel pentru lv_blend_esp_table: aceleasi formule ca
+ * lv_color_16_16_mix / lv_color_24_16_mix si LV_OPA_MIX2 / LV_OPA_MIX3 din LVGL,
+ * fara nicio scurtatura. O folosesc doar verificarile (host/bench_blend_esp.c),
+ * pe placa nu e legata in firmware (nimeni nu o refera).
+ */
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "lv_blend_esp_kernels.h"
+
+#define REF_MIX2(a, b)    ((uint8_t) (((int32_t) (a) * (b)) >> 8))
+#define REF_MIX3(a, b, c) ((uint8_t) (((int32_t) (a) * (b) * (c)) >> 16))
+
+//---------
+static uint16_t ref_swap(uint16_t c) {
+    return (uint16_t) ((c >> 8) | (c << 8));
+}
+//---------
+static uint16_t ref_to_u16(const uint8_t* c) {
+    return (uint16_t) (((c[2] & 0xF8) << 8) + ((c[1] & 0xFC) << 3) + ((c[0] & 0xF8) >> 3));
+}
+//---------
+static uint16_t ref_mix_16_16(uint16_t c1, uint16_t c2, uint8_t mix) {
+    if (mix == 255) {
+        return c1;
+    }
+    if (mix == 0) {
+        return c2;
+    }
+    if (c1 == c2) {
+        return c1;
+    }
+    mix             = (uint8_t) (((uint32_t) mix + 4) >> 3);
+    uint32_t bg     = (uint32_t) (c2 | ((uint32_t) c2 << 16)) & 0x7E0F81F;
+    uint32_t fg     = (uint32_t) (c1 | ((uint32_t) c1 << 16)) & 0x7E0F81F;
+    uint32_t result = ((((fg - bg) * mix) >> 5) + bg) & 0x7E0F81F;
+    return (uint16_t) ((result >> 16) | result);
+}
+//---------
+static uint16_t ref_mix_24_16(const uint8_t* c1, uint16_t c2, uint8_t mix) {
+    if (mix == 0) {
+        return c2;
+    }
+    if (mix == 255) {
+        return ref_to_u16(c1);
+    }
+    uint8_t mix_inv = 255 - mix;
+    return (uint16_t) (((((c1[2] >> 3) * mix + ((c2 >> 11) & 0x1F) * mix_inv) << 3) & 0xF800) +
+                       ((((c1[1] >> 2) * mix + ((c2 >> 5) & 0x3F) * mix_inv) >> 3) & 0x07E0) +
+                       (((c1[0] >> 3) * mix + (c2 & 0x1F) * mix_inv) >> 8));
+}
+//---------
+static uint16_t* ref_dst_row(const lv_blend_esp_dsc_t* dsc, uint32_t y) {
+    return (uint16_t*) ((uint8_t*) dsc->dst_buf + y * dsc->dst_stride);
+}
+//---------
+static const uint8_t* ref_src_row(const lv_blend_esp_dsc_t* dsc, uint32_t y) {
+    return (const uint8_t*) dsc->src_buf + y * dsc->src_stride;
+}
+//---------
+static const uint8_t* ref_mask_row(const lv_blend_esp_dsc_t* dsc, uint32_t y) {
+    return dsc->mask_buf ? dsc->mask_buf + y * dsc->mask_stride : NULL;
+}
+//---------
+// Destinatia swapped: se intoarce in RGB565, se amesteca si se scrie inapoi inversata (ca LVGL)
+static void ref_store(uint16_t* px, uint16_t val, bool swapped) {
+    *px = swapped ? ref_swap(val) : val;
+}
+//---------
+static uint16_t ref_load(const uint16_t* px, bool swapped) {
+    return swapped ? ref_swap(*px) : *px;
+}
+//---------
+static uint8_t ref_mix_of(lv_blend_esp_op_t op, uint8_t alpha, uint8_t mask, uint8_t opa) {
+    switch (op) {
+        case LV_BLEND_ESP_FILL:
+        case LV_BLEND_ESP_RGB565:
+            return 255;
+        case LV_BLEND_ESP_FILL_OPA:
+        case LV_BLEND_ESP_RGB565_OPA:
+            return opa;
+        case LV_BLEND_ESP_FILL_MASK:
+        case LV_BLEND_ESP_RGB565_MASK:
+            return mask;
+        case LV_BLEND_ESP_FILL_MASK_OPA:
+        case LV_BLEND_ESP_RGB565_MASK_OPA:
+            return REF_MIX2(mask, opa);
+        case LV_BLEND_ESP_ARGB8888:
+            return alpha;
+        case LV_BLEND_ESP_ARGB8888_OPA:
+            return REF_MIX2(alpha, opa);
+        case LV_BLEND_ESP_ARGB8888_MASK:
+            return REF_MIX2(alpha, mask);
+        default:
+            return REF_MIX3(alpha, mask, opa);
+    }
+}
+//---------
+static int ref_blend(lv_blend_esp_dsc_t* dsc, lv_blend_esp_op_t op, bool swapped) {
+    uint8_t opa = (uint8_t) dsc->opa;
+    for (uint32_t y = 0; y < dsc->dst_h; y++) {
+        uint16_t*      dst  = ref_dst_row(dsc, y);
+        const uint8_t* src  = op <= LV_BLEND_ESP_FILL_MASK_OPA ? NULL : ref_src_row(dsc, y);
+        const uint8_t* mask = ref_mask_row(dsc, y);
+        for (uint32_t x = 0; x < dsc->dst_w; x++) {
+            uint8_t  m = mask ? mask[x] : 255;
+            uint16_t d = ref_load(&dst[x], swapped);
+            if (op <= LV_BLEND_ESP_FILL_MASK_OPA) {
+                uint16_t c = ref_to_u16((const uint8_t*) dsc->src_buf);
+                ref_store(&dst[x], ref_mix_16_16(c, d, ref_mix_of(op, 255, m, opa)), swapped);
+            } else if (op <= LV_BLEND_ESP_RGB565_MASK_OPA) {
+                uint16_t s;
+                memcpy(&s, &src[x * 2], sizeof(s));
+                ref_store(&dst[x], ref_mix_16_16(s, d, ref_mix_of(op, 255, m, opa)), swapped);
+            } else {
+                const uint8_t* s = &src[x * 4];
+                ref_store(&dst[x], ref_mix_24_16(s, d, ref_mix_of(op, s[3], m, opa)), swapped);
+            }
+        }
+    }
+    return 1;
+}
+
+#define REF_FN(op_id, name)                                                                                            \
+    static int ref_##name##_rgb565(lv_blend_esp_dsc_t* dsc) { return ref_blend(dsc, op_id, false); }                   \
+    static int ref_##name##_rgb565_swapped(lv_blend_esp_dsc_t* dsc) { return ref_blend(dsc, op_id, true); }
+
+REF_FN(LV_BLEND_ESP_FILL, fill)
+REF_FN(LV_BLEND_ESP_FILL_OPA, fill_opa)
+REF_FN(LV_BLEND_ESP_FILL_MASK, fill_mask)
+REF_FN(LV_BLEND_ESP_FILL_MASK_OPA, fill_mask_opa)
+REF_FN(LV_BLEND_ESP_RGB565, rgb565)
+REF_FN(LV_BLEND_ESP_RGB565_OPA, rgb565_opa)
+REF_FN(LV_BLEND_ESP_RGB565_MASK, rgb565_mask)
+REF_FN(LV_BLEND_ESP_RGB565_MASK_OPA, rgb565_mask_opa)
+REF_FN(LV_BLEND_ESP_ARGB8888, argb8888)
+REF_FN(LV_BLEND_ESP_ARGB8888_OPA, argb8888_opa)
+REF_FN(LV_BLEND_ESP_ARGB8888_MASK, argb8888_mask)
+REF_FN(LV_BLEND_ESP_ARGB8888_MASK_OPA, argb8888_mask_opa)
+
+#define REF_ROW(suffix)                                                                                                \
+    {                                                                                                                  \
+        ref_fill_##suffix, ref_fill_opa_##suffix, ref_fill_mask_##suffix, ref_fill_mask_opa_##suffix,                  \
+            ref_rgb565_##suffix, ref_rgb565_opa_##suffix, ref_rgb565_mask_##suffix, ref_rgb565_mask_opa_##suffix,      \
+            ref_argb8888_##suffix, ref_argb8888_opa_##suffix, ref_argb8888_mask_##suffix,                              \
+            ref_argb8888_mask_opa_##suffix,                                                                            \
+    }
+
+const lv_blend_esp_table_t lv_blend_esp_ref_table = {
+    .to_rgb565         = REF_ROW(rgb565),
+    .to_rgb565_swapped = REF_ROW(rgb565_swapped),
+};
@@ -0,0 +1,145 @@
+#pragma once
+
+#ifndef CLI_OUT_H
+#define CLI_OUT_H
+
+/*
+ * Iesire structurata pentru comenzi: `--json` sau `--bin` oriunde pe linia de comanda (scos
+ * inainte de esp_console_run, deci argtable-urile nu il vad). O comanda care stie scrie
+ * inregistrari in loc de tabelele pentru oameni:
+ *
+ *   cli_out_t* o = cli_out_get();
+ *   if (o) {
+ *       cli_out_record_begin(o, "uptime");
+ *       cli_out_uint(o, "us", esp_timer_get_time());
+ *       cli_out_record_end(o);
+ *   }
+ *
+ * --json: o linie JSON per inregistrare, {"type":"uptime","us":123}\n
+ * --bin:  un frame per inregistrare, fara '\0' in interior (COBS) si delimitat de '\0' la ambele
+ *         capete, ca textul intercalat (log-uri din alte task-uri) sa nu strice frame-ul urmator:
+ *
+ *   payload = CLI_OUT_BIN_MAGIC, tip (varint lungime + bytes), elemente..., CRC-16/CCITT (LE)
+ *   element = tag [cheie] valoare
+ *     tag & 0x0F: CLI_OUT_T_*
+ *     tag >> 4:   0 = fara cheie (in array), 1..13 = cheia cu indexul 0..12, 14 = indexul in
+ *                 urmatorul byte, 15 = cheie noua (varint lungime + bytes), primeste urmatorul
+ *                 index (cat timp sunt sub CLI_OUT_KEYS)
+ *     valori:     UINT varint, SINT varint zigzag, FLOAT float32 LE, STR varint lungime + bytes,
+ *                 OBJECT / ARRAY: elemente pana la un tag END
+ *
+ * Cheile se trimit o singura data per inregistrare: un array de task-uri plateste numele
+ * campurilor doar la primul element. Dictionarul incepe gol la fiecare frame, deci un frame
+ * pierdut nu strica urmatoarele.
+ *
+ * Fara alocari: toata starea e in cli_out_t. Emitter-ul si decodorul (tools/cli_out_dec.c, bin ->
+ * aceleasi linii JSON) nu depind de ESP-IDF.
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* #ifdef __cplusplus */
+
+#define CLI_OUT_DEPTH     (6)    // Obiecte / array-uri imbricate, cu tot cu radacina
+#define CLI_OUT_KEYS      (32)   // Chei indexate per inregistrare
+#define CLI_OUT_BUF       (128)  // Scrieri mici adunate inainte de write()
+#define CLI_OUT_BIN_MAGIC (0xC1)
+
+typedef enum {
+    CLI_OUT_TEXT = 0,  // Tabelele obisnuite; cli_out_get() == NULL
+    CLI_OUT_JSON,
+    CLI_OUT_BIN,
+} cli_out_mode_t;
+
+enum {
+    CLI_OUT_T_END = 0,
+    CLI_OUT_T_UINT,
+    CLI_OUT_T_SINT,
+    CLI_OUT_T_FLOAT,
+    CLI_OUT_T_STR,
+    CLI_OUT_T_TRUE,
+    CLI_OUT_T_FALSE,
+    CLI_OUT_T_NULL,
+    CLI_OUT_T_OBJECT,
+    CLI_OUT_T_ARRAY,
+};
+
+typedef void (*cli_out_write_fn_t)(void* ctx, const void* data, size_t len);
+
+typedef struct {
+    cli_out_mode_t     mode;
+    cli_out_write_fn_t write;
+    void*              ctx;
+
+    uint8_t depth;                    // 0 = in afara unei inregistrari
+    bool    is_array[CLI_OUT_DEPTH];
+    bool    has_items[CLI_OUT_DEPTH];  // JSON: virgula inainte de urmatorul element
+
+    const char* keys[CLI_OUT_KEYS];  // Bin: dictionarul inregistrarii curente
+    uint8_t     key_count;
+
+    uint8_t  block[254];  // Bin: bytes COBS ai blocului curent (fara byte-ul de cod)
+    uint8_t  block_len;
+    uint16_t crc;
+
+    char   buf[CLI_OUT_BUF];
+    size_t len;
+
+    uint32_t records;
+    uint32_t bytes;   // Trimisi la write()
+    bool     error;   // Apeluri in ordine gresita (ignorate)
+} cli_out_t;
+
+void cli_out_init(cli_out_t* o, cli_out_mode_t mode, cli_out_write_fn_t write, void* ctx);
+
+/* O inregistrare = obiectul radacina; type ajunge in campul "type" */
+void cli_out_record_begin(cli_out_t* o, const char* type);
+void cli_out_record_end(cli_out_t* o);  // Trimite si tot ce e in buffer
+
+/* key == NULL doar pentru elementele unui array */
+void cli_out_object_begin(cli_out_t* o, const char* key);
+void cli_out_object_end(cli_out_t* o);
+void cli_out_array_begin(cli_out_t* o, const char* key);
+void cli_out_array_end(cli_out_t* o);
+
+void cli_out_uint(cli_out_t* o, const char* key, uint64_t value);
+void cli_out_int(cli_out_t* o, const char* key, int64_t value);
+void cli_out_float(cli_out_t* o, const char* key, float value);  // JSON: "%.7g", bin: float32
+void cli_out_bool(cli_out_t* o, const char* key, bool value);
+void cli_out_null(cli_out_t* o, const char* key);
+void cli_out_str(cli_out_t* o, const char* key, const char* value);  // NULL -> null
+void cli_out_strn(cli_out_t* o, const char* key, const char* value, size_t len);
+
+void cli_out_flush(cli_out_t* o);
+
+/**
+ * @brief Scoate `--json` / `--bin` (cuvinte intregi, in afara ghilimelelor) din line, in loc.
+ * @return modul cerut (ultimul gasit), CLI_OUT_TEXT daca niciunul
+ */
+cli_out_mode_t cli_out_take_flag(char* line);
+
+/* Formatul numerelor, comun emitter-ului JSON si decodorului */
+int cli_out_format_float(char* buf, size_t size, float value);
+
+/* --- Pe placa (cli_out_esp.c) --- */
+
+/* Emitter-ul comenzii care ruleaza, NULL in modul text */
+cli_out_t* cli_out_get(void);
+
+/**
+ * @brief esp_console_run cu `--json` / `--bin` scos din line. In modurile structurate o eroare
+ *        devine o inregistrare "error"; *mode spune apelantului daca mai afiseaza el ceva.
+ *        O comanda rulata dintr-o alta (run) mosteneste modul, daca nu are flag-ul ei.
+ * @return rezultatul esp_console_run
+ */
+int cli_out_run(char* line, int* ret, cli_out_mode_t* mode);
+
+#ifdef __cplusplus
+}
+#endif /* #ifdef __cplusplus */
+
+#endif /* #ifndef CLI_OUT_H */
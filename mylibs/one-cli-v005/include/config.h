@@ -7,6 +7,13 @@
 #define CONSOLE_PROMPT_MAX_LEN (32)
 
 #define CONFIG_CONSOLE_STORE_HISTORY (1)
+#define CONSOLE_HISTORY_MAX_LEN (100)         // Comenzi pastrate (linenoise si fisierul)
+#define CONSOLE_HISTORY_PENDING (1024)        // Bytes de comenzi adunate in RAM intre doua scrieri
+#define CONSOLE_HISTORY_FLUSH_MS (3000)       // Scrie dupa atata liniste la tastatura...
+#define CONSOLE_HISTORY_FLUSH_MAX_MS (15000)  // ...dar nu mai tarziu de atat de la prima comanda
+#define CONSOLE_HISTORY_SYNC_WAIT_MS (1000)   // cli_history_sync() la restart
+#define CONSOLE_HISTORY_MOUNT_WAIT_MS (5000)  // Cat asteapta consola montarea lui MOUNT_PATH (cli_set_history_wait)
+#define CONSOLE_HISTORY_TASK_STACK (3072)
 #define CONFIG_CONSOLE_IGNORE_EMPTY_LINES (1)
 #define PROMPT_STR CONFIG_IDF_TARGET
 
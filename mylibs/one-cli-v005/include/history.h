@@ -0,0 +1,130 @@
+#pragma once
+
+#ifndef CLI_HISTORY_H
+#define CLI_HISTORY_H
+
+/*
+ * Istoricul comenzilor pe filesystem, fara rescrierea intregului fisier la fiecare Enter.
+ *
+ * Doua fisiere, fiecare cu un antet `<fnv1a 8 hex>#<generatie 8 hex>\n` urmat de inregistrari
+ * `<fnv1a 8 hex> <comanda>\n`:
+ *   - path:       ultimele max_len comenzi, rescris doar la compactare (tmp + rename)
+ *   - path.log:   comenzile de dupa, la care doar se adauga; tinut sub CLI_HISTORY_LOG_MAX ca
+ *                 littlefs sa-l pastreze inline in metadate (un append nu copiaza un bloc de 4 KB)
+ * Comenzile se strang in RAM (cli_history_push) si se scriu in loturi (cli_history_flush). Cand
+ * jurnalul ar depasi CLI_HISTORY_LOG_MAX, lotul intra direct intr-o compactare: fisierul nou are
+ * generatia + 1, iar un jurnal ramas cu generatia veche (pierdere de alimentare intre rename si
+ * remove) e ignorat la incarcare, deci nimic nu apare de doua ori.
+ *
+ * Incarcarea ignora inregistrarile rupte sau corupte (o scriere intrerupta) si, daca a gasit asa
+ * ceva, compacteaza imediat. Un fisier vechi, scris de linenoiseHistorySave (linii simple), e
+ * incarcat ca atare si convertit.
+ *
+ * Partea de format nu depinde de ESP-IDF: accesul la fisiere trece prin cli_history_io_t
+ * (stdio/VFS pe placa, littlefs direct in host/bench_cli_history.c).
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* #ifdef __cplusplus */
+
+#define CLI_HISTORY_LINE_MAX (256 + 16)  // CONSOLE_MAX_CMDLINE_LENGTH + hash + separatori
+#define CLI_HISTORY_PATH_MAX (72)
+#define CLI_HISTORY_LOG_MAX  (448)  // Sub inline_max al littlefs (cache_size = 512)
+
+/* Acces la fisiere; file e un handle opac, NULL = nu s-a putut deschide */
+typedef struct {
+    void* (*open)(void* ctx, const char* path, const char* mode);  // "r", "a" sau "w"
+    int (*read)(void* ctx, void* file, void* buf, size_t len);     // bytes cititi, 0 la sfarsit, < 0 eroare
+    int (*write)(void* ctx, void* file, const void* buf, size_t len);  // 0 sau < 0
+    int (*close)(void* ctx, void* file);  // Scrie pe flash tot ce a ramas (sync), 0 sau < 0
+    int (*rename)(void* ctx, const char* from, const char* to);
+    int (*remove)(void* ctx, const char* path);
+    void* ctx;
+} cli_history_io_t;
+
+/* Pentru fiecare comanda incarcata, de la cea mai veche */
+typedef void (*cli_history_add_fn_t)(void* ctx, const char* line);
+
+typedef struct {
+    const cli_history_io_t* io;
+    char                    path[CLI_HISTORY_PATH_MAX];
+    char                    log_path[CLI_HISTORY_PATH_MAX + 4];
+    char                    tmp_path[CLI_HISTORY_PATH_MAX + 4];
+    uint32_t                max_len;       // Comenzi pastrate dupa compactare
+    uint32_t                generation;    // A fisierului compactat; jurnalul o repeta in antet
+    uint32_t                base_records;  // Inregistrari in fisierul compactat
+    uint32_t                log_records;   // ... si in jurnal
+    size_t                  log_bytes;     // 0 = jurnalul nu exista (sau e din alta generatie)
+    bool                    damaged;       // O adaugare a esuat la jumatate: compactare inainte de urmatoarea
+
+    char*    pending;        // Adunate de cli_history_push
+    size_t   pending_len;
+    uint32_t pending_count;
+    char*    writing;        // Lotul scris de cli_history_write
+    size_t   writing_len;
+    uint32_t writing_count;
+    size_t   buffer_size;
+
+    uint32_t flushes;      // Loturi scrise
+    uint32_t compactions;
+    uint32_t dropped;      // Comenzi care nu au mai incaput in RAM (raman doar in linenoise)
+    uint32_t skipped;      // Inregistrari rupte / corupte gasite la incarcare
+} cli_history_t;
+
+/**
+ * @brief Aloca cele doua buffere (de buffer_size bytes fiecare).
+ * @return false daca nu e memorie sau path-ul e prea lung
+ */
+bool cli_history_init(cli_history_t* h, const cli_history_io_t* io, const char* path, uint32_t max_len,
+    size_t buffer_size);
+
+void cli_history_deinit(cli_history_t* h);
+
+/**
+ * @brief Citeste fisierul compactat si jurnalul si trimite ultimele max_len comenzi la add. Sterge
+ *        fisierele ramase de la o compactare intrerupta; compacteaza daca istoricul e vechi sau rupt.
+ * @return comenzi incarcate
+ */
+uint32_t cli_history_load(cli_history_t* h, cli_history_add_fn_t add, void* ctx);
+
+/**
+ * @brief Adauga o comanda in RAM (fara acces la fisiere).
+ * @return true cand bufferul e plin peste 3/4: lotul trebuie scris curand
+ */
+bool cli_history_push(cli_history_t* h, const char* line);
+
+/* Muta comenzile adunate in lotul de scris (daca cel anterior a fost scris). Sub lock-ul lui push. */
+void cli_history_swap(cli_history_t* h);
+
+/**
+ * @brief Scrie lotul: append la jurnal sau, daca jurnalul s-ar umple, compactare cu tot cu lot.
+ *        Doar fisiere, fara lock-ul lui push: comenzile noi se aduna in paralel. Un lot nescris
+ *        ramane pentru data viitoare.
+ * @return 0 sau eroarea io
+ */
+int cli_history_write(cli_history_t* h);
+
+/* swap + write, pentru un singur thread */
+int cli_history_flush(cli_history_t* h);
+
+/* --- Pe placa (history_esp.c): linenoise + task-ul care scrie loturile --- */
+
+/* Incarca istoricul in linenoise si porneste scrierea in fundal */
+bool cli_history_start(const char* path);
+
+/* Dupa fiecare comanda nevida (in loc de linenoiseHistorySave) */
+void cli_history_note(const char* line);
+
+/* Scrie imediat ce e in RAM (iesirea din consola, restart) */
+void cli_history_sync(void);
+
+#ifdef __cplusplus
+}
+#endif /* #ifdef __cplusplus */
+
+#endif /* #ifndef CLI_HISTORY_H */
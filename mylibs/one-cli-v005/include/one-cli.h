@@ -7,6 +7,7 @@
 #warning "Acest cod este scris de Florin Aurel Baciu"
 #pragma GCC diagnostic pop
 
+#include <stdbool.h>
 #include <string.h>
 #include <unistd.h>
 #include <fcntl.h>
@@ -32,9 +33,17 @@ extern "C"
 {
 #endif /* #ifdef __cplusplus */
 
+    typedef void (*cli_register_fn_t)(void);
+    // true = path e pe un filesystem montat (asteapta cel mult timeout_ms)
+    typedef bool (*cli_path_wait_fn_t)(const char *path, uint32_t timeout_ms);
+
     // register all commands
     void cli_register_all_commands(void);
+    // commands from outside one-cli (ex. main); call before StartCLI()
+    bool cli_add_external_command(cli_register_fn_t register_fn);
     void cli_set_history_path(const char *path);
+    // filesystem montat in fundal: consola asteapta istoricul inainte sa-l incarce; call before StartCLI()
+    void cli_set_history_wait(cli_path_wait_fn_t wait_fn);
     void StartCLI();
 
 #ifdef __cplusplus
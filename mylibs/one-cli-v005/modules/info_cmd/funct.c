@@ -17,6 +17,7 @@
 #include "soc/rtc.h"
 #include "freertos/timers.h"
 #include "esp_timer.h"
+#include "cli_out.h"
 
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
@@ -35,6 +36,16 @@ void printSysInfo()
 {
     esp_chip_info_t chip_info;
     esp_chip_info(&chip_info);
+    cli_out_t *out = cli_out_get();
+    if (out)
+    {
+        cli_out_record_begin(out, "sys");
+        cli_out_str(out, "model", CONFIG_IDF_TARGET);
+        cli_out_uint(out, "cores", chip_info.cores);
+        cli_out_uint(out, "revision", chip_info.revision);
+        cli_out_record_end(out);
+        return;
+    }
     printf("System Info:\n");
     printf("  Model: %s\n", CONFIG_IDF_TARGET);
     printf("  Cores: %d\n", chip_info.cores);
@@ -50,6 +61,14 @@ void printFlashInfo()
 {
     uint32_t flash_size;
     esp_flash_get_size(NULL, &flash_size);
+    cli_out_t *out = cli_out_get();
+    if (out)
+    {
+        cli_out_record_begin(out, "flash");
+        cli_out_uint(out, "size", flash_size);
+        cli_out_record_end(out);
+        return;
+    }
     printf("Flash Info:\n  Size: %lu bytes\n", (unsigned long)flash_size);
     return;
 }
@@ -98,8 +117,38 @@ const char *MEMORY_TAG = "MEMORY";
  * @note This function prints the memory information in a formatted way
  * @note It uses ESP_LOGI for logging if USE_ESP_LOGI is defined, otherwise it uses printf
  */
+/* `info ram --json|--bin`: bytes, nu KB si procente (le calculeaza cine citeste) */
+#define MEM_RECORD_ROW(out, label, caps)                                       \
+    do                                                                         \
+    {                                                                          \
+        cli_out_object_begin(out, NULL);                                       \
+        cli_out_str(out, "segment", label);                                    \
+        cli_out_uint(out, "total", heap_caps_get_total_size(caps));            \
+        cli_out_uint(out, "free", heap_caps_get_free_size(caps));              \
+        cli_out_uint(out, "min_free", heap_caps_get_minimum_free_size(caps));  \
+        cli_out_uint(out, "largest", heap_caps_get_largest_free_block(caps));  \
+        cli_out_object_end(out);                                               \
+    } while (0)
+
 void printInfoAboutMemory()
 {
+    cli_out_t *out = cli_out_get();
+    if (out)
+    {
+        cli_out_record_begin(out, "ram");
+        cli_out_array_begin(out, "segments");
+        MEM_RECORD_ROW(out, "RAM", MALLOC_CAP_INTERNAL);
+        MEM_RECORD_ROW(out, "RAM-DMA", MALLOC_CAP_DMA);
+        MEM_RECORD_ROW(out, "RAM 8 bit", MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+        MEM_RECORD_ROW(out, "RAM 32 bit", MALLOC_CAP_INTERNAL | MALLOC_CAP_32BIT);
+        MEM_RECORD_ROW(out, "RTC RAM", MALLOC_CAP_RTCRAM);
+        MEM_RECORD_ROW(out, "PSRAM", MALLOC_CAP_SPIRAM);
+        MEM_RECORD_ROW(out, "PSRAM 8 bit", MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+        MEM_RECORD_ROW(out, "PSRAM 32 bit", MALLOC_CAP_SPIRAM | MALLOC_CAP_32BIT);
+        cli_out_array_end(out);
+        cli_out_record_end(out);
+        return;
+    }
 #if (USE_PRINTF == 1)
     printf("╔═══════════════════════════════ MEMORY STATS ═════════════════════════════╗\n");
     printf("║   Segment     │    Total     │    Used     │   Free      │ Utilizare %%   ║\n");
@@ -198,6 +247,21 @@ void get_version(int argc, char **argv)
         printf("Get flash size failed");
         return;
     }
+    cli_out_t *out = cli_out_get();
+    if (out)
+    {
+        cli_out_record_begin(out, "version");
+        cli_out_str(out, "idf", esp_get_idf_version());
+        cli_out_str(out, "model", model);
+        cli_out_uint(out, "cores", info.cores);
+        cli_out_uint(out, "features", info.features);
+        cli_out_uint(out, "revision", info.revision);
+        cli_out_uint(out, "flash_size", flash_size);
+        cli_out_str(out, "firmware", CONFIG_APP_PROJECT_VER);
+        cli_out_str(out, "compiled", __DATE__ " " __TIME__);
+        cli_out_record_end(out);
+        return;
+    }
     printf("IDF Version:%s\r\n", esp_get_idf_version());
     printf("Chip info:\r\n");
     printf("\tmodel:%s\r\n", model);
@@ -4,6 +4,7 @@
 #include "esp_log.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
+#include "cli_out.h"
 
 static const char* TAG = "STACK";
 
@@ -20,6 +21,23 @@ void print_task_stack_info(void) {
                                                        numTasks,
                                                    NULL);
     // clang-format on
+    cli_out_t* out = cli_out_get();
+    if (out) {
+        cli_out_record_begin(out, "stack");
+        cli_out_array_begin(out, "tasks");
+        for (UBaseType_t i = 0; i < arraySize; i++) {
+            cli_out_object_begin(out, NULL);
+            cli_out_str(out, "name", taskStatusArray[i].pcTaskName);
+            cli_out_uint(out, "high_water", taskStatusArray[i].usStackHighWaterMark * sizeof(StackType_t));
+            cli_out_uint(out, "state", taskStatusArray[i].eCurrentState);
+            cli_out_uint(out, "prio", taskStatusArray[i].uxCurrentPriority);
+            cli_out_object_end(out);
+        }
+        cli_out_array_end(out);
+        cli_out_record_end(out);
+        free(taskStatusArray);
+        return;
+    }
     printf("╔═════════════════════════════════════════════════════╗\n");
     printf("║ %-20s │ %-12s │ %-5s │ %-5s ║\n", "Task", "High Water", "State", "Prio");
     printf("╟──────────────────────┼──────────────┼───────┼───────╢\n");
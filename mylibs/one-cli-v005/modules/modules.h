@@ -15,5 +15,6 @@
 #include "modules/uptime_cmd/uptime_cmd.h"
 #include "modules/wifi_cmd/wifi_cmd.h"
 #include "modules/perfmon_cmd/perfmon_cmd.h"
+#include "modules/run_cmd/run_cmd.h"
 
 #endif /* MODULES_H_ */
\ No newline at end of file
@@ -20,6 +20,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include "nvs_cmd.h"
+#include "sysmon_hardware.h"  // Utilizarea NVS din /hardware se reconstruieste dupa commit
 
 static const char *TAG = "CLI";
 
@@ -144,6 +145,9 @@ static esp_err_t store_blob(nvs_handle_t nvs, const char* key, const char* str_v
 
     if (err == ESP_OK) {
         err = nvs_commit(nvs);
+        if (err == ESP_OK) {
+            sysmon_hardware_note_nvs_commit();
+        }
     }
 
     return err;
@@ -235,6 +239,7 @@ static esp_err_t set_value_in_nvs(const char* key, const char* str_type, const c
     if (err == ESP_OK) {
         err = nvs_commit(nvs);
         if (err == ESP_OK) {
+            sysmon_hardware_note_nvs_commit();
             ESP_LOGI(TAG, "Value stored under key '%s'", key);
         }
     }
@@ -335,6 +340,7 @@ static esp_err_t erase(const char* key) {
         if (err == ESP_OK) {
             err = nvs_commit(nvs);
             if (err == ESP_OK) {
+                sysmon_hardware_note_nvs_commit();
                 ESP_LOGI(TAG, "Value with key '%s' erased", key);
             }
         }
@@ -352,6 +358,9 @@ static esp_err_t erase_all(const char* name) {
         err = nvs_erase_all(nvs);
         if (err == ESP_OK) {
             err = nvs_commit(nvs);
+            if (err == ESP_OK) {
+                sysmon_hardware_note_nvs_commit();
+            }
         }
     }
 
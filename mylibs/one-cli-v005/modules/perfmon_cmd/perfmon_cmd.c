@@ -8,6 +8,7 @@
 #include "esp_sleep.h"
 #include "sdkconfig.h"
 #include "perfmon.h"
+#include "cli_out.h"
 
 #include "perfmon_cmd.h"
 
@@ -48,33 +49,63 @@ static uint32_t pm_check_table[] = {
 #define TOTAL_CALL_AMOUNT 200 //
 #define PERFMON_TRACELEVEL -1 // -1 - will ignore trace level
 
+/* Un contor ca element in array-ul "counters" (in loc de xtensa_perfmon_view_cb pe stdout) */
+static void perfmon_record_cb(void* params, uint32_t select, uint32_t mask, uint32_t value) {
+    cli_out_t* out = (cli_out_t*) params;
+    cli_out_object_begin(out, NULL);
+    cli_out_uint(out, "select", select);
+    cli_out_uint(out, "mask", mask);
+    cli_out_uint(out, "value", value);
+    cli_out_object_end(out);
+}
+
+static void perfmon_run(xtensa_perfmon_config_t* pm_config, const char* test, cli_out_t* out) {
+    if (out == NULL) {
+        pm_config->callback        = xtensa_perfmon_view_cb;
+        pm_config->callback_params = stdout;
+        xtensa_perfmon_exec(pm_config);
+        return;
+    }
+    pm_config->callback        = perfmon_record_cb;
+    pm_config->callback_params = out;
+    cli_out_record_begin(out, "perfmon");
+    cli_out_str(out, "test", test);
+    cli_out_uint(out, "repeat", pm_config->repeat_count);
+    cli_out_array_begin(out, "counters");
+    xtensa_perfmon_exec(pm_config);
+    cli_out_array_end(out);
+    cli_out_record_end(out);
+}
+
 bool app_main_perfmon(void) {
-    ESP_LOGI(TAG, "Start");
-    ESP_LOGI(TAG, "Start test with printing all available statistic");
+    cli_out_t* out = cli_out_get();  // Log-urile ar amesteca text printre inregistrari
+    if (!out) {
+        ESP_LOGI(TAG, "Start");
+        ESP_LOGI(TAG, "Start test with printing all available statistic");
+    }
     xtensa_perfmon_config_t pm_config = {};
     pm_config.counters_size   = sizeof(xtensa_perfmon_select_mask_all) / sizeof(uint32_t) / 2;
     pm_config.select_mask     = xtensa_perfmon_select_mask_all;
     pm_config.repeat_count    = TOTAL_CALL_AMOUNT;
     pm_config.max_deviation   = 1;
     pm_config.call_function   = exec_test_function;
-    pm_config.callback        = xtensa_perfmon_view_cb;
-    pm_config.callback_params = stdout;
     pm_config.tracelevel      = PERFMON_TRACELEVEL;
-    xtensa_perfmon_exec(&pm_config);
+    perfmon_run(&pm_config, "all", out);
 
-    ESP_LOGI(TAG, "Start test with user defined statistic");
+    if (!out) {
+        ESP_LOGI(TAG, "Start test with user defined statistic");
+    }
     pm_config.counters_size   = sizeof(pm_check_table) / sizeof(uint32_t) / 2;
     pm_config.select_mask     = pm_check_table;
     pm_config.repeat_count    = TOTAL_CALL_AMOUNT;
     pm_config.max_deviation   = 1;
     pm_config.call_function   = exec_test_function;
-    pm_config.callback        = xtensa_perfmon_view_cb;
-    pm_config.callback_params = stdout;
     pm_config.tracelevel      = PERFMON_TRACELEVEL;
+    perfmon_run(&pm_config, "user", out);
 
-    xtensa_perfmon_exec(&pm_config);
-
-    ESP_LOGI(TAG, "The End");
+    if (!out) {
+        ESP_LOGI(TAG, "The End");
+    }
     return 1;
 }
 
@@ -0,0 +1,457 @@
+#include "cli_script.h"
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SCRIPT_MAX_ARGS (8)  // Pentru filtrele de aici
+
+typedef int (*script_builtin_fn_t)(cli_script_t* s, int argc, char** argv, const char* input, size_t input_len,
+    cli_script_out_t* out);
+
+typedef struct {
+    const char*         name;
+    script_builtin_fn_t fn;
+} script_builtin_t;
+
+/* Raportul unei etape, afisat dupa pipeline */
+typedef struct {
+    int     status;  // CLI_SCRIPT_EXEC_*
+    int     ret;
+    int64_t us;
+    bool    truncated;
+} script_report_t;
+
+// -------------------------------------
+
+static bool script_is_space(char c) {
+    return c == ' ' || c == '\t' || c == '\r';
+}
+//---------
+/* Etapa [start, end) fara spatiile de la capete */
+static cli_script_span_t script_trim(const char* start, const char* end) {
+    while (start < end && script_is_space(*start)) {
+        start++;
+    }
+    while (end > start && script_is_space(end[-1])) {
+        end--;
+    }
+    return (cli_script_span_t){start, (size_t) (end - start)};
+}
+//---------
+/* Ca esp_console_split_argv: ghilimele duble, `\` scapa urmatorul caracter; in loc, in buf */
+static int script_split(char* buf, char** argv, int max) {
+    int   argc = 0;
+    char* in   = buf;
+    while (*in && argc < max) {
+        while (script_is_space(*in)) {
+            in++;
+        }
+        if (!*in) {
+            break;
+        }
+        char* out    = in;
+        argv[argc++] = out;
+        bool quoted  = false;
+        for (; *in; in++) {
+            if (*in == '\\' && in[1]) {
+                *out++ = *++in;
+            } else if (*in == '"') {
+                quoted = !quoted;
+            } else if (!quoted && script_is_space(*in)) {
+                in++;
+                break;
+            } else {
+                *out++ = *in;
+            }
+        }
+        *out = '\0';
+    }
+    return argc;
+}
+//---------
+static void script_emit(cli_script_t* s, cli_script_out_t* out, const char* data, size_t len) {
+    if (out) {
+        cli_script_out_write(out, data, len);
+    } else {
+        s->env->print(s->env->ctx, data, len);
+    }
+}
+//---------
+static void script_printf(cli_script_t* s, cli_script_out_t* out, const char* fmt, ...) __attribute__((format(printf, 3, 4)));
+static void script_printf(cli_script_t* s, cli_script_out_t* out, const char* fmt, ...) {
+    char    text[CLI_SCRIPT_LINE_MAX + 64];
+    va_list ap;
+    va_start(ap, fmt);
+    int n = vsnprintf(text, sizeof(text), fmt, ap);
+    va_end(ap);
+    if (n > 0) {
+        script_emit(s, out, text, (size_t) n < sizeof(text) ? (size_t) n : sizeof(text) - 1);
+    }
+}
+//---------
+/* Urmatoarea linie din [*pos, len), fara '\n'; false la sfarsit */
+static bool script_next_line(const char* data, size_t len, size_t* pos, const char** line, size_t* line_len) {
+    if (*pos >= len) {
+        return false;
+    }
+    const char* start = data + *pos;
+    const char* nl    = memchr(start, '\n', len - *pos);
+    *line             = start;
+    *line_len         = nl ? (size_t) (nl - start) : len - *pos;
+    *pos += *line_len + (nl ? 1 : 0);
+    return true;
+}
+//---------
+static bool script_contains(const char* line, size_t len, const char* needle) {
+    size_t n = strlen(needle);
+    for (size_t i = 0; n <= len && i <= len - n; i++) {
+        if (memcmp(line + i, needle, n) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// -------------------------------------
+// Filtre pentru `|`: lucreaza pe iesirea etapei anterioare
+
+static int script_grep(cli_script_t* s, int argc, char** argv, const char* input, size_t input_len,
+    cli_script_out_t* out) {
+    bool        invert = false, count = false;
+    const char* needle = NULL;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "-v")) {
+            invert = true;
+        } else if (!strcmp(argv[i], "-c")) {
+            count = true;
+        } else if (needle == NULL) {
+            needle = argv[i];
+        } else {
+            needle = NULL;
+            break;
+        }
+    }
+    if (needle == NULL) {
+        script_printf(s, NULL, "usage: grep [-v] [-c] <text>\n");
+        return 1;
+    }
+    size_t      pos = 0, line_len, matched = 0;
+    const char* line;
+    while (script_next_line(input, input_len, &pos, &line, &line_len)) {
+        if (script_contains(line, line_len, needle) != invert) {
+            matched++;
+            if (!count) {
+                script_emit(s, out, line, line_len);
+                script_emit(s, out, "\n", 1);
+            }
+        }
+    }
+    if (count) {
+        script_printf(s, out, "%u\n", (unsigned) matched);
+    }
+    return matched ? 0 : 1;  // Ca grep: 1 daca nu a gasit nimic
+}
+//---------
+static long script_count_arg(int argc, char** argv) {
+    int i = (argc > 1 && !strcmp(argv[1], "-n")) ? 2 : 1;
+    if (argc == i) {
+        return 10;
+    }
+    char* end;
+    long  n = strtol(argv[i], &end, 10);
+    return (argc == i + 1 && *end == '\0' && n >= 0) ? n : -1;
+}
+//---------
+static int script_head(cli_script_t* s, int argc, char** argv, const char* input, size_t input_len,
+    cli_script_out_t* out) {
+    long n = script_count_arg(argc, argv);
+    if (n < 0) {
+        script_printf(s, NULL, "usage: head [-n] [lines]\n");
+        return 1;
+    }
+    size_t      pos = 0, line_len;
+    const char* line;
+    for (long i = 0; i < n && script_next_line(input, input_len, &pos, &line, &line_len); i++) {
+    }
+    script_emit(s, out, input, pos);
+    return 0;
+}
+//---------
+static int script_tail(cli_script_t* s, int argc, char** argv, const char* input, size_t input_len,
+    cli_script_out_t* out) {
+    long n = script_count_arg(argc, argv);
+    if (n < 0) {
+        script_printf(s, NULL, "usage: tail [-n] [lines]\n");
+        return 1;
+    }
+    size_t start = input_len;
+    if (start && input[start - 1] == '\n') {
+        start--;  // '\n'-ul ultimei linii nu incepe o linie noua
+    }
+    for (long lines = 0; start > 0; start--) {
+        if (input[start - 1] == '\n' && ++lines == n) {
+            break;
+        }
+    }
+    if (n == 0) {
+        start = input_len;
+    }
+    script_emit(s, out, input + start, input_len - start);
+    return 0;
+}
+//---------
+static int script_wc(cli_script_t* s, int argc, char** argv, const char* input, size_t input_len,
+    cli_script_out_t* out) {
+    bool lines_only = argc == 2 && !strcmp(argv[1], "-l");
+    if (argc > 1 && !lines_only) {
+        script_printf(s, NULL, "usage: wc [-l]\n");
+        return 1;
+    }
+    size_t lines = 0, words = 0;
+    bool   in_word = false;
+    for (size_t i = 0; i < input_len; i++) {
+        char c = input[i];
+        lines += c == '\n';
+        bool space = c == '\n' || script_is_space(c);
+        words += !space && !in_word;
+        in_word = !space;
+    }
+    if (lines_only) {
+        script_printf(s, out, "%u\n", (unsigned) lines);
+    } else {
+        script_printf(s, out, "%u %u %u\n", (unsigned) lines, (unsigned) words, (unsigned) input_len);
+    }
+    return 0;
+}
+
+static const script_builtin_t s_builtins[] = {
+    {"grep", script_grep},
+    {"head", script_head},
+    {"tail", script_tail},
+    {"wc", script_wc},
+};
+
+//---------
+static const script_builtin_t* script_find_builtin(const char* cmdline) {
+    while (script_is_space(*cmdline)) {
+        cmdline++;
+    }
+    size_t n = strcspn(cmdline, " \t\r");
+    for (size_t i = 0; i < sizeof(s_builtins) / sizeof(s_builtins[0]); i++) {
+        if (strlen(s_builtins[i].name) == n && !memcmp(cmdline, s_builtins[i].name, n)) {
+            return &s_builtins[i];
+        }
+    }
+    return NULL;
+}
+
+// -------------------------------------
+
+static const char* script_report_status(const script_report_t* r, char* buf, size_t size) {
+    switch (r->status) {
+        case CLI_SCRIPT_EXEC_OK:
+            if (r->ret != 0) {
+                snprintf(buf, size, "ret=%d", r->ret);
+                return buf;
+            }
+            return r->truncated ? "trunc" : "ok";
+        case CLI_SCRIPT_EXEC_NOT_FOUND:
+            return "unknown";
+        default:
+            return "error";
+    }
+}
+//---------
+/* Ruleaza etapele una dupa alta; false daca una a esuat (restul pipeline-ului nu mai ruleaza) */
+static bool script_pipeline(cli_script_t* s, const cli_script_pipeline_t* pl) {
+    const cli_script_env_t* env = s->env;
+    script_report_t         report[CLI_SCRIPT_MAX_STAGES];
+    const char*             input     = NULL;
+    size_t                  input_len = 0;
+    uint32_t                ran       = 0;
+    bool                    ok        = true;
+
+    for (uint32_t i = 0; i < pl->count && ok; i++) {
+        bool             last = i + 1 == pl->count;
+        cli_script_out_t out  = {s->pipe[i & 1], 0, CLI_SCRIPT_PIPE_MAX, false};
+        memcpy(s->cmdline, pl->stage[i].start, pl->stage[i].len);
+        s->cmdline[pl->stage[i].len] = '\0';
+
+        script_report_t*        r       = &report[ran++];
+        const script_builtin_t* builtin = script_find_builtin(s->cmdline);
+        int64_t                 start   = env->now_us(env->ctx);
+        r->ret                          = 0;
+        if (builtin) {
+            char* argv[SCRIPT_MAX_ARGS];
+            int   argc = script_split(s->cmdline, argv, SCRIPT_MAX_ARGS);
+            r->status  = CLI_SCRIPT_EXEC_OK;
+            r->ret     = builtin->fn(s, argc, argv, input ? input : "", input_len, last ? NULL : &out);
+        } else {
+            r->status = env->exec(env->ctx, s->cmdline, input, input_len, last ? NULL : &out, &r->ret);
+        }
+        r->us        = env->now_us(env->ctx) - start;
+        r->truncated = !last && out.truncated;
+        s->result.commands++;
+
+        if (r->status == CLI_SCRIPT_EXEC_NOT_FOUND) {
+            script_printf(s, NULL, "Unrecognized command: %.*s\n", (int) pl->stage[i].len, pl->stage[i].start);
+        }
+        ok        = r->status == CLI_SCRIPT_EXEC_OK && r->ret == 0;
+        input     = out.data;
+        input_len = out.len;
+    }
+    s->result.pipelines++;
+
+    if (!(s->flags & CLI_SCRIPT_QUIET)) {
+        for (uint32_t i = 0; i < ran; i++) {
+            char           status[16];
+            const uint64_t us = report[i].us > 0 ? (uint64_t) report[i].us : 0;
+            script_printf(s, NULL, "# %3u %6lu.%03lu ms  %-7s %.*s\n", (unsigned) pl->line, (unsigned long) (us / 1000),
+                (unsigned long) (us % 1000), script_report_status(&report[i], status, sizeof(status)),
+                (int) (pl->stage[i].len < 48 ? pl->stage[i].len : 48), pl->stage[i].start);
+        }
+    }
+    return ok;
+}
+
+// -------------------------------------
+
+void cli_script_out_write(cli_script_out_t* out, const char* data, size_t len) {
+    size_t room = out->cap - out->len;
+    if (len > room) {
+        len            = room;
+        out->truncated = true;
+    }
+    memcpy(out->data + out->len, data, len);
+    out->len += len;
+}
+//---------
+void cli_script_parser_init(cli_script_parser_t* p, const char* text, size_t len) {
+    p->text = text;
+    p->len  = len;
+    p->pos  = 0;
+    p->line = 1;
+}
+//---------
+cli_script_status_t cli_script_next(cli_script_parser_t* p, cli_script_pipeline_t* pl) {
+    memset(pl, 0, sizeof(*pl));
+    // Spatii, linii goale, `;` in plus si comentarii
+    while (p->pos < p->len) {
+        char c = p->text[p->pos];
+        if (c == '#') {
+            while (p->pos < p->len && p->text[p->pos] != '\n') {
+                p->pos++;
+            }
+        } else if (c == '\n' || c == ';' || script_is_space(c)) {
+            p->line += c == '\n';
+            p->pos++;
+        } else {
+            break;
+        }
+    }
+    pl->line = p->line;
+    if (p->pos >= p->len) {
+        return CLI_SCRIPT_END;
+    }
+
+    size_t start  = p->pos;
+    bool   quoted = false;
+    for (;;) {
+        bool at_end = p->pos >= p->len;
+        char c      = at_end ? '\n' : p->text[p->pos];
+        if (!at_end && c == '\\' && p->pos + 1 < p->len) {
+            p->line += p->text[p->pos + 1] == '\n';  // `\` la sfarsit de linie: continua pe urmatoarea
+            p->pos += 2;
+            continue;
+        }
+        if (quoted && c != '"') {
+            if (c == '\n') {
+                return CLI_SCRIPT_ERR_QUOTE;
+            }
+            p->pos++;
+            continue;
+        }
+        if (c == '"') {
+            quoted = !quoted;
+            p->pos++;
+            continue;
+        }
+        if (c != '\n' && c != ';' && c != '|') {
+            p->pos++;
+            continue;
+        }
+        // Sfarsitul unei etape
+        cli_script_span_t stage = script_trim(p->text + start, p->text + p->pos);
+        if (stage.len == 0) {
+            return CLI_SCRIPT_ERR_EMPTY;
+        }
+        if (stage.len > CLI_SCRIPT_LINE_MAX) {
+            return CLI_SCRIPT_ERR_TOO_LONG;
+        }
+        if (pl->count == CLI_SCRIPT_MAX_STAGES) {
+            return CLI_SCRIPT_ERR_STAGES;
+        }
+        pl->stage[pl->count++] = stage;
+        if (c != '|') {
+            return CLI_SCRIPT_OK;  // '\n' / ';' raman pentru urmatorul apel
+        }
+        start = ++p->pos;
+    }
+}
+//---------
+const char* cli_script_status_str(cli_script_status_t status) {
+    switch (status) {
+        case CLI_SCRIPT_OK:
+        case CLI_SCRIPT_END:
+            return "ok";
+        case CLI_SCRIPT_ERR_QUOTE:
+            return "unterminated quote";
+        case CLI_SCRIPT_ERR_EMPTY:
+            return "empty command in pipeline";
+        case CLI_SCRIPT_ERR_STAGES:
+            return "too many commands in pipeline";
+        case CLI_SCRIPT_ERR_TOO_LONG:
+            return "command too long";
+    }
+    return "?";
+}
+//---------
+int cli_script_run(cli_script_t* s, const cli_script_env_t* env, uint32_t flags, const char* text, size_t len) {
+    cli_script_parser_t   p;
+    cli_script_pipeline_t pl;
+    cli_script_status_t   status;
+    memset(&s->result, 0, sizeof(s->result));
+    s->env   = env;
+    s->flags = flags;
+
+    // Tot scriptul trebuie sa fie corect inainte sa ruleze ceva (provisioning pe jumatate e mai rau)
+    cli_script_parser_init(&p, text, len);
+    while ((status = cli_script_next(&p, &pl)) == CLI_SCRIPT_OK) {
+    }
+    if (status != CLI_SCRIPT_END) {
+        s->result.syntax     = status;
+        s->result.error_line = pl.line;
+        script_printf(s, NULL, "line %u: %s, nothing was run\n", (unsigned) pl.line, cli_script_status_str(status));
+        return 1;
+    }
+
+    int64_t start = env->now_us(env->ctx);
+    cli_script_parser_init(&p, text, len);
+    while (cli_script_next(&p, &pl) == CLI_SCRIPT_OK) {
+        if (!script_pipeline(s, &pl)) {
+            s->result.failed++;
+            s->result.error_line = s->result.error_line ? s->result.error_line : pl.line;
+            if (!(flags & CLI_SCRIPT_KEEP_GOING)) {
+                break;
+            }
+        }
+    }
+    s->result.total_us = env->now_us(env->ctx) - start;
+
+    uint64_t us = s->result.total_us > 0 ? (uint64_t) s->result.total_us : 0;
+    script_printf(s, NULL, "# %u commands, %u failed, %lu.%03lu ms\n", (unsigned) s->result.commands,
+        (unsigned) s->result.failed, (unsigned long) (us / 1000), (unsigned long) (us % 1000));
+    return s->result.failed ? 1 : 0;
+}
@@ -0,0 +1,139 @@
+#pragma once
+
+#ifndef CLI_SCRIPT_H
+#define CLI_SCRIPT_H
+
+/*
+ * Scripturi pentru `run`: mai multe comenzi dintr-un fisier, din stdin sau din `run -c`, fara
+ * un round-trip prin prompt pentru fiecare.
+ *
+ *   # comentariu (doar la inceputul unei comenzi)
+ *   set log wifi debug; wifi join lab-ap secret
+ *   tasks | grep IDLE | wc
+ *
+ * Separatori: linie noua si `;` intre comenzi, `|` intre etapele unui pipeline. Ghilimelele duble
+ * si `\` ca in esp_console_split_argv: `echo "a;b"` si `echo a\|b` sunt o singura comanda. Iesirea
+ * unei etape (pana la CLI_SCRIPT_PIPE_MAX bytes) devine intrarea urmatoarei: stdin pentru comenzile
+ * din consola, textul filtrat pentru cele de aici (grep, head, tail, wc). Dupa fiecare pipeline
+ * vine cate o linie de raport per comanda, cu timpul ei.
+ *
+ * Fara dependente ESP-IDF: comenzile se ruleaza prin cli_script_env_t (esp_console_run pe placa,
+ * un registru fals in host/bench_cli_script.c).
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* #ifdef __cplusplus */
+
+#define CLI_SCRIPT_MAX_STAGES (8)     // Etape intr-un pipeline
+#define CLI_SCRIPT_LINE_MAX   (256)   // CONSOLE_MAX_CMDLINE_LENGTH
+#define CLI_SCRIPT_PIPE_MAX   (4096)  // Iesirea unei etape pastrata pentru urmatoarea
+#define CLI_SCRIPT_MAX_BYTES  (8192)  // Un script intreg (fisier / stdin)
+
+#define CLI_SCRIPT_KEEP_GOING (1u << 0)  // Continua dupa o comanda esuata
+#define CLI_SCRIPT_QUIET      (1u << 1)  // Fara liniile de raport per comanda (doar sumarul)
+
+typedef enum {
+    CLI_SCRIPT_OK = 0,
+    CLI_SCRIPT_END,             // Nu mai sunt comenzi
+    CLI_SCRIPT_ERR_QUOTE,       // Ghilimele neinchise pana la sfarsitul liniei
+    CLI_SCRIPT_ERR_EMPTY,       // Etapa goala intr-un pipeline ("a | | b", "a |")
+    CLI_SCRIPT_ERR_STAGES,      // Mai mult de CLI_SCRIPT_MAX_STAGES etape
+    CLI_SCRIPT_ERR_TOO_LONG,    // Comanda mai lunga decat CLI_SCRIPT_LINE_MAX
+} cli_script_status_t;
+
+/* Rezultatul env->exec */
+enum {
+    CLI_SCRIPT_EXEC_OK = 0,     // A rulat, codul de iesire e in *ret
+    CLI_SCRIPT_EXEC_NOT_FOUND,  // Comanda necunoscuta
+    CLI_SCRIPT_EXEC_ERROR,      // Eroare interna (argumente, memorie)
+};
+
+typedef struct {
+    const char* start;
+    size_t      len;
+} cli_script_span_t;
+
+/* O comanda din script: etapele ei, in ordine */
+typedef struct {
+    cli_script_span_t stage[CLI_SCRIPT_MAX_STAGES];
+    uint32_t          count;
+    uint32_t          line;  // Linia din script, de la 1
+} cli_script_pipeline_t;
+
+typedef struct {
+    const char* text;
+    size_t      len;
+    size_t      pos;
+    uint32_t    line;
+} cli_script_parser_t;
+
+/* Buffer de iesire: ce nu mai incape e aruncat si marcat */
+typedef struct {
+    char*  data;
+    size_t len;
+    size_t cap;
+    bool   truncated;
+} cli_script_out_t;
+
+typedef struct {
+    /**
+     * Ruleaza o comanda din consola. input != NULL: iesirea etapei anterioare (stdin-ul comenzii).
+     * out != NULL: iesirea se aduna acolo (urmeaza un `|`), altfel merge direct la consola.
+     * @return CLI_SCRIPT_EXEC_*
+     */
+    int (*exec)(void* ctx, const char* cmdline, const char* input, size_t input_len, cli_script_out_t* out, int* ret);
+    int64_t (*now_us)(void* ctx);
+    void (*print)(void* ctx, const char* text, size_t len);  // Consola: iesirea filtrelor, raportul
+    void* ctx;
+} cli_script_env_t;
+
+typedef struct {
+    uint32_t pipelines;    // Executate
+    uint32_t commands;     // Etape executate
+    uint32_t failed;       // Pipeline-uri esuate
+    uint32_t error_line;   // Prima linie cu eroare (sintaxa sau executie), 0 = niciuna
+    cli_script_status_t syntax;  // CLI_SCRIPT_OK sau eroarea de sintaxa (nimic nu a rulat)
+    int64_t  total_us;
+} cli_script_result_t;
+
+/* Toata starea unei rulari: ~8.5 KB, alocata o data de apelant */
+typedef struct {
+    const cli_script_env_t* env;
+    uint32_t                flags;
+    char                    pipe[2][CLI_SCRIPT_PIPE_MAX];
+    char                    cmdline[CLI_SCRIPT_LINE_MAX + 1];
+    cli_script_result_t     result;
+} cli_script_t;
+
+void cli_script_parser_init(cli_script_parser_t* p, const char* text, size_t len);
+
+/**
+ * @brief Urmatoarea comanda (pipeline) din script; sare peste liniile goale si comentarii.
+ * @return CLI_SCRIPT_OK, CLI_SCRIPT_END sau o eroare de sintaxa (pipeline->line = linia)
+ */
+cli_script_status_t cli_script_next(cli_script_parser_t* p, cli_script_pipeline_t* pipeline);
+
+/* Textul erorii de sintaxa */
+const char* cli_script_status_str(cli_script_status_t status);
+
+/**
+ * @brief Verifica tot scriptul, apoi il ruleaza. O eroare de sintaxa opreste totul inainte de
+ *        prima comanda; o comanda esuata (cod != 0, necunoscuta) opreste restul, cu exceptia
+ *        CLI_SCRIPT_KEEP_GOING.
+ * @return 0 daca totul a mers, 1 altfel (detalii in s->result)
+ */
+int cli_script_run(cli_script_t* s, const cli_script_env_t* env, uint32_t flags, const char* text, size_t len);
+
+/* Adauga la un buffer de iesire (si pentru captura stdout-ului pe placa) */
+void cli_script_out_write(cli_script_out_t* out, const char* data, size_t len);
+
+#ifdef __cplusplus
+}
+#endif /* #ifdef __cplusplus */
+
+#endif /* #ifndef CLI_SCRIPT_H */
@@ -0,0 +1,261 @@
+#include "run_cmd.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include "esp_console.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_err.h"
+#include "argtable3/argtable3.h"
+#include "config.h"
+#include "cli_script.h"
+#include "cli_out.h"
+
+
+static const char* TAG = "CLI";
+
+static struct
+{
+    struct arg_str* file;
+    struct arg_str* script;
+    struct arg_lit* keep_going;
+    struct arg_lit* quiet;
+    struct arg_end* end;
+} run_args;
+
+/* Intrarea unei etape din pipeline, citita de comanda ca stdin */
+typedef struct {
+    const char* data;
+    size_t      len;
+    size_t      pos;
+} run_input_t;
+
+static bool s_running = false;  // `run` dintr-un script nu porneste alt script
+
+// -------------------------------------
+
+static int run_capture_write(void* cookie, const char* data, int len) {
+    cli_script_out_write((cli_script_out_t*) cookie, data, (size_t) len);
+    return len;  // Ce nu incape e marcat ca trunchiat, comanda nu vede o eroare
+}
+//---------
+static int run_input_read(void* cookie, char* buf, int len) {
+    run_input_t* in = (run_input_t*) cookie;
+    size_t       n  = in->len - in->pos;
+    n               = n < (size_t) len ? n : (size_t) len;
+    memcpy(buf, in->data + in->pos, n);
+    in->pos += n;
+    return (int) n;  // 0 = EOF
+}
+//---------
+/* esp_console_run cu stdout (si stdin, daca e un `|` inainte) redirectate doar pentru task-ul consolei */
+static int run_exec(void* ctx, const char* cmdline, const char* input, size_t input_len, cli_script_out_t* out,
+    int* ret) {
+    run_input_t in        = {input, input_len, 0};
+    FILE*       saved_in  = stdin;
+    FILE*       saved_out = stdout;
+    FILE*       in_file   = NULL;
+    FILE*       out_file  = NULL;
+
+    if (input) {
+        in_file = funopen(&in, run_input_read, NULL, NULL, NULL);
+    }
+    if (out) {
+        out_file = funopen(out, NULL, run_capture_write, NULL, NULL);
+    }
+    if ((input && in_file == NULL) || (out && out_file == NULL)) {
+        if (in_file) {
+            fclose(in_file);
+        }
+        if (out_file) {
+            fclose(out_file);
+        }
+        return CLI_SCRIPT_EXEC_ERROR;
+    }
+
+    fflush(stdout);
+    if (in_file) {
+        stdin = in_file;
+    }
+    if (out_file) {
+        stdout = out_file;
+    }
+    char line[CLI_SCRIPT_LINE_MAX + 1];  // cli_out_run scoate `--json` / `--bin` din ea
+    snprintf(line, sizeof(line), "%s", cmdline);
+    cli_out_mode_t mode;
+    esp_err_t      err = cli_out_run(line, ret, &mode);
+    if (out_file) {
+        fflush(out_file);
+        stdout = saved_out;
+        fclose(out_file);
+    }
+    if (in_file) {
+        stdin = saved_in;
+        fclose(in_file);
+    }
+
+    switch (err) {
+        case ESP_OK:
+            return CLI_SCRIPT_EXEC_OK;
+        case ESP_ERR_NOT_FOUND:
+            return CLI_SCRIPT_EXEC_NOT_FOUND;
+        default:
+            if (mode == CLI_OUT_TEXT) {
+                printf("Internal error: %s\n", esp_err_to_name(err));
+            }
+            return CLI_SCRIPT_EXEC_ERROR;
+    }
+}
+//---------
+static int64_t run_now_us(void* ctx) {
+    return esp_timer_get_time();
+}
+//---------
+static void run_print(void* ctx, const char* text, size_t len) {
+    fwrite(text, 1, len, stdout);
+}
+
+// -------------------------------------
+
+/* Fisierul intreg in buf; cai relative fata de MOUNT_PATH */
+static size_t run_read_file(const char* name, char* buf, size_t size) {
+    char path[CONSOLE_MAX_CMDLINE_LENGTH + sizeof(MOUNT_PATH) + 1];
+    if (name[0] == '/') {
+        snprintf(path, sizeof(path), "%s", name);
+    } else {
+        snprintf(path, sizeof(path), "%s/%s", MOUNT_PATH, name);
+    }
+
+    FILE* f = fopen(path, "r");
+    if (f == NULL) {
+        printf("Cannot open %s\n", path);
+        return 0;
+    }
+    size_t len = fread(buf, 1, size, f);
+    bool   more = fgetc(f) != EOF;
+    fclose(f);
+    if (more) {
+        printf("%s is larger than %u bytes\n", path, (unsigned) size);
+        return 0;
+    }
+    if (len == 0) {
+        printf("%s is empty\n", path);
+    }
+    return len;
+}
+//---------
+/* Linii de la consola pana la una cu "." sau Ctrl-D (scripturi lipite in terminal sau trimise de un tool) */
+static size_t run_read_stdin(char* buf, size_t size) {
+    size_t len = 0, line_start = 0;
+    printf("Reading script, end with a line containing only '.' or Ctrl-D\n");
+    for (;;) {
+        int c = fgetc(stdin);
+        if (c == EOF || c == 0x04) {
+            break;
+        }
+        if (c == '\r') {
+            c = '\n';
+        }
+        if (c == 0x08 || c == 0x7f) {
+            if (len > line_start) {
+                len--;
+                fputs("\b \b", stdout);
+            }
+            continue;
+        }
+        if (c == '\n' && len == line_start + 1 && buf[line_start] == '.') {
+            len = line_start;
+            putchar('\n');
+            break;
+        }
+        if (len == size) {
+            printf("\nScript larger than %u bytes\n", (unsigned) size);
+            return 0;
+        }
+        buf[len++] = (char) c;
+        putchar(c);
+        fflush(stdout);
+        if (c == '\n') {
+            line_start = len;
+        }
+    }
+    return len;
+}
+
+// -------------------------------------
+
+static int run_command(int argc, char** argv) {
+    int nerrors = arg_parse(argc, argv, (void**) &run_args);
+    if (nerrors != 0) {
+        arg_print_errors(stderr, run_args.end, argv[0]);
+        return 1;
+    }
+    if ((run_args.file->count > 0) == (run_args.script->count > 0)) {
+        printf("Usage: run <file> | run - | run -c \"<commands>\" [-k] [-q]\n");
+        return 1;
+    }
+    if (s_running) {
+        printf("'run' cannot be nested\n");
+        return 1;
+    }
+
+    cli_script_t* s    = malloc(sizeof(cli_script_t));
+    char*         text = run_args.file->count > 0 ? malloc(CLI_SCRIPT_MAX_BYTES) : NULL;
+    if (s == NULL || (run_args.file->count > 0 && text == NULL)) {
+        printf("Not enough memory for a script\n");
+        free(s);
+        free(text);
+        return 1;
+    }
+
+    size_t len = 0;
+    if (run_args.script->count > 0) {
+        len = strlen(run_args.script->sval[0]);
+    } else if (strcmp(run_args.file->sval[0], "-") == 0) {
+        len = run_read_stdin(text, CLI_SCRIPT_MAX_BYTES);
+    } else {
+        len = run_read_file(run_args.file->sval[0], text, CLI_SCRIPT_MAX_BYTES);
+    }
+
+    int ret = 1;
+    if (len > 0) {
+        const cli_script_env_t env = {
+            .exec   = run_exec,
+            .now_us = run_now_us,
+            .print  = run_print,
+            .ctx    = NULL,
+        };
+        uint32_t flags = (run_args.keep_going->count > 0 ? CLI_SCRIPT_KEEP_GOING : 0) |
+                         (run_args.quiet->count > 0 ? CLI_SCRIPT_QUIET : 0);
+        s_running      = true;
+        ret = cli_script_run(s, &env, flags, text ? text : run_args.script->sval[0], len);
+        s_running      = false;
+    }
+    free(text);
+    free(s);
+    return ret;
+}
+
+// -------------------------------------
+
+void cli_register_run_command(void) {
+    run_args.file       = arg_str0(NULL, NULL, "<file|->", "Script on " MOUNT_PATH " (relative path) or '-' for the console");
+    run_args.script     = arg_str0("c", "command", "<commands>", "Run the given commands, e.g. \"tasks | grep IDLE; uptime\"");
+    run_args.keep_going = arg_lit0("k", "keep-going", "Continue after a failed command");
+    run_args.quiet      = arg_lit0("q", "quiet", "Only print the summary, not the per-command timing");
+    run_args.end        = arg_end(2);
+
+    const esp_console_cmd_t cmd = {
+        .command  = "run",
+        .help     = "Run a script: commands separated by newlines or ';', output piped with '|' "
+                    "(grep [-v] [-c], head [N], tail [N], wc [-l])",
+        .hint     = NULL,
+        .func     = &run_command,
+        .argtable = &run_args,
+    };
+
+    ESP_ERROR_CHECK(esp_console_cmd_register(&cmd));
+    ESP_LOGI(TAG, "'%s' command registered.", cmd.command);
+}
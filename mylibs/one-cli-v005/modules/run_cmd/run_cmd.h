@@ -0,0 +1,19 @@
+#pragma once
+
+
+#ifndef RUN_CMD_H
+#define RUN_CMD_H
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* #ifdef __cplusplus */
+
+void cli_register_run_command(void);
+
+
+#ifdef __cplusplus
+}
+#endif /* #ifdef __cplusplus */
+
+#endif  /* #ifndef RUN_CMD_H */
@@ -14,6 +14,10 @@
 #include "esp_err.h"
 #include <time.h>
 #include "argtable3/argtable3.h"
+#include "driver/usb_serial_jtag.h"
+#include "task_trace.h"
+#include "tasks_top.h"
+#include "cli_out.h"
 
 static const char* TAG = "CLI";
 
@@ -53,15 +57,48 @@ const char* getTimestamp() {
     return timestamp;
 }
 
+/* `tasks info --json|--bin`: aceleasi valori ca tabelul, un singur record cu toate task-urile */
+static void tasks_info_record(cli_out_t* out, const TaskStatus_t* taskStats, uint32_t taskCount, float f) {
+    cli_out_record_begin(out, "tasks");
+    cli_out_array_begin(out, "tasks");
+    for (uint32_t i = 0; i < taskCount; i++) {
+        const TaskStatus_t* stats            = &taskStats[i];
+        task_data_t*        previousTaskData = getPreviousTaskData(stats->xTaskNumber);
+        cli_out_object_begin(out, NULL);
+        cli_out_str(out, "name", stats->pcTaskName);
+        cli_out_uint(out, "num", stats->xTaskNumber);
+        cli_out_float(out, "load", f * (stats->ulRunTimeCounter - previousTaskData->ulRunTimeCounter));
+        cli_out_uint(out, "stack", stats->usStackHighWaterMark);
+        cli_out_str(out, "state", task_state[stats->eCurrentState]);
+        if (stats->xCoreID == -1 || stats->xCoreID == 2147483647) {
+            cli_out_null(out, "core");  // Fara afinitate
+        } else {
+            cli_out_int(out, "core", stats->xCoreID);
+        }
+        cli_out_uint(out, "prio", stats->uxBasePriority);
+        cli_out_object_end(out);
+        previousTaskData->ulRunTimeCounter = stats->ulRunTimeCounter;
+    }
+    cli_out_array_end(out);
+    cli_out_record_end(out);
+}
+
 static int tasks_info() {
-    ESP_LOGI(TAG, "-----------------Task Dump Start-----------------");
-    printf("\n\r");
     uint32_t     totalRunTime              = 0;
     TaskStatus_t taskStats[TASK_MAX_COUNT] = {0};
     uint32_t     taskCount                 = uxTaskGetSystemState(taskStats, TASK_MAX_COUNT, &totalRunTime);
     assert(task_top_id < TASK_MAX_COUNT);
     uint32_t totalDelta = totalRunTime - total_runtime;
     float    f          = 100.0 / totalDelta;
+
+    cli_out_t* out = cli_out_get();
+    if (out) {
+        tasks_info_record(out, taskStats, taskCount, f);
+        total_runtime = totalRunTime;
+        return 0;
+    }
+    ESP_LOGI(TAG, "-----------------Task Dump Start-----------------");
+    printf("\n\r");
     printf("%.4s\t%.6s\t%.8s\t%.8s\t%.4s\t%-20s\n",
         "Load",
         "Stack",
@@ -222,6 +259,228 @@ exit:  // Common return path
 
 // ==========================================
 
+#define SCHED_WINDOW_TICKS pdMS_TO_TICKS(1000)
+#define SCHED_ROWS_SPARE   8  // Task-uri create intre cele doua copii
+
+typedef struct
+{
+    const task_trace_task_t* row;
+    uint64_t                 run_us;
+    uint32_t                 switches;
+    uint32_t                 preemptions;
+    uint32_t                 wakeups;
+    uint64_t                 latency_sum_us;
+} sched_delta_t;
+
+static int sched_delta_cmp(const void* a, const void* b) {
+    const sched_delta_t* x = a;
+    const sched_delta_t* y = b;
+    return (x->run_us < y->run_us) - (x->run_us > y->run_us);  // Descrescator dupa CPU
+}
+
+/**
+ * @brief   CPU, latenta de planificare si preemptari per task, din trace-ul de comutari.
+ *
+ * Doua copii ale totalurilor din task_trace (mylibs/task-trace-v001) la xTicksToWait distanta,
+ * scazute per task (acelasi handle si aceeasi generatie). Nu apeleaza uxTaskGetSystemState si
+ * nu suspenda scheduler-ul; trace-ul porneste la primul apel.
+ *
+ * CPU % e din timpul unui core (un task care tine un core ocupat are 100%).
+ * Lat = cat a stat task-ul ready dupa ce a fost trezit, pana a rulat (medie / maxim de la pornire).
+ */
+static esp_err_t print_sched_stats(TickType_t xTicksToWait) {
+    esp_err_t err = task_trace_start();
+    if (err != ESP_OK) {
+        printf("Context switch trace unavailable: %s (CONFIG_TASK_TRACE_ENABLE)\n", esp_err_to_name(err));
+        return err;
+    }
+
+    task_trace_summary_t start_summary, end_summary;
+    task_trace_snapshot(NULL, 0, &start_summary);
+    uint32_t           capacity    = start_summary.task_count + SCHED_ROWS_SPARE;
+    task_trace_task_t* start_rows  = malloc(capacity * sizeof(task_trace_task_t));
+    task_trace_task_t* end_rows    = malloc(capacity * sizeof(task_trace_task_t));
+    sched_delta_t*     deltas      = malloc(capacity * sizeof(sched_delta_t));
+    if (start_rows == NULL || end_rows == NULL || deltas == NULL) {
+        err = ESP_ERR_NO_MEM;
+        goto exit;
+    }
+
+    uint32_t start_count = task_trace_snapshot(start_rows, capacity, &start_summary);
+    vTaskDelay(xTicksToWait);
+    uint32_t end_count = task_trace_snapshot(end_rows, capacity, &end_summary);
+
+    uint32_t window_us = end_summary.now - start_summary.now;
+    if (window_us == 0) {
+        err = ESP_ERR_INVALID_STATE;
+        goto exit;
+    }
+
+    // Diferentele per task; un task nou (sau un handle refolosit) porneste de la zero
+    for (uint32_t i = 0; i < end_count; i++) {
+        const task_trace_task_t* cur  = &end_rows[i];
+        const task_trace_task_t* prev = task_trace_find(start_rows, start_count, cur->task, cur->generation);
+        deltas[i] = (sched_delta_t) {
+            .row            = cur,
+            .run_us         = cur->run_us - (prev ? prev->run_us : 0),
+            .switches       = cur->switches - (prev ? prev->switches : 0),
+            .preemptions    = cur->preemptions - (prev ? prev->preemptions : 0),
+            .wakeups        = cur->wakeups - (prev ? prev->wakeups : 0),
+            .latency_sum_us = cur->latency_sum_us - (prev ? prev->latency_sum_us : 0),
+        };
+    }
+    qsort(deltas, end_count, sizeof(sched_delta_t), sched_delta_cmp);
+
+    printf("╔════════════════════════ SCHEDULER (%5" PRIu32 " ms, context switch trace) ═════════════════════════╗\n",
+        window_us / 1000);
+    printf("║ %-16s │ %4s │ %6s │ %8s │ %8s │ %8s │ %10s │ %10s ║\n",
+        "Task", "Core", "CPU %", "Switches", "Preempt", "Wakeups", "Lat avg us", "Lat max us");
+    printf("╟──────────────────┼──────┼────────┼──────────┼──────────┼──────────┼────────────┼────────────╢\n");
+    for (uint32_t i = 0; i < end_count; i++) {
+        const sched_delta_t* d   = &deltas[i];
+        uint32_t             avg = d->wakeups ? (uint32_t) (d->latency_sum_us / d->wakeups) : 0;
+        printf("║ %-16.16s │ %4d │ %6.2f │ %8" PRIu32 " │ %8" PRIu32 " │ %8" PRIu32 " │ %10" PRIu32 " │ %10" PRIu32 " ║\n",
+            d->row->name,
+            d->row->core,
+            (double) d->run_us * 100.0 / window_us,
+            d->switches,
+            d->preemptions,
+            d->wakeups,
+            avg,
+            d->row->latency_max_us);
+    }
+    printf("╟──────────────────┴──────┴────────┴──────────┴──────────┴──────────┴────────────┴────────────╢\n");
+    for (uint32_t core = 0; core < end_summary.core_count; core++) {
+        const task_trace_core_t* c0      = &start_summary.cores[core];
+        const task_trace_core_t* c1      = &end_summary.cores[core];
+        uint64_t                 elapsed = c1->elapsed_us - c0->elapsed_us;
+        uint64_t                 known   = elapsed - (c1->unknown_us - c0->unknown_us);
+        double                   busy    = known ? (double) (c1->busy_us - c0->busy_us) * 100.0 / known : 0.0;
+        printf("║ Core %" PRIu32 ": busy %6.2f %%   switches %8" PRIu32 "   lost events %8" PRIu32 "%*s║\n",
+            core, busy, c1->switches - c0->switches, c1->lost - c0->lost, 28, "");
+    }
+    printf("╚═════════════════════════════════════════════════════════════════════════════════════════════╝\n");
+    err = ESP_OK;
+
+exit:  // Common return path
+    free(start_rows);
+    free(end_rows);
+    free(deltas);
+    return err;
+}
+
+// ==========================================
+
+#define WATCH_MAX_TASKS   48
+#define WATCH_LINES       (TASKS_TOP_HEADER + 24)  // Un terminal de 80x30, cu loc pentru prompt
+#define WATCH_INTERVAL_MS 1000
+#define WATCH_MIN_MS      100
+
+/* Alocat o singura data per `tasks --watch`: cele doua copii alterneaza (anterioara / curenta) */
+typedef struct
+{
+    TaskStatus_t    status[2][WATCH_MAX_TASKS];
+    tasks_top_row_t rows[WATCH_MAX_TASKS];
+    tasks_top_t     top;
+} tasks_watch_t;
+
+static void watch_write(void* ctx, const char* data, size_t len) {
+    (void) ctx;
+    fwrite(data, 1, len, stdout);
+    fflush(stdout);
+}
+
+static uint16_t watch_load(uint32_t delta, uint32_t total) {
+    uint64_t load = total ? (uint64_t) delta * 10000u / total : 0;  // Sutimi de procent din timpul unui core
+    return (uint16_t) (load > 10000 ? 10000 : load);
+}
+
+/**
+ * @brief   Vedere live tip top: load per task intre doua copii uxTaskGetSystemState la interval_ms,
+ *          sortat descrescator, redesenat pe loc (tasks_top.c trimite doar celulele schimbate).
+ *
+ * Asteptarea dintre cadre e o citire din USB-Serial-JTAG cu timeout: orice tasta opreste imediat
+ * vederea (si nu ajunge la linenoise). Memoria e alocata o data, la pornire.
+ */
+static esp_err_t tasks_watch(uint32_t interval_ms) {
+    if (interval_ms < WATCH_MIN_MS) {
+        interval_ms = WATCH_MIN_MS;
+    }
+    tasks_watch_t* w = malloc(sizeof(tasks_watch_t));
+    if (w == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+    tasks_top_init(&w->top, WATCH_LINES, watch_write, NULL);
+
+    configRUN_TIME_COUNTER_TYPE prev_total = 0, total = 0;
+    int                         prev       = 0;
+    UBaseType_t                 prev_count = uxTaskGetSystemState(w->status[prev], WATCH_MAX_TASKS, &prev_total);
+    esp_err_t                   ret        = ESP_OK;
+    if (prev_count == 0) {
+        printf("More than %d tasks, `tasks --watch` cannot list them\n", WATCH_MAX_TASKS);
+        free(w);
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    for (;;) {
+        uint8_t key;
+        if (usb_serial_jtag_read_bytes(&key, 1, pdMS_TO_TICKS(interval_ms)) > 0) {
+            break;
+        }
+        int         cur   = prev ^ 1;
+        UBaseType_t count = uxTaskGetSystemState(w->status[cur], WATCH_MAX_TASKS, &total);
+        if (count == 0) {
+            ret = ESP_ERR_INVALID_SIZE;  // Au aparut prea multe task-uri intre timp
+            break;
+        }
+        uint32_t elapsed = (uint32_t) (total - prev_total);
+
+        tasks_top_summary_t summary = {
+            .interval_ms = interval_ms,
+            .uptime_s    = (uint32_t) (esp_timer_get_time() / 1000000),
+            .free_heap   = esp_get_free_heap_size(),
+            .task_count  = (uint16_t) count,
+            .core_count  = CONFIG_FREERTOS_NUMBER_OF_CORES,
+        };
+        for (UBaseType_t i = 0; i < count; i++) {
+            const TaskStatus_t* t     = &w->status[cur][i];
+            uint32_t            delta = (uint32_t) t->ulRunTimeCounter;  // Task nou: tot timpul lui de la creare
+            for (UBaseType_t j = 0; j < prev_count; j++) {
+                if (w->status[prev][j].xHandle == t->xHandle) {
+                    delta = (uint32_t) (t->ulRunTimeCounter - w->status[prev][j].ulRunTimeCounter);
+                    break;
+                }
+            }
+            tasks_top_row_t* row = &w->rows[i];
+            snprintf(row->name, sizeof(row->name), "%s", t->pcTaskName);
+            row->key       = (uint32_t) (uintptr_t) t->xHandle;
+            row->load      = watch_load(delta, elapsed);
+            row->core      = (t->xCoreID >= 0 && t->xCoreID < CONFIG_FREERTOS_NUMBER_OF_CORES) ? (int8_t) t->xCoreID : TASKS_TOP_CORE_ANY;
+            row->state     = (uint8_t) t->eCurrentState;
+            row->priority  = (uint8_t) t->uxCurrentPriority;
+            row->stack_hwm = t->usStackHighWaterMark;
+            for (int core = 0; core < CONFIG_FREERTOS_NUMBER_OF_CORES && core < 2; core++) {
+                if (t->xHandle == xTaskGetIdleTaskHandleForCore(core)) {
+                    summary.core_load[core] = (uint16_t) (10000u - row->load);  // Ce nu a rulat idle-ul
+                }
+            }
+        }
+        tasks_top_sort(w->rows, (uint32_t) count);
+        tasks_top_render(&w->top, &summary, w->rows, (uint32_t) count);
+
+        prev       = cur;
+        prev_count = count;
+        prev_total = total;
+    }
+
+    tasks_top_finish(&w->top);
+    printf("%" PRIu32 " bytes sent\n", (uint32_t) w->top.bytes);
+    free(w);
+    return ret;
+}
+
+// ==========================================
+
 // -------------------------------------------------------------
 
 /***
@@ -232,6 +491,8 @@ static struct
 {
     struct arg_str* subcommand;
     struct arg_lit* list;  // <-- opțiunea nouă
+    struct arg_lit* watch;
+    struct arg_int* interval;
     struct arg_lit* help;  // ⬅️ NOU
     struct arg_end* end;
 } tasks_args;
@@ -254,12 +515,20 @@ void printTasksInfo() {
 void printTasksStats() {
     print_real_time_stats(1000);
 }
+void printTasksSched() {
+    print_sched_stats(SCHED_WINDOW_TICKS);
+}
+void printTasksWatch() {
+    tasks_watch(WATCH_INTERVAL_MS);
+}
 
 // -------------------------------------
 
 static const tasks_command_entry_t tasks_cmds[] = {
     {"info", printTasksInfo, "Display chip model, cores, and revision"},
     {"stats", printTasksStats, "Display chip model, cores, and revision"},
+    {"sched", printTasksSched, "CPU, wake latency, preemptions (switch trace)"},
+    {"watch", printTasksWatch, "Live view sorted by load (--watch [-i ms]), any key exits"},
     {"--list", printTasksCommandList, "List all available subcommands"},
 };
 
@@ -323,6 +592,12 @@ static int tasks_command(int argc, char** argv) {
         return 1;
     }
 
+    // tasks --watch [--interval <ms>]
+    if (tasks_args.watch->count > 0) {
+        int interval = tasks_args.interval->count > 0 ? tasks_args.interval->ival[0] : WATCH_INTERVAL_MS;
+        return tasks_watch(interval > 0 ? (uint32_t) interval : WATCH_INTERVAL_MS) == ESP_OK ? 0 : 1;
+    }
+
     // Verificare subcommand valid
     if (!tasks_args.subcommand || tasks_args.subcommand->count == 0 || !tasks_args.subcommand->sval[0]) {
         printf("No subcommand provided. Use `info --help`.\n");
@@ -352,11 +627,13 @@ static int tasks_command(int argc, char** argv) {
 
 void cli_register_tasks_command(void) {
     generate_tasks_cmds_help_text();
-    tasks_args.subcommand       = arg_str1(NULL,  // nu are flag scurt, gen `-s
+    tasks_args.subcommand       = arg_str0(NULL,  // nu are flag scurt, gen `-s (optional cu --watch)
         NULL,                               // nu are flag lung, gen `--subcmd`
         "<subcommand>",                     // numele argumentului (pentru help/usage)
         tasks_cmds_help);                   // descrierea lui
     tasks_args.list             = arg_lit0("l", "list", "List all available subcommands");
+    tasks_args.watch            = arg_lit0("w", "watch", "Live view sorted by load, any key exits");
+    tasks_args.interval         = arg_int0("i", "interval", "<ms>", "Refresh interval for --watch (default 1000)");
     tasks_args.help             = arg_lit0("h", "help", "Show help for 'info' command");
     tasks_args.end              = arg_end(1);
 
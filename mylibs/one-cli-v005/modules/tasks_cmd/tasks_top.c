@@ -0,0 +1,184 @@
+#include "tasks_top.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define TASKS_TOP_GAP (6)  // Celule nemodificate rescrise in loc de o noua pozitionare (ESC[r;cH are 6-8 bytes)
+
+static const char* const tasks_top_states[] = {"Run", "Ready", "Block", "Susp", "Del", "?"};
+
+// -------------------------------------
+
+static void tasks_top_flush(tasks_top_t* top) {
+    if (top->out_len) {
+        top->write(top->ctx, top->out, top->out_len);
+        top->bytes += top->out_len;
+        top->out_len = 0;
+    }
+}
+//---------
+static void tasks_top_put(tasks_top_t* top, const char* data, size_t len) {
+    while (len) {
+        size_t n = sizeof(top->out) - top->out_len;
+        n        = n < len ? n : len;
+        memcpy(top->out + top->out_len, data, n);
+        top->out_len += n;
+        data += n;
+        len -= n;
+        if (top->out_len == sizeof(top->out)) {
+            tasks_top_flush(top);
+        }
+    }
+}
+//---------
+static void tasks_top_goto(tasks_top_t* top, uint32_t line, uint32_t col) {
+    char esc[16];
+    int  n = col ? snprintf(esc, sizeof(esc), "\x1b[%u;%uH", (unsigned) line + 1, (unsigned) col + 1)
+                 : snprintf(esc, sizeof(esc), "\x1b[%uH", (unsigned) line + 1);
+    tasks_top_put(top, esc, (size_t) n);
+}
+//---------
+/* Textul completat cu spatii pana la TASKS_TOP_WIDTH (taiat daca e mai lung) */
+static void tasks_top_fill(char* line, const char* text) {
+    size_t n = strlen(text);
+    n        = n < TASKS_TOP_WIDTH ? n : TASKS_TOP_WIDTH;
+    memcpy(line, text, n);
+    memset(line + n, ' ', TASKS_TOP_WIDTH - n);
+}
+//---------
+/* Trimite doar bucatile schimbate ale liniei si actualizeaza copia de pe ecran */
+static void tasks_top_diff(tasks_top_t* top, uint32_t index, const char* line, uint32_t* cursor_line,
+    uint32_t* cursor_col) {
+    char*    old = top->screen[index];
+    uint32_t col = 0;
+    while (col < TASKS_TOP_WIDTH) {
+        if (line[col] == old[col]) {
+            col++;
+            continue;
+        }
+        uint32_t start = col;
+        uint32_t end   = col + 1;
+        for (uint32_t j = end; j < TASKS_TOP_WIDTH && j - end < TASKS_TOP_GAP; j++) {
+            if (line[j] != old[j]) {
+                end = j + 1;
+            }
+        }
+        if (*cursor_line != index || *cursor_col != start) {
+            tasks_top_goto(top, index, start);
+        }
+        tasks_top_put(top, line + start, end - start);
+        *cursor_line = index;
+        *cursor_col  = end;
+        col          = end;
+    }
+    memcpy(old, line, TASKS_TOP_WIDTH);
+}
+//---------
+static void tasks_top_format_row(char* text, size_t size, const tasks_top_row_t* row) {
+    char core[8];
+    if (row->core == TASKS_TOP_CORE_ANY) {
+        snprintf(core, sizeof(core), "%s", "any");
+    } else {
+        snprintf(core, sizeof(core), "%d", row->core);
+    }
+    uint16_t load = row->load > 10000 ? 10000 : row->load;
+    snprintf(text, size, "%3u.%02u  %4s  %4u  %-7s %6u  %-16.16s", (unsigned) (load / 100), (unsigned) (load % 100),
+        core, (unsigned) row->priority, tasks_top_states[row->state < TASKS_TOP_INVALID ? row->state : TASKS_TOP_INVALID],
+        (unsigned) row->stack_hwm, row->name);
+}
+//---------
+static int tasks_top_cmp(const void* a, const void* b) {
+    const tasks_top_row_t* x = a;
+    const tasks_top_row_t* y = b;
+    if (x->load != y->load) {
+        return x->load > y->load ? -1 : 1;
+    }
+    int c = strcmp(x->name, y->name);
+    if (c) {
+        return c;
+    }
+    return (x->key > y->key) - (x->key < y->key);
+}
+
+// -------------------------------------
+
+void tasks_top_init(tasks_top_t* top, uint32_t lines, tasks_top_write_fn_t write, void* ctx) {
+    memset(top, 0, sizeof(*top));
+    if (lines < TASKS_TOP_HEADER + 1) {
+        lines = TASKS_TOP_HEADER + 1;
+    }
+    top->lines = lines < TASKS_TOP_MAX_LINES ? lines : TASKS_TOP_MAX_LINES;
+    top->write = write;
+    top->ctx   = ctx;
+}
+//---------
+void tasks_top_sort(tasks_top_row_t* rows, uint32_t count) {
+    qsort(rows, count, sizeof(tasks_top_row_t), tasks_top_cmp);
+}
+//---------
+size_t tasks_top_render(tasks_top_t* top, const tasks_top_summary_t* summary, const tasks_top_row_t* rows,
+    uint32_t count) {
+    uint64_t before      = top->bytes;
+    uint32_t cursor_line = UINT32_MAX;
+    uint32_t cursor_col  = 0;
+    char     text[TASKS_TOP_WIDTH + 32];
+    char     line[TASKS_TOP_WIDTH];
+
+    if (!top->drawn) {
+        // Ecran curat: de aici incolo doar celulele care nu sunt spatii
+        static const char clear[] = "\x1b[?25l\x1b[2J";
+        tasks_top_put(top, clear, sizeof(clear) - 1);
+        memset(top->screen, ' ', sizeof(top->screen));
+        top->drawn = 1;
+    }
+
+    // Antet
+    uint32_t up = summary->uptime_s;
+    if (summary->core_count > 1) {
+        snprintf(text, sizeof(text), "Tasks %3u  CPU0 %3u.%02u%%  CPU1 %3u.%02u%%  Heap %5uK  Up %3u:%02u:%02u",
+            (unsigned) summary->task_count, summary->core_load[0] / 100u, summary->core_load[0] % 100u,
+            summary->core_load[1] / 100u, summary->core_load[1] % 100u, (unsigned) (summary->free_heap / 1024u),
+            (unsigned) (up / 3600u), (unsigned) (up / 60u % 60u), (unsigned) (up % 60u));
+    } else {
+        snprintf(text, sizeof(text), "Tasks %3u  CPU %3u.%02u%%  Heap %5uK  Up %3u:%02u:%02u",
+            (unsigned) summary->task_count, summary->core_load[0] / 100u, summary->core_load[0] % 100u,
+            (unsigned) (summary->free_heap / 1024u), (unsigned) (up / 3600u), (unsigned) (up / 60u % 60u),
+            (unsigned) (up % 60u));
+    }
+    tasks_top_fill(line, text);
+    tasks_top_diff(top, 0, line, &cursor_line, &cursor_col);
+    snprintf(text, sizeof(text), "Refresh %u ms, sorted by load. Any key exits.", (unsigned) summary->interval_ms);
+    tasks_top_fill(line, text);
+    tasks_top_diff(top, 1, line, &cursor_line, &cursor_col);
+    snprintf(text, sizeof(text), "%6s  %4s  %4s  %-7s %6s  %s", "Load%", "Core", "Prio", "State", "Stack", "Name");
+    tasks_top_fill(line, text);
+    tasks_top_diff(top, 2, line, &cursor_line, &cursor_col);
+
+    // Randuri; daca nu incap toate, ultimul spune cate lipsesc
+    uint32_t avail = top->lines - TASKS_TOP_HEADER;
+    uint32_t shown = count <= avail ? count : avail - 1;
+    for (uint32_t i = 0; i < avail; i++) {
+        if (i < shown) {
+            tasks_top_format_row(text, sizeof(text), &rows[i]);
+        } else if (i == shown && count > shown) {
+            snprintf(text, sizeof(text), "   ... %u more", (unsigned) (count - shown));
+        } else {
+            text[0] = '\0';
+        }
+        tasks_top_fill(line, text);
+        tasks_top_diff(top, TASKS_TOP_HEADER + i, line, &cursor_line, &cursor_col);
+    }
+
+    tasks_top_flush(top);
+    return (size_t) (top->bytes - before);
+}
+//---------
+void tasks_top_finish(tasks_top_t* top) {
+    static const char show[] = "\x1b[?25h\n";
+    if (top->drawn) {
+        tasks_top_goto(top, top->lines, 0);
+    }
+    tasks_top_put(top, show, sizeof(show) - 1);
+    tasks_top_flush(top);
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#ifndef TASKS_TOP_H
+#define TASKS_TOP_H
+
+/*
+ * Formatter-ul pentru `tasks --watch`: ecranul (antet + cate un rand per task, sortat dupa load)
+ * e pastrat intre cadre si la fiecare cadru se trimit doar celulele schimbate, fiecare bucata cu
+ * pozitionare ANSI (ESC[rand;coloanaH). Un cadru in care se schimba doar cateva procente costa
+ * zeci de bytes, nu tot tabelul, peste buffer-ul TX de 256 de bytes al USB-Serial-JTAG.
+ *
+ * Fara dependente ESP-IDF / FreeRTOS: host/bench_tasks_top.c il compileaza pe Linux.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* #ifdef __cplusplus */
+
+#define TASKS_TOP_WIDTH     (64)   // Coloane, fiecare linie e completata cu spatii pana aici
+#define TASKS_TOP_HEADER    (3)    // Liniile de antet: sumar, interval, capul de tabel
+#define TASKS_TOP_MAX_LINES (40)   // Antet + randuri de task-uri
+#define TASKS_TOP_CORE_ANY  (-1)   // Task fara afinitate
+#define TASKS_TOP_OUT_CHUNK (128)  // Iesirea se trimite in bucati de cel mult atat
+
+/* Starea, in ordinea eTaskState */
+enum {
+    TASKS_TOP_RUNNING = 0,
+    TASKS_TOP_READY,
+    TASKS_TOP_BLOCKED,
+    TASKS_TOP_SUSPENDED,
+    TASKS_TOP_DELETED,
+    TASKS_TOP_INVALID,
+};
+
+typedef struct {
+    char     name[17];
+    uint32_t key;        // Ordinea finala la load si nume egale (handle-ul task-ului)
+    uint16_t load;       // Sutimi de procent din timpul unui core, 0..10000
+    int8_t   core;       // 0, 1 sau TASKS_TOP_CORE_ANY
+    uint8_t  state;      // TASKS_TOP_*
+    uint8_t  priority;
+    uint32_t stack_hwm;  // Bytes nefolositi niciodata din stiva
+} tasks_top_row_t;
+
+typedef struct {
+    uint32_t interval_ms;
+    uint32_t uptime_s;
+    uint32_t free_heap;
+    uint16_t task_count;  // Toate task-urile, pot fi mai multe decat randurile afisate
+    uint8_t  core_count;
+    uint16_t core_load[2];  // Sutimi de procent
+} tasks_top_summary_t;
+
+typedef void (*tasks_top_write_fn_t)(void* ctx, const char* data, size_t len);
+
+typedef struct {
+    char                 screen[TASKS_TOP_MAX_LINES][TASKS_TOP_WIDTH];  // Ce e acum pe terminal
+    uint32_t             lines;     // Linii afisate, antet inclus
+    uint32_t             drawn;     // 0 pana la primul cadru (care sterge ecranul)
+    char                 out[TASKS_TOP_OUT_CHUNK];
+    size_t               out_len;
+    uint64_t             bytes;     // Total trimis, pentru statistici
+    tasks_top_write_fn_t write;
+    void*                ctx;
+} tasks_top_t;
+
+/**
+ * @brief Pregateste ecranul.
+ * @param lines Liniile terminalului folosite (antet inclus), cel mult TASKS_TOP_MAX_LINES
+ */
+void tasks_top_init(tasks_top_t* top, uint32_t lines, tasks_top_write_fn_t write, void* ctx);
+
+/* Descrescator dupa load, apoi dupa nume si key: acelasi cadru pentru aceleasi date */
+void tasks_top_sort(tasks_top_row_t* rows, uint32_t count);
+
+/**
+ * @brief Deseneaza un cadru: primul complet, urmatoarele doar diferentele. rows trebuie sortate.
+ *        Daca nu incap toate randurile, ultimul rand arata cate au ramas pe dinafara.
+ * @return bytes trimisi pentru acest cadru
+ */
+size_t tasks_top_render(tasks_top_t* top, const tasks_top_summary_t* summary, const tasks_top_row_t* rows,
+    uint32_t count);
+
+/* Muta cursorul sub tabel si il reafiseaza (la iesirea din --watch) */
+void tasks_top_finish(tasks_top_t* top);
+
+#ifdef __cplusplus
+}
+#endif /* #ifdef __cplusplus */
+
+#endif /* #ifndef TASKS_TOP_H */
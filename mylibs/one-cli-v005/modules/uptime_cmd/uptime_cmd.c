@@ -7,6 +7,7 @@
 #include "esp_timer.h"
 #include "esp_console.h"
 #include "esp_log.h"
+#include "cli_out.h"
 
 
 static const char *TAG = "CLI";
@@ -16,6 +17,14 @@ static int uptime_command(int argc, char **argv)
     int64_t uptime_us = esp_timer_get_time();
     int64_t uptime_s = uptime_us / 1000000;
 
+    cli_out_t *out = cli_out_get();
+    if (out) {
+        cli_out_record_begin(out, "uptime");
+        cli_out_uint(out, "us", (uint64_t)uptime_us);
+        cli_out_record_end(out);
+        return 0;
+    }
+
     int days = uptime_s / (24 * 3600);
     uptime_s %= (24 * 3600);
     int hours = uptime_s / 3600;
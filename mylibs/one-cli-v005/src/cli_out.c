@@ -0,0 +1,425 @@
+#include "cli_out.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+// -------------------------------------
+
+static void out_flush_buf(cli_out_t* o) {
+    if (o->len) {
+        o->write(o->ctx, o->buf, o->len);
+        o->bytes += (uint32_t) o->len;
+        o->len = 0;
+    }
+}
+//---------
+static void out_raw(cli_out_t* o, const void* data, size_t len) {
+    const char* p = data;
+    while (len) {
+        size_t n = CLI_OUT_BUF - o->len;
+        n        = n < len ? n : len;
+        memcpy(o->buf + o->len, p, n);
+        o->len += n;
+        p += n;
+        len -= n;
+        if (o->len == CLI_OUT_BUF) {
+            out_flush_buf(o);
+        }
+    }
+}
+
+// -------------------------------------
+// JSON
+
+static void json_put(cli_out_t* o, const char* s) {
+    out_raw(o, s, strlen(s));
+}
+//---------
+static void json_string(cli_out_t* o, const char* s, size_t len) {
+    out_raw(o, "\"", 1);
+    size_t run = 0;  // Bucata fara caractere de escapat, scrisa dintr-o data
+    for (size_t i = 0; i < len; i++) {
+        unsigned char c = (unsigned char) s[i];
+        if (c >= 0x20 && c != '"' && c != '\\') {
+            continue;
+        }
+        out_raw(o, s + run, i - run);
+        run = i + 1;
+        char esc[8];
+        switch (c) {
+            case '"': json_put(o, "\\\""); break;
+            case '\\': json_put(o, "\\\\"); break;
+            case '\n': json_put(o, "\\n"); break;
+            case '\r': json_put(o, "\\r"); break;
+            case '\t': json_put(o, "\\t"); break;
+            default:
+                snprintf(esc, sizeof(esc), "\\u%04x", c);
+                json_put(o, esc);
+                break;
+        }
+    }
+    out_raw(o, s + run, len - run);
+    out_raw(o, "\"", 1);
+}
+//---------
+/* Virgula si cheia inaintea unui element */
+static void json_prefix(cli_out_t* o, const char* key) {
+    uint8_t d = o->depth - 1;
+    if (o->has_items[d]) {
+        out_raw(o, ",", 1);
+    }
+    o->has_items[d] = true;
+    if (!o->is_array[d]) {
+        json_string(o, key ? key : "", key ? strlen(key) : 0);
+        out_raw(o, ":", 1);
+    }
+}
+
+// -------------------------------------
+// Bin: CRC-16/CCITT peste payload, COBS peste payload + CRC
+
+/* Cate 4 biti o data: 32 B de tabel in loc de 8 iteratii per byte */
+static const uint16_t s_crc16_nibble[16] = {
+    0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50a5, 0x60c6, 0x70e7,
+    0x8108, 0x9129, 0xa14a, 0xb16b, 0xc18c, 0xd1ad, 0xe1ce, 0xf1ef,
+};
+
+static uint16_t crc16_byte(uint16_t crc, uint8_t b) {
+    crc = (uint16_t) ((crc << 4) ^ s_crc16_nibble[(crc >> 12) ^ (b >> 4)]);
+    crc = (uint16_t) ((crc << 4) ^ s_crc16_nibble[(crc >> 12) ^ (b & 0x0F)]);
+    return crc;
+}
+//---------
+static void cobs_block_end(cli_out_t* o) {
+    uint8_t code = (uint8_t) (o->block_len + 1);
+    out_raw(o, &code, 1);
+    out_raw(o, o->block, o->block_len);
+    o->block_len = 0;
+}
+//---------
+static void cobs_byte(cli_out_t* o, uint8_t b) {
+    if (b == 0) {
+        cobs_block_end(o);
+        return;
+    }
+    o->block[o->block_len++] = b;
+    if (o->block_len == sizeof(o->block)) {
+        cobs_block_end(o);  // Cod 0xFF: bloc plin, fara '\0' implicit dupa el
+    }
+}
+//---------
+static void bin_byte(cli_out_t* o, uint8_t b) {
+    o->crc = crc16_byte(o->crc, b);
+    cobs_byte(o, b);
+}
+//---------
+static void bin_bytes(cli_out_t* o, const void* data, size_t len) {
+    const uint8_t* p = data;
+    for (size_t i = 0; i < len; i++) {
+        bin_byte(o, p[i]);
+    }
+}
+//---------
+static void bin_varint(cli_out_t* o, uint64_t v) {
+    while (v >= 0x80) {
+        bin_byte(o, (uint8_t) (v | 0x80));
+        v >>= 7;
+    }
+    bin_byte(o, (uint8_t) v);
+}
+//---------
+/* Tag-ul si cheia unui element (cheie noua doar prima data in inregistrare) */
+static void bin_item(cli_out_t* o, uint8_t type, const char* key) {
+    if (o->is_array[o->depth - 1]) {
+        bin_byte(o, type);
+        return;
+    }
+    key = key ? key : "";
+    for (uint8_t i = 0; i < o->key_count; i++) {
+        if (o->keys[i] == key || strcmp(o->keys[i], key) == 0) {
+            if (i < 13) {
+                bin_byte(o, (uint8_t) (((i + 1) << 4) | type));
+            } else {
+                bin_byte(o, (uint8_t) (0xE0 | type));
+                bin_byte(o, i);
+            }
+            return;
+        }
+    }
+    if (o->key_count < CLI_OUT_KEYS) {
+        o->keys[o->key_count++] = key;
+    }
+    size_t len = strlen(key);
+    bin_byte(o, (uint8_t) (0xF0 | type));
+    bin_varint(o, len);
+    bin_bytes(o, key, len);
+}
+
+// -------------------------------------
+
+/* Un element poate fi scris doar intr-o inregistrare; key lipsa doar in array */
+static bool out_item_ok(cli_out_t* o, const char* key) {
+    if (o->mode == CLI_OUT_TEXT || o->depth == 0) {
+        o->error = true;
+        return false;
+    }
+    if (key == NULL && !o->is_array[o->depth - 1]) {
+        o->error = true;  // Scris totusi, cu cheia "", ca iesirea sa ramana valida
+    }
+    return true;
+}
+//---------
+static void out_push(cli_out_t* o, const char* key, bool array) {
+    if (!out_item_ok(o, key)) {
+        return;
+    }
+    if (o->depth == CLI_OUT_DEPTH) {
+        o->error = true;
+        return;
+    }
+    if (o->mode == CLI_OUT_JSON) {
+        json_prefix(o, key);
+        out_raw(o, array ? "[" : "{", 1);
+    } else {
+        bin_item(o, array ? CLI_OUT_T_ARRAY : CLI_OUT_T_OBJECT, key);
+    }
+    o->is_array[o->depth]  = array;
+    o->has_items[o->depth] = false;
+    o->depth++;
+}
+//---------
+static void out_pop(cli_out_t* o, bool array) {
+    if (o->mode == CLI_OUT_TEXT || o->depth < 2 || o->is_array[o->depth - 1] != array) {
+        o->error = true;
+        return;
+    }
+    if (o->mode == CLI_OUT_JSON) {
+        out_raw(o, array ? "]" : "}", 1);
+    } else {
+        bin_byte(o, CLI_OUT_T_END);
+    }
+    o->depth--;
+}
+
+// -------------------------------------
+
+void cli_out_init(cli_out_t* o, cli_out_mode_t mode, cli_out_write_fn_t write, void* ctx) {
+    memset(o, 0, sizeof(*o));
+    o->mode  = mode;
+    o->write = write;
+    o->ctx   = ctx;
+}
+//---------
+void cli_out_record_begin(cli_out_t* o, const char* type) {
+    if (o->mode == CLI_OUT_TEXT) {
+        return;
+    }
+    if (o->depth != 0) {
+        o->error = true;
+        cli_out_record_end(o);  // Inchide inregistrarea uitata deschisa
+    }
+    size_t len = strlen(type);
+    if (o->mode == CLI_OUT_JSON) {
+        json_put(o, "{\"type\":");
+        json_string(o, type, len);
+    } else {
+        uint8_t delimiter = 0;
+        out_raw(o, &delimiter, 1);
+        o->crc       = 0xFFFF;
+        o->block_len = 0;
+        o->key_count = 0;
+        bin_byte(o, CLI_OUT_BIN_MAGIC);
+        bin_varint(o, len);
+        bin_bytes(o, type, len);
+    }
+    o->depth        = 1;
+    o->is_array[0]  = false;
+    o->has_items[0] = true;  // "type" e deja acolo
+}
+//---------
+void cli_out_record_end(cli_out_t* o) {
+    if (o->mode == CLI_OUT_TEXT || o->depth == 0) {
+        o->error = o->mode != CLI_OUT_TEXT;
+        return;
+    }
+    if (o->depth != 1) {
+        o->error = true;
+        while (o->depth > 1) {
+            out_pop(o, o->is_array[o->depth - 1]);
+        }
+    }
+    if (o->mode == CLI_OUT_JSON) {
+        out_raw(o, "}\n", 2);
+    } else {
+        uint16_t crc = o->crc;
+        cobs_byte(o, (uint8_t) crc);
+        cobs_byte(o, (uint8_t) (crc >> 8));
+        cobs_block_end(o);
+        uint8_t delimiter = 0;
+        out_raw(o, &delimiter, 1);
+    }
+    o->depth = 0;
+    o->records++;
+    out_flush_buf(o);
+}
+//---------
+void cli_out_object_begin(cli_out_t* o, const char* key) {
+    out_push(o, key, false);
+}
+//---------
+void cli_out_object_end(cli_out_t* o) {
+    out_pop(o, false);
+}
+//---------
+void cli_out_array_begin(cli_out_t* o, const char* key) {
+    out_push(o, key, true);
+}
+//---------
+void cli_out_array_end(cli_out_t* o) {
+    out_pop(o, true);
+}
+//---------
+void cli_out_uint(cli_out_t* o, const char* key, uint64_t value) {
+    if (!out_item_ok(o, key)) {
+        return;
+    }
+    if (o->mode == CLI_OUT_JSON) {
+        char text[24];
+        snprintf(text, sizeof(text), "%llu", (unsigned long long) value);
+        json_prefix(o, key);
+        json_put(o, text);
+    } else {
+        bin_item(o, CLI_OUT_T_UINT, key);
+        bin_varint(o, value);
+    }
+}
+//---------
+void cli_out_int(cli_out_t* o, const char* key, int64_t value) {
+    if (!out_item_ok(o, key)) {
+        return;
+    }
+    if (o->mode == CLI_OUT_JSON) {
+        char text[24];
+        snprintf(text, sizeof(text), "%lld", (long long) value);
+        json_prefix(o, key);
+        json_put(o, text);
+    } else {
+        bin_item(o, CLI_OUT_T_SINT, key);
+        bin_varint(o, ((uint64_t) value << 1) ^ (uint64_t) (value >> 63));
+    }
+}
+//---------
+void cli_out_float(cli_out_t* o, const char* key, float value) {
+    if (!out_item_ok(o, key)) {
+        return;
+    }
+    if (o->mode == CLI_OUT_JSON) {
+        char text[32];
+        cli_out_format_float(text, sizeof(text), value);
+        json_prefix(o, key);
+        json_put(o, text);
+    } else {
+        uint32_t bits;
+        memcpy(&bits, &value, sizeof(bits));
+        bin_item(o, CLI_OUT_T_FLOAT, key);
+        for (int i = 0; i < 4; i++) {
+            bin_byte(o, (uint8_t) (bits >> (8 * i)));
+        }
+    }
+}
+//---------
+static void out_literal(cli_out_t* o, const char* key, uint8_t type, const char* json) {
+    if (!out_item_ok(o, key)) {
+        return;
+    }
+    if (o->mode == CLI_OUT_JSON) {
+        json_prefix(o, key);
+        json_put(o, json);
+    } else {
+        bin_item(o, type, key);
+    }
+}
+//---------
+void cli_out_bool(cli_out_t* o, const char* key, bool value) {
+    out_literal(o, key, value ? CLI_OUT_T_TRUE : CLI_OUT_T_FALSE, value ? "true" : "false");
+}
+//---------
+void cli_out_null(cli_out_t* o, const char* key) {
+    out_literal(o, key, CLI_OUT_T_NULL, "null");
+}
+//---------
+void cli_out_strn(cli_out_t* o, const char* key, const char* value, size_t len) {
+    if (!out_item_ok(o, key)) {
+        return;
+    }
+    if (o->mode == CLI_OUT_JSON) {
+        json_prefix(o, key);
+        json_string(o, value, len);
+    } else {
+        bin_item(o, CLI_OUT_T_STR, key);
+        bin_varint(o, len);
+        bin_bytes(o, value, len);
+    }
+}
+//---------
+void cli_out_str(cli_out_t* o, const char* key, const char* value) {
+    if (value == NULL) {
+        cli_out_null(o, key);
+    } else {
+        cli_out_strn(o, key, value, strlen(value));
+    }
+}
+//---------
+void cli_out_flush(cli_out_t* o) {
+    out_flush_buf(o);
+}
+//---------
+int cli_out_format_float(char* buf, size_t size, float value) {
+    if (isnan(value) || isinf(value)) {
+        return snprintf(buf, size, "null");  // JSON nu are NaN / Infinity
+    }
+    return snprintf(buf, size, "%.7g", (double) value);
+}
+
+// -------------------------------------
+
+cli_out_mode_t cli_out_take_flag(char* line) {
+    cli_out_mode_t mode = CLI_OUT_TEXT;
+    char*          p    = line;
+    while (*p) {
+        while (*p == ' ' || *p == '\t') {
+            p++;
+        }
+        char* start  = p;
+        bool  quoted = false;
+        for (; *p && (quoted || (*p != ' ' && *p != '\t')); p++) {
+            if (*p == '\\' && p[1]) {
+                p++;
+            } else if (*p == '"') {
+                quoted = !quoted;
+            }
+        }
+        size_t         len   = (size_t) (p - start);
+        cli_out_mode_t found = CLI_OUT_TEXT;
+        if (len == 6 && memcmp(start, "--json", 6) == 0) {
+            found = CLI_OUT_JSON;
+        } else if (len == 5 && memcmp(start, "--bin", 5) == 0) {
+            found = CLI_OUT_BIN;
+        }
+        if (found != CLI_OUT_TEXT) {
+            mode = found;
+            while (*p == ' ' || *p == '\t') {
+                p++;
+            }
+            memmove(start, p, strlen(p) + 1);
+            p = start;
+        }
+    }
+    // Fara spatiile ramase la sfarsit ("uptime --json" -> "uptime ")
+    size_t len = strlen(line);
+    while (mode != CLI_OUT_TEXT && len && (line[len - 1] == ' ' || line[len - 1] == '\t')) {
+        line[--len] = '\0';
+    }
+    return mode;
+}
@@ -0,0 +1,57 @@
+/*
+ * `--json` / `--bin` pe placa: un singur emitter static (comenzile ruleaza pe task-ul consolei),
+ * activ cat ruleaza comanda care a cerut modul. Iesirea merge prin stdout, deci si prin captura
+ * lui `run` (pipe-uri).
+ */
+
+#include "cli_out.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include "esp_console.h"
+#include "esp_err.h"
+
+static cli_out_t s_out;
+static bool      s_active;
+
+// -------------------------------------
+
+static void cli_out_stdout_write(void* ctx, const void* data, size_t len) {
+    (void) ctx;
+    fwrite(data, 1, len, stdout);
+    fflush(stdout);  // O inregistrare = o scriere pe VFS
+}
+
+// -------------------------------------
+
+cli_out_t* cli_out_get(void) {
+    return s_active ? &s_out : NULL;
+}
+//---------
+int cli_out_run(char* line, int* ret, cli_out_mode_t* mode) {
+    cli_out_mode_t wanted = cli_out_take_flag(line);
+    bool           owner  = false;
+    if (!s_active && wanted != CLI_OUT_TEXT) {
+        cli_out_init(&s_out, wanted, cli_out_stdout_write, NULL);
+        s_active = owner = true;
+    }
+    *mode = s_active ? s_out.mode : CLI_OUT_TEXT;
+
+    *ret          = 0;
+    esp_err_t err = esp_console_run(line, ret);
+
+    // Eroarea ca inregistrare, nu ca text intre frame-uri (comanda goala nu e eroare)
+    if (s_active && err != ESP_ERR_INVALID_ARG && (err != ESP_OK || *ret != 0)) {
+        cli_out_record_begin(&s_out, "error");
+        cli_out_strn(&s_out, "command", line, strcspn(line, " \t"));
+        cli_out_str(&s_out, "err", esp_err_to_name(err));
+        cli_out_int(&s_out, "ret", err == ESP_OK ? *ret : 0);
+        cli_out_record_end(&s_out);
+    }
+    if (owner) {
+        cli_out_flush(&s_out);
+        s_active = false;
+    }
+    return err;
+}
@@ -0,0 +1,456 @@
+#include "history.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define HISTORY_HASH_LEN   (8)    // Hex digits before the separator
+#define HISTORY_HEADER_LEN (17)   // "<hash>#<generatie>", fara '\n'
+#define HISTORY_CHUNK      (128)  // Citiri din fisier (CONFIG_LITTLEFS_READ_SIZE)
+
+typedef enum {
+    HISTORY_END = 0,  // Sfarsitul fisierului
+    HISTORY_LINE,     // Linie completa
+    HISTORY_TORN,     // Ultima linie, fara '\n' (scriere intrerupta)
+    HISTORY_LONG,     // Mai lunga decat CLI_HISTORY_LINE_MAX, sarita
+} history_read_t;
+
+typedef struct {
+    const cli_history_io_t* io;
+    void*                   file;
+    char                    chunk[HISTORY_CHUNK];
+    size_t                  pos;
+    size_t                  len;
+    size_t                  total;  // Bytes cititi din fisier
+} history_reader_t;
+
+/* Ce a gasit history_scan_file intr-un fisier */
+typedef struct {
+    uint32_t count;   // Inregistrari valide
+    uint32_t bad;     // Rupte sau corupte
+    uint32_t gen;     // Din antet, 0 fara antet
+    size_t   bytes;
+    bool     legacy;  // Linii simple (linenoiseHistorySave)
+    bool     stale;   // Jurnal fara antet sau din alta generatie: ignorat
+} history_file_t;
+
+/* Apelat pentru fiecare comanda valida, cu indexul ei in tot istoricul */
+typedef int (*history_entry_fn_t)(void* ctx, uint32_t index, const char* cmd, size_t len);
+
+// -------------------------------------
+
+static uint32_t history_hash(const char* s, size_t len) {
+    uint32_t h = 2166136261u;  // FNV-1a
+    for (size_t i = 0; i < len; i++) {
+        h = (h ^ (uint8_t) s[i]) * 16777619u;
+    }
+    return h;
+}
+//---------
+static int history_getc(history_reader_t* r) {
+    if (r->pos == r->len) {
+        int n = r->io->read(r->io->ctx, r->file, r->chunk, sizeof(r->chunk));
+        if (n <= 0) {
+            return -1;
+        }
+        r->len = (size_t) n;
+        r->pos = 0;
+        r->total += (size_t) n;
+    }
+    return (uint8_t) r->chunk[r->pos++];
+}
+//---------
+static history_read_t history_read_line(history_reader_t* r, char* line, size_t* len) {
+    size_t n         = 0;
+    bool   long_line = false;
+    for (;;) {
+        int c = history_getc(r);
+        if (c < 0) {
+            *len = n;
+            return (n || long_line) ? HISTORY_TORN : HISTORY_END;
+        }
+        if (c == '\n') {
+            line[n] = '\0';
+            *len    = n;
+            return long_line ? HISTORY_LONG : HISTORY_LINE;
+        }
+        if (n < CLI_HISTORY_LINE_MAX - 1) {
+            line[n++] = (char) c;
+        } else {
+            long_line = true;
+        }
+    }
+}
+//---------
+static bool history_is_hex(const char* s, size_t len) {
+    for (size_t i = 0; i < len; i++) {
+        if (!((s[i] >= '0' && s[i] <= '9') || (s[i] >= 'a' && s[i] <= 'f'))) {
+            return false;
+        }
+    }
+    return true;
+}
+//---------
+/* Forma unei inregistrari (sep ' ') sau a antetului (sep '#'), chiar daca hash-ul nu se potriveste */
+static bool history_looks_like(const char* line, size_t len, char sep) {
+    return len > HISTORY_HASH_LEN && line[HISTORY_HASH_LEN] == sep && history_is_hex(line, HISTORY_HASH_LEN);
+}
+//---------
+static bool history_parse(const char* line, size_t len, const char** cmd, size_t* cmd_len) {
+    if (!history_looks_like(line, len, ' ') || len == HISTORY_HASH_LEN + 1) {
+        return false;
+    }
+    *cmd     = line + HISTORY_HASH_LEN + 1;
+    *cmd_len = len - HISTORY_HASH_LEN - 1;
+    return (uint32_t) strtoul(line, NULL, 16) == history_hash(*cmd, *cmd_len);
+}
+//---------
+static bool history_parse_header(const char* line, size_t len, uint32_t* gen) {
+    const char* digits = line + HISTORY_HASH_LEN + 1;
+    if (len != HISTORY_HEADER_LEN || !history_looks_like(line, len, '#') || !history_is_hex(digits, 8) ||
+        (uint32_t) strtoul(line, NULL, 16) != history_hash(digits, 8)) {
+        return false;
+    }
+    *gen = (uint32_t) strtoul(digits, NULL, 16);
+    return true;
+}
+//---------
+static size_t history_format_header(char* out, uint32_t gen) {
+    char digits[9];
+    snprintf(digits, sizeof(digits), "%08lx", (unsigned long) gen);
+    sprintf(out, "%08lx#%s\n", (unsigned long) history_hash(digits, 8), digits);
+    return HISTORY_HEADER_LEN + 1;
+}
+//---------
+static size_t history_format(char* out, const char* cmd, size_t len) {
+    sprintf(out, "%08lx ", (unsigned long) history_hash(cmd, len));
+    memcpy(out + HISTORY_HASH_LEN + 1, cmd, len);
+    out[HISTORY_HASH_LEN + 1 + len] = '\n';
+    return HISTORY_HASH_LEN + 2 + len;
+}
+//---------
+/**
+ * Parcurge un fisier: fn primeste comenzile valide, in ordine, cu indexul de la first. Fisierul
+ * compactat (expect_gen NULL) a carui prima linie nu e nici antet, nici inregistrare e unul vechi:
+ * fiecare linie nevida e o comanda. Jurnalul conteaza doar daca antetul lui are generatia
+ * *expect_gen. Intoarce false daca fisierul lipseste.
+ */
+static bool history_scan_file(cli_history_t* h, const char* path, const uint32_t* expect_gen, history_entry_fn_t fn,
+    void* ctx, uint32_t first, history_file_t* f) {
+    char             line[CLI_HISTORY_LINE_MAX];
+    history_reader_t r = {.io = h->io};
+    memset(f, 0, sizeof(*f));
+    r.file = h->io->open(h->io->ctx, path, "r");
+    if (r.file == NULL) {
+        return false;
+    }
+    size_t len;
+    bool   start = true;
+    for (history_read_t res; (res = history_read_line(&r, line, &len)) != HISTORY_END;) {
+        const char* cmd     = line;
+        size_t      cmd_len = len;
+        if (start) {
+            start = false;
+            if (res == HISTORY_LINE && history_parse_header(line, len, &f->gen)) {
+                if (expect_gen && f->gen != *expect_gen) {
+                    f->stale = true;
+                    break;
+                }
+                continue;
+            }
+            if (expect_gen) {
+                f->stale = true;
+                break;
+            }
+            if (res == HISTORY_LINE && !history_looks_like(line, len, ' ') && !history_looks_like(line, len, '#')) {
+                f->legacy = true;
+            }
+        }
+        if (res != HISTORY_LINE) {
+            f->bad++;
+            continue;
+        }
+        if (f->legacy) {
+            if (len == 0) {
+                continue;
+            }
+        } else if (!history_parse(line, len, &cmd, &cmd_len)) {
+            f->bad++;
+            continue;
+        }
+        if (fn && fn(ctx, first + f->count, cmd, cmd_len) != 0) {
+            break;
+        }
+        f->count++;
+    }
+    if (expect_gen && start) {
+        f->stale = true;  // Gol: nici antetul nu a ajuns pe flash
+    }
+    f->bytes = r.total;
+    h->io->close(h->io->ctx, r.file);
+    return true;
+}
+//---------
+/* Fisierul compactat, apoi jurnalul din aceeasi generatie; indexii continua de la unul la altul */
+static void history_scan(cli_history_t* h, history_entry_fn_t fn, void* ctx, history_file_t* base,
+    history_file_t* log) {
+    history_scan_file(h, h->path, NULL, fn, ctx, 0, base);
+    history_scan_file(h, h->log_path, &base->gen, fn, ctx, base->count, log);
+}
+
+// -------------------------------------
+
+typedef struct {
+    cli_history_t* h;
+    void*          file;
+    uint32_t       skip;
+    int            err;
+} history_copy_t;
+
+static int history_copy_entry(void* ctx, uint32_t index, const char* cmd, size_t len) {
+    history_copy_t* c = ctx;
+    if (index < c->skip) {
+        return 0;
+    }
+    char record[CLI_HISTORY_LINE_MAX + HISTORY_HASH_LEN + 2];
+    c->err = c->h->io->write(c->h->io->ctx, c->file, record, history_format(record, cmd, len));
+    return c->err;
+}
+//---------
+/* Inregistrarile din lot (deja formatate) cu indexul, numarat de la first, >= skip */
+static void history_copy_batch(history_copy_t* c, uint32_t first) {
+    cli_history_t* h   = c->h;
+    size_t         pos = 0;
+    for (uint32_t i = 0; i < h->writing_count && !c->err; i++) {
+        size_t end = (size_t) ((char*) memchr(h->writing + pos, '\n', h->writing_len - pos) - h->writing) + 1;
+        if (first + i >= c->skip) {
+            c->err = h->io->write(h->io->ctx, c->file, h->writing + pos, end - pos);
+        }
+        pos = end;
+    }
+}
+//---------
+/**
+ * Ultimele max_len comenzi (fisierul compactat + jurnalul + lotul, daca with_batch) intr-un fisier
+ * temporar cu generatia urmatoare, rename peste fisierul compactat, apoi jurnalul sters.
+ * found = comenzile valide gasite in fisiere.
+ */
+static int history_compact(cli_history_t* h, bool with_batch, uint32_t* found) {
+    const cli_history_io_t* io = h->io;
+    history_file_t          base, log;
+    history_scan(h, NULL, NULL, &base, &log);
+    *found         = base.count + log.count;
+    uint32_t total = *found + (with_batch ? h->writing_count : 0);
+
+    history_copy_t copy = {h, io->open(io->ctx, h->tmp_path, "w"), 0, 0};
+    if (copy.file == NULL) {
+        return -1;
+    }
+    copy.skip = total > h->max_len ? total - h->max_len : 0;
+    char header[HISTORY_HEADER_LEN + 2];
+    copy.err = io->write(io->ctx, copy.file, header, history_format_header(header, base.gen + 1));
+    if (!copy.err) {
+        history_scan(h, history_copy_entry, &copy, &base, &log);
+    }
+    if (!copy.err && with_batch) {
+        history_copy_batch(&copy, *found);
+    }
+    int err = io->close(io->ctx, copy.file);
+    if (copy.err || err) {
+        io->remove(io->ctx, h->tmp_path);
+        return copy.err ? copy.err : err;
+    }
+    if (io->rename(io->ctx, h->tmp_path, h->path) != 0) {
+        // FAT nu suprascrie la rename (littlefs da, atomic)
+        io->remove(io->ctx, h->path);
+        if ((err = io->rename(io->ctx, h->tmp_path, h->path)) != 0) {
+            return err;
+        }
+    }
+    // De aici jurnalul e din generatia veche: daca remove nu mai apuca, e ignorat la incarcare
+    io->remove(io->ctx, h->log_path);
+    h->generation   = base.gen + 1;
+    h->base_records = total - copy.skip;
+    h->log_records  = 0;
+    h->log_bytes    = 0;
+    h->damaged      = false;
+    h->compactions++;
+    if (with_batch) {
+        h->writing_len   = 0;
+        h->writing_count = 0;
+        h->flushes++;
+    }
+    return 0;
+}
+//---------
+/* Primele n inregistrari din lot au ajuns deja in jurnal (append intrerupt): nu le mai scriem */
+static void history_drop_written(cli_history_t* h, uint32_t n) {
+    size_t pos = 0;
+    n          = n < h->writing_count ? n : h->writing_count;
+    for (uint32_t i = 0; i < n; i++) {
+        pos = (size_t) ((char*) memchr(h->writing + pos, '\n', h->writing_len - pos) - h->writing) + 1;
+    }
+    memmove(h->writing, h->writing + pos, h->writing_len - pos);
+    h->writing_len -= pos;
+    h->writing_count -= n;
+}
+//---------
+static int history_append(cli_history_t* h) {
+    const cli_history_io_t* io    = h->io;
+    bool                    fresh = h->log_bytes == 0;  // "w": un jurnal din generatia veche e suprascris
+    void*                   file  = io->open(io->ctx, h->log_path, fresh ? "w" : "a");
+    if (file == NULL) {
+        return -1;
+    }
+    char   header[HISTORY_HEADER_LEN + 2];
+    size_t header_len = fresh ? history_format_header(header, h->generation) : 0;
+    int    err        = fresh ? io->write(io->ctx, file, header, header_len) : 0;
+    if (!err) {
+        err = io->write(io->ctx, file, h->writing, h->writing_len);
+    }
+    int cer = io->close(io->ctx, file);
+    if (err || cer) {
+        h->damaged = true;  // Poate a ramas o parte din lot, cu o linie rupta la sfarsit
+        return err ? err : cer;
+    }
+    h->log_bytes += header_len + h->writing_len;
+    h->log_records += h->writing_count;
+    h->writing_len   = 0;
+    h->writing_count = 0;
+    h->flushes++;
+    return 0;
+}
+
+// -------------------------------------
+
+bool cli_history_init(cli_history_t* h, const cli_history_io_t* io, const char* path, uint32_t max_len,
+    size_t buffer_size) {
+    memset(h, 0, sizeof(*h));
+    if (strlen(path) >= sizeof(h->path) || max_len == 0) {
+        return false;
+    }
+    strcpy(h->path, path);
+    snprintf(h->log_path, sizeof(h->log_path), "%s.log", path);
+    snprintf(h->tmp_path, sizeof(h->tmp_path), "%s.tmp", path);
+    h->io          = io;
+    h->max_len     = max_len;
+    h->buffer_size = buffer_size;
+    h->pending     = malloc(buffer_size);
+    h->writing     = malloc(buffer_size);
+    if (h->pending == NULL || h->writing == NULL) {
+        cli_history_deinit(h);
+        return false;
+    }
+    return true;
+}
+//---------
+void cli_history_deinit(cli_history_t* h) {
+    free(h->pending);
+    free(h->writing);
+    h->pending = NULL;
+    h->writing = NULL;
+}
+//---------
+typedef struct {
+    uint32_t             skip;
+    cli_history_add_fn_t add;
+    void*                ctx;
+    uint32_t             loaded;
+} history_load_t;
+
+static int history_load_entry(void* ctx, uint32_t index, const char* cmd, size_t len) {
+    history_load_t* l = ctx;
+    (void) len;  // cmd se termina cu '\0' (linia citita)
+    if (index >= l->skip) {
+        l->add(l->ctx, cmd);
+        l->loaded++;
+    }
+    return 0;
+}
+//---------
+uint32_t cli_history_load(cli_history_t* h, cli_history_add_fn_t add, void* ctx) {
+    h->io->remove(h->io->ctx, h->tmp_path);  // Compactare intrerupta: fisierele sunt inca cele vechi
+
+    history_file_t base, log;
+    history_scan(h, NULL, NULL, &base, &log);
+    uint32_t       total = base.count + log.count;
+    history_load_t load  = {total > h->max_len ? total - h->max_len : 0, add, ctx, 0};
+    history_scan(h, history_load_entry, &load, &base, &log);
+
+    h->generation   = base.gen;
+    h->base_records = base.count;
+    h->log_records  = log.count;
+    h->log_bytes    = log.stale ? 0 : log.bytes;
+    h->skipped += base.bad + log.bad;
+    if (log.stale) {
+        h->io->remove(h->io->ctx, h->log_path);
+    }
+    if (base.legacy || base.bad || log.bad || h->log_bytes > CLI_HISTORY_LOG_MAX) {
+        uint32_t found;
+        history_compact(h, false, &found);
+    }
+    return load.loaded;
+}
+//---------
+bool cli_history_push(cli_history_t* h, const char* line) {
+    size_t len = strlen(line);
+    if (len == 0) {
+        return false;
+    }
+    if (len > CLI_HISTORY_LINE_MAX - HISTORY_HASH_LEN - 2) {
+        len = CLI_HISTORY_LINE_MAX - HISTORY_HASH_LEN - 2;
+    }
+    if (h->pending_len + len + HISTORY_HASH_LEN + 2 > h->buffer_size) {
+        h->dropped++;
+        return true;
+    }
+    h->pending_len += history_format(h->pending + h->pending_len, line, len);
+    h->pending_count++;
+    return h->pending_len > h->buffer_size / 4 * 3;
+}
+//---------
+void cli_history_swap(cli_history_t* h) {
+    if (h->writing_len == 0) {
+        char* buf        = h->writing;
+        h->writing       = h->pending;
+        h->writing_len   = h->pending_len;
+        h->writing_count = h->pending_count;
+        h->pending       = buf;
+    } else if (h->writing_len + h->pending_len <= h->buffer_size) {
+        // Lotul anterior nu a fost scris: noile comenzi il urmeaza
+        memcpy(h->writing + h->writing_len, h->pending, h->pending_len);
+        h->writing_len += h->pending_len;
+        h->writing_count += h->pending_count;
+    } else {
+        return;
+    }
+    h->pending_len   = 0;
+    h->pending_count = 0;
+}
+//---------
+int cli_history_write(cli_history_t* h) {
+    int      err;
+    uint32_t found;
+    if (h->damaged) {
+        uint32_t before = h->base_records + h->log_records;
+        if ((err = history_compact(h, false, &found)) != 0) {
+            return err;
+        }
+        if (found > before) {
+            history_drop_written(h, found - before);
+        }
+    }
+    if (h->writing_len == 0) {
+        return 0;
+    }
+    if (h->log_bytes + h->writing_len > CLI_HISTORY_LOG_MAX) {
+        // Jurnalul n-ar mai sta inline: lotul merge direct in fisierul compactat
+        return history_compact(h, true, &found);
+    }
+    return history_append(h);
+}
+//---------
+int cli_history_flush(cli_history_t* h) {
+    cli_history_swap(h);
+    return cli_history_write(h);
+}
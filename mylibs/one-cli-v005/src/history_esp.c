@@ -0,0 +1,154 @@
+/*
+ * Istoricul comenzilor pe placa: linenoise pastreaza lista din RAM (sageti sus/jos), history.c
+ * scrie jurnalul. Consola doar adauga comanda in buffer (cli_history_note); task-ul "cli_hist"
+ * asteapta sa se linisteasca tastatura (CONSOLE_HISTORY_FLUSH_MS fara comenzi noi, cel mult
+ * CONSOLE_HISTORY_FLUSH_MAX_MS) si scrie tot lotul cu un singur append.
+ */
+
+#include "history.h"
+#include "config.h"
+
+#include <stdio.h>
+#include <unistd.h>
+
+#include "esp_log.h"
+#include "esp_system.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+#include "linenoise/linenoise.h"
+
+static const char* TAG = "CLI";
+
+static cli_history_t     s_history;
+static SemaphoreHandle_t s_pending_lock;  // pending: push / swap, scurt
+static SemaphoreHandle_t s_io_lock;       // writing + fisierele: un singur writer
+static TaskHandle_t      s_flush_task;
+static volatile bool     s_urgent;  // Buffer aproape plin: fara debounce
+
+// -------------------------------------
+
+static void* history_stdio_open(void* ctx, const char* path, const char* mode) {
+    (void) ctx;
+    return fopen(path, mode);
+}
+//---------
+static int history_stdio_read(void* ctx, void* file, void* buf, size_t len) {
+    (void) ctx;
+    size_t n = fread(buf, 1, len, (FILE*) file);
+    return (n == 0 && ferror((FILE*) file)) ? -1 : (int) n;
+}
+//---------
+static int history_stdio_write(void* ctx, void* file, const void* buf, size_t len) {
+    (void) ctx;
+    return fwrite(buf, 1, len, (FILE*) file) == len ? 0 : -1;
+}
+//---------
+static int history_stdio_close(void* ctx, void* file) {
+    (void) ctx;
+    int err = fflush((FILE*) file);
+    err |= fsync(fileno((FILE*) file));
+    err |= fclose((FILE*) file);
+    return err ? -1 : 0;
+}
+//---------
+static int history_stdio_rename(void* ctx, const char* from, const char* to) {
+    (void) ctx;
+    return rename(from, to);
+}
+//---------
+static int history_stdio_remove(void* ctx, const char* path) {
+    (void) ctx;
+    return remove(path);
+}
+
+static const cli_history_io_t s_stdio_io = {
+    .open   = history_stdio_open,
+    .read   = history_stdio_read,
+    .write  = history_stdio_write,
+    .close  = history_stdio_close,
+    .rename = history_stdio_rename,
+    .remove = history_stdio_remove,
+    .ctx    = NULL,
+};
+
+// -------------------------------------
+
+static void history_add_line(void* ctx, const char* line) {
+    (void) ctx;
+    linenoiseHistoryAdd(line);
+}
+//---------
+static void history_flush_task(void* parameter) {
+    (void) parameter;
+    for (;;) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        // Debounce: cat timp vin comenzi, mai asteptam (dar nu la nesfarsit)
+        TickType_t start = xTaskGetTickCount();
+        while (!s_urgent && xTaskGetTickCount() - start < pdMS_TO_TICKS(CONSOLE_HISTORY_FLUSH_MAX_MS) &&
+               ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(CONSOLE_HISTORY_FLUSH_MS)) != 0) {
+        }
+        s_urgent = false;
+        cli_history_sync();
+    }
+}
+
+// -------------------------------------
+
+bool cli_history_start(const char* path) {
+    if (s_flush_task != NULL) {
+        return true;
+    }
+    if (path == NULL || path[0] == '\0' ||
+        !cli_history_init(&s_history, &s_stdio_io, path, CONSOLE_HISTORY_MAX_LEN, CONSOLE_HISTORY_PENDING)) {
+        ESP_LOGE(TAG, "History disabled (path or memory)");
+        return false;
+    }
+    uint32_t loaded = cli_history_load(&s_history, history_add_line, NULL);
+    ESP_LOGI(TAG, "History: %lu commands from %s (%lu damaged records skipped)", (unsigned long) loaded, path,
+        (unsigned long) s_history.skipped);
+
+    s_pending_lock = xSemaphoreCreateMutex();
+    s_io_lock      = xSemaphoreCreateMutex();
+    if (s_pending_lock == NULL || s_io_lock == NULL ||
+        xTaskCreatePinnedToCore(history_flush_task, "cli_hist", CONSOLE_HISTORY_TASK_STACK, NULL, tskIDLE_PRIORITY + 1,
+            &s_flush_task, tskNO_AFFINITY) != pdPASS) {
+        ESP_LOGE(TAG, "History writer task not started, history is not saved");
+        s_flush_task = NULL;
+        return false;
+    }
+    // esp_restart() (comanda restart, OTA) scrie intai ce e in RAM
+    esp_register_shutdown_handler(cli_history_sync);
+    return true;
+}
+//---------
+void cli_history_note(const char* line) {
+    if (s_flush_task == NULL) {
+        return;
+    }
+    xSemaphoreTake(s_pending_lock, portMAX_DELAY);
+    bool urgent = cli_history_push(&s_history, line);
+    xSemaphoreGive(s_pending_lock);
+    if (urgent) {
+        s_urgent = true;
+    }
+    xTaskNotifyGive(s_flush_task);
+}
+//---------
+void cli_history_sync(void) {
+    if (s_flush_task == NULL) {
+        return;
+    }
+    // Timeout: la restart nu asteptam la nesfarsit un filesystem blocat
+    if (xSemaphoreTake(s_io_lock, pdMS_TO_TICKS(CONSOLE_HISTORY_SYNC_WAIT_MS)) != pdTRUE) {
+        return;
+    }
+    xSemaphoreTake(s_pending_lock, portMAX_DELAY);
+    cli_history_swap(&s_history);
+    xSemaphoreGive(s_pending_lock);
+    int err = cli_history_write(&s_history);
+    xSemaphoreGive(s_io_lock);
+    if (err) {
+        ESP_LOGW(TAG, "History write failed (%d), retried with the next batch", err);
+    }
+}
@@ -2,6 +2,7 @@
 #include "one-cli.h"
 #include "init.h"
 #include "config.h"
+#include "history.h"
 
 static const char *TAG = "CLI";
 
@@ -64,7 +65,7 @@ void initialize_console_library(const char *history_path) {
   linenoiseSetHintsCallback((linenoiseHintsCallback *)&esp_console_get_hint);
 
   /* Set command history size */
-  linenoiseHistorySetMaxLen(100);
+  linenoiseHistorySetMaxLen(CONSOLE_HISTORY_MAX_LEN);
 
   /* Set command maximum length */
   linenoiseSetMaxLineLen(console_config.max_cmdline_length);
@@ -73,8 +74,8 @@ void initialize_console_library(const char *history_path) {
   linenoiseAllowEmpty(false);
 
 #if CONFIG_CONSOLE_STORE_HISTORY
-  /* Load command history from filesystem */
-  linenoiseHistoryLoad(history_path);
+  /* Load command history from filesystem, then append new commands in the background */
+  cli_history_start(history_path);
 #endif  // CONFIG_CONSOLE_STORE_HISTORY
 
   /* Figure out if the terminal supports escape sequences */
@@ -5,11 +5,29 @@
 // include/command_line_interface.h
 #include "one-cli.h"
 #include "modules.h"
+#include "history.h"
+#include "cli_out.h"
 
 static const char* TAG = "CLI";
 
 // -------------------------------------------------
 
+#define CLI_MAX_EXTERNAL_COMMANDS (8)
+static cli_register_fn_t s_external_commands[CLI_MAX_EXTERNAL_COMMANDS];
+static size_t            s_external_command_count = 0;
+
+bool cli_add_external_command(cli_register_fn_t register_fn) {
+    if (register_fn == NULL || s_external_command_count >= CLI_MAX_EXTERNAL_COMMANDS)
+    {
+        ESP_LOGE(TAG, "Cannot add external command");
+        return false;
+    }
+    s_external_commands[s_external_command_count++] = register_fn;
+    return true;
+}
+
+// -------------------------------------------------
+
 void cli_register_all_commands(void) {
     esp_console_register_help_command(); // asta efunctia predefinita a esp -idf.. aici trebuie
                                          // lucrat in contionuare
@@ -23,6 +41,11 @@ void cli_register_all_commands(void) {
     cli_register_WiFi_join_command();
     cli_register_set_command();
     cli_register_perfmon_command();
+    cli_register_run_command();
+    for (size_t i = 0; i < s_external_command_count; i++)
+    {
+        s_external_commands[i]();
+    }
     return;
 }
 
@@ -74,6 +97,7 @@ void printStartupMessage() {
 // -------------------------------
 // Variabilă globală pentru path-ul istoriei
 static char s_history_path[64] = MOUNT_PATH "/history.txt";
+static cli_path_wait_fn_t s_history_wait = NULL;
 
 void cli_set_history_path(const char* path) {
     if (path == NULL)
@@ -86,12 +110,25 @@ void cli_set_history_path(const char* path) {
     ESP_LOGI(TAG, "History path set to: %s", s_history_path);
 }
 
+void cli_set_history_wait(cli_path_wait_fn_t wait_fn) {
+    s_history_wait = wait_fn;
+}
+
 void rtos_init_cli() {
     /* Initialize console output periheral (UART, USB_OTG, USB_JTAG) */
     initialize_console_peripheral();
 
+    /* The history may be on a filesystem that is still mounting (init_filesystem_sys) */
+    const char* history_path = s_history_path;
+    if (s_history_wait != NULL && !s_history_wait(s_history_path, CONSOLE_HISTORY_MOUNT_WAIT_MS))
+    {
+        ESP_LOGW(TAG, "%s not mounted after %d ms, history is not loaded or saved", s_history_path,
+            CONSOLE_HISTORY_MOUNT_WAIT_MS);
+        history_path = NULL;
+    }
+
     /* Initialize linenoise library and esp_console*/
-    initialize_console_library(s_history_path);
+    initialize_console_library(history_path);
 
     /* Prompt to be printed before each line.
      * This can be customized, made dynamic, etc.
@@ -139,18 +176,18 @@ void console_app(void* parameter) {
         {
             linenoiseHistoryAdd(line);
 #if CONFIG_CONSOLE_STORE_HISTORY
-            /* Save command history to filesystem */
-            if (s_history_path[0] != '\0')
-            { // avem path valid
-                linenoiseHistorySave(s_history_path);
-            }
+            /* Queue it for the history log (written in batches by the cli_hist task) */
+            cli_history_note(line);
 #endif // CONFIG_CONSOLE_STORE_HISTORY
         }
 
-        /* Try to run the command */
-        int       ret;
-        esp_err_t err = esp_console_run(line, &ret);
-        if (err == ESP_ERR_NOT_FOUND)
+        /* Try to run the command (`--json` / `--bin` anywhere on the line selects structured output) */
+        int            ret;
+        cli_out_mode_t out_mode;
+        esp_err_t      err = cli_out_run(line, &ret, &out_mode);
+        if (out_mode != CLI_OUT_TEXT)
+        { /* Errors were already sent as an "error" record */
+        } else if (err == ESP_ERR_NOT_FOUND)
         {
             printf("Unrecognized command\n");
         } else if (err == ESP_ERR_INVALID_ARG)
@@ -166,6 +203,9 @@ void console_app(void* parameter) {
     }
 
     ESP_LOGE(TAG, "Error or end-of-input, terminating console");
+#if CONFIG_CONSOLE_STORE_HISTORY
+    cli_history_sync();
+#endif // CONFIG_CONSOLE_STORE_HISTORY
     esp_console_deinit();
     return;
 }
@@ -0,0 +1,44 @@
+/*
+ * cli_out_cat - fluxul de pe consola (comenzi cu `--bin`) -> linii JSON pe stdout
+ *
+ *   cat /dev/ttyACM0 | cli_out_cat --crlf | jq .
+ *
+ * --crlf: consola placii a scris '\n' ca "\r\n" (initialize_console_peripheral). La sfarsit, pe
+ * stderr: inregistrari decodate si bucati sarite (prompt, log-uri, frame-uri stricate).
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "cli_out_dec.h"
+
+static void print_record(void* ctx, const char* json, size_t len) {
+    (void) ctx;
+    fwrite(json, 1, len, stdout);
+    fflush(stdout);  // Cine citeste vrea inregistrarile cand sosesc
+}
+
+int main(int argc, char** argv) {
+    static uint8_t frame[64 * 1024];
+    static char    json[256 * 1024];
+    bool           crlf = false;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--crlf")) {
+            crlf = true;
+        } else {
+            fprintf(stderr, "usage: %s [--crlf] < capture\n", argv[0]);
+            return 2;
+        }
+    }
+
+    cli_out_dec_t d;
+    cli_out_dec_init(&d, frame, sizeof(frame), json, sizeof(json), crlf, print_record, NULL);
+    uint8_t buf[4096];
+    size_t  n;
+    while ((n = fread(buf, 1, sizeof(buf), stdin)) > 0) {
+        cli_out_dec_feed(&d, buf, n);
+    }
+    fprintf(stderr, "%u records, %u skipped (%u bytes)\n", (unsigned) d.records, (unsigned) d.skipped,
+        (unsigned) d.skipped_bytes);
+    return 0;
+}
@@ -0,0 +1,317 @@
+#include "cli_out_dec.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include "cli_out.h"
+
+typedef struct {
+    char*  buf;
+    size_t cap;
+    size_t len;
+    bool   ok;
+} dec_json_t;
+
+typedef struct {
+    const uint8_t* p;
+    const uint8_t* end;
+} dec_reader_t;
+
+typedef struct {
+    const uint8_t* text;
+    size_t         len;
+} dec_key_t;
+
+// -------------------------------------
+
+static void json_raw(dec_json_t* j, const void* data, size_t len) {
+    if (!j->ok || j->cap - j->len < len + 1) {
+        j->ok = false;
+        return;
+    }
+    memcpy(j->buf + j->len, data, len);
+    j->len += len;
+    j->buf[j->len] = '\0';
+}
+//---------
+static void json_put(dec_json_t* j, const char* s) {
+    json_raw(j, s, strlen(s));
+}
+//---------
+/* Aceleasi escape-uri ca emitter-ul (src/cli_out.c), ca liniile sa fie identice */
+static void json_string(dec_json_t* j, const uint8_t* s, size_t len) {
+    json_raw(j, "\"", 1);
+    for (size_t i = 0; i < len; i++) {
+        uint8_t c = s[i];
+        char    esc[8];
+        switch (c) {
+            case '"': json_put(j, "\\\""); break;
+            case '\\': json_put(j, "\\\\"); break;
+            case '\n': json_put(j, "\\n"); break;
+            case '\r': json_put(j, "\\r"); break;
+            case '\t': json_put(j, "\\t"); break;
+            default:
+                if (c < 0x20) {
+                    snprintf(esc, sizeof(esc), "\\u%04x", c);
+                    json_put(j, esc);
+                } else {
+                    json_raw(j, &c, 1);
+                }
+                break;
+        }
+    }
+    json_raw(j, "\"", 1);
+}
+//---------
+static bool read_varint(dec_reader_t* r, uint64_t* value) {
+    *value = 0;
+    for (int shift = 0; shift < 64 && r->p < r->end; shift += 7) {
+        uint8_t b = *r->p++;
+        *value |= (uint64_t) (b & 0x7F) << shift;
+        if (!(b & 0x80)) {
+            return true;
+        }
+    }
+    return false;
+}
+//---------
+static bool read_bytes(dec_reader_t* r, const uint8_t** data, size_t* len) {
+    uint64_t n;
+    if (!read_varint(r, &n) || n > (uint64_t) (r->end - r->p)) {
+        return false;
+    }
+    *data = r->p;
+    *len  = (size_t) n;
+    r->p += n;
+    return true;
+}
+//---------
+static uint16_t crc16(const uint8_t* data, size_t len) {
+    uint16_t crc = 0xFFFF;
+    for (size_t i = 0; i < len; i++) {
+        crc ^= (uint16_t) data[i] << 8;
+        for (int b = 0; b < 8; b++) {
+            crc = (crc & 0x8000) ? (uint16_t) ((crc << 1) ^ 0x1021) : (uint16_t) (crc << 1);
+        }
+    }
+    return crc;
+}
+//---------
+/* COBS in loc; lungimea payload-ului sau -1 */
+static int cobs_decode(uint8_t* frame, size_t len) {
+    size_t in = 0, out = 0;
+    while (in < len) {
+        uint8_t code = frame[in++];
+        size_t  n    = (size_t) code - 1;
+        if (code == 0 || n > len - in) {
+            return -1;
+        }
+        memmove(frame + out, frame + in, n);
+        out += n;
+        in += n;
+        if (code != 0xFF && in < len) {
+            frame[out++] = 0;
+        }
+    }
+    return (int) out;
+}
+
+// -------------------------------------
+
+int cli_out_dec_frame(uint8_t* frame, size_t len, char* json, size_t json_cap) {
+    int payload = cobs_decode(frame, len);
+    if (payload < 3 || frame[0] != CLI_OUT_BIN_MAGIC) {
+        return -1;
+    }
+    size_t n = (size_t) payload - 2;
+    if (crc16(frame, n) != (uint16_t) (frame[n] | (frame[n + 1] << 8))) {
+        return -1;
+    }
+
+    dec_reader_t   r = {frame + 1, frame + n};
+    dec_json_t     j = {json, json_cap, 0, json_cap > 0};
+    dec_key_t      keys[CLI_OUT_KEYS];
+    size_t         key_count = 0;
+    bool           is_array[CLI_OUT_DEPTH];
+    bool           has_items[CLI_OUT_DEPTH];
+    size_t         depth = 1;
+    const uint8_t* text;
+    size_t         text_len;
+
+    if (!read_bytes(&r, &text, &text_len)) {
+        return -1;
+    }
+    json_put(&j, "{\"type\":");
+    json_string(&j, text, text_len);
+    is_array[0]  = false;
+    has_items[0] = true;
+
+    while (r.p < r.end) {
+        uint8_t tag  = *r.p++;
+        uint8_t type = tag & 0x0F;
+        uint8_t kn   = tag >> 4;
+
+        if (type == CLI_OUT_T_END) {
+            if (depth < 2 || kn != 0) {
+                return -1;
+            }
+            depth--;
+            json_put(&j, is_array[depth] ? "]" : "}");
+            continue;
+        }
+
+        const dec_key_t* key = NULL;
+        dec_key_t        new_key;
+        if (is_array[depth - 1]) {
+            if (kn != 0) {
+                return -1;
+            }
+        } else if (kn >= 1 && kn <= 13) {
+            if ((size_t) (kn - 1) >= key_count) {
+                return -1;
+            }
+            key = &keys[kn - 1];
+        } else if (kn == 14) {
+            if (r.p == r.end || *r.p >= key_count) {
+                return -1;
+            }
+            key = &keys[*r.p++];
+        } else if (kn == 15) {
+            if (!read_bytes(&r, &new_key.text, &new_key.len)) {
+                return -1;
+            }
+            if (key_count < CLI_OUT_KEYS) {
+                keys[key_count++] = new_key;
+            }
+            key = &new_key;
+        } else {
+            return -1;
+        }
+
+        if (has_items[depth - 1]) {
+            json_put(&j, ",");
+        }
+        has_items[depth - 1] = true;
+        if (key) {
+            json_string(&j, key->text, key->len);
+            json_put(&j, ":");
+        }
+
+        char     number[32];
+        uint64_t v;
+        switch (type) {
+            case CLI_OUT_T_UINT:
+                if (!read_varint(&r, &v)) {
+                    return -1;
+                }
+                snprintf(number, sizeof(number), "%llu", (unsigned long long) v);
+                json_put(&j, number);
+                break;
+            case CLI_OUT_T_SINT:
+                if (!read_varint(&r, &v)) {
+                    return -1;
+                }
+                snprintf(number, sizeof(number), "%lld", (long long) ((v >> 1) ^ (~(v & 1) + 1)));
+                json_put(&j, number);
+                break;
+            case CLI_OUT_T_FLOAT: {
+                if (r.end - r.p < 4) {
+                    return -1;
+                }
+                uint32_t bits = (uint32_t) r.p[0] | (uint32_t) r.p[1] << 8 | (uint32_t) r.p[2] << 16 |
+                                (uint32_t) r.p[3] << 24;
+                float f;
+                memcpy(&f, &bits, sizeof(f));
+                r.p += 4;
+                cli_out_format_float(number, sizeof(number), f);
+                json_put(&j, number);
+                break;
+            }
+            case CLI_OUT_T_STR:
+                if (!read_bytes(&r, &text, &text_len)) {
+                    return -1;
+                }
+                json_string(&j, text, text_len);
+                break;
+            case CLI_OUT_T_TRUE: json_put(&j, "true"); break;
+            case CLI_OUT_T_FALSE: json_put(&j, "false"); break;
+            case CLI_OUT_T_NULL: json_put(&j, "null"); break;
+            case CLI_OUT_T_OBJECT:
+            case CLI_OUT_T_ARRAY:
+                if (depth == CLI_OUT_DEPTH) {
+                    return -1;
+                }
+                is_array[depth]  = type == CLI_OUT_T_ARRAY;
+                has_items[depth] = false;
+                depth++;
+                json_put(&j, type == CLI_OUT_T_ARRAY ? "[" : "{");
+                break;
+            default:
+                return -1;
+        }
+    }
+    if (depth != 1) {
+        return -1;
+    }
+    json_put(&j, "}\n");
+    return j.ok ? (int) j.len : -1;
+}
+
+// -------------------------------------
+
+void cli_out_dec_init(cli_out_dec_t* d, uint8_t* frame, size_t frame_cap, char* json, size_t json_cap, bool crlf,
+    cli_out_dec_record_fn_t record, void* ctx) {
+    memset(d, 0, sizeof(*d));
+    d->frame     = frame;
+    d->frame_cap = frame_cap;
+    d->json      = json;
+    d->json_cap  = json_cap;
+    d->crlf      = crlf;
+    d->record    = record;
+    d->ctx       = ctx;
+}
+//---------
+static void dec_byte(cli_out_dec_t* d, uint8_t b) {
+    if (b != 0) {
+        if (d->frame_len < d->frame_cap) {
+            d->frame[d->frame_len++] = b;
+        } else {
+            d->overflow = true;
+            d->skipped_bytes++;
+        }
+        return;
+    }
+    if (d->frame_len == 0 && !d->overflow) {
+        return;  // Intre doua frame-uri lipite
+    }
+    int n = d->overflow ? -1 : cli_out_dec_frame(d->frame, d->frame_len, d->json, d->json_cap);
+    if (n >= 0) {
+        d->records++;
+        d->record(d->ctx, d->json, (size_t) n);
+    } else {
+        d->skipped++;
+        d->skipped_bytes += (uint32_t) d->frame_len;
+    }
+    d->frame_len = 0;
+    d->overflow  = false;
+}
+//---------
+void cli_out_dec_feed(cli_out_dec_t* d, const void* data, size_t len) {
+    const uint8_t* p = data;
+    for (size_t i = 0; i < len; i++) {
+        uint8_t b = p[i];
+        if (d->crlf) {
+            if (d->pending_cr) {
+                d->pending_cr = false;
+                if (b != '\n') {
+                    dec_byte(d, '\r');
+                }
+            }
+            if (b == '\r') {
+                d->pending_cr = true;
+                continue;
+            }
+        }
+        dec_byte(d, b);
+    }
+}
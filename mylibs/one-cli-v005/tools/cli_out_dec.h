@@ -0,0 +1,63 @@
+#pragma once
+
+#ifndef CLI_OUT_DEC_H
+#define CLI_OUT_DEC_H
+
+/*
+ * Decodorul pentru `--bin` (formatul e descris in include/cli_out.h), pentru tool-urile de pe PC.
+ * Primeste fluxul de pe portul serial in bucati oricat de mici si da, pentru fiecare frame valid,
+ * exact linia JSON pe care ar fi scris-o `--json`. Ce e intre frame-uri (prompt, log-uri, text de
+ * la alte comenzi) sau un frame cu CRC gresit e numarat si sarit.
+ *
+ * Consola placii scrie '\n' ca "\r\n" (usb_serial_jtag_vfs_set_tx_line_endings), si in frame-uri;
+ * cu crlf = true decodorul face conversia inversa inainte de COBS.
+ *
+ * Fara alocari: bufferele le da apelantul.
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* #ifdef __cplusplus */
+
+/* Pentru fiecare inregistrare: o linie JSON, cu '\n' la sfarsit */
+typedef void (*cli_out_dec_record_fn_t)(void* ctx, const char* json, size_t len);
+
+typedef struct {
+    uint8_t* frame;  // Bytes primiti de la ultimul '\0'
+    size_t   frame_cap;
+    size_t   frame_len;
+    bool     overflow;  // Bucata curenta nu a incaput in frame (aruncata la urmatorul '\0')
+    char*    json;
+    size_t   json_cap;
+    bool     crlf;
+    bool     pending_cr;
+
+    cli_out_dec_record_fn_t record;
+    void*                   ctx;
+
+    uint32_t records;
+    uint32_t skipped;        // Bucati dintre '\0' care nu au fost frame-uri valide
+    uint32_t skipped_bytes;
+} cli_out_dec_t;
+
+void cli_out_dec_init(cli_out_dec_t* d, uint8_t* frame, size_t frame_cap, char* json, size_t json_cap, bool crlf,
+    cli_out_dec_record_fn_t record, void* ctx);
+
+/* Bytes de pe fir, in orice impartire */
+void cli_out_dec_feed(cli_out_dec_t* d, const void* data, size_t len);
+
+/**
+ * @brief Un frame fara delimitatori: COBS (decodat in loc), CRC, apoi JSON in json.
+ * @return lungimea liniei JSON sau -1 daca frame-ul nu e valid / json e prea mic
+ */
+int cli_out_dec_frame(uint8_t* frame, size_t len, char* json, size_t json_cap);
+
+#ifdef __cplusplus
+}
+#endif /* #ifdef __cplusplus */
+
+#endif /* #ifndef CLI_OUT_DEC_H */
@@ -1,11 +1,16 @@
 #pragma once
 
+// Project-specific includes
+#include "sysmon_index.h"
+#include "sysmon_rollup.h"
+
 // ESP-IDF includes
 #include "esp_err.h"
 #include "esp_http_server.h"
 #include "freertos/task.h"
 
 // System includes
+#include <stddef.h>
 #include <stdint.h>
 #include <stdbool.h>
 
@@ -73,21 +78,21 @@ extern const uint8_t _binary_app_js_start[];
 extern const uint8_t _binary_app_js_end[];
 
 /**
- * @brief Stores usage samples and statistics for a single tracked FreeRTOS task.
+ * @brief Stores metadata for a single tracked FreeRTOS task (one slot of the task table).
  *
- * This struct contains both the time-series history buffers used by the sampler and metadata fields
- * populated from the FreeRTOS TaskStatus_t snapshot during each sampling interval.
- * Members are populated and updated by the monitor logic in sysmon.c.
+ * This struct contains the metadata fields populated from the FreeRTOS TaskStatus_t snapshot during
+ * each sampling interval. The per-sample history of the task lives in SysMonState.history, in column
+ * `slot` (see _history_at()). Members are populated and updated by the task table in sysmon_tasks.c.
  *
  * Members                       : 
- * - task_name                   : Fixed-length buffer holding the task name (matches t->pcTaskName from TaskStatus_t).
- * - usage_percent_history       : Array of per-sample CPU usage percentages for this task (cyclic buffer).
- * - stack_usage_bytes_history   : Array of per-sample stack usage in bytes (cyclic buffer).
- * - stack_usage_percent_history : Array of per-sample stack usage as a percentage of stack_size_bytes (cyclic buffer).
- * - write_index                 : Index for the next write into the rolling history buffers.
+ * - task_name                   : Fixed-length buffer holding the task name (t->pcTaskName from TaskStatus_t; a second live
+ *                                 task with the same name gets a "#<task_id>" suffix so every name stays unique).
+ * - handle                      : FreeRTOS handle of the task (key of the stack size registry).
  * - is_active                   : Whether this entry represents a currently observed (alive) task.
  * - consecutive_zero_samples    : Number of consecutive samples this task's usage was zero (used to time out deleted tasks).
- * - task_id                     : RTOS-assigned numeric task ID (from TaskStatus_t.xTaskNumber).
+ * - last_seen_seq               : Sample sequence number (SysMonState.sample_seq + 1) of the last sample this task was seen in.
+ * - next_free                   : Next slot of the free list while the slot is unused, -1 at the end of the list.
+ * - task_id                     : RTOS-assigned numeric task ID (from TaskStatus_t.xTaskNumber), key of SysMonState.task_index.
  * - current_priority            : Current FreeRTOS priority of the task (from TaskStatus_t.uxCurrentPriority).
  * - base_priority               : Initial or base FreeRTOS priority for this task (from TaskStatus_t.uxBasePriority).
  * - total_run_time_ticks        : Cumulative run time as counted by FreeRTOS up to the latest sample (from TaskStatus_t.ulRunTimeCounter).
@@ -95,20 +100,19 @@ extern const uint8_t _binary_app_js_end[];
  * - stack_size_bytes            : Stack size in bytes (as registered, see sysmon_stack API).
  * - core_id                     : The core number this task is running/pinned to (from TaskStatus_t.xCoreID).
  * - prev_run_time_ticks         : Logical copy of previous ulRunTimeCounter for this task since the last sample, used for delta calculations.
+ * - run_time_stale              : The last sample did not have the task's run time (missing from the trace): prev_run_time_ticks is no base.
  *
- * The time series buffers have length = CONFIG_SYSMON_SAMPLE_COUNT and are maintained as circular buffers.
- * This structure is filled, tracked, and used internally by sysmon.c and exposed to JSON and telemetry handlers.
+ * This structure is filled, tracked, and used internally by sysmon_tasks.c and exposed to JSON and telemetry handlers.
  */
 
 typedef struct
 {
     char task_name[24];
-    float usage_percent_history[CONFIG_SYSMON_SAMPLE_COUNT];
-    uint32_t stack_usage_bytes_history[CONFIG_SYSMON_SAMPLE_COUNT];
-    float stack_usage_percent_history[CONFIG_SYSMON_SAMPLE_COUNT];
-    int write_index;
+    TaskHandle_t handle;
     bool is_active;
     int consecutive_zero_samples;
+    uint32_t last_seen_seq;
+    int next_free;
     UBaseType_t task_id;
     UBaseType_t current_priority;
     UBaseType_t base_priority;
@@ -117,8 +121,29 @@ typedef struct
     uint32_t stack_size_bytes;
     int core_id;
     uint32_t prev_run_time_ticks;
+    bool run_time_stale;
 } TaskUsageSample;
 
+/**
+ * @brief Per-task history buffers, struct-of-arrays.
+ *
+ * Each array holds CONFIG_SYSMON_SAMPLE_COUNT rows of task_capacity values: row = one sample of every
+ * task slot, column = one task. A sampling cycle writes one contiguous row per array instead of
+ * touching three arrays inside every task struct. All tasks advance together, so the rows share
+ * SysMonState.series_write_index as their cyclic write index.
+ *
+ * Members:
+ * - usage_percent       : CPU usage percentage per sample.
+ * - stack_usage_bytes   : Stack usage in bytes per sample.
+ * - stack_usage_percent : Stack usage as a percentage of stack_size_bytes per sample.
+ */
+typedef struct
+{
+    float *usage_percent;
+    uint32_t *stack_usage_bytes;
+    float *stack_usage_percent;
+} TaskHistory;
+
 /**
  * @brief Stores global usage and state for the sysmon monitor.
  *
@@ -128,7 +153,14 @@ typedef struct
  *
  * Members:
  * - httpd                : Handle to the HTTP server providing sysmon telemetry endpoints.
- * - tasks                : Array of per-task usage samples (TaskUsageSample), dynamically allocated.
+ * - tasks                : Task table, array of per-task metadata (TaskUsageSample), dynamically allocated.
+ * - history              : Per-task history rows (TaskHistory), CONFIG_SYSMON_SAMPLE_COUNT x task_capacity.
+ * - history_first_row    : Ring index held by row 0 of history. 0 in `self`; in a snapshot view, which only
+ *                          holds the newest rows, the ring index of the oldest copied row.
+ * - rollup               : Min/avg/max rollup tiers (1 sample, 10 s, 1 min buckets) of the system series and
+ *                          of every task slot, sized with the task table (see sysmon_rollup.h).
+ * - task_index           : Hash index xTaskNumber -> slot in tasks.
+ * - free_slot            : Head of the free slot list (TaskUsageSample.next_free), -1 when the table is full.
  * - task_status          : Array of TaskStatus_t used to query live FreeRTOS task states.
  * - task_capacity        : Capacity of the allocated tasks/task_status arrays (number of slots).
  * - prev_total_run_time  : Snapshot of the previous global runtime tick count (for usage delta calculation).
@@ -145,17 +177,26 @@ typedef struct
  * - psram_total          : Ring buffer of PSRAM total bytes.
  * - psram_used_percent   : Ring buffer of PSRAM usage percent.
  *
- * - series_write_index   : Ring buffer write head for time-series data.
+ * - series_write_index   : Ring buffer write head for time-series data (system series and task history rows).
+ * - sample_seq           : Number of completed sampling cycles (sequence number of the newest sample,
+ *                          used by /history?since=<seq>).
  * - psram_seen           : True if PSRAM is detected on this platform/session.
  * - log_decimator        : Used for periodic logging throttling.
  *
  * The structure is owned and manipulated exclusively by sysmon.c, but its
  * reference is provided by extern for certain operations in other modules.
+ * The sampler changes it inside sysmon_snapshot_write_begin()/_end(); the HTTP
+ * handlers read a copy made by sysmon_snapshot_take(), never `self` directly.
  */
 typedef struct
 {
     httpd_handle_t httpd;
     TaskUsageSample *tasks;
+    TaskHistory history;
+    int history_first_row;
+    sysmon_rollup_t rollup;
+    sysmon_index_t task_index;
+    int free_slot;
     TaskStatus_t *task_status;
     int task_capacity;
     uint32_t prev_total_run_time;
@@ -174,6 +215,7 @@ typedef struct
     float psram_used_percent[CONFIG_SYSMON_SAMPLE_COUNT];
 
     int series_write_index;
+    uint32_t sample_seq;
     bool psram_seen;
     int log_decimator;
 } SysMonState;
@@ -181,6 +223,24 @@ typedef struct
 // Shared module state (defined in sysmon.c)
 extern SysMonState self;
 
+/**
+ * @brief Position of (sample, task slot) in the TaskHistory arrays of `state`
+ *        (`self`, or a view from sysmon_snapshot_take()).
+ */
+static inline size_t _history_at(const SysMonState *state, int sample, int slot)
+{
+    int row = (sample - state->history_first_row + CONFIG_SYSMON_SAMPLE_COUNT) % CONFIG_SYSMON_SAMPLE_COUNT;
+    return (size_t)row * (size_t)state->task_capacity + (size_t)slot;
+}
+
+/**
+ * @brief Ring index of the newest sample (task history rows and system series).
+ */
+static inline int _newest_sample_index(const SysMonState *state)
+{
+    return (state->series_write_index - 1 + CONFIG_SYSMON_SAMPLE_COUNT) % CONFIG_SYSMON_SAMPLE_COUNT;
+}
+
 /**
  * @brief Initialize System Monitor: start HTTP server on port 81 and task monitor.
  *
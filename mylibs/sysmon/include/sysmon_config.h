@@ -3,16 +3,21 @@
  * @brief Configuration structures and macros for HTTP server route handlers.
  *
  * This header defines the configuration structures and helper macros used to
- * configure static file handlers and JSON endpoint handlers in the sysmon
- * HTTP server.
+ * configure static file handlers and streamed endpoint handlers in the sysmon
+ * HTTP server, and declares the generated table of dashboard assets.
  */
 
 #pragma once
 
+// Project-specific includes
+#include "sysmon_stream.h"
+
 // ESP-IDF includes
-#include "cJSON.h"
+#include "esp_err.h"
 
 // System includes
+#include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 
 #ifdef __cplusplus
@@ -21,48 +26,87 @@ extern "C" {
 
 /**
  * @brief Configuration structure for static file handlers.
+ *
+ * The dashboard table (sysmon_www_files) is generated at build time by tools/sysmon_www_pack.py.
+ * etag: quoted strong ETag, answered with 304 when If-None-Match lists it (NULL: always 200).
+ * cache_control: Cache-Control header value (NULL: none).
+ * gzip: start..end is gzip data, sent with Content-Encoding: gzip.
  */
 typedef struct
 {
     const char *uri;
+    const char *content_type;
     const uint8_t *start;
     const uint8_t *end;
+    const char *etag;
+    const char *cache_control;
+    bool gzip;
 } static_file_config_t;
 
 /**
- * @brief Configuration structure for JSON endpoint handlers.
+ * @brief Configuration structure for streamed (JSON or CBOR) endpoint handlers.
+ *
+ * history_rows: task history rows the document reads from its snapshot, 1 (newest sample)
+ * or CONFIG_SYSMON_SAMPLE_COUNT (reduced to the ?since= delta when the client sends one).
+ * 0: the document does not read the samples at all (no snapshot, no X-Sysmon-* headers).
+ * rollup: the document reads the rollup tier selected by ?tier= (sysmon_snapshot_take_rollup())
+ * instead of history rows.
  */
 typedef struct
 {
     const char *uri;
-    cJSON *(*create_json)(void);
-} json_handler_config_t;
+    esp_err_t (*stream_document)(sysmon_stream_t *stream, const SysMonState *state, const sysmon_stream_query_t *query);
+    int history_rows;
+    bool rollup;
+} stream_handler_config_t;
+
+/**
+ * @brief Macro to simplify streamed endpoint entry configuration.
+ *
+ * @param uri_path URI path for the endpoint
+ * @param stream_func Document function from sysmon_stream.h
+ * @param rows History rows the document reads (see stream_handler_config_t)
+ */
+#define STREAM_ENDPOINT_ENTRY(uri_path, stream_func, rows) \
+    { \
+        .uri             = uri_path, \
+        .stream_document = stream_func, \
+        .history_rows    = rows \
+    }
 
 /**
- * @brief Macro to simplify binary file entry configuration.
+ * @brief Macro to simplify streamed entry configuration for documents that read no samples (history_rows 0).
  *
- * @param uri_path URI path for the static file
- * @param name Base name of the binary symbol (e.g., "index_html" for _binary_index_html_start)
+ * @param uri_path URI path for the endpoint
+ * @param stream_func Document function, called with a zeroed state
  */
-#define STATIC_FILE_ENTRY(uri_path, name) \
+#define STREAM_STATIC_ENDPOINT_ENTRY(uri_path, stream_func) \
     { \
-        .uri   = uri_path, \
-        .start = _binary_##name##_start, \
-        .end   = _binary_##name##_end \
+        .uri             = uri_path, \
+        .stream_document = stream_func, \
+        .history_rows    = 0 \
     }
 
 /**
- * @brief Macro to simplify JSON endpoint entry configuration.
+ * @brief Macro to simplify streamed rollup endpoint entry configuration (?tier=, see stream_handler_config_t).
  *
- * @param uri_path URI path for the JSON endpoint
- * @param create_json_func Function pointer to JSON creation function
+ * @param uri_path URI path for the endpoint
+ * @param stream_func Document function from sysmon_stream.h
  */
-#define JSON_ENDPOINT_ENTRY(uri_path, create_json_func) \
+#define STREAM_ROLLUP_ENDPOINT_ENTRY(uri_path, stream_func) \
     { \
-        .uri         = uri_path, \
-        .create_json = create_json_func \
+        .uri             = uri_path, \
+        .stream_document = stream_func, \
+        .history_rows    = 1, \
+        .rollup          = true \
     }
 
+/**
+ * @brief Dashboard assets packed from www/ at build time (gzip, ETag, Cache-Control).
+ */
+extern const static_file_config_t sysmon_www_files[];
+extern const size_t sysmon_www_file_count;
+
 #ifdef __cplusplus
 }
 #endif
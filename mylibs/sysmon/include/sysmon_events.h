@@ -0,0 +1,41 @@
+/**
+ * @file sysmon_events.h
+ * @brief /events endpoint: sysmon samples pushed to the dashboard as Server-Sent Events.
+ *
+ * Glue between sysmon_push.c and the ESP-IDF HTTP server. Every sample, sysmon_monitor
+ * calls sysmon_events_publish(): if a client is subscribed, it encodes a "telemetry" event
+ * (the /telemetry document) and, every CONFIG_SYSMON_PUSH_TASKS_EVERY samples, a "tasks"
+ * event (the /tasks document), then queues the send work on the HTTP server task.
+ */
+
+#pragma once
+
+// ESP-IDF includes
+#include "esp_err.h"
+#include "esp_http_server.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Push the sample just published to the subscribed clients.
+ *
+ * Called only from the sysmon_monitor task, after sysmon_snapshot_write_end(). Does
+ * nothing while no client is subscribed.
+ */
+void sysmon_events_publish(void);
+
+/**
+ * @brief httpd_config_t.close_fn of the sysmon server: unsubscribes the socket, then closes it.
+ */
+void sysmon_events_close_fn(httpd_handle_t hd, int sockfd);
+
+/**
+ * @brief Free the queued events (called during sysmon_deinit, after the sampler is stopped).
+ */
+void sysmon_events_cleanup(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,60 @@
+/**
+ * @file sysmon_hardware.h
+ * @brief /hardware document: chip, memory and partition table, encoded once and cached.
+ *
+ * Walking the partition table is the expensive part of /hardware: every app partition
+ * costs an esp_flash_read() of its image header plus one per segment header, every NVS
+ * partition an nvs_get_stats(). That data only changes when an OTA update writes an app
+ * partition or NVS commits entries, so the static members of the document (chip, memory,
+ * partitions, flashSummary, config) are encoded once per wire format and kept as bytes.
+ * A request copies those bytes and appends the members that change on their own
+ * (system with bootTime, wifi).
+ *
+ * The cache is versioned by two counters, bumped by the application:
+ *   - sysmon_hardware_note_ota()        after esp_ota_end() / esp_ota_set_boot_partition()
+ *   - sysmon_hardware_note_nvs_commit() after nvs_commit()
+ * The next request sees a counter that differs from the one the cache was built with and
+ * rebuilds it. Without the hooks, partition usage stays as read by the first request.
+ *
+ * The hooks may be called from any task. The cache itself is only touched by the HTTP
+ * server task (one request at a time).
+ */
+
+#pragma once
+
+// Project-specific includes
+#include "sysmon_stream.h"
+
+// ESP-IDF includes
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief The /hardware document (stream endpoint, reads no snapshot: `state` and `query` are unused).
+ *
+ * Same fields as the former cJSON builder, in the order chip, memory, partitions,
+ * flashSummary, config, system, wifi. Percentages are rounded to 2 decimals.
+ */
+esp_err_t sysmon_stream_hardware(sysmon_stream_t *stream, const SysMonState *state, const sysmon_stream_query_t *query);
+
+/**
+ * @brief An app partition was written (OTA end, boot partition changed): rebuild on the next request.
+ */
+void sysmon_hardware_note_ota(void);
+
+/**
+ * @brief NVS entries were committed: rebuild on the next request.
+ */
+void sysmon_hardware_note_nvs_commit(void);
+
+/**
+ * @brief Free the cached documents (called during sysmon_deinit, after the HTTP server is stopped).
+ */
+void sysmon_hardware_cleanup(void);
+
+#ifdef __cplusplus
+}
+#endif
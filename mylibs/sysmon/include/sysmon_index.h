@@ -0,0 +1,98 @@
+/**
+ * @file sysmon_index.h
+ * @brief Open-addressing hash index used by the task table and the stack registry.
+ *
+ * Maps a nonzero integer key (xTaskNumber, or a TaskHandle_t cast to uintptr_t) to a
+ * 32-bit value (a task table slot, or a stack size). Linear probing in a power-of-two
+ * table kept at most half full; removal uses backward shifting, so churn leaves no
+ * tombstones and lookups stay O(1) however long the device runs.
+ */
+
+#pragma once
+
+// ESP-IDF includes
+#include "esp_err.h"
+
+// System includes
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief One bucket. key == 0 marks an empty bucket.
+ */
+typedef struct
+{
+    uintptr_t key;
+    uint32_t value;
+} sysmon_index_entry_t;
+
+/**
+ * @brief Hash index state.
+ *
+ * Members:
+ * - entries : Bucket array, `mask + 1` entries (power of two).
+ * - mask    : Bucket count - 1.
+ * - count   : Keys stored.
+ */
+typedef struct
+{
+    sysmon_index_entry_t *entries;
+    uint32_t mask;
+    uint32_t count;
+} sysmon_index_t;
+
+/**
+ * @brief Allocate an empty index that holds at least `capacity` keys at half load.
+ *
+ * @return ESP_OK, or ESP_ERR_NO_MEM (the index is left empty).
+ */
+esp_err_t sysmon_index_init(sysmon_index_t *index, uint32_t capacity);
+
+/**
+ * @brief Release the buckets. The index can be initialized again afterwards.
+ */
+void sysmon_index_free(sysmon_index_t *index);
+
+/**
+ * @brief Insert every key of `from` into `to` (already initialized, large enough).
+ *
+ * Does not allocate or free, so it can run inside a critical section; the caller frees `from`.
+ */
+void sysmon_index_rehash(sysmon_index_t *to, const sysmon_index_t *from);
+
+/**
+ * @brief Look up a key.
+ *
+ * @return true and *value set if the key is present.
+ */
+bool sysmon_index_find(const sysmon_index_t *index, uintptr_t key, uint32_t *value);
+
+/**
+ * @brief Insert a key or overwrite its value.
+ *
+ * @return ESP_OK, ESP_ERR_INVALID_ARG for key 0, ESP_ERR_NO_MEM if the index is at half
+ *         load (grow it with sysmon_index_init + sysmon_index_rehash first).
+ */
+esp_err_t sysmon_index_put(sysmon_index_t *index, uintptr_t key, uint32_t value);
+
+/**
+ * @brief Remove a key if present.
+ */
+void sysmon_index_remove(sysmon_index_t *index, uintptr_t key);
+
+/**
+ * @brief True if one more key fits without going over half load.
+ */
+static inline bool sysmon_index_has_room(const sysmon_index_t *index)
+{
+    return index->entries != NULL && (index->count + 1) * 2 <= index->mask + 1;
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -29,13 +29,6 @@ cJSON *_create_tasks_json(void);
  */
 cJSON *_create_history_json(void);
 
-/**
- * @brief Create hardware information JSON object with static chip and system info.
- *
- * @return Hardware info JSON object, or NULL on allocation failure.
- */
-cJSON *_create_hardware_json(void);
-
 /**
  * @brief Build a complete telemetry JSON object summarizing CPU/memory and current registered task usage.
  *
@@ -0,0 +1,221 @@
+/**
+ * @file sysmon_push.h
+ * @brief Fan-out of sysmon samples to subscribed clients (Server-Sent Events frames).
+ *
+ * Instead of polling /telemetry and /tasks, a dashboard opens one /events connection and
+ * sysmon_monitor pushes every sample to it. A sample is encoded once, whatever the number of
+ * clients, into a reference-counted frame:
+ *
+ *   event: telemetry
+ *   id: 42
+ *   data: {"summary":{...},"current":{...}}
+ *
+ * and the frame is queued on every client. Each client has a bounded queue
+ * (CONFIG_SYSMON_PUSH_QUEUE_DEPTH frames): a client whose queue is full when a new frame is
+ * published is dropped, so the sampler never waits for a slow client and never buffers more
+ * than depth x clients frames.
+ *
+ * Two sides, each single-threaded:
+ *   - publisher (sysmon_monitor) : sysmon_push_encode(), sysmon_push_publish(). Never blocks.
+ *   - sender (HTTP server task)  : sysmon_push_attach(), _detach(), _pump(). Writes the
+ *                                  queued frames with the non-blocking send callback and
+ *                                  frees the slots of dropped or closed clients.
+ *
+ * The queues are single-producer/single-consumer rings. A slot that was dropped is freed by
+ * the sender only when no publish is running (the `publishing` flag), so the publisher never
+ * touches a slot that is being reused. This module needs only the compiler's __atomic
+ * builtins and malloc; it runs unchanged on Linux (host/bench_sysmon_push.c).
+ */
+
+#pragma once
+
+// Project-specific includes
+#include "sysmon_stream.h"
+
+// ESP-IDF includes
+#include "esp_err.h"
+
+// System includes
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Fallback defaults if Kconfig is not used
+#ifndef CONFIG_SYSMON_PUSH_MAX_CLIENTS
+#define CONFIG_SYSMON_PUSH_MAX_CLIENTS 2
+#endif
+
+#ifndef CONFIG_SYSMON_PUSH_QUEUE_DEPTH
+#define CONFIG_SYSMON_PUSH_QUEUE_DEPTH 8
+#endif
+
+#ifndef CONFIG_SYSMON_PUSH_TASKS_EVERY
+#define CONFIG_SYSMON_PUSH_TASKS_EVERY 10
+#endif
+
+/**
+ * @brief States of a client slot.
+ */
+typedef enum
+{
+    SYSMON_PUSH_FREE = 0,  // Unused
+    SYSMON_PUSH_ACTIVE,    // Receives frames
+    SYSMON_PUSH_CLOSING,   // Dropped or closed, freed by the next sysmon_push_pump()
+} sysmon_push_state_t;
+
+/**
+ * @brief One encoded event, shared by all the queues it is on.
+ *
+ * Members:
+ * - refs   : Queues holding the frame, plus the publisher until sysmon_push_publish() returns.
+ * - seq    : Event id (1, 2, ... per sysmon_push_t).
+ * - length : Bytes in data (no terminator).
+ */
+typedef struct
+{
+    uint32_t refs;
+    uint32_t seq;
+    size_t length;
+    char data[];
+} sysmon_push_frame_t;
+
+/**
+ * @brief Non-blocking write of len bytes to client fd.
+ *
+ * @return Bytes written (> 0), 0 if the socket would block, < 0 on error (the client is closed).
+ */
+typedef int (*sysmon_push_send_fn)(void *ctx, int fd, const char *data, size_t len);
+
+/**
+ * @brief Close client fd (called by the sender for dropped clients, never after sysmon_push_detach()).
+ */
+typedef void (*sysmon_push_close_fn)(void *ctx, int fd);
+
+/**
+ * @brief Document written into a frame (a sysmon_stream.h document function).
+ */
+typedef esp_err_t (*sysmon_push_doc_fn)(sysmon_stream_t *stream, const SysMonState *state,
+                                        const sysmon_stream_query_t *query);
+
+/**
+ * @brief One subscribed client.
+ *
+ * Members:
+ * - state      : sysmon_push_state_t, changed with atomics by both sides.
+ * - fd         : Client socket.
+ * - head       : Frames taken off the queue (sender).
+ * - tail       : Frames put on the queue (publisher).
+ * - offset     : Bytes of the frame at head already sent (partial writes).
+ * - detached   : The socket was closed by its owner (sysmon_push_detach()), do not close it again.
+ * - frames     : Frames sent completely.
+ * - bytes      : Bytes sent.
+ * - queue      : Ring of frame pointers, index = counter % CONFIG_SYSMON_PUSH_QUEUE_DEPTH.
+ */
+typedef struct
+{
+    uint32_t state;
+    int fd;
+    uint32_t head;
+    uint32_t tail;
+    size_t offset;
+    bool detached;
+    uint32_t frames;
+    uint64_t bytes;
+    sysmon_push_frame_t *queue[CONFIG_SYSMON_PUSH_QUEUE_DEPTH];
+} sysmon_push_client_t;
+
+/**
+ * @brief Fan-out state. Zero it and call sysmon_push_init().
+ *
+ * Members:
+ * - clients         : Client slots.
+ * - active          : Slots not FREE (attach increments, the sender's reclaim decrements).
+ * - publishing      : 1 while sysmon_push_publish() walks the slots.
+ * - seq             : Id of the last encoded frame (publisher).
+ * - dropped         : Clients dropped because their queue was full.
+ * - send / close    : Socket callbacks and their ctx.
+ * - scratch         : Encode buffer of the publisher, grown to the largest frame and kept.
+ * - scratch_length  : Bytes of the frame being encoded.
+ * - scratch_size    : Allocated size of scratch.
+ */
+typedef struct
+{
+    sysmon_push_client_t clients[CONFIG_SYSMON_PUSH_MAX_CLIENTS];
+    uint32_t active;
+    uint32_t publishing;
+    uint32_t seq;
+    uint32_t dropped;
+    sysmon_push_send_fn send;
+    sysmon_push_close_fn close;
+    void *ctx;
+    char *scratch;
+    size_t scratch_length;
+    size_t scratch_size;
+} sysmon_push_t;
+
+void sysmon_push_init(sysmon_push_t *push, sysmon_push_send_fn send, sysmon_push_close_fn close, void *ctx);
+
+/**
+ * @brief Free every queued frame and the scratch buffer, and close the clients not detached.
+ *
+ * Neither side may be running.
+ */
+void sysmon_push_shutdown(sysmon_push_t *push);
+
+/**
+ * @brief Encode `event` (one word) with the compact JSON document `doc` of `state` into a new frame.
+ *
+ * Publisher side. The returned frame holds one reference, handed over by sysmon_push_publish().
+ *
+ * @return The frame, or NULL when out of memory or the document failed.
+ */
+sysmon_push_frame_t *sysmon_push_encode(sysmon_push_t *push, const char *event, sysmon_push_doc_fn doc,
+                                        const SysMonState *state);
+
+/**
+ * @brief Queue `frame` on every active client and drop its reference.
+ *
+ * Publisher side, never blocks. A client whose queue is full is marked CLOSING (dropped).
+ */
+void sysmon_push_publish(sysmon_push_t *push, sysmon_push_frame_t *frame);
+
+/**
+ * @brief Drop one reference; the last one frees the frame.
+ */
+void sysmon_push_frame_release(sysmon_push_frame_t *frame);
+
+/**
+ * @brief True while a client is subscribed (the publisher skips encoding otherwise).
+ */
+bool sysmon_push_has_clients(const sysmon_push_t *push);
+
+/**
+ * @brief Subscribe socket fd. Sender side.
+ *
+ * @return Slot index, or -1 when all CONFIG_SYSMON_PUSH_MAX_CLIENTS slots are taken.
+ */
+int sysmon_push_attach(sysmon_push_t *push, int fd);
+
+/**
+ * @brief The socket fd was closed by its owner: free its slot without calling close. Sender side.
+ *
+ * @return true if fd was subscribed.
+ */
+bool sysmon_push_detach(sysmon_push_t *push, int fd);
+
+/**
+ * @brief Send the queued frames of every client and free the slots of closed clients. Sender side.
+ *
+ * Sends until a socket would block; the rest stays queued for the next call.
+ *
+ * @return Number of clients still active.
+ */
+int sysmon_push_pump(sysmon_push_t *push);
+
+#ifdef __cplusplus
+}
+#endif
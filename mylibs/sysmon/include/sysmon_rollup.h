@@ -0,0 +1,253 @@
+/**
+ * @file sysmon_rollup.h
+ * @brief Multi-resolution time series of the sysmon sampler (min/avg/max rollups).
+ *
+ * The raw history keeps CONFIG_SYSMON_SAMPLE_COUNT samples (one minute at the default
+ * interval). The rollup store keeps SYSMON_ROLLUP_TIERS rings of CONFIG_SYSMON_ROLLUP_BUCKETS
+ * buckets each; a bucket of tier t covers sysmon_rollup_t.tier[t].width samples:
+ *
+ *   tier 0 : 1 sample per bucket   (60 x 1 s  = 1 min at the defaults)
+ *   tier 1 : 10 samples per bucket (60 x 10 s = 10 min)
+ *   tier 2 : 60 samples per bucket (60 x 1 min = 1 h)
+ *
+ * Every tier accumulates the raw samples directly (sum/min/max), so avg is the exact rounded
+ * mean of the samples in the bucket, computed on insert without rescanning. Values are
+ * stored as uint16: percentages in hundredths (SYSMON_ROLLUP_PERCENT_SCALE), byte counts in
+ * KiB. A one-sample bucket stores one value (min == avg == max), wider buckets store three.
+ *
+ * All tiers share one allocation, placed in PSRAM when the board has it. Task columns use
+ * the slots of the task table; a slot that is given to a new task is cleared, like its
+ * history row, so a column never mixes two tasks.
+ */
+
+#pragma once
+
+// ESP-IDF includes
+#include "esp_err.h"
+
+// System includes
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Fallback defaults if Kconfig is not used
+#ifndef CONFIG_SYSMON_ROLLUP_BUCKETS
+#define CONFIG_SYSMON_ROLLUP_BUCKETS 60
+#endif
+
+#ifndef CONFIG_SYSMON_ROLLUP_TIER1_SAMPLES
+#define CONFIG_SYSMON_ROLLUP_TIER1_SAMPLES 10
+#endif
+
+#ifndef CONFIG_SYSMON_ROLLUP_TIER2_SAMPLES
+#define CONFIG_SYSMON_ROLLUP_TIER2_SAMPLES 60
+#endif
+
+#define SYSMON_ROLLUP_TIERS         3
+#define SYSMON_ROLLUP_PERCENT_SCALE 100     // Stored percent = round(percent * 100), 0..10000
+#define SYSMON_ROLLUP_VALUE_MAX     0xFFFF  // KiB values saturate here (64 MiB)
+
+/**
+ * @brief System series kept by the rollups.
+ */
+typedef enum
+{
+    SYSMON_ROLLUP_SYS_CPU = 0,          // Overall CPU, percent
+    SYSMON_ROLLUP_SYS_CPU_CORE0,        // Core 0 CPU, percent
+    SYSMON_ROLLUP_SYS_CPU_CORE1,        // Core 1 CPU, percent
+    SYSMON_ROLLUP_SYS_DRAM_USED,        // DRAM used, percent
+    SYSMON_ROLLUP_SYS_PSRAM_USED,       // PSRAM used, percent
+    SYSMON_ROLLUP_SYS_DRAM_FREE,        // DRAM free, KiB
+    SYSMON_ROLLUP_SYS_DRAM_MIN_FREE,    // DRAM minimum ever free, KiB
+    SYSMON_ROLLUP_SYS_DRAM_LARGEST,     // DRAM largest free block, KiB
+    SYSMON_ROLLUP_SYS_PSRAM_FREE,       // PSRAM free, KiB
+    SYSMON_ROLLUP_SYS_METRICS
+} sysmon_rollup_sys_metric_t;
+
+/**
+ * @brief Per-task series kept by the rollups.
+ */
+typedef enum
+{
+    SYSMON_ROLLUP_TASK_CPU = 0,  // CPU usage, percent
+    SYSMON_ROLLUP_TASK_STACK,    // Stack used, percent of the registered stack size
+    SYSMON_ROLLUP_TASK_METRICS
+} sysmon_rollup_task_metric_t;
+
+/**
+ * @brief Field of a stored bucket.
+ */
+typedef enum
+{
+    SYSMON_ROLLUP_MIN = 0,
+    SYSMON_ROLLUP_AVG,
+    SYSMON_ROLLUP_MAX,
+} sysmon_rollup_field_t;
+
+/**
+ * @brief Running sum/min/max of the open bucket of one series.
+ */
+typedef struct
+{
+    uint32_t sum;
+    uint16_t min;
+    uint16_t max;
+} sysmon_rollup_acc_t;
+
+/**
+ * @brief One ring of buckets.
+ *
+ * Members:
+ * - width       : Samples per bucket.
+ * - fields      : Values stored per series and bucket: 1 when width == 1, else 3 (min, avg, max).
+ * - write_index : Bucket written when the open bucket closes.
+ * - bucket_seq  : Buckets closed so far (the newest bucket is number bucket_seq).
+ * - pending     : Samples in the open bucket.
+ * - system      : CONFIG_SYSMON_ROLLUP_BUCKETS rows of SYSMON_ROLLUP_SYS_METRICS x fields values.
+ * - tasks       : CONFIG_SYSMON_ROLLUP_BUCKETS rows of capacity x SYSMON_ROLLUP_TASK_METRICS x fields values.
+ */
+typedef struct
+{
+    uint16_t width;
+    uint8_t fields;
+    int write_index;
+    uint32_t bucket_seq;
+    uint16_t pending;
+    uint16_t *system;
+    uint16_t *tasks;
+} sysmon_rollup_tier_t;
+
+/**
+ * @brief Rollup store (SysMonState.rollup).
+ *
+ * Members:
+ * - tier     : The rings, finest first.
+ * - capacity : Task columns per row (the task table capacity).
+ * - block    : The allocation holding the rows of every tier (PSRAM when available).
+ * - acc      : Accumulators of the open buckets, SYSMON_ROLLUP_TIERS x (SYSMON_ROLLUP_SYS_METRICS +
+ *              capacity x SYSMON_ROLLUP_TASK_METRICS). Used only by the sampler.
+ */
+typedef struct
+{
+    sysmon_rollup_tier_t tier[SYSMON_ROLLUP_TIERS];
+    int capacity;
+    uint16_t *block;
+    sysmon_rollup_acc_t *acc;
+} sysmon_rollup_t;
+
+/**
+ * @brief Encode a percentage (clamped to 0..100) in hundredths.
+ */
+static inline uint16_t sysmon_rollup_percent(float percent)
+{
+    if (!(percent > 0.0f))
+    {
+        return 0;
+    }
+    if (percent >= 100.0f)
+    {
+        return 100 * SYSMON_ROLLUP_PERCENT_SCALE;
+    }
+    return (uint16_t)(percent * (float)SYSMON_ROLLUP_PERCENT_SCALE + 0.5f);
+}
+
+/**
+ * @brief Encode a byte count in KiB (rounded down, saturating at SYSMON_ROLLUP_VALUE_MAX).
+ */
+static inline uint16_t sysmon_rollup_kib(uint32_t bytes)
+{
+    uint32_t kib = bytes / 1024U;
+    return (uint16_t)(kib > SYSMON_ROLLUP_VALUE_MAX ? SYSMON_ROLLUP_VALUE_MAX : kib);
+}
+
+/**
+ * @brief Position of (bucket, system metric, field) in tier->system.
+ */
+static inline size_t sysmon_rollup_sys_at(const sysmon_rollup_tier_t *tier, int bucket, int metric, int field)
+{
+    int f = (tier->fields == 1) ? 0 : field;
+    return ((size_t)bucket * SYSMON_ROLLUP_SYS_METRICS + (size_t)metric) * tier->fields + (size_t)f;
+}
+
+/**
+ * @brief Position of (bucket, task slot, task metric, field) in tier->tasks.
+ */
+static inline size_t sysmon_rollup_task_at(const sysmon_rollup_tier_t *tier, int capacity, int bucket, int slot, int metric, int field)
+{
+    int f = (tier->fields == 1) ? 0 : field;
+    return (((size_t)bucket * (size_t)capacity + (size_t)slot) * SYSMON_ROLLUP_TASK_METRICS + (size_t)metric) * tier->fields + (size_t)f;
+}
+
+/**
+ * @brief Ring index of the newest closed bucket of a tier.
+ */
+static inline int sysmon_rollup_newest(const sysmon_rollup_tier_t *tier)
+{
+    return (tier->write_index - 1 + CONFIG_SYSMON_ROLLUP_BUCKETS) % CONFIG_SYSMON_ROLLUP_BUCKETS;
+}
+
+/**
+ * @brief Bytes of tier rows (the PSRAM block) for `capacity` task slots.
+ */
+size_t sysmon_rollup_block_bytes(int capacity);
+
+/**
+ * @brief Bytes of writer-side accumulators for `capacity` task slots.
+ */
+size_t sysmon_rollup_acc_bytes(int capacity);
+
+/**
+ * @brief Set the tier widths (tier 0: 1 sample, then CONFIG_SYSMON_ROLLUP_TIER1/2_SAMPLES). Allocates nothing.
+ */
+void sysmon_rollup_init(sysmon_rollup_t *rollup);
+
+/**
+ * @brief Grow the store to `capacity` task columns, keeping every bucket and open accumulator.
+ *
+ * The new rows go to PSRAM when available. The accumulators are freed here; the old row
+ * block is returned in *old_block for the caller to free once no reader can hold it
+ * (sysmon_snapshot_retire()).
+ *
+ * @return ESP_OK (also when capacity <= rollup->capacity, *old_block = NULL) or
+ *         ESP_ERR_NO_MEM with the store unchanged.
+ */
+esp_err_t sysmon_rollup_resize(sysmon_rollup_t *rollup, int capacity, void **old_block);
+
+/**
+ * @brief Fold the system values of the current sample into the open bucket of every tier.
+ *
+ * @param system SYSMON_ROLLUP_SYS_METRICS encoded values.
+ */
+void sysmon_rollup_put_system(sysmon_rollup_t *rollup, const uint16_t *system);
+
+/**
+ * @brief Fold the values of one task slot into the open bucket of every tier.
+ *
+ * Every slot below rollup->capacity is put once per sample (0, 0 for a free slot), so all
+ * columns of a bucket cover the same samples.
+ */
+void sysmon_rollup_put_task(sysmon_rollup_t *rollup, int slot, uint16_t cpu, uint16_t stack);
+
+/**
+ * @brief End the current sample: every tier whose open bucket now holds `width` samples
+ *        writes min/avg/max to its ring and starts a new bucket.
+ */
+void sysmon_rollup_commit(sysmon_rollup_t *rollup);
+
+/**
+ * @brief Zero every bucket and open accumulator of a task slot (the slot now belongs to a new task).
+ */
+void sysmon_rollup_clear_slot(sysmon_rollup_t *rollup, int slot);
+
+/**
+ * @brief Free the rows and accumulators.
+ */
+void sysmon_rollup_free(sysmon_rollup_t *rollup);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,36 @@
+/**
+ * @file sysmon_sched.h
+ * @brief /sched document: per-task scheduling totals from the context switch trace.
+ *
+ * The totals come from task_trace_snapshot() (mylibs/task-trace-v001) and are cumulative since
+ * the trace started, like the run time counters: a client computes rates from the difference
+ * between two responses, matching tasks by handle and generation (a handle reused by a new task
+ * gets another generation). Reading them neither suspends the scheduler nor takes a sysmon
+ * snapshot.
+ */
+
+#pragma once
+
+// Project-specific includes
+#include "sysmon_stream.h"
+
+// ESP-IDF includes
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief The /sched document (stream endpoint, reads no snapshot: `state` and `query` are unused).
+ *
+ * {enabled, now, untracked, cores: [{elapsedUs, busyUs, unknownUs, switches, lost}],
+ *  tasks: [{name, handle, generation, core, runUs, switches, preemptions, wakeups,
+ *  latencySumUs, latencyMaxUs}]}. With the trace off (CONFIG_TASK_TRACE_ENABLE) only
+ * {enabled: false} is sent.
+ */
+esp_err_t sysmon_stream_sched(sysmon_stream_t *stream, const SysMonState *state, const sysmon_stream_query_t *query);
+
+#ifdef __cplusplus
+}
+#endif
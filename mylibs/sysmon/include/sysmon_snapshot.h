@@ -0,0 +1,97 @@
+/**
+ * @file sysmon_snapshot.h
+ * @brief Seqlock between the sysmon sampler (single writer) and the HTTP handlers (readers).
+ *
+ * sysmon_monitor wraps every change to `self` in sysmon_snapshot_write_begin()/_end(). Readers
+ * never read `self` while encoding a response: sysmon_snapshot_take() copies a consistent view
+ * (the system series, the task table and the newest history rows) into buffers owned by the
+ * reader, retrying if a sample was published during the copy. The sampler never waits for a
+ * reader, however slow the HTTP client is.
+ *
+ * Arrays replaced by a resize of the task table are retired instead of freed and released by
+ * the writer once no reader is copying, so a reader never touches freed memory.
+ */
+
+#pragma once
+
+// Project-specific includes
+#include "sysmon.h"
+
+// ESP-IDF includes
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Copy attempts before sysmon_snapshot_take() gives up (a sample is published every
+ *        CONFIG_SYSMON_CPU_SAMPLING_INTERVAL_MS, so a retry almost always succeeds).
+ */
+#define SYSMON_SNAPSHOT_MAX_ATTEMPTS 8
+
+/**
+ * @brief Start publishing a sample: readers that overlap this section retry.
+ *
+ * Called only from the sysmon_monitor task.
+ */
+void sysmon_snapshot_write_begin(void);
+
+/**
+ * @brief Publish the sample and free the retired arrays if no reader is copying.
+ */
+void sysmon_snapshot_write_end(void);
+
+/**
+ * @brief Free `ptr` once no reader can still be copying from it (writer side, inside a write section).
+ *
+ * @return true if `ptr` was retired or freed, false if the retire list is full
+ *         (the caller keeps the old array and tries again on a later sample).
+ */
+bool sysmon_snapshot_retire(void *ptr);
+
+/**
+ * @brief Number of arrays sysmon_snapshot_retire() can take right now.
+ */
+int sysmon_snapshot_retire_room(void);
+
+/**
+ * @brief Copy a consistent view of `self` into `view`.
+ *
+ * The view holds the system series, sample counters, the task table and the newest `rows`
+ * rows of the task history (1 for /tasks and /telemetry, the ?since= delta for /history).
+ * Only those rows are allocated; view->history_first_row maps them, so _history_at() and
+ * _newest_sample_index() work on the view as on `self`. Sampler-only members (httpd,
+ * task_status, task_index) and the rollup rows are cleared. Release the view with sysmon_snapshot_release().
+ *
+ * @param view Output view.
+ * @param rows History rows to copy, 0..CONFIG_SYSMON_SAMPLE_COUNT.
+ * @return ESP_OK, ESP_ERR_NO_MEM, or ESP_ERR_TIMEOUT after SYSMON_SNAPSHOT_MAX_ATTEMPTS attempts
+ *         that all overlapped a publication.
+ */
+esp_err_t sysmon_snapshot_take(SysMonState *view, int rows);
+
+/**
+ * @brief Copy a consistent view of `self` with the rows of one rollup tier (see sysmon_rollup.h).
+ *
+ * Like sysmon_snapshot_take(view, 1), plus view->rollup.tier[tier].system / .tasks in a
+ * reader buffer (PSRAM when available). The other tiers of the view have no rows.
+ *
+ * @param tier 0..SYSMON_ROLLUP_TIERS - 1.
+ * @return ESP_OK, ESP_ERR_INVALID_ARG, ESP_ERR_NO_MEM or ESP_ERR_TIMEOUT.
+ */
+esp_err_t sysmon_snapshot_take_rollup(SysMonState *view, int tier);
+
+/**
+ * @brief Free the buffers of a view filled by sysmon_snapshot_take() or sysmon_snapshot_take_rollup().
+ */
+void sysmon_snapshot_release(SysMonState *view);
+
+/**
+ * @brief Free every retired array. Only when no reader can run (sysmon_deinit, after the HTTP server stopped).
+ */
+void sysmon_snapshot_cleanup(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -4,6 +4,7 @@
 #include "freertos/FreeRTOS.h"
 
 // System includes
+#include <stdbool.h>
 #include <stdint.h>
 
 #ifdef __cplusplus
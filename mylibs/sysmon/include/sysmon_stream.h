@@ -0,0 +1,180 @@
+/**
+ * @file sysmon_stream.h
+ * @brief Streaming JSON/CBOR encoder for the sysmon HTTP endpoints.
+ *
+ * The encoder writes compact JSON (or CBOR, selected by the Accept header) into a
+ * small fixed buffer and hands every full buffer to a write callback, which on the
+ * device is httpd_resp_send_chunk(). No document tree is built and the encoder
+ * allocates nothing on the heap. The documents read a SysMonState view from
+ * sysmon_snapshot_take(), which holds only the history rows the response needs.
+ *
+ * The document functions (sysmon_stream_tasks/history/telemetry) emit the same
+ * fields as the legacy cJSON builders in sysmon_json.c, except that stack/memory
+ * percentages, which cJSON printed as raw floats (43.2199974060059), are rounded to
+ * 2 decimals. /history additionally
+ * supports a delta mode: with `?since=<seq>` only the samples taken after sample
+ * number `seq` are sent (see sysmon_stream_query_t). /rollup serves the min/avg/max
+ * tiers of sysmon_rollup.h, with the same delta mode counted in buckets.
+ */
+
+#pragma once
+
+// Project-specific includes
+#include "sysmon.h"
+
+// ESP-IDF includes
+#include "esp_err.h"
+
+// System includes
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SYSMON_STREAM_CHUNK_SIZE 512  // Bytes buffered before each write callback (lives on the caller's stack)
+#define SYSMON_STREAM_MAX_DEPTH  8    // Nesting of maps/arrays
+
+/**
+ * @brief Wire format of a stream.
+ */
+typedef enum
+{
+    SYSMON_STREAM_JSON = 0,  // application/json, compact (no whitespace)
+    SYSMON_STREAM_CBOR,      // application/cbor (RFC 8949), indefinite-length maps/arrays
+} sysmon_stream_format_t;
+
+/**
+ * @brief Sink for encoded bytes (httpd_resp_send_chunk on the device).
+ */
+typedef esp_err_t (*sysmon_stream_write_fn)(void *ctx, const char *data, size_t len);
+
+/**
+ * @brief Encoder state. Allocate it on the stack, initialize with sysmon_stream_init().
+ *
+ * Members:
+ * - format      : JSON or CBOR.
+ * - write / ctx : Sink called with each full chunk and from sysmon_stream_finish().
+ * - buffer      : Pending bytes not yet handed to the sink.
+ * - total_bytes : Bytes handed to the sink so far.
+ * - error       : First error returned by the sink; once set, all further output is dropped.
+ * - first       : Per nesting level, true until the first element is written (JSON commas).
+ * - after_key   : JSON only, the next value follows a "key": prefix.
+ */
+typedef struct
+{
+    sysmon_stream_format_t format;
+    sysmon_stream_write_fn write;
+    void *ctx;
+    char buffer[SYSMON_STREAM_CHUNK_SIZE];
+    size_t length;
+    size_t total_bytes;
+    esp_err_t error;
+    uint8_t depth;
+    bool first[SYSMON_STREAM_MAX_DEPTH];
+    bool after_key;
+} sysmon_stream_t;
+
+/**
+ * @brief Request parameters shared by the document functions.
+ *
+ * Members:
+ * - has_since : The client passed ?since=<seq>.
+ * - since     : Last sample number the client already has.
+ * - seq       : Sample number of the newest sample (filled by sysmon_stream_resolve_query).
+ * - samples   : History samples per series in this response (filled by sysmon_stream_resolve_query).
+ *               CONFIG_SYSMON_SAMPLE_COUNT means a full history: no ?since=, a client too far
+ *               behind, or a `since` from before a reboot (since > seq).
+ * - tier      : Rollup tier from ?tier= (/rollup only, default 0). For /rollup, seq counts the closed
+ *               buckets of that tier and samples is a number of buckets (CONFIG_SYSMON_ROLLUP_BUCKETS
+ *               when full).
+ */
+typedef struct
+{
+    bool has_since;
+    uint32_t since;
+    uint32_t seq;
+    uint32_t samples;
+    int tier;
+} sysmon_stream_query_t;
+
+void sysmon_stream_init(sysmon_stream_t *stream, sysmon_stream_format_t format,
+                        sysmon_stream_write_fn write, void *ctx);
+
+/**
+ * @brief Hand the buffered bytes to the sink.
+ *
+ * @return ESP_OK, or the first error returned by the sink.
+ */
+esp_err_t sysmon_stream_finish(sysmon_stream_t *stream);
+
+// Primitives. Inside a map, every value is preceded by sysmon_stream_key().
+void sysmon_stream_map_begin(sysmon_stream_t *stream);
+void sysmon_stream_map_end(sysmon_stream_t *stream);
+void sysmon_stream_array_begin(sysmon_stream_t *stream);
+void sysmon_stream_array_end(sysmon_stream_t *stream);
+void sysmon_stream_key(sysmon_stream_t *stream, const char *key);
+void sysmon_stream_string(sysmon_stream_t *stream, const char *value);
+void sysmon_stream_uint(sysmon_stream_t *stream, uint64_t value);
+void sysmon_stream_int(sysmon_stream_t *stream, int64_t value);
+void sysmon_stream_bool(sysmon_stream_t *stream, bool value);
+void sysmon_stream_null(sysmon_stream_t *stream);
+
+/**
+ * @brief Write value rounded to `decimals` (0..3) places, like round(value * 10^d) / 10^d.
+ *
+ * JSON gets the shortest decimal text ("12.5", "3", "-0.25"), CBOR an integer when the
+ * rounded value is whole and a float32 otherwise.
+ */
+void sysmon_stream_fixed(sysmon_stream_t *stream, float value, uint8_t decimals);
+
+/**
+ * @brief Splice pre-encoded key/value pairs into the open map.
+ *
+ * `data` holds the members of a map encoded earlier in the same format, without the
+ * map's own delimiters (JSON: `"a":1,"b":2`, CBOR: the bytes between 0xBF and 0xFF).
+ * Members written before or after it get their commas as usual.
+ */
+void sysmon_stream_members(sysmon_stream_t *stream, const char *data, size_t len);
+
+/**
+ * @brief Fill query->seq and query->samples from the sample counter of `state`.
+ */
+void sysmon_stream_resolve_query(sysmon_stream_query_t *query, const SysMonState *state);
+
+/**
+ * @brief Fill query->seq and query->samples from the bucket counter of rollup tier query->tier of `state`.
+ */
+void sysmon_stream_resolve_rollup_query(sysmon_stream_query_t *query, const SysMonState *state);
+
+/**
+ * @brief Same document as _create_tasks_json(): task name -> metadata.
+ */
+esp_err_t sysmon_stream_tasks(sysmon_stream_t *stream, const SysMonState *state, const sysmon_stream_query_t *query);
+
+/**
+ * @brief Same document as _create_history_json(), limited to the last query->samples samples.
+ */
+esp_err_t sysmon_stream_history(sysmon_stream_t *stream, const SysMonState *state, const sysmon_stream_query_t *query);
+
+/**
+ * @brief Same document as _create_telemetry_json(): {summary: {cpu, mem, wifiRssi}, current: {...}}.
+ */
+esp_err_t sysmon_stream_telemetry(sysmon_stream_t *stream, const SysMonState *state, const sysmon_stream_query_t *query);
+
+/**
+ * @brief The last query->samples buckets of rollup tier query->tier, oldest first.
+ *
+ * {tier, bucketMs, buckets, cpu: {overall, core0, core1}, mem: {dramUsedPct, psramUsedPct,
+ * dramFreeKb, dramMinFreeKb, dramLargestKb, psramFreeKb}, tasks: {name: {cpu, stackPct}}},
+ * where every series is {min: [...], avg: [...], max: [...]}. Percentages have 2 decimals;
+ * stackPct is sent only for tasks with a registered stack size. `state` comes from
+ * sysmon_snapshot_take_rollup().
+ */
+esp_err_t sysmon_stream_rollup(sysmon_stream_t *stream, const SysMonState *state, const sysmon_stream_query_t *query);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,62 @@
+/**
+ * @file sysmon_tasks.h
+ * @brief Task table of the sysmon sampler: slots, hash index, free list and history rows.
+ *
+ * Internal API used by sysmon_monitor. Tasks are identified by xTaskNumber (unique per
+ * created task) through SysMonState.task_index, so a sampling cycle costs one hash lookup
+ * per task instead of a name scan over the whole table.
+ */
+
+#pragma once
+
+// Project-specific includes
+#include "sysmon.h"
+
+// ESP-IDF includes
+#include "esp_err.h"
+#include "freertos/task.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Grow the task table, its history rows, its rollup columns and its index to `capacity` slots.
+ *
+ * Existing slots keep their index and history; the new slots are appended to the free list.
+ * Call inside sysmon_snapshot_write_begin()/_end(): the old arrays are handed to
+ * sysmon_snapshot_retire(), since an HTTP reader may still be copying them.
+ *
+ * @return ESP_OK (also when capacity <= task_capacity), ESP_ERR_NO_MEM, or ESP_ERR_NOT_FINISHED
+ *         while earlier arrays are still retired (try again on the next sample). The table is
+ *         unchanged on error.
+ */
+esp_err_t _tasks_resize(int capacity);
+
+/**
+ * @brief Record one sample for every task from a uxTaskGetSystemState() snapshot.
+ *
+ * Writes row SysMonState.series_write_index of the history. Known tasks are found through the
+ * hash index; new tasks take over the entry of a deleted task with the same name (a task that
+ * was deleted and created again keeps its history) or get a slot from the free list. Tasks
+ * missing from the snapshot record zeros and are released after CONFIG_SYSMON_SAMPLE_COUNT
+ * samples.
+ *
+ * A task whose run time was not sampled (sampled[i] false: missing from the context switch trace)
+ * records no CPU usage, and its next sampled counter only becomes the base for the delta after it.
+ *
+ * @param task_status Snapshot from uxTaskGetSystemState().
+ * @param sampled Per entry of task_status, whether ulRunTimeCounter was sampled; NULL = all were.
+ * @param count Number of entries in task_status.
+ * @param delta_total Total runtime delta since the previous sample.
+ */
+void _tasks_update(const TaskStatus_t *task_status, const bool *sampled, UBaseType_t count, uint32_t delta_total);
+
+/**
+ * @brief Free the task table, the history rows, the rollups and the index.
+ */
+void _tasks_free(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -3,8 +3,8 @@
  * @brief Utility functions for sysmon HTTP module.
  *
  * This header declares utility functions used across the sysmon HTTP
- * subsystem for content type detection, task name formatting, and JSON
- * cleanup operations.
+ * subsystem for task name formatting, JSON cleanup operations and WiFi
+ * information.
  */
 
 #pragma once
@@ -30,14 +30,6 @@ extern "C" {
  */
 const char *_get_task_display_name(const char *task_name);
 
-/**
- * @brief Determine content type from URI path.
- *
- * @param uri URI path string.
- * @return Content type string based on URI extension.
- */
-const char *_get_content_type_from_uri(const char *uri);
-
 /**
  * @brief Clean up multiple cJSON objects.
  *
@@ -27,9 +27,14 @@
 
 // Project-specific includes
 #include "sysmon.h"
+#include "sysmon_events.h"
+#include "sysmon_hardware.h"
 #include "sysmon_http.h"
+#include "sysmon_snapshot.h"
 #include "sysmon_stack.h"
+#include "sysmon_tasks.h"
 #include "sysmon_utils.h"
+#include "task_trace.h"
 
 // ESP-IDF includes
 #include "esp_log.h"
@@ -47,7 +52,16 @@ static const char *LOG_TAG = "sysmon";
 
 // Persistent module state (shared with sysmon_http.c)
 // Stores current task info, stats buffers, task handle, and ringbuffer pointers.
-SysMonState self = { 0 };
+SysMonState self = { .free_slot = -1 };
+
+// Copy of the context switch trace totals, refreshed every sample (sampler task only)
+static task_trace_task_t *s_trace_rows = NULL;
+static uint32_t s_trace_capacity = 0;
+// Per entry of self.task_status: found in the trace copy (false = not sampled this time)
+static bool *s_trace_sampled = NULL;
+static uint32_t s_trace_sampled_capacity = 0;
+// Run times of the previous sample came from the trace (microseconds), not from ulRunTimeCounter
+static bool s_run_time_traced = false;
 
 // ============================================================================
 // Monitor Task Helper Functions
@@ -71,14 +85,19 @@ static bool _ensure_task_storage_capacity(void)
         UBaseType_t num = uxTaskGetSystemState(self.task_status, self.task_capacity, &total_run_time);
         actual_task_count = (int)num;
         
-        // If we got fewer tasks than capacity, we have enough space
-        if (actual_task_count < self.task_capacity)
+        // If we got fewer tasks than capacity and a slot is free for a new one, we have enough space
+        if (actual_task_count < self.task_capacity && self.free_slot >= 0)
         {
             return true;
         }
         
-        // If we got exactly capacity, buffer was full - might have more tasks
-        buffer_was_full = (actual_task_count == self.task_capacity);
+        // If we got exactly capacity, buffer was full - might have more tasks.
+        // Same when every slot is taken: deleted tasks keep theirs for CONFIG_SYSMON_SAMPLE_COUNT samples.
+        buffer_was_full = true;
+        if (actual_task_count < self.task_capacity)
+        {
+            actual_task_count = self.task_capacity;
+        }
     }
     else
     {
@@ -108,38 +127,90 @@ static bool _ensure_task_storage_capacity(void)
         return true;
     }
     
-    TaskUsageSample *new_tasks = (TaskUsageSample *)calloc(required_capacity, sizeof(TaskUsageSample));
-    if (new_tasks == NULL)
+    TaskStatus_t *new_status = (TaskStatus_t *)malloc(sizeof(TaskStatus_t) * required_capacity);
+    if (new_status == NULL)
     {
         return false;
     }
     
-    TaskStatus_t *new_status = (TaskStatus_t *)malloc(sizeof(TaskStatus_t) * required_capacity);
-    if (new_status == NULL)
+    // Grow the task table (slots, history rows, index); existing slots keep their index
+    sysmon_snapshot_write_begin();
+    esp_err_t err = _tasks_resize(required_capacity);
+    sysmon_snapshot_write_end();
+    if (err != ESP_OK)
     {
-        free(new_tasks);
+        free(new_status);
         return false;
     }
     
-    // Copy existing active tasks
-    if (self.tasks != NULL)
+    // Ownership hand-off
+    free(self.task_status);
+    self.task_status = new_status;
+    
+    return true;
+}
+
+static int _trace_row_cmp(const void *a, const void *b)
+{
+    uint32_t x = ((const task_trace_task_t *)a)->task;
+    uint32_t y = ((const task_trace_task_t *)b)->task;
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief Replace the run time counters of a snapshot with the run times measured by the context switch trace.
+ *
+ * Both are microseconds, so _tasks_update() and _calculate_cpu_metrics() work unchanged, but the
+ * trace charges every switch at its exact time. The copy of the trace is sorted by handle once and
+ * every task is found by binary search. Tasks the trace has no row for are marked as not sampled in
+ * s_trace_sampled: _tasks_update() records no usage for them and does not use their counter as a base.
+ *
+ * @param task_status Snapshot from uxTaskGetSystemState().
+ * @param count Number of entries in task_status.
+ * @param total_run_time Output: time the trace is accounted up to.
+ * @return true if the counters were replaced, false if the trace rows could not be copied.
+ */
+static bool _apply_trace_run_times(TaskStatus_t *task_status, UBaseType_t count, uint32_t *total_run_time)
+{
+    if (count > s_trace_sampled_capacity)
     {
-        for (int j = 0; j < self.task_capacity; j++)
+        bool *grown = (bool *)realloc(s_trace_sampled, count * sizeof(bool));
+        if (grown == NULL)
         {
-            if (self.tasks[j].is_active)
-            {
-                new_tasks[j] = self.tasks[j];
-            }
+            return false;
         }
+        s_trace_sampled = grown;
+        s_trace_sampled_capacity = count;
     }
+
+    task_trace_summary_t summary;
+    uint32_t rows = task_trace_snapshot(s_trace_rows, s_trace_capacity, &summary);
+    if (summary.task_count > s_trace_capacity)
+    {
+        // More tasks than last time: grow the copy and take it again
+        uint32_t capacity = summary.task_count + 8;
+        task_trace_task_t *grown = (task_trace_task_t *)realloc(s_trace_rows, capacity * sizeof(task_trace_task_t));
+        if (grown == NULL)
+        {
+            return false;
+        }
+        s_trace_rows = grown;
+        s_trace_capacity = capacity;
+        rows = task_trace_snapshot(s_trace_rows, s_trace_capacity, &summary);
+    }
+    qsort(s_trace_rows, rows, sizeof(task_trace_task_t), _trace_row_cmp);
     
-    // Ownership hand-off
-    free(self.tasks);
-    free(self.task_status);
-    self.tasks         = new_tasks;
-    self.task_status   = new_status;
-    self.task_capacity = required_capacity;
-    
+    for (UBaseType_t i = 0; i < count; i++)
+    {
+        task_trace_task_t key = { .task = (uint32_t)(uintptr_t)task_status[i].xHandle };
+        const task_trace_task_t *row = bsearch(&key, s_trace_rows, rows, sizeof(task_trace_task_t), _trace_row_cmp);
+        s_trace_sampled[i] = row != NULL;
+        if (row != NULL)
+        {
+            task_status[i].ulRunTimeCounter = (uint32_t)row->run_us;
+        }
+    }
+    *total_run_time = summary.now;
     return true;
 }
 
@@ -147,10 +218,11 @@ static bool _ensure_task_storage_capacity(void)
  * @brief Sample current task states and calculate total runtime delta.
  * 
  * @param num_returned Output: number of tasks returned by uxTaskGetSystemState.
- * @param delta_total Output: calculated delta for total runtime.
+ * @param sampled Output: per task, whether its run time was sampled; NULL when all were (no trace).
+ * @param delta_total Output: calculated delta for total runtime, 0 when the run time source changed.
  * @return true on success, false if sampling failed.
  */
-static bool _sample_task_states(UBaseType_t *num_returned, uint32_t *delta_total)
+static bool _sample_task_states(UBaseType_t *num_returned, const bool **sampled, uint32_t *delta_total)
 {
     uint32_t total_run_time = 0;
     UBaseType_t num = uxTaskGetSystemState(self.task_status, self.task_capacity, &total_run_time);
@@ -162,6 +234,14 @@ static bool _sample_task_states(UBaseType_t *num_returned, uint32_t *delta_total
     
     *num_returned = num;
     
+    // CPU time from the context switch trace when it runs (task_trace_start() in sysmon_init)
+    bool traced = task_trace_is_running();
+    if (traced && !_apply_trace_run_times(self.task_status, num, &total_run_time))
+    {
+        return false;
+    }
+    *sampled = traced ? s_trace_sampled : NULL;
+    
     // Calculate delta_total, handling wrap-around
     if (total_run_time >= self.prev_total_run_time)
     {
@@ -175,135 +255,14 @@ static bool _sample_task_states(UBaseType_t *num_returned, uint32_t *delta_total
     
     self.prev_total_run_time = total_run_time;
     
-    return true;
-}
-
-/**
- * @brief Find or create task entry index for a given task name.
- * 
- * @param task_name Task name to find.
- * @return Task index on success, -1 if no slot available.
- */
-static int _find_or_create_task_index(const char *task_name)
-{
-    // Try to find existing task entry
-    for (int j = 0; j < self.task_capacity; j++)
-    {
-        if (self.tasks[j].is_active && 
-            strncmp(self.tasks[j].task_name, task_name, sizeof(self.tasks[j].task_name)) == 0)
-        {
-            return j;
-        }
-    }
-    
-    // Allocate slot for new task
-    for (int j = 0; j < self.task_capacity; j++)
-    {
-        if (!self.tasks[j].is_active)
-        {
-            memset(&self.tasks[j], 0, sizeof(TaskUsageSample));
-            strncpy(self.tasks[j].task_name, task_name, sizeof(self.tasks[j].task_name) - 1);
-            self.tasks[j].is_active = true;
-            self.tasks[j].consecutive_zero_samples = 0;
-            ESP_LOGI(LOG_TAG, "Discovered new task: '%s'", task_name);
-            return j;
-        }
-    }
-    
-    return -1;
-}
-
-/**
- * @brief Update task usage history for a single task.
- * 
- * @param idx Task index.
- * @param task_status Task status from uxTaskGetSystemState.
- * @param delta_total Total runtime delta for CPU calculation.
- */
-static void _update_task_history(int idx, const TaskStatus_t *task_status, uint32_t delta_total)
-{
-    // Compute delta runtime
-    uint32_t delta_task = 0;
-    if (task_status->ulRunTimeCounter >= self.tasks[idx].prev_run_time_ticks)
-    {
-        delta_task = task_status->ulRunTimeCounter - self.tasks[idx].prev_run_time_ticks;
-    }
-    self.tasks[idx].prev_run_time_ticks = task_status->ulRunTimeCounter;
-    
-    // Calculate CPU usage
-    float usage = (delta_total > 0) ? ((float)delta_task / (float)delta_total) * 100.0f : 0.0f;
-    self.tasks[idx].consecutive_zero_samples = 0;  // Task is present, reset counter
-    self.tasks[idx].usage_percent_history[self.tasks[idx].write_index] = usage;
-    
-    // Calculate stack usage
-    self.tasks[idx].stack_high_water_mark = task_status->usStackHighWaterMark;
-    uint32_t stack_hwm_bytes = task_status->usStackHighWaterMark * sizeof(StackType_t);
-    
-    // Lookup registered stack size
-    uint32_t stack_size_bytes = 0U;
-    sysmon_stack_get_size(task_status->xHandle, &stack_size_bytes);
-    
-    self.tasks[idx].stack_size_bytes = stack_size_bytes;
-    
-    uint32_t stack_used_bytes = 0U;
-    float stack_usage_percent = 0.0f;
-    if (stack_size_bytes > 0U)
+    // Ticks of ulRunTimeCounter and trace microseconds do not subtract: this sample only sets the base
+    if (traced != s_run_time_traced)
     {
-        if (stack_size_bytes > stack_hwm_bytes)
-        {
-            stack_used_bytes = stack_size_bytes - stack_hwm_bytes;
-        }
-        stack_usage_percent = ((float)stack_used_bytes / (float)stack_size_bytes) * 100.0f;
+        *delta_total = 0;
+        s_run_time_traced = traced;
     }
     
-    // Store stack usage history
-    self.tasks[idx].stack_usage_bytes_history[self.tasks[idx].write_index] = stack_used_bytes;
-    self.tasks[idx].stack_usage_percent_history[self.tasks[idx].write_index] = stack_usage_percent;
-    
-    // Update task metadata
-    self.tasks[idx].write_index = (self.tasks[idx].write_index + 1) % CONFIG_SYSMON_SAMPLE_COUNT;
-    self.tasks[idx].task_id = task_status->xTaskNumber;
-    self.tasks[idx].current_priority = task_status->uxCurrentPriority;
-    self.tasks[idx].base_priority = task_status->uxBasePriority;
-    self.tasks[idx].total_run_time_ticks = task_status->ulRunTimeCounter;
-    self.tasks[idx].core_id = task_status->xCoreID;
-}
-
-/**
- * @brief Process deleted tasks (not seen in current sample).
- * 
- * @param tasks_seen Array indicating which tasks were seen in current sample.
- */
-static void _process_deleted_tasks(const bool *tasks_seen)
-{
-    for (int j = 0; j < self.task_capacity; j++)
-    {
-        if (self.tasks[j].is_active && !tasks_seen[j])
-        {
-            self.tasks[j].consecutive_zero_samples++;
-            
-            // Record zero values
-            self.tasks[j].usage_percent_history[self.tasks[j].write_index] = 0.0f;
-            self.tasks[j].stack_usage_bytes_history[self.tasks[j].write_index] = 0U;
-            self.tasks[j].stack_usage_percent_history[self.tasks[j].write_index] = 0.0f;
-            self.tasks[j].write_index = (self.tasks[j].write_index + 1) % CONFIG_SYSMON_SAMPLE_COUNT;
-            
-            // Mark inactive after CONFIG_SYSMON_SAMPLE_COUNT consecutive zeros
-            if (self.tasks[j].consecutive_zero_samples >= CONFIG_SYSMON_SAMPLE_COUNT)
-            {
-                self.tasks[j].is_active = false;
-                self.tasks[j].consecutive_zero_samples = 0;
-                ESP_LOGI(LOG_TAG, "Task removed after %d consecutive zero samples: '%s'", 
-                         CONFIG_SYSMON_SAMPLE_COUNT, self.tasks[j].task_name);
-            }
-            else if (self.tasks[j].consecutive_zero_samples % 10 == 0)
-            {
-                ESP_LOGI(LOG_TAG, "Task not detected; logging zero for inactivity (sample %d of %d): '%s'", 
-                         self.tasks[j].consecutive_zero_samples, CONFIG_SYSMON_SAMPLE_COUNT, 
-                         self.tasks[j].task_name);
-            }
-        }
-    }
+    return true;
 }
 
 /**
@@ -428,6 +387,45 @@ static void _update_series_buffers(float overall_usage, float core_usage_0, floa
     self.psram_total[write_index] = psram_total;
     self.psram_used_percent[write_index] = psram_used_percent;
     self.series_write_index = (write_index + 1) % CONFIG_SYSMON_SAMPLE_COUNT;
+
+    // Every task history advanced by one sample in this cycle, so one counter covers all series
+    self.sample_seq++;
+}
+
+/**
+ * @brief Fold the newest sample (series and task history row) into the rollup tiers.
+ *
+ * Runs after _update_series_buffers() in the same write section; free slots add zeros so
+ * every column of a bucket covers the same samples.
+ */
+static void _update_rollups(void)
+{
+    int read_index = _newest_sample_index(&self);
+    uint16_t system[SYSMON_ROLLUP_SYS_METRICS];
+    system[SYSMON_ROLLUP_SYS_CPU] = sysmon_rollup_percent(self.cpu_overall_percent[read_index]);
+    system[SYSMON_ROLLUP_SYS_CPU_CORE0] = sysmon_rollup_percent(self.cpu_core_percent[0][read_index]);
+    system[SYSMON_ROLLUP_SYS_CPU_CORE1] = sysmon_rollup_percent(self.cpu_core_percent[1][read_index]);
+    system[SYSMON_ROLLUP_SYS_DRAM_USED] = sysmon_rollup_percent(self.dram_used_percent[read_index]);
+    system[SYSMON_ROLLUP_SYS_PSRAM_USED] = sysmon_rollup_percent(self.psram_used_percent[read_index]);
+    system[SYSMON_ROLLUP_SYS_DRAM_FREE] = sysmon_rollup_kib(self.dram_free[read_index]);
+    system[SYSMON_ROLLUP_SYS_DRAM_MIN_FREE] = sysmon_rollup_kib(self.dram_min_free[read_index]);
+    system[SYSMON_ROLLUP_SYS_DRAM_LARGEST] = sysmon_rollup_kib(self.dram_largest_block[read_index]);
+    system[SYSMON_ROLLUP_SYS_PSRAM_FREE] = sysmon_rollup_kib(self.psram_free[read_index]);
+    sysmon_rollup_put_system(&self.rollup, system);
+
+    for (int slot = 0; slot < self.rollup.capacity; slot++)
+    {
+        uint16_t cpu = 0;
+        uint16_t stack = 0;
+        if (slot < self.task_capacity && self.tasks[slot].is_active)
+        {
+            size_t at = _history_at(&self, read_index, slot);
+            cpu = sysmon_rollup_percent(self.history.usage_percent[at]);
+            stack = sysmon_rollup_percent(self.history.stack_usage_percent[at]);
+        }
+        sysmon_rollup_put_task(&self.rollup, slot, cpu, stack);
+    }
+    sysmon_rollup_commit(&self.rollup);
 }
 
 /**
@@ -436,11 +434,13 @@ static void _update_series_buffers(float overall_usage, float core_usage_0, floa
  * This function is executed as a pinned FreeRTOS task and performs the following loop:
  *   1. Allocates and right-sizes memory to track all active tasks if the count grows.
  *   2. Samples all tasks' runtime counters and global total counters using uxTaskGetSystemState().
- *   3. Updates or creates per-task usage history entries, calculating deltas and utilization percent.
+ *   3. Updates or creates per-task usage history entries (hash lookup by xTaskNumber), calculating deltas and utilization percent.
  *   4. Identifies idle tasks per core, computes per-core idle, and derives CPU workload metrics.
  *   5. Collects DRAM and PSRAM heap statistics for memory diagnostics.
- *   6. Records all observations into cyclic ringbuffers for overview and UI reporting.
- *   7. Sleeps for a configured interval before next sample.
+ *   6. Records all observations into cyclic ringbuffers for overview and UI reporting, and folds them
+ *      into the min/avg/max rollup tiers.
+ *   7. Pushes the sample to the /events subscribers, if any.
+ *   8. Sleeps for a configured interval before next sample.
  * Loop continues until task is deleted by external shutdown.
  *
  * Thread-unsafe: This runs as a single RTOS sampler and should not be invoked directly.
@@ -466,8 +466,9 @@ static void sysmon_monitor(void *param)
         
         // 2. Sample task states
         UBaseType_t num_returned = 0;
+        const bool *sampled = NULL;
         uint32_t delta_total = 0;
-        if (!_sample_task_states(&num_returned, &delta_total))
+        if (!_sample_task_states(&num_returned, &sampled, &delta_total))
         {
             vTaskDelay(pdMS_TO_TICKS(CONFIG_SYSMON_CPU_SAMPLING_INTERVAL_MS));
             continue;
@@ -479,44 +480,11 @@ static void sysmon_monitor(void *param)
             ESP_LOGI(LOG_TAG, "Sampling %u tasks", num_returned);
         }
         
-        // Track which tasks were seen
-        bool *tasks_seen = (bool *)calloc(self.task_capacity, sizeof(bool));
-        if (tasks_seen == NULL)
-        {
-            vTaskDelay(pdMS_TO_TICKS(CONFIG_SYSMON_CPU_SAMPLING_INTERVAL_MS));
-            continue;
-        }
-        
-        // 3. Update per-task histories
-        for (UBaseType_t i = 0; i < num_returned; i++)
-        {
-            TaskStatus_t *t = &self.task_status[i];
-            if (t->pcTaskName == NULL)
-            {
-                continue;
-            }
-            
-            int idx = _find_or_create_task_index(t->pcTaskName);
-            if (idx == -1)
-            {
-                ESP_LOGW(LOG_TAG, "Task capacity exceeded, cannot track task '%s' (capacity: %d, num_tasks: %d). Will retry next sample.", 
-                         t->pcTaskName, self.task_capacity, uxTaskGetNumberOfTasks());
-                continue;
-            }
-            
-            _update_task_history(idx, t, delta_total);
-            tasks_seen[idx] = true;
-        }
-        
-        // 4. Process deleted tasks
-        _process_deleted_tasks(tasks_seen);
-        free(tasks_seen);
-        
-        // 5. Calculate CPU metrics
+        // 3. Calculate CPU metrics
         float core_usage_0, core_usage_1, overall_usage;
         _calculate_cpu_metrics(num_returned, delta_total, &core_usage_0, &core_usage_1, &overall_usage);
         
-        // 6. Collect memory statistics
+        // 4. Collect memory statistics
         uint32_t dram_free, dram_min_free, dram_largest, dram_total;
         float dram_used_percent;
         uint32_t psram_free, psram_total;
@@ -524,10 +492,18 @@ static void sysmon_monitor(void *param)
         _collect_memory_stats(&dram_free, &dram_min_free, &dram_largest, &dram_total, &dram_used_percent,
                               &psram_free, &psram_total, &psram_used_percent);
         
-        // 7. Update series buffers
+        // 5. Update per-task histories and process deleted tasks, 6. update series buffers and rollups.
+        //    Published as one sample: HTTP readers copy either the previous sample or this one.
+        sysmon_snapshot_write_begin();
+        _tasks_update(self.task_status, sampled, num_returned, delta_total);
         _update_series_buffers(overall_usage, core_usage_0, core_usage_1,
                                dram_free, dram_min_free, dram_largest, dram_total, dram_used_percent,
                                psram_free, psram_total, psram_used_percent);
+        _update_rollups();
+        sysmon_snapshot_write_end();
+        
+        // 7. Push the sample to the /events subscribers (encoded once for all of them)
+        sysmon_events_publish();
         
         // 8. Delay before next sample
         vTaskDelay(pdMS_TO_TICKS(CONFIG_SYSMON_CPU_SAMPLING_INTERVAL_MS));
@@ -557,15 +533,24 @@ void sysmon_deinit(void)
         self.monitor_task_handle = NULL;
     }
     // Free task metric storage buffers
-    free(self.tasks);
-    self.tasks = NULL;
+    _tasks_free();
     free(self.task_status);
     self.task_status          = NULL;
     self.task_capacity        = 0;
     self.prev_total_run_time  = 0;
+    free(s_trace_rows);
+    s_trace_rows              = NULL;
+    s_trace_capacity          = 0;
+    free(s_trace_sampled);
+    s_trace_sampled           = NULL;
+    s_trace_sampled_capacity  = 0;
+    s_run_time_traced         = false;
     
-    // Clean up stack records
+    // Clean up stack records and arrays retired by the snapshot seqlock
     sysmon_stack_cleanup();
+    sysmon_snapshot_cleanup();
+    sysmon_events_cleanup();
+    sysmon_hardware_cleanup();
 }
 
 
@@ -581,7 +566,7 @@ void sysmon_deinit(void)
  * Step-by-step operation:
  *  1. Verify WiFi connectivity (required for HTTP server).
  *  2. Start HTTP API handler for telemetry endpoints.
- *  3. If not already running, create task monitor (CPU+memory) pinned to core 0.
+ *  3. If not already running, start the context switch trace and create task monitor (CPU+memory) pinned to core 0.
  *  4. Report initialization status via log and return result.
  */
 esp_err_t sysmon_init(void)
@@ -607,6 +592,14 @@ esp_err_t sysmon_init(void)
     // 3. Only start monitor if not running (singleton pattern)
     if (self.monitor_task_handle == NULL)
     {
+        // Per-task CPU from the context switch trace; without it, from the run time counters
+        esp_err_t trace_err = task_trace_start();
+        if (trace_err != ESP_OK && trace_err != ESP_ERR_NOT_SUPPORTED)
+        {
+            ESP_LOGW(LOG_TAG, "task_trace_start() failed: %s, CPU usage from run time counters", esp_err_to_name(trace_err));
+        }
+        
+
         BaseType_t result = xTaskCreatePinnedToCore(
             sysmon_monitor,
             "sysmon_monitor",
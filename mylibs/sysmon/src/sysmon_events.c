@@ -0,0 +1,173 @@
+/**
+ * @file sysmon_events.c
+ * @brief /events endpoint: sysmon samples pushed to the dashboard as Server-Sent Events.
+ *
+ * The handler answers GET /events with the SSE response header, written directly on the
+ * socket, and subscribes the socket to the fan-out (sysmon_push.c); the connection then stays
+ * open and httpd leaves it alone until the browser closes it. All sends happen on the HTTP
+ * server task (httpd_queue_work), non-blocking (MSG_DONTWAIT): a frame the socket cannot
+ * take stays queued for the next sample, and a client that falls
+ * CONFIG_SYSMON_PUSH_QUEUE_DEPTH samples behind is closed. EventSource reconnects by itself.
+ *
+ * When all CONFIG_SYSMON_PUSH_MAX_CLIENTS slots are taken the handler answers 503 and the
+ * dashboard falls back to polling /telemetry and /tasks.
+ */
+
+// Project-specific includes
+#include "sysmon_events.h"
+#include "sysmon_push.h"
+#include "sysmon_stream.h"
+#include "sysmon.h"
+
+// ESP-IDF includes
+#include "esp_log.h"
+#include "esp_http_server.h"
+
+// System includes
+#include <stdbool.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+// Logger tag for this module
+static const char *LOG_TAG = "sysmon_events";
+
+// Response header plus the EventSource reconnect delay (ms)
+static const char SSE_RESPONSE_HEADER[] =
+    "HTTP/1.1 200 OK\r\n"
+    "Content-Type: text/event-stream\r\n"
+    "Cache-Control: no-cache\r\n"
+    "Connection: keep-alive\r\n"
+    "Access-Control-Allow-Origin: *\r\n"
+    "\r\n"
+    "retry: 3000\n\n";
+
+static sysmon_push_t s_push;
+static bool s_push_ready = false;    // s_push initialized (HTTP server task)
+static uint32_t s_published = 0;     // Samples pushed (sysmon_monitor task)
+
+// ============================================================================
+// Internal Helper Functions
+// ============================================================================
+
+/**
+ * @brief sysmon_push send callback: non-blocking write on the HTTP server task.
+ */
+static int _events_send(void *ctx, int fd, const char *data, size_t len)
+{
+    (void)ctx;
+    httpd_handle_t server = self.httpd;
+    if (server == NULL)
+    {
+        return -1;
+    }
+    int sent = httpd_socket_send(server, fd, data, len, MSG_DONTWAIT);
+    if (sent == HTTPD_SOCK_ERR_TIMEOUT)
+    {
+        return 0;
+    }
+    return (sent < 0) ? -1 : sent;
+}
+
+/**
+ * @brief sysmon_push close callback for dropped clients: httpd closes the session (and calls
+ *        sysmon_events_close_fn, which finds the slot already free).
+ */
+static void _events_close(void *ctx, int fd)
+{
+    (void)ctx;
+    httpd_handle_t server = self.httpd;
+    ESP_LOGI(LOG_TAG, "client %d dropped", fd);
+    if (server != NULL)
+    {
+        httpd_sess_trigger_close(server, fd);
+    }
+}
+
+/**
+ * @brief Work item run on the HTTP server task after every publish.
+ */
+static void _events_pump_work(void *arg)
+{
+    (void)arg;
+    sysmon_push_pump(&s_push);
+}
+
+// ============================================================================
+// Public API Functions
+// ============================================================================
+
+/**
+ * @brief Handler function for /events (internal use only).
+ *
+ * @param request HTTP request object.
+ * @return ESP_OK when the client is subscribed or refused with 503, ESP_FAIL if the header could not be sent.
+ */
+esp_err_t http_handle_events(httpd_req_t *request)
+{
+    if (!s_push_ready)
+    {
+        sysmon_push_init(&s_push, _events_send, _events_close, NULL);
+        s_push_ready = true;
+    }
+
+    int fd = httpd_req_to_sockfd(request);
+    if (fd < 0 || sysmon_push_attach(&s_push, fd) < 0)
+    {
+        ESP_LOGW(LOG_TAG, "no free event slot (%d max), client falls back to polling", CONFIG_SYSMON_PUSH_MAX_CLIENTS);
+        httpd_resp_set_status(request, "503 Service Unavailable");
+        httpd_resp_set_hdr(request, "Access-Control-Allow-Origin", "*");
+        return httpd_resp_send(request, NULL, 0);
+    }
+
+    // The header goes out as is, before any frame: the HTTP server task is the only sender
+    int sent = httpd_socket_send(request->handle, fd, SSE_RESPONSE_HEADER, sizeof(SSE_RESPONSE_HEADER) - 1, 0);
+    if (sent != (int)(sizeof(SSE_RESPONSE_HEADER) - 1))
+    {
+        ESP_LOGE(LOG_TAG, "client %d: SSE header not sent (%d)", fd, sent);
+        sysmon_push_detach(&s_push, fd);
+        return ESP_FAIL;
+    }
+    ESP_LOGI(LOG_TAG, "client %d subscribed", fd);
+    return ESP_OK;
+}
+
+void sysmon_events_publish(void)
+{
+    httpd_handle_t server = self.httpd;
+    if (server == NULL || !sysmon_push_has_clients(&s_push))
+    {
+        return;
+    }
+
+    // `self` is read directly: this runs on the sampler, the only writer
+    sysmon_push_publish(&s_push, sysmon_push_encode(&s_push, "telemetry", sysmon_stream_telemetry, &self));
+    if (s_published++ % CONFIG_SYSMON_PUSH_TASKS_EVERY == 0)
+    {
+        sysmon_push_publish(&s_push, sysmon_push_encode(&s_push, "tasks", sysmon_stream_tasks, &self));
+    }
+
+    if (httpd_queue_work(server, _events_pump_work, NULL) != ESP_OK)
+    {
+        ESP_LOGW(LOG_TAG, "httpd_queue_work() failed, events wait for the next sample");
+    }
+}
+
+void sysmon_events_close_fn(httpd_handle_t hd, int sockfd)
+{
+    (void)hd;
+    if (s_push_ready && sysmon_push_detach(&s_push, sockfd))
+    {
+        ESP_LOGI(LOG_TAG, "client %d closed", sockfd);
+    }
+    close(sockfd);
+}
+
+void sysmon_events_cleanup(void)
+{
+    if (s_push_ready)
+    {
+        sysmon_push_shutdown(&s_push);
+        s_push_ready = false;
+    }
+    s_published = 0;
+}
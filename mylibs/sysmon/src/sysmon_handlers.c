@@ -2,22 +2,23 @@
  * @file sysmon_handlers.c
  * @brief HTTP request handlers for sysmon HTTP server.
  *
- * This file implements HTTP request handlers for serving static files and
- * JSON endpoints in the sysmon HTTP server.
+ * This file implements the HTTP request handler for the streamed endpoints
+ * in the sysmon HTTP server. Static files are served by sysmon_www.c.
  */
 
 // Project-specific includes
 #include "sysmon_config.h"
-#include "sysmon_json.h"
-#include "sysmon_utils.h"
+#include "sysmon_snapshot.h"
+#include "sysmon_stream.h"
 #include "sysmon.h"
 
 // ESP-IDF includes
 #include "esp_log.h"
 #include "esp_http_server.h"
-#include "cJSON.h"
 
 // System includes
+#include <inttypes.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -25,99 +26,192 @@
 static const char *LOG_TAG = "sysmon_handlers";
 
 /**
- * @brief Handler function for static files (internal use only).
- *
- * @param request HTTP request object.
- * @return ESP_OK on success, error code otherwise.
+ * @brief Stream sink: every full encoder buffer becomes one HTTP chunk.
+ */
+static esp_err_t _stream_send_chunk(void *ctx, const char *data, size_t len)
+{
+    return httpd_resp_send_chunk((httpd_req_t *)ctx, data, (ssize_t)len);
+}
+
+/**
+ * @brief CBOR when the client lists application/cbor in Accept, compact JSON otherwise.
  */
-esp_err_t http_handle_static_file(httpd_req_t *request)
+static sysmon_stream_format_t _stream_format_from_accept(httpd_req_t *request)
 {
-    // Get config from user_ctx
-    const static_file_config_t *config = (const static_file_config_t *)request->user_ctx;
-    if (config == NULL)
+    char accept[96] = { 0 };
+    esp_err_t err = httpd_req_get_hdr_value_str(request, "Accept", accept, sizeof(accept));
+    if ((err == ESP_OK || err == ESP_ERR_HTTPD_RESULT_TRUNC) && strstr(accept, "application/cbor") != NULL)
     {
-        ESP_LOGE(LOG_TAG, "Static file config is NULL");
-        return httpd_resp_send_500(request);
+        return SYSMON_STREAM_CBOR;
     }
+    return SYSMON_STREAM_JSON;
+}
 
-    const uint8_t *start = config->start;
-    const uint8_t *end = config->end;
-    size_t len = (size_t)(end - start);
+/**
+ * @brief Parse ?since=<seq> and ?tier=<n> (decimal). A malformed since yields a full document,
+ *        a malformed tier an invalid one (-1, rejected by the rollup handler).
+ */
+static void _stream_parse_query(httpd_req_t *request, sysmon_stream_query_t *query)
+{
+    char query_str[48] = { 0 };
+    char value[12] = { 0 };
+    if (httpd_req_get_url_query_str(request, query_str, sizeof(query_str)) != ESP_OK)
+    {
+        return;
+    }
+    char *end = NULL;
+    if (httpd_query_key_value(query_str, "since", value, sizeof(value)) == ESP_OK)
+    {
+        unsigned long since = strtoul(value, &end, 10);
+        if (end != value && *end == '\0')
+        {
+            query->has_since = true;
+            query->since = (uint32_t)since;
+        }
+    }
+    if (httpd_query_key_value(query_str, "tier", value, sizeof(value)) == ESP_OK)
+    {
+        unsigned long tier = strtoul(value, &end, 10);
+        query->tier = (end != value && *end == '\0' && tier < SYSMON_ROLLUP_TIERS) ? (int)tier : -1;
+    }
+}
 
-    // Always exclude null terminator from TEXT mode embeddings
-    if (len > 0)
+/**
+ * @brief History rows to copy for a request: the ?since= delta plus one spare sample, or config->history_rows.
+ *
+ * self.sample_seq is read without the seqlock, as a hint; the handler checks the result against the snapshot.
+ */
+static int _stream_history_rows(const stream_handler_config_t *config, const sysmon_stream_query_t *query)
+{
+    if (config->history_rows <= 1 || !query->has_since)
+    {
+        return config->history_rows;
+    }
+    uint32_t seq = __atomic_load_n(&self.sample_seq, __ATOMIC_RELAXED);
+    if (query->since > seq || (seq - query->since) >= (uint32_t)config->history_rows - 1U)
     {
-        len--;
+        return config->history_rows;
     }
+    return (int)(seq - query->since) + 1;
+}
 
-    // Symbol and length checks to prevent runtime failure.
-    if (start == NULL || end == NULL || len == 0)
+/**
+ * @brief Take the snapshot a streamed document reads and resolve the query against it.
+ */
+static esp_err_t _stream_take_snapshot(const stream_handler_config_t *config, sysmon_stream_query_t *query, SysMonState *view)
+{
+    if (config->history_rows == 0)
     {
-        ESP_LOGE(LOG_TAG, "embedded symbols not found for %s", config->uri);
-        return httpd_resp_send_500(request);
+        memset(view, 0, sizeof(*view));
+        return ESP_OK;
+    }
+    if (config->rollup)
+    {
+        esp_err_t err = sysmon_snapshot_take_rollup(view, query->tier);
+        if (err == ESP_OK)
+        {
+            sysmon_stream_resolve_rollup_query(query, view);
+        }
+        return err;
     }
 
-    const char *content_type = _get_content_type_from_uri(config->uri);
-    httpd_resp_set_type(request, content_type);
-    
-    // Add CORS headers to allow cross-origin requests from other machines
-    httpd_resp_set_hdr(request, "Access-Control-Allow-Origin", "*");
-    httpd_resp_set_hdr(request, "Access-Control-Allow-Methods", "GET, OPTIONS");
-    httpd_resp_set_hdr(request, "Access-Control-Allow-Headers", "Content-Type");
-    
-    return httpd_resp_send(request, (const char *)start, (ssize_t)len);
+    int rows = _stream_history_rows(config, query);
+    esp_err_t err = sysmon_snapshot_take(view, rows);
+    if (err != ESP_OK)
+    {
+        return err;
+    }
+    sysmon_stream_resolve_query(query, view);
+    if (rows < config->history_rows && query->samples > (uint32_t)rows)
+    {
+        // More samples were published since the hint: copy the whole history
+        sysmon_snapshot_release(view);
+        err = sysmon_snapshot_take(view, config->history_rows);
+        if (err == ESP_OK)
+        {
+            sysmon_stream_resolve_query(query, view);
+        }
+    }
+    return err;
 }
 
 /**
- * @brief Handler function for JSON endpoints (internal use only).
+ * @brief Handler function for streamed JSON/CBOR endpoints (internal use only).
+ *
+ * The document is encoded from a snapshot (sysmon_snapshot_take() or _take_rollup()), so a slow client never holds
+ * up the sampler and never gets a response that mixes two samples.
+ *
+ * Headers:
+ *   - X-Sysmon-Seq     : sequence number of the newest sample, pass it back as ?since=
+ *   - X-Sysmon-Samples : history samples per series in this response
+ *                        (CONFIG_SYSMON_SAMPLE_COUNT = full history, the client replaces instead of appending)
+ *   For /rollup both count buckets of the requested tier (CONFIG_SYSMON_ROLLUP_BUCKETS = full tier);
+ *   an invalid ?tier= gets 400. Documents that read no samples (history_rows 0, e.g. /hardware) send neither.
  *
  * @param request HTTP request object.
- * @return ESP_OK on success, HTTP 500 on JSON build failure.
+ * @return ESP_OK on success, error from httpd_resp_send_chunk() otherwise.
  */
-esp_err_t http_handle_json_endpoint(httpd_req_t *request)
+esp_err_t http_handle_stream_endpoint(httpd_req_t *request)
 {
-    // Get config from user_ctx
-    const json_handler_config_t *config = (const json_handler_config_t *)request->user_ctx;
-    if (config == NULL || config->create_json == NULL)
+    const stream_handler_config_t *config = (const stream_handler_config_t *)request->user_ctx;
+    if (config == NULL || config->stream_document == NULL)
     {
-        ESP_LOGE(LOG_TAG, "JSON handler config is NULL");
+        ESP_LOGE(LOG_TAG, "Stream handler config is NULL");
         return httpd_resp_send_500(request);
     }
 
-    cJSON *json_root = config->create_json();
-    if (json_root == NULL)
+    sysmon_stream_query_t query = { 0 };
+    _stream_parse_query(request, &query);
+
+    SysMonState view;
+    esp_err_t err = _stream_take_snapshot(config, &query, &view);
+    if (err == ESP_ERR_INVALID_ARG)
     {
-        ESP_LOGE(LOG_TAG, "Failed to create JSON for %s", config->uri);
-        return httpd_resp_send_500(request);
+        return httpd_resp_send_err(request, HTTPD_400_BAD_REQUEST, "tier must be 0, 1 or 2");
     }
-
-    // Serialize JSON to string
-    char *json_string = cJSON_Print(json_root);
-    if (json_string == NULL)
+    if (err != ESP_OK)
     {
-        ESP_LOGE(LOG_TAG, "Failed to serialize JSON for %s", config->uri);
-        JSON_CLEANUP(json_root);
+        ESP_LOGE(LOG_TAG, "%s: no snapshot: %s (0x%x)", config->uri, esp_err_to_name(err), err);
         return httpd_resp_send_500(request);
     }
 
-    // Send JSON response
-    httpd_resp_set_type(request, "application/json; charset=utf-8");
-    
-    // Add CORS headers to allow cross-origin requests from other machines
+    // httpd keeps the header pointers until the first chunk goes out
+    char seq_str[12];
+    char samples_str[12];
+    snprintf(seq_str, sizeof(seq_str), "%" PRIu32, query.seq);
+    snprintf(samples_str, sizeof(samples_str), "%" PRIu32, query.samples);
+
+    sysmon_stream_t stream;
+    sysmon_stream_init(&stream, _stream_format_from_accept(request), _stream_send_chunk, request);
+
+    httpd_resp_set_type(request, stream.format == SYSMON_STREAM_CBOR ? "application/cbor" : "application/json; charset=utf-8");
     httpd_resp_set_hdr(request, "Access-Control-Allow-Origin", "*");
     httpd_resp_set_hdr(request, "Access-Control-Allow-Methods", "GET, OPTIONS");
     httpd_resp_set_hdr(request, "Access-Control-Allow-Headers", "Content-Type");
-    
-    esp_err_t result = httpd_resp_send(request, json_string, HTTPD_RESP_USE_STRLEN);
-    if (result != ESP_OK)
+    httpd_resp_set_hdr(request, "Access-Control-Expose-Headers", "X-Sysmon-Seq, X-Sysmon-Samples");
+    httpd_resp_set_hdr(request, "Vary", "Accept");
+    if (config->history_rows > 0)
     {
-        ESP_LOGE(LOG_TAG, "httpd_resp_send() failed for %s: %s (0x%x)", 
-                 config->uri, esp_err_to_name(result), result);
+        httpd_resp_set_hdr(request, "X-Sysmon-Seq", seq_str);
+        httpd_resp_set_hdr(request, "X-Sysmon-Samples", samples_str);
     }
 
-    // Cleanup
-    free(json_string);
-    cJSON_Delete(json_root);
+    config->stream_document(&stream, &view, &query);
+    esp_err_t result = sysmon_stream_finish(&stream);
+    sysmon_snapshot_release(&view);
+    if (result == ESP_OK)
+    {
+        result = httpd_resp_send_chunk(request, NULL, 0);  // terminating chunk
+    }
+    if (result != ESP_OK)
+    {
+        ESP_LOGE(LOG_TAG, "streaming %s failed after %u bytes: %s (0x%x)",
+                 config->uri, (unsigned)stream.total_bytes, esp_err_to_name(result), result);
+    }
+    else
+    {
+        ESP_LOGD(LOG_TAG, "%s: %u bytes (%s, %" PRIu32 " samples)", config->uri, (unsigned)stream.total_bytes,
+                 stream.format == SYSMON_STREAM_CBOR ? "cbor" : "json", query.samples);
+    }
     return result;
 }
-
@@ -0,0 +1,674 @@
+/**
+ * @file sysmon_hardware.c
+ * @brief /hardware document: chip, memory and partition table, encoded once and cached.
+ *
+ * One cache entry per wire format (JSON, CBOR), each holding the encoded members of the
+ * static part of the document without the map delimiters. A request opens the map,
+ * splices the entry in with sysmon_stream_members() and writes the dynamic members after
+ * it. An entry is rebuilt when the OTA or NVS counter moved since it was encoded; if it
+ * cannot be allocated, the static members are encoded straight into the response.
+ */
+
+// Project-specific includes
+#include "sysmon_hardware.h"
+#include "sysmon_stream.h"
+#include "sysmon_utils.h"
+#include "sysmon.h"
+
+// ESP-IDF includes
+#include "esp_chip_info.h"
+#include "esp_log.h"
+#include "esp_system.h"
+#include "esp_heap_caps.h"
+#include "esp_clk_tree.h"
+#include "soc/clk_tree_defs.h"
+#include "esp_partition.h"
+#include "esp_flash.h"
+#include "nvs_flash.h"
+#include "esp_image_format.h"
+
+// System includes
+#include <stdbool.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// Logger tag for this module
+static const char *LOG_TAG = "sysmon_hardware";
+
+#define HARDWARE_CACHE_MIN 512  // First allocation of a cache entry, doubled as needed
+
+/**
+ * @brief Encoded static members of the document in one wire format.
+ *
+ * Members:
+ * - data    : Members without the map delimiters, NULL until built.
+ * - length  : Bytes in data.
+ * - size    : Allocated size of data.
+ * - ota_gen : s_ota_gen when data was encoded.
+ * - nvs_gen : s_nvs_gen when data was encoded.
+ */
+typedef struct
+{
+    char *data;
+    size_t length;
+    size_t size;
+    uint32_t ota_gen;
+    uint32_t nvs_gen;
+} hardware_cache_t;
+
+static hardware_cache_t s_cache[2];   // Indexed by sysmon_stream_format_t
+static uint32_t s_ota_gen = 0;        // Bumped by sysmon_hardware_note_ota()
+static uint32_t s_nvs_gen = 0;        // Bumped by sysmon_hardware_note_nvs_commit()
+
+// ============================================================================
+// Internal Helper Functions (Static Members)
+// ============================================================================
+
+/**
+ * @brief Determine chip variant string based on model, features, and memory configuration.
+ *
+ * @param chip_info Chip information structure.
+ * @param psram_total Total PSRAM size in bytes (0 if not present).
+ * @return Variant string (e.g., "ESP32-S3R8", "ESP32-S3FN8"), or NULL for base model.
+ *
+ * Note: Embedded flash size cannot be determined programmatically, so variants
+ * with embedded flash will show "F" prefix but without size specification.
+ */
+static const char *_determine_chip_variant(const esp_chip_info_t *chip_info, uint32_t psram_total)
+{
+    if (chip_info == NULL)
+    {
+        return NULL;
+    }
+
+    // Only ESP32-S3 has multiple variants
+    if (chip_info->model != CHIP_ESP32S3)
+    {
+        return NULL;
+    }
+
+    bool has_emb_flash = (chip_info->features & CHIP_FEATURE_EMB_FLASH) != 0;
+    bool has_emb_psram = (chip_info->features & CHIP_FEATURE_EMB_PSRAM) != 0;
+
+    // If no embedded flash or PSRAM, it's the base ESP32-S3
+    if (!has_emb_flash && !has_emb_psram)
+    {
+        return NULL;
+    }
+
+    // Build variant string
+    // Note: We use a static buffer since the result is written to the stream right away
+    static char variant_str[32];
+    size_t pos = 0;
+
+    // Start with base model
+    pos = snprintf(variant_str, sizeof(variant_str), "ESP32-S3");
+
+    // Add embedded flash indicator (F)
+    if (has_emb_flash)
+    {
+        // Note: Embedded flash size cannot be determined programmatically
+        // Common sizes are 4MB (H4) and 8MB (N8), but we can't detect which
+        variant_str[pos++] = 'F';
+    }
+
+    // Add PSRAM size indicator (R2, R8, R16)
+    if (has_emb_psram && psram_total > 0)
+    {
+        // Convert bytes to MB and determine variant suffix
+        uint32_t psram_mb = psram_total / (1024 * 1024);
+        if (psram_mb == 2)
+        {
+            pos += snprintf(variant_str + pos, sizeof(variant_str) - pos, "R2");
+        }
+        else if (psram_mb == 8)
+        {
+            pos += snprintf(variant_str + pos, sizeof(variant_str) - pos, "R8");
+        }
+        else if (psram_mb == 16)
+        {
+            pos += snprintf(variant_str + pos, sizeof(variant_str) - pos, "R16");
+        }
+        else
+        {
+            // Unknown PSRAM size, just add the size
+            pos += snprintf(variant_str + pos, sizeof(variant_str) - pos, "R%" PRIu32, psram_mb);
+        }
+    }
+
+    variant_str[pos] = '\0';
+    return variant_str;
+}
+
+/**
+ * @brief Chip model name.
+ */
+static const char *_chip_model_name(esp_chip_model_t model)
+{
+    switch (model)
+    {
+        case CHIP_ESP32:
+            return "ESP32";
+        case CHIP_ESP32S2:
+            return "ESP32-S2";
+        case CHIP_ESP32S3:
+            return "ESP32-S3";
+        case CHIP_ESP32C3:
+            return "ESP32-C3";
+        case CHIP_ESP32C2:
+            return "ESP32-C2";
+        case CHIP_ESP32C6:
+            return "ESP32-C6";
+        case CHIP_ESP32H2:
+            return "ESP32-H2";
+        case CHIP_ESP32P4:
+            return "ESP32-P4";
+        case CHIP_ESP32C61:
+            return "ESP32-C61";
+        case CHIP_ESP32C5:
+            return "ESP32-C5";
+        case CHIP_POSIX_LINUX:
+            return "POSIX-Linux";
+        default:
+            return "Unknown";
+    }
+}
+
+/**
+ * @brief Get usage statistics for a partition based on its type.
+ *
+ * @param part Partition to get stats for.
+ * @param used_bytes Output parameter for used bytes (0 if unavailable).
+ * @param free_bytes Output parameter for free bytes (0 if unavailable).
+ * @return true if usage stats are available, false otherwise.
+ *
+ * Details:
+ *   - For NVS partitions: Uses nvs_get_stats() to get actual usage.
+ *   - For App partitions: Sums the segment sizes read from the image header (one flash read per segment).
+ *   - For other partition types: Returns false (stats not available).
+ */
+static bool _get_partition_usage(const esp_partition_t *part,
+                                 uint32_t *used_bytes,
+                                 uint32_t *free_bytes)
+{
+    if (part == NULL || used_bytes == NULL || free_bytes == NULL)
+    {
+        return false;
+    }
+
+    *used_bytes = 0;
+    *free_bytes = 0;
+
+    // NVS partitions - can get actual usage stats
+    if (part->type == ESP_PARTITION_TYPE_DATA &&
+        part->subtype == ESP_PARTITION_SUBTYPE_DATA_NVS)
+    {
+        nvs_stats_t nvs_stats;
+        esp_err_t err = nvs_get_stats(part->label, &nvs_stats);
+        if (err == ESP_OK)
+        {
+            // NVS doesn't directly give bytes, but we can estimate
+            // Each entry has overhead, so we calculate based on entries
+            // This is approximate - NVS has variable entry sizes
+            uint32_t total_entries = nvs_stats.used_entries + nvs_stats.free_entries;
+            if (total_entries > 0)
+            {
+                // Estimate: used entries / total entries * partition size
+                *used_bytes = (uint32_t)((double)nvs_stats.used_entries /
+                                        (double)total_entries * part->size);
+                *free_bytes = part->size - *used_bytes;
+            }
+            else
+            {
+                *free_bytes = part->size;
+            }
+            return true;
+        }
+        else
+        {
+            ESP_LOGW(LOG_TAG, "nvs_get_stats() failed for partition '%s': %s (0x%x). Usage stats unavailable.",
+                     part->label, esp_err_to_name(err), err);
+        }
+    }
+
+    // App partitions - read actual image size from image header
+    if (part->type == ESP_PARTITION_TYPE_APP)
+    {
+        // Read image header to verify it's a valid app image
+        esp_image_header_t image_header;
+        esp_err_t err = esp_flash_read(NULL, &image_header, part->address, sizeof(esp_image_header_t));
+        if (err == ESP_OK && image_header.magic == ESP_IMAGE_HEADER_MAGIC)
+        {
+            // Calculate image size by reading all segment headers sequentially
+            uint32_t image_size = sizeof(esp_image_header_t);
+            uint8_t segment_count = image_header.segment_count;
+            uint32_t current_offset = sizeof(esp_image_header_t);
+
+            // Read each segment header and sum data lengths
+            for (uint8_t i = 0; i < segment_count; i++)
+            {
+                esp_image_segment_header_t seg_header;
+                err = esp_flash_read(NULL, &seg_header, part->address + current_offset,
+                                     sizeof(esp_image_segment_header_t));
+                if (err != ESP_OK)
+                {
+                    ESP_LOGW(LOG_TAG, "esp_flash_read() failed for partition '%s' at offset 0x%" PRIx32 ": %s (0x%x). Using fallback size calculation.",
+                             part->label, current_offset, esp_err_to_name(err), err);
+                    break;
+                }
+
+                // Add segment header size
+                image_size += sizeof(esp_image_segment_header_t);
+
+                // Add segment data length (aligned to 4 bytes)
+                uint32_t data_len = seg_header.data_len;
+                if (data_len % 4 != 0)
+                {
+                    data_len = (data_len + 3) & ~3; // Align to 4 bytes
+                }
+                image_size += data_len;
+
+                // Move to next segment header
+                current_offset += sizeof(esp_image_segment_header_t) + data_len;
+            }
+
+            // Add app description size (typically 32 bytes at end of image)
+            // Using constant size since esp_app_desc_t may not be available in all ESP-IDF versions
+            image_size += 32; // sizeof(esp_app_desc_t) is typically 32 bytes
+
+            // Ensure we don't exceed partition size
+            if (image_size > part->size)
+            {
+                image_size = part->size;
+            }
+
+            *used_bytes = image_size;
+            *free_bytes = part->size - image_size;
+            return true;
+        }
+
+        // Fallback: if we can't read the header, assume fully used
+        // This is safer than showing incorrect free space
+        *used_bytes = part->size;
+        *free_bytes = 0;
+        return true;
+    }
+
+    // Other partition types - usage stats not available
+    return false;
+}
+
+/**
+ * @brief "chip" and "memory" members.
+ */
+static void _stream_chip_members(sysmon_stream_t *stream)
+{
+    esp_chip_info_t chip_info;
+    esp_chip_info(&chip_info);
+
+    // Get PSRAM size for variant determination (needed before variant check)
+    uint32_t psram_total = (uint32_t)heap_caps_get_total_size(MALLOC_CAP_SPIRAM);
+
+    sysmon_stream_key(stream, "chip");
+    sysmon_stream_map_begin(stream);
+    sysmon_stream_key(stream, "model");
+    sysmon_stream_string(stream, _chip_model_name(chip_info.model));
+    sysmon_stream_key(stream, "revision");
+    sysmon_stream_uint(stream, chip_info.revision);
+    sysmon_stream_key(stream, "cores");
+    sysmon_stream_uint(stream, chip_info.cores);
+
+    // Determine chip variant (e.g., ESP32-S3R8, ESP32-S3FN8)
+    const char *variant_str = _determine_chip_variant(&chip_info, psram_total);
+    if (variant_str != NULL)
+    {
+        sysmon_stream_key(stream, "variant");
+        sysmon_stream_string(stream, variant_str);
+    }
+
+    // Get current CPU frequency in MHz using ESP-IDF 5+ clock tree API
+    // According to ESP-IDF 5+ docs: https://docs.espressif.com/projects/esp-idf/en/latest/esp32/api-reference/peripherals/clk_tree.html
+    uint32_t cpu_freq_hz = 0;
+    esp_err_t freq_err = esp_clk_tree_src_get_freq_hz(SOC_MOD_CLK_CPU, ESP_CLK_TREE_SRC_FREQ_PRECISION_CACHED, &cpu_freq_hz);
+    uint32_t cpu_freq_mhz = 0;
+    if (freq_err == ESP_OK && cpu_freq_hz > 0)
+    {
+        cpu_freq_mhz = cpu_freq_hz / 1000000;
+    }
+    sysmon_stream_key(stream, "cpuFreqMHz");
+    sysmon_stream_uint(stream, cpu_freq_mhz);
+
+    // Chip features
+    sysmon_stream_key(stream, "features");
+    sysmon_stream_array_begin(stream);
+    if (chip_info.features & CHIP_FEATURE_EMB_FLASH)
+    {
+        sysmon_stream_string(stream, "Embedded Flash");
+    }
+    if (chip_info.features & CHIP_FEATURE_WIFI_BGN)
+    {
+        sysmon_stream_string(stream, "WiFi 2.4GHz");
+    }
+    if (chip_info.features & CHIP_FEATURE_BLE)
+    {
+        sysmon_stream_string(stream, "Bluetooth LE");
+    }
+    if (chip_info.features & CHIP_FEATURE_BT)
+    {
+        sysmon_stream_string(stream, "Bluetooth Classic");
+    }
+    if (chip_info.features & CHIP_FEATURE_IEEE802154)
+    {
+        sysmon_stream_string(stream, "IEEE 802.15.4");
+    }
+    if (chip_info.features & CHIP_FEATURE_EMB_PSRAM)
+    {
+        sysmon_stream_string(stream, "Embedded PSRAM");
+    }
+    sysmon_stream_array_end(stream);
+    sysmon_stream_map_end(stream);
+
+    // Memory information (totals are static)
+    sysmon_stream_key(stream, "memory");
+    sysmon_stream_map_begin(stream);
+    sysmon_stream_key(stream, "dramTotal");
+    sysmon_stream_uint(stream, heap_caps_get_total_size(MALLOC_CAP_INTERNAL));
+    sysmon_stream_key(stream, "psramTotal");
+    sysmon_stream_uint(stream, psram_total);
+    // CONFIG_SPIRAM_SPEED is only available when PSRAM is enabled in sdkconfig
+#ifdef CONFIG_SPIRAM_SPEED
+    if (psram_total > 0U)
+    {
+        sysmon_stream_key(stream, "psramSpeed");
+        sysmon_stream_uint(stream, CONFIG_SPIRAM_SPEED);
+    }
+#endif
+    sysmon_stream_map_end(stream);
+}
+
+/**
+ * @brief "partitions", "flashSummary" and "config" members: the flash reads and nvs_get_stats() calls live here.
+ */
+static void _stream_partition_members(sysmon_stream_t *stream)
+{
+    uint32_t total_partition_size = 0;
+
+    sysmon_stream_key(stream, "partitions");
+    sysmon_stream_array_begin(stream);
+    esp_partition_iterator_t it = esp_partition_find(ESP_PARTITION_TYPE_ANY, ESP_PARTITION_SUBTYPE_ANY, NULL);
+    while (it != NULL)
+    {
+        const esp_partition_t *part = esp_partition_get(it);
+
+        // Skip phy_init, the system partition for PHY initialization data
+        if (part == NULL || strcmp(part->label, "phy_init") == 0)
+        {
+            it = esp_partition_next(it);
+            continue;
+        }
+        total_partition_size += part->size;
+
+        sysmon_stream_map_begin(stream);
+        sysmon_stream_key(stream, "label");
+        sysmon_stream_string(stream, part->label);
+        sysmon_stream_key(stream, "type");
+        sysmon_stream_uint(stream, (uint64_t)part->type);
+        sysmon_stream_key(stream, "address");
+        sysmon_stream_uint(stream, part->address);
+        sysmon_stream_key(stream, "size");
+        sysmon_stream_uint(stream, part->size);
+
+        // Get usage statistics if available
+        uint32_t used_bytes = 0;
+        uint32_t free_bytes = 0;
+        bool usage_available = _get_partition_usage(part, &used_bytes, &free_bytes);
+        sysmon_stream_key(stream, "usageAvailable");
+        sysmon_stream_bool(stream, usage_available);
+        if (usage_available)
+        {
+            sysmon_stream_key(stream, "used");
+            sysmon_stream_uint(stream, used_bytes);
+            sysmon_stream_key(stream, "free");
+            sysmon_stream_uint(stream, free_bytes);
+            sysmon_stream_key(stream, "usedPct");
+            sysmon_stream_fixed(stream, (part->size > 0) ? (float)((double)used_bytes / (double)part->size * 100.0) : 0.0f, 2);
+        }
+        sysmon_stream_map_end(stream);
+        it = esp_partition_next(it);
+    }
+    esp_partition_iterator_release(it);
+    sysmon_stream_array_end(stream);
+
+    // Flash summary (total flash size and space not covered by a partition)
+    uint32_t total_flash_size = 0;
+    esp_err_t flash_ret = esp_flash_get_size(NULL, &total_flash_size);
+    if (flash_ret != ESP_OK)
+    {
+        ESP_LOGW(LOG_TAG, "esp_flash_get_size() failed: %s (0x%x). Flash summary unavailable.",
+                 esp_err_to_name(flash_ret), flash_ret);
+        total_flash_size = 0;
+    }
+    if (total_flash_size > 0)
+    {
+        uint32_t unused_flash = total_flash_size - total_partition_size;
+        sysmon_stream_key(stream, "flashSummary");
+        sysmon_stream_map_begin(stream);
+        sysmon_stream_key(stream, "totalFlash");
+        sysmon_stream_uint(stream, total_flash_size);
+        sysmon_stream_key(stream, "totalPartitions");
+        sysmon_stream_uint(stream, total_partition_size);
+        sysmon_stream_key(stream, "unused");
+        sysmon_stream_uint(stream, unused_flash);
+        sysmon_stream_key(stream, "unusedPct");
+        sysmon_stream_fixed(stream, (float)((double)unused_flash / (double)total_flash_size * 100.0), 2);
+        sysmon_stream_key(stream, "partitionsPct");
+        sysmon_stream_fixed(stream, (float)((double)total_partition_size / (double)total_flash_size * 100.0), 2);
+        sysmon_stream_map_end(stream);
+    }
+
+    // Configuration section for frontend
+    sysmon_stream_key(stream, "config");
+    sysmon_stream_map_begin(stream);
+    sysmon_stream_key(stream, "cpuSamplingIntervalMs");
+    sysmon_stream_uint(stream, CONFIG_SYSMON_CPU_SAMPLING_INTERVAL_MS);
+    sysmon_stream_key(stream, "sampleCount");
+    sysmon_stream_uint(stream, CONFIG_SYSMON_SAMPLE_COUNT);
+    sysmon_stream_map_end(stream);
+}
+
+/**
+ * @brief All the cached members, in document order.
+ */
+static void _stream_static_members(sysmon_stream_t *stream)
+{
+    _stream_chip_members(stream);
+    _stream_partition_members(stream);
+}
+
+// ============================================================================
+// Internal Helper Functions (Dynamic Members)
+// ============================================================================
+
+/**
+ * @brief "system" and "wifi" members, written on every request.
+ */
+static void _stream_dynamic_members(sysmon_stream_t *stream)
+{
+    sysmon_stream_key(stream, "system");
+    sysmon_stream_map_begin(stream);
+    sysmon_stream_key(stream, "idfVersion");
+    sysmon_stream_string(stream, esp_get_idf_version());
+    sysmon_stream_key(stream, "compileTime");
+    sysmon_stream_string(stream, __DATE__ " " __TIME__);
+
+    // Boot time - show current date/time as ESP32 sees it
+    // Format matches compile time: "MMM DD YYYY HH:MM:SS" (e.g., "Nov 11 2025 02:17:56")
+    time_t now = time(NULL);
+    char boot_time_str[64];
+    if (now > 0)
+    {
+        struct tm timeinfo;
+        if (localtime_r(&now, &timeinfo) != NULL)
+        {
+            strftime(boot_time_str, sizeof(boot_time_str), "%b %d %Y %H:%M:%S", &timeinfo);
+        }
+        else
+        {
+            snprintf(boot_time_str, sizeof(boot_time_str), "Time not available");
+        }
+    }
+    else
+    {
+        snprintf(boot_time_str, sizeof(boot_time_str), "Time not set");
+    }
+    sysmon_stream_key(stream, "bootTime");
+    sysmon_stream_string(stream, boot_time_str);
+    sysmon_stream_map_end(stream);
+
+    sysmon_stream_key(stream, "wifi");
+    sysmon_stream_map_begin(stream);
+    char ssid_buffer[33] = { 0 };
+    sysmon_stream_key(stream, "ssid");
+    sysmon_stream_string(stream, (_get_wifi_ssid(ssid_buffer, sizeof(ssid_buffer)) == ESP_OK) ? ssid_buffer : "Not Connected");
+
+    int8_t rssi = 0;
+    sysmon_stream_key(stream, "rssi");
+    if (_get_wifi_rssi(&rssi) == ESP_OK)
+    {
+        sysmon_stream_int(stream, rssi);
+    }
+    else
+    {
+        sysmon_stream_null(stream);
+    }
+
+    char ip_buffer[16] = { 0 };
+    sysmon_stream_key(stream, "ip");
+    sysmon_stream_string(stream, (_get_wifi_ip_info(ip_buffer, sizeof(ip_buffer)) == ESP_OK) ? ip_buffer : "N/A");
+
+    // HTTP server port
+    sysmon_stream_key(stream, "port");
+    sysmon_stream_uint(stream, CONFIG_SYSMON_HTTPD_SERVER_PORT);
+    sysmon_stream_map_end(stream);
+}
+
+// ============================================================================
+// Internal Helper Functions (Cache)
+// ============================================================================
+
+/**
+ * @brief Stream sink appending to a cache entry, growing it by doubling.
+ */
+static esp_err_t _cache_write(void *ctx, const char *data, size_t len)
+{
+    hardware_cache_t *cache = (hardware_cache_t *)ctx;
+    size_t needed = cache->length + len;
+    if (needed > cache->size)
+    {
+        size_t size = (cache->size != 0) ? cache->size : HARDWARE_CACHE_MIN;
+        while (size < needed)
+        {
+            size *= 2;
+        }
+        char *data_new = realloc(cache->data, size);
+        if (data_new == NULL)
+        {
+            return ESP_ERR_NO_MEM;
+        }
+        cache->data = data_new;
+        cache->size = size;
+    }
+    memcpy(cache->data + cache->length, data, len);
+    cache->length = needed;
+    return ESP_OK;
+}
+
+static void _cache_free(hardware_cache_t *cache)
+{
+    free(cache->data);
+    memset(cache, 0, sizeof(*cache));
+}
+
+/**
+ * @brief The cache entry of `format`, rebuilt if a hook ran since it was encoded.
+ *
+ * @return The entry, or NULL when it could not be built (out of memory).
+ */
+static const hardware_cache_t *_cache_get(sysmon_stream_format_t format)
+{
+    hardware_cache_t *cache = &s_cache[format];
+    uint32_t ota_gen = __atomic_load_n(&s_ota_gen, __ATOMIC_ACQUIRE);
+    uint32_t nvs_gen = __atomic_load_n(&s_nvs_gen, __ATOMIC_ACQUIRE);
+    if (cache->data != NULL && cache->ota_gen == ota_gen && cache->nvs_gen == nvs_gen)
+    {
+        return cache;
+    }
+
+    // Encoded as a whole map, then the delimiters are cut off (1 byte each in JSON and CBOR)
+    sysmon_stream_t stream;
+    cache->length = 0;
+    sysmon_stream_init(&stream, format, _cache_write, cache);
+    sysmon_stream_map_begin(&stream);
+    _stream_static_members(&stream);
+    sysmon_stream_map_end(&stream);
+    esp_err_t err = sysmon_stream_finish(&stream);
+    if (err != ESP_OK || cache->length < 2)
+    {
+        ESP_LOGW(LOG_TAG, "%s document not cached: %s (0x%x)",
+                 format == SYSMON_STREAM_CBOR ? "cbor" : "json", esp_err_to_name(err), err);
+        _cache_free(cache);
+        return NULL;
+    }
+    cache->length -= 2;
+    memmove(cache->data, cache->data + 1, cache->length);
+    cache->ota_gen = ota_gen;
+    cache->nvs_gen = nvs_gen;
+    ESP_LOGD(LOG_TAG, "%s document cached: %u bytes (ota %" PRIu32 ", nvs %" PRIu32 ")",
+             format == SYSMON_STREAM_CBOR ? "cbor" : "json", (unsigned)cache->length, ota_gen, nvs_gen);
+    return cache;
+}
+
+// ============================================================================
+// Public API Functions
+// ============================================================================
+
+esp_err_t sysmon_stream_hardware(sysmon_stream_t *stream, const SysMonState *state, const sysmon_stream_query_t *query)
+{
+    (void)state;
+    (void)query;
+
+    sysmon_stream_map_begin(stream);
+    const hardware_cache_t *cache = _cache_get(stream->format);
+    if (cache != NULL)
+    {
+        sysmon_stream_members(stream, cache->data, cache->length);
+    }
+    else
+    {
+        _stream_static_members(stream);
+    }
+    _stream_dynamic_members(stream);
+    sysmon_stream_map_end(stream);
+    return stream->error;
+}
+
+void sysmon_hardware_note_ota(void)
+{
+    __atomic_fetch_add(&s_ota_gen, 1, __ATOMIC_RELEASE);
+}
+
+void sysmon_hardware_note_nvs_commit(void)
+{
+    __atomic_fetch_add(&s_nvs_gen, 1, __ATOMIC_RELEASE);
+}
+
+void sysmon_hardware_cleanup(void)
+{
+    for (size_t i = 0; i < sizeof(s_cache) / sizeof(s_cache[0]); i++)
+    {
+        _cache_free(&s_cache[i]);
+    }
+}
@@ -4,30 +4,39 @@
  *
  * This module manages the HTTP server lifecycle and route registration for the sysmon
  * system monitor. It coordinates with sysmon_handlers.c for request handling and
- * sysmon_json.c for JSON response generation.
+ * sysmon_stream.c / sysmon_hardware.c for the documents.
  *
  * Responsibilities:
  *   - Initializes and runs the HTTP server for telemetry endpoints.
- *   - Registers static file and JSON endpoint handlers.
+ *   - Registers static file and streamed endpoint handlers.
  *   - Manages server lifecycle (start/stop).
  *
  * Dependencies:
  *   - ESP-IDF HTTP server (esp_http_server)
  *   - sysmon core API (sysmon.h)
  *   - sysmon_config.h for configuration structures
- *   - sysmon_json.h for JSON function declarations
+ *   - sysmon_stream.h and sysmon_hardware.h for the document functions
  *   - sysmon_handlers.c for HTTP request handlers
  *
  * Usage:
  *   - Call sysmon_http_start() to activate endpoints; sysmon_http_stop() to disable.
- *   - Endpoints: '/', '/tasks', '/history', '/telemetry', '/hardware'
+ *   - Endpoints: '/', '/tasks', '/history', '/telemetry', '/rollup', '/hardware', '/events'
+ *   - '/tasks', '/history' and '/telemetry' are streamed (sysmon_stream.c): JSON or CBOR
+ *     depending on the Accept header, '/history?since=<seq>' for deltas
+ *   - '/hardware' is served from a cache rebuilt only after OTA/NVS writes (sysmon_hardware.c)
+ *   - Dashboard assets come from sysmon_www_files, packed at build time (gzip, ETag, 304)
+ *   - '/events' pushes every sample as Server-Sent Events (sysmon_events.c); the dashboard
+ *     polls only when it cannot subscribe
  *  */
 
 // Project-specific includes
 #include "sysmon_http.h"
 #include "sysmon.h"
 #include "sysmon_config.h"
-#include "sysmon_json.h"
+#include "sysmon_events.h"
+#include "sysmon_hardware.h"
+#include "sysmon_sched.h"
+#include "sysmon_stream.h"
 
 // ESP-IDF includes
 #include "esp_log.h"
@@ -39,32 +48,29 @@
 // Logger tag for this module
 static const char *LOG_TAG = "sysmon_http";
 
-// Forward declarations for handler functions (defined in sysmon_handlers.c)
-extern esp_err_t http_handle_static_file(httpd_req_t *request);
-extern esp_err_t http_handle_json_endpoint(httpd_req_t *request);
+// Browsers open up to 6 connections per host. Unbundled, a first dashboard open fetches
+// 10 static files plus the API endpoints concurrently and needs more sockets. Each /events
+// subscriber keeps one of these sockets open.
+#if CONFIG_SYSMON_WWW_BUNDLE
+#define SYSMON_HTTPD_MAX_OPEN_SOCKETS 7
+#else
+#define SYSMON_HTTPD_MAX_OPEN_SOCKETS 12
+#endif
 
-// Static file handler configurations
-static const static_file_config_t static_file_configs[] =
-{
-    STATIC_FILE_ENTRY("/", index_html),
-    STATIC_FILE_ENTRY("/css/sysmon-theme-color-vars.css", sysmon_theme_color_vars_css),
-    STATIC_FILE_ENTRY("/css/sysmon-theme-utility-classes.css", sysmon_theme_utility_classes_css),
-    STATIC_FILE_ENTRY("/css/sysmon-theme.css", sysmon_theme_css),
-    STATIC_FILE_ENTRY("/js/theme.js", theme_js),
-    STATIC_FILE_ENTRY("/js/config.js", config_js),
-    STATIC_FILE_ENTRY("/js/utils.js", utils_js),
-    STATIC_FILE_ENTRY("/js/charts.js", charts_js),
-    STATIC_FILE_ENTRY("/js/table.js", table_js),
-    STATIC_FILE_ENTRY("/js/app.js", app_js)
-};
+// Forward declarations for handler functions (defined in sysmon_www.c, sysmon_handlers.c and sysmon_events.c)
+extern esp_err_t http_handle_static_file(httpd_req_t *request);
+extern esp_err_t http_handle_stream_endpoint(httpd_req_t *request);
+extern esp_err_t http_handle_events(httpd_req_t *request);
 
-// JSON endpoint handler configurations
-static const json_handler_config_t json_handler_configs[] =
+// Streamed endpoint handler configurations (polled by the dashboard, JSON or CBOR, /history?since=<seq>, /rollup?tier=<n>)
+static const stream_handler_config_t stream_handler_configs[] =
 {
-    JSON_ENDPOINT_ENTRY("/tasks", _create_tasks_json),
-    JSON_ENDPOINT_ENTRY("/history", _create_history_json),
-    JSON_ENDPOINT_ENTRY("/telemetry", _create_telemetry_json),
-    JSON_ENDPOINT_ENTRY("/hardware", _create_hardware_json)
+    STREAM_ENDPOINT_ENTRY("/tasks", sysmon_stream_tasks, 1),
+    STREAM_ENDPOINT_ENTRY("/history", sysmon_stream_history, CONFIG_SYSMON_SAMPLE_COUNT),
+    STREAM_ENDPOINT_ENTRY("/telemetry", sysmon_stream_telemetry, 1),
+    STREAM_ROLLUP_ENDPOINT_ENTRY("/rollup", sysmon_stream_rollup),
+    STREAM_STATIC_ENDPOINT_ENTRY("/hardware", sysmon_stream_hardware),
+    STREAM_STATIC_ENDPOINT_ENTRY("/sched", sysmon_stream_sched)
 };
 
 /**
@@ -128,19 +134,20 @@ esp_err_t sysmon_http_start(void)
     config.server_port      = CONFIG_SYSMON_HTTPD_SERVER_PORT;
     config.ctrl_port        = CONFIG_SYSMON_HTTPD_CTRL_PORT; // necessary if you want to create multiple HTTPD servers
 
-    // Allow more simultaneous connections for multiple browser asset/API requests
-    // Served files: 1 HTML + 3 CSS + 6 JS = 10 static files, plus 4 JSON API endpoints
-    // Browsers load these concurrently, so default max_open_sockets=7 is insufficient
-    config.max_open_sockets = 12;
+    // Simultaneous connections for the browser's asset/API requests (see SYSMON_HTTPD_MAX_OPEN_SOCKETS)
+    config.max_open_sockets = SYSMON_HTTPD_MAX_OPEN_SOCKETS;
+
+    // Unsubscribe /events clients before their socket is closed
+    config.close_fn         = sysmon_events_close_fn;
 
     // Set max URI handlers based on how many static files & APIs we'll serve
-    size_t static_file_count  = sizeof(static_file_configs) / sizeof(static_file_configs[0]);
-    size_t json_handler_count = sizeof(json_handler_configs) / sizeof(json_handler_configs[0]);
-    config.max_uri_handlers   = static_file_count + json_handler_count;
+    size_t static_file_count  = sysmon_www_file_count;
+    size_t stream_handler_count = sizeof(stream_handler_configs) / sizeof(stream_handler_configs[0]);
+    config.max_uri_handlers   = static_file_count + stream_handler_count + 1;  // + /events
 
     // Warn if LWIP socket pool is too small for this server config
-#if CONFIG_LWIP_MAX_SOCKETS < 15
-    #warning "CONFIG_LWIP_MAX_SOCKETS may be too low (need at least 15 for max_open_sockets=12)."
+#if CONFIG_LWIP_MAX_SOCKETS < SYSMON_HTTPD_MAX_OPEN_SOCKETS + 3
+    #warning "CONFIG_LWIP_MAX_SOCKETS may be too low (need max_open_sockets + 3 for the HTTP server)."
 #endif
 
 
@@ -153,30 +160,31 @@ esp_err_t sysmon_http_start(void)
     }
 
     // Register all static file handlers
-    for (size_t i = 0; i < sizeof(static_file_configs) / sizeof(static_file_configs[0]); i++)
+    for (size_t i = 0; i < sysmon_www_file_count; i++)
     {
-        err = _register_handler(self.httpd, static_file_configs[i].uri, HTTP_GET,
-                                 http_handle_static_file, (void *)&static_file_configs[i],
-                                 static_file_configs[i].uri);
+        err = _register_handler(self.httpd, sysmon_www_files[i].uri, HTTP_GET,
+                                 http_handle_static_file, (void *)&sysmon_www_files[i],
+                                 sysmon_www_files[i].uri);
         if (err != ESP_OK)
         {
             return err;
         }
     }
 
-    // Register all JSON endpoint handlers
-    for (size_t i = 0; i < sizeof(json_handler_configs) / sizeof(json_handler_configs[0]); i++)
+    // Register all streamed endpoint handlers
+    for (size_t i = 0; i < sizeof(stream_handler_configs) / sizeof(stream_handler_configs[0]); i++)
     {
-        err = _register_handler(self.httpd, json_handler_configs[i].uri, HTTP_GET,
-                                 http_handle_json_endpoint, (void *)&json_handler_configs[i],
-                                 json_handler_configs[i].uri);
+        err = _register_handler(self.httpd, stream_handler_configs[i].uri, HTTP_GET,
+                                 http_handle_stream_endpoint, (void *)&stream_handler_configs[i],
+                                 stream_handler_configs[i].uri);
         if (err != ESP_OK)
         {
             return err;
         }
     }
 
-    return ESP_OK;
+    // Register the server-push endpoint
+    return _register_handler(self.httpd, "/events", HTTP_GET, http_handle_events, NULL, "/events");
 }
 
 /**
@@ -0,0 +1,139 @@
+/**
+ * @file sysmon_index.c
+ * @brief Open-addressing hash index (linear probing, backward-shift removal).
+ */
+
+// Project-specific includes
+#include "sysmon_index.h"
+
+// System includes
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @brief Home bucket of a key.
+ *
+ * Task numbers are consecutive and task handles are aligned heap addresses, so the key is
+ * mixed (Fibonacci hashing on the folded 32-bit value) before masking.
+ */
+static uint32_t _index_home(const sysmon_index_t *index, uintptr_t key)
+{
+    uint32_t folded = (uint32_t)key ^ (uint32_t)((uint64_t)key >> 32);
+    folded *= 2654435761U;
+    return (folded ^ (folded >> 16)) & index->mask;
+}
+
+esp_err_t sysmon_index_init(sysmon_index_t *index, uint32_t capacity)
+{
+    uint32_t buckets = 8;
+    while (buckets < capacity * 2)
+    {
+        buckets <<= 1;
+    }
+    memset(index, 0, sizeof(*index));
+    index->entries = (sysmon_index_entry_t *)calloc(buckets, sizeof(sysmon_index_entry_t));
+    if (index->entries == NULL)
+    {
+        return ESP_ERR_NO_MEM;
+    }
+    index->mask = buckets - 1;
+    return ESP_OK;
+}
+
+void sysmon_index_free(sysmon_index_t *index)
+{
+    free(index->entries);
+    memset(index, 0, sizeof(*index));
+}
+
+void sysmon_index_rehash(sysmon_index_t *to, const sysmon_index_t *from)
+{
+    for (uint32_t i = 0; from->entries != NULL && i <= from->mask; i++)
+    {
+        if (from->entries[i].key != 0)
+        {
+            sysmon_index_put(to, from->entries[i].key, from->entries[i].value);
+        }
+    }
+}
+
+bool sysmon_index_find(const sysmon_index_t *index, uintptr_t key, uint32_t *value)
+{
+    if (index->entries == NULL || key == 0)
+    {
+        return false;
+    }
+    for (uint32_t i = _index_home(index, key);; i = (i + 1) & index->mask)
+    {
+        const sysmon_index_entry_t *entry = &index->entries[i];
+        if (entry->key == key)
+        {
+            *value = entry->value;
+            return true;
+        }
+        if (entry->key == 0)
+        {
+            return false;
+        }
+    }
+}
+
+esp_err_t sysmon_index_put(sysmon_index_t *index, uintptr_t key, uint32_t value)
+{
+    if (key == 0)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (index->entries == NULL)
+    {
+        return ESP_ERR_NO_MEM;
+    }
+    uint32_t i = _index_home(index, key);
+    while (index->entries[i].key != 0 && index->entries[i].key != key)
+    {
+        i = (i + 1) & index->mask;
+    }
+    if (index->entries[i].key == 0)
+    {
+        if (!sysmon_index_has_room(index))
+        {
+            return ESP_ERR_NO_MEM;
+        }
+        index->entries[i].key = key;
+        index->count++;
+    }
+    index->entries[i].value = value;
+    return ESP_OK;
+}
+
+void sysmon_index_remove(sysmon_index_t *index, uintptr_t key)
+{
+    if (index->entries == NULL || key == 0)
+    {
+        return;
+    }
+    uint32_t hole = _index_home(index, key);
+    while (index->entries[hole].key != key)
+    {
+        if (index->entries[hole].key == 0)
+        {
+            return;
+        }
+        hole = (hole + 1) & index->mask;
+    }
+
+    // Backward shift: pull later entries of the probe run into the hole when their
+    // home bucket is not between the hole and their current position.
+    for (uint32_t i = (hole + 1) & index->mask; index->entries[i].key != 0; i = (i + 1) & index->mask)
+    {
+        uint32_t home = _index_home(index, index->entries[i].key);
+        if (((i - home) & index->mask) >= ((i - hole) & index->mask))
+        {
+            index->entries[hole] = index->entries[i];
+            hole = i;
+        }
+    }
+    index->entries[hole].key = 0;
+    index->entries[hole].value = 0;
+    index->count--;
+}
@@ -0,0 +1,333 @@
+/**
+ * @file sysmon_push.c
+ * @brief Fan-out of sysmon samples to subscribed clients (Server-Sent Events frames).
+ *
+ * Slot life cycle (see sysmon_push.h for the two sides):
+ *
+ *   FREE --attach--> ACTIVE --queue full (publisher) / send error, detach (sender)--> CLOSING
+ *   CLOSING --pump or detach, while no publish is running (sender)--> FREE
+ *
+ * The publisher sets `publishing` before it reads any slot state and clears it when it is
+ * done; the sender reads `publishing` after a slot became CLOSING. Both are sequentially
+ * consistent, so either the sender sees the publish and leaves the slot for the next pump,
+ * or the publish starts later and sees CLOSING. A publish therefore never writes to a slot
+ * the sender is freeing or reusing.
+ */
+
+// Project-specific includes
+#include "sysmon_push.h"
+
+// System includes
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SYSMON_PUSH_SCRATCH_MIN 1024  // First scratch allocation, doubled as needed
+
+// ============================================================================
+// Internal Helper Functions
+// ============================================================================
+
+/**
+ * @brief Append to the publisher's scratch buffer, growing it by doubling.
+ */
+static esp_err_t _push_append(sysmon_push_t *push, const char *data, size_t len)
+{
+    size_t needed = push->scratch_length + len;
+    if (needed > push->scratch_size)
+    {
+        size_t size = (push->scratch_size != 0) ? push->scratch_size : SYSMON_PUSH_SCRATCH_MIN;
+        while (size < needed)
+        {
+            size *= 2;
+        }
+        char *scratch = realloc(push->scratch, size);
+        if (scratch == NULL)
+        {
+            return ESP_ERR_NO_MEM;
+        }
+        push->scratch = scratch;
+        push->scratch_size = size;
+    }
+    memcpy(push->scratch + push->scratch_length, data, len);
+    push->scratch_length = needed;
+    return ESP_OK;
+}
+
+/**
+ * @brief Stream sink writing the document into the scratch buffer.
+ */
+static esp_err_t _push_stream_write(void *ctx, const char *data, size_t len)
+{
+    return _push_append((sysmon_push_t *)ctx, data, len);
+}
+
+/**
+ * @brief Give a slot back: release its queued frames, close its socket unless detached.
+ *
+ * Sender side, only for CLOSING slots and only while no publish is running.
+ */
+static void _push_reclaim(sysmon_push_t *push, sysmon_push_client_t *client)
+{
+    uint32_t tail = __atomic_load_n(&client->tail, __ATOMIC_ACQUIRE);
+    for (uint32_t i = client->head; i != tail; i++)
+    {
+        sysmon_push_frame_release(client->queue[i % CONFIG_SYSMON_PUSH_QUEUE_DEPTH]);
+    }
+    if (!client->detached && push->close != NULL)
+    {
+        push->close(push->ctx, client->fd);
+    }
+    client->fd = -1;
+    client->head = 0;
+    client->tail = 0;
+    client->offset = 0;
+    client->detached = false;
+    __atomic_fetch_sub(&push->active, 1, __ATOMIC_RELAXED);
+    __atomic_store_n(&client->state, SYSMON_PUSH_FREE, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief Free a CLOSING slot unless a publish is running (then the next pump frees it).
+ */
+static void _push_try_reclaim(sysmon_push_t *push, sysmon_push_client_t *client)
+{
+    if (__atomic_load_n(&client->state, __ATOMIC_SEQ_CST) == SYSMON_PUSH_CLOSING &&
+        __atomic_load_n(&push->publishing, __ATOMIC_SEQ_CST) == 0)
+    {
+        _push_reclaim(push, client);
+    }
+}
+
+/**
+ * @brief ACTIVE -> CLOSING. False if the slot was not ACTIVE (already closing).
+ */
+static bool _push_close_slot(sysmon_push_client_t *client)
+{
+    uint32_t expected = SYSMON_PUSH_ACTIVE;
+    return __atomic_compare_exchange_n(&client->state, &expected, SYSMON_PUSH_CLOSING, false,
+                                       __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+}
+
+/**
+ * @brief Send queued frames of one client until its queue is empty or the socket would block.
+ */
+static void _push_send_client(sysmon_push_t *push, sysmon_push_client_t *client)
+{
+    uint32_t tail = __atomic_load_n(&client->tail, __ATOMIC_ACQUIRE);
+    while (client->head != tail)
+    {
+        sysmon_push_frame_t *frame = client->queue[client->head % CONFIG_SYSMON_PUSH_QUEUE_DEPTH];
+        int sent = push->send(push->ctx, client->fd, frame->data + client->offset, frame->length - client->offset);
+        if (sent < 0)
+        {
+            _push_close_slot(client);
+            return;
+        }
+        if (sent == 0)
+        {
+            return;
+        }
+        client->offset += (size_t)sent;
+        client->bytes += (uint64_t)sent;
+        if (client->offset < frame->length)
+        {
+            continue;
+        }
+        client->offset = 0;
+        client->frames++;
+        sysmon_push_frame_release(frame);
+        __atomic_store_n(&client->head, client->head + 1, __ATOMIC_RELEASE);
+    }
+}
+
+// ============================================================================
+// Public API Functions
+// ============================================================================
+
+void sysmon_push_init(sysmon_push_t *push, sysmon_push_send_fn send, sysmon_push_close_fn close, void *ctx)
+{
+    memset(push, 0, sizeof(*push));
+    for (int i = 0; i < CONFIG_SYSMON_PUSH_MAX_CLIENTS; i++)
+    {
+        push->clients[i].fd = -1;
+    }
+    push->send  = send;
+    push->close = close;
+    push->ctx   = ctx;
+}
+
+void sysmon_push_shutdown(sysmon_push_t *push)
+{
+    for (int i = 0; i < CONFIG_SYSMON_PUSH_MAX_CLIENTS; i++)
+    {
+        sysmon_push_client_t *client = &push->clients[i];
+        if (client->state != SYSMON_PUSH_FREE)
+        {
+            client->state = SYSMON_PUSH_CLOSING;
+            _push_reclaim(push, client);
+        }
+    }
+    free(push->scratch);
+    push->scratch = NULL;
+    push->scratch_size = 0;
+    push->scratch_length = 0;
+}
+
+sysmon_push_frame_t *sysmon_push_encode(sysmon_push_t *push, const char *event, sysmon_push_doc_fn doc,
+                                        const SysMonState *state)
+{
+    char header[48];
+    uint32_t seq = push->seq + 1;
+    int header_len = snprintf(header, sizeof(header), "event: %s\nid: %lu\ndata: ", event, (unsigned long)seq);
+    if (header_len < 0 || (size_t)header_len >= sizeof(header))
+    {
+        return NULL;
+    }
+
+    push->scratch_length = 0;
+    if (_push_append(push, header, (size_t)header_len) != ESP_OK)
+    {
+        return NULL;
+    }
+    sysmon_stream_t stream;
+    sysmon_stream_query_t query = { 0 };
+    sysmon_stream_init(&stream, SYSMON_STREAM_JSON, _push_stream_write, push);
+    esp_err_t err = doc(&stream, state, &query);
+    if (err == ESP_OK)
+    {
+        err = sysmon_stream_finish(&stream);
+    }
+    if (err == ESP_OK)
+    {
+        err = _push_append(push, "\n\n", 2);
+    }
+    if (err != ESP_OK)
+    {
+        return NULL;
+    }
+
+    // Exact-size copy: the frame lives as long as the slowest client's queue holds it
+    sysmon_push_frame_t *frame = malloc(sizeof(sysmon_push_frame_t) + push->scratch_length);
+    if (frame == NULL)
+    {
+        return NULL;
+    }
+    frame->refs   = 1;
+    frame->seq    = seq;
+    frame->length = push->scratch_length;
+    memcpy(frame->data, push->scratch, push->scratch_length);
+    push->seq = seq;
+    return frame;
+}
+
+void sysmon_push_publish(sysmon_push_t *push, sysmon_push_frame_t *frame)
+{
+    if (frame == NULL)
+    {
+        return;
+    }
+    __atomic_store_n(&push->publishing, 1, __ATOMIC_SEQ_CST);
+    for (int i = 0; i < CONFIG_SYSMON_PUSH_MAX_CLIENTS; i++)
+    {
+        sysmon_push_client_t *client = &push->clients[i];
+        if (__atomic_load_n(&client->state, __ATOMIC_SEQ_CST) != SYSMON_PUSH_ACTIVE)
+        {
+            continue;
+        }
+        uint32_t head = __atomic_load_n(&client->head, __ATOMIC_ACQUIRE);
+        if (client->tail - head >= CONFIG_SYSMON_PUSH_QUEUE_DEPTH)
+        {
+            // Slow client: drop it instead of waiting or buffering more
+            if (_push_close_slot(client))
+            {
+                __atomic_fetch_add(&push->dropped, 1, __ATOMIC_RELAXED);
+            }
+            continue;
+        }
+        __atomic_fetch_add(&frame->refs, 1, __ATOMIC_RELAXED);
+        client->queue[client->tail % CONFIG_SYSMON_PUSH_QUEUE_DEPTH] = frame;
+        __atomic_store_n(&client->tail, client->tail + 1, __ATOMIC_RELEASE);
+    }
+    __atomic_store_n(&push->publishing, 0, __ATOMIC_SEQ_CST);
+    sysmon_push_frame_release(frame);
+}
+
+void sysmon_push_frame_release(sysmon_push_frame_t *frame)
+{
+    if (frame != NULL && __atomic_sub_fetch(&frame->refs, 1, __ATOMIC_ACQ_REL) == 0)
+    {
+        free(frame);
+    }
+}
+
+bool sysmon_push_has_clients(const sysmon_push_t *push)
+{
+    return __atomic_load_n(&push->active, __ATOMIC_RELAXED) != 0;
+}
+
+int sysmon_push_attach(sysmon_push_t *push, int fd)
+{
+    for (int i = 0; i < CONFIG_SYSMON_PUSH_MAX_CLIENTS; i++)
+    {
+        sysmon_push_client_t *client = &push->clients[i];
+        if (__atomic_load_n(&client->state, __ATOMIC_ACQUIRE) != SYSMON_PUSH_FREE)
+        {
+            continue;
+        }
+        client->fd = fd;
+        client->head = 0;
+        client->tail = 0;
+        client->offset = 0;
+        client->detached = false;
+        client->frames = 0;
+        client->bytes = 0;
+        __atomic_fetch_add(&push->active, 1, __ATOMIC_RELAXED);
+        __atomic_store_n(&client->state, SYSMON_PUSH_ACTIVE, __ATOMIC_RELEASE);
+        return i;
+    }
+    return -1;
+}
+
+bool sysmon_push_detach(sysmon_push_t *push, int fd)
+{
+    for (int i = 0; i < CONFIG_SYSMON_PUSH_MAX_CLIENTS; i++)
+    {
+        sysmon_push_client_t *client = &push->clients[i];
+        // A detached slot still waiting for its reclaim may carry an fd that was reused since
+        if (__atomic_load_n(&client->state, __ATOMIC_ACQUIRE) == SYSMON_PUSH_FREE || client->fd != fd ||
+            client->detached)
+        {
+            continue;
+        }
+        client->detached = true;
+        _push_close_slot(client);
+        _push_try_reclaim(push, client);
+        return true;
+    }
+    return false;
+}
+
+int sysmon_push_pump(sysmon_push_t *push)
+{
+    int active = 0;
+    for (int i = 0; i < CONFIG_SYSMON_PUSH_MAX_CLIENTS; i++)
+    {
+        sysmon_push_client_t *client = &push->clients[i];
+        uint32_t state = __atomic_load_n(&client->state, __ATOMIC_ACQUIRE);
+        if (state == SYSMON_PUSH_FREE)
+        {
+            continue;
+        }
+        if (state == SYSMON_PUSH_ACTIVE && !client->detached)
+        {
+            _push_send_client(push, client);
+        }
+        _push_try_reclaim(push, client);
+        if (__atomic_load_n(&client->state, __ATOMIC_RELAXED) == SYSMON_PUSH_ACTIVE)
+        {
+            active++;
+        }
+    }
+    return active;
+}
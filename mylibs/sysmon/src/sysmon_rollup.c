@@ -0,0 +1,308 @@
+/**
+ * @file sysmon_rollup.c
+ * @brief Multi-resolution time series of the sysmon sampler (min/avg/max rollups).
+ *
+ * Block layout, per tier (finest first):
+ *   system rows : CONFIG_SYSMON_ROLLUP_BUCKETS x SYSMON_ROLLUP_SYS_METRICS x fields
+ *   task rows   : CONFIG_SYSMON_ROLLUP_BUCKETS x capacity x SYSMON_ROLLUP_TASK_METRICS x fields
+ *
+ * Accumulators, per tier: SYSMON_ROLLUP_SYS_METRICS entries, then capacity x
+ * SYSMON_ROLLUP_TASK_METRICS entries. The first value put into an open bucket (pending == 0)
+ * resets its accumulator, so closing a bucket never has to clear anything.
+ */
+
+// Project-specific includes
+#include "sysmon_rollup.h"
+
+// ESP-IDF includes
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+
+// System includes
+#include <stdlib.h>
+#include <string.h>
+
+// Logger tag for this module
+static const char *LOG_TAG = "sysmon_rollup";
+
+// ============================================================================
+// Internal Helper Functions
+// ============================================================================
+
+/**
+ * @brief Values stored per series and bucket for a tier of `width` samples.
+ */
+static uint8_t _fields_for_width(uint16_t width)
+{
+    return (width == 1) ? 1 : 3;
+}
+
+/**
+ * @brief Values (uint16) of the system rows and of the task rows of one tier.
+ */
+static size_t _tier_system_values(const sysmon_rollup_tier_t *tier)
+{
+    return (size_t)CONFIG_SYSMON_ROLLUP_BUCKETS * SYSMON_ROLLUP_SYS_METRICS * tier->fields;
+}
+
+static size_t _tier_task_values(const sysmon_rollup_tier_t *tier, int capacity)
+{
+    return (size_t)CONFIG_SYSMON_ROLLUP_BUCKETS * (size_t)capacity * SYSMON_ROLLUP_TASK_METRICS * tier->fields;
+}
+
+/**
+ * @brief Accumulators of one tier.
+ */
+static size_t _acc_per_tier(int capacity)
+{
+    return SYSMON_ROLLUP_SYS_METRICS + (size_t)capacity * SYSMON_ROLLUP_TASK_METRICS;
+}
+
+/**
+ * @brief Point tier->system / tier->tasks into `block`.
+ */
+static void _assign_rows(sysmon_rollup_t *rollup, uint16_t *block, int capacity)
+{
+    uint16_t *at = block;
+    for (int t = 0; t < SYSMON_ROLLUP_TIERS; t++)
+    {
+        sysmon_rollup_tier_t *tier = &rollup->tier[t];
+        tier->system = at;
+        at += _tier_system_values(tier);
+        tier->tasks = at;
+        at += _tier_task_values(tier, capacity);
+    }
+}
+
+/**
+ * @brief Fold `value` into an accumulator of a tier whose open bucket holds `pending` samples.
+ */
+static inline void _acc_put(sysmon_rollup_acc_t *acc, uint16_t pending, uint16_t value)
+{
+    if (pending == 0)
+    {
+        acc->sum = value;
+        acc->min = value;
+        acc->max = value;
+        return;
+    }
+    acc->sum += value;
+    if (value < acc->min)
+    {
+        acc->min = value;
+    }
+    if (value > acc->max)
+    {
+        acc->max = value;
+    }
+}
+
+/**
+ * @brief Write a closed accumulator (min, rounded avg, max) to `out` (fields values).
+ */
+static inline void _acc_store(uint16_t *out, const sysmon_rollup_acc_t *acc, uint16_t count, uint8_t fields)
+{
+    uint16_t avg = (uint16_t)((acc->sum + count / 2U) / count);
+    if (fields == 1)
+    {
+        out[0] = avg;
+        return;
+    }
+    out[SYSMON_ROLLUP_MIN] = acc->min;
+    out[SYSMON_ROLLUP_AVG] = avg;
+    out[SYSMON_ROLLUP_MAX] = acc->max;
+}
+
+// ============================================================================
+// Public API Functions
+// ============================================================================
+
+size_t sysmon_rollup_block_bytes(int capacity)
+{
+    sysmon_rollup_t rollup;
+    sysmon_rollup_init(&rollup);
+    size_t values = 0;
+    for (int t = 0; t < SYSMON_ROLLUP_TIERS; t++)
+    {
+        values += _tier_system_values(&rollup.tier[t]) + _tier_task_values(&rollup.tier[t], capacity);
+    }
+    return values * sizeof(uint16_t);
+}
+
+size_t sysmon_rollup_acc_bytes(int capacity)
+{
+    return SYSMON_ROLLUP_TIERS * _acc_per_tier(capacity) * sizeof(sysmon_rollup_acc_t);
+}
+
+void sysmon_rollup_init(sysmon_rollup_t *rollup)
+{
+    static const uint16_t widths[SYSMON_ROLLUP_TIERS] =
+    {
+        1, CONFIG_SYSMON_ROLLUP_TIER1_SAMPLES, CONFIG_SYSMON_ROLLUP_TIER2_SAMPLES
+    };
+    memset(rollup, 0, sizeof(sysmon_rollup_t));
+    for (int t = 0; t < SYSMON_ROLLUP_TIERS; t++)
+    {
+        rollup->tier[t].width = widths[t];
+        rollup->tier[t].fields = _fields_for_width(widths[t]);
+    }
+}
+
+esp_err_t sysmon_rollup_resize(sysmon_rollup_t *rollup, int capacity, void **old_block)
+{
+    *old_block = NULL;
+    int old_capacity = (rollup->block != NULL) ? rollup->capacity : 0;
+    if (capacity <= old_capacity && rollup->block != NULL)
+    {
+        return ESP_OK;
+    }
+    if (rollup->tier[0].width == 0)
+    {
+        sysmon_rollup_init(rollup);
+    }
+
+    // Rows are read by the HTTP snapshots only: PSRAM is fast enough and saves internal RAM
+    size_t block_bytes = sysmon_rollup_block_bytes(capacity);
+    uint16_t *block = (uint16_t *)heap_caps_calloc_prefer(1, block_bytes, 2,
+                                                          MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT,
+                                                          MALLOC_CAP_DEFAULT);
+    sysmon_rollup_acc_t *acc = (sysmon_rollup_acc_t *)calloc(SYSMON_ROLLUP_TIERS * _acc_per_tier(capacity),
+                                                             sizeof(sysmon_rollup_acc_t));
+    if (block == NULL || acc == NULL)
+    {
+        free(block);
+        free(acc);
+        ESP_LOGE(LOG_TAG, "Failed to allocate rollups for %d tasks (%u bytes)", capacity, (unsigned)block_bytes);
+        return ESP_ERR_NO_MEM;
+    }
+
+    // Existing columns keep their slot: copy every row into the wider rows
+    if (rollup->block != NULL)
+    {
+        sysmon_rollup_t grown = *rollup;
+        _assign_rows(&grown, block, capacity);
+        for (int t = 0; t < SYSMON_ROLLUP_TIERS; t++)
+        {
+            const sysmon_rollup_tier_t *tier = &rollup->tier[t];
+            memcpy(grown.tier[t].system, tier->system, _tier_system_values(tier) * sizeof(uint16_t));
+            size_t old_row = (size_t)old_capacity * SYSMON_ROLLUP_TASK_METRICS * tier->fields;
+            size_t new_row = (size_t)capacity * SYSMON_ROLLUP_TASK_METRICS * tier->fields;
+            for (int b = 0; b < CONFIG_SYSMON_ROLLUP_BUCKETS; b++)
+            {
+                memcpy(&grown.tier[t].tasks[(size_t)b * new_row], &tier->tasks[(size_t)b * old_row], old_row * sizeof(uint16_t));
+            }
+            memcpy(&acc[(size_t)t * _acc_per_tier(capacity)], &rollup->acc[(size_t)t * _acc_per_tier(old_capacity)],
+                   _acc_per_tier(old_capacity) * sizeof(sysmon_rollup_acc_t));
+        }
+    }
+
+    // Ownership hand-off
+    *old_block = rollup->block;
+    free(rollup->acc);
+    _assign_rows(rollup, block, capacity);
+    rollup->block = block;
+    rollup->acc = acc;
+    rollup->capacity = capacity;
+    ESP_LOGD(LOG_TAG, "Rollups for %d tasks: %u bytes of rows, %u bytes of accumulators", capacity,
+             (unsigned)block_bytes, (unsigned)sysmon_rollup_acc_bytes(capacity));
+    return ESP_OK;
+}
+
+void sysmon_rollup_put_system(sysmon_rollup_t *rollup, const uint16_t *system)
+{
+    if (rollup->acc == NULL)
+    {
+        return;
+    }
+    size_t per_tier = _acc_per_tier(rollup->capacity);
+    for (int t = 0; t < SYSMON_ROLLUP_TIERS; t++)
+    {
+        sysmon_rollup_acc_t *acc = &rollup->acc[(size_t)t * per_tier];
+        uint16_t pending = rollup->tier[t].pending;
+        for (int m = 0; m < SYSMON_ROLLUP_SYS_METRICS; m++)
+        {
+            _acc_put(&acc[m], pending, system[m]);
+        }
+    }
+}
+
+void sysmon_rollup_put_task(sysmon_rollup_t *rollup, int slot, uint16_t cpu, uint16_t stack)
+{
+    if (rollup->acc == NULL || slot < 0 || slot >= rollup->capacity)
+    {
+        return;
+    }
+    size_t per_tier = _acc_per_tier(rollup->capacity);
+    size_t column = SYSMON_ROLLUP_SYS_METRICS + (size_t)slot * SYSMON_ROLLUP_TASK_METRICS;
+    for (int t = 0; t < SYSMON_ROLLUP_TIERS; t++)
+    {
+        sysmon_rollup_acc_t *acc = &rollup->acc[(size_t)t * per_tier + column];
+        uint16_t pending = rollup->tier[t].pending;
+        _acc_put(&acc[SYSMON_ROLLUP_TASK_CPU], pending, cpu);
+        _acc_put(&acc[SYSMON_ROLLUP_TASK_STACK], pending, stack);
+    }
+}
+
+void sysmon_rollup_commit(sysmon_rollup_t *rollup)
+{
+    if (rollup->acc == NULL)
+    {
+        return;
+    }
+    size_t per_tier = _acc_per_tier(rollup->capacity);
+    for (int t = 0; t < SYSMON_ROLLUP_TIERS; t++)
+    {
+        sysmon_rollup_tier_t *tier = &rollup->tier[t];
+        tier->pending++;
+        if (tier->pending < tier->width)
+        {
+            continue;
+        }
+
+        // Close the bucket
+        const sysmon_rollup_acc_t *acc = &rollup->acc[(size_t)t * per_tier];
+        int b = tier->write_index;
+        for (int m = 0; m < SYSMON_ROLLUP_SYS_METRICS; m++)
+        {
+            _acc_store(&tier->system[sysmon_rollup_sys_at(tier, b, m, 0)], &acc[m], tier->pending, tier->fields);
+        }
+        acc += SYSMON_ROLLUP_SYS_METRICS;
+        uint16_t *row = &tier->tasks[sysmon_rollup_task_at(tier, rollup->capacity, b, 0, 0, 0)];
+        size_t columns = (size_t)rollup->capacity * SYSMON_ROLLUP_TASK_METRICS;
+        for (size_t c = 0; c < columns; c++)
+        {
+            _acc_store(&row[c * tier->fields], &acc[c], tier->pending, tier->fields);
+        }
+        tier->write_index = (b + 1) % CONFIG_SYSMON_ROLLUP_BUCKETS;
+        tier->bucket_seq++;
+        tier->pending = 0;
+    }
+}
+
+void sysmon_rollup_clear_slot(sysmon_rollup_t *rollup, int slot)
+{
+    if (rollup->block == NULL || slot < 0 || slot >= rollup->capacity)
+    {
+        return;
+    }
+    size_t per_tier = _acc_per_tier(rollup->capacity);
+    size_t column = SYSMON_ROLLUP_SYS_METRICS + (size_t)slot * SYSMON_ROLLUP_TASK_METRICS;
+    for (int t = 0; t < SYSMON_ROLLUP_TIERS; t++)
+    {
+        sysmon_rollup_tier_t *tier = &rollup->tier[t];
+        size_t cell = SYSMON_ROLLUP_TASK_METRICS * tier->fields;
+        for (int b = 0; b < CONFIG_SYSMON_ROLLUP_BUCKETS; b++)
+        {
+            memset(&tier->tasks[sysmon_rollup_task_at(tier, rollup->capacity, b, slot, 0, 0)], 0, cell * sizeof(uint16_t));
+        }
+        // The samples of the open bucket taken before the task existed count as 0, as in its history row
+        memset(&rollup->acc[(size_t)t * per_tier + column], 0, SYSMON_ROLLUP_TASK_METRICS * sizeof(sysmon_rollup_acc_t));
+    }
+}
+
+void sysmon_rollup_free(sysmon_rollup_t *rollup)
+{
+    free(rollup->block);
+    free(rollup->acc);
+    sysmon_rollup_init(rollup);
+}
@@ -0,0 +1,137 @@
+/**
+ * @file sysmon_sched.c
+ * @brief /sched document: per-task scheduling totals from the context switch trace.
+ *
+ * The trace rows are copied into a buffer allocated per request (the table grows and shrinks
+ * with the tasks), then encoded. The copy is taken under the trace's own mutex, which also
+ * drains the per-core rings, so the document is current to within a few tens of microseconds.
+ */
+
+// Project-specific includes
+#include "sysmon_sched.h"
+#include "sysmon_stream.h"
+#include "sysmon.h"
+#include "task_trace.h"
+
+// ESP-IDF includes
+#include "esp_log.h"
+
+// System includes
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+// Logger tag for this module
+static const char *LOG_TAG = "sysmon_sched";
+
+#define SCHED_ROWS_SPARE 8  // Rows beyond the current task count, for tasks created in between
+
+// ============================================================================
+// Internal Helper Functions
+// ============================================================================
+
+/**
+ * @brief Write the per-core totals as an array of maps.
+ */
+static void _stream_cores(sysmon_stream_t *stream, const task_trace_summary_t *summary)
+{
+    sysmon_stream_key(stream, "cores");
+    sysmon_stream_array_begin(stream);
+    for (uint32_t core = 0; core < summary->core_count; core++)
+    {
+        const task_trace_core_t *c = &summary->cores[core];
+        sysmon_stream_map_begin(stream);
+        sysmon_stream_key(stream, "elapsedUs");
+        sysmon_stream_uint(stream, c->elapsed_us);
+        sysmon_stream_key(stream, "busyUs");
+        sysmon_stream_uint(stream, c->busy_us);
+        sysmon_stream_key(stream, "unknownUs");
+        sysmon_stream_uint(stream, c->unknown_us);
+        sysmon_stream_key(stream, "switches");
+        sysmon_stream_uint(stream, c->switches);
+        sysmon_stream_key(stream, "lost");
+        sysmon_stream_uint(stream, c->lost);
+        sysmon_stream_map_end(stream);
+    }
+    sysmon_stream_array_end(stream);
+}
+
+/**
+ * @brief Write the per-task totals as an array of maps.
+ */
+static void _stream_tasks(sysmon_stream_t *stream, const task_trace_task_t *rows, uint32_t count)
+{
+    sysmon_stream_key(stream, "tasks");
+    sysmon_stream_array_begin(stream);
+    for (uint32_t i = 0; i < count; i++)
+    {
+        const task_trace_task_t *t = &rows[i];
+        sysmon_stream_map_begin(stream);
+        sysmon_stream_key(stream, "name");
+        sysmon_stream_string(stream, t->name);
+        sysmon_stream_key(stream, "handle");
+        sysmon_stream_uint(stream, t->task);
+        sysmon_stream_key(stream, "generation");
+        sysmon_stream_uint(stream, t->generation);
+        sysmon_stream_key(stream, "core");
+        sysmon_stream_int(stream, t->core);
+        sysmon_stream_key(stream, "runUs");
+        sysmon_stream_uint(stream, t->run_us);
+        sysmon_stream_key(stream, "switches");
+        sysmon_stream_uint(stream, t->switches);
+        sysmon_stream_key(stream, "preemptions");
+        sysmon_stream_uint(stream, t->preemptions);
+        sysmon_stream_key(stream, "wakeups");
+        sysmon_stream_uint(stream, t->wakeups);
+        sysmon_stream_key(stream, "latencySumUs");
+        sysmon_stream_uint(stream, t->latency_sum_us);
+        sysmon_stream_key(stream, "latencyMaxUs");
+        sysmon_stream_uint(stream, t->latency_max_us);
+        sysmon_stream_map_end(stream);
+    }
+    sysmon_stream_array_end(stream);
+}
+
+// ============================================================================
+// Public API Functions
+// ============================================================================
+
+esp_err_t sysmon_stream_sched(sysmon_stream_t *stream, const SysMonState *state, const sysmon_stream_query_t *query)
+{
+    (void)state;
+    (void)query;
+
+    task_trace_summary_t summary;
+    task_trace_task_t *rows = NULL;
+    uint32_t count = 0;
+    bool enabled = task_trace_is_running();
+    if (enabled)
+    {
+        task_trace_snapshot(NULL, 0, &summary);
+        uint32_t capacity = summary.task_count + SCHED_ROWS_SPARE;
+        rows = (task_trace_task_t *)malloc(capacity * sizeof(task_trace_task_t));
+        if (rows == NULL)
+        {
+            ESP_LOGE(LOG_TAG, "no memory for %u trace rows", (unsigned)capacity);
+            return ESP_ERR_NO_MEM;
+        }
+        count = task_trace_snapshot(rows, capacity, &summary);
+    }
+
+    sysmon_stream_map_begin(stream);
+    sysmon_stream_key(stream, "enabled");
+    sysmon_stream_bool(stream, enabled);
+    if (enabled)
+    {
+        sysmon_stream_key(stream, "now");
+        sysmon_stream_uint(stream, summary.now);
+        sysmon_stream_key(stream, "untracked");
+        sysmon_stream_uint(stream, summary.untracked);
+        _stream_cores(stream, &summary);
+        _stream_tasks(stream, rows, count);
+    }
+    sysmon_stream_map_end(stream);
+
+    free(rows);
+    return stream->error;
+}
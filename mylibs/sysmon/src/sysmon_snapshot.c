@@ -0,0 +1,315 @@
+/**
+ * @file sysmon_snapshot.c
+ * @brief Seqlock between the sysmon sampler and the HTTP handlers.
+ *
+ * Writer (sysmon_monitor, one task):
+ *   s_seq odd -> change `self` -> s_seq even -> free retired arrays if s_readers == 0
+ *
+ * Reader (httpd task):
+ *   s_readers++ -> read s_seq -> copy -> read s_seq again -> s_readers--
+ *   The copy is valid if both reads return the same even value; otherwise it is retried.
+ *
+ * s_readers is raised before the first read of s_seq, so a writer that sees s_readers == 0
+ * after publishing knows that any later reader loads the new pointers: retired arrays can go.
+ */
+
+// Project-specific includes
+#include "sysmon_snapshot.h"
+
+// ESP-IDF includes
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+// System includes
+#include <stdlib.h>
+#include <string.h>
+
+// Logger tag for this module
+static const char *LOG_TAG = "sysmon_snapshot";
+
+// Arrays a resize can retire before they are freed (task table, 3 history series and the rollup rows, twice)
+#define SYSMON_SNAPSHOT_RETIRE_SLOTS 10
+
+static uint32_t s_seq = 0;      // Odd while the sampler is changing `self`
+static uint32_t s_readers = 0;  // Readers copying right now
+static void *s_retired[SYSMON_SNAPSHOT_RETIRE_SLOTS];
+static int s_retired_count = 0;
+
+// ============================================================================
+// Internal Helper Functions
+// ============================================================================
+
+/**
+ * @brief Free the retired arrays (writer side, no reader copying).
+ */
+static void _free_retired(void)
+{
+    for (int i = 0; i < s_retired_count; i++)
+    {
+        free(s_retired[i]);
+        s_retired[i] = NULL;
+    }
+    s_retired_count = 0;
+}
+
+/**
+ * @brief Values (uint16) of the system rows and of the task rows of a rollup tier for `capacity` slots.
+ */
+static size_t _tier_system_values(const sysmon_rollup_tier_t *tier)
+{
+    return sysmon_rollup_sys_at(tier, CONFIG_SYSMON_ROLLUP_BUCKETS, 0, 0);
+}
+
+static size_t _tier_task_values(const sysmon_rollup_tier_t *tier, int capacity)
+{
+    return sysmon_rollup_task_at(tier, capacity, CONFIG_SYSMON_ROLLUP_BUCKETS, 0, 0, 0);
+}
+
+/**
+ * @brief Allocate the reader-owned task table, `rows` history rows and, for tier >= 0, the rows of
+ *        that rollup tier for `capacity` slots.
+ */
+static bool _view_alloc(SysMonState *view, int capacity, int rows, int tier)
+{
+    size_t cells = (size_t)(rows > 0 ? rows : 1) * (size_t)capacity;
+    view->tasks = (TaskUsageSample *)malloc((size_t)capacity * sizeof(TaskUsageSample));
+    view->history.usage_percent = (float *)malloc(cells * sizeof(float));
+    view->history.stack_usage_bytes = (uint32_t *)malloc(cells * sizeof(uint32_t));
+    view->history.stack_usage_percent = (float *)malloc(cells * sizeof(float));
+    bool ok = view->tasks != NULL && view->history.usage_percent != NULL &&
+              view->history.stack_usage_bytes != NULL && view->history.stack_usage_percent != NULL;
+    if (tier >= 0)
+    {
+        // Tier widths only change in sysmon_rollup_init(), before the first sample
+        const sysmon_rollup_tier_t *source = &self.rollup.tier[tier];
+        size_t values = _tier_system_values(source) + _tier_task_values(source, capacity);
+        view->rollup.block = (uint16_t *)heap_caps_malloc_prefer(values * sizeof(uint16_t), 2,
+                                                                 MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT,
+                                                                 MALLOC_CAP_DEFAULT);
+        ok = ok && view->rollup.block != NULL;
+    }
+    return ok;
+}
+
+/**
+ * @brief Copy rollup tier `tier` of `self` into the reader buffer view->rollup.block (inside the read section).
+ *
+ * Only that tier is readable in the view; the other tiers keep their counters but no rows.
+ */
+static bool _view_copy_tier(SysMonState *view, const sysmon_rollup_t *source, int tier)
+{
+    uint16_t *block = view->rollup.block;
+    view->rollup = *source;
+    view->rollup.block = block;
+    view->rollup.acc = NULL;
+    for (int t = 0; t < SYSMON_ROLLUP_TIERS; t++)
+    {
+        view->rollup.tier[t].system = NULL;
+        view->rollup.tier[t].tasks = NULL;
+    }
+    if (tier < 0)
+    {
+        return true;
+    }
+    const sysmon_rollup_tier_t *from = &source->tier[tier];
+    if (source->block == NULL || from->system == NULL || source->capacity != view->task_capacity)
+    {
+        view->rollup.capacity = 0;
+        return source->block == NULL;
+    }
+    size_t system_values = _tier_system_values(from);
+    sysmon_rollup_tier_t *to = &view->rollup.tier[tier];
+    to->system = block;
+    to->tasks = block + system_values;
+    memcpy(to->system, from->system, system_values * sizeof(uint16_t));
+    memcpy(to->tasks, from->tasks, _tier_task_values(from, source->capacity) * sizeof(uint16_t));
+    return true;
+}
+
+/**
+ * @brief Copy `self` into `view` (inside the seqlock read section).
+ *
+ * @param tier Rollup tier to copy, -1 for none.
+ * @param buffer_capacity Slots the view buffers were allocated for.
+ * @param begin Sequence number read when the read section started.
+ * @return false if `self` changed while its members were copied or the table grew past
+ *         buffer_capacity since the buffers were allocated.
+ */
+static bool _view_copy(SysMonState *view, int rows, int tier, int buffer_capacity, uint32_t begin)
+{
+    TaskUsageSample *tasks = view->tasks;
+    TaskHistory history = view->history;
+    sysmon_rollup_t rollup = view->rollup;
+
+    memcpy(view, &self, sizeof(SysMonState));
+    // Array pointers and capacities must come from one publication before they are followed:
+    // a replaced array stays readable until the reader leaves (retired), but it may be smaller
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    bool members_valid = __atomic_load_n(&s_seq, __ATOMIC_RELAXED) == begin;
+    const TaskUsageSample *src_tasks = view->tasks;
+    TaskHistory src_history = view->history;
+    sysmon_rollup_t src_rollup = view->rollup;
+    int capacity = view->task_capacity;
+
+    // Sampler-only members
+    view->tasks = tasks;
+    view->history = history;
+    view->rollup = rollup;
+    view->httpd = NULL;
+    view->task_status = NULL;
+    memset(&view->task_index, 0, sizeof(view->task_index));
+    view->free_slot = -1;
+
+    if (!members_valid || capacity > buffer_capacity || view->series_write_index < 0 ||
+        view->series_write_index >= CONFIG_SYSMON_SAMPLE_COUNT)
+    {
+        return false;
+    }
+    if (src_tasks == NULL || capacity <= 0)
+    {
+        view->task_capacity = 0;
+        return _view_copy_tier(view, &src_rollup, -1);
+    }
+
+    // The newest `rows` ring positions, oldest first, become rows 0..rows-1 of the view
+    memcpy(view->tasks, src_tasks, (size_t)capacity * sizeof(TaskUsageSample));
+    view->history_first_row = (view->series_write_index - rows + CONFIG_SYSMON_SAMPLE_COUNT) % CONFIG_SYSMON_SAMPLE_COUNT;
+    size_t row_cells = (size_t)capacity;
+    for (int r = 0; r < rows; r++)
+    {
+        size_t from = (size_t)((view->history_first_row + r) % CONFIG_SYSMON_SAMPLE_COUNT) * row_cells;
+        size_t to = (size_t)r * row_cells;
+        memcpy(&view->history.usage_percent[to], &src_history.usage_percent[from], row_cells * sizeof(float));
+        memcpy(&view->history.stack_usage_bytes[to], &src_history.stack_usage_bytes[from], row_cells * sizeof(uint32_t));
+        memcpy(&view->history.stack_usage_percent[to], &src_history.stack_usage_percent[from], row_cells * sizeof(float));
+    }
+    return _view_copy_tier(view, &src_rollup, tier);
+}
+
+/**
+ * @brief sysmon_snapshot_take() / sysmon_snapshot_take_rollup(): `tier` < 0 copies no rollup rows.
+ */
+static esp_err_t _snapshot_take(SysMonState *view, int rows, int tier)
+{
+    memset(view, 0, sizeof(SysMonState));
+    if (rows < 0)
+    {
+        rows = 0;
+    }
+    if (rows > CONFIG_SYSMON_SAMPLE_COUNT)
+    {
+        rows = CONFIG_SYSMON_SAMPLE_COUNT;
+    }
+
+    int buffer_capacity = 0;
+    for (int attempt = 0; attempt < SYSMON_SNAPSHOT_MAX_ATTEMPTS; attempt++)
+    {
+        // Buffers are allocated outside the read section (the table only grows)
+        int capacity = __atomic_load_n(&self.task_capacity, __ATOMIC_RELAXED);
+        if (capacity > buffer_capacity)
+        {
+            sysmon_snapshot_release(view);
+            if (!_view_alloc(view, capacity, rows, tier))
+            {
+                sysmon_snapshot_release(view);
+                ESP_LOGE(LOG_TAG, "Failed to allocate a snapshot for %d tasks", capacity);
+                return ESP_ERR_NO_MEM;
+            }
+            buffer_capacity = capacity;
+        }
+
+        __atomic_fetch_add(&s_readers, 1, __ATOMIC_SEQ_CST);
+        uint32_t begin = __atomic_load_n(&s_seq, __ATOMIC_SEQ_CST);
+        bool copied = ((begin & 1U) == 0U) && _view_copy(view, rows, tier, buffer_capacity, begin);
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        uint32_t end = __atomic_load_n(&s_seq, __ATOMIC_RELAXED);
+        __atomic_fetch_sub(&s_readers, 1, __ATOMIC_SEQ_CST);
+
+        if (copied && begin == end)
+        {
+            return ESP_OK;
+        }
+        if ((begin & 1U) != 0U)
+        {
+            vTaskDelay(1);  // Let the sampler finish (it may run on this core at a lower priority)
+        }
+    }
+
+    sysmon_snapshot_release(view);
+    ESP_LOGW(LOG_TAG, "No consistent snapshot after %d attempts", SYSMON_SNAPSHOT_MAX_ATTEMPTS);
+    return ESP_ERR_TIMEOUT;
+}
+
+// ============================================================================
+// Public API Functions
+// ============================================================================
+
+void sysmon_snapshot_write_begin(void)
+{
+    __atomic_store_n(&s_seq, s_seq + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+}
+
+void sysmon_snapshot_write_end(void)
+{
+    __atomic_store_n(&s_seq, s_seq + 1, __ATOMIC_SEQ_CST);
+    if (s_retired_count > 0 && __atomic_load_n(&s_readers, __ATOMIC_SEQ_CST) == 0)
+    {
+        _free_retired();
+    }
+}
+
+bool sysmon_snapshot_retire(void *ptr)
+{
+    if (ptr == NULL)
+    {
+        return true;
+    }
+    if (s_retired_count >= SYSMON_SNAPSHOT_RETIRE_SLOTS)
+    {
+        return false;
+    }
+    s_retired[s_retired_count++] = ptr;
+    return true;
+}
+
+int sysmon_snapshot_retire_room(void)
+{
+    return SYSMON_SNAPSHOT_RETIRE_SLOTS - s_retired_count;
+}
+
+esp_err_t sysmon_snapshot_take(SysMonState *view, int rows)
+{
+    return _snapshot_take(view, rows, -1);
+}
+
+esp_err_t sysmon_snapshot_take_rollup(SysMonState *view, int tier)
+{
+    if (tier < 0 || tier >= SYSMON_ROLLUP_TIERS)
+    {
+        memset(view, 0, sizeof(SysMonState));
+        return ESP_ERR_INVALID_ARG;
+    }
+    return _snapshot_take(view, 1, tier);
+}
+
+void sysmon_snapshot_release(SysMonState *view)
+{
+    free(view->tasks);
+    free(view->history.usage_percent);
+    free(view->history.stack_usage_bytes);
+    free(view->history.stack_usage_percent);
+    free(view->rollup.block);
+    view->tasks = NULL;
+    memset(&view->history, 0, sizeof(view->history));
+    memset(&view->rollup, 0, sizeof(view->rollup));
+    view->task_capacity = 0;
+}
+
+void sysmon_snapshot_cleanup(void)
+{
+    _free_retired();
+    s_seq = 0;  // The sampler may have been deleted inside a write section
+}
@@ -9,6 +9,7 @@
 // Project-specific includes
 #include "sysmon_stack.h"
 #include "sysmon.h"
+#include "sysmon_index.h"
 
 // ESP-IDF includes
 #include "esp_log.h"
@@ -22,16 +23,51 @@
 // Logger tag for this module
 static const char *LOG_TAG = "sysmon_stack";
 
-typedef struct
+// Registered stack sizes: task handle -> depth in bytes (hash index, O(1) lookup per task and sample)
+static sysmon_index_t s_stack_records = { 0 };
+static portMUX_TYPE s_stack_records_lock = portMUX_INITIALIZER_UNLOCKED;
+
+/**
+ * @brief Grow the registry so one more handle fits.
+ *
+ * The new table is allocated and the old one freed outside the critical section;
+ * only the rehash (no allocation) runs with the lock held.
+ *
+ * @param required_capacity Minimum number of handles the registry should hold.
+ * @return true if one more handle fits, false on allocation failure.
+ */
+static bool _stack_records_reserve(int required_capacity)
 {
-    TaskHandle_t handle;
-    uint32_t     depth_bytes;
-    bool         is_valid;
-} TaskStackRecord;
+    portENTER_CRITICAL(&s_stack_records_lock);
+    bool has_room = sysmon_index_has_room(&s_stack_records);
+    uint32_t count = s_stack_records.count;
+    portEXIT_CRITICAL(&s_stack_records_lock);
+    if (has_room)
+    {
+        return true;
+    }
 
-static TaskStackRecord *s_stack_records = NULL;
-static int s_stack_records_capacity = 0;
-static portMUX_TYPE s_stack_records_lock = portMUX_INITIALIZER_UNLOCKED;
+    uint32_t new_capacity = (uint32_t)required_capacity;
+    if (new_capacity < (count + 1) * 2)
+    {
+        new_capacity = (count + 1) * 2;
+    }
+    sysmon_index_t bigger;
+    if (sysmon_index_init(&bigger, new_capacity) != ESP_OK)
+    {
+        ESP_LOGE(LOG_TAG, "Failed to allocate stack records (capacity: %lu)", (unsigned long)new_capacity);
+        return false;
+    }
+
+    portENTER_CRITICAL(&s_stack_records_lock);
+    sysmon_index_t old = s_stack_records;
+    sysmon_index_rehash(&bigger, &old);
+    s_stack_records = bigger;
+    portEXIT_CRITICAL(&s_stack_records_lock);
+
+    sysmon_index_free(&old);
+    return true;
+}
 
 /**
  * @brief Register a task's stack size for accurate monitoring.
@@ -66,62 +102,26 @@ void sysmon_stack_register(TaskHandle_t task_handle, uint32_t stack_size_bytes)
         task_name = "unknown";
     }
 
-    // Store or update the stack record
-    portENTER_CRITICAL(&s_stack_records_lock);
-    
     // Determine required capacity (use task_capacity if set, otherwise use a reasonable initial size)
     int required_capacity = (self.task_capacity > 0) ? self.task_capacity : 32;
-    
-    // Ensure capacity matches task capacity (grow if needed)
-    if (s_stack_records_capacity < required_capacity)
-    {
-        int new_capacity = required_capacity;
-        TaskStackRecord *new_records = (TaskStackRecord *)calloc(new_capacity, sizeof(TaskStackRecord));
-        if (new_records == NULL)
-        {
-            portEXIT_CRITICAL(&s_stack_records_lock);
-            ESP_LOGE(LOG_TAG, "Failed to allocate stack records (capacity: %d)", new_capacity);
-            return;
-        }
-        
-        // Copy existing records
-        if (s_stack_records != NULL)
-        {
-            memcpy(new_records, s_stack_records, s_stack_records_capacity * sizeof(TaskStackRecord));
-            free(s_stack_records);
-        }
-        
-        s_stack_records = new_records;
-        s_stack_records_capacity = new_capacity;
-    }
-    
-    // Update existing record
-    for (int i = 0; i < s_stack_records_capacity; i++)
+    if (!_stack_records_reserve(required_capacity))
     {
-        if (s_stack_records[i].is_valid && s_stack_records[i].handle == task_handle)
-        {
-            s_stack_records[i].depth_bytes = stack_size_bytes;
-            portEXIT_CRITICAL(&s_stack_records_lock);
-            ESP_LOGI(LOG_TAG, "Updated stack size for task '%s': %lu bytes", 
-                     task_name, (unsigned long)stack_size_bytes);
-            return;
-        }
+        return;
     }
 
-    // Create new record
-    for (int i = 0; i < s_stack_records_capacity; i++)
+    // Store or update the stack record
+    portENTER_CRITICAL(&s_stack_records_lock);
+    uint32_t previous = 0U;
+    bool updated = sysmon_index_find(&s_stack_records, (uintptr_t)task_handle, &previous);
+    esp_err_t err = sysmon_index_put(&s_stack_records, (uintptr_t)task_handle, stack_size_bytes);
+    portEXIT_CRITICAL(&s_stack_records_lock);
+
+    if (err != ESP_OK)
     {
-        if (!s_stack_records[i].is_valid)
-        {
-            s_stack_records[i].handle      = task_handle;
-            s_stack_records[i].depth_bytes = stack_size_bytes;
-            s_stack_records[i].is_valid    = true;
-            break;
-        }
+        ESP_LOGE(LOG_TAG, "Failed to store stack size for task '%s': %s", task_name, esp_err_to_name(err));
+        return;
     }
-    
-    portEXIT_CRITICAL(&s_stack_records_lock);
-    ESP_LOGI(LOG_TAG, "Registered stack size for task '%s': %lu bytes", 
+    ESP_LOGI(LOG_TAG, "%s stack size for task '%s': %lu bytes", updated ? "Updated" : "Registered",
              task_name, (unsigned long)stack_size_bytes);
 }
 
@@ -140,22 +140,12 @@ bool sysmon_stack_get_size(TaskHandle_t task_handle, uint32_t *stack_size_bytes)
     }
 
     portENTER_CRITICAL(&s_stack_records_lock);
-    if (s_stack_records != NULL)
-    {
-        for (int i = 0; i < s_stack_records_capacity; i++)
-        {
-            if (s_stack_records[i].is_valid && s_stack_records[i].handle == task_handle)
-            {
-                *stack_size_bytes = s_stack_records[i].depth_bytes;
-                portEXIT_CRITICAL(&s_stack_records_lock);
-                return true;
-            }
-        }
-    }
+    uint32_t depth_bytes = 0U;
+    bool found = sysmon_index_find(&s_stack_records, (uintptr_t)task_handle, &depth_bytes);
     portEXIT_CRITICAL(&s_stack_records_lock);
-    
-    *stack_size_bytes = 0;
-    return false;
+
+    *stack_size_bytes = found ? depth_bytes : 0U;
+    return found;
 }
 
 /**
@@ -164,12 +154,8 @@ bool sysmon_stack_get_size(TaskHandle_t task_handle, uint32_t *stack_size_bytes)
 void sysmon_stack_cleanup(void)
 {
     portENTER_CRITICAL(&s_stack_records_lock);
-    if (s_stack_records != NULL)
-    {
-        free(s_stack_records);
-        s_stack_records = NULL;
-        s_stack_records_capacity = 0;
-    }
+    sysmon_index_t old = s_stack_records;
+    memset(&s_stack_records, 0, sizeof(s_stack_records));
     portEXIT_CRITICAL(&s_stack_records_lock);
+    sysmon_index_free(&old);
 }
-
@@ -0,0 +1,764 @@
+/**
+ * @file sysmon_stream.c
+ * @brief Streaming JSON/CBOR encoder for the sysmon HTTP endpoints.
+ *
+ * Replaces the cJSON tree + cJSON_Print path for /tasks, /history and /telemetry, and
+ * encodes /rollup.
+ * Every value goes straight into a SYSMON_STREAM_CHUNK_SIZE buffer, which is handed to
+ * the write callback (httpd_resp_send_chunk) whenever it fills up. The documents read a
+ * view copied by sysmon_snapshot_take() (or _take_rollup()), never `self`, so a slow client cannot see a
+ * sample change halfway through a response. Besides that view, peak memory per request
+ * is the sysmon_stream_t on the httpd task stack, whatever the task count.
+ *
+ * Numbers are written as fixed-point text (no printf, no double formatting), using the
+ * same rounding as the legacy builders in sysmon_json.c.
+ */
+
+// Project-specific includes
+#include "sysmon_stream.h"
+#include "sysmon.h"
+#include "sysmon_utils.h"
+
+// ESP-IDF includes
+#include "freertos/task.h"
+
+// System includes
+#include <math.h>
+#include <string.h>
+
+// CBOR major types (RFC 8949, section 3.1)
+#define CBOR_MAJOR_UINT   0
+#define CBOR_MAJOR_NINT   1
+#define CBOR_MAJOR_TEXT   3
+#define CBOR_MAJOR_ARRAY  4
+#define CBOR_MAJOR_MAP    5
+#define CBOR_INDEFINITE   0x1F
+#define CBOR_BREAK        0xFF
+#define CBOR_FALSE        0xF4
+#define CBOR_TRUE         0xF5
+#define CBOR_NULL         0xF6
+#define CBOR_FLOAT32      0xFA
+
+static const uint32_t s_pow10[] = { 1, 10, 100, 1000 };
+
+// ============================================================================
+// Output buffer
+// ============================================================================
+
+/**
+ * @brief Hand the buffered bytes to the sink, remember the first error.
+ */
+static void _stream_flush(sysmon_stream_t *stream)
+{
+    if (stream->length == 0 || stream->error != ESP_OK)
+    {
+        stream->length = 0;
+        return;
+    }
+    esp_err_t err = stream->write(stream->ctx, stream->buffer, stream->length);
+    if (err != ESP_OK)
+    {
+        stream->error = err;
+    }
+    stream->total_bytes += stream->length;
+    stream->length = 0;
+}
+
+/**
+ * @brief Append bytes, flushing every time the buffer fills up.
+ */
+static void _stream_put(sysmon_stream_t *stream, const void *data, size_t len)
+{
+    const char *src = (const char *)data;
+    while (len > 0 && stream->error == ESP_OK)
+    {
+        size_t room = SYSMON_STREAM_CHUNK_SIZE - stream->length;
+        size_t n = (len < room) ? len : room;
+        memcpy(&stream->buffer[stream->length], src, n);
+        stream->length += n;
+        src += n;
+        len -= n;
+        if (stream->length == SYSMON_STREAM_CHUNK_SIZE)
+        {
+            _stream_flush(stream);
+        }
+    }
+}
+
+static void _stream_put_char(sysmon_stream_t *stream, char c)
+{
+    _stream_put(stream, &c, 1);
+}
+
+// ============================================================================
+// Encoding helpers
+// ============================================================================
+
+/**
+ * @brief JSON separator before a value: nothing after a key, a comma between elements.
+ */
+static void _json_prefix(sysmon_stream_t *stream)
+{
+    if (stream->after_key)
+    {
+        stream->after_key = false;
+        return;
+    }
+    if (stream->depth > 0)
+    {
+        if (!stream->first[stream->depth - 1])
+        {
+            _stream_put_char(stream, ',');
+        }
+        stream->first[stream->depth - 1] = false;
+    }
+}
+
+/**
+ * @brief CBOR initial byte + argument in the shortest form.
+ */
+static void _cbor_head(sysmon_stream_t *stream, uint8_t major, uint64_t value)
+{
+    uint8_t head[9];
+    size_t n;
+    if (value < 24)
+    {
+        head[0] = (uint8_t)((major << 5) | value);
+        n = 1;
+    }
+    else if (value <= 0xFF)
+    {
+        head[0] = (uint8_t)((major << 5) | 24);
+        head[1] = (uint8_t)value;
+        n = 2;
+    }
+    else if (value <= 0xFFFF)
+    {
+        head[0] = (uint8_t)((major << 5) | 25);
+        head[1] = (uint8_t)(value >> 8);
+        head[2] = (uint8_t)value;
+        n = 3;
+    }
+    else if (value <= 0xFFFFFFFFULL)
+    {
+        head[0] = (uint8_t)((major << 5) | 26);
+        for (int i = 0; i < 4; i++)
+        {
+            head[1 + i] = (uint8_t)(value >> (24 - 8 * i));
+        }
+        n = 5;
+    }
+    else
+    {
+        head[0] = (uint8_t)((major << 5) | 27);
+        for (int i = 0; i < 8; i++)
+        {
+            head[1 + i] = (uint8_t)(value >> (56 - 8 * i));
+        }
+        n = 9;
+    }
+    _stream_put(stream, head, n);
+}
+
+/**
+ * @brief Decimal text of an unsigned value, no printf.
+ */
+static size_t _format_uint(char *out, uint64_t value)
+{
+    char tmp[20];
+    size_t n = 0;
+    do
+    {
+        tmp[n++] = (char)('0' + (value % 10));
+        value /= 10;
+    } while (value > 0);
+    for (size_t i = 0; i < n; i++)
+    {
+        out[i] = tmp[n - 1 - i];
+    }
+    return n;
+}
+
+static void _container_begin(sysmon_stream_t *stream, char json_open, uint8_t cbor_major)
+{
+    if (stream->depth >= SYSMON_STREAM_MAX_DEPTH)
+    {
+        stream->error = ESP_ERR_INVALID_STATE;
+        return;
+    }
+    if (stream->format == SYSMON_STREAM_CBOR)
+    {
+        uint8_t head = (uint8_t)((cbor_major << 5) | CBOR_INDEFINITE);
+        _stream_put(stream, &head, 1);
+    }
+    else
+    {
+        _json_prefix(stream);
+        _stream_put_char(stream, json_open);
+    }
+    stream->first[stream->depth++] = true;
+}
+
+static void _container_end(sysmon_stream_t *stream, char json_close)
+{
+    if (stream->depth == 0)
+    {
+        stream->error = ESP_ERR_INVALID_STATE;
+        return;
+    }
+    stream->depth--;
+    if (stream->format == SYSMON_STREAM_CBOR)
+    {
+        uint8_t brk = CBOR_BREAK;
+        _stream_put(stream, &brk, 1);
+    }
+    else
+    {
+        _stream_put_char(stream, json_close);
+    }
+}
+
+static void _json_string_body(sysmon_stream_t *stream, const char *value)
+{
+    static const char hex[] = "0123456789abcdef";
+    _stream_put_char(stream, '"');
+    for (const char *p = value; *p != '\0'; p++)
+    {
+        unsigned char c = (unsigned char)*p;
+        if (c == '"' || c == '\\')
+        {
+            char esc[2] = { '\\', (char)c };
+            _stream_put(stream, esc, 2);
+        }
+        else if (c < 0x20)
+        {
+            char esc[6] = { '\\', 'u', '0', '0', hex[c >> 4], hex[c & 0xF] };
+            _stream_put(stream, esc, 6);
+        }
+        else
+        {
+            _stream_put_char(stream, (char)c);
+        }
+    }
+    _stream_put_char(stream, '"');
+}
+
+// ============================================================================
+// Public primitives
+// ============================================================================
+
+void sysmon_stream_init(sysmon_stream_t *stream, sysmon_stream_format_t format,
+                        sysmon_stream_write_fn write, void *ctx)
+{
+    memset(stream, 0, sizeof(*stream));
+    stream->format = format;
+    stream->write = write;
+    stream->ctx = ctx;
+    stream->error = ESP_OK;
+}
+
+esp_err_t sysmon_stream_finish(sysmon_stream_t *stream)
+{
+    _stream_flush(stream);
+    return stream->error;
+}
+
+void sysmon_stream_map_begin(sysmon_stream_t *stream)
+{
+    _container_begin(stream, '{', CBOR_MAJOR_MAP);
+}
+
+void sysmon_stream_map_end(sysmon_stream_t *stream)
+{
+    _container_end(stream, '}');
+}
+
+void sysmon_stream_array_begin(sysmon_stream_t *stream)
+{
+    _container_begin(stream, '[', CBOR_MAJOR_ARRAY);
+}
+
+void sysmon_stream_array_end(sysmon_stream_t *stream)
+{
+    _container_end(stream, ']');
+}
+
+void sysmon_stream_key(sysmon_stream_t *stream, const char *key)
+{
+    if (stream->format == SYSMON_STREAM_CBOR)
+    {
+        size_t len = strlen(key);
+        _cbor_head(stream, CBOR_MAJOR_TEXT, len);
+        _stream_put(stream, key, len);
+        return;
+    }
+    _json_prefix(stream);
+    _json_string_body(stream, key);
+    _stream_put_char(stream, ':');
+    stream->after_key = true;
+}
+
+void sysmon_stream_string(sysmon_stream_t *stream, const char *value)
+{
+    if (stream->format == SYSMON_STREAM_CBOR)
+    {
+        size_t len = strlen(value);
+        _cbor_head(stream, CBOR_MAJOR_TEXT, len);
+        _stream_put(stream, value, len);
+        return;
+    }
+    _json_prefix(stream);
+    _json_string_body(stream, value);
+}
+
+void sysmon_stream_uint(sysmon_stream_t *stream, uint64_t value)
+{
+    if (stream->format == SYSMON_STREAM_CBOR)
+    {
+        _cbor_head(stream, CBOR_MAJOR_UINT, value);
+        return;
+    }
+    char text[20];
+    _json_prefix(stream);
+    _stream_put(stream, text, _format_uint(text, value));
+}
+
+void sysmon_stream_int(sysmon_stream_t *stream, int64_t value)
+{
+    if (value >= 0)
+    {
+        sysmon_stream_uint(stream, (uint64_t)value);
+        return;
+    }
+    uint64_t magnitude = (uint64_t)(-(value + 1)) + 1;
+    if (stream->format == SYSMON_STREAM_CBOR)
+    {
+        _cbor_head(stream, CBOR_MAJOR_NINT, magnitude - 1);
+        return;
+    }
+    char text[21];
+    text[0] = '-';
+    _json_prefix(stream);
+    _stream_put(stream, text, 1 + _format_uint(&text[1], magnitude));
+}
+
+void sysmon_stream_bool(sysmon_stream_t *stream, bool value)
+{
+    if (stream->format == SYSMON_STREAM_CBOR)
+    {
+        uint8_t b = value ? CBOR_TRUE : CBOR_FALSE;
+        _stream_put(stream, &b, 1);
+        return;
+    }
+    _json_prefix(stream);
+    _stream_put(stream, value ? "true" : "false", value ? 4 : 5);
+}
+
+void sysmon_stream_null(sysmon_stream_t *stream)
+{
+    if (stream->format == SYSMON_STREAM_CBOR)
+    {
+        uint8_t b = CBOR_NULL;
+        _stream_put(stream, &b, 1);
+        return;
+    }
+    _json_prefix(stream);
+    _stream_put(stream, "null", 4);
+}
+
+void sysmon_stream_fixed(sysmon_stream_t *stream, float value, uint8_t decimals)
+{
+    if (decimals > 3)
+    {
+        decimals = 3;
+    }
+    if (!isfinite(value))
+    {
+        sysmon_stream_null(stream);
+        return;
+    }
+    // Same rounding as round(x * 10^d) / 10^d in sysmon_json.c
+    int64_t scaled = (int64_t)llround((double)value * s_pow10[decimals]);
+    int64_t whole = scaled / (int64_t)s_pow10[decimals];
+    int64_t frac = scaled % (int64_t)s_pow10[decimals];
+    if (frac == 0)
+    {
+        sysmon_stream_int(stream, whole);
+        return;
+    }
+    if (stream->format == SYSMON_STREAM_CBOR)
+    {
+        float rounded = (float)((double)scaled / s_pow10[decimals]);
+        uint32_t bits;
+        memcpy(&bits, &rounded, sizeof(bits));
+        uint8_t out[5] = { CBOR_FLOAT32, (uint8_t)(bits >> 24), (uint8_t)(bits >> 16), (uint8_t)(bits >> 8), (uint8_t)bits };
+        _stream_put(stream, out, sizeof(out));
+        return;
+    }
+
+    // "-0.25": sign, whole part, then the fraction without trailing zeros
+    char text[32];
+    size_t n = 0;
+    if (scaled < 0)
+    {
+        text[n++] = '-';
+        whole = -whole;
+        frac = -frac;
+    }
+    n += _format_uint(&text[n], (uint64_t)whole);
+    text[n++] = '.';
+    for (uint32_t div = s_pow10[decimals] / 10; div > 0 && frac > 0; div /= 10)
+    {
+        text[n++] = (char)('0' + frac / div);
+        frac %= div;
+    }
+    _json_prefix(stream);
+    _stream_put(stream, text, n);
+}
+
+void sysmon_stream_members(sysmon_stream_t *stream, const char *data, size_t len)
+{
+    if (stream->depth == 0 || stream->after_key)
+    {
+        stream->error = ESP_ERR_INVALID_STATE;
+        return;
+    }
+    if (len == 0)
+    {
+        return;
+    }
+    if (stream->format == SYSMON_STREAM_JSON)
+    {
+        _json_prefix(stream);
+    }
+    _stream_put(stream, data, len);
+}
+
+// ============================================================================
+// Documents
+// ============================================================================
+
+/**
+ * @brief Samples to send out of a ring of `capacity` whose newest entry is number `seq`.
+ */
+static void _resolve_ring(sysmon_stream_query_t *query, uint32_t seq, uint32_t capacity)
+{
+    query->seq = seq;
+    query->samples = capacity;
+    if (query->has_since && query->since <= query->seq && (query->seq - query->since) < capacity)
+    {
+        query->samples = query->seq - query->since;
+    }
+}
+
+void sysmon_stream_resolve_query(sysmon_stream_query_t *query, const SysMonState *state)
+{
+    _resolve_ring(query, state->sample_seq, CONFIG_SYSMON_SAMPLE_COUNT);
+}
+
+void sysmon_stream_resolve_rollup_query(sysmon_stream_query_t *query, const SysMonState *state)
+{
+    uint32_t seq = 0;
+    if (query->tier >= 0 && query->tier < SYSMON_ROLLUP_TIERS)
+    {
+        seq = state->rollup.tier[query->tier].bucket_seq;
+    }
+    _resolve_ring(query, seq, CONFIG_SYSMON_ROLLUP_BUCKETS);
+}
+
+/**
+ * @brief Emit "stackRemaining" when the legacy builders did (registered task, nonzero usage).
+ */
+static void _stream_stack_remaining(sysmon_stream_t *stream, const SysMonState *state, const TaskUsageSample *task, size_t at)
+{
+    if (state->history.stack_usage_bytes[at] > 0U && state->history.stack_usage_percent[at] > 0.0f)
+    {
+        sysmon_stream_key(stream, "stackRemaining");
+        sysmon_stream_uint(stream, (uint64_t)task->stack_high_water_mark * sizeof(StackType_t));
+    }
+}
+
+esp_err_t sysmon_stream_tasks(sysmon_stream_t *stream, const SysMonState *state, const sysmon_stream_query_t *query)
+{
+    (void)query;
+    int read_index = _newest_sample_index(state);
+    sysmon_stream_map_begin(stream);
+    for (int i = 0; i < state->task_capacity && state->tasks != NULL; i++)
+    {
+        const TaskUsageSample *task = &state->tasks[i];
+        if (!task->is_active)
+        {
+            continue;
+        }
+        size_t at = _history_at(state, read_index, i);
+        sysmon_stream_key(stream, _get_task_display_name(task->task_name));
+        sysmon_stream_map_begin(stream);
+        sysmon_stream_key(stream, "core");
+        sysmon_stream_int(stream, task->core_id);
+        sysmon_stream_key(stream, "prio");
+        sysmon_stream_uint(stream, task->current_priority);
+        sysmon_stream_key(stream, "stackSize");
+        sysmon_stream_uint(stream, task->stack_size_bytes);
+        sysmon_stream_key(stream, "stackUsed");
+        sysmon_stream_uint(stream, state->history.stack_usage_bytes[at]);
+        sysmon_stream_key(stream, "stackUsedPct");
+        sysmon_stream_fixed(stream, state->history.stack_usage_percent[at], 2);
+        _stream_stack_remaining(stream, state, task, at);
+        sysmon_stream_map_end(stream);
+    }
+    sysmon_stream_map_end(stream);
+    return stream->error;
+}
+
+esp_err_t sysmon_stream_history(sysmon_stream_t *stream, const SysMonState *state, const sysmon_stream_query_t *query)
+{
+    uint32_t samples = query->samples;
+    if (samples > CONFIG_SYSMON_SAMPLE_COUNT)
+    {
+        samples = CONFIG_SYSMON_SAMPLE_COUNT;
+    }
+
+    // Oldest sample to send: `samples` positions behind the write index
+    int first = (state->series_write_index - (int)samples + CONFIG_SYSMON_SAMPLE_COUNT) % CONFIG_SYSMON_SAMPLE_COUNT;
+
+    sysmon_stream_map_begin(stream);
+    for (int i = 0; i < state->task_capacity && state->tasks != NULL; i++)
+    {
+        const TaskUsageSample *task = &state->tasks[i];
+        if (!task->is_active)
+        {
+            continue;
+        }
+
+        sysmon_stream_key(stream, _get_task_display_name(task->task_name));
+        sysmon_stream_map_begin(stream);
+        sysmon_stream_key(stream, "cpu");
+        sysmon_stream_array_begin(stream);
+        for (uint32_t j = 0, idx = first; j < samples; j++, idx = (idx + 1) % CONFIG_SYSMON_SAMPLE_COUNT)
+        {
+            sysmon_stream_fixed(stream, state->history.usage_percent[_history_at(state, idx, i)], 1);
+        }
+        sysmon_stream_array_end(stream);
+        // Stack history only for registered tasks, as in _create_history_json()
+        if (task->stack_size_bytes > 0U)
+        {
+            sysmon_stream_key(stream, "stack");
+            sysmon_stream_array_begin(stream);
+            for (uint32_t j = 0, idx = first; j < samples; j++, idx = (idx + 1) % CONFIG_SYSMON_SAMPLE_COUNT)
+            {
+                sysmon_stream_uint(stream, state->history.stack_usage_bytes[_history_at(state, idx, i)]);
+            }
+            sysmon_stream_array_end(stream);
+        }
+        sysmon_stream_map_end(stream);
+    }
+    sysmon_stream_map_end(stream);
+    return stream->error;
+}
+
+esp_err_t sysmon_stream_telemetry(sysmon_stream_t *stream, const SysMonState *state, const sysmon_stream_query_t *query)
+{
+    (void)query;
+    int read_index = _newest_sample_index(state);
+
+    sysmon_stream_map_begin(stream);
+    sysmon_stream_key(stream, "summary");
+    sysmon_stream_map_begin(stream);
+
+    sysmon_stream_key(stream, "cpu");
+    sysmon_stream_map_begin(stream);
+    sysmon_stream_key(stream, "overall");
+    sysmon_stream_fixed(stream, state->cpu_overall_percent[read_index], 2);
+    sysmon_stream_key(stream, "cores");
+    sysmon_stream_array_begin(stream);
+    sysmon_stream_fixed(stream, state->cpu_core_percent[0][read_index], 2);
+    sysmon_stream_fixed(stream, state->cpu_core_percent[1][read_index], 2);
+    sysmon_stream_array_end(stream);
+    sysmon_stream_map_end(stream);
+
+    sysmon_stream_key(stream, "mem");
+    sysmon_stream_map_begin(stream);
+    sysmon_stream_key(stream, "dram");
+    sysmon_stream_map_begin(stream);
+    sysmon_stream_key(stream, "free");
+    sysmon_stream_uint(stream, state->dram_free[read_index]);
+    sysmon_stream_key(stream, "largest");
+    sysmon_stream_uint(stream, state->dram_largest_block[read_index]);
+    sysmon_stream_key(stream, "total");
+    sysmon_stream_uint(stream, state->dram_total[read_index]);
+    sysmon_stream_key(stream, "usedPct");
+    sysmon_stream_fixed(stream, state->dram_used_percent[read_index], 2);
+    sysmon_stream_map_end(stream);
+    sysmon_stream_key(stream, "psram");
+    sysmon_stream_map_begin(stream);
+    sysmon_stream_key(stream, "free");
+    sysmon_stream_uint(stream, state->psram_free[read_index]);
+    sysmon_stream_key(stream, "total");
+    sysmon_stream_uint(stream, state->psram_total[read_index]);
+    sysmon_stream_key(stream, "usedPct");
+    sysmon_stream_fixed(stream, state->psram_used_percent[read_index], 2);
+    sysmon_stream_key(stream, "present");
+    sysmon_stream_bool(stream, state->psram_seen);
+    sysmon_stream_map_end(stream);
+    sysmon_stream_map_end(stream);
+
+    int8_t rssi = 0;
+    sysmon_stream_key(stream, "wifiRssi");
+    if (_get_wifi_rssi(&rssi) == ESP_OK)
+    {
+        sysmon_stream_int(stream, rssi);
+    }
+    else
+    {
+        sysmon_stream_null(stream);
+    }
+    sysmon_stream_map_end(stream);
+
+    sysmon_stream_key(stream, "current");
+    sysmon_stream_map_begin(stream);
+    for (int i = 0; i < state->task_capacity && state->tasks != NULL; i++)
+    {
+        const TaskUsageSample *task = &state->tasks[i];
+        if (!task->is_active)
+        {
+            continue;
+        }
+        size_t at = _history_at(state, read_index, i);
+        sysmon_stream_key(stream, _get_task_display_name(task->task_name));
+        sysmon_stream_map_begin(stream);
+        sysmon_stream_key(stream, "cpu");
+        sysmon_stream_fixed(stream, state->history.usage_percent[at], 2);
+        sysmon_stream_key(stream, "stack");
+        sysmon_stream_uint(stream, state->history.stack_usage_bytes[at]);
+        sysmon_stream_key(stream, "stackPct");
+        sysmon_stream_fixed(stream, state->history.stack_usage_percent[at], 2);
+        _stream_stack_remaining(stream, state, task, at);
+        sysmon_stream_map_end(stream);
+    }
+    sysmon_stream_map_end(stream);
+    sysmon_stream_map_end(stream);
+    return stream->error;
+}
+
+/**
+ * @brief Write {min: [...], avg: [...], max: [...]} for one rollup series.
+ *
+ * @param values Field 0 of the series in bucket 0; bucket b is at values[b * stride].
+ * @param first Ring index of the oldest bucket to send.
+ * @param percent Values are hundredths of a percent (else KiB).
+ */
+static void _stream_rollup_series(sysmon_stream_t *stream, const char *key, const sysmon_rollup_tier_t *tier,
+                                  const uint16_t *values, size_t stride, int first, uint32_t samples, bool percent)
+{
+    static const char *const field_keys[] = { "min", "avg", "max" };
+    sysmon_stream_key(stream, key);
+    sysmon_stream_map_begin(stream);
+    for (int f = SYSMON_ROLLUP_MIN; f <= SYSMON_ROLLUP_MAX; f++)
+    {
+        int offset = (tier->fields == 1) ? 0 : f;  // One-sample buckets store min == avg == max once
+        sysmon_stream_key(stream, field_keys[f]);
+        sysmon_stream_array_begin(stream);
+        for (uint32_t j = 0, b = (uint32_t)first; j < samples; j++, b = (b + 1) % CONFIG_SYSMON_ROLLUP_BUCKETS)
+        {
+            uint16_t value = values[(size_t)b * stride + (size_t)offset];
+            if (percent)
+            {
+                sysmon_stream_fixed(stream, (float)value / (float)SYSMON_ROLLUP_PERCENT_SCALE, 2);
+            }
+            else
+            {
+                sysmon_stream_uint(stream, value);
+            }
+        }
+        sysmon_stream_array_end(stream);
+    }
+    sysmon_stream_map_end(stream);
+}
+
+esp_err_t sysmon_stream_rollup(sysmon_stream_t *stream, const SysMonState *state, const sysmon_stream_query_t *query)
+{
+    static const struct
+    {
+        const char *key;
+        int metric;
+        bool percent;
+    } mem_series[] =
+    {
+        { "dramUsedPct",   SYSMON_ROLLUP_SYS_DRAM_USED,     true  },
+        { "psramUsedPct",  SYSMON_ROLLUP_SYS_PSRAM_USED,    true  },
+        { "dramFreeKb",    SYSMON_ROLLUP_SYS_DRAM_FREE,     false },
+        { "dramMinFreeKb", SYSMON_ROLLUP_SYS_DRAM_MIN_FREE, false },
+        { "dramLargestKb", SYSMON_ROLLUP_SYS_DRAM_LARGEST,  false },
+        { "psramFreeKb",   SYSMON_ROLLUP_SYS_PSRAM_FREE,    false },
+    };
+
+    if (query->tier < 0 || query->tier >= SYSMON_ROLLUP_TIERS)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    const sysmon_rollup_tier_t *tier = &state->rollup.tier[query->tier];
+    uint32_t samples = (tier->system != NULL) ? query->samples : 0U;
+    if (samples > CONFIG_SYSMON_ROLLUP_BUCKETS)
+    {
+        samples = CONFIG_SYSMON_ROLLUP_BUCKETS;
+    }
+    int first = (tier->write_index - (int)samples + CONFIG_SYSMON_ROLLUP_BUCKETS) % CONFIG_SYSMON_ROLLUP_BUCKETS;
+    size_t sys_stride = (size_t)SYSMON_ROLLUP_SYS_METRICS * tier->fields;
+
+    sysmon_stream_map_begin(stream);
+    sysmon_stream_key(stream, "tier");
+    sysmon_stream_uint(stream, (uint64_t)query->tier);
+    sysmon_stream_key(stream, "bucketMs");
+    sysmon_stream_uint(stream, (uint64_t)tier->width * CONFIG_SYSMON_CPU_SAMPLING_INTERVAL_MS);
+    sysmon_stream_key(stream, "buckets");
+    sysmon_stream_uint(stream, samples);
+
+    sysmon_stream_key(stream, "cpu");
+    sysmon_stream_map_begin(stream);
+    if (samples > 0U)
+    {
+        _stream_rollup_series(stream, "overall", tier, &tier->system[sysmon_rollup_sys_at(tier, 0, SYSMON_ROLLUP_SYS_CPU, 0)],
+                              sys_stride, first, samples, true);
+        _stream_rollup_series(stream, "core0", tier, &tier->system[sysmon_rollup_sys_at(tier, 0, SYSMON_ROLLUP_SYS_CPU_CORE0, 0)],
+                              sys_stride, first, samples, true);
+        _stream_rollup_series(stream, "core1", tier, &tier->system[sysmon_rollup_sys_at(tier, 0, SYSMON_ROLLUP_SYS_CPU_CORE1, 0)],
+                              sys_stride, first, samples, true);
+    }
+    sysmon_stream_map_end(stream);
+
+    sysmon_stream_key(stream, "mem");
+    sysmon_stream_map_begin(stream);
+    for (size_t m = 0; m < sizeof(mem_series) / sizeof(mem_series[0]) && samples > 0U; m++)
+    {
+        _stream_rollup_series(stream, mem_series[m].key, tier, &tier->system[sysmon_rollup_sys_at(tier, 0, mem_series[m].metric, 0)],
+                              sys_stride, first, samples, mem_series[m].percent);
+    }
+    sysmon_stream_map_end(stream);
+
+    sysmon_stream_key(stream, "tasks");
+    sysmon_stream_map_begin(stream);
+    int capacity = state->rollup.capacity;
+    size_t task_stride = (size_t)capacity * SYSMON_ROLLUP_TASK_METRICS * tier->fields;
+    for (int i = 0; i < state->task_capacity && i < capacity && state->tasks != NULL && samples > 0U; i++)
+    {
+        const TaskUsageSample *task = &state->tasks[i];
+        if (!task->is_active)
+        {
+            continue;
+        }
+        sysmon_stream_key(stream, _get_task_display_name(task->task_name));
+        sysmon_stream_map_begin(stream);
+        _stream_rollup_series(stream, "cpu", tier, &tier->tasks[sysmon_rollup_task_at(tier, capacity, 0, i, SYSMON_ROLLUP_TASK_CPU, 0)],
+                              task_stride, first, samples, true);
+        if (task->stack_size_bytes > 0U)
+        {
+            _stream_rollup_series(stream, "stackPct", tier,
+                                  &tier->tasks[sysmon_rollup_task_at(tier, capacity, 0, i, SYSMON_ROLLUP_TASK_STACK, 0)],
+                                  task_stride, first, samples, true);
+        }
+        sysmon_stream_map_end(stream);
+    }
+    sysmon_stream_map_end(stream);
+    sysmon_stream_map_end(stream);
+    return stream->error;
+}
@@ -0,0 +1,365 @@
+/**
+ * @file sysmon_tasks.c
+ * @brief Task table of the sysmon sampler: slots, hash index, free list and history rows.
+ *
+ * Every sampling cycle maps each task of the uxTaskGetSystemState() snapshot to a slot of
+ * self.tasks. The mapping goes through self.task_index (xTaskNumber -> slot), so the cost per
+ * cycle is one hash lookup per task plus one pass over the table for tasks that disappeared,
+ * instead of a strncmp() scan of the table per task. Slots of removed tasks go back to a free
+ * list (self.free_slot / TaskUsageSample.next_free).
+ *
+ * The per-task histories are struct-of-arrays rows (see TaskHistory in sysmon.h): the values
+ * of one cycle land next to each other in one row per series.
+ */
+
+// Project-specific includes
+#include "sysmon_tasks.h"
+#include "sysmon_snapshot.h"
+#include "sysmon_stack.h"
+
+// ESP-IDF includes
+#include "esp_log.h"
+
+// System includes
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Logger tag for this module
+static const char *LOG_TAG = "sysmon_tasks";
+
+// ============================================================================
+// Internal Helper Functions
+// ============================================================================
+
+/**
+ * @brief Write one history row value for a task slot.
+ */
+static void _write_history(int slot, int row, float usage, uint32_t stack_bytes, float stack_percent)
+{
+    size_t at = _history_at(&self, row, slot);
+    self.history.usage_percent[at] = usage;
+    self.history.stack_usage_bytes[at] = stack_bytes;
+    self.history.stack_usage_percent[at] = stack_percent;
+}
+
+/**
+ * @brief Return a slot to the free list.
+ */
+static void _release_slot(int slot)
+{
+    sysmon_index_remove(&self.task_index, self.tasks[slot].task_id);
+    self.tasks[slot].is_active = false;
+    self.tasks[slot].consecutive_zero_samples = 0;
+    self.tasks[slot].next_free = self.free_slot;
+    self.free_slot = slot;
+}
+
+/**
+ * @brief Create the table entry of a task that is not in the index yet.
+ *
+ * @param task_status Task status from uxTaskGetSystemState.
+ * @param seen_seq Sequence number of the current sample.
+ * @return Slot on success, -1 if the table is full.
+ *
+ * Details:
+ *   - An active entry with the same name that was not seen in this sample belongs to a task that
+ *     was deleted and created again: it is re-keyed to the new xTaskNumber and keeps its history.
+ *   - If a live task already uses the name, the new entry is named "<name>#<xTaskNumber>".
+ *   - The name scan only runs for new tasks, not on every sample.
+ */
+static int _create_task_entry(const TaskStatus_t *task_status, uint32_t seen_seq)
+{
+    bool name_in_use = false;
+    for (int j = 0; j < self.task_capacity; j++)
+    {
+        TaskUsageSample *task = &self.tasks[j];
+        if (!task->is_active || strncmp(task->task_name, task_status->pcTaskName, sizeof(task->task_name)) != 0)
+        {
+            continue;
+        }
+        if (task->last_seen_seq != seen_seq)
+        {
+            sysmon_index_remove(&self.task_index, task->task_id);
+            if (sysmon_index_put(&self.task_index, task_status->xTaskNumber, (uint32_t)j) != ESP_OK)
+            {
+                _release_slot(j);
+                return -1;
+            }
+            task->task_id = task_status->xTaskNumber;
+            task->handle = task_status->xHandle;
+            task->prev_run_time_ticks = 0;
+            task->run_time_stale = false;
+            task->consecutive_zero_samples = 0;
+            ESP_LOGI(LOG_TAG, "Task re-created, continuing its history: '%s'", task->task_name);
+            return j;
+        }
+        name_in_use = true;
+    }
+
+    int slot = self.free_slot;
+    if (slot < 0 || sysmon_index_put(&self.task_index, task_status->xTaskNumber, (uint32_t)slot) != ESP_OK)
+    {
+        return -1;
+    }
+    TaskUsageSample *task = &self.tasks[slot];
+    self.free_slot = task->next_free;
+
+    memset(task, 0, sizeof(TaskUsageSample));
+    if (name_in_use)
+    {
+        // Keep the suffix whole, shorten the name if needed
+        char suffix[12];
+        int suffix_len = snprintf(suffix, sizeof(suffix), "#%lu", (unsigned long)task_status->xTaskNumber);
+        snprintf(task->task_name, sizeof(task->task_name), "%.*s%s",
+                 (int)sizeof(task->task_name) - 1 - suffix_len, task_status->pcTaskName, suffix);
+    }
+    else
+    {
+        strncpy(task->task_name, task_status->pcTaskName, sizeof(task->task_name) - 1);
+    }
+    task->handle = task_status->xHandle;
+    task->task_id = task_status->xTaskNumber;
+    task->is_active = true;
+    task->next_free = -1;
+
+    // The slot may hold the history and rollups of a removed task
+    for (int row = 0; row < CONFIG_SYSMON_SAMPLE_COUNT; row++)
+    {
+        _write_history(slot, row, 0.0f, 0U, 0.0f);
+    }
+    sysmon_rollup_clear_slot(&self.rollup, slot);
+    ESP_LOGI(LOG_TAG, "Discovered new task: '%s'", task->task_name);
+    return slot;
+}
+
+/**
+ * @brief Update task usage history for a single task.
+ *
+ * @param slot Task slot.
+ * @param task_status Task status from uxTaskGetSystemState.
+ * @param sampled Whether task_status->ulRunTimeCounter was sampled.
+ * @param delta_total Total runtime delta for CPU calculation.
+ * @param row History row of the current sample.
+ * @param seen_seq Sequence number of the current sample.
+ */
+static void _update_task_history(int slot, const TaskStatus_t *task_status, bool sampled, uint32_t delta_total, int row, uint32_t seen_seq)
+{
+    TaskUsageSample *task = &self.tasks[slot];
+
+    // Compute delta runtime: nothing without a sample now and a base from the previous one
+    uint32_t delta_task = 0;
+    if (sampled)
+    {
+        if (!task->run_time_stale && task_status->ulRunTimeCounter >= task->prev_run_time_ticks)
+        {
+            delta_task = task_status->ulRunTimeCounter - task->prev_run_time_ticks;
+        }
+        task->prev_run_time_ticks = task_status->ulRunTimeCounter;
+    }
+    task->run_time_stale = !sampled;
+
+    // Calculate CPU usage
+    float usage = (delta_total > 0) ? ((float)delta_task / (float)delta_total) * 100.0f : 0.0f;
+    task->consecutive_zero_samples = 0;  // Task is present, reset counter
+    task->last_seen_seq = seen_seq;
+
+    // Calculate stack usage
+    task->stack_high_water_mark = task_status->usStackHighWaterMark;
+    uint32_t stack_hwm_bytes = task_status->usStackHighWaterMark * sizeof(StackType_t);
+
+    // Lookup registered stack size
+    uint32_t stack_size_bytes = 0U;
+    sysmon_stack_get_size(task_status->xHandle, &stack_size_bytes);
+
+    task->stack_size_bytes = stack_size_bytes;
+
+    uint32_t stack_used_bytes = 0U;
+    float stack_usage_percent = 0.0f;
+    if (stack_size_bytes > 0U)
+    {
+        if (stack_size_bytes > stack_hwm_bytes)
+        {
+            stack_used_bytes = stack_size_bytes - stack_hwm_bytes;
+        }
+        stack_usage_percent = ((float)stack_used_bytes / (float)stack_size_bytes) * 100.0f;
+    }
+
+    // Store history row
+    _write_history(slot, row, usage, stack_used_bytes, stack_usage_percent);
+
+    // Update task metadata
+    task->current_priority = task_status->uxCurrentPriority;
+    task->base_priority = task_status->uxBasePriority;
+    if (sampled)
+    {
+        task->total_run_time_ticks = task_status->ulRunTimeCounter;
+    }
+    task->core_id = task_status->xCoreID;
+}
+
+/**
+ * @brief Process deleted tasks (not seen in current sample).
+ *
+ * @param row History row of the current sample.
+ * @param seen_seq Sequence number of the current sample.
+ */
+static void _process_deleted_tasks(int row, uint32_t seen_seq)
+{
+    for (int j = 0; j < self.task_capacity; j++)
+    {
+        TaskUsageSample *task = &self.tasks[j];
+        if (!task->is_active || task->last_seen_seq == seen_seq)
+        {
+            continue;
+        }
+        task->consecutive_zero_samples++;
+
+        // Record zero values
+        _write_history(j, row, 0.0f, 0U, 0.0f);
+
+        // Release the slot after CONFIG_SYSMON_SAMPLE_COUNT consecutive zeros
+        if (task->consecutive_zero_samples >= CONFIG_SYSMON_SAMPLE_COUNT)
+        {
+            ESP_LOGI(LOG_TAG, "Task removed after %d consecutive zero samples: '%s'",
+                     CONFIG_SYSMON_SAMPLE_COUNT, task->task_name);
+            _release_slot(j);
+        }
+        else if (task->consecutive_zero_samples % 10 == 0)
+        {
+            ESP_LOGI(LOG_TAG, "Task not detected; logging zero for inactivity (sample %d of %d): '%s'",
+                     task->consecutive_zero_samples, CONFIG_SYSMON_SAMPLE_COUNT, task->task_name);
+        }
+    }
+}
+
+// ============================================================================
+// Public API Functions
+// ============================================================================
+
+esp_err_t _tasks_resize(int capacity)
+{
+    int old_capacity = (self.tasks != NULL) ? self.task_capacity : 0;
+    if (capacity <= old_capacity)
+    {
+        return ESP_OK;
+    }
+
+    // Readers may be copying the old arrays: they are retired, not freed (see sysmon_snapshot.h)
+    if (old_capacity > 0 && sysmon_snapshot_retire_room() < 5)
+    {
+        return ESP_ERR_NOT_FINISHED;
+    }
+
+    size_t cells = (size_t)CONFIG_SYSMON_SAMPLE_COUNT * (size_t)capacity;
+    TaskUsageSample *tasks = (TaskUsageSample *)calloc(capacity, sizeof(TaskUsageSample));
+    TaskHistory history = {
+        .usage_percent = (float *)calloc(cells, sizeof(float)),
+        .stack_usage_bytes = (uint32_t *)calloc(cells, sizeof(uint32_t)),
+        .stack_usage_percent = (float *)calloc(cells, sizeof(float)),
+    };
+    sysmon_index_t index;
+    esp_err_t err = sysmon_index_init(&index, (uint32_t)capacity);
+    void *old_rollup = NULL;  // The rollup rows grow last: nothing else can fail after them
+    if (tasks == NULL || history.usage_percent == NULL || history.stack_usage_bytes == NULL ||
+        history.stack_usage_percent == NULL || err != ESP_OK ||
+        sysmon_rollup_resize(&self.rollup, capacity, &old_rollup) != ESP_OK)
+    {
+        free(tasks);
+        free(history.usage_percent);
+        free(history.stack_usage_bytes);
+        free(history.stack_usage_percent);
+        sysmon_index_free(&index);
+        return ESP_ERR_NO_MEM;
+    }
+
+    // Existing slots keep their index: copy the entries and every history row into the wider rows
+    int free_slot = -1;
+    if (old_capacity > 0)
+    {
+        memcpy(tasks, self.tasks, (size_t)old_capacity * sizeof(TaskUsageSample));
+        for (int row = 0; row < CONFIG_SYSMON_SAMPLE_COUNT; row++)
+        {
+            size_t from = (size_t)row * (size_t)old_capacity;
+            size_t to = (size_t)row * (size_t)capacity;
+            memcpy(&history.usage_percent[to], &self.history.usage_percent[from], (size_t)old_capacity * sizeof(float));
+            memcpy(&history.stack_usage_bytes[to], &self.history.stack_usage_bytes[from], (size_t)old_capacity * sizeof(uint32_t));
+            memcpy(&history.stack_usage_percent[to], &self.history.stack_usage_percent[from], (size_t)old_capacity * sizeof(float));
+        }
+        sysmon_index_rehash(&index, &self.task_index);
+        free_slot = self.free_slot;
+    }
+
+    // New slots go to the front of the free list, lowest first
+    for (int j = capacity - 1; j >= old_capacity; j--)
+    {
+        tasks[j].next_free = free_slot;
+        free_slot = j;
+    }
+
+    // Ownership hand-off
+    sysmon_snapshot_retire(self.tasks);
+    sysmon_snapshot_retire(self.history.usage_percent);
+    sysmon_snapshot_retire(self.history.stack_usage_bytes);
+    sysmon_snapshot_retire(self.history.stack_usage_percent);
+    sysmon_snapshot_retire(old_rollup);
+    sysmon_index_free(&self.task_index);  // Readers never use the index
+    self.tasks = tasks;
+    self.history = history;
+    self.task_index = index;
+    self.free_slot = free_slot;
+    self.task_capacity = capacity;
+    return ESP_OK;
+}
+
+void _tasks_update(const TaskStatus_t *task_status, const bool *sampled, UBaseType_t count, uint32_t delta_total)
+{
+    int row = self.series_write_index;
+    uint32_t seen_seq = self.sample_seq + 1;  // Sequence number this sample gets in _update_series_buffers()
+
+    // 1. Known tasks: one hash lookup each
+    for (UBaseType_t i = 0; i < count; i++)
+    {
+        const TaskStatus_t *t = &task_status[i];
+        uint32_t slot = 0;
+        if (t->pcTaskName != NULL && sysmon_index_find(&self.task_index, t->xTaskNumber, &slot))
+        {
+            _update_task_history((int)slot, t, sampled == NULL || sampled[i], delta_total, row, seen_seq);
+        }
+    }
+
+    // 2. New tasks, once every known task is marked as seen (an entry not seen by now is really gone)
+    for (UBaseType_t i = 0; i < count; i++)
+    {
+        const TaskStatus_t *t = &task_status[i];
+        uint32_t slot = 0;
+        if (t->pcTaskName == NULL || sysmon_index_find(&self.task_index, t->xTaskNumber, &slot))
+        {
+            continue;
+        }
+        int idx = _create_task_entry(t, seen_seq);
+        if (idx == -1)
+        {
+            ESP_LOGW(LOG_TAG, "Task capacity exceeded, cannot track task '%s' (capacity: %d, num_tasks: %u). Will retry next sample.",
+                     t->pcTaskName, self.task_capacity, (unsigned)count);
+            continue;
+        }
+        _update_task_history(idx, t, sampled == NULL || sampled[i], delta_total, row, seen_seq);
+    }
+
+    // 3. Tasks missing from the snapshot
+    _process_deleted_tasks(row, seen_seq);
+}
+
+void _tasks_free(void)
+{
+    free(self.tasks);
+    free(self.history.usage_percent);
+    free(self.history.stack_usage_bytes);
+    free(self.history.stack_usage_percent);
+    sysmon_index_free(&self.task_index);
+    sysmon_rollup_free(&self.rollup);
+    self.tasks = NULL;
+    memset(&self.history, 0, sizeof(self.history));
+    self.free_slot = -1;
+}
@@ -3,8 +3,8 @@
  * @brief Utility functions for sysmon HTTP module.
  *
  * This file implements utility functions used across the sysmon HTTP
- * subsystem for content type detection, task name formatting, and JSON
- * cleanup operations.
+ * subsystem for task name formatting, JSON cleanup operations and WiFi
+ * information.
  */
 
 // Project-specific includes
@@ -40,40 +40,6 @@ const char *_get_task_display_name(const char *task_name)
     return task_name;
 }
 
-/**
- * @brief Determine content type from URI path.
- *
- * @param uri URI path string.
- * @return Content type string based on URI extension.
- */
-const char *_get_content_type_from_uri(const char *uri)
-{
-    if (uri == NULL)
-    {
-        return "application/octet-stream";
-    }
-
-    // Root URI is HTML
-    if (strcmp(uri, "/") == 0)
-    {
-        return "text/html; charset=utf-8";
-    }
-
-    // Check file extension
-    size_t uri_len = strlen(uri);
-    if (uri_len >= 4 && strcmp(uri + uri_len - 4, ".css") == 0)
-    {
-        return "text/css; charset=utf-8";
-    }
-    if (uri_len >= 3 && strcmp(uri + uri_len - 3, ".js") == 0)
-    {
-        return "application/javascript; charset=utf-8";
-    }
-
-    // Default fallback
-    return "application/octet-stream";
-}
-
 /**
  * @brief Clean up multiple cJSON objects.
  *
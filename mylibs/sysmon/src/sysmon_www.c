@@ -0,0 +1,168 @@
+/**
+ * @file sysmon_www.c
+ * @brief HTTP handler for the dashboard assets (index.html, CSS, JS).
+ *
+ * The assets are packed at build time by tools/sysmon_www_pack.py (sysmon_www_files in the
+ * generated sysmon_www_assets.c): gzip data in flash, sent as is with Content-Encoding: gzip,
+ * plus a strong ETag and a Cache-Control value per asset.
+ *
+ *   - index.html is "no-cache": the browser revalidates it on every dashboard open and gets
+ *     304 Not Modified (no body) while the firmware is unchanged.
+ *   - CSS/JS are referenced from index.html as <uri>?v=<hash> and cached for a year, so a
+ *     dashboard open with a warm cache requests only index.html.
+ *
+ * Every browser the dashboard supports accepts gzip, so there is no uncompressed fallback;
+ * use curl --compressed.
+ */
+
+// Project-specific includes
+#include "sysmon_config.h"
+
+// ESP-IDF includes
+#include "esp_log.h"
+#include "esp_http_server.h"
+
+// System includes
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+// Logger tag for this module
+static const char *LOG_TAG = "sysmon_www";
+
+// If-None-Match values longer than this are ignored (the asset is sent)
+#define IF_NONE_MATCH_MAX_LEN 128
+
+// ============================================================================
+// Internal Helper Functions
+// ============================================================================
+
+/**
+ * @brief Check an If-None-Match list ("a", W/"b", *) against a strong ETag.
+ *
+ * Uses the weak comparison of RFC 9110 13.1.2, as required for If-None-Match: a W/ prefix
+ * is ignored.
+ */
+static bool _www_etag_matches(const char *list, const char *etag)
+{
+    size_t etag_len = strlen(etag);
+    const char *p = list;
+    while (*p != '\0')
+    {
+        while (*p == ' ' || *p == '\t' || *p == ',')
+        {
+            p++;
+        }
+        const char *end = p;
+        while (*end != '\0' && *end != ',')
+        {
+            end++;
+        }
+        const char *last = end;
+        while (last > p && (last[-1] == ' ' || last[-1] == '\t'))
+        {
+            last--;
+        }
+        if (last - p == 1 && *p == '*')
+        {
+            return true;
+        }
+        if (last - p >= 2 && p[0] == 'W' && p[1] == '/')
+        {
+            p += 2;
+        }
+        if ((size_t)(last - p) == etag_len && memcmp(p, etag, etag_len) == 0)
+        {
+            return true;
+        }
+        p = end;
+    }
+    return false;
+}
+
+/**
+ * @brief True when the request's If-None-Match lists the asset's ETag.
+ */
+static bool _www_not_modified(httpd_req_t *request, const char *etag)
+{
+    if (etag == NULL)
+    {
+        return false;
+    }
+    size_t len = httpd_req_get_hdr_value_len(request, "If-None-Match");
+    if (len == 0 || len >= IF_NONE_MATCH_MAX_LEN)
+    {
+        return false;
+    }
+    char value[IF_NONE_MATCH_MAX_LEN];
+    if (httpd_req_get_hdr_value_str(request, "If-None-Match", value, sizeof(value)) != ESP_OK)
+    {
+        return false;
+    }
+    return _www_etag_matches(value, etag);
+}
+
+// ============================================================================
+// Public API Functions
+// ============================================================================
+
+/**
+ * @brief Handler function for static files (internal use only).
+ *
+ * Sends the asset from config (a sysmon_www_files entry) or 304 Not Modified when the
+ * client already has it. ETag, Cache-Control and Vary are sent with both.
+ *
+ * @param request HTTP request object.
+ * @return ESP_OK on success, error code otherwise.
+ */
+esp_err_t http_handle_static_file(httpd_req_t *request)
+{
+    // Get config from user_ctx
+    const static_file_config_t *config = (const static_file_config_t *)request->user_ctx;
+    if (config == NULL)
+    {
+        ESP_LOGE(LOG_TAG, "Static file config is NULL");
+        return httpd_resp_send_500(request);
+    }
+
+    const uint8_t *start = config->start;
+    const uint8_t *end = config->end;
+    if (start == NULL || end == NULL || end <= start)
+    {
+        ESP_LOGE(LOG_TAG, "no data for %s", config->uri);
+        return httpd_resp_send_500(request);
+    }
+
+    httpd_resp_set_type(request, config->content_type);
+
+    // Add CORS headers to allow cross-origin requests from other machines
+    httpd_resp_set_hdr(request, "Access-Control-Allow-Origin", "*");
+    httpd_resp_set_hdr(request, "Access-Control-Allow-Methods", "GET, OPTIONS");
+    httpd_resp_set_hdr(request, "Access-Control-Allow-Headers", "Content-Type");
+
+    if (config->etag != NULL)
+    {
+        httpd_resp_set_hdr(request, "ETag", config->etag);
+    }
+    if (config->cache_control != NULL)
+    {
+        httpd_resp_set_hdr(request, "Cache-Control", config->cache_control);
+    }
+    if (config->gzip)
+    {
+        httpd_resp_set_hdr(request, "Vary", "Accept-Encoding");
+    }
+
+    if (_www_not_modified(request, config->etag))
+    {
+        ESP_LOGD(LOG_TAG, "%s: 304", config->uri);
+        httpd_resp_set_status(request, "304 Not Modified");
+        return httpd_resp_send(request, NULL, 0);
+    }
+
+    if (config->gzip)
+    {
+        httpd_resp_set_hdr(request, "Content-Encoding", "gzip");
+    }
+    return httpd_resp_send(request, (const char *)start, (ssize_t)(end - start));
+}
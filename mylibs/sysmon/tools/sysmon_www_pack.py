@@ -0,0 +1,180 @@
+#!/usr/bin/env python3
+"""
+Pack the sysmon dashboard (www/) into a C source file at build time.
+
+Every asset is gzip-compressed (level 9, no timestamp, so the output only changes with
+the input) and described by a static_file_config_t entry (sysmon_config.h): URI, content
+type, strong ETag from a SHA-256 of the served bytes and Cache-Control.
+
+index.html is rewritten before it is compressed:
+  - references to the other assets ('/css/x.css', "/js/x.js") get ?v=<hash>, so those
+    assets can be cached for a year; a new firmware changes the hash and the URL
+  - with --bundle, <script src="/js/x.js"></script> tags are replaced by the script
+    itself and the script is not served on its own
+
+index.html is served with Cache-Control: no-cache: the browser revalidates it on every
+load and gets 304 Not Modified while the firmware is unchanged.
+
+Usage:
+  sysmon_www_pack.py --root www --out sysmon_www_assets.c [--bundle] [--name sysmon_www] index.html css/a.css ...
+"""
+
+import argparse
+import gzip
+import hashlib
+import os
+import re
+import sys
+
+CONTENT_TYPES = {
+    ".html": "text/html; charset=utf-8",
+    ".css": "text/css; charset=utf-8",
+    ".js": "application/javascript; charset=utf-8",
+}
+
+CACHE_REVALIDATE = "no-cache"
+CACHE_IMMUTABLE = "public, max-age=31536000, immutable"
+
+ETAG_HEX = 16    # Hex digits of the SHA-256 in the ETag
+VERSION_HEX = 8  # Hex digits of the SHA-256 in ?v=
+
+
+def compress(data):
+    return gzip.compress(data, compresslevel=9, mtime=0)
+
+
+def digest(data):
+    return hashlib.sha256(data).hexdigest()
+
+
+def uri_of(path):
+    return "/" if path == "index.html" else "/" + path
+
+
+def c_string(text):
+    return '"' + text.replace("\\", "\\\\").replace('"', '\\"') + '"'
+
+
+def rewrite_index(html, assets, bundle):
+    """Inline (--bundle) or version the asset references of index.html. Returns (html, inlined, versioned)."""
+    inlined = set()
+    versioned = set()
+
+    if bundle:
+        def inline(match):
+            uri = match.group(2).decode()
+            body = assets.get(uri)
+            # A script that contains </script would end the inline block early
+            if body is None or not uri.endswith(".js") or b"</script" in body.lower():
+                return match.group(0)
+            inlined.add(uri)
+            return b"<script>\n" + body.rstrip(b"\n") + b"\n</script>"
+
+        html = re.sub(rb'<script src=(["\'])(/[^"\']+)\1></script>', inline, html)
+
+    def version(match):
+        uri = match.group(2).decode()
+        if uri not in assets or uri in inlined:
+            return match.group(0)
+        versioned.add(uri)
+        tag = digest(compress(assets[uri]))[:VERSION_HEX]
+        return match.group(1) + ("%s?v=%s" % (uri, tag)).encode() + match.group(1)
+
+    html = re.sub(rb'(["\'])(/(?:css|js)/[^"\'?]+)\1', version, html)
+    return html, inlined, versioned
+
+
+def write_c(out, name, entries, raw_total):
+    lines = [
+        "/**",
+        " * @file %s" % os.path.basename(out),
+        " * @brief Generated by tools/sysmon_www_pack.py from www/ - do not edit.",
+        " */",
+        "",
+        '#include "sysmon_config.h"',
+        "",
+        "#include <stddef.h>",
+        "#include <stdint.h>",
+        "",
+    ]
+    for index, entry in enumerate(entries):
+        data = entry["data"]
+        lines.append("// %s: %d bytes, %d gzip" % (entry["uri"], entry["raw"], len(data)))
+        lines.append("static const uint8_t _www_%d[%d] =" % (index, len(data)))
+        lines.append("{")
+        for offset in range(0, len(data), 16):
+            lines.append("    " + ", ".join("0x%02x" % b for b in data[offset:offset + 16]) + ",")
+        lines.append("};")
+        lines.append("")
+
+    lines.append("// %d assets, %d bytes, %d gzip" % (len(entries), raw_total, sum(len(e["data"]) for e in entries)))
+    lines.append("const static_file_config_t %s_files[] =" % name)
+    lines.append("{")
+    for index, entry in enumerate(entries):
+        lines.append("    {")
+        lines.append("        .uri           = %s," % c_string(entry["uri"]))
+        lines.append("        .content_type  = %s," % c_string(entry["type"]))
+        lines.append("        .start         = _www_%d," % index)
+        lines.append("        .end           = _www_%d + sizeof(_www_%d)," % (index, index))
+        lines.append("        .etag          = %s," % c_string('"%s"' % entry["etag"]))
+        lines.append("        .cache_control = %s," % c_string(entry["cache"]))
+        lines.append("        .gzip          = true")
+        lines.append("    },")
+    lines.append("};")
+    lines.append("")
+    lines.append("const size_t %s_file_count = sizeof(%s_files) / sizeof(%s_files[0]);" % (name, name, name))
+    lines.append("")
+
+    text = "\n".join(lines)
+    # Leave the file alone when nothing changed, so the build does not recompile it
+    if os.path.exists(out):
+        with open(out, "r", encoding="utf-8") as f:
+            if f.read() == text:
+                return
+    with open(out, "w", encoding="utf-8") as f:
+        f.write(text)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--root", required=True, help="directory the asset paths are relative to")
+    parser.add_argument("--out", required=True, help="generated C file")
+    parser.add_argument("--name", default="sysmon_www", help="prefix of the generated table (<name>_files, <name>_file_count)")
+    parser.add_argument("--bundle", action="store_true", help="inline the local scripts into index.html")
+    parser.add_argument("files", nargs="+", help="assets, index.html first")
+    args = parser.parse_args()
+
+    assets = {}
+    for path in args.files:
+        ext = os.path.splitext(path)[1]
+        if ext not in CONTENT_TYPES:
+            sys.exit("sysmon_www_pack: no content type for %s" % path)
+        with open(os.path.join(args.root, path), "rb") as f:
+            assets[uri_of(path)] = f.read()
+    raw_total = sum(len(data) for data in assets.values())
+
+    inlined = set()
+    versioned = set()
+    if "/" in assets:
+        assets["/"], inlined, versioned = rewrite_index(assets["/"], assets, args.bundle)
+
+    entries = []
+    for path in args.files:
+        uri = uri_of(path)
+        if uri in inlined:
+            continue
+        data = compress(assets[uri])
+        entries.append({
+            "uri": uri,
+            "type": CONTENT_TYPES[os.path.splitext(path)[1]],
+            "data": data,
+            "raw": len(assets[uri]),
+            "etag": digest(data)[:ETAG_HEX],
+            "cache": CACHE_IMMUTABLE if uri in versioned else CACHE_REVALIDATE,
+        })
+
+    write_c(args.out, args.name, entries, raw_total)
+
+
+if __name__ == "__main__":
+    main()
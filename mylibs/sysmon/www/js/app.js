@@ -66,7 +66,7 @@ function updateStatusPopup()
  *  - Retrieving telemetry history for chart population.
  *  - Building and initializing all dashboard charts, widgets, and summaries.
  *  - Wiring up UI controls including filtering, system task toggles, and updating tooltips.
- *  - Setting up periodic timers to refresh chart data, task table, and summary badges.
+ *  - Subscribing to the event stream (or polling) to refresh chart data, task table, and summary badges.
  *  - Setting status popup for feedback during initialization and connection issues.
  *
  * Should be called once when the dashboard page loads. Handles all one-time bootstrapping
@@ -312,6 +312,74 @@ async function initializeDashboard()
   }
 
   // Keep updating charts, summary, and table
+  startLiveUpdates();
+}
+
+/**
+ * Start receiving live updates for charts, summary, and table.
+ *
+ * Subscribes to the server-push stream (/events): the device sends a 'telemetry' event
+ * every sample and a 'tasks' event every few samples, so no request is made per update.
+ * EventSource reconnects by itself when the device drops the stream. When the stream
+ * cannot be opened at all (all event slots taken, or firmware without /events), falls
+ * back to polling /telemetry and /tasks.
+ */
+function startLiveUpdates()
+{
+  if (typeof EventSource === 'undefined')
+  {
+    startPolling();
+    return;
+  }
+
+  const events = new EventSource(API_ROUTES.EVENTS);
+  events.addEventListener('telemetry', (event) => {
+    try
+    {
+      applyTelemetry(JSON.parse(event.data));
+    }
+    catch (error)
+    {
+      AppState.status.consecutiveFailures++;
+      updateStatusPopup();
+    }
+  });
+  events.addEventListener('tasks', (event) => {
+    try
+    {
+      applyTaskData(JSON.parse(event.data));
+    }
+    catch (error)
+    {
+      console.error("tasks event error:", error);
+      AppState.status.consecutiveFailures++;
+      updateStatusPopup();
+    }
+  });
+  events.onerror = () => {
+    if (events.readyState === EventSource.CLOSED)
+    {
+      // Refused (503/404): EventSource does not retry these
+      console.warn("Event stream unavailable, polling instead");
+      startPolling();
+      return;
+    }
+    // Reconnecting
+    AppState.status.consecutiveFailures++;
+    updateStatusPopup();
+  };
+}
+
+/**
+ * Poll /telemetry and /tasks (fallback when the event stream is unavailable).
+ */
+function startPolling()
+{
+  if (AppState.status.polling)
+  {
+    return;
+  }
+  AppState.status.polling = true;
   setInterval(updateDashboard, CHART_TELEMETRY_UPDATE_INTERVAL_MS);
   setInterval(updateTable, CHART_TASK_TABLE_UPDATE_INTERVAL_MS);
 }
@@ -345,209 +413,222 @@ async function updateDashboard()
       return;
     }
     const telemetryData = await response.json();
-    AppState.status.lastTelemetrySuccess = Date.now();
-    AppState.status.consecutiveFailures = 0;
+    applyTelemetry(telemetryData);
+  }
+  catch (error)
+  {
+    AppState.status.consecutiveFailures++;
+    updateStatusPopup();
+  }
+}
 
-    // Compute current task names once for both paused and active paths
-    const currentTaskNames = new Set(Object.keys(telemetryData.current));
+/**
+ * Apply one telemetry document (/telemetry response or pushed 'telemetry' event).
+ *
+ * Updates the summary badges, progress bars, chart datasets and table rows, and refreshes
+ * the task table when tasks appeared or disappeared.
+ *
+ * @param {Object} telemetryData - Document with `summary` and `current` members.
+ */
+function applyTelemetry(telemetryData)
+{
+  AppState.status.lastTelemetrySuccess = Date.now();
+  AppState.status.consecutiveFailures = 0;
 
-    // Skip visual updates if paused (data collection continues)
-    if (!AppState.ui.isPaused)
-    {
-      // Update summary badges with progress bars
-      const cpuOverall    = document.getElementById('cpuOverall');
-      const cpuC0         = document.getElementById('cpuC0');
-      const cpuC1         = document.getElementById('cpuC1');
-      const cpuOverallBar = document.getElementById('cpuOverallBar');
-      const cpuC0Bar      = document.getElementById('cpuC0Bar');
-      const cpuC1Bar      = document.getElementById('cpuC1Bar');
-
-      const overallValue = telemetryData.summary.cpu.overall;
-    const core0Value   = telemetryData.summary.cpu.cores[0];
-    const core1Value   = telemetryData.summary.cpu.cores[1];
-
-    cpuOverall.textContent = `${overallValue.toFixed(1)} %`;
-    cpuC0.textContent      = `${core0Value.toFixed(1)} %`;
-    cpuC1.textContent      = `${core1Value.toFixed(1)} %`;
-
-    // Update progress bars with color coding
-    updateCpuProgressBar(cpuOverallBar, overallValue);
-    updateCpuProgressBar(cpuC0Bar, core0Value);
-    updateCpuProgressBar(cpuC1Bar, core1Value);
-
-    // Update tooltips on containers (containers are always full width and hoverable)
-    const cpuOverallContainer = cpuOverallBar ? cpuOverallBar.closest('.progress-container') : null;
-    const cpuC0Container = cpuC0Bar ? cpuC0Bar.closest('.progress-container') : null;
-    const cpuC1Container = cpuC1Bar ? cpuC1Bar.closest('.progress-container') : null;
-
-    if (cpuOverallContainer)
-    {
-      cpuOverallContainer.setAttribute('aria-label', `Overall CPU: ${overallValue.toFixed(1)}%`);
-      cpuOverallContainer.setAttribute('role', 'tooltip');
-      cpuOverallContainer.setAttribute('data-microtip-position', 'bottom');
-    }
-    if (cpuC0Container)
-    {
-      cpuC0Container.setAttribute('aria-label', `Core 0: ${core0Value.toFixed(1)}%`);
-      cpuC0Container.setAttribute('role', 'tooltip');
-      cpuC0Container.setAttribute('data-microtip-position', 'bottom');
-    }
-    if (cpuC1Container)
+  // Compute current task names once for both paused and active paths
+  const currentTaskNames = new Set(Object.keys(telemetryData.current));
+
+  // Skip visual updates if paused (data collection continues)
+  if (!AppState.ui.isPaused)
+  {
+    // Update summary badges with progress bars
+    const cpuOverall    = document.getElementById('cpuOverall');
+    const cpuC0         = document.getElementById('cpuC0');
+    const cpuC1         = document.getElementById('cpuC1');
+    const cpuOverallBar = document.getElementById('cpuOverallBar');
+    const cpuC0Bar      = document.getElementById('cpuC0Bar');
+    const cpuC1Bar      = document.getElementById('cpuC1Bar');
+
+    const overallValue = telemetryData.summary.cpu.overall;
+  const core0Value   = telemetryData.summary.cpu.cores[0];
+  const core1Value   = telemetryData.summary.cpu.cores[1];
+
+  cpuOverall.textContent = `${overallValue.toFixed(1)} %`;
+  cpuC0.textContent      = `${core0Value.toFixed(1)} %`;
+  cpuC1.textContent      = `${core1Value.toFixed(1)} %`;
+
+  // Update progress bars with color coding
+  updateCpuProgressBar(cpuOverallBar, overallValue);
+  updateCpuProgressBar(cpuC0Bar, core0Value);
+  updateCpuProgressBar(cpuC1Bar, core1Value);
+
+  // Update tooltips on containers (containers are always full width and hoverable)
+  const cpuOverallContainer = cpuOverallBar ? cpuOverallBar.closest('.progress-container') : null;
+  const cpuC0Container = cpuC0Bar ? cpuC0Bar.closest('.progress-container') : null;
+  const cpuC1Container = cpuC1Bar ? cpuC1Bar.closest('.progress-container') : null;
+
+  if (cpuOverallContainer)
+  {
+    cpuOverallContainer.setAttribute('aria-label', `Overall CPU: ${overallValue.toFixed(1)}%`);
+    cpuOverallContainer.setAttribute('role', 'tooltip');
+    cpuOverallContainer.setAttribute('data-microtip-position', 'bottom');
+  }
+  if (cpuC0Container)
+  {
+    cpuC0Container.setAttribute('aria-label', `Core 0: ${core0Value.toFixed(1)}%`);
+    cpuC0Container.setAttribute('role', 'tooltip');
+    cpuC0Container.setAttribute('data-microtip-position', 'bottom');
+  }
+  if (cpuC1Container)
+  {
+    cpuC1Container.setAttribute('aria-label', `Core 1: ${core1Value.toFixed(1)}%`);
+    cpuC1Container.setAttribute('role', 'tooltip');
+    cpuC1Container.setAttribute('data-microtip-position', 'bottom');
+  }
+
+  // Update DRAM visualizations
+  const dramTotal   = telemetryData.summary.mem.dram.total;
+  const dramFree    = telemetryData.summary.mem.dram.free;
+  const dramUsed    = dramTotal - dramFree;
+  const dramUsedPct = telemetryData.summary.mem.dram.usedPct;
+  const dramLargest = telemetryData.summary.mem.dram.largest;
+
+  // Update text elements
+  const dramUsedPctEl = document.getElementById('dramUsedPct');
+  const dramFreeEl    = document.getElementById('dramFree');
+  const dramUsedEl    = document.getElementById('dramUsed');
+  const dramLargestEl = document.getElementById('dramLargest');
+  const dramTotalEl   = document.getElementById('dramTotal');
+
+  dramUsedPctEl.textContent = `${dramUsedPct.toFixed(1)} %`;
+  dramFreeEl.textContent    = formatSize(dramFree, 'kb', true);
+  dramFreeEl.setAttribute('aria-label', formatSize(dramFree, 'bytes', true));
+  dramFreeEl.setAttribute('role', 'tooltip');
+  dramFreeEl.setAttribute('data-microtip-position', 'bottom');
+  dramUsedEl.textContent    = formatSize(dramUsed, 'kb', true);
+  dramUsedEl.setAttribute('aria-label', formatSize(dramUsed, 'bytes', true));
+  dramUsedEl.setAttribute('role', 'tooltip');
+  dramUsedEl.setAttribute('data-microtip-position', 'bottom');
+  dramLargestEl.textContent = formatSize(dramLargest, 'kb', true);
+  dramLargestEl.setAttribute('aria-label', formatSize(dramLargest, 'bytes', true));
+  dramLargestEl.setAttribute('role', 'tooltip');
+  dramLargestEl.setAttribute('data-microtip-position', 'bottom');
+  dramTotalEl.textContent   = formatSize(dramTotal, 'kb', true);
+  dramTotalEl.setAttribute('aria-label', formatSize(dramTotal, 'bytes', true));
+  dramTotalEl.setAttribute('role', 'tooltip');
+  dramTotalEl.setAttribute('data-microtip-position', 'bottom-left');
+
+  // Update WiFi RSSI icon if available in telemetry
+  if (telemetryData.summary && telemetryData.summary.wifiRssi !== undefined)
+  {
+    updateWifiRssi(telemetryData.summary.wifiRssi);
+  }
+
+  // Update usage progress bar (green for used, grey background for free)
+  const dramUsedBar = document.getElementById('dramUsedBar');
+  const dramUsedContainer = dramUsedBar ? dramUsedBar.closest('.progress-container') : null;
+  if (dramUsedBar)
+  {
+    updateDramProgressBar(dramUsedBar, dramUsedPct);
+    // Update tooltip with used/free/total on container
+    if (dramUsedContainer)
     {
-      cpuC1Container.setAttribute('aria-label', `Core 1: ${core1Value.toFixed(1)}%`);
-      cpuC1Container.setAttribute('role', 'tooltip');
-      cpuC1Container.setAttribute('data-microtip-position', 'bottom');
+      dramUsedContainer.setAttribute('aria-label', `DRAM: ${formatSize(dramUsed, 'bytes', true)} used (${dramUsedPct.toFixed(1)}%), ${formatSize(dramFree, 'bytes', true)} free, ${formatSize(dramTotal, 'bytes', true)} total`);
+      dramUsedContainer.setAttribute('role', 'tooltip');
+      dramUsedContainer.setAttribute('data-microtip-position', 'bottom');
     }
+  }
 
-    // Update DRAM visualizations
-    const dramTotal   = telemetryData.summary.mem.dram.total;
-    const dramFree    = telemetryData.summary.mem.dram.free;
-    const dramUsed    = dramTotal - dramFree;
-    const dramUsedPct = telemetryData.summary.mem.dram.usedPct;
-    const dramLargest = telemetryData.summary.mem.dram.largest;
+  // Update fragmentation bar (largest block as percentage of total, positioned from right)
+  const dramFragmentationBar = document.getElementById('dramFragmentationBar');
+  if (dramFragmentationBar && dramTotal > 0)
+  {
+    // Show largest block as a percentage of total, positioned from the right edge
+    const largestPct = (dramLargest / dramTotal) * 100;
+    dramFragmentationBar.style.width = `${largestPct}%`;
+    dramFragmentationBar.style.display = (largestPct > 0 && largestPct <= 100) ? 'block' : 'none';
+  }
+
+  // Update PSRAM visualizations
+  const psramSection = document.getElementById('psramSection');
+  if (telemetryData.summary.mem.psram.present)
+  {
+    const psramTotal   = telemetryData.summary.mem.psram.total;
+    const psramFree    = telemetryData.summary.mem.psram.free;
+    const psramUsed    = psramTotal - psramFree;
+    const psramUsedPct = telemetryData.summary.mem.psram.usedPct;
+
+    // Show PSRAM section
+    psramSection.classList.remove('hidden');
 
     // Update text elements
-    const dramUsedPctEl = document.getElementById('dramUsedPct');
-    const dramFreeEl    = document.getElementById('dramFree');
-    const dramUsedEl    = document.getElementById('dramUsed');
-    const dramLargestEl = document.getElementById('dramLargest');
-    const dramTotalEl   = document.getElementById('dramTotal');
-
-    dramUsedPctEl.textContent = `${dramUsedPct.toFixed(1)} %`;
-    dramFreeEl.textContent    = formatSize(dramFree, 'kb', true);
-    dramFreeEl.setAttribute('aria-label', formatSize(dramFree, 'bytes', true));
-    dramFreeEl.setAttribute('role', 'tooltip');
-    dramFreeEl.setAttribute('data-microtip-position', 'bottom');
-    dramUsedEl.textContent    = formatSize(dramUsed, 'kb', true);
-    dramUsedEl.setAttribute('aria-label', formatSize(dramUsed, 'bytes', true));
-    dramUsedEl.setAttribute('role', 'tooltip');
-    dramUsedEl.setAttribute('data-microtip-position', 'bottom');
-    dramLargestEl.textContent = formatSize(dramLargest, 'kb', true);
-    dramLargestEl.setAttribute('aria-label', formatSize(dramLargest, 'bytes', true));
-    dramLargestEl.setAttribute('role', 'tooltip');
-    dramLargestEl.setAttribute('data-microtip-position', 'bottom');
-    dramTotalEl.textContent   = formatSize(dramTotal, 'kb', true);
-    dramTotalEl.setAttribute('aria-label', formatSize(dramTotal, 'bytes', true));
-    dramTotalEl.setAttribute('role', 'tooltip');
-    dramTotalEl.setAttribute('data-microtip-position', 'bottom-left');
-
-    // Update WiFi RSSI icon if available in telemetry
-    if (telemetryData.summary && telemetryData.summary.wifiRssi !== undefined)
-    {
-      updateWifiRssi(telemetryData.summary.wifiRssi);
-    }
+    const psramUsedPctEl = document.getElementById('psramUsedPct');
+    const psramFreeEl    = document.getElementById('psramFree');
+    const psramUsedEl    = document.getElementById('psramUsed');
+    const psramTotalEl   = document.getElementById('psramTotal');
+
+    psramUsedPctEl.textContent = `${psramUsedPct.toFixed(1)} %`;
+    psramFreeEl.textContent    = formatSize(psramFree, 'kb', true);
+    psramFreeEl.setAttribute('aria-label', formatSize(psramFree, 'bytes', true));
+    psramFreeEl.setAttribute('role', 'tooltip');
+    psramFreeEl.setAttribute('data-microtip-position', 'bottom');
+    psramUsedEl.textContent    = formatSize(psramUsed, 'kb', true);
+    psramUsedEl.setAttribute('aria-label', formatSize(psramUsed, 'bytes', true));
+    psramUsedEl.setAttribute('role', 'tooltip');
+    psramUsedEl.setAttribute('data-microtip-position', 'bottom');
+    psramTotalEl.textContent   = formatSize(psramTotal, 'kb', true);
+    psramTotalEl.setAttribute('aria-label', formatSize(psramTotal, 'bytes', true));
+    psramTotalEl.setAttribute('role', 'tooltip');
+    psramTotalEl.setAttribute('data-microtip-position', 'bottom-left');
 
     // Update usage progress bar (green for used, grey background for free)
-    const dramUsedBar = document.getElementById('dramUsedBar');
-    const dramUsedContainer = dramUsedBar ? dramUsedBar.closest('.progress-container') : null;
-    if (dramUsedBar)
+    const psramUsedBar = document.getElementById('psramUsedBar');
+    const psramUsedContainer = psramUsedBar ? psramUsedBar.closest('.progress-container') : null;
+    if (psramUsedBar)
     {
-      updateDramProgressBar(dramUsedBar, dramUsedPct);
+      updatePsramProgressBar(psramUsedBar, psramUsedPct);
       // Update tooltip with used/free/total on container
-      if (dramUsedContainer)
-      {
-        dramUsedContainer.setAttribute('aria-label', `DRAM: ${formatSize(dramUsed, 'bytes', true)} used (${dramUsedPct.toFixed(1)}%), ${formatSize(dramFree, 'bytes', true)} free, ${formatSize(dramTotal, 'bytes', true)} total`);
-        dramUsedContainer.setAttribute('role', 'tooltip');
-        dramUsedContainer.setAttribute('data-microtip-position', 'bottom');
-      }
-    }
-
-    // Update fragmentation bar (largest block as percentage of total, positioned from right)
-    const dramFragmentationBar = document.getElementById('dramFragmentationBar');
-    if (dramFragmentationBar && dramTotal > 0)
-    {
-      // Show largest block as a percentage of total, positioned from the right edge
-      const largestPct = (dramLargest / dramTotal) * 100;
-      dramFragmentationBar.style.width = `${largestPct}%`;
-      dramFragmentationBar.style.display = (largestPct > 0 && largestPct <= 100) ? 'block' : 'none';
-    }
-
-    // Update PSRAM visualizations
-    const psramSection = document.getElementById('psramSection');
-    if (telemetryData.summary.mem.psram.present)
-    {
-      const psramTotal   = telemetryData.summary.mem.psram.total;
-      const psramFree    = telemetryData.summary.mem.psram.free;
-      const psramUsed    = psramTotal - psramFree;
-      const psramUsedPct = telemetryData.summary.mem.psram.usedPct;
-
-      // Show PSRAM section
-      psramSection.classList.remove('hidden');
-
-      // Update text elements
-      const psramUsedPctEl = document.getElementById('psramUsedPct');
-      const psramFreeEl    = document.getElementById('psramFree');
-      const psramUsedEl    = document.getElementById('psramUsed');
-      const psramTotalEl   = document.getElementById('psramTotal');
-
-      psramUsedPctEl.textContent = `${psramUsedPct.toFixed(1)} %`;
-      psramFreeEl.textContent    = formatSize(psramFree, 'kb', true);
-      psramFreeEl.setAttribute('aria-label', formatSize(psramFree, 'bytes', true));
-      psramFreeEl.setAttribute('role', 'tooltip');
-      psramFreeEl.setAttribute('data-microtip-position', 'bottom');
-      psramUsedEl.textContent    = formatSize(psramUsed, 'kb', true);
-      psramUsedEl.setAttribute('aria-label', formatSize(psramUsed, 'bytes', true));
-      psramUsedEl.setAttribute('role', 'tooltip');
-      psramUsedEl.setAttribute('data-microtip-position', 'bottom');
-      psramTotalEl.textContent   = formatSize(psramTotal, 'kb', true);
-      psramTotalEl.setAttribute('aria-label', formatSize(psramTotal, 'bytes', true));
-      psramTotalEl.setAttribute('role', 'tooltip');
-      psramTotalEl.setAttribute('data-microtip-position', 'bottom-left');
-
-      // Update usage progress bar (green for used, grey background for free)
-      const psramUsedBar = document.getElementById('psramUsedBar');
-      const psramUsedContainer = psramUsedBar ? psramUsedBar.closest('.progress-container') : null;
-      if (psramUsedBar)
+      if (psramUsedContainer)
       {
-        updatePsramProgressBar(psramUsedBar, psramUsedPct);
-        // Update tooltip with used/free/total on container
-        if (psramUsedContainer)
-        {
-          psramUsedContainer.setAttribute('aria-label', `PSRAM: ${formatSize(psramUsed, 'bytes', true)} used (${psramUsedPct.toFixed(1)}%), ${formatSize(psramFree, 'bytes', true)} free, ${formatSize(psramTotal, 'bytes', true)} total`);
-          psramUsedContainer.setAttribute('role', 'tooltip');
-          psramUsedContainer.setAttribute('data-microtip-position', 'bottom');
-        }
+        psramUsedContainer.setAttribute('aria-label', `PSRAM: ${formatSize(psramUsed, 'bytes', true)} used (${psramUsedPct.toFixed(1)}%), ${formatSize(psramFree, 'bytes', true)} free, ${formatSize(psramTotal, 'bytes', true)} total`);
+        psramUsedContainer.setAttribute('role', 'tooltip');
+        psramUsedContainer.setAttribute('data-microtip-position', 'bottom');
       }
     }
-    else
-    {
-      psramSection.classList.add('hidden');
-    }
-
-    // Detect task changes: if new tasks appeared or tasks disappeared, refresh table immediately
-    const previousTaskNames = AppState.data.lastTelemetryTaskNames;
-    const hasNewTasks       = [...currentTaskNames].some(name => !previousTaskNames.has(name));
-    const hasRemovedTasks   = [...previousTaskNames].some(name => !currentTaskNames.has(name));
+  }
+  else
+  {
+    psramSection.classList.add('hidden');
+  }
 
-    if (hasNewTasks || hasRemovedTasks)
-    {
-      // Task was added or removed - refresh table immediately to show current state
-      updateTable();
-    }
+  // Detect task changes: if new tasks appeared or tasks disappeared, refresh table immediately
+  const previousTaskNames = AppState.data.lastTelemetryTaskNames;
+  const hasNewTasks       = [...currentTaskNames].some(name => !previousTaskNames.has(name));
+  const hasRemovedTasks   = [...previousTaskNames].some(name => !currentTaskNames.has(name));
 
-    // Update tracked task names for next comparison
-    AppState.data.lastTelemetryTaskNames = new Set(currentTaskNames);
+  if (hasNewTasks || hasRemovedTasks)
+  {
+    // Task was added or removed - refresh table immediately to show current state
+    updateTable();
+  }
 
-      // Update charts with new telemetry data
-      updateCharts(telemetryData.current, currentTaskNames);
+  // Update tracked task names for next comparison
+  AppState.data.lastTelemetryTaskNames = new Set(currentTaskNames);
 
-      // Update table rows for registered tasks with telemetry data
-      updateTableRowsFromTelemetry(telemetryData.current);
-    }
-    else
-    {
-      // When paused, still update chart data but don't trigger visual update
-      // This allows data to accumulate in the background
-      updateCharts(telemetryData.current, currentTaskNames);
-    }
+    // Update charts with new telemetry data
+    updateCharts(telemetryData.current, currentTaskNames);
 
-    updateStatusPopup();
+    // Update table rows for registered tasks with telemetry data
+    updateTableRowsFromTelemetry(telemetryData.current);
   }
-  catch (error)
+  else
   {
-    AppState.status.consecutiveFailures++;
-    updateStatusPopup();
+    // When paused, still update chart data but don't trigger visual update
+    // This allows data to accumulate in the background
+    updateCharts(telemetryData.current, currentTaskNames);
   }
+
+  updateStatusPopup();
 }
 
 // Application startup (entry point)
@@ -3,7 +3,8 @@ const API_ROUTES = {
   HISTORY   : '/history',
   TELEMETRY : '/telemetry',
   TASKS     : '/tasks',
-  HARDWARE  : '/hardware'
+  HARDWARE  : '/hardware',
+  EVENTS    : '/events'     // Server-Sent Events: 'telemetry' every sample, 'tasks' every few samples
 };
 
 const TELEMETRY_TIMEOUT_MS = 4000;
@@ -197,6 +198,7 @@ const AppState = {
     lastTelemetrySuccess: null,  // Timestamp of last successful telemetry fetch
     lastTableSuccess    : null,  // Timestamp of last successful table fetch
     consecutiveFailures : 0,     // Count of consecutive API failures
+    polling             : false, // Polling /telemetry and /tasks instead of the event stream
     currentStatus       : null   // Current status message type
   }
 };
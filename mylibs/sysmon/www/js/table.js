@@ -450,139 +450,149 @@ async function updateTable()
       throw new Error("Fetch failed");
     }
     const taskData = await response.json();
-    AppState.status.lastTableSuccess = Date.now();
-    AppState.status.consecutiveFailures = 0;
-
-    // Sync registeredTasks set and taskInfo with current task list
-    // Remove tasks that no longer exist
-    const currentTaskNames = new Set(Object.keys(taskData));
-    const tasksToRemove = [];
-    
-    // Find tasks that are no longer present
-    for (const taskName of AppState.data.registeredTasks)
-    {
-      if (!currentTaskNames.has(taskName))
-      {
-        tasksToRemove.push(taskName);
-      }
-    }
-    
-    // Remove tasks that no longer exist
-    for (const taskName of tasksToRemove)
+    applyTaskData(taskData);
+  }
+  catch (error)
+  {
+    console.error("updateTable error:", error);
+    AppState.status.consecutiveFailures++;
+    updateStatusPopup();
+  }
+}
+
+/**
+ * Apply one task document (/tasks response or pushed 'tasks' event) to the task info table.
+ *
+ * @param {Object} taskData - Task name -> task metadata.
+ */
+function applyTaskData(taskData)
+{
+  AppState.status.lastTableSuccess = Date.now();
+  AppState.status.consecutiveFailures = 0;
+
+  // Sync registeredTasks set and taskInfo with current task list
+  // Remove tasks that no longer exist
+  const currentTaskNames = new Set(Object.keys(taskData));
+  const tasksToRemove = [];
+  
+  // Find tasks that are no longer present
+  for (const taskName of AppState.data.registeredTasks)
+  {
+    if (!currentTaskNames.has(taskName))
     {
-      AppState.data.registeredTasks.delete(taskName);
-      delete AppState.data.taskInfo[taskName];
+      tasksToRemove.push(taskName);
     }
-    
-    // Update taskInfo and registeredTasks for current tasks
-    AppState.data.taskInfo = {};
-    AppState.data.registeredTasks.clear();
-    for (const [taskName, taskInfo] of Object.entries(taskData))
+  }
+  
+  // Remove tasks that no longer exist
+  for (const taskName of tasksToRemove)
+  {
+    AppState.data.registeredTasks.delete(taskName);
+    delete AppState.data.taskInfo[taskName];
+  }
+  
+  // Update taskInfo and registeredTasks for current tasks
+  AppState.data.taskInfo = {};
+  AppState.data.registeredTasks.clear();
+  for (const [taskName, taskInfo] of Object.entries(taskData))
+  {
+    AppState.data.taskInfo[taskName] = taskInfo;
+    if (taskInfo.stackSize !== undefined && taskInfo.stackSize > 0)
     {
-      AppState.data.taskInfo[taskName] = taskInfo;
-      if (taskInfo.stackSize !== undefined && taskInfo.stackSize > 0)
-      {
-        AppState.data.registeredTasks.add(taskName);
-      }
+      AppState.data.registeredTasks.add(taskName);
     }
+  }
 
-    const tbody = document.querySelector('#taskTable tbody');
-    if (!tbody)
-    {
-      return;
-    }
+  const tbody = document.querySelector('#taskTable tbody');
+  if (!tbody)
+  {
+    return;
+  }
 
-    // Build a map of existing rows by task name
-    const existingRows = tbody.querySelectorAll('tr');
-    const rowMap = new Map();
-    for (const row of existingRows)
+  // Build a map of existing rows by task name
+  const existingRows = tbody.querySelectorAll('tr');
+  const rowMap = new Map();
+  for (const row of existingRows)
+  {
+    const taskNameCell = row.querySelector('[data-column="task-name"]');
+    if (taskNameCell)
     {
-      const taskNameCell = row.querySelector('[data-column="task-name"]');
-      if (taskNameCell)
+      const taskName = taskNameCell.textContent.trim();
+      if (taskName)
       {
-        const taskName = taskNameCell.textContent.trim();
-        if (taskName)
-        {
-          rowMap.set(taskName, row);
-        }
+        rowMap.set(taskName, row);
       }
     }
+  }
 
-    // Separate tasks into system and non-system tasks
-    const nonSystemTasks = [];
-    const systemTasks = [];
-    for (const [taskName, taskInfo] of Object.entries(taskData))
+  // Separate tasks into system and non-system tasks
+  const nonSystemTasks = [];
+  const systemTasks = [];
+  for (const [taskName, taskInfo] of Object.entries(taskData))
+  {
+    const isSystemTask = SYSTEM_TASKS.hasOwnProperty(taskName);
+    if (isSystemTask)
     {
-      const isSystemTask = SYSTEM_TASKS.hasOwnProperty(taskName);
-      if (isSystemTask)
-      {
-        systemTasks.push([taskName, taskInfo]);
-      }
-      else
-      {
-        nonSystemTasks.push([taskName, taskInfo]);
-      }
+      systemTasks.push([taskName, taskInfo]);
+    }
+    else
+    {
+      nonSystemTasks.push([taskName, taskInfo]);
     }
+  }
 
-    // Combine both non-system and system tasks into one array with a flag
-    const allTasks = [
-      ...nonSystemTasks.map(([taskName, taskInfo]) => ({ taskName, taskInfo, isSystem: false })),
-      ...systemTasks.map(([taskName, taskInfo]) => ({ taskName, taskInfo, isSystem: true })),
-    ];
+  // Combine both non-system and system tasks into one array with a flag
+  const allTasks = [
+    ...nonSystemTasks.map(([taskName, taskInfo]) => ({ taskName, taskInfo, isSystem: false })),
+    ...systemTasks.map(([taskName, taskInfo]) => ({ taskName, taskInfo, isSystem: true })),
+  ];
 
-    for (const { taskName, taskInfo, isSystem } of allTasks)
+  for (const { taskName, taskInfo, isSystem } of allTasks)
+  {
+    const existingRow = rowMap.get(taskName);
+    if (existingRow)
     {
-      const existingRow = rowMap.get(taskName);
-      if (existingRow)
-      {
-        // Row exists - update it incrementally
-        updateTableRow(existingRow, taskName, taskInfo);
+      // Row exists - update it incrementally
+      updateTableRow(existingRow, taskName, taskInfo);
 
-        // For system tasks, move the row to the bottom if it's not already there
-        if (isSystem)
-        {
-          existingRow.remove();
-          tbody.appendChild(existingRow);
-        }
-        // Remove from map so we know it's been processed
-        rowMap.delete(taskName);
-      }
-      else
+      // For system tasks, move the row to the bottom if it's not already there
+      if (isSystem)
       {
-        // Row doesn't exist - create a new one (at the bottom for both)
-        const newRow = createTableRow(taskName, taskInfo);
-        tbody.appendChild(newRow);
+        existingRow.remove();
+        tbody.appendChild(existingRow);
       }
+      // Remove from map so we know it's been processed
+      rowMap.delete(taskName);
+    }
+    else
+    {
+      // Row doesn't exist - create a new one (at the bottom for both)
+      const newRow = createTableRow(taskName, taskInfo);
+      tbody.appendChild(newRow);
     }
+  }
 
 
-    // Remove rows for tasks that no longer exist
-    for (const [taskName, row] of rowMap.entries())
+  // Remove rows for tasks that no longer exist
+  for (const [taskName, row] of rowMap.entries())
+  {
+    row.remove();
+  }
+
+  // Initialize or refresh Tablesort
+  const tableElement = document.getElementById('taskTable');
+  if (tableElement && typeof Tablesort !== 'undefined')
+  {
+    if (!AppState.ui.tableSorter.tasks)
     {
-      row.remove();
+      AppState.ui.tableSorter.tasks = new Tablesort(tableElement);
     }
-
-    // Initialize or refresh Tablesort
-    const tableElement = document.getElementById('taskTable');
-    if (tableElement && typeof Tablesort !== 'undefined')
+    else
     {
-      if (!AppState.ui.tableSorter.tasks)
-      {
-        AppState.ui.tableSorter.tasks = new Tablesort(tableElement);
-      }
-      else
-      {
-        AppState.ui.tableSorter.tasks.refresh();
-      }
+      AppState.ui.tableSorter.tasks.refresh();
     }
-    
-    updateStatusPopup();
-  }
-  catch (error)
-  {
-    console.error("updateTable error:", error);
-    AppState.status.consecutiveFailures++;
-    updateStatusPopup();
   }
+  
+  updateStatusPopup();
 }
 
@@ -0,0 +1,62 @@
+#pragma once
+#ifndef TASK_TRACE_H
+#define TASK_TRACE_H
+
+/*
+ * Contabilizare CPU per task din comutarile de context (CONFIG_TASK_TRACE_ENABLE).
+ *
+ * Hook-urile FreeRTOS (task_trace_hooks.h) scriu fiecare switch in / switch out / ready /
+ * delete, cu stamp-ul esp_timer in microsecunde si handle-ul task-ului, in ring-ul core-ului
+ * pe care ruleaza (task_trace_ring.h). Un esp_timer goleste ring-urile la
+ * CONFIG_TASK_TRACE_POLL_MS in agregator (task_trace_agg.h); task_trace_snapshot goleste si el
+ * ring-urile si copiaza totalurile. Nici hook-urile, nici citirea nu suspenda scheduler-ul.
+ *
+ * Timpul vine din esp_timer (systimer), nu din CCOUNT: e comun celor doua core-uri (latenta
+ * unui task trezit de pe celalalt core se poate scadea direct) si nu se schimba cu frecventa
+ * CPU (CONFIG_PM_ENABLE). Rezolutia e de 1 us.
+ *
+ * Consumatorii (sysmon, `tasks sched` din CLI) pastreaza copia anterioara si fac diferenta,
+ * cu task_trace_find(task, generation) pentru randul aceluiasi task.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "esp_err.h"
+#include "task_trace_agg.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* #ifdef __cplusplus */
+
+typedef struct {
+    uint32_t          now;         // Stamp (us) everything is accounted up to
+    uint32_t          task_count;  // Tasks tracked, may be more than were copied
+    uint32_t          core_count;
+    uint32_t          untracked;   // Events of tasks that did not fit in the table
+    task_trace_core_t cores[TASK_TRACE_MAX_CORES];
+} task_trace_summary_t;
+
+/**
+ * @brief Allocates the task table and starts recording. Safe to call more than once.
+ * @return ESP_OK, ESP_ERR_NO_MEM, or ESP_ERR_NOT_SUPPORTED with CONFIG_TASK_TRACE_ENABLE off
+ */
+esp_err_t task_trace_start(void);
+
+bool task_trace_is_running(void);
+
+/**
+ * @brief Drains the rings and copies the per-task totals. Any task, never from an ISR.
+ *
+ * @param tasks   Output rows (table order), may be NULL with max 0 for the summary only
+ * @param max     Rows available in tasks
+ * @param summary Output, may be NULL
+ * @return rows copied, 0 when the trace is not running
+ */
+uint32_t task_trace_snapshot(task_trace_task_t* tasks, uint32_t max, task_trace_summary_t* summary);
+
+#ifdef __cplusplus
+}
+#endif /* #ifdef __cplusplus */
+
+#endif /* #ifndef TASK_TRACE_H */
@@ -0,0 +1,129 @@
+#pragma once
+#ifndef TASK_TRACE_AGG_H
+#define TASK_TRACE_AGG_H
+
+/*
+ * Agregatorul: citeste ring-urile tuturor core-urilor (task_trace_ring.h) in ordinea
+ * timpului si tine, per task, totaluri cumulative: timp de rulare, comutari, preemptari,
+ * treziri si latenta de planificare (ready -> switched in). Consumatorii (sysmon, CLI) copiaza
+ * totalurile cu task_trace_agg_copy si fac singuri diferenta intre doua copii, ca la
+ * ulRunTimeCounter, dar fara uxTaskGetSystemState si fara sa suspende scheduler-ul.
+ *
+ * Clasificarea la switch in, dupa ce a vazut agregatorul de la ultimul switch out al task-ului:
+ *   - READY intre ele      -> task-ul s-a blocat si a fost trezit: wakeups++, latenta = IN - READY
+ *   - nimic intre ele      -> task-ul a ramas ready (preemptat sau yield): preemptions++
+ * Un READY cu stamp dinaintea ultimei comutari a task-ului e vechi si e ignorat.
+ *
+ * Task-urile sunt cheie dupa handle (tabela cu adresare deschisa, capacitate putere a lui 2).
+ * La DELETE randul se elibereaza; un handle refolosit de un task nou primeste alt `generation`,
+ * asa ca un consumator nu scade contoarele task-ului vechi din cele ale celui nou.
+ *
+ * Timpul e in microsecunde, pe 32 de biti (diferentele sunt corecte peste wrap, cat timp
+ * intre doua drain-uri trec mai putin de ~35 de minute).
+ *
+ * Fara dependente ESP-IDF: acelasi cod ruleaza pe placa si in host/bench_task_trace.c.
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "task_trace_ring.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* #ifdef __cplusplus */
+
+#define TASK_TRACE_MAX_CORES (2)
+#define TASK_TRACE_NAME_LEN  (16)  // configMAX_TASK_NAME_LEN
+
+typedef enum {
+    TASK_TRACE_STATE_NONE = 0,  // Not seen switching yet, or its core lost events
+    TASK_TRACE_STATE_RUNNING,   // Switched in on `core`
+    TASK_TRACE_STATE_OUT,       // Switched out, not woken since (still ready unless it blocked)
+    TASK_TRACE_STATE_READY,     // Woken at `mark`, waiting to be switched in
+} task_trace_state_t;
+
+typedef struct {
+    uint32_t task;            // Task handle, 0 = free slot
+    uint32_t generation;      // Different for every task the handle has belonged to
+    uint64_t run_us;          // Time running, accounted up to the last drain
+    uint32_t switches;        // Times switched in
+    uint32_t preemptions;     // Switched in again without having blocked (preempted or yielded)
+    uint32_t wakeups;         // Switched in after being woken, one latency sample each
+    uint64_t latency_sum_us;  // Sum of ready -> switched in
+    uint32_t latency_max_us;  // Largest ready -> switched in since the task was first seen
+    uint32_t mark;            // Stamp of the last switch in / switch out / ready
+    int8_t   core;            // Core it runs or last ran on, -1 before the first switch in
+    uint8_t  state;           // task_trace_state_t
+    char     name[TASK_TRACE_NAME_LEN];
+} task_trace_task_t;
+
+typedef struct {
+    uint32_t running;     // Task running now, 0 = unknown (before the first switch in, after a gap)
+    uint32_t idle;        // Idle task of this core, its time is not busy (0 = none)
+    uint32_t clock;       // Stamp the core is accounted up to
+    bool     started;     // clock is valid
+    uint64_t elapsed_us;  // Time accounted on this core
+    uint64_t busy_us;     // ... while a task other than `idle` was running
+    uint64_t unknown_us;  // ... while the running task was unknown
+    uint32_t switches;    // Switch ins
+    uint32_t gaps;        // Gap markers seen (the ring was full)
+    uint32_t lost;        // Events dropped by the ring, copied at every drain
+} task_trace_core_t;
+
+/* Fills `name` (len bytes, NUL terminated) for a task the aggregator sees for the first time */
+typedef void (*task_trace_name_fn_t)(void* ctx, uint32_t task, char* name, size_t len);
+
+typedef struct {
+    task_trace_task_t*   tasks;     // Open addressing table, `capacity` slots
+    uint32_t             capacity;  // Power of 2
+    uint32_t             count;     // Used slots, at most capacity / 2
+    uint32_t             generation;
+    uint32_t             core_count;
+    task_trace_core_t    cores[TASK_TRACE_MAX_CORES];
+    uint64_t             events;    // Events processed
+    uint32_t             deleted;   // Tasks removed by DELETE
+    uint32_t             untracked; // Events for tasks that did not fit in the table
+    task_trace_name_fn_t name_fn;
+    void*                name_ctx;
+} task_trace_agg_t;
+
+/* capacity: power of 2, the table tracks up to capacity / 2 tasks. name_fn may be NULL */
+void task_trace_agg_init(task_trace_agg_t* agg, task_trace_task_t* table, uint32_t capacity, uint32_t core_count,
+    task_trace_name_fn_t name_fn, void* name_ctx);
+
+void task_trace_agg_set_idle(task_trace_agg_t* agg, uint32_t core, uint32_t idle_task);
+
+/* One event, in time order across cores (task_trace_agg_drain does the ordering) */
+void task_trace_agg_event(task_trace_agg_t* agg, uint32_t core, uint32_t stamp, uint32_t word);
+
+/* Charges the running tasks of every core up to stamp */
+void task_trace_agg_advance(task_trace_agg_t* agg, uint32_t stamp);
+
+/**
+ * @brief Merges the rings (one per core) by stamp and processes every event stamped at or
+ *        before `watermark`, then advances the cores to it.
+ *
+ * The watermark is a time all producers are known to have passed, so no event older than it can
+ * still arrive: later events stay in their ring for the next drain. On equal stamps from
+ * different cores switch outs go first, then READY, then switch ins and deletes. A core whose ring dropped events since the
+ * previous drain is not advanced: its gap marker, stamped with the first lost event, is still to
+ * come.
+ *
+ * @return events processed
+ */
+uint32_t task_trace_agg_drain(task_trace_agg_t* agg, task_trace_ring_t* rings, uint32_t watermark);
+
+/* Copies the tracked tasks (table order) into out, returns how many were copied */
+uint32_t task_trace_agg_copy(const task_trace_agg_t* agg, task_trace_task_t* out, uint32_t max);
+
+/* Row of `task` in a copy, NULL if missing or if the handle now belongs to another task */
+const task_trace_task_t* task_trace_find(const task_trace_task_t* tasks, uint32_t count, uint32_t task,
+    uint32_t generation);
+
+#ifdef __cplusplus
+}
+#endif /* #ifdef __cplusplus */
+
+#endif /* #ifndef TASK_TRACE_AGG_H */
@@ -0,0 +1,37 @@
+#pragma once
+#ifndef TASK_TRACE_HOOKS_H
+#define TASK_TRACE_HOOKS_H
+
+/*
+ * Hook-urile de trace ale FreeRTOS, legate la ring-urile din task_trace.c. Headerul e
+ * inclus fortat (-include) in toate sursele componentei freertos, inaintea FreeRTOS.h, de
+ * mylibs/task-trace-v001/CMakeLists.txt: FreeRTOS.h defineste hook-urile goale doar daca
+ * nu le-a definit deja cineva. Doar tasks.c le expandeaza.
+ *
+ * Nu include nimic din FreeRTOS (inca nu e inclus), de aceea TCB-ul trece ca void*.
+ * Toate se apeleaza din kernel cu intreruperile mascate pe core-ul curent.
+ */
+
+#ifndef __ASSEMBLER__
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* #ifdef __cplusplus */
+
+void task_trace_hook_switched_in(void);
+void task_trace_hook_switched_out(void);
+void task_trace_hook_ready(void* tcb);
+void task_trace_hook_delete(void* tcb);
+
+#ifdef __cplusplus
+}
+#endif /* #ifdef __cplusplus */
+
+#define traceTASK_SWITCHED_IN()               task_trace_hook_switched_in()
+#define traceTASK_SWITCHED_OUT()              task_trace_hook_switched_out()
+#define traceMOVED_TASK_TO_READY_STATE(pxTCB) task_trace_hook_ready((void*) (pxTCB))
+#define traceTASK_DELETE(pxTCB)               task_trace_hook_delete((void*) (pxTCB))
+
+#endif /* #ifndef __ASSEMBLER__ */
+
+#endif /* #ifndef TASK_TRACE_HOOKS_H */
@@ -0,0 +1,113 @@
+#pragma once
+#ifndef TASK_TRACE_RING_H
+#define TASK_TRACE_RING_H
+
+/*
+ * Ring-ul de evenimente al unui core: un singur producator (hook-urile FreeRTOS de pe acel
+ * core, apelate cu intreruperile mascate, deci fara reintrare) si un singur consumator
+ * (task_trace_poll, sub mutex-ul agregatorului). Fara lock: producatorul scrie slotul si
+ * publica `head` cu release, consumatorul citeste pana la `head` si elibereaza cu `tail`.
+ *
+ * Ring plin -> evenimentul se pierde (numarat in `lost`), producatorul nu asteapta niciodata.
+ * Primul eveniment scris dupa o pierdere e precedat de un marker (word == 0, fara task) cu
+ * stamp-ul primului eveniment pierdut: agregatorul stie din ce moment nu mai stie ce ruleaza
+ * pe acel core.
+ *
+ * Fara dependente ESP-IDF: acelasi cod ruleaza pe placa si in host/bench_task_trace.c.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* #ifdef __cplusplus */
+
+/* Event type, in the 2 low bits of word (task handles are at least 4 byte aligned) */
+#define TASK_TRACE_EV_IN     (0u)  // Task switched in on this core
+#define TASK_TRACE_EV_OUT    (1u)  // Task switched out on this core
+#define TASK_TRACE_EV_READY  (2u)  // Task moved to the ready list (woken, on any core)
+#define TASK_TRACE_EV_DELETE (3u)  // Task deleted, its handle may be reused
+#define TASK_TRACE_EV_MASK   (3u)
+
+#define TASK_TRACE_EV_TYPE(word) ((word) & TASK_TRACE_EV_MASK)
+#define TASK_TRACE_EV_TASK(word) ((word) & ~TASK_TRACE_EV_MASK)
+#define TASK_TRACE_EV_GAP(word)  ((word) == 0u)  // Events were lost from this stamp on
+
+/* The producer runs from IRAM hooks: its code must be inlined there, not left in flash */
+#define TASK_TRACE_RING_INLINE static inline __attribute__((always_inline))
+
+typedef struct {
+    uint32_t stamp;  // Microseconds, low 32 bits of the global time base (wraps every ~71 min)
+    uint32_t word;   // Task handle | TASK_TRACE_EV_*, 0 = gap marker
+} task_trace_event_t;
+
+typedef struct {
+    task_trace_event_t* slots;
+    uint32_t            mask;  // Slot count - 1, slot count is a power of 2
+    volatile uint32_t   head;  // Next slot written, producer only (__atomic release)
+    volatile uint32_t   tail;  // Next slot read, consumer only (__atomic release)
+    volatile uint32_t   lost;       // Events dropped because the ring was full (producer only)
+    uint32_t            gap_stamp;  // Stamp of the first event dropped since the last gap marker
+    bool                gap;        // A gap marker must precede the next event (producer only)
+} task_trace_ring_t;
+
+/* slot_count must be a power of 2 */
+TASK_TRACE_RING_INLINE void task_trace_ring_init(task_trace_ring_t* r, task_trace_event_t* slots, uint32_t slot_count) {
+    r->slots = slots;
+    r->mask  = slot_count - 1u;
+    r->head  = 0;
+    r->tail  = 0;
+    r->lost      = 0;
+    r->gap_stamp = 0;
+    r->gap       = false;
+}
+
+/**
+ * @brief Producer side (hook of the owning core). Never blocks.
+ * @return false if the ring was full and the event was dropped
+ */
+TASK_TRACE_RING_INLINE bool task_trace_ring_push(task_trace_ring_t* r, uint32_t stamp, uint32_t word) {
+    uint32_t head = r->head;
+    uint32_t tail = __atomic_load_n(&r->tail, __ATOMIC_ACQUIRE);
+    uint32_t need = r->gap ? 2u : 1u;
+    if (r->mask + 1u - (head - tail) < need) {
+        __atomic_store_n(&r->lost, r->lost + 1u, __ATOMIC_RELAXED);
+        if (!r->gap) {
+            r->gap       = true;
+            r->gap_stamp = stamp;
+        }
+        return false;
+    }
+    if (r->gap) {
+        r->slots[head & r->mask] = (task_trace_event_t) {r->gap_stamp, 0u};
+        head++;
+        r->gap = false;
+    }
+    r->slots[head & r->mask] = (task_trace_event_t) {stamp, word};
+    __atomic_store_n(&r->head, head + 1u, __ATOMIC_RELEASE);
+    return true;
+}
+
+/**
+ * @brief Consumer side: copies up to max events, oldest first, and frees their slots.
+ * @return events copied
+ */
+TASK_TRACE_RING_INLINE uint32_t task_trace_ring_read(task_trace_ring_t* r, task_trace_event_t* out, uint32_t max) {
+    uint32_t tail  = r->tail;
+    uint32_t count = __atomic_load_n(&r->head, __ATOMIC_ACQUIRE) - tail;
+    if (count > max) {
+        count = max;
+    }
+    for (uint32_t i = 0; i < count; i++) {
+        out[i] = r->slots[(tail + i) & r->mask];
+    }
+    __atomic_store_n(&r->tail, tail + count, __ATOMIC_RELEASE);
+    return count;
+}
+
+#ifdef __cplusplus
+}
+#endif /* #ifdef __cplusplus */
+
+#endif /* #ifndef TASK_TRACE_RING_H */
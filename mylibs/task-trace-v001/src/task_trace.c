@@ -0,0 +1,178 @@
+#include "task_trace.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "esp_attr.h"
+#include "esp_cpu.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+#include "sdkconfig.h"
+
+#if CONFIG_TASK_TRACE_ENABLE
+
+static const char* TAG = "task_trace";
+
+#define TASK_TRACE_CORES    (CONFIG_FREERTOS_NUMBER_OF_CORES < TASK_TRACE_MAX_CORES ? CONFIG_FREERTOS_NUMBER_OF_CORES : TASK_TRACE_MAX_CORES)
+#define TASK_TRACE_SETTLE_US (50)  // Intre stamp si publicarea in ring trec cateva sute de cicluri, cu intreruperile mascate
+
+_Static_assert((CONFIG_TASK_TRACE_RING_EVENTS & (CONFIG_TASK_TRACE_RING_EVENTS - 1)) == 0,
+    "CONFIG_TASK_TRACE_RING_EVENTS must be a power of 2");
+
+// Ring-urile sunt statice, in DRAM: hook-urile ruleaza si cu cache-ul flash dezactivat
+static task_trace_event_t s_slots[TASK_TRACE_CORES][CONFIG_TASK_TRACE_RING_EVENTS];
+static task_trace_ring_t  s_rings[TASK_TRACE_CORES];
+static volatile bool      s_enabled = false;
+
+static task_trace_agg_t    s_agg;
+static SemaphoreHandle_t   s_lock  = NULL;
+static esp_timer_handle_t  s_timer = NULL;
+static uint32_t            s_now   = 0;  // Watermark of the last drain
+
+/**********************
+ *   HOOKS (tasks.c)
+ **********************/
+//---------
+static inline __attribute__((always_inline)) void task_trace_record(uint32_t type, void* task) {
+    if (!s_enabled || task == NULL) {
+        return;
+    }
+    uint32_t core = (uint32_t) esp_cpu_get_core_id();
+    task_trace_ring_push(&s_rings[core], (uint32_t) esp_timer_get_time(), (uint32_t) (uintptr_t) task | type);
+}
+//---------
+void IRAM_ATTR task_trace_hook_switched_in(void) {
+    task_trace_record(TASK_TRACE_EV_IN, xTaskGetCurrentTaskHandle());
+}
+//---------
+void IRAM_ATTR task_trace_hook_switched_out(void) {
+    task_trace_record(TASK_TRACE_EV_OUT, xTaskGetCurrentTaskHandle());
+}
+//---------
+void IRAM_ATTR task_trace_hook_ready(void* tcb) {
+    task_trace_record(TASK_TRACE_EV_READY, tcb);
+}
+//---------
+void IRAM_ATTR task_trace_hook_delete(void* tcb) {
+    task_trace_record(TASK_TRACE_EV_DELETE, tcb);
+}
+
+/**********************
+ *   AGGREGATOR
+ **********************/
+//---------
+static void task_trace_name(void* ctx, uint32_t task, char* name, size_t len) {
+    (void) ctx;
+    // Task-ul a rulat sau a fost trezit de curand; un task sters intre timp lasa aici un nume vechi
+    const char* src = pcTaskGetName((TaskHandle_t) (uintptr_t) task);
+    strncpy(name, src ? src : "?", len - 1);
+    name[len - 1] = '\0';
+}
+//---------
+static void task_trace_poll_locked(void) {
+    s_now = (uint32_t) esp_timer_get_time() - TASK_TRACE_SETTLE_US;
+    task_trace_agg_drain(&s_agg, s_rings, s_now);
+}
+//---------
+static void task_trace_timer_cb(void* arg) {
+    (void) arg;
+    // Daca un consumator tine deja lock-ul, goleste el ring-urile
+    if (xSemaphoreTake(s_lock, 0) == pdTRUE) {
+        task_trace_poll_locked();
+        xSemaphoreGive(s_lock);
+    }
+}
+//---------
+esp_err_t task_trace_start(void) {
+    if (s_enabled) {
+        return ESP_OK;
+    }
+    uint32_t capacity = 1;
+    while (capacity < 2u * CONFIG_TASK_TRACE_MAX_TASKS) {
+        capacity <<= 1;
+    }
+    task_trace_task_t* table = calloc(capacity, sizeof(task_trace_task_t));
+    s_lock                   = s_lock ? s_lock : xSemaphoreCreateMutex();
+    if (table == NULL || s_lock == NULL) {
+        free(table);
+        return ESP_ERR_NO_MEM;
+    }
+    task_trace_agg_init(&s_agg, table, capacity, TASK_TRACE_CORES, task_trace_name, NULL);
+    for (uint32_t core = 0; core < TASK_TRACE_CORES; core++) {
+        task_trace_agg_set_idle(&s_agg, core, (uint32_t) (uintptr_t) xTaskGetIdleTaskHandleForCore((BaseType_t) core));
+        task_trace_ring_init(&s_rings[core], s_slots[core], CONFIG_TASK_TRACE_RING_EVENTS);
+    }
+
+    const esp_timer_create_args_t args = {
+        .callback        = task_trace_timer_cb,
+        .dispatch_method = ESP_TIMER_TASK,
+        .name            = "task_trace",
+    };
+    esp_err_t err = esp_timer_create(&args, &s_timer);
+    if (err == ESP_OK) {
+        err = esp_timer_start_periodic(s_timer, CONFIG_TASK_TRACE_POLL_MS * 1000ULL);
+    }
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "esp_timer: %s", esp_err_to_name(err));
+        if (s_timer) {
+            esp_timer_delete(s_timer);
+            s_timer = NULL;
+        }
+        free(table);
+        return err;
+    }
+
+    __atomic_store_n(&s_enabled, true, __ATOMIC_RELEASE);
+    ESP_LOGI(TAG, "started: %d cores, %d events/core, %u task slots, drain every %d ms", TASK_TRACE_CORES,
+        CONFIG_TASK_TRACE_RING_EVENTS, (unsigned) capacity, CONFIG_TASK_TRACE_POLL_MS);
+    return ESP_OK;
+}
+//---------
+bool task_trace_is_running(void) {
+    return s_enabled;
+}
+//---------
+uint32_t task_trace_snapshot(task_trace_task_t* tasks, uint32_t max, task_trace_summary_t* summary) {
+    if (!s_enabled) {
+        if (summary) {
+            memset(summary, 0, sizeof(*summary));
+        }
+        return 0;
+    }
+    xSemaphoreTake(s_lock, portMAX_DELAY);
+    task_trace_poll_locked();
+    uint32_t n = tasks ? task_trace_agg_copy(&s_agg, tasks, max) : 0;
+    if (summary) {
+        summary->now        = s_now;
+        summary->task_count = s_agg.count;
+        summary->core_count = s_agg.core_count;
+        summary->untracked  = s_agg.untracked;
+        memcpy(summary->cores, s_agg.cores, sizeof(summary->cores));
+    }
+    xSemaphoreGive(s_lock);
+    return n;
+}
+
+#else /* CONFIG_TASK_TRACE_ENABLE */
+
+esp_err_t task_trace_start(void) {
+    return ESP_ERR_NOT_SUPPORTED;
+}
+//---------
+bool task_trace_is_running(void) {
+    return false;
+}
+//---------
+uint32_t task_trace_snapshot(task_trace_task_t* tasks, uint32_t max, task_trace_summary_t* summary) {
+    (void) tasks;
+    (void) max;
+    if (summary) {
+        memset(summary, 0, sizeof(*summary));
+    }
+    return 0;
+}
+
+#endif /* CONFIG_TASK_TRACE_ENABLE */
@@ -0,0 +1,321 @@
+#include "task_trace_agg.h"
+
+#include <stdbool.h>
+#include <string.h>
+
+#define TASK_TRACE_BEFORE(a, b) ((int32_t) ((a) - (b)) < 0)  // Stamp a is older than b (wrap safe)
+
+//---------
+static uint32_t task_trace_hash(const task_trace_agg_t* agg, uint32_t task) {
+    return ((task >> 2) * 2654435761u) & (agg->capacity - 1u);  // Handle-urile sunt aliniate la 4
+}
+//---------
+static uint32_t task_trace_rank(uint32_t word) {
+    // Ordinea la acelasi stamp pe core-uri diferite: un task iese de pe un core (sau se blocheaza),
+    // e trezit, apoi intra pe celalalt core in aceeasi microsecunda
+    if (TASK_TRACE_EV_GAP(word) || TASK_TRACE_EV_TYPE(word) == TASK_TRACE_EV_OUT) {
+        return 0;
+    }
+    return TASK_TRACE_EV_TYPE(word) == TASK_TRACE_EV_READY ? 1u : 2u;
+}
+//---------
+static task_trace_task_t* task_trace_lookup(task_trace_agg_t* agg, uint32_t task) {
+    uint32_t mask = agg->capacity - 1u;
+    for (uint32_t i = task_trace_hash(agg, task);; i = (i + 1u) & mask) {
+        task_trace_task_t* row = &agg->tasks[i];
+        if (row->task == task) {
+            return row;
+        }
+        if (row->task == 0) {
+            return NULL;
+        }
+    }
+}
+//---------
+static task_trace_task_t* task_trace_insert(task_trace_agg_t* agg, uint32_t task) {
+    task_trace_task_t* row = task_trace_lookup(agg, task);
+    if (row) {
+        return row;
+    }
+    if (agg->count >= agg->capacity / 2u) {
+        agg->untracked++;
+        return NULL;
+    }
+    uint32_t mask = agg->capacity - 1u;
+    uint32_t i    = task_trace_hash(agg, task);
+    while (agg->tasks[i].task != 0) {
+        i = (i + 1u) & mask;
+    }
+    row = &agg->tasks[i];
+    memset(row, 0, sizeof(*row));
+    row->task       = task;
+    row->generation = ++agg->generation;
+    row->core       = -1;
+    if (agg->name_fn) {
+        agg->name_fn(agg->name_ctx, task, row->name, sizeof(row->name));
+    }
+    agg->count++;
+    return row;
+}
+//---------
+static void task_trace_remove(task_trace_agg_t* agg, task_trace_task_t* row) {
+    // Linear probing fara tombstone-uri: mutam inapoi randurile care ar fi ajuns mai devreme aici
+    uint32_t mask = agg->capacity - 1u;
+    uint32_t hole = (uint32_t) (row - agg->tasks);
+    for (uint32_t i = (hole + 1u) & mask; agg->tasks[i].task != 0; i = (i + 1u) & mask) {
+        uint32_t home = task_trace_hash(agg, agg->tasks[i].task);
+        if (((i - home) & mask) >= ((i - hole) & mask)) {
+            agg->tasks[hole] = agg->tasks[i];
+            hole             = i;
+        }
+    }
+    agg->tasks[hole].task = 0;
+    agg->count--;
+}
+//---------
+static void task_trace_charge(task_trace_agg_t* agg, uint32_t core, uint32_t stamp) {
+    task_trace_core_t* c = &agg->cores[core];
+    if (!c->started) {
+        c->started = true;
+        c->clock   = stamp;
+        return;
+    }
+    if (!TASK_TRACE_BEFORE(c->clock, stamp)) {
+        return;  // Deja contabilizat pana aici (advance la watermark, apoi un eveniment cu acelasi stamp)
+    }
+    uint32_t delta = stamp - c->clock;
+    c->clock       = stamp;
+    c->elapsed_us += delta;
+    if (c->running == 0) {
+        c->unknown_us += delta;
+        return;
+    }
+    task_trace_task_t* row = task_trace_lookup(agg, c->running);
+    if (row) {
+        row->run_us += delta;
+    }
+    if (c->running != c->idle) {
+        c->busy_us += delta;
+    }
+}
+//---------
+static void task_trace_forget_running(task_trace_agg_t* agg, task_trace_task_t* row, uint32_t stamp) {
+    // Task-ul nu mai ruleaza pe core-ul lui (sters, sau a aparut pe alt core dupa un gap)
+    if (row->state == TASK_TRACE_STATE_RUNNING && row->core >= 0 && (uint32_t) row->core < agg->core_count) {
+        task_trace_core_t* c = &agg->cores[row->core];
+        if (c->running == row->task) {
+            task_trace_charge(agg, (uint32_t) row->core, stamp);
+            c->running = 0;
+        }
+    }
+}
+//---------
+static void task_trace_switched_in(task_trace_agg_t* agg, uint32_t core, uint32_t stamp, uint32_t task) {
+    task_trace_core_t* c = &agg->cores[core];
+    if (c->running != 0 && c->running != task) {
+        task_trace_task_t* prev = task_trace_lookup(agg, c->running);
+        if (prev && prev->state == TASK_TRACE_STATE_RUNNING && prev->core == (int8_t) core) {
+            prev->state = TASK_TRACE_STATE_NONE;  // Switch out-ul lui s-a pierdut
+        }
+    }
+    c->running = task;
+    c->switches++;
+
+    task_trace_task_t* row = task_trace_insert(agg, task);
+    if (!row) {
+        return;
+    }
+    if (row->state == TASK_TRACE_STATE_RUNNING && row->core != (int8_t) core) {
+        task_trace_forget_running(agg, row, stamp);
+    }
+    if (row->state == TASK_TRACE_STATE_READY) {
+        uint32_t latency = TASK_TRACE_BEFORE(stamp, row->mark) ? 0u : stamp - row->mark;
+        row->wakeups++;
+        row->latency_sum_us += latency;
+        if (latency > row->latency_max_us) {
+            row->latency_max_us = latency;
+        }
+    } else if (row->state == TASK_TRACE_STATE_OUT) {
+        row->preemptions++;
+    }
+    row->switches++;
+    row->state = TASK_TRACE_STATE_RUNNING;
+    row->core  = (int8_t) core;
+    row->mark  = stamp;
+}
+//---------
+static void task_trace_switched_out(task_trace_agg_t* agg, uint32_t core, uint32_t stamp, uint32_t task) {
+    // Core-ul ramane pe task pana la switch in-ul urmator (alegerea urmatorului task ii apartine)
+    task_trace_task_t* row = task_trace_lookup(agg, task);
+    if (!row || row->state != TASK_TRACE_STATE_RUNNING || row->core != (int8_t) core) {
+        return;
+    }
+    row->state = TASK_TRACE_STATE_OUT;
+    row->mark  = stamp;
+}
+//---------
+static void task_trace_ready(task_trace_agg_t* agg, uint32_t stamp, uint32_t task) {
+    task_trace_task_t* row = task_trace_insert(agg, task);
+    if (!row) {
+        return;
+    }
+    switch (row->state) {
+        case TASK_TRACE_STATE_RUNNING:  // Re-adaugat in lista ready cat ruleaza (prioritate schimbata)
+        case TASK_TRACE_STATE_READY:    // Deja trezit, latenta se masoara de la primul READY
+            break;
+        case TASK_TRACE_STATE_OUT:
+            if (!TASK_TRACE_BEFORE(stamp, row->mark)) {
+                row->state = TASK_TRACE_STATE_READY;
+                row->mark  = stamp;
+            }
+            break;
+        default:
+            row->state = TASK_TRACE_STATE_READY;
+            row->mark  = stamp;
+            break;
+    }
+}
+//---------
+static void task_trace_deleted(task_trace_agg_t* agg, uint32_t stamp, uint32_t task) {
+    task_trace_task_t* row = task_trace_lookup(agg, task);
+    if (!row) {
+        return;
+    }
+    task_trace_forget_running(agg, row, stamp);
+    task_trace_remove(agg, row);
+    agg->deleted++;
+}
+//---------
+void task_trace_agg_init(task_trace_agg_t* agg, task_trace_task_t* table, uint32_t capacity, uint32_t core_count,
+    task_trace_name_fn_t name_fn, void* name_ctx) {
+    memset(agg, 0, sizeof(*agg));
+    memset(table, 0, (size_t) capacity * sizeof(*table));
+    agg->tasks      = table;
+    agg->capacity   = capacity;
+    agg->core_count = core_count > TASK_TRACE_MAX_CORES ? TASK_TRACE_MAX_CORES : core_count;
+    agg->name_fn    = name_fn;
+    agg->name_ctx   = name_ctx;
+}
+//---------
+void task_trace_agg_set_idle(task_trace_agg_t* agg, uint32_t core, uint32_t idle_task) {
+    if (core < agg->core_count) {
+        agg->cores[core].idle = idle_task;
+    }
+}
+//---------
+void task_trace_agg_event(task_trace_agg_t* agg, uint32_t core, uint32_t stamp, uint32_t word) {
+    if (core >= agg->core_count) {
+        return;
+    }
+    agg->events++;
+    task_trace_charge(agg, core, stamp);
+
+    if (TASK_TRACE_EV_GAP(word)) {
+        // Lipsesc evenimente pe acest core: nu mai stim ce ruleaza pana la urmatorul switch in
+        task_trace_core_t* c = &agg->cores[core];
+        if (c->running != 0) {
+            task_trace_task_t* row = task_trace_lookup(agg, c->running);
+            if (row && row->state == TASK_TRACE_STATE_RUNNING && row->core == (int8_t) core) {
+                row->state = TASK_TRACE_STATE_NONE;
+            }
+        }
+        c->running = 0;
+        c->gaps++;
+        return;
+    }
+
+    uint32_t task = TASK_TRACE_EV_TASK(word);
+    switch (TASK_TRACE_EV_TYPE(word)) {
+        case TASK_TRACE_EV_IN:
+            task_trace_switched_in(agg, core, stamp, task);
+            break;
+        case TASK_TRACE_EV_OUT:
+            task_trace_switched_out(agg, core, stamp, task);
+            break;
+        case TASK_TRACE_EV_READY:
+            task_trace_ready(agg, stamp, task);
+            break;
+        default:
+            task_trace_deleted(agg, stamp, task);
+            break;
+    }
+}
+//---------
+void task_trace_agg_advance(task_trace_agg_t* agg, uint32_t stamp) {
+    for (uint32_t core = 0; core < agg->core_count; core++) {
+        if (agg->cores[core].started) {
+            task_trace_charge(agg, core, stamp);
+        }
+    }
+}
+//---------
+uint32_t task_trace_agg_drain(task_trace_agg_t* agg, task_trace_ring_t* rings, uint32_t watermark) {
+    uint32_t tail[TASK_TRACE_MAX_CORES];
+    uint32_t head[TASK_TRACE_MAX_CORES];
+    bool     dropped[TASK_TRACE_MAX_CORES];
+    for (uint32_t core = 0; core < agg->core_count; core++) {
+        uint32_t lost         = __atomic_load_n(&rings[core].lost, __ATOMIC_RELAXED);
+        dropped[core]         = lost != agg->cores[core].lost;
+        agg->cores[core].lost = lost;
+        tail[core]            = rings[core].tail;
+        head[core]            = __atomic_load_n(&rings[core].head, __ATOMIC_ACQUIRE);
+    }
+
+    uint32_t processed = 0;
+    for (;;) {
+        // Cel mai vechi eveniment din capetele ring-urilor
+        int                       best     = -1;
+        const task_trace_event_t* best_ev  = NULL;
+        for (uint32_t core = 0; core < agg->core_count; core++) {
+            if (tail[core] == head[core]) {
+                continue;
+            }
+            const task_trace_event_t* ev = &rings[core].slots[tail[core] & rings[core].mask];
+            if (TASK_TRACE_BEFORE(watermark, ev->stamp)) {
+                continue;  // Mai nou decat watermark-ul: ramane pentru drain-ul urmator
+            }
+            if (best_ev == NULL || TASK_TRACE_BEFORE(ev->stamp, best_ev->stamp) ||
+                (ev->stamp == best_ev->stamp && task_trace_rank(ev->word) < task_trace_rank(best_ev->word))) {
+                best    = (int) core;
+                best_ev = ev;
+            }
+        }
+        if (best < 0) {
+            break;
+        }
+        task_trace_event_t ev = *best_ev;
+        tail[best]++;
+        task_trace_agg_event(agg, (uint32_t) best, ev.stamp, ev.word);
+        processed++;
+    }
+
+    for (uint32_t core = 0; core < agg->core_count; core++) {
+        __atomic_store_n(&rings[core].tail, tail[core], __ATOMIC_RELEASE);
+        // Ring plin de la drain-ul anterior: marker-ul de gap (cu stamp-ul primului eveniment
+        // pierdut) vine abia cu urmatorul eveniment scris, ceasul core-ului il asteapta
+        if (agg->cores[core].started && !dropped[core]) {
+            task_trace_charge(agg, core, watermark);
+        }
+    }
+    return processed;
+}
+//---------
+uint32_t task_trace_agg_copy(const task_trace_agg_t* agg, task_trace_task_t* out, uint32_t max) {
+    uint32_t n = 0;
+    for (uint32_t i = 0; i < agg->capacity && n < max; i++) {
+        if (agg->tasks[i].task != 0) {
+            out[n++] = agg->tasks[i];
+        }
+    }
+    return n;
+}
+//---------
+const task_trace_task_t* task_trace_find(const task_trace_task_t* tasks, uint32_t count, uint32_t task,
+    uint32_t generation) {
+    for (uint32_t i = 0; i < count; i++) {
+        if (tasks[i].task == task) {
+            return tasks[i].generation == generation ? &tasks[i] : NULL;
+        }
+    }
+    return NULL;
+}